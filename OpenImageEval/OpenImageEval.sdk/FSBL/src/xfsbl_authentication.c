@@ -278,7 +278,7 @@ END:
  ******************************************************************************/
 static u32 XFsbl_PartitionSignVer(const XFsblPs *FsblInstancePtr, u64 PartitionOffset,
 				u32 PartitionLen, u64 AcOffset,
-				u32 PartitionNum)
+				u32 PartitionNum, const u8 *StreamedHash)
 {
 
 	u8 PartitionHash[XFSBL_HASH_TYPE_SHA3] __attribute__ ((aligned (4))) = {0};
@@ -295,55 +295,60 @@ static u32 XFsbl_PartitionSignVer(const XFsblPs *FsblInstancePtr, u64 PartitionO
 
 	XFsbl_Printf(DEBUG_INFO, "Doing Partition Sign verification\r\n");
 
-	/**
-	 * total partition length to be hashed except the AC
-	 */
-	HashDataLen = PartitionLen - XFSBL_AUTH_CERT_MIN_SIZE;
+	if (StreamedHash != NULL) {
+		/* Hashed as it was copied (see XFsbl_PartitionCopy) */
+		(void)XFsbl_MemCpy(PartitionHash, StreamedHash, HashLen);
+	} else {
+		/**
+		 * total partition length to be hashed except the AC
+		 */
+		HashDataLen = PartitionLen - XFSBL_AUTH_CERT_MIN_SIZE;
 
-	/* Start the SHA engine */
-	(void)XFsbl_ShaStart(ShaCtx, HashLen);
+		/* Start the SHA engine */
+		(void)XFsbl_ShaStart(ShaCtx, HashLen);
 
-	/* Calculate Partition Hash */
+		/* Calculate Partition Hash */
 #ifndef XFSBL_PS_DDR
-	const XFsblPs_PartitionHeader * PartitionHeader;
-	u32 DestinationDevice = 0U;
-	PartitionHeader =
-		&FsblInstancePtr->ImageHeader.PartitionHeader[PartitionNum];
-	DestinationDevice = XFsbl_GetDestinationDevice(PartitionHeader);
+		const XFsblPs_PartitionHeader * PartitionHeader;
+		u32 DestinationDevice = 0U;
+		PartitionHeader =
+			&FsblInstancePtr->ImageHeader.PartitionHeader[PartitionNum];
+		DestinationDevice = XFsbl_GetDestinationDevice(PartitionHeader);
 
-	if (DestinationDevice == XIH_PH_ATTRB_DEST_DEVICE_PL)
-	{
-#ifdef XFSBL_BS
-		if(XFSBL_SUCCESS != XFsbl_ShaUpdate_DdrLess(FsblInstancePtr,
-		 ShaCtx, PartitionOffset, HashDataLen, HashLen, PartitionHash))
+		if (DestinationDevice == XIH_PH_ATTRB_DEST_DEVICE_PL)
 		{
-			XFsbl_Printf(DEBUG_GENERAL,
-			"XFsbl_PartitionVer: XFSBL_ERROR_PART_RSA_DECRYPT\r\n");
-			Status = XFSBL_ERROR_PART_RSA_DECRYPT;
-			goto END;
-		}
+#ifdef XFSBL_BS
+			if(XFSBL_SUCCESS != XFsbl_ShaUpdate_DdrLess(FsblInstancePtr,
+			 ShaCtx, PartitionOffset, HashDataLen, HashLen, PartitionHash))
+			{
+				XFsbl_Printf(DEBUG_GENERAL,
+				"XFsbl_PartitionVer: XFSBL_ERROR_PART_RSA_DECRYPT\r\n");
+				Status = XFSBL_ERROR_PART_RSA_DECRYPT;
+				goto END;
+			}
 
 #endif
-	}
-	else
-	{
-		XFsbl_Printf(DEBUG_INFO, "XFsbl_PartitionVer: SHA calc. "
-					"for non bs DDR less partition \r\n");
-		/* SHA calculation for non-bitstream, DDR less partitions */
-		XFsbl_ShaUpdate(ShaCtx, (u8 *)(PTRSIZE)PartitionOffset,
-							HashDataLen, HashLen);
-	}
+		}
+		else
+		{
+			XFsbl_Printf(DEBUG_INFO, "XFsbl_PartitionVer: SHA calc. "
+						"for non bs DDR less partition \r\n");
+			/* SHA calculation for non-bitstream, DDR less partitions */
+			XFsbl_ShaUpdate(ShaCtx, (u8 *)(PTRSIZE)PartitionOffset,
+								HashDataLen, HashLen);
+		}
 #else
-	/* SHA calculation in DDRful systems */
-	XFsbl_ShaUpdate(ShaCtx, (u8 *)(PTRSIZE)PartitionOffset, HashDataLen, HashLen);
+		/* SHA calculation in DDRful systems */
+		XFsbl_ShaUpdate(ShaCtx, (u8 *)(PTRSIZE)PartitionOffset, HashDataLen, HashLen);
 
 #endif
 
-	/* Calculate hash for (AC - signature size) */
-	XFsbl_ShaUpdate(ShaCtx, (u8 *)(PTRSIZE)AcOffset,
-			(XFSBL_AUTH_CERT_MIN_SIZE - XFSBL_FSBL_SIG_SIZE), HashLen);
+		/* Calculate hash for (AC - signature size) */
+		XFsbl_ShaUpdate(ShaCtx, (u8 *)(PTRSIZE)AcOffset,
+				(XFSBL_AUTH_CERT_MIN_SIZE - XFSBL_FSBL_SIG_SIZE), HashLen);
 
-	XFsbl_ShaFinish(ShaCtx, (u8 *)PartitionHash, HashLen);
+		XFsbl_ShaFinish(ShaCtx, (u8 *)PartitionHash, HashLen);
+	}
 
 	/* Set SPK pointer */
 	AcPtr += (XFSBL_RSA_AC_ALIGN + XFSBL_PPK_SIZE);
@@ -415,7 +420,7 @@ END:
  ******************************************************************************/
 u32 XFsbl_Authentication(const XFsblPs * FsblInstancePtr, u64 PartitionOffset,
 				u32 PartitionLen, u64 AcOffset,
-				u32 PartitionNum)
+				u32 PartitionNum, const u8 *StreamedHash)
 {
         u32 Status;
         u32 HashLen = XFSBL_HASH_TYPE_SHA3;
@@ -435,7 +440,8 @@ u32 XFsbl_Authentication(const XFsblPs * FsblInstancePtr, u64 PartitionOffset,
 
         /* Do Partition Signature verification using SPK */
         Status = XFsbl_PartitionSignVer(FsblInstancePtr, PartitionOffset,
-					PartitionLen, AcOffset, PartitionNum);
+					PartitionLen, AcOffset, PartitionNum,
+					StreamedHash);
 
         if(XFSBL_SUCCESS != Status)
         {
@@ -53,15 +53,34 @@
 #include "xfsbl_hw.h"
 #ifdef XFSBL_BS
 #include "xfsbl_bs.h"
+#ifdef XFSBL_LZ4
+#include "xil_cache.h"
+#endif
 
 /************************** Constant Definitions *****************************/
 
+#ifdef XFSBL_LZ4
+/**
+ * Division of ReadBuffer for compressed partitions:  two halves for the
+ * compressed data, one read while the other is decompressed; and, on the
+ * way to the PCAP, one block of the decompressed data ahead of them.
+ */
+#define XFSBL_LZ4_COPY_CHUNK_SIZE	(READ_BUFFER_SIZE / 2U)
+#define XFSBL_LZ4_PCAP_CHUNK_SIZE	\
+		((READ_BUFFER_SIZE - XFSBL_LZ4_BLOCK_SIZE) / 2U)
+#endif
+
 /**************************** Type Definitions *******************************/
 
 /***************** Macros (Inline Functions) Definitions *********************/
 
 /************************** Function Prototypes ******************************/
 
+#ifdef XFSBL_LZ4
+static u32 XFsbl_Lz4Stream(XFsblPs *FsblInstancePtr, u32 PartitionNum,
+		XFsblLz4 *Lz4, u8 *InBuffer, u32 ChunkSize, u32 IsPcap);
+#endif
+
 /************************** Variable Definitions *****************************/
 /* Global OCM buffer to store data chunks */
 #ifdef __clang__
@@ -351,6 +370,238 @@ END:
 }
 #endif
 
+#ifdef XFSBL_LZ4
+/*****************************************************************************/
+/**
+ * This function reads the header of a compressed partition, for the length
+ * of the data once decompressed.  It is read to ReadBuffer, which is
+ * whole cache lines, and not yet in use.
+ *
+ * @param	FsblInstancePtr is pointer to the XFsbl Instance
+ *
+ * @param	PartitionNum is the partition number in the image
+ *
+ * @param	LengthPtr receives the length, in bytes
+ *
+ * @return	error status based on implemented functionality(SUCCESS by default)
+ *
+ *****************************************************************************/
+u32 XFsbl_Lz4GetLength(XFsblPs *FsblInstancePtr, u32 PartitionNum,
+		u32 *LengthPtr)
+{
+	u32 Status;
+	const u32 *Header = (const u32 *)ReadBuffer;
+	const XFsblPs_PartitionHeader *PartitionHeader =
+		&FsblInstancePtr->ImageHeader.PartitionHeader[PartitionNum];
+
+	Status = FsblInstancePtr->DeviceOps.DeviceCopy(
+			FsblInstancePtr->ImageOffsetAddress +
+				(PartitionHeader->DataWordOffset *
+					XIH_PARTITION_WORD_LENGTH),
+			(PTRSIZE)ReadBuffer, 2U * sizeof(u32));
+	if (Status != XFSBL_SUCCESS) {
+		goto END;
+	}
+
+	if (Header[0U] != XFSBL_LZ4_MAGIC) {
+		XFsbl_Printf(DEBUG_GENERAL, "XFSBL_ERROR_DECOMPRESSION\r\n");
+		Status = XFSBL_ERROR_DECOMPRESSION;
+		goto END;
+	}
+
+	*LengthPtr = Header[1U];
+
+END:
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * This function loads a compressed partition to memory.
+ *
+ * @param	FsblInstancePtr is pointer to the XFsbl Instance
+ *
+ * @param	PartitionNum is the partition number in the image
+ *
+ * @param	LoadAddress is where it is decompressed to
+ *
+ * @param	Length is the room there, from XFsbl_Lz4GetLength
+ *
+ * @return	error status based on implemented functionality(SUCCESS by default)
+ *
+ *****************************************************************************/
+u32 XFsbl_Lz4Copy(XFsblPs *FsblInstancePtr, u32 PartitionNum,
+		PTRSIZE LoadAddress, u32 Length)
+{
+	u32 Status;
+	XFsblLz4 Lz4;
+
+	XFsbl_Lz4Init(&Lz4, (u8 *)LoadAddress, Length);
+
+	Status = XFsbl_Lz4Stream(FsblInstancePtr, PartitionNum, &Lz4,
+			ReadBuffer, XFSBL_LZ4_COPY_CHUNK_SIZE, FALSE);
+
+	/* For the CPU that runs it */
+	Xil_DCacheFlushRange(LoadAddress, Length);
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * This function downloads a compressed bitstream to the PL.  Each block is
+ * decompressed to the start of ReadBuffer, and sent to the PCAP; with or
+ * without DDR, as the bitstream is never held whole.
+ *
+ * @param	FsblInstancePtr is pointer to the XFsbl Instance
+ *
+ * @param	PartitionNum is the partition number in the image
+ *
+ * @return	error status based on implemented functionality(SUCCESS by default)
+ *
+ *****************************************************************************/
+u32 XFsbl_Lz4ToPcap(XFsblPs *FsblInstancePtr, u32 PartitionNum)
+{
+	XFsblLz4 Lz4;
+
+	XFsbl_Printf(DEBUG_GENERAL,
+		"Compressed Bitstream transfer in blocks to begin now\r\n");
+
+	XFsbl_Lz4Init(&Lz4, ReadBuffer, XFSBL_LZ4_BLOCK_SIZE);
+
+	return XFsbl_Lz4Stream(FsblInstancePtr, PartitionNum, &Lz4,
+			&ReadBuffer[XFSBL_LZ4_BLOCK_SIZE], XFSBL_LZ4_PCAP_CHUNK_SIZE,
+			TRUE);
+}
+
+/*****************************************************************************/
+/**
+ * This function reads a compressed partition into the two halves of a
+ * buffer in turn, and decompresses each half while the next is read, if the
+ * boot device can read in the background (DeviceCopyStart).
+ *
+ * @param	FsblInstancePtr is pointer to the XFsbl Instance
+ *
+ * @param	PartitionNum is the partition number in the image
+ *
+ * @param	Lz4 is the decoder, initialized for the destination
+ *
+ * @param	InBuffer is the buffer, of two chunks
+ *
+ * @param	ChunkSize is the size of each half, in bytes
+ *
+ * @param	IsPcap is TRUE to send each block to the PCAP, and rewind
+ *
+ * @return	error status based on implemented functionality(SUCCESS by default)
+ *
+ *****************************************************************************/
+static u32 XFsbl_Lz4Stream(XFsblPs *FsblInstancePtr, u32 PartitionNum,
+		XFsblLz4 *Lz4, u8 *InBuffer, u32 ChunkSize, u32 IsPcap)
+{
+	u32 Status = XFSBL_SUCCESS;
+	u32 Result = XFSBL_LZ4_MORE;
+	const XFsblPs_PartitionHeader *PartitionHeader =
+		&FsblInstancePtr->ImageHeader.PartitionHeader[PartitionNum];
+	u32 SrcAddress = FsblInstancePtr->ImageOffsetAddress +
+		(PartitionHeader->DataWordOffset * XIH_PARTITION_WORD_LENGTH);
+	u32 Remaining = PartitionHeader->UnEncryptedDataWordLength *
+		XIH_PARTITION_WORD_LENGTH;
+	u32 IsAsync = (FsblInstancePtr->DeviceOps.DeviceCopyStart != NULL) ?
+		TRUE : FALSE;
+	u32 Half = 0U;
+	u32 ChunkLength;
+	u32 NextLength;
+	u32 Pos;
+	u32 Used;
+	u8 *Chunk;
+
+	ChunkLength = (Remaining < ChunkSize) ? Remaining : ChunkSize;
+	if (IsAsync == TRUE) {
+		Status = FsblInstancePtr->DeviceOps.DeviceCopyStart(SrcAddress,
+				(PTRSIZE)InBuffer, ChunkLength);
+	} else {
+		Status = FsblInstancePtr->DeviceOps.DeviceCopy(SrcAddress,
+				(PTRSIZE)InBuffer, ChunkLength);
+	}
+
+	while ((Status == XFSBL_SUCCESS) && (Result != XFSBL_LZ4_DONE) &&
+			(ChunkLength != 0U)) {
+		if (IsAsync == TRUE) {
+			Status = FsblInstancePtr->DeviceOps.DeviceCopyWait();
+			if (Status != XFSBL_SUCCESS) {
+				break;
+			}
+		}
+
+		Chunk = &InBuffer[Half * ChunkSize];
+		SrcAddress += ChunkLength;
+		Remaining -= ChunkLength;
+		Half ^= 1U;
+
+		/**
+		 * Start the next chunk
+		 */
+		NextLength = (Remaining < ChunkSize) ? Remaining : ChunkSize;
+		if ((NextLength != 0U) && (IsAsync == TRUE)) {
+			Status = FsblInstancePtr->DeviceOps.DeviceCopyStart(
+					SrcAddress, (PTRSIZE)&InBuffer[Half * ChunkSize],
+					NextLength);
+		}
+
+		/**
+		 * Decompress this one, sending on each block if it is for the PL
+		 */
+		Pos = 0U;
+		while ((Status == XFSBL_SUCCESS) && (Pos < ChunkLength) &&
+				(Result != XFSBL_LZ4_DONE)) {
+			Result = XFsbl_Lz4Decode(Lz4, &Chunk[Pos],
+					ChunkLength - Pos, &Used);
+			Pos += Used;
+
+			if (Result == XFSBL_LZ4_ERROR) {
+				Status = XFSBL_ERROR_DECOMPRESSION;
+			} else if ((Result == XFSBL_LZ4_BLOCK) && (IsPcap == TRUE)) {
+				if ((Lz4->OutPos % 4U) != 0U) {
+					Status = XFSBL_ERROR_DECOMPRESSION;
+				} else {
+					Xil_DCacheFlushRange((INTPTR)Lz4->Out, Lz4->OutPos);
+					Status = XFsbl_WriteToPcap(Lz4->OutPos / 4U,
+							Lz4->Out);
+					XFsbl_Lz4Rewind(Lz4);
+				}
+			} else {
+				/* More to come */
+			}
+		}
+
+		if ((NextLength != 0U) && (IsAsync == FALSE) &&
+				(Status == XFSBL_SUCCESS)) {
+			Status = FsblInstancePtr->DeviceOps.DeviceCopy(SrcAddress,
+					(PTRSIZE)&InBuffer[Half * ChunkSize], NextLength);
+		}
+		ChunkLength = NextLength;
+	}
+
+	/**
+	 * Let a read still under way finish, so as not to leave the QSPI busy
+	 */
+	if ((IsAsync == TRUE) && (ChunkLength != 0U) &&
+			(Result != XFSBL_LZ4_MORE)) {
+		(void)FsblInstancePtr->DeviceOps.DeviceCopyWait();
+	}
+
+	if ((Status == XFSBL_SUCCESS) && (Result != XFSBL_LZ4_DONE)) {
+		Status = XFSBL_ERROR_DECOMPRESSION;
+	}
+
+	if (Status == XFSBL_ERROR_DECOMPRESSION) {
+		XFsbl_Printf(DEBUG_GENERAL, "XFSBL_ERROR_DECOMPRESSION\r\n");
+	}
+
+	return Status;
+}
+#endif
+
 #endif
 /*****************************************************************************/
 /**
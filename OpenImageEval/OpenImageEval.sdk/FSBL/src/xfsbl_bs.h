@@ -62,6 +62,9 @@ extern "C" {
 #include "xfsbl_csu_dma.h"
 #include "xfsbl_hw.h"
 #include "xcsudma.h"
+#ifdef XFSBL_LZ4
+#include "xfsbl_lz4.h"
+#endif
 /************************** Constant Definitions *****************************/
 
 #define PL_DONE_POLL_COUNT  (u32)(10000U)
@@ -96,6 +99,13 @@ u32 XFsbl_PcapInit(void);
 u32 XFsbl_PLWaitForDone(void);
 u32 XFsbl_WriteToPcap(u32 WrSize, u8 *WrAddr);
 u32 XFsbl_PLCheckForDone(void);
+#ifdef XFSBL_LZ4
+u32 XFsbl_Lz4GetLength(XFsblPs *FsblInstancePtr, u32 PartitionNum,
+		u32 *LengthPtr);
+u32 XFsbl_Lz4Copy(XFsblPs *FsblInstancePtr, u32 PartitionNum,
+		PTRSIZE LoadAddress, u32 Length);
+u32 XFsbl_Lz4ToPcap(XFsblPs *FsblInstancePtr, u32 PartitionNum);
+#endif
 
 /************************** Variable Definitions *****************************/
 
@@ -130,6 +130,15 @@ extern "C" {
  *     	 contains bitstream
  *     - FSBL_FORCE_ENC_EXCLUDE_VAL Forcing encryption for every partition
  *       when ENC only bit is blown will be excluded.
+ *     - FSBL_PROFILE_EXCLUDE_VAL The boot profile for the application
+ *       (see xfsbl_profile.h) will be excluded
+ *     - FSBL_STREAM_HASH_EXCLUDE_VAL Hashing each partition as it is read
+ *       from QSPI, rather than after, will be excluded
+ *     - FSBL_LZ4_EXCLUDE_VAL Loading of compressed partitions (see
+ *       xfsbl_lz4.h) will be excluded
+ *     - FSBL_ECC_SCRUB_EXCLUDE_VAL ECC initialization of the DDR above
+ *       XFSBL_ECC_SCRUB_START_ADDRESS in the background will be excluded;
+ *       it is all initialized before the partitions are loaded
  */
 #define FSBL_NAND_EXCLUDE_VAL			(0U)
 #define FSBL_QSPI_EXCLUDE_VAL			(0U)
@@ -146,6 +155,10 @@ extern "C" {
 #define FSBL_PARTITION_LOAD_EXCLUDE_VAL (0U)
 #define FSBL_FORCE_ENC_EXCLUDE_VAL		(0U)
 #define FSBL_DDR_SR_EXCLUDE_VAL			(1U)
+#define FSBL_PROFILE_EXCLUDE_VAL		(0U)
+#define FSBL_STREAM_HASH_EXCLUDE_VAL	(0U)
+#define FSBL_LZ4_EXCLUDE_VAL			(0U)
+#define FSBL_ECC_SCRUB_EXCLUDE_VAL		(0U)
 
 #if FSBL_NAND_EXCLUDE_VAL
 #define FSBL_NAND_EXCLUDE
@@ -206,6 +219,42 @@ extern "C" {
 #if (FSBL_DDR_SR_EXCLUDE_VAL == 0U)
 #define XFSBL_ENABLE_DDR_SR
 #endif
+
+#if FSBL_PROFILE_EXCLUDE_VAL
+#define FSBL_PROFILE_EXCLUDE
+#endif
+
+#if FSBL_STREAM_HASH_EXCLUDE_VAL
+#define FSBL_STREAM_HASH_EXCLUDE
+#endif
+
+#if FSBL_LZ4_EXCLUDE_VAL
+#define FSBL_LZ4_EXCLUDE
+#endif
+
+#if FSBL_ECC_SCRUB_EXCLUDE_VAL
+#define FSBL_ECC_SCRUB_EXCLUDE
+#endif
+
+/**
+ * Fast paths, each of which shortens one stage of the boot (as timed by the
+ * boot profile) at some cost; all are off by default.
+ *     - FSBL_BANNER_EXCLUDE_VAL The banner is not printed, saving about
+ *       87 us per character at 115200 baud in XFsbl_Initialize
+ *     - FSBL_QSPI_FAST_CLK_VAL The QSPI clock is the reference divided by 4,
+ *       rather than 8, halving the partition copy time; the flash must be
+ *       rated for it
+ */
+#define FSBL_BANNER_EXCLUDE_VAL			(0U)
+#define FSBL_QSPI_FAST_CLK_VAL			(0U)
+
+#if FSBL_BANNER_EXCLUDE_VAL
+#define FSBL_BANNER_EXCLUDE
+#endif
+
+#if FSBL_QSPI_FAST_CLK_VAL
+#define FSBL_QSPI_FAST_CLK
+#endif
 /************************** Function Prototypes ******************************/
 
 /************************** Variable Definitions *****************************/
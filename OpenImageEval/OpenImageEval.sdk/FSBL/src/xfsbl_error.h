@@ -208,6 +208,8 @@ extern "C" {
 #define XSFBL_EEPROM_PRESENT						(0x76U)
 #define XFSBL_BITSTREAM_NOT_LOADED				(0x77U)
 #define XFSBL_ERROR_SHA2_NOT_SUPPORTED				(0x78U)
+#define XFSBL_ERROR_COMPRESSED_PARTITION			(0x79U)
+#define XFSBL_ERROR_DECOMPRESSION					(0x7AU)
 #define XFSBL_FAILURE					(0x3FFFFFFFU)
 
 /**************************** Type Definitions *******************************/
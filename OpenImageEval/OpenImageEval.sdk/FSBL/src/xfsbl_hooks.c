@@ -51,6 +51,7 @@
 #include "xfsbl_hw.h"
 #include "xfsbl_hooks.h"
 #include "psu_init.h"
+#include "xfsbl_profile.h"
 /************************** Constant Definitions *****************************/
 
 /**************************** Type Definitions *******************************/
@@ -91,8 +92,10 @@ u32 XFsbl_HookBeforeHandoff(u32 EarlyHandoff)
 	u32 Status = XFSBL_SUCCESS;
 
 	/**
-	 * Add the code here
+	 * Record when the application was started, as the last event of the
+	 * boot profile
 	 */
+	XFsbl_ProfileMark(XFSBL_PROFILE_HANDOFF, 0U);
 
 	return Status;
 }
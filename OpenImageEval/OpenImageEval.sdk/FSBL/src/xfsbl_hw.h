@@ -851,6 +851,11 @@ extern "C" {
 #define XFSBL_QSPI_BUSWIDTH_ONE			0U
 #define XFSBL_QSPI_BUSWIDTH_TWO			1U
 #define XFSBL_QSPI_BUSWIDTH_FOUR		2U
+#ifdef FSBL_QSPI_FAST_CLK
+#define XFSBL_QSPI_PRESCALER	XQSPIPSU_CLK_PRESCALE_4
+#else
+#define XFSBL_QSPI_PRESCALER	XQSPIPSU_CLK_PRESCALE_8
+#endif
 #endif
 
 /**
@@ -886,6 +891,28 @@ extern "C" {
 #define XFSBL_PERF
 #endif
 
+/**
+ * Definition for the boot profile to be included
+ */
+#if !defined(FSBL_PROFILE_EXCLUDE) && !defined(ARMR5)
+#define XFSBL_PROFILE
+#endif
+
+/**
+ * Definition for hashing partitions as they are read to be included
+ */
+#if !defined(FSBL_STREAM_HASH_EXCLUDE) && defined(XFSBL_SECURE)
+#define XFSBL_STREAM_HASH
+#endif
+
+/**
+ * Definition for compressed partitions to be included; they are
+ * decompressed through the bitstream's buffer
+ */
+#if !defined(FSBL_LZ4_EXCLUDE) && defined(XFSBL_BS)
+#define XFSBL_LZ4
+#endif
+
 /* Definition for TCM ECC Enable for A53 to be included */
 #if !defined(FSBL_A53_TCM_ECC_EXCLUDE)
 #define XFSBL_A53_TCM_ECC
@@ -941,6 +968,13 @@ extern "C" {
 #endif
 #endif
 
+/**
+ * Definition for the background ECC initialization of DDR to be included
+ */
+#if !defined(FSBL_ECC_SCRUB_EXCLUDE) && defined(XFSBL_PS_DDR)
+#define XFSBL_ECC_SCRUB
+#endif
+
 #ifdef XFSBL_ENABLE_DDR_SR
 /*
  * For DDR status PMU_GLOBAL_PERS_GLOB_GEN_STORAGE7 is used
@@ -979,6 +1013,14 @@ extern "C" {
 #define XFSBL_OCM_START_ADDRESS			(0xFFFEA000U)
 #define XFSBL_OCM_END_ADDRESS			(0xFFFFFFFFU)
 
+/**
+ * The start of that bank holds the boot profile and the ECC scrub record,
+ * left for the application (see xfsbl_profile.h and xfsbl_main.h); no
+ * partition may be loaded over them
+ */
+#define XFSBL_OCM_RESERVED_START_ADDRESS	(0xFFFEA000U)
+#define XFSBL_OCM_RESERVED_END_ADDRESS	(0xFFFEA800U)
+
 /* Different Memory types */
 #define XFSBL_R5_0_TCM		(0x1U)
 #define XFSBL_R5_1_TCM		(0x2U)
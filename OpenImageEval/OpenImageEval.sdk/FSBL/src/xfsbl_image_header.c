@@ -129,6 +129,12 @@ u32 XFsbl_GetBlockSize(const XFsblPs_PartitionHeader * PartitionHeader)
 	return Size;
 }
 
+u32 XFsbl_IsCompressed(const XFsblPs_PartitionHeader * PartitionHeader)
+{
+        return PartitionHeader->PartitionAttributes &
+                                XIH_PH_ATTRB_COMPRESSED_MASK;
+}
+
 /************************** Function Prototypes ******************************/
 static u32 XFsbl_ValidateImageHeaderTable(
 		XFsblPs_ImageHeaderTable * ImageHeaderTable);
@@ -558,9 +564,10 @@ static u32 XFsbl_CheckValidMemoryAddress(u64 Address, u32 CpuId, u32 DevId)
 
 #ifdef XFSBL_OCM
 	 /**
-         * Check if Address is in the range of last bank of OCM
+         * Check if Address is in the range of last bank of OCM, past the
+         * records reserved at its start
          */
-        if ((Address >= XFSBL_OCM_START_ADDRESS) &&
+        if ((Address >= XFSBL_OCM_RESERVED_END_ADDRESS) &&
              (Address < XFSBL_OCM_END_ADDRESS) )
         {
 			Status = XFSBL_SUCCESS;
@@ -706,6 +713,26 @@ u32 XFsbl_ValidatePartitionHeader(
 		}
 	}
 
+	/**
+	 * Compressed partitions are decompressed as they are read, so they
+	 * cannot also be decrypted, or checked against a hash of what was read
+	 */
+	if (XFsbl_IsCompressed(PartitionHeader) != 0U)
+	{
+#ifdef XFSBL_LZ4
+		if ((IsAuthenticated == TRUE) || (IsEncrypted == TRUE) ||
+			(XFsbl_GetChecksumType(PartitionHeader) !=
+				XIH_PH_ATTRB_NOCHECKSUM) ||
+			(PartitionHeader->UnEncryptedDataWordLength == 0U))
+#endif
+		{
+			Status = XFSBL_ERROR_COMPRESSED_PARTITION;
+			XFsbl_Printf(DEBUG_GENERAL,
+				"XFSBL_ERROR_COMPRESSED_PARTITION\n\r");
+			goto END;
+		}
+	}
+
 
 	/**
 	 * check for authentication and encryption length
@@ -149,6 +149,7 @@ extern "C" {
 /**
  * Partition Attribute fields
  */
+#define XIH_PH_ATTRB_COMPRESSED_MASK		(0x1000000U)
 #define XIH_PH_ATTRB_VEC_LOCATION_MASK		(0x800000U)
 #define XIH_PH_ATTR_BLOCK_SIZE_MASK		(0x700000U)
 #define XIH_PH_ATTRB_ENDIAN_MASK		(0x40000U)
@@ -171,6 +172,9 @@ extern "C" {
 #define XIH_PH_ATTRB_CHECKSUM_MD5		(0x1000U)
 #define XIH_PH_ATTRB_HASH_SHA3			(0x3000U)
 
+/* Compressed, as xfsbl_lz4.h describes; set by oiBootPack */
+#define XIH_PH_ATTRB_COMPRESSED			(0x1000000U)
+
 #define XIH_PH_ATTRB_DEST_CPU_NONE	(0x0000U)
 #define XIH_PH_ATTRB_DEST_CPU_A53_0	(u32)(0x100U)
 #define XIH_PH_ATTRB_DEST_CPU_A53_1	(u32)(0x200U)
@@ -317,6 +321,7 @@ u32 XFsbl_GetDestinationDevice(const XFsblPs_PartitionHeader * PartitionHeader);
 u32 XFsbl_GetA53ExecState(const XFsblPs_PartitionHeader * PartitionHeader);
 u32 XFsbl_GetVectorLocation(const XFsblPs_PartitionHeader * PartitionHeader);
 u32 XFsbl_GetBlockSize(const XFsblPs_PartitionHeader * PartitionHeader);
+u32 XFsbl_IsCompressed(const XFsblPs_PartitionHeader * PartitionHeader);
 
 u32 XFsbl_ValidateChecksum(u32 Buffer[], u32 Length);
 u32 XFsbl_ReadImageHeader(XFsblPs_ImageHeader * ImageHeader,
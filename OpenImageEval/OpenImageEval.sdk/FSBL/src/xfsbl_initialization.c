@@ -71,6 +71,7 @@
 #include "xfsbl_main.h"
 #include "xfsbl_misc_drivers.h"
 #include "xfsbl_qspi.h"
+#include "xfsbl_profile.h"
 #include "xfsbl_csu_dma.h"
 #include "xfsbl_board.h"
 #include "xil_mmu.h"
@@ -99,6 +100,10 @@ static u32 XFsbl_ValidateHeader(XFsblPs * FsblInstancePtr);
 static u32 XFsbl_SecondaryBootDeviceInit(XFsblPs * FsblInstancePtr);
 static u32 XFsbl_DdrEccInit(void);
 static u32 XFsbl_EccInit(u64 DestAddr, u64 LengthBytes);
+static void XFsbl_ZdmaFill(u32 ChOffset, u64 DestAddr, u32 Length);
+#ifdef XFSBL_ECC_SCRUB
+static u32 XFsbl_EccScrubStart(u64 DestAddr, u64 LengthBytes, u32 *ChannelPtr);
+#endif
 static u32 XFsbl_TcmInit(XFsblPs * FsblInstancePtr);
 static void XFsbl_EnableProgToPL(void);
 static void XFsbl_ClearPendingInterrupts(void);
@@ -293,6 +298,7 @@ u32 XFsbl_Initialize(XFsblPs * FsblInstancePtr)
 		if (XFSBL_SUCCESS != Status) {
 			goto END;
 		}
+		XFsbl_ProfileMark(XFSBL_PROFILE_SYSTEM_INIT, 0U);
 	}
 	else
 	{
@@ -314,7 +320,9 @@ u32 XFsbl_Initialize(XFsblPs * FsblInstancePtr)
 	/**
 	 * Print the FSBL banner
 	 */
+#ifndef FSBL_BANNER_EXCLUDE
 	XFsbl_PrintFsblBanner();
+#endif
 
 	/* Initialize the processor */
 	Status = XFsbl_ProcessorInit(FsblInstancePtr);
@@ -322,6 +330,11 @@ u32 XFsbl_Initialize(XFsblPs * FsblInstancePtr)
 		goto END;
 	}
 
+#ifdef XFSBL_ECC_SCRUB
+	/* None is under way, unless XFsbl_DdrEccInit starts one */
+	((XFsblPs_EccScrub *)(PTRSIZE)XFSBL_ECC_SCRUB_ADDRESS)->Magic = 0U;
+#endif
+
 	if(FsblInstancePtr->ResetReason != XFSBL_APU_ONLY_RESET) {
 		/* Do ECC Initialization of TCM if required */
 		Status = XFsbl_TcmInit(FsblInstancePtr);
@@ -345,6 +358,7 @@ u32 XFsbl_Initialize(XFsblPs * FsblInstancePtr)
 			if (XFSBL_SUCCESS != Status) {
 				goto END;
 			}
+			XFsbl_ProfileMark(XFSBL_PROFILE_DDR_ECC_INIT, 0U);
 		}
 #else
 	/* Do ECC Initialization of DDR if required */
@@ -352,6 +366,7 @@ u32 XFsbl_Initialize(XFsblPs * FsblInstancePtr)
 	if (XFSBL_SUCCESS != Status) {
 		goto END;
 	}
+	XFsbl_ProfileMark(XFSBL_PROFILE_DDR_ECC_INIT, 0U);
 #endif
 
 #if defined(XFSBL_PL_CLEAR) && defined(XFSBL_BS)
@@ -951,6 +966,11 @@ static u32 XFsbl_PrimaryBootDeviceInit(XFsblPs * FsblInstancePtr)
             FsblInstancePtr->DeviceOps.DeviceInit = XFsbl_Qspi32Init;
 			FsblInstancePtr->DeviceOps.DeviceCopy = XFsbl_Qspi32Copy;
 			FsblInstancePtr->DeviceOps.DeviceRelease = XFsbl_Qspi32Release;
+#ifdef XFSBL_STREAM_HASH
+			FsblInstancePtr->DeviceOps.DeviceCopyStart =
+					XFsbl_Qspi32CopyStart;
+			FsblInstancePtr->DeviceOps.DeviceCopyWait = XFsbl_Qspi32CopyWait;
+#endif
 			Status = XFSBL_SUCCESS;
 #else
 			/**
@@ -1263,7 +1283,7 @@ static u32 XFsbl_ValidateHeader(XFsblPs * FsblInstancePtr)
 			Status = XFsbl_Authentication(FsblInstancePtr,
 					(PTRSIZE)ImageHdr,
 					Size + XFSBL_AUTH_CERT_MIN_SIZE,
-					(PTRSIZE)(AuthBuffer), 0x00U);
+					(PTRSIZE)(AuthBuffer), 0x00U, NULL);
 			if (Status != XFSBL_SUCCESS) {
 				XFsbl_Printf(DEBUG_GENERAL,
 					"Failure at image header"
@@ -1340,8 +1360,12 @@ static u32 XFsbl_SecondaryBootDeviceInit(XFsblPs * FsblInstancePtr)
 	u32 SecBootMode;
 
 	/**
-	 * Update the deviceops structure
+	 * Update the deviceops structure; only QSPI 32 bit can start copies
 	 */
+	if (FsblInstancePtr->SecondaryBootDevice != XIH_IHT_PPD_SAME) {
+		FsblInstancePtr->DeviceOps.DeviceCopyStart = NULL;
+		FsblInstancePtr->DeviceOps.DeviceCopyWait = NULL;
+	}
 
 	switch (FsblInstancePtr->SecondaryBootDevice) {
 	case XIH_IHT_PPD_SAME: {
@@ -1402,6 +1426,10 @@ static u32 XFsbl_SecondaryBootDeviceInit(XFsblPs * FsblInstancePtr)
 		FsblInstancePtr->DeviceOps.DeviceInit = XFsbl_Qspi32Init;
 		FsblInstancePtr->DeviceOps.DeviceCopy = XFsbl_Qspi32Copy;
 		FsblInstancePtr->DeviceOps.DeviceRelease = XFsbl_Qspi32Release;
+#ifdef XFSBL_STREAM_HASH
+		FsblInstancePtr->DeviceOps.DeviceCopyStart = XFsbl_Qspi32CopyStart;
+		FsblInstancePtr->DeviceOps.DeviceCopyWait = XFsbl_Qspi32CopyWait;
+#endif
 		SecBootMode = XFSBL_QSPI32_BOOT_MODE;
 		Status = XFSBL_SUCCESS;
 #else
@@ -1578,42 +1606,7 @@ static u32 XFsbl_EccInit(u64 DestAddr, u64 LengthBytes)
 			Length = (u32)NumBytes;
 		}
 
-		/* Wait until the DMA is in idle state */
-		do {
-			RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_STATUS);
-			RegVal &= ADMA_CH0_ZDMA_CH_STATUS_STATE_MASK;
-		} while ((RegVal != ADMA_CH0_ZDMA_CH_STATUS_STATE_DONE) &&
-				(RegVal != ADMA_CH0_ZDMA_CH_STATUS_STATE_ERR));
-
-		/* Enable Simple (Write Only) Mode */
-		RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_CTRL0);
-		RegVal &= (ADMA_CH0_ZDMA_CH_CTRL0_POINT_TYPE_MASK |
-				ADMA_CH0_ZDMA_CH_CTRL0_MODE_MASK);
-		RegVal |= (ADMA_CH0_ZDMA_CH_CTRL0_POINT_TYPE_NORMAL |
-				ADMA_CH0_ZDMA_CH_CTRL0_MODE_WR_ONLY);
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_CTRL0, RegVal);
-
-		/* Fill in the data to be written */
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD0, XFSBL_ECC_INIT_VAL_WORD);
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD1, XFSBL_ECC_INIT_VAL_WORD);
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD2, XFSBL_ECC_INIT_VAL_WORD);
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD3, XFSBL_ECC_INIT_VAL_WORD);
-
-		/* Write Destination Address */
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_DST_DSCR_WORD0,
-				(u32)(StartAddr & ADMA_CH0_ZDMA_CH_DST_DSCR_WORD0_LSB_MASK));
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_DST_DSCR_WORD1,
-				(u32)((StartAddr >> 32U) &
-						ADMA_CH0_ZDMA_CH_DST_DSCR_WORD1_MSB_MASK));
-
-		/* Size to be Transferred. Recommended to set both src and dest sizes */
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_SRC_DSCR_WORD2, Length);
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_DST_DSCR_WORD2, Length);
-
-		/* DMA Enable */
-		RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_CTRL2);
-		RegVal |= ADMA_CH0_ZDMA_CH_CTRL2_EN_MASK;
-		XFsbl_Out32(ADMA_CH0_ZDMA_CH_CTRL2, RegVal);
+		XFsbl_ZdmaFill(0U, StartAddr, Length);
 
 		/* Check the status of the transfer by polling on DMA Done */
 		do {
@@ -1661,6 +1654,179 @@ END:
 	return Status;
 }
 
+/*****************************************************************************/
+/**
+ * This function starts an ADMA channel filling memory with the ECC
+ * initialization pattern, and returns without waiting for it.
+ *
+ * @param	ChOffset is the offset of the channel's registers from channel 0's
+ * @param	DestAddr is start address from where to calculate ECC
+ * @param	Length is the length in bytes, at most ZDMA_TRANSFER_MAX_LEN
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+static void XFsbl_ZdmaFill(u32 ChOffset, u64 DestAddr, u32 Length)
+{
+	u32 RegVal;
+
+	/* Wait until the DMA is in idle state */
+	do {
+		RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_STATUS + ChOffset);
+		RegVal &= ADMA_CH0_ZDMA_CH_STATUS_STATE_MASK;
+	} while ((RegVal != ADMA_CH0_ZDMA_CH_STATUS_STATE_DONE) &&
+			(RegVal != ADMA_CH0_ZDMA_CH_STATUS_STATE_ERR));
+
+	/* Enable Simple (Write Only) Mode */
+	RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_CTRL0 + ChOffset);
+	RegVal &= (ADMA_CH0_ZDMA_CH_CTRL0_POINT_TYPE_MASK |
+			ADMA_CH0_ZDMA_CH_CTRL0_MODE_MASK);
+	RegVal |= (ADMA_CH0_ZDMA_CH_CTRL0_POINT_TYPE_NORMAL |
+			ADMA_CH0_ZDMA_CH_CTRL0_MODE_WR_ONLY);
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_CTRL0 + ChOffset, RegVal);
+
+	/* Fill in the data to be written */
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD0 + ChOffset,
+			XFSBL_ECC_INIT_VAL_WORD);
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD1 + ChOffset,
+			XFSBL_ECC_INIT_VAL_WORD);
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD2 + ChOffset,
+			XFSBL_ECC_INIT_VAL_WORD);
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_WR_ONLY_WORD3 + ChOffset,
+			XFSBL_ECC_INIT_VAL_WORD);
+
+	/* Write Destination Address */
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_DST_DSCR_WORD0 + ChOffset,
+			(u32)(DestAddr & ADMA_CH0_ZDMA_CH_DST_DSCR_WORD0_LSB_MASK));
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_DST_DSCR_WORD1 + ChOffset,
+			(u32)((DestAddr >> 32U) &
+					ADMA_CH0_ZDMA_CH_DST_DSCR_WORD1_MSB_MASK));
+
+	/* Size to be Transferred. Recommended to set both src and dest sizes */
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_SRC_DSCR_WORD2 + ChOffset, Length);
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_DST_DSCR_WORD2 + ChOffset, Length);
+
+	/* DMA Enable */
+	RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_CTRL2 + ChOffset);
+	RegVal |= ADMA_CH0_ZDMA_CH_CTRL2_EN_MASK;
+	XFsbl_Out32(ADMA_CH0_ZDMA_CH_CTRL2 + ChOffset, RegVal);
+}
+
+#ifdef XFSBL_ECC_SCRUB
+/*****************************************************************************/
+/**
+ * This function starts the ECC initialization of a range of DDR in the
+ * background, each ZDMA_TRANSFER_MAX_LEN of it on the next free ADMA
+ * channel.  Once the channels run out, the rest is done here and now.
+ * The FSBL does not touch the range, so the cache need not be disabled.
+ *
+ * @param	DestAddr is start address from where to calculate ECC
+ * @param	LengthBytes is length in bytes from start address to calculate ECC
+ * @param	ChannelPtr is the next free channel; updated
+ *
+ * @return
+ * 		- XFSBL_SUCCESS for successful start
+ * 		- errors as mentioned in xfsbl_error.h
+ *
+ *****************************************************************************/
+static u32 XFsbl_EccScrubStart(u64 DestAddr, u64 LengthBytes, u32 *ChannelPtr)
+{
+	u32 Status = XFSBL_SUCCESS;
+	u32 Length;
+	u32 ChOffset;
+	u64 StartAddr = DestAddr;
+	u64 NumBytes = LengthBytes;
+	XFsblPs_EccScrub *ScrubPtr =
+		(XFsblPs_EccScrub *)(PTRSIZE)XFSBL_ECC_SCRUB_ADDRESS;
+
+	while ((NumBytes > 0U) && (*ChannelPtr <= XFSBL_ECC_SCRUB_LAST_CH)) {
+		if (NumBytes > ZDMA_TRANSFER_MAX_LEN) {
+			Length = ZDMA_TRANSFER_MAX_LEN;
+		} else {
+			Length = (u32)NumBytes;
+		}
+
+		/* A stale DMA done would let the application in early */
+		ChOffset = *ChannelPtr * ADMA_CH_OFFSET;
+		XFsbl_Out32(ADMA_CH0_ZDMA_CH_ISR + ChOffset,
+				ADMA_CH0_ZDMA_CH_ISR_DMA_DONE_MASK);
+		XFsbl_ZdmaFill(ChOffset, StartAddr, Length);
+		ScrubPtr->Start[*ChannelPtr] = StartAddr;
+		ScrubPtr->Length[*ChannelPtr] = Length;
+
+		XFsbl_Printf(DEBUG_INFO,
+			"Address 0x%0lx, Length %0lx, ECC init on ADMA channel %u\r\n",
+			StartAddr, Length, *ChannelPtr);
+
+		*ChannelPtr += 1U;
+		NumBytes -= Length;
+		StartAddr += Length;
+	}
+
+	if (NumBytes > 0U) {
+		Status = XFsbl_EccInit(StartAddr, NumBytes);
+	}
+
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * This function waits for the channels of the background ECC
+ * initialization that cover any of the given range; for partitions loaded
+ * there.
+ *
+ * @param	Address is the start of the range
+ * @param	Length is its length in bytes
+ *
+ * @return
+ * 		- XFSBL_SUCCESS once the range is initialized, or if it is not
+ * 		                being initialized in the background
+ * 		- XFSBL_ERROR_DDR_ECC_INIT if a channel failed
+ *
+ *****************************************************************************/
+u32 XFsbl_EccScrubWait(PTRSIZE Address, u64 Length)
+{
+	u32 Status = XFSBL_SUCCESS;
+	u32 Channel;
+	u32 ChOffset;
+	u32 RegVal;
+	const XFsblPs_EccScrub *ScrubPtr =
+		(const XFsblPs_EccScrub *)(PTRSIZE)XFSBL_ECC_SCRUB_ADDRESS;
+
+	if (ScrubPtr->Magic != XFSBL_ECC_SCRUB_MAGIC) {
+		goto END;
+	}
+
+	for (Channel = XFSBL_ECC_SCRUB_FIRST_CH;
+			Channel <= XFSBL_ECC_SCRUB_LAST_CH; Channel++) {
+		if (((ScrubPtr->ChannelMask & ((u32)1U << Channel)) == 0U) ||
+				(((u64)Address + Length) <= ScrubPtr->Start[Channel]) ||
+				((u64)Address >= (ScrubPtr->Start[Channel] +
+					ScrubPtr->Length[Channel]))) {
+			continue;
+		}
+
+		ChOffset = Channel * ADMA_CH_OFFSET;
+		do {
+			RegVal = XFsbl_In32(ADMA_CH0_ZDMA_CH_ISR + ChOffset) &
+					ADMA_CH0_ZDMA_CH_ISR_DMA_DONE_MASK;
+			if ((XFsbl_In32(ADMA_CH0_ZDMA_CH_STATUS + ChOffset) &
+					ADMA_CH0_ZDMA_CH_STATUS_STATE_MASK) ==
+					ADMA_CH0_ZDMA_CH_STATUS_STATE_ERR) {
+				Status = XFSBL_ERROR_DDR_ECC_INIT;
+				XFsbl_Printf(DEBUG_GENERAL,
+					"XFSBL_ERROR_DDR_ECC_INIT\n\r");
+				goto END;
+			}
+		} while (RegVal != ADMA_CH0_ZDMA_CH_ISR_DMA_DONE_MASK);
+	}
+
+END:
+	return Status;
+}
+#endif
+
 /*****************************************************************************/
 /**
  * This function does ECC Initialization of DDR memory
@@ -1680,6 +1846,18 @@ static u32 XFsbl_DdrEccInit(void)
 	u64 LengthBytes =
 			(XFSBL_PS_DDR_END_ADDRESS - XFSBL_PS_DDR_INIT_START_ADDRESS) + 1;
 	u64 DestAddr = XFSBL_PS_DDR_INIT_START_ADDRESS;
+#ifdef XFSBL_ECC_SCRUB
+	XFsblPs_EccScrub *ScrubPtr =
+		(XFsblPs_EccScrub *)(PTRSIZE)XFSBL_ECC_SCRUB_ADDRESS;
+	u32 Channel = XFSBL_ECC_SCRUB_FIRST_CH;
+	u64 HeadAddr;
+	u64 StrideBytes;
+
+	/* Only what the FSBL and the application's image need, now */
+	if (XFSBL_PS_DDR_END_ADDRESS >= XFSBL_ECC_SCRUB_START_ADDRESS) {
+		LengthBytes = XFSBL_ECC_SCRUB_START_ADDRESS - DestAddr;
+	}
+#endif
 
 	XFsbl_Printf(DEBUG_GENERAL,"Initializing DDR ECC\n\r");
 
@@ -1690,6 +1868,51 @@ static u32 XFsbl_DdrEccInit(void)
 		goto END;
 	}
 
+#ifdef XFSBL_ECC_SCRUB
+	/*
+	 * The rest, and any upper PS DDR, in the background; but for the head
+	 * of each stride, now
+	 */
+	for (HeadAddr = XFSBL_ECC_SCRUB_START_ADDRESS;
+			(XFSBL_SUCCESS == Status) &&
+			(HeadAddr <= XFSBL_PS_DDR_END_ADDRESS);
+			HeadAddr += XFSBL_ECC_SCRUB_STRIDE) {
+		StrideBytes = (XFSBL_PS_DDR_END_ADDRESS - HeadAddr) + 1;
+		if (StrideBytes > XFSBL_ECC_SCRUB_STRIDE) {
+			StrideBytes = XFSBL_ECC_SCRUB_STRIDE;
+		}
+
+		if (StrideBytes <= XFSBL_ECC_SCRUB_HEAD_LENGTH) {
+			Status = XFsbl_EccInit(HeadAddr, StrideBytes);
+		} else {
+			Status = XFsbl_EccInit(HeadAddr,
+					XFSBL_ECC_SCRUB_HEAD_LENGTH);
+			if (XFSBL_SUCCESS == Status) {
+				Status = XFsbl_EccScrubStart(
+					HeadAddr + XFSBL_ECC_SCRUB_HEAD_LENGTH,
+					StrideBytes - XFSBL_ECC_SCRUB_HEAD_LENGTH,
+					&Channel);
+			}
+		}
+	}
+#ifdef XFSBL_PS_HI_DDR_START_ADDRESS
+	if (XFSBL_SUCCESS == Status) {
+		Status = XFsbl_EccScrubStart(XFSBL_PS_HI_DDR_START_ADDRESS,
+				(XFSBL_PS_HI_DDR_END_ADDRESS -
+					XFSBL_PS_HI_DDR_START_ADDRESS) + 1,
+				&Channel);
+	}
+#endif
+	if (XFSBL_SUCCESS != Status) {
+		Status = XFSBL_ERROR_DDR_ECC_INIT;
+		XFsbl_Printf(DEBUG_GENERAL,"XFSBL_ERROR_DDR_ECC_INIT\n\r");
+		goto END;
+	}
+
+	ScrubPtr->ChannelMask = ((u32)1U << Channel) -
+			((u32)1U << XFSBL_ECC_SCRUB_FIRST_CH);
+	ScrubPtr->Magic = XFSBL_ECC_SCRUB_MAGIC;
+#else
 	/* If there is upper PS DDR, initialize its ECC */
 #ifdef XFSBL_PS_HI_DDR_START_ADDRESS
 	LengthBytes =
@@ -1703,6 +1926,7 @@ static u32 XFsbl_DdrEccInit(void)
 		goto END;
 	}
 #endif
+#endif
 END:
 #else
 	Status = XFSBL_SUCCESS;
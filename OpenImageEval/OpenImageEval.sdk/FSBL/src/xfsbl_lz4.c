@@ -0,0 +1,361 @@
+/*****************************************************************************/
+/**
+*
+* @file xfsbl_lz4.c
+*
+* This file contains the decoder of compressed partitions (see
+* xfsbl_lz4.h).  Every length and offset is checked before it is used, so
+* that a corrupt partition ends in XFSBL_LZ4_ERROR rather than a write
+* outside the buffer.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00  agent 10/19/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xfsbl_lz4.h"
+
+/************************** Constant Definitions *****************************/
+
+/**
+ * States of the decoder; each is the field it is waiting for.
+ */
+#define XFSBL_LZ4_S_MAGIC		(0U)
+#define XFSBL_LZ4_S_LENGTH		(1U)
+#define XFSBL_LZ4_S_BLOCK_SIZE		(2U)
+#define XFSBL_LZ4_S_STORED		(3U)
+#define XFSBL_LZ4_S_TOKEN		(4U)
+#define XFSBL_LZ4_S_LITLEN		(5U)
+#define XFSBL_LZ4_S_LITERALS		(6U)
+#define XFSBL_LZ4_S_OFFSET		(7U)
+#define XFSBL_LZ4_S_MATCHLEN		(8U)
+#define XFSBL_LZ4_S_MATCH		(9U)
+#define XFSBL_LZ4_S_END			(10U)
+#define XFSBL_LZ4_S_ERROR		(11U)
+
+#define XFSBL_LZ4_MIN_MATCH		(4U)
+#define XFSBL_LZ4_RUN_MASK		(0xFU)
+#define XFSBL_LZ4_LEN_MORE		(255U)
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+static uint32_t XFsbl_Lz4HasRoom(const XFsblLz4 *Lz4, uint32_t Len);
+static uint32_t XFsbl_Lz4EndLiterals(XFsblLz4 *Lz4);
+
+/************************** Variable Definitions *****************************/
+
+/*****************************************************************************/
+/**
+ * This function readies the decoder for a partition.
+ *
+ * @param	Lz4 is the decoder
+ *
+ * @param	Out is where the partition is decompressed to
+ *
+ * @param	OutSize is the room there; at least XFSBL_LZ4_BLOCK_SIZE if
+ *		the decoder is rewound after each block
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+void XFsbl_Lz4Init(XFsblLz4 *Lz4, uint8_t *Out, uint32_t OutSize)
+{
+	Lz4->Out = Out;
+	Lz4->OutSize = OutSize;
+	Lz4->OutPos = 0U;
+	Lz4->BlockStart = 0U;
+	Lz4->Length = 0U;
+	Lz4->Decoded = 0U;
+	Lz4->State = XFSBL_LZ4_S_MAGIC;
+	Lz4->Field = 0U;
+	Lz4->Value = 0U;
+	Lz4->BlockLeft = 0U;
+	Lz4->Token = 0U;
+	Lz4->RunLeft = 0U;
+	Lz4->Offset = 0U;
+}
+
+/*****************************************************************************/
+/**
+ * This function decompresses the next piece of the partition.  It returns
+ * at the end of each block, so that the caller may take the block away
+ * (and rewind) before the next; otherwise it uses all of the input.
+ *
+ * @param	Lz4 is the decoder
+ *
+ * @param	In is the next piece of the partition
+ *
+ * @param	InLen is its length, in bytes
+ *
+ * @param	UsedPtr receives the number of bytes of it used
+ *
+ * @return	XFSBL_LZ4_MORE if all of the input was used,
+ *		XFSBL_LZ4_BLOCK if a block was completed (Out holds it, from
+ *		BlockStart to OutPos),
+ *		XFSBL_LZ4_DONE if the partition was completed, or
+ *		XFSBL_LZ4_ERROR if it is malformed or does not fit
+ *
+ *****************************************************************************/
+uint32_t XFsbl_Lz4Decode(XFsblLz4 *Lz4, const uint8_t *In, uint32_t InLen,
+		uint32_t *UsedPtr)
+{
+	uint32_t Status = XFSBL_LZ4_MORE;
+	uint32_t Pos = 0U;
+	uint32_t Len;
+	uint32_t Byte;
+	uint32_t Index;
+
+	while ((Status == XFSBL_LZ4_MORE) && (Pos < InLen)) {
+		switch (Lz4->State) {
+		case XFSBL_LZ4_S_MAGIC:
+		case XFSBL_LZ4_S_LENGTH:
+		case XFSBL_LZ4_S_BLOCK_SIZE:
+			/* Little-endian words */
+			Lz4->Value |= (uint32_t)In[Pos] << (8U * Lz4->Field);
+			Pos++;
+			Lz4->Field++;
+			if (Lz4->Field < 4U) {
+				break;
+			}
+			Byte = Lz4->Value;
+			Lz4->Field = 0U;
+			Lz4->Value = 0U;
+
+			if (Lz4->State == XFSBL_LZ4_S_MAGIC) {
+				Lz4->State = (Byte == XFSBL_LZ4_MAGIC) ?
+					XFSBL_LZ4_S_LENGTH : XFSBL_LZ4_S_ERROR;
+			} else if (Lz4->State == XFSBL_LZ4_S_LENGTH) {
+				Lz4->Length = Byte;
+				Lz4->State = XFSBL_LZ4_S_BLOCK_SIZE;
+			} else if (Byte == 0U) {
+				/* The end */
+				if (Lz4->Decoded == Lz4->Length) {
+					Lz4->State = XFSBL_LZ4_S_END;
+					Status = XFSBL_LZ4_DONE;
+				} else {
+					Lz4->State = XFSBL_LZ4_S_ERROR;
+				}
+			} else {
+				Lz4->BlockLeft = Byte & ~XFSBL_LZ4_STORED;
+				Lz4->BlockStart = Lz4->OutPos;
+				if ((Lz4->BlockLeft == 0U) ||
+				    (Lz4->BlockLeft > XFSBL_LZ4_BLOCK_SIZE)) {
+					Lz4->State = XFSBL_LZ4_S_ERROR;
+				} else if ((Byte & XFSBL_LZ4_STORED) != 0U) {
+					Lz4->RunLeft = Lz4->BlockLeft;
+					Lz4->State =
+						(XFsbl_Lz4HasRoom(Lz4, Lz4->RunLeft)
+						 != 0U) ? XFSBL_LZ4_S_STORED :
+						XFSBL_LZ4_S_ERROR;
+				} else {
+					Lz4->State = XFSBL_LZ4_S_TOKEN;
+				}
+			}
+			break;
+
+		case XFSBL_LZ4_S_STORED:
+		case XFSBL_LZ4_S_LITERALS:
+			/* Copied as they are; the room was checked before */
+			Len = InLen - Pos;
+			if (Len > Lz4->RunLeft) {
+				Len = Lz4->RunLeft;
+			}
+			for (Index = 0U; Index < Len; Index++) {
+				Lz4->Out[Lz4->OutPos + Index] = In[Pos + Index];
+			}
+			Pos += Len;
+			Lz4->OutPos += Len;
+			Lz4->Decoded += Len;
+			Lz4->BlockLeft -= Len;
+			Lz4->RunLeft -= Len;
+			if (Lz4->RunLeft != 0U) {
+				break;
+			}
+
+			if (Lz4->State == XFSBL_LZ4_S_STORED) {
+				Lz4->State = XFSBL_LZ4_S_BLOCK_SIZE;
+				Status = XFSBL_LZ4_BLOCK;
+			} else {
+				Status = XFsbl_Lz4EndLiterals(Lz4);
+			}
+			break;
+
+		case XFSBL_LZ4_S_TOKEN:
+			Lz4->Token = In[Pos];
+			Pos++;
+			Lz4->BlockLeft--;
+			Lz4->RunLeft = Lz4->Token >> 4U;
+			if (Lz4->RunLeft == XFSBL_LZ4_RUN_MASK) {
+				Lz4->State = XFSBL_LZ4_S_LITLEN;
+			} else if ((Lz4->RunLeft > Lz4->BlockLeft) ||
+				   (XFsbl_Lz4HasRoom(Lz4, Lz4->RunLeft) == 0U)) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			} else if (Lz4->RunLeft != 0U) {
+				Lz4->State = XFSBL_LZ4_S_LITERALS;
+			} else {
+				Status = XFsbl_Lz4EndLiterals(Lz4);
+			}
+			break;
+
+		case XFSBL_LZ4_S_LITLEN:
+		case XFSBL_LZ4_S_MATCHLEN:
+			/* Lengths of 15 and over go on in bytes, ending < 255 */
+			if (Lz4->BlockLeft == 0U) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+				break;
+			}
+			Byte = In[Pos];
+			Pos++;
+			Lz4->BlockLeft--;
+			Lz4->RunLeft += Byte;
+			if (Lz4->RunLeft > XFSBL_LZ4_BLOCK_SIZE) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			} else if (Byte == XFSBL_LZ4_LEN_MORE) {
+				/* More to come */
+			} else if (XFsbl_Lz4HasRoom(Lz4, Lz4->RunLeft) == 0U) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			} else if (Lz4->State == XFSBL_LZ4_S_MATCHLEN) {
+				Lz4->State = XFSBL_LZ4_S_MATCH;
+			} else if (Lz4->RunLeft > Lz4->BlockLeft) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			} else {
+				Lz4->State = XFSBL_LZ4_S_LITERALS;
+			}
+			break;
+
+		case XFSBL_LZ4_S_OFFSET:
+			if (Lz4->BlockLeft == 0U) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+				break;
+			}
+			Lz4->Value |= (uint32_t)In[Pos] << (8U * Lz4->Field);
+			Pos++;
+			Lz4->BlockLeft--;
+			Lz4->Field++;
+			if (Lz4->Field < 2U) {
+				break;
+			}
+			Lz4->Offset = Lz4->Value;
+			Lz4->Field = 0U;
+			Lz4->Value = 0U;
+
+			/* Matches may not reach before the block */
+			Lz4->RunLeft = (Lz4->Token & XFSBL_LZ4_RUN_MASK) +
+					XFSBL_LZ4_MIN_MATCH;
+			if ((Lz4->Offset == 0U) ||
+			    (Lz4->Offset > (Lz4->OutPos - Lz4->BlockStart))) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			} else if ((Lz4->Token & XFSBL_LZ4_RUN_MASK) ==
+				   XFSBL_LZ4_RUN_MASK) {
+				Lz4->State = XFSBL_LZ4_S_MATCHLEN;
+			} else if (XFsbl_Lz4HasRoom(Lz4, Lz4->RunLeft) == 0U) {
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			} else {
+				Lz4->State = XFSBL_LZ4_S_MATCH;
+			}
+			break;
+
+		default:
+			/* Finished, or failed; nothing more is taken */
+			Status = (Lz4->State == XFSBL_LZ4_S_END) ?
+					XFSBL_LZ4_DONE : XFSBL_LZ4_ERROR;
+			break;
+		}
+
+		/* A match needs no input, so is done as soon as it is known */
+		if (Lz4->State == XFSBL_LZ4_S_MATCH) {
+			for (Index = 0U; Index < Lz4->RunLeft; Index++) {
+				Lz4->Out[Lz4->OutPos + Index] =
+				    Lz4->Out[Lz4->OutPos + Index - Lz4->Offset];
+			}
+			Lz4->OutPos += Lz4->RunLeft;
+			Lz4->Decoded += Lz4->RunLeft;
+			Lz4->RunLeft = 0U;
+			Lz4->State = XFSBL_LZ4_S_TOKEN;
+			if (Lz4->BlockLeft == 0U) {
+				/* A block ends with literals, not a match */
+				Lz4->State = XFSBL_LZ4_S_ERROR;
+			}
+		}
+
+		if (Lz4->State == XFSBL_LZ4_S_ERROR) {
+			Status = XFSBL_LZ4_ERROR;
+		}
+	}
+
+	*UsedPtr = Pos;
+	return Status;
+}
+
+/*****************************************************************************/
+/**
+ * This function starts the next block at the start of the output buffer,
+ * once the caller has taken the last one away.
+ *
+ * @param	Lz4 is the decoder
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+void XFsbl_Lz4Rewind(XFsblLz4 *Lz4)
+{
+	Lz4->OutPos = 0U;
+	Lz4->BlockStart = 0U;
+}
+
+/*****************************************************************************/
+/**
+ * This function checks that a run of output fits the block, the buffer and
+ * the partition.
+ *
+ * @param	Lz4 is the decoder
+ *
+ * @param	Len is the length of the run, in bytes
+ *
+ * @return	Nonzero if it fits
+ *
+ *****************************************************************************/
+static uint32_t XFsbl_Lz4HasRoom(const XFsblLz4 *Lz4, uint32_t Len)
+{
+	return (uint32_t)((Len <= (XFSBL_LZ4_BLOCK_SIZE -
+				(Lz4->OutPos - Lz4->BlockStart))) &&
+			(Len <= (Lz4->OutSize - Lz4->OutPos)) &&
+			(Len <= (Lz4->Length - Lz4->Decoded)));
+}
+
+/*****************************************************************************/
+/**
+ * This function moves on from a sequence's literals:  to its match, or, if
+ * the block has no more, to the next block.
+ *
+ * @param	Lz4 is the decoder
+ *
+ * @return	XFSBL_LZ4_BLOCK if the block is complete, else XFSBL_LZ4_MORE
+ *
+ *****************************************************************************/
+static uint32_t XFsbl_Lz4EndLiterals(XFsblLz4 *Lz4)
+{
+	uint32_t Status = XFSBL_LZ4_MORE;
+
+	if (Lz4->BlockLeft == 0U) {
+		Lz4->State = XFSBL_LZ4_S_BLOCK_SIZE;
+		Status = XFSBL_LZ4_BLOCK;
+	} else {
+		Lz4->State = XFSBL_LZ4_S_OFFSET;
+	}
+
+	return Status;
+}
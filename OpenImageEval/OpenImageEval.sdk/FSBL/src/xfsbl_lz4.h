@@ -0,0 +1,98 @@
+/*****************************************************************************/
+/**
+*
+* @file xfsbl_lz4.h
+*
+* This is the header file which contains definitions for the decoder of
+* compressed partitions (those with XIH_PH_ATTRB_COMPRESSED set).  The
+* decoder takes its input in pieces of any size, as the boot device reads
+* them, and keeps its place between them.
+*
+* It is portable C, without the FSBL's headers, so that the host tools
+* (oiBootPack, which writes compressed partitions) build it too.
+*
+* A compressed partition is:
+*
+*   u32 XFSBL_LZ4_MAGIC
+*   u32 length of the data, decompressed
+*   blocks, each:
+*     u32 size of the block's data, with XFSBL_LZ4_STORED if it is stored
+*         as it is rather than compressed; zero ends the partition
+*     the block's data:  one LZ4 block (see the LZ4 block format), which
+*         decompresses to at most XFSBL_LZ4_BLOCK_SIZE bytes, and whose
+*         matches do not reach before its start
+*   padding to a word
+*
+* All fields are little-endian.  Each block stands alone so that it can be
+* decompressed into a small buffer, e.g. on its way to the PCAP.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00  agent 10/19/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef XFSBL_LZ4_H
+#define XFSBL_LZ4_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include <stdint.h>
+
+/************************** Constant Definitions *****************************/
+
+#define XFSBL_LZ4_MAGIC			(0x345A4C4FU)	/* "OLZ4" */
+#define XFSBL_LZ4_BLOCK_SIZE		(32U * 1024U)
+#define XFSBL_LZ4_STORED		(0x80000000U)
+
+/**
+ * Results of XFsbl_Lz4Decode
+ */
+#define XFSBL_LZ4_MORE			(0U)	/* all input used */
+#define XFSBL_LZ4_BLOCK			(1U)	/* a block is complete */
+#define XFSBL_LZ4_DONE			(2U)	/* the partition is complete */
+#define XFSBL_LZ4_ERROR			(3U)	/* malformed, or no room */
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	uint8_t *Out;		/**< Where the blocks are decompressed to */
+	uint32_t OutSize;	/**< Room there */
+	uint32_t OutPos;	/**< Bytes written there */
+	uint32_t BlockStart;	/**< OutPos at the start of the block */
+	uint32_t Length;	/**< Decompressed length, from the header */
+	uint32_t Decoded;	/**< Bytes decompressed so far, of all blocks */
+	uint32_t State;
+	uint32_t Field;		/**< Bytes of the field read so far */
+	uint32_t Value;		/**< The field being read */
+	uint32_t BlockLeft;	/**< Input bytes left in the block */
+	uint32_t Token;		/**< Of the sequence */
+	uint32_t RunLeft;	/**< Bytes left of the literals or match */
+	uint32_t Offset;	/**< Of the match */
+} XFsblLz4;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+void XFsbl_Lz4Init(XFsblLz4 *Lz4, uint8_t *Out, uint32_t OutSize);
+uint32_t XFsbl_Lz4Decode(XFsblLz4 *Lz4, const uint8_t *In, uint32_t InLen,
+		uint32_t *UsedPtr);
+void XFsbl_Lz4Rewind(XFsblLz4 *Lz4);
+
+/************************** Variable Definitions *****************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* XFSBL_LZ4_H */
@@ -52,6 +52,7 @@
 /***************************** Include Files *********************************/
 #include "xfsbl_hw.h"
 #include "xfsbl_main.h"
+#include "xfsbl_profile.h"
 #include "bspconfig.h"
 
 /************************** Constant Definitions *****************************/
@@ -100,6 +101,11 @@ int main(void )
 #error "FSBL should be generated using only EL3 BSP"
 #endif
 
+	/**
+	 * Start the boot profile
+	 */
+	XFsbl_ProfileInit();
+
 	/**
 	 * Initialize globals.
 	 */
@@ -126,6 +132,7 @@ int main(void )
 					 * Include the code for FSBL time measurements
 					 * Initialize the global timer and get the value
 					 */
+					XFsbl_ProfileMark(XFSBL_PROFILE_INIT_DONE, 0U);
 
 					FsblStage = XFSBL_STAGE2;
 				}
@@ -190,6 +197,7 @@ int main(void )
 
 					FsblStage = XFSBL_STAGE3;
 				}
+				XFsbl_ProfileMark(XFSBL_PROFILE_BOOT_DEVICE, 0U);
 #ifdef XFSBL_PERF
 				XFsbl_MeasurePerfTime(tCur);
 				XFsbl_Printf(DEBUG_PRINT_ALWAYS, " : Boot Dev. Init. Time\n\r");
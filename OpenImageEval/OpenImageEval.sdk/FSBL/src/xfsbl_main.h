@@ -168,6 +168,34 @@ typedef struct {
 /* Pattern to be filled for DDR ECC Initialization */
 #define XFSBL_ECC_INIT_VAL_WORD 0xDEADBEEFU
 
+/**
+ * DDR from XFSBL_ECC_SCRUB_START_ADDRESS up (the application's sample
+ * buffers) has its ECC initialized in the background, by the ADMA channels
+ * from XFSBL_ECC_SCRUB_FIRST_CH on, which are still running at handoff.
+ * Which channels, and the range of each, is left at XFSBL_ECC_SCRUB_ADDRESS,
+ * beside the boot profile, for the application to wait on.
+ *
+ * The first XFSBL_ECC_SCRUB_HEAD_LENGTH of each XFSBL_ECC_SCRUB_STRIDE from
+ * there (the start of each ADC's buffer, where the application records its
+ * calibration) is initialized before handoff, so that the calibration need
+ * not wait for the rest.
+ */
+#define XFSBL_ECC_SCRUB_START_ADDRESS	(0x40000000U)
+#define XFSBL_ECC_SCRUB_STRIDE		(0x20000000U)
+#define XFSBL_ECC_SCRUB_HEAD_LENGTH	(0x10000U)
+#define XFSBL_ECC_SCRUB_ADDRESS		(XFSBL_OCM_RESERVED_START_ADDRESS + 0x400U)
+#define XFSBL_ECC_SCRUB_MAGIC		(0x42524353U)	/* "SCRB" */
+#define XFSBL_ECC_SCRUB_FIRST_CH	(1U)
+#define XFSBL_ECC_SCRUB_LAST_CH		(7U)
+#define ADMA_CH_OFFSET			(0x10000U)
+
+typedef struct {
+	u32 Magic;
+	u32 ChannelMask;	/**< Bit n for ADMA channel n */
+	u64 Start[XFSBL_ECC_SCRUB_LAST_CH + 1U];	/**< Of channel n's range */
+	u64 Length[XFSBL_ECC_SCRUB_LAST_CH + 1U];
+} XFsblPs_EccScrub;
+
 #define XFSBL_R50_TCM_ECC_INIT_STATUS 0x00000001U
 #define XFSBL_R51_TCM_ECC_INIT_STATUS 0x00000002U
 
@@ -197,6 +225,9 @@ void XFsbl_MeasurePerfTime(XTime tCur);
 u32 XFsbl_Initialize(XFsblPs * FsblInstancePtr);
 u32 XFsbl_BootDeviceInitAndValidate(XFsblPs * FsblInstancePtr);
 u32 XFsbl_TcmEccInit(XFsblPs * FsblInstancePtr, u32 CpuId);
+#ifdef XFSBL_ECC_SCRUB
+u32 XFsbl_EccScrubWait(PTRSIZE Address, u64 Length);
+#endif
 void XFsbl_MarkDdrAsReserved(u8 Cond);
 
 /**
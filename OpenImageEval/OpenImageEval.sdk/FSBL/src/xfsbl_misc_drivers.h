@@ -86,6 +86,11 @@ typedef struct {
 		/**< Function pointer for device copy */
 	u32 (*DeviceRelease) ();
 		/**< Function pointer for device release */
+	u32 (*DeviceCopyStart) (u32 SrcAddress, PTRSIZE DestAddress, u32 Length);
+		/**< Function pointer to start a copy without waiting for it;
+		 * NULL if the device has none */
+	u32 (*DeviceCopyWait) (void);
+		/**< Function pointer to wait for the copy started */
 } XFsblPs_DeviceOps;
 
 
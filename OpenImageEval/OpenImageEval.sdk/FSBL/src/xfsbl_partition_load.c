@@ -75,7 +75,15 @@
 #include "xfsbl_bs.h"
 #include "psu_init.h"
 #include "xfsbl_plpartition_valid.h"
+#include "xfsbl_profile.h"
 /************************** Constant Definitions *****************************/
+#ifdef XFSBL_STREAM_HASH
+/**
+ * Size of the chunks in which a partition is hashed as it is copied; each
+ * is hashed while the next is read
+ */
+#define XFSBL_STREAM_CHUNK_SIZE		(64U * 1024U)
+#endif
 
 /**************************** Type Definitions *******************************/
 
@@ -111,6 +119,13 @@ static u32 XFsbl_CalcualteSHA(const XFsblPs* FsblInstancePtr,
 		PTRSIZE LoadAddress, u32 PartitionNum, u32 ShaType);
 #endif
 
+#ifdef XFSBL_STREAM_HASH
+static u32 XFsbl_IsHashStreamable(XFsblPs * FsblInstancePtr,
+		u32 PartitionNum);
+static u32 XFsbl_PartitionCopyAndHash(XFsblPs * FsblInstancePtr,
+		u32 PartitionNum, u32 SrcAddress, PTRSIZE LoadAddress, u32 Length);
+#endif
+
 #ifdef ARMR5
 static void XFsbl_SetR5ExcepVectorHiVec(void);
 static void XFsbl_SetR5ExcepVectorLoVec(void);
@@ -127,6 +142,12 @@ static void XFsbl_SetR5ExcepVectorLoVec(void);
 #ifdef XFSBL_SECURE
 u32 Iv[XIH_BH_IV_LENGTH / 4U] = { 0 };
 u8 AuthBuffer[XFSBL_AUTH_BUFFER_SIZE]__attribute__ ((aligned (4))) = {0};
+/**
+ * Hash of the partition being loaded, if it was taken as it was copied;
+ * the checksum, or for authentication, that of the data and the AC
+ */
+static u8 StreamedHash[XFSBL_HASH_TYPE_SHA3] __attribute__ ((aligned (4)));
+static u32 IsHashStreamed = FALSE;
 #ifdef XFSBL_BS
 #ifdef __clang__
 u8 HashsOfChunks[HASH_BUFFER_SIZE] __attribute__((section (".bss.bitstream_buffer")));
@@ -173,6 +194,7 @@ u32 XFsbl_PartitionLoad(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 	/**
 	 * Load and validate the partition
 	 */
+	XFsbl_ProfileMark(XFSBL_PROFILE_PARTITION_START, PartitionNum);
 
 	/**
 	 * Partition Header Validation
@@ -203,6 +225,7 @@ u32 XFsbl_PartitionLoad(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 	{
 		goto END;
 	}
+	XFsbl_ProfileMark(XFSBL_PROFILE_PARTITION_COPIED, PartitionNum);
 
 	/**
 	 * Partition Validation
@@ -252,6 +275,7 @@ u32 XFsbl_PartitionLoad(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 
 	/* Check if PMU FW load is done and handoff it to Microblaze */
 	XFsbl_CheckPmuFw(FsblInstancePtr, PartitionNum);
+	XFsbl_ProfileMark(XFSBL_PROFILE_PARTITION_DONE, PartitionNum);
 
 END:
 	return Status;
@@ -847,6 +871,10 @@ static u32 XFsbl_PartitionCopy(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 
 	RunningCpu = FsblInstancePtr->ProcessorID;
 
+#ifdef XFSBL_SECURE
+	IsHashStreamed = FALSE;
+#endif
+
 	/**
 	 * Check for XIP image
 	 * No need to copy for XIP image
@@ -905,6 +933,29 @@ static u32 XFsbl_PartitionCopy(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 					XIH_PARTITION_WORD_LENGTH;
 	DestinationDevice = XFsbl_GetDestinationDevice(PartitionHeader);
 
+#ifdef XFSBL_LZ4
+	/**
+	 * A compressed bitstream is decompressed on its way to the PCAP, in
+	 * XFsbl_PartitionValidation; anything else, to its load address, for
+	 * which the length is that decompressed
+	 */
+	if (XFsbl_IsCompressed(PartitionHeader) != 0U)
+	{
+		if (DestinationDevice == XIH_PH_ATTRB_DEST_DEVICE_PL)
+		{
+			Status = XFSBL_SUCCESS;
+			goto END;
+		}
+
+		Status = XFsbl_Lz4GetLength(FsblInstancePtr, PartitionNum,
+					&Length);
+		if (XFSBL_SUCCESS != Status)
+		{
+			goto END;
+		}
+	}
+#endif
+
 	/**
 	 * Copy the authentication certificate to auth. buffer
 	 * Update Partition length to be copied.
@@ -927,6 +978,21 @@ static u32 XFsbl_PartitionCopy(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 #endif
 
 	LoadAddress = (PTRSIZE)PartitionHeader->DestinationLoadAddress;
+
+	/**
+	 * The header's check is of the load address only; nothing copied may
+	 * reach into the records reserved in OCM either
+	 */
+	if ((DestinationDevice != XIH_PH_ATTRB_DEST_DEVICE_PL) &&
+		((u64)LoadAddress < XFSBL_OCM_RESERVED_END_ADDRESS) &&
+		(((u64)LoadAddress + Length) > XFSBL_OCM_RESERVED_START_ADDRESS))
+	{
+		Status = XFSBL_ERROR_ADDRESS;
+		XFsbl_Printf(DEBUG_GENERAL,
+			"XFSBL_ERROR_ADDRESS: reserved OCM\n\r");
+		goto END;
+	}
+
 	/**
 	 * Copy the PL to temporary DDR Address
 	 * Copy the PS to Load Address
@@ -985,6 +1051,17 @@ static u32 XFsbl_PartitionCopy(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 		goto END;
 	}
 
+#ifdef XFSBL_ECC_SCRUB
+	/**
+	 * Not into DDR whose ECC is still being initialized
+	 */
+	Status = XFsbl_EccScrubWait(LoadAddress, Length);
+	if (XFSBL_SUCCESS != Status)
+	{
+		goto END;
+	}
+#endif
+
 
 #ifdef ARMR5
 
@@ -1083,8 +1160,22 @@ static u32 XFsbl_PartitionCopy(XFsblPs * FsblInstancePtr, u32 PartitionNum)
 	/**
 	 * Copy the partition to PS_DDR/PL_DDR/TCM
 	 */
-	Status = FsblInstancePtr->DeviceOps.DeviceCopy(SrcAddress,
+#ifdef XFSBL_LZ4
+	if (XFsbl_IsCompressed(PartitionHeader) != 0U) {
+		Status = XFsbl_Lz4Copy(FsblInstancePtr, PartitionNum,
 					LoadAddress, Length);
+	} else
+#endif
+#ifdef XFSBL_STREAM_HASH
+	if (XFsbl_IsHashStreamable(FsblInstancePtr, PartitionNum) == TRUE) {
+		Status = XFsbl_PartitionCopyAndHash(FsblInstancePtr, PartitionNum,
+					SrcAddress, LoadAddress, Length);
+	} else
+#endif
+	{
+		Status = FsblInstancePtr->DeviceOps.DeviceCopy(SrcAddress,
+					LoadAddress, Length);
+	}
 
 #ifdef XFSBL_PERF
 	XFsbl_MeasurePerfTime(tCur);
@@ -1322,6 +1413,7 @@ static u32 XFsbl_PartitionValidation(XFsblPs * FsblInstancePtr,
 			Status = XFSBL_ERROR_PARTITION_CHECKSUM_FAILED;
 			goto END;
 		}
+		XFsbl_ProfileMark(XFSBL_PROFILE_PARTITION_HASHED, PartitionNum);
 #else
 		XFsbl_Printf(DEBUG_GENERAL,"XFSBL_ERROR_SECURE_NOT_ENABLED \r\n");
 		Status = XFSBL_ERROR_SECURE_NOT_ENABLED;
@@ -1349,7 +1441,8 @@ static u32 XFsbl_PartitionValidation(XFsblPs * FsblInstancePtr,
 			 */
 			Status = XFsbl_Authentication(FsblInstancePtr, LoadAddress,
 					Length, (PTRSIZE)AuthBuffer,
-					PartitionNum);
+					PartitionNum,
+					(IsHashStreamed == TRUE) ? StreamedHash : NULL);
 			if (Status != XFSBL_SUCCESS) {
 				goto END;
 			}
@@ -1432,6 +1525,8 @@ static u32 XFsbl_PartitionValidation(XFsblPs * FsblInstancePtr,
 #endif
 		}
 
+		XFsbl_ProfileMark(XFSBL_PROFILE_PARTITION_AUTHENTICATED,
+				PartitionNum);
 #ifdef XFSBL_PERF
 		XFsbl_MeasurePerfTime(tCur);
 		XFsbl_Printf(DEBUG_PRINT_ALWAYS, ": P%d Auth. Time \r\n",
@@ -1561,24 +1656,37 @@ static u32 XFsbl_PartitionValidation(XFsblPs * FsblInstancePtr,
 			XTime_GetTime(&tCur);
 #endif
 
+#ifdef XFSBL_LZ4
+			if (XFsbl_IsCompressed(PartitionHeader) != 0U) {
+				/* Decompressed on its way, a block at a time */
+				Status = XFsbl_Lz4ToPcap(FsblInstancePtr,
+								PartitionNum);
+				if (Status != XFSBL_SUCCESS) {
+					goto END;
+				}
+			} else
+#endif
+			{
 #ifdef XFSBL_PS_DDR
-			/* Use CSU DMA to load Bit stream to PL */
-			BitstreamWordSize =
-				PartitionHeader->UnEncryptedDataWordLength;
+				/* Use CSU DMA to load Bit stream to PL */
+				BitstreamWordSize =
+					PartitionHeader->UnEncryptedDataWordLength;
 
-			Status = XFsbl_WriteToPcap(BitstreamWordSize, (u8 *) LoadAddress);
-			if (Status != XFSBL_SUCCESS) {
-				goto END;
-			}
+				Status = XFsbl_WriteToPcap(BitstreamWordSize,
+							(u8 *) LoadAddress);
+				if (Status != XFSBL_SUCCESS) {
+					goto END;
+				}
 #else
-			/* In case of DDR less system, do the chunked transfer */
-			Status = XFsbl_ChunkedBSTxfer(FsblInstancePtr,
-							PartitionNum);
-			if (Status != XFSBL_SUCCESS) {
-				goto END;
-			}
+				/* In case of DDR less system, do the chunked transfer */
+				Status = XFsbl_ChunkedBSTxfer(FsblInstancePtr,
+								PartitionNum);
+				if (Status != XFSBL_SUCCESS) {
+					goto END;
+				}
 
 #endif
+			}
 
 #ifdef XFSBL_PERF
 			XFsbl_MeasurePerfTime(tCur);
@@ -1595,6 +1703,7 @@ static u32 XFsbl_PartitionValidation(XFsblPs * FsblInstancePtr,
 		if (Status != XFSBL_SUCCESS) {
 			goto END;
 		}
+		XFsbl_ProfileMark(XFSBL_PROFILE_BITSTREAM_DONE, PartitionNum);
 
 		/**
 		 * PL is powered-up before its configuration, but will be in isolation.
@@ -1859,8 +1968,12 @@ static u32 XFsbl_CalcualteSHA(const XFsblPs * FsblInstancePtr, PTRSIZE LoadAddre
 	Length = PartitionHeader->TotalDataWordLength * 4U;
 	HashOffset = FsblInstancePtr->ImageOffsetAddress + PartitionHeader->ChecksumWordOffset * 4U;
 
-	/* Calculate SHA hash */
-	XFsbl_ShaDigest((u8*)LoadAddress,Length, PartitionHash, ShaType);
+	/* Calculate SHA hash, unless it was taken as the partition was copied */
+	if (IsHashStreamed == TRUE) {
+		(void)XFsbl_MemCpy(PartitionHash, StreamedHash, ShaType);
+	} else {
+		XFsbl_ShaDigest((u8*)LoadAddress,Length, PartitionHash, ShaType);
+	}
 	Status = FsblInstancePtr->DeviceOps.DeviceCopy(HashOffset,
 			(PTRSIZE) Hash, ShaType);
 
@@ -1883,6 +1996,144 @@ static u32 XFsbl_CalcualteSHA(const XFsblPs * FsblInstancePtr, PTRSIZE LoadAddre
 }
 #endif  /* end of XFSBL_SECURE */
 
+#ifdef XFSBL_STREAM_HASH
+/*****************************************************************************/
+/**
+ * This function checks whether the partition can be hashed as it is copied:
+ * the boot device must be able to start a copy and return, and the whole
+ * partition must be hashed once from memory, for either its SHA3 checksum
+ * or its authentication (but not both, and not for a bitstream, which is
+ * authenticated in blocks)
+ *
+ * @param	FsblInstancePtr is pointer to the XFsbl Instance
+ *
+ * @param	PartitionNum is the partition number in the image to be loaded
+ *
+ * @return	returns TRUE if it can, FALSE if not
+ *
+ *****************************************************************************/
+static u32 XFsbl_IsHashStreamable(XFsblPs * FsblInstancePtr,
+		u32 PartitionNum)
+{
+	XFsblPs_PartitionHeader * PartitionHeader;
+	u32 IsAuthenticationEnabled;
+	u32 IsChecksumEnabled;
+	u32 Result;
+
+	PartitionHeader =
+		&FsblInstancePtr->ImageHeader.PartitionHeader[PartitionNum];
+
+	IsAuthenticationEnabled = (XFsbl_IsRsaSignaturePresent(PartitionHeader)
+			== XIH_PH_ATTRB_RSA_SIGNATURE) ? TRUE : FALSE;
+	IsChecksumEnabled = (XFsbl_GetChecksumType(PartitionHeader)
+			== XIH_PH_ATTRB_HASH_SHA3) ? TRUE : FALSE;
+
+	if (FsblInstancePtr->DeviceOps.DeviceCopyStart == NULL) {
+		Result = FALSE;
+	} else if ((IsAuthenticationEnabled == TRUE) &&
+			(IsChecksumEnabled == FALSE)) {
+		Result = (XFsbl_GetDestinationDevice(PartitionHeader) !=
+				XIH_PH_ATTRB_DEST_DEVICE_PL) ? TRUE : FALSE;
+	} else if ((IsAuthenticationEnabled == FALSE) &&
+			(IsChecksumEnabled == TRUE)) {
+		Result = TRUE;
+	} else {
+		Result = FALSE;
+	}
+
+	return Result;
+}
+
+/*****************************************************************************/
+/**
+ * This function copies the partition in chunks, and feeds each chunk to
+ * the SHA3 engine while the next is read, so that the hash takes little
+ * more than the read.  The QSPI and the CSU each have their own DMA.  The
+ * hash is left in StreamedHash, for XFsbl_PartitionValidation.
+ *
+ * For authentication, the hash also covers the AC (less its signature),
+ * which XFsbl_PartitionCopy has already read to AuthBuffer; as
+ * XFsbl_PartitionSignVer would hash it.
+ *
+ * @param	FsblInstancePtr is pointer to the XFsbl Instance
+ *
+ * @param	PartitionNum is the partition number in the image to be loaded
+ *
+ * @param	SrcAddress is the flash offset of the partition
+ *
+ * @param	LoadAddress is where the partition is copied to
+ *
+ * @param	Length is the length to be copied and hashed
+ *
+ * @return	returns the error codes described in xfsbl_error.h on any error
+ * 			returns XFSBL_SUCCESS on success
+ *
+ *****************************************************************************/
+static u32 XFsbl_PartitionCopyAndHash(XFsblPs * FsblInstancePtr,
+		u32 PartitionNum, u32 SrcAddress, PTRSIZE LoadAddress, u32 Length)
+{
+	u32 Status = XFSBL_SUCCESS;
+	u32 Offset = 0U;
+	u32 ChunkLength;
+	u32 PrevLength = 0U;
+	void * ShaCtx = (void * )NULL;
+
+	(void)XFsbl_ShaStart(ShaCtx, XFSBL_HASH_TYPE_SHA3);
+
+	while ((Offset < Length) && (Status == XFSBL_SUCCESS)) {
+		ChunkLength = Length - Offset;
+		if (ChunkLength > XFSBL_STREAM_CHUNK_SIZE) {
+			ChunkLength = XFSBL_STREAM_CHUNK_SIZE;
+		}
+
+		Status = FsblInstancePtr->DeviceOps.DeviceCopyStart(
+					SrcAddress + Offset, LoadAddress + Offset,
+					ChunkLength);
+		if (Status == XFSBL_SUCCESS) {
+			/**
+			 * Hash the previous chunk while this one is read
+			 */
+			if (PrevLength != 0U) {
+				XFsbl_ShaUpdate(ShaCtx,
+					(u8 *)(LoadAddress + Offset - PrevLength),
+					PrevLength, XFSBL_HASH_TYPE_SHA3);
+			}
+
+			Status = FsblInstancePtr->DeviceOps.DeviceCopyWait();
+		}
+
+		PrevLength = ChunkLength;
+		Offset += ChunkLength;
+	}
+
+	if (Status != XFSBL_SUCCESS) {
+		goto END;
+	}
+
+	/**
+	 * The last chunk; then the AC, less the partition signature
+	 */
+	if (PrevLength != 0U) {
+		XFsbl_ShaUpdate(ShaCtx, (u8 *)(LoadAddress + Length - PrevLength),
+				PrevLength, XFSBL_HASH_TYPE_SHA3);
+	}
+
+	if (XFsbl_IsRsaSignaturePresent(
+			&FsblInstancePtr->ImageHeader.PartitionHeader[PartitionNum])
+			== XIH_PH_ATTRB_RSA_SIGNATURE) {
+		XFsbl_ShaUpdate(ShaCtx, AuthBuffer,
+				(XFSBL_AUTH_CERT_MIN_SIZE - XFSBL_FSBL_SIG_SIZE),
+				XFSBL_HASH_TYPE_SHA3);
+	}
+
+	XFsbl_ShaFinish(ShaCtx, StreamedHash, XFSBL_HASH_TYPE_SHA3);
+	IsHashStreamed = TRUE;
+
+END:
+	return Status;
+}
+#endif
+
 #ifdef XFSBL_ENABLE_DDR_SR
 /*****************************************************************************/
 /**
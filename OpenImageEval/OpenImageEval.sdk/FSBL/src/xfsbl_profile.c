@@ -0,0 +1,87 @@
+/*****************************************************************************/
+/**
+*
+* @file xfsbl_profile.c
+*
+* This file records the boot profile (see xfsbl_profile.h).  The times are
+* of the system counter, in microseconds; it is started by psu_init, so any
+* events before that read as its start.
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00  agent 10/19/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+
+/***************************** Include Files *********************************/
+#include "xfsbl_profile.h"
+#include "xtime_l.h"
+
+#ifdef XFSBL_PROFILE
+/************************** Constant Definitions *****************************/
+
+/**************************** Type Definitions *******************************/
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+/************************** Variable Definitions *****************************/
+
+static XFsblPs_Profile * const ProfilePtr =
+		(XFsblPs_Profile *)(PTRSIZE)XFSBL_PROFILE_ADDRESS;
+
+/*****************************************************************************/
+/**
+ * This function empties the table, and records the FSBL's entry.
+ *
+ * @param	None
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+void XFsbl_ProfileInit(void)
+{
+	ProfilePtr->Magic = XFSBL_PROFILE_MAGIC;
+	ProfilePtr->NumEvents = 0U;
+
+	XFsbl_ProfileMark(XFSBL_PROFILE_ENTRY, 0U);
+}
+
+/*****************************************************************************/
+/**
+ * This function records the time of an event.  Once the table is full,
+ * later events are dropped.
+ *
+ * @param	Event is one of XFSBL_PROFILE_*
+ *
+ * @param	Partition is the number of the partition, if any
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+void XFsbl_ProfileMark(u32 Event, u32 Partition)
+{
+	XTime tCur = 0;
+	u32 Index = ProfilePtr->NumEvents;
+
+	if (Index < XFSBL_PROFILE_MAX_EVENTS) {
+		XTime_GetTime(&tCur);
+		ProfilePtr->Events[Index].Event = (u16)Event;
+		ProfilePtr->Events[Index].Partition = (u16)Partition;
+		/* Seconds and the remainder apart, so that nothing overflows */
+		ProfilePtr->Events[Index].Usec =
+			(u32)((((u64)tCur / COUNTS_PER_SECOND) * 1000000U) +
+			((((u64)tCur % COUNTS_PER_SECOND) * 1000000U) /
+				COUNTS_PER_SECOND));
+		ProfilePtr->NumEvents = Index + 1U;
+	}
+}
+#endif
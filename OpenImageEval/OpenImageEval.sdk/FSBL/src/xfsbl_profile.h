@@ -0,0 +1,92 @@
+/*****************************************************************************/
+/**
+*
+* @file xfsbl_profile.h
+*
+* This is the header file which contains definitions for the boot profile:
+* the time at which each stage of the FSBL was reached, left in OCM for the
+* application (see OI_BOOT_PROFILE in open_image_protocol.h, whose layout
+* this must match).
+*
+* <pre>
+* MODIFICATION HISTORY:
+*
+* Ver   Who  Date        Changes
+* ----- ---- -------- -------------------------------------------------------
+* 1.00  agent 10/19/26 Initial release
+*
+* </pre>
+*
+* @note
+*
+******************************************************************************/
+#ifndef XFSBL_PROFILE_H
+#define XFSBL_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/***************************** Include Files *********************************/
+#include "xil_types.h"
+#include "xfsbl_hw.h"
+
+/************************** Constant Definitions *****************************/
+
+/**
+ * The table is in the part of OCM that the FSBL does not use, and that
+ * ATF would (this boot image has none); the application copies it out.
+ */
+#define XFSBL_PROFILE_ADDRESS		(XFSBL_OCM_RESERVED_START_ADDRESS)
+#define XFSBL_PROFILE_MAGIC		(0x464F5250U)	/* "PROF" */
+#define XFSBL_PROFILE_MAX_EVENTS	(32U)
+
+/**
+ * Events.  Those of a partition give its number; the others zero.
+ */
+#define XFSBL_PROFILE_ENTRY		(0U)	/* FSBL started */
+#define XFSBL_PROFILE_SYSTEM_INIT	(1U)	/* psu_init done */
+#define XFSBL_PROFILE_DDR_ECC_INIT	(2U)	/* DDR ECC initialized */
+#define XFSBL_PROFILE_INIT_DONE		(3U)	/* XFsbl_Initialize done */
+#define XFSBL_PROFILE_BOOT_DEVICE	(4U)	/* headers read and checked */
+#define XFSBL_PROFILE_PARTITION_START	(5U)
+#define XFSBL_PROFILE_PARTITION_COPIED	(6U)	/* in memory */
+#define XFSBL_PROFILE_PARTITION_HASHED	(7U)	/* checksum checked */
+#define XFSBL_PROFILE_PARTITION_AUTHENTICATED	(8U)
+#define XFSBL_PROFILE_BITSTREAM_DONE	(9U)	/* PL configured */
+#define XFSBL_PROFILE_PARTITION_DONE	(10U)
+#define XFSBL_PROFILE_HANDOFF		(11U)
+
+/**************************** Type Definitions *******************************/
+
+typedef struct {
+	u16 Event;
+	u16 Partition;
+	u32 Usec;	/* of the system counter */
+} XFsblPs_ProfileEvent;
+
+typedef struct {
+	u32 Magic;
+	u32 NumEvents;
+	XFsblPs_ProfileEvent Events[XFSBL_PROFILE_MAX_EVENTS];
+} XFsblPs_Profile;
+
+/***************** Macros (Inline Functions) Definitions *********************/
+
+/************************** Function Prototypes ******************************/
+
+#ifdef XFSBL_PROFILE
+void XFsbl_ProfileInit(void);
+void XFsbl_ProfileMark(u32 Event, u32 Partition);
+#else
+#define XFsbl_ProfileInit()
+#define XFsbl_ProfileMark(Event, Partition)
+#endif
+
+/************************** Variable Definitions *****************************/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* XFSBL_PROFILE_H */
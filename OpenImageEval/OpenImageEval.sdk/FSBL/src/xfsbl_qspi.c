@@ -77,6 +77,12 @@
 static u32 FlashReadID(XQspiPsu *QspiPsuPtr);
 static u32 MacronixEnable4B(XQspiPsu *QspiPsuPtr);
 static u32 MacronixEnableQPIMode(XQspiPsu *QspiPsuPtr, int Enable);
+static void XFsbl_Qspi32ReadSetup(u32 QspiAddr, PTRSIZE DestAddress,
+		u32 TransferBytes);
+#ifdef XFSBL_STREAM_HASH
+static void XFsbl_QspiStatusHandler(void *CallBackRef, u32 StatusEvent,
+		u32 ByteCount);
+#endif
 
 /************************** Variable Definitions *****************************/
 static XQspiPsu QspiPsuInstance;
@@ -90,6 +96,10 @@ static u8 TxBfrPtr __attribute__ ((aligned(32)));
 static u8 ReadBuffer[10] __attribute__ ((aligned(32)));
 static u8 WriteBuffer[10] __attribute__ ((aligned(32)));
 static u32 MacronixFlash = 0U;
+#ifdef XFSBL_STREAM_HASH
+static volatile u32 QspiCopyDone = TRUE;
+static u32 QspiCopyStatus = XFSBL_SUCCESS;
+#endif
 /******************************************************************************
 *
 * This function reads serial FLASH ID connected to the SPI interface.
@@ -263,7 +273,7 @@ u32 XFsbl_Qspi24Init(u32 DeviceFlags)
 	/*
 	 * Set the pre-scaler for QSPI clock
 	 */
-	Status = XQspiPsu_SetClkPrescaler(&QspiPsuInstance, XQSPIPSU_CLK_PRESCALE_8);
+	Status = XQspiPsu_SetClkPrescaler(&QspiPsuInstance, XFSBL_QSPI_PRESCALER);
 
 	if (Status != XFSBL_SUCCESS) {
 		UStatus = XFSBL_ERROR_QSPI_PRESCALER_CLK;
@@ -948,7 +958,7 @@ u32 XFsbl_Qspi32Init(u32 DeviceFlags)
 	/*
 	 * Set the pre-scaler for QSPI clock
 	 */
-	Status = XQspiPsu_SetClkPrescaler(&QspiPsuInstance, XQSPIPSU_CLK_PRESCALE_8);
+	Status = XQspiPsu_SetClkPrescaler(&QspiPsuInstance, XFSBL_QSPI_PRESCALER);
 
 	if (Status != XFSBL_SUCCESS) {
 		UStatus = XFSBL_ERROR_QSPI_PRESCALER_CLK;
@@ -958,6 +968,14 @@ u32 XFsbl_Qspi32Init(u32 DeviceFlags)
 	XQspiPsu_SelectFlash(&QspiPsuInstance,
 		XQSPIPSU_SELECT_FLASH_CS_LOWER, XQSPIPSU_SELECT_FLASH_BUS_LOWER);
 
+#ifdef XFSBL_STREAM_HASH
+	/*
+	 * Completion of the reads started by XFsbl_Qspi32CopyStart
+	 */
+	XQspiPsu_SetStatusHandler(&QspiPsuInstance, &QspiPsuInstance,
+		XFsbl_QspiStatusHandler);
+#endif
+
 	/*
 	 * Configure the qspi in linear mode if running in XIP
 	 * TBD
@@ -1186,6 +1204,93 @@ END:
 	return UStatus;
 }
 
+/*****************************************************************************/
+/**
+ * This function sets up the messages (FlashMsg[0] to [2]) to read from the
+ * 32 bit addressed QSPI flash in SPI, dual or quad mode
+ *
+ * @param QspiAddr is the flash address, as translated by XFsbl_GetQspiAddr
+ *
+ * @param DestAddress is the address of the destination where it
+ * should copy to
+ *
+ * @param TransferBytes Length of the bytes to be read
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+static void XFsbl_Qspi32ReadSetup(u32 QspiAddr, PTRSIZE DestAddress,
+		u32 TransferBytes)
+{
+	u32 DiscardByteCnt;
+
+	WriteBuffer[COMMAND_OFFSET]   = (u8)ReadCommand;
+	WriteBuffer[ADDRESS_1_OFFSET] = (u8)((QspiAddr & 0xFF000000U) >> 24);
+	WriteBuffer[ADDRESS_2_OFFSET] = (u8)((QspiAddr & 0xFF0000U) >> 16);
+	WriteBuffer[ADDRESS_3_OFFSET] = (u8)((QspiAddr & 0xFF00U) >> 8);
+	WriteBuffer[ADDRESS_4_OFFSET] = (u8)(QspiAddr & 0xFFU);
+	DiscardByteCnt = 5;
+
+	FlashMsg[0].TxBfrPtr = WriteBuffer;
+	FlashMsg[0].RxBfrPtr = NULL;
+	FlashMsg[0].ByteCount = DiscardByteCnt;
+	FlashMsg[0].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
+	FlashMsg[0].Flags = XQSPIPSU_MSG_FLAG_TX;
+
+	/*
+	 * It is recommended to have a separate entry for dummy
+	 */
+	if ((ReadCommand == FAST_READ_CMD_32BIT) ||
+			(ReadCommand == DUAL_READ_CMD_32BIT) ||
+			(ReadCommand == QUAD_READ_CMD_32BIT)) {
+
+		/* Update Dummy cycles as per flash specs for QUAD IO */
+
+		/*
+		 * It is recommended that Bus width value during dummy
+		 * phase should be same as data phase
+		 */
+		if (ReadCommand == FAST_READ_CMD_32BIT) {
+			FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
+		}
+
+		if (ReadCommand == DUAL_READ_CMD_32BIT) {
+			FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_DUALSPI;
+		}
+
+		if (ReadCommand == QUAD_READ_CMD_32BIT) {
+			FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_QUADSPI;
+		}
+
+		FlashMsg[1].TxBfrPtr = NULL;
+		FlashMsg[1].RxBfrPtr = NULL;
+		FlashMsg[1].ByteCount = DUMMY_CLOCKS;
+		FlashMsg[1].Flags = 0U;
+	}
+
+	if (ReadCommand == FAST_READ_CMD_32BIT) {
+		FlashMsg[2].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
+	}
+
+	if (ReadCommand == DUAL_READ_CMD_32BIT) {
+		FlashMsg[2].BusWidth = XQSPIPSU_SELECT_MODE_DUALSPI;
+	}
+
+	if (ReadCommand == QUAD_READ_CMD_32BIT) {
+		FlashMsg[2].BusWidth = XQSPIPSU_SELECT_MODE_QUADSPI;
+	}
+
+	FlashMsg[2].TxBfrPtr = NULL;
+	FlashMsg[2].RxBfrPtr = (u8 *)DestAddress;
+	FlashMsg[2].ByteCount = TransferBytes;
+	FlashMsg[2].Flags = XQSPIPSU_MSG_FLAG_RX;
+
+	if(QspiPsuInstance.Config.ConnectionMode ==
+			XQSPIPSU_CONNECTION_MODE_PARALLEL){
+		FlashMsg[2].Flags |= XQSPIPSU_MSG_FLAG_STRIPE;
+	}
+}
+
 /*****************************************************************************/
 /**
  * This function is used to copy the data from QSPI flash to destination
@@ -1324,71 +1429,7 @@ u32 XFsbl_Qspi32Copy(u32 SrcAddress, PTRSIZE DestAddress, u32 Length)
 			}
 
 		} else {
-			WriteBuffer[COMMAND_OFFSET]   = (u8)ReadCommand;
-			WriteBuffer[ADDRESS_1_OFFSET] = (u8)((QspiAddr & 0xFF000000U) >> 24);
-			WriteBuffer[ADDRESS_2_OFFSET] = (u8)((QspiAddr & 0xFF0000U) >> 16);
-			WriteBuffer[ADDRESS_3_OFFSET] = (u8)((QspiAddr & 0xFF00U) >> 8);
-			WriteBuffer[ADDRESS_4_OFFSET] = (u8)(QspiAddr & 0xFFU);
-			DiscardByteCnt = 5;
-
-			FlashMsg[0].TxBfrPtr = WriteBuffer;
-			FlashMsg[0].RxBfrPtr = NULL;
-			FlashMsg[0].ByteCount = DiscardByteCnt;
-			FlashMsg[0].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
-			FlashMsg[0].Flags = XQSPIPSU_MSG_FLAG_TX;
-
-			/*
-			 * It is recommended to have a separate entry for dummy
-			 */
-			if ((ReadCommand == FAST_READ_CMD_32BIT) ||
-					(ReadCommand == DUAL_READ_CMD_32BIT) ||
-					(ReadCommand == QUAD_READ_CMD_32BIT)) {
-
-				/* Update Dummy cycles as per flash specs for QUAD IO */
-
-				/*
-				 * It is recommended that Bus width value during dummy
-				 * phase should be same as data phase
-				 */
-				if (ReadCommand == FAST_READ_CMD_32BIT) {
-					FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
-				}
-
-				if (ReadCommand == DUAL_READ_CMD_32BIT) {
-					FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_DUALSPI;
-				}
-
-				if (ReadCommand == QUAD_READ_CMD_32BIT) {
-					FlashMsg[1].BusWidth = XQSPIPSU_SELECT_MODE_QUADSPI;
-				}
-
-				FlashMsg[1].TxBfrPtr = NULL;
-				FlashMsg[1].RxBfrPtr = NULL;
-				FlashMsg[1].ByteCount = DUMMY_CLOCKS;
-				FlashMsg[1].Flags = 0U;
-			}
-
-			if (ReadCommand == FAST_READ_CMD_32BIT) {
-				FlashMsg[2].BusWidth = XQSPIPSU_SELECT_MODE_SPI;
-			}
-
-			if (ReadCommand == DUAL_READ_CMD_32BIT) {
-				FlashMsg[2].BusWidth = XQSPIPSU_SELECT_MODE_DUALSPI;
-			}
-
-			if (ReadCommand == QUAD_READ_CMD_32BIT) {
-				FlashMsg[2].BusWidth = XQSPIPSU_SELECT_MODE_QUADSPI;
-			}
-
-			FlashMsg[2].TxBfrPtr = NULL;
-			FlashMsg[2].RxBfrPtr = (u8 *)DestAddress;
-			FlashMsg[2].ByteCount = TransferBytes;
-			FlashMsg[2].Flags = XQSPIPSU_MSG_FLAG_RX;
-
-			if(QspiPsuInstance.Config.ConnectionMode ==
-					XQSPIPSU_CONNECTION_MODE_PARALLEL){
-				FlashMsg[2].Flags |= XQSPIPSU_MSG_FLAG_STRIPE;
-			}
+			XFsbl_Qspi32ReadSetup(QspiAddr, DestAddress, TransferBytes);
 
 			/**
 			 * Send the read command to the Flash to read the specified number
@@ -1415,6 +1456,133 @@ END:
 	return UStatus;
 }
 
+#ifdef XFSBL_STREAM_HASH
+/*****************************************************************************/
+/**
+ * This function is used to start a copy of the data from QSPI flash to
+ * destination address, and returns while the DMA does it; the caller may
+ * meanwhile use the CSU DMA (e.g. for SHA3), and waits for the copy with
+ * XFsbl_Qspi32CopyWait.  Only one copy is in flight at once.
+ *
+ * Reads in QPI mode, which is entered and left around each read, and
+ * reads longer than one DMA transfer are copied before returning.
+ *
+ * @param SrcAddress is the address of the QSPI flash where copy should
+ * start from
+ *
+ * @param DestAddress is the address of the destination where it
+ * should copy to
+ *
+ * @param Length Length of the bytes to be copied
+ *
+ * @return
+ * 		- XFSBL_SUCCESS if the copy was started
+ * 		- errors as mentioned in xfsbl_error.h
+ *
+ *****************************************************************************/
+u32 XFsbl_Qspi32CopyStart(u32 SrcAddress, PTRSIZE DestAddress, u32 Length)
+{
+	s32 Status;
+	u32 QspiAddr;
+	u32 UStatus;
+
+	if (((MacronixFlash == 1U) &&
+			(QspiPsuInstance.Config.BusWidth == XFSBL_QSPI_BUSWIDTH_FOUR)) ||
+			(Length > DMA_DATA_TRAN_SIZE))
+	{
+		UStatus = XFsbl_Qspi32Copy(SrcAddress, DestAddress, Length);
+		QspiCopyStatus = UStatus;
+		QspiCopyDone = TRUE;
+		goto END;
+	}
+
+	/**
+	 * Check the read length with Qspi flash size
+	 */
+	if ((SrcAddress + Length) > QspiFlashSize)
+	{
+		UStatus = XFSBL_ERROR_QSPI_LENGTH;
+		XFsbl_Printf(DEBUG_GENERAL,"XFSBL_ERROR_QSPI_LENGTH\r\n");
+		goto END;
+	}
+
+	/**
+	 * Translate address based on type of connection
+	 * If stacked assert the slave select based on address
+	 */
+	QspiAddr = XFsbl_GetQspiAddr((u32 )SrcAddress);
+
+	XFsbl_Printf(DEBUG_DETAILED,
+				"QSPI Read Start Src 0x%0lx, Dest %0lx, Length %0lx\r\n",
+					QspiAddr, DestAddress, Length);
+
+	XFsbl_Qspi32ReadSetup(QspiAddr, DestAddress, Length);
+
+	QspiCopyDone = FALSE;
+	Status = XQspiPsu_InterruptTransfer(&QspiPsuInstance, &FlashMsg[0], 3);
+	if (Status != XFSBL_SUCCESS) {
+		QspiCopyDone = TRUE;
+		UStatus = XFSBL_ERROR_QSPI_READ;
+		XFsbl_Printf(DEBUG_GENERAL,"XFSBL_ERROR_QSPI_READ\r\n");
+		goto END;
+	}
+
+	UStatus = XFSBL_SUCCESS;
+END:
+	return UStatus;
+}
+
+/*****************************************************************************/
+/**
+ * This function waits for the copy started by XFsbl_Qspi32CopyStart.  The
+ * QSPI interrupt is not enabled in the GIC, so its handler is polled.
+ *
+ * @param	None
+ *
+ * @return
+ * 		- XFSBL_SUCCESS for successful copy
+ * 		- errors as mentioned in xfsbl_error.h
+ *
+ *****************************************************************************/
+u32 XFsbl_Qspi32CopyWait(void)
+{
+	while (QspiCopyDone == FALSE) {
+		(void)XQspiPsu_InterruptHandler(&QspiPsuInstance);
+	}
+
+	return QspiCopyStatus;
+}
+
+/*****************************************************************************/
+/**
+ * This function is called by the QSPI driver when a copy started by
+ * XFsbl_Qspi32CopyStart ends
+ *
+ * @param	CallBackRef is the QSPI instance
+ *
+ * @param	StatusEvent is XST_SPI_TRANSFER_DONE, or the error
+ *
+ * @param	ByteCount is unused
+ *
+ * @return	None
+ *
+ *****************************************************************************/
+static void XFsbl_QspiStatusHandler(void *CallBackRef, u32 StatusEvent,
+		u32 ByteCount)
+{
+	(void)CallBackRef;
+	(void)ByteCount;
+
+	if (StatusEvent == XST_SPI_TRANSFER_DONE) {
+		QspiCopyStatus = XFSBL_SUCCESS;
+	} else {
+		QspiCopyStatus = XFSBL_ERROR_QSPI_READ;
+		XFsbl_Printf(DEBUG_GENERAL,"XFSBL_ERROR_QSPI_READ\r\n");
+	}
+	QspiCopyDone = TRUE;
+}
+#endif
+
 /*****************************************************************************/
 /**
  * This function is used to release the Qspi settings
@@ -214,6 +214,10 @@ u32 XFsbl_Qspi24Release(void );
 u32 XFsbl_Qspi32Init(u32 DeviceFlags);
 u32 XFsbl_Qspi32Copy(u32 SrcAddress, PTRSIZE DestAddress, u32 Length);
 u32 XFsbl_Qspi32Release(void );
+#ifdef XFSBL_STREAM_HASH
+u32 XFsbl_Qspi32CopyStart(u32 SrcAddress, PTRSIZE DestAddress, u32 Length);
+u32 XFsbl_Qspi32CopyWait(void);
+#endif
 
 /************************** Variable Definitions *****************************/
 
@@ -0,0 +1,57 @@
+/*
+	oi_ring.h
+
+	Lock-free single-producer, single-consumer ring of fixed-size messages,
+	for passing work between cores.  Portable; also built into the host
+	software.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_RING_H__
+#define __OI_RING_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//********************************  Constants  *******************************//
+// Size of the cache line; the indices are kept on separate lines so that
+//  producer and consumer do not contend.
+#define OI_RING_LINE_BYTES                                              64u
+
+//**********************************  Types  *********************************//
+
+// The ring and its slots must be in memory that both sides see coherently;
+//  on the device, that is memory that is not cached (see oiCore.c).
+typedef struct tag_oi_ring {
+	// Written only by the producer:
+	volatile uint32_t head;
+	uint8_t pad0[OI_RING_LINE_BYTES - sizeof(uint32_t)];
+
+	// Written only by the consumer:
+	volatile uint32_t tail;
+	uint8_t pad1[OI_RING_LINE_BYTES - sizeof(uint32_t)];
+
+	// Fixed at initialization:
+	uint32_t
+		nSlots,      // a power of two
+		slotBytes;
+	uint8_t* pSlots;
+} OI_RING;
+
+//********************************  Functions  *******************************//
+
+void oiRingInit(OI_RING* pRing, void* pSlots, uint32_t nSlots, uint32_t slotBytes);
+bool oiRingPush(OI_RING* pRing, const void* pMsg, uint32_t nBytes);
+bool oiRingPop(OI_RING* pRing, void* pMsg);
+uint32_t oiRingCount(const OI_RING* pRing);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OI_RING_H__ */
@@ -9,6 +9,14 @@
 #ifndef __OPEN_IMAGE_H__
 #define __OPEN_IMAGE_H__
 
+/////  Shared with Assembly  /////
+// The assembly sources (oiCoreEntry.S) see only these.
+
+// Stack of each secondary core.
+#define OI_CORE_STACK_BYTES                                          0x8000
+
+#ifndef __ASSEMBLER__
+
 #include <assert.h>
 #include <stdbool.h>
 #include <stdint.h>
@@ -17,50 +25,13 @@
 #include <xparameters.h>
 #include <xscugic.h>
 
+#include "open_image_protocol.h"
+
 
 #pragma GCC diagnostic ignored "-Wparentheses"
 
 //********************************  Constants  *******************************//
 
-/////  Communications  /////
-// TCP/IP Port used to connect to the OpenImager.
-#define OI_TCP_PORT                                                  26000u
-// First byte of every packet.  260 doesn't fit so we div 2.
-#define OI_MAGIC                                                  (260u/2u)
-
-///  Command Codes  ///
-#define OI_CMD_GET_STATUS                                             0x01u
-
-#define OI_CMD_QUEUE_FRAME                                            0x11u
-#define OI_CMD_GET_FRAME                                              0x12u
-
-///  Response Codes  ///
-#define OI_RES_ACK                                                    0x80u
-#define OI_RES_STATUS                                                 0x81u
-
-#define OI_RES_FRAME                                                  0x92u
-
-#define OI_RES_NACK                                                   0xFFu
-
-
-
-// Total number of channels for transmit and receive.
-#define OI_N_CHAN                                                       16u
-
-// Number of entires for the level sequencer.
-#define OI_MAX_N_LEVEL_SEQUENCE                                        252u
-
-
-// Number of ADC devices present in the system.
-#define OI_RX_N_CHIPS                                                    2u
-
-// Maximum number of Time Gain Compensation values that may be specified.
-#define OI_RX_MAX_N_TGC                                                300u
-
-// Maximum number of shots in one frame.
-#define OI_MAX_N_SHOTS                                                 100u
-
-
 /////  Clocks  /////
 
 // Clock rate of the CPU.
@@ -101,10 +72,54 @@ typedef enum tag_emio_gpio_pin {
 	EMIO_GPIO_PIN_LED_6,
 	EMIO_GPIO_PIN_LED_7,
 	EMIO_GPIO_PIN_DAC_START,   // currently started in software
+#if OI_SAMPLE_PACK
+	EMIO_GPIO_PIN_SAMPLE_FORMAT_0,  // OI_SAMPLE_FORMAT_*, to axis_sample_pack
+	EMIO_GPIO_PIN_SAMPLE_FORMAT_1,
+#endif
 } emio_gpio_pin_t;
 
 #define USER_LED_PIN                                                     23
 
+// Input of the EMIO bank, the last of its 28 pins, tied high by
+//  SHOT_HEADER_PRESENT in bitstreams in which axis_shot_header feeds each
+//  DMA; it reads low on those without (see oiAdcDma.c).
+#define EMIO_GPIO_PIN_SHOT_HEADER                                        27
+
+
+/////  Cores  /////
+
+// Set to 0 to run everything on core 0, in a single loop.
+#ifndef OI_SMP
+#	define OI_SMP                                                         1
+#endif
+
+// Role of each Cortex-A53 core; the index is the core number (see oiCore.c).
+typedef enum tag_oi_core {
+	OI_CORE_NETWORK,      // lwIP, which owns the interrupts
+	OI_CORE_ACQUISITION,  // commands, state machine and shot sequencing
+	OI_CORE_WORKER_0,     // processing of recorded shots
+	OI_CORE_WORKER_1,
+	
+	OI_N_CORES
+} oi_core_t;
+
+#define OI_N_WORKERS                      (OI_N_CORES - OI_CORE_WORKER_0)
+
+/////  Flash  /////
+#define OI_FLASH_SECTOR_BYTES                                       0x10000u
+
+// Sector of the lower QSPI flash that holds the board's ADC link
+//  calibration:  the last of a 512 Mb part.  The boot image (FSBL.bif)
+//  places its partitions back to back from offset 0, and is some 20 MB, so
+//  this is well clear of it.
+#define OI_FLASH_CAL_OFFSET                                      0x03FF0000u
+
+
+/////  Hashing  /////
+// 64-bit FNV-1a.
+#define FNV_OFFSET_BASIS                              0xCBF29CE484222325ull
+#define FNV_PRIME                                            0x100000001B3ull
+
 
 //**********************************  Types  *********************************//
 
@@ -120,101 +135,29 @@ typedef enum tag_event {
 	N_EVENTS
 } event_t;
 
-typedef enum tag_state {
-	STATE_INIT,
-	STATE_READY,
-	STATE_ARMED,
-	STATE_RECORD,
-	STATE_FAULT,
-	
-	N_STATES,
-	
-	STATE_ANY
-} state_t;
-
-typedef enum tag_oi_error {
-	OI_ERR_NONE,
-	OI_ERR_UNRECOGNIZED_COMMAND,
-	OI_ERR_BAD_PACKET,
-	OI_ERR_INCORRECT_SIZE,
-	OI_ERR_ILLEGAL_STATE,
-	OI_ERR_INVALID_PARAMETER,
-	
-} oi_error_t;
-
-// NOTE: all data structures should have 32-bit alignment.
-
-typedef struct tag_oi_status {
-	uint32_t 
-		state,
-		flags;
-	
-	uint8_t buildDate[32];
-} OI_STATUS;
-
-typedef struct tag_oi_tx_channel {
-	uint32_t 
-		enable,
-		nLevelSequence;
-	
-	// Waveform to generate.  The waveform will be output at
-	//   oi_tx.CLOCK_RATE.
-	//  2 = Vpp0, 1 = Vpp1, 0 = RTZ, -1 = Vnn1, -2 = Vnn0;
-	//  e.g., [2 -2] would be  single-cycle square wave.
-	//  Note that the waveform *must* begin and end with RTZ.
-	int8_t levelSequence[OI_MAX_N_LEVEL_SEQUENCE];
-	
-} OI_TX_CHANNEL;
-
-typedef struct tag_oi_tx {
-	OI_TX_CHANNEL channels[OI_N_CHAN];
-} OI_TX;
-
-typedef struct tag_oi_rx_channel {
-	uint32_t enable;
-	
-} OI_RX_CHANNEL;
-
-typedef struct tag_oi_rx {
-	OI_RX_CHANNEL channels[OI_N_CHAN];
-	
+// Product computed from each recorded shot.
+typedef enum tag_product {
+	PRODUCT_NONE,
+	PRODUCT_IQ,
+	PRODUCT_BF,
+	PRODUCT_PACK,  // of raw rows, for OI_CMD_GET_FRAME_PACKED (see oiCmd.c)
+} product_t;
+
+// Everything needed to process one shot, on whichever core; this is
+//  planned, in order, by the acquisition core.
+typedef struct tag_shot_job {
+	product_t product;
 	uint32_t
+		iShot,
 		nSamples,
-		nTgc[OI_RX_N_CHIPS];
-
-	uint8_t
-		lpfMul[OI_RX_N_CHIPS],
-		lpfDiv[OI_RX_N_CHIPS],
-		tgc[OI_RX_N_CHIPS][OI_RX_MAX_N_TGC],
-		lna[OI_RX_N_CHIPS],
-		pga[OI_RX_N_CHIPS],
-		hpf_divisor[OI_RX_N_CHIPS],
-		testMode[OI_RX_N_CHIPS]; 
-		
-} OI_RX;
-
-typedef struct tag_oi_shot {
-	OI_TX tx;
-	
-	OI_RX rx;
-	
-} OI_SHOT;
-
-typedef struct tag_oi_frame {
-	uint32_t
-		handle,
-		nShots;
-		
-	OI_SHOT shots[OI_MAX_N_SHOTS];
-} OI_FRAME;
-
-
-typedef struct tag_oi_frame_data_req {
-	uint32_t 
-		iAdc,
-		byteOffset,
-		nBytes;
-} OI_FRAME_DATA_REQ;
+		rawOffset,  // byte offset of the shot's samples in the raw buffers
+		outOffset;  // byte offset of its product
+	union {
+		OI_IQ_CONFIG iq;
+		OI_BF_CONFIG bf;
+		OI_FRAME_DATA_REQ pack;
+	} cfg;
+} shot_job_t;
 
 //*******************************  Global Data  ******************************//
 // Global GPIO instance.
@@ -256,17 +199,73 @@ void delay_cycles(uint32_t nCycles);
 void oiAdcInit(void);
 void oiAdcVisit(void);
 void oiAdcSetup(const OI_RX* pRx);
+bool oiAdcSetLink(uint32_t iAdc, int32_t fcoRotate, uint32_t dcoDelayPs);
+void oiAdcGetLink(uint32_t iAdc, int32_t* pFcoRotate, uint32_t* pDcoDelayPs);
+void oiAdcSetUserPattern(bool isOn);
+void oiAdcSoftTrigger(void);
+void oiAdcWaitReady(void);
+
+void oiAdcCalibrate(void);
 
 void oiAdcDmaInit(void);
 void oiAdcDmaVisit(void);
-void oiAdcDmaSetup(uint32_t nSamples);
+bool oiAdcDmaSetup(uint32_t nBytes);
+bool oiAdcDmaIsUsable(uint32_t nBytes);
+void oiAdcDmaLabelShot(uint32_t handle, uint32_t iShot);
+void oiAdcDmaGetShotCounts(uint32_t* pnShots, uint32_t* pnBadShots);
 const uint8_t* oiAdcDmaGetFrameData(const OI_FRAME_DATA_REQ* pReq);
 void oiAdcDmaRestartRecording(void);
+bool oiAdcDmaIsDone(void);
+void oiAdcDmaDiscardShot(void);
+
+void oiBfInit(void);
+oi_error_t oiBfConfigure(const void* pBytes, uint32_t nBytes);
+bool oiBfIsEnabled(void);
+void oiBfRestart(void);
+bool oiBfPlanShot(shot_job_t* pJob, uint32_t iShot, uint32_t nSamples);
+void oiBfProcessShot(const shot_job_t* pJob);
+const uint8_t* oiBfGetFrameData(const OI_FRAME_DATA_REQ* pReq);
+
+void oiBootInit(void);
+uint32_t oiBootUsec(void);
+void oiBootWaitUntil(uint32_t usec);
+void oiBootMark(oi_boot_stage_t stage);
+void oiBootGetTimeline(uint32_t* pUsec);
+const OI_BOOT_PROFILE* oiBootGetProfile(void);
+bool oiBootIsScrubbed(void);
+bool oiBootIsScrubFailed(void);
+bool oiBootIsUsable(uint64_t address, uint64_t nBytes);
+bool oiBootWaitScrubbed(uint64_t address, uint64_t nBytes);
 
 void oiCmdHandle(void *pPacket, uint32_t nBytes);
+void oiCmdVisit(void);
+bool oiCmdIsBusy(void);
+void oiCmdPackShot(const shot_job_t* pJob);
+
+void oiCoreStart(void);
+void oiCoreVisit(void);
+uint32_t oiCoreId(void);
+bool oiCoreIsReadyForPacket(void);
+void oiCoreHandlePacket(const void* pPacket, uint32_t nBytes);
+void oiCoreQueueReply(uint8_t cmd, const void* pData, uint32_t nData);
+void oiCoreWaitForReplies(void);
+void oiCoreRunJob(const shot_job_t* pJob);
+bool oiCoreIsIdle(void);
+
+void oiFlashInit(void);
+bool oiFlashRead(uint32_t offset, void* pData, uint32_t nBytes);
+bool oiFlashWriteSector(uint32_t offset, const void* pData, uint32_t nBytes);
 
 void oiInit(void);
 
+void oiIqInit(void);
+oi_error_t oiIqConfigure(const void* pBytes, uint32_t nBytes);
+bool oiIqIsEnabled(void);
+void oiIqRestart(void);
+bool oiIqPlanShot(shot_job_t* pJob, uint32_t nSamples);
+void oiIqProcessShot(const shot_job_t* pJob);
+const uint8_t* oiIqGetFrameData(const OI_FRAME_DATA_REQ* pReq);
+
 void oiPulserInit(void);
 void oiPulserVisit(void);	
 bool oiPulserSetup(const OI_TX* pTx);
@@ -274,18 +273,26 @@ bool oiPulserSetup(const OI_TX* pTx);
 void oiServerInit(void);
 void oiServerVisit(void);
 void oiServerReply(uint8_t cmd, const void* pData, uint32_t nData);
+bool oiServerCanReply(uint32_t nData);
 
 void oiShotManInit(void);
 void oiShotManVisit(void);
-oi_error_t oiShotManQueueFrame(const void* pBytes, uint32_t nBytes);
+oi_error_t oiShotManQueueFrame(const void* pBytes, uint32_t nBytes,
+		bool isFormatted);
+oi_error_t oiShotManQueueFrameRle(const void* pBytes, uint32_t nBytes);
+oi_error_t oiShotManQueueFrameFocused(const void* pBytes, uint32_t nBytes);
+bool oiShotManIsFullWidth(void);
+const OI_TIMING_CAL* oiShotManGetTiming(void);
 
 void oiSmVisit(void);
 void oiSmSetEvent(event_t event);
 state_t oiSmGetState(void);
 
 void oiTgcInit(void);
-void oiTgcSetup(const OI_RX* pRx);
+bool oiTgcSetup(const OI_RX* pRx);
+
 
+#endif /* __ASSEMBLER__ */
 
 #endif /* __OPEN_IMAGE_H__ */
 
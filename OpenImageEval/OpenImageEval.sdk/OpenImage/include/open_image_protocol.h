@@ -0,0 +1,723 @@
+/*
+	open_image_protocol.h
+
+	Declarations of the Open Image communications protocol.  This header
+	has no dependencies on the Xilinx BSP, so that it may be shared
+	with host software.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OPEN_IMAGE_PROTOCOL_H__
+#define __OPEN_IMAGE_PROTOCOL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//********************************  Constants  *******************************//
+
+/////  Communications  /////
+// TCP/IP Port used to connect to the OpenImager.
+#define OI_TCP_PORT                                                  26000u
+// First byte of every packet.  260 doesn't fit so we div 2.
+#define OI_MAGIC                                                  (260u/2u)
+// Most bytes of payload in a reply:  what fits in the device's TCP send
+//  buffer (lwIP's TCP_SND_BUF, 8 KB), with the header.  Every request is
+//  answered once; one whose reply would be larger is NACK'd with
+//  OI_ERR_INCORRECT_SIZE.
+#define OI_MAX_REPLY_BYTES                                            8188u
+// Version of the protocol, as OI_CMD_GET_VERSION replies.  Version 1 had
+//  only OI_CMD_GET_STATUS, OI_CMD_QUEUE_FRAME and OI_CMD_GET_FRAME, and
+//  NACKs OI_CMD_GET_VERSION with OI_ERR_UNRECOGNIZED_COMMAND.  Version 2
+//  adds the other commands, the fields of OI_STATUS after buildDate, and
+//  OI_RX.sampleFormat; OI_CMD_QUEUE_FRAME still takes the shots of version
+//  1 (OI_SHOT_V1_BYTES), and OI_CMD_QUEUE_FRAME_FORMATTED takes OI_SHOT.
+#define OI_PROTOCOL_VERSION                                              2u
+
+///  Command Codes  ///
+#define OI_CMD_GET_STATUS                                             0x01u
+#define OI_CMD_GET_BOOT_PROFILE                                       0x02u
+#define OI_CMD_GET_TIMING                                             0x03u
+#define OI_CMD_GET_VERSION                                            0x04u
+
+#define OI_CMD_QUEUE_FRAME                                            0x11u
+#define OI_CMD_GET_FRAME                                              0x12u
+#define OI_CMD_QUEUE_FRAME_RLE                                        0x13u
+#define OI_CMD_QUEUE_FRAME_FOCUSED                                    0x14u
+#define OI_CMD_GET_FRAME_PACKED                                       0x15u
+#define OI_CMD_ESTIMATE_FRAME                                         0x16u
+#define OI_CMD_QUEUE_FRAME_FORMATTED                                  0x17u
+
+#define OI_CMD_SET_IQ                                                 0x21u
+#define OI_CMD_SET_BEAMFORM                                           0x22u
+
+///  Response Codes  ///
+#define OI_RES_ACK                                                    0x80u
+#define OI_RES_STATUS                                                 0x81u
+#define OI_RES_BOOT_PROFILE                                           0x82u
+#define OI_RES_TIMING                                                 0x83u
+#define OI_RES_VERSION                                                0x84u
+
+#define OI_RES_FRAME                                                  0x92u
+#define OI_RES_FRAME_PACKED                                           0x95u
+#define OI_RES_ESTIMATE                                               0x96u
+
+#define OI_RES_NACK                                                   0xFFu
+
+///  Status Flags  ///
+// Frame data is demodulated to baseband IQ (OI_CMD_SET_IQ).
+#define OI_STATUS_FLAG_IQ                                             0x01u
+// Frame data is beamformed to A-lines (OI_CMD_SET_BEAMFORM).
+#define OI_STATUS_FLAG_BEAMFORM                                       0x02u
+// The FSBL's initialization of some of the sample buffers' ECC failed (see
+//  OI_BOOT_EVENT_SCRUB_FAILED); frames that would record there are refused.
+#define OI_STATUS_FLAG_SCRUB_FAILED                                   0x04u
+
+
+///  Boot Profile  ///
+// Marks a valid OI_BOOT_PROFILE.
+#define OI_BOOT_PROFILE_MAGIC                                   0x464F5250u  // "PROF"
+// Most events timed by the FSBL.
+#define OI_BOOT_PROFILE_MAX_EVENTS                                       32u
+
+
+///  Timing Model  ///
+// Costs of the shot pipeline until the device has measured its own (see
+//  OI_TIMING_CAL), in nanoseconds.  They are reckoned from the registers
+//  each step writes:  252 verified words for each of the 4 pulsers, 300
+//  TGC words, and about a dozen verified SPI registers for each ADC.
+#define OI_TIMING_DEFAULT_ARM_NS                                     210000u
+#define OI_TIMING_DEFAULT_SHOT_NS                                     20000u
+#define OI_TIMING_DEFAULT_PULSER_NS                                  250000u
+#define OI_TIMING_DEFAULT_TGC_NS                                      30000u
+#define OI_TIMING_DEFAULT_ADC_NS                                      80000u
+#define OI_TIMING_DEFAULT_BD_NS                                         200u
+#define OI_TIMING_DEFAULT_REQUEST_NS                                  10000u
+// TCP payload of gigabit Ethernet.
+#define OI_TIMING_DEFAULT_LINK_BYTES_PER_SEC                      110000000u
+// The AD9670s' sample clock.
+#define OI_TIMING_DEFAULT_SAMPLE_RATE_HZ                           40000000u
+// Bytes of each DMA buffer descriptor; a shot's record takes as many as
+//  it needs, on each ADC.
+#define OI_DMA_BD_BYTES                                               2048u
+// The shot's TGC waveforms differ from those of the shot before it, so
+//  they are loaded (OI_ESTIMATE_SHOT.flags).
+#define OI_ESTIMATE_TGC_LOAD                                          0x01u
+
+
+// Total number of channels for transmit and receive.
+#define OI_N_CHAN                                                       16u
+
+// Number of entires for the level sequencer.
+#define OI_MAX_N_LEVEL_SEQUENCE                                        252u
+
+// Maximum number of runs in one run-length encoded transmit template.
+#define OI_TX_MAX_N_RUNS                                                30u
+
+// Maximum number of transmit templates shared by the shots of a frame.
+#define OI_TX_MAX_N_TEMPLATES                                            8u
+
+// Rate at which the level sequence is played; the SRC_CLK of the
+//  hv7321_axi4 instances.  Transmit delays are quantized to this clock.
+#define OI_TX_CLOCK_HZ                                           220000000u
+
+
+// Number of ADC devices present in the system.
+#define OI_RX_N_CHIPS                                                    2u
+
+// Maximum number of Time Gain Compensation values that may be specified.
+#define OI_RX_MAX_N_TGC                                                300u
+
+// Period of each Time Gain Compensation value.
+#define OI_TGC_POINT_NS                                                100u
+
+// Maximum number of segments in a parametric TGC curve.
+#define OI_TGC_MAX_N_SEGMENTS                                            8u
+
+// Maximum number of shots in one frame.
+#define OI_MAX_N_SHOTS                                                 100u
+
+// Maximum number of taps in the IQ low-pass filter.
+#define OI_IQ_MAX_N_TAPS                                                64u
+
+// Maximum decimation of the IQ output.
+#define OI_IQ_MAX_DECIMATION                                            32u
+
+// Maximum number of points in one beamformed line.
+#define OI_BF_MAX_N_DEPTH                                             4096u
+
+// Compression of raw frame data (OI_CMD_GET_FRAME_PACKED); see oiPack.c.
+// Largest range of raw data that one request may cover, so that the
+//  packed reply always fits in OI_MAX_REPLY_BYTES:  224 rows.
+#define OI_PACK_MAX_BYTES                                             3584u
+// Rows (samples of each channel) that share a predictor and Rice parameter.
+#define OI_PACK_BLOCK_ROWS                                              16u
+// Largest Rice parameter; residuals are less than 2^18.
+#define OI_PACK_MAX_K                                                   17u
+// Quotients from this up are escaped, and the residual sent in full.
+#define OI_PACK_ESCAPE_Q                                                16u
+#define OI_PACK_ESCAPE_BITS                                             18u
+
+// Formats of the recorded samples (OI_RX.sampleFormat).  The packed
+//  formats keep the most significant bits of each sample, and are packed
+//  LSB first into the stream:  sample i of a shot (counting across the
+//  channels of a row) occupies bits [b*i, b*i + b) for b bits per sample.
+#define OI_SAMPLE_FORMAT_16                                              0u
+#define OI_SAMPLE_FORMAT_14                                              1u
+#define OI_SAMPLE_FORMAT_12                                              2u
+#define OI_N_SAMPLE_FORMATS                                              3u
+// Shots in a packed format must be a multiple of this many rows, so that
+//  each ends on a whole AXI beat.
+#define OI_SAMPLE_FORMAT_ROWS                                            8u
+// Set when the bitstream has axis_sample_pack between each ADC's stream
+//  and its DMA, with its format on EMIO GPIO pins 25 and 26, as does
+//  edt_zcu106.bd.  Set to 0 for bitstreams without it, which accept only
+//  OI_SAMPLE_FORMAT_16.
+#ifndef OI_SAMPLE_PACK
+#	define OI_SAMPLE_PACK                                                 1
+#endif
+
+// Header of each shot of raw data (OI_SHOT_HEADER).
+#define OI_SHOT_HEADER_BYTES                                            32u
+// "OISH", as the FPGA writes it.
+#define OI_SHOT_MAGIC                                           0x4853494Fu
+// Flags of a shot header; none are set on a good shot.
+// The FPGA's shot sequence did not follow that of the previous shot:  data
+//  were lost.
+#define OI_SHOT_FLAG_SEQUENCE                                         0x01u
+// Fewer or more bytes arrived than were configured.
+#define OI_SHOT_FLAG_LENGTH                                           0x02u
+// The header did not come from the FPGA; the data are stale.
+#define OI_SHOT_FLAG_MAGIC                                            0x04u
+
+
+//**********************************  Types  *********************************//
+
+typedef enum tag_state {
+	STATE_INIT,
+	STATE_READY,
+	STATE_ARMED,
+	STATE_RECORD,
+	STATE_FAULT,
+
+	N_STATES,
+
+	STATE_ANY
+} state_t;
+
+typedef enum tag_oi_error {
+	OI_ERR_NONE,
+	OI_ERR_UNRECOGNIZED_COMMAND,
+	OI_ERR_BAD_PACKET,
+	OI_ERR_INCORRECT_SIZE,
+	OI_ERR_ILLEGAL_STATE,
+	OI_ERR_INVALID_PARAMETER,
+	OI_ERR_BUSY,                // no room to send the reply; ask again
+
+} oi_error_t;
+
+// Stages of the boot, as timed in OI_STATUS.bootUsec:  microseconds from the
+//  start of the system counter, early in the FSBL, or zero if not (yet)
+//  reached.
+typedef enum tag_oi_boot_stage {
+	OI_BOOT_FSBL_HANDOFF,   // the FSBL starts the application
+	OI_BOOT_PLATFORM,       // interrupts, timers and GPIO are set up
+	OI_BOOT_NETWORK,        // the PHY has negotiated; lwIP is up
+	OI_BOOT_ADC,            // the ADCs are programmed and settled
+	OI_BOOT_CALIBRATED,     // the ADC links are calibrated
+	OI_BOOT_READY,          // commands are accepted
+	OI_BOOT_FIRST_FRAME,    // the first frame is recorded and processed
+
+	OI_N_BOOT_STAGES
+} oi_boot_stage_t;
+
+// Events timed by the FSBL, in OI_BOOT_PROFILE; as XFSBL_PROFILE_* in
+//  xfsbl_profile.h.
+typedef enum tag_oi_boot_event {
+	OI_BOOT_EVENT_ENTRY,                   // the FSBL starts
+	OI_BOOT_EVENT_SYSTEM_INIT,             // psu_init done
+	OI_BOOT_EVENT_DDR_ECC_INIT,            // DDR ECC initialized
+	OI_BOOT_EVENT_INIT_DONE,               // XFsbl_Initialize done
+	OI_BOOT_EVENT_BOOT_DEVICE,             // boot headers read and checked
+	OI_BOOT_EVENT_PARTITION_START,
+	OI_BOOT_EVENT_PARTITION_COPIED,        // in memory
+	OI_BOOT_EVENT_PARTITION_HASHED,        // checksum checked
+	OI_BOOT_EVENT_PARTITION_AUTHENTICATED,
+	OI_BOOT_EVENT_BITSTREAM_DONE,          // the PL is configured
+	OI_BOOT_EVENT_PARTITION_DONE,
+	OI_BOOT_EVENT_HANDOFF,                 // the FSBL starts the application
+	OI_BOOT_EVENT_SCRUB_FAILED,            // added by the application:  an
+	                                       //  ADMA channel (as partition)
+	                                       //  failed to initialize its DDR
+} oi_boot_event_t;
+
+// NOTE: all data structures should have 32-bit alignment.
+
+typedef struct tag_oi_status {
+	uint32_t
+		state,
+		flags;
+
+	uint8_t buildDate[32];
+
+	// Shots recorded since power-up, and how many of those were flagged
+	//  (see OI_SHOT_HEADER).
+	uint32_t
+		nShots,
+		nBadShots;
+
+	// When each stage of the boot was reached (see oi_boot_stage_t).
+	uint32_t bootUsec[OI_N_BOOT_STAGES];
+} OI_STATUS;
+
+// Reply to OI_CMD_GET_BOOT_PROFILE:  the FSBL's stages, as it left them
+//  for the application; magic is zero if it did not (e.g., when started
+//  by the debugger).  Times are as OI_STATUS.bootUsec.
+typedef struct tag_oi_boot_profile {
+	uint32_t
+		magic,
+		nEvents;
+
+	struct tag_oi_boot_profile_event {
+		uint16_t
+			event,        // oi_boot_event_t
+			partition;    // of the boot image, for those of a partition
+		uint32_t usec;
+	} events[OI_BOOT_PROFILE_MAX_EVENTS];
+} OI_BOOT_PROFILE;
+
+typedef struct tag_oi_tx_channel {
+	uint32_t
+		enable,
+		nLevelSequence;
+
+	// Waveform to generate.  The waveform will be output at
+	//   oi_tx.CLOCK_RATE.
+	//  2 = Vpp0, 1 = Vpp1, 0 = RTZ, -1 = Vnn1, -2 = Vnn0;
+	//  e.g., [2 -2] would be  single-cycle square wave.
+	//  Note that the waveform *must* begin and end with RTZ.
+	int8_t levelSequence[OI_MAX_N_LEVEL_SEQUENCE];
+
+} OI_TX_CHANNEL;
+
+typedef struct tag_oi_tx {
+	OI_TX_CHANNEL channels[OI_N_CHAN];
+} OI_TX;
+
+/////  Run-Length Encoded Transmit  /////
+// One run of a transmit template:  'level' (as in levelSequence) held
+//  for 'count' clocks.  A count of zero is illegal.
+typedef struct tag_oi_tx_run {
+	int8_t level;
+	uint8_t count;
+} OI_TX_RUN;
+
+// A pulse shape shared by any number of channels and shots.
+typedef struct tag_oi_tx_template {
+	uint32_t nRuns;
+
+	OI_TX_RUN runs[OI_TX_MAX_N_RUNS];
+} OI_TX_TEMPLATE;
+
+// The channel outputs RTZ for 'delay' clocks, then plays template
+//  'iTemplate'.  The total length may not exceed OI_MAX_N_LEVEL_SEQUENCE.
+typedef struct tag_oi_tx_rle_channel {
+	uint8_t
+		enable,
+		iTemplate;
+	uint16_t delay;
+} OI_TX_RLE_CHANNEL;
+
+typedef struct tag_oi_tx_rle {
+	OI_TX_RLE_CHANNEL channels[OI_N_CHAN];
+} OI_TX_RLE;
+
+/////  Parametric (Focused) Transmit  /////
+// Every element in the aperture fires template 'iTemplate', delayed so
+//  that the wavefronts meet at the focal point.  The element positions
+//  are given by OI_FRAME_FOCUSED.pitchNm, centred on the array.
+typedef struct tag_oi_tx_focus {
+	uint32_t
+		apertureMask,  // bit i enables element i
+		iTemplate;
+
+	// Focal point relative to the centre of the array face, in
+	//  micrometres, within 500 mm.  A depth of zero or less selects a plane
+	//  wave steered by 'steerMdeg' instead.
+	int32_t
+		focusXUm,
+		focusZUm;
+
+	// Plane wave steering angle, in millidegrees; positive toward the
+	//  last element.
+	int32_t steerMdeg;
+} OI_TX_FOCUS;
+
+typedef struct tag_oi_rx_channel {
+	uint32_t enable;
+
+} OI_RX_CHANNEL;
+
+typedef struct tag_oi_rx {
+	OI_RX_CHANNEL channels[OI_N_CHAN];
+
+	uint32_t
+		nSamples,
+		nTgc[OI_RX_N_CHIPS];
+
+	uint8_t
+		lpfMul[OI_RX_N_CHIPS],
+		lpfDiv[OI_RX_N_CHIPS],
+		tgc[OI_RX_N_CHIPS][OI_RX_MAX_N_TGC],
+		lna[OI_RX_N_CHIPS],
+		pga[OI_RX_N_CHIPS],
+		hpf_divisor[OI_RX_N_CHIPS],
+		testMode[OI_RX_N_CHIPS];
+
+	// One of OI_SAMPLE_FORMAT_*.  Added in version 2, last, so that a shot
+	//  of version 1 is an OI_SHOT without it (OI_SHOT_V1_BYTES).
+	uint32_t sampleFormat;
+
+} OI_RX;
+
+/////  Parametric Time Gain Compensation  /////
+// A linear ramp of the TGC level over 'duration' TGC points.  Levels are
+//  DAC codes in 8.8 fixed point; since the AD9670 gain is linear in dB
+//  with the TGC voltage, this is a constant slope in dB/usec.
+typedef struct tag_oi_tgc_segment {
+	uint16_t
+		duration,
+		endLevel;
+} OI_TGC_SEGMENT;
+
+// The level starts at 'startLevel', follows the segments, and then holds.
+typedef struct tag_oi_tgc_curve {
+	uint16_t
+		startLevel,
+		nSegments;
+
+	OI_TGC_SEGMENT segments[OI_TGC_MAX_N_SEGMENTS];
+} OI_TGC_CURVE;
+
+// As OI_RX, but the TGC waveforms are given as curves.
+typedef struct tag_oi_rx_compact {
+	OI_RX_CHANNEL channels[OI_N_CHAN];
+
+	uint32_t nSamples;
+
+	OI_TGC_CURVE tgc[OI_RX_N_CHIPS];
+
+	uint8_t
+		lpfMul[OI_RX_N_CHIPS],
+		lpfDiv[OI_RX_N_CHIPS],
+		lna[OI_RX_N_CHIPS],
+		pga[OI_RX_N_CHIPS],
+		hpf_divisor[OI_RX_N_CHIPS],
+		testMode[OI_RX_N_CHIPS];
+
+	// As OI_RX.
+	uint32_t sampleFormat;
+
+} OI_RX_COMPACT;
+
+typedef struct tag_oi_shot {
+	OI_TX tx;
+
+	OI_RX rx;
+
+} OI_SHOT;
+
+// Of OI_CMD_QUEUE_FRAME_FORMATTED; of OI_CMD_QUEUE_FRAME, but with the
+//  shots of version 1 (OI_SHOT_V1_BYTES each), which record 16 bits.
+typedef struct tag_oi_frame {
+	uint32_t
+		handle,
+		nShots;
+
+	OI_SHOT shots[OI_MAX_N_SHOTS];
+} OI_FRAME;
+
+typedef struct tag_oi_shot_rle {
+	OI_TX_RLE tx;
+
+	OI_RX_COMPACT rx;
+
+} OI_SHOT_RLE;
+
+// As OI_FRAME, but the transmit waveforms are run-length encoded, and the
+//  TGC waveforms are parametric.  As with OI_FRAME, only 'nShots' shots
+//  are sent.
+typedef struct tag_oi_frame_rle {
+	uint32_t
+		handle,
+		nShots,
+		nTemplates;
+
+	OI_TX_TEMPLATE templates[OI_TX_MAX_N_TEMPLATES];
+
+	OI_SHOT_RLE shots[OI_MAX_N_SHOTS];
+} OI_FRAME_RLE;
+
+
+typedef struct tag_oi_shot_focused {
+	OI_TX_FOCUS tx;
+
+	OI_RX_COMPACT rx;
+
+} OI_SHOT_FOCUSED;
+
+// As OI_FRAME_RLE, but the device computes the transmit delays.
+typedef struct tag_oi_frame_focused {
+	uint32_t
+		handle,
+		nShots,
+		nTemplates,
+		pitchNm,          // element pitch, at most 10 mm
+		speedOfSound;     // m/s
+
+	OI_TX_TEMPLATE templates[OI_TX_MAX_N_TEMPLATES];
+
+	OI_SHOT_FOCUSED shots[OI_MAX_N_SHOTS];
+} OI_FRAME_FOCUSED;
+
+
+/////  Baseband IQ  /////
+// When enabled, each shot is mixed down by the local oscillator, low-pass
+//  filtered and decimated as it is recorded, and OI_CMD_GET_FRAME returns
+//  the IQ data instead of the RF.  For each ADC, each shot then holds
+//  OI_IQ_N_OUT samples, each of which is the (I, Q) pairs of that ADC's
+//  channels, as int16_t.
+typedef struct tag_oi_iq_config {
+	uint32_t
+		enable,
+		phaseInc;     // LO frequency as a fraction of the sample rate, * 2^32
+
+	uint16_t
+		decimation,
+		nTaps;
+
+	// Low-pass filter in Q15.  The sum of the magnitudes of the taps must be
+	//  less than 2.0.  Output m is centred on input sample m*decimation.
+	int16_t taps[OI_IQ_MAX_N_TAPS];
+} OI_IQ_CONFIG;
+
+/////  Beamforming  /////
+// When enabled, each shot is beamformed into one A-line as it is
+//  recorded, and OI_CMD_GET_FRAME returns the lines (for either ADC)
+//  instead of the RF:  'nDepth' int32_t points per shot, one after the
+//  other.  Enabling this and IQ at once is illegal.
+typedef struct tag_oi_bf_config {
+	uint32_t
+		enable,
+		pitchNm,          // element pitch
+		speedOfSound,     // m/s
+		sampleRateHz,     // of the ADCs
+		nDepth,           // points per line
+		depthStartUm,
+		depthStepUm;
+
+	// Subtracted from every delay, in 1/256 samples; e.g., the time from
+	//  the start of the recording to the centre of the transmitted pulse.
+	int32_t offsetQ8;
+
+	// Receive apodization of each channel, in Q15.
+	int16_t apodization[OI_N_CHAN];
+
+	// Lateral position of each shot's line, relative to the centre of the
+	//  array, in micrometres.  The line runs straight down.
+	int32_t lineXUm[OI_MAX_N_SHOTS];
+} OI_BF_CONFIG;
+
+
+// Precedes the samples of each shot in the raw data, for each ADC.  The
+//  first half is written by the FPGA as the shot is recorded; the second by
+//  the firmware, once it has checked the first.  Bitstreams without the
+//  FPGA's half leave its space to the firmware, which writes all of it:
+//  the sequence counts the firmware's shots, and the timestamp is zero.
+typedef struct tag_oi_shot_header {
+	uint32_t
+		magic,         // OI_SHOT_MAGIC
+		sequence,      // shots through the FPGA since it was reset
+		timestampLo,   // stream clocks at the first sample
+		timestampHi;
+
+	uint32_t
+		handle,        // of the frame
+		iShot,
+		nBytes,        // of samples that follow, as transferred
+		flags;         // OI_SHOT_FLAG_*
+} OI_SHOT_HEADER;
+
+// Request for frame data.  The raw data of each shot start with an
+//  OI_SHOT_HEADER, so a shot takes OI_RX_SHOT_RECORD_BYTES.  For
+//  OI_CMD_GET_FRAME_PACKED, the range is of the
+//  raw data, whole rows of which must be requested (multiples of 16 bytes),
+//  at most OI_PACK_MAX_BYTES; the reply is those rows, packed as oiPack.c.
+typedef struct tag_oi_frame_data_req {
+	uint32_t
+		iAdc,
+		byteOffset,
+		nBytes;
+} OI_FRAME_DATA_REQ;
+
+// Reply to OI_CMD_GET_TIMING:  the costs with which the device estimates
+//  frames (oiTiming.c).  It starts from the defaults (OI_TIMING_DEFAULT_*),
+//  and averages in what it measures of each shot it records; the link's
+//  costs are not measured, as they depend on the client.
+typedef struct tag_oi_timing_cal {
+	uint32_t
+		armNs,           // from queueing a frame to its first shot's setup
+		shotNs,          // of each shot, beyond its setup and recording
+		pulserNs,        // loading and verifying the pulsers' waveforms
+		tgcNs,           // loading the TGC waveforms, when they change
+		adcNs,           // writing and verifying the ADCs' registers
+		bdNs,            // setting up each DMA buffer descriptor
+		requestNs,       // the device's handling of a request for data
+		linkBytesPerSec,
+		sampleRateHz,
+		nMeasured;       // shots timed; zero for the defaults
+} OI_TIMING_CAL;
+
+// What a shot's timing depends on.
+typedef struct tag_oi_estimate_shot {
+	uint32_t
+		nSamples,
+		sampleFormat,    // OI_SAMPLE_FORMAT_*
+		flags;           // OI_ESTIMATE_*
+} OI_ESTIMATE_SHOT;
+
+// Request of OI_CMD_ESTIMATE_FRAME, for a frame of raw data.
+typedef struct tag_oi_estimate_req {
+	uint32_t
+		nShots,
+		programBytes,    // of the frame as queued
+		chunkBytes,      // of each request for its data
+		pollNs,          // between the client's polls of the status
+		clearDepthUm,    // echoes that should die out before each next shot
+		speedOfSound;    // m/s; zero for 1540
+	OI_ESTIMATE_SHOT shots[OI_MAX_N_SHOTS];
+} OI_ESTIMATE_REQ;
+
+// Reply to OI_CMD_ESTIMATE_FRAME.  A frame is queued, armed, its shots are
+//  recorded one after another, and then its data are read:  none of these
+//  overlap, as the device reuses its buffers for the next frame.
+typedef struct tag_oi_frame_estimate {
+	uint32_t
+		uploadNs,        // sending the frame, until it is acknowledged
+		armNs,
+		setupNs,         // of every shot:  pulsers, TGC, ADCs and DMA
+		recordNs,        // of every shot's samples
+		shotsNs,         // from the first shot's setup to the last's end
+		pollNs,          // on average, until the client sees the end
+		transferNs,      // reading every byte of both ADCs
+		frameNs,         // the sum:  from queueing to having the data
+		prfMilliHz,      // shots per second, while recording
+		frameRateMilliHz,// frames per second, one after another
+		linkPermille,    // of the frame's time that the link is busy
+		nBds,            // of each ADC, over the frame
+		nEchoOverlap;    // shots that fire before clearDepthUm's echoes
+} OI_FRAME_ESTIMATE;
+
+
+//*********************************  Macros  *********************************//
+
+// Number of bytes on the wire for a frame with the given number of shots.
+#define OI_FRAME_BYTES(nShots)                                            \
+	(sizeof(OI_FRAME) - sizeof(OI_SHOT) * (OI_MAX_N_SHOTS - (nShots)))
+// A shot as OI_CMD_QUEUE_FRAME takes it:  an OI_SHOT up to rx.sampleFormat.
+#define OI_SHOT_V1_BYTES                   (sizeof(OI_SHOT) - sizeof(uint32_t))
+#define OI_FRAME_V1_BYTES(nShots)                                         \
+	(OI_FRAME_BYTES(0u) + OI_SHOT_V1_BYTES * (nShots))
+#define OI_FRAME_RLE_BYTES(nShots)                                        \
+	(sizeof(OI_FRAME_RLE) - sizeof(OI_SHOT_RLE) * (OI_MAX_N_SHOTS - (nShots)))
+#define OI_FRAME_FOCUSED_BYTES(nShots)                                    \
+	(sizeof(OI_FRAME_FOCUSED)                                             \
+			- sizeof(OI_SHOT_FOCUSED) * (OI_MAX_N_SHOTS - (nShots)))
+// Number of bytes on the wire for an estimate of a frame of nShots.
+#define OI_ESTIMATE_REQ_BYTES(nShots)                                     \
+	(sizeof(OI_ESTIMATE_REQ)                                              \
+			- sizeof(OI_ESTIMATE_SHOT) * (OI_MAX_N_SHOTS - (nShots)))
+// Number of IQ samples produced from a shot of nSamples RF samples.
+#define OI_IQ_N_OUT(nSamples, decimation)                                 \
+	(((nSamples) + (decimation) - 1u) / (decimation))
+// Most bytes that nRows rows of raw data may pack into:  34 bits per
+//  sample, 60 bits per block, and a partial word.
+#define OI_PACK_MAX_PACKED_BYTES(nRows)                                   \
+	((nRows) * 34u + ((nRows) + OI_PACK_BLOCK_ROWS - 1u)                  \
+			/ OI_PACK_BLOCK_ROWS * 8u + 4u)
+// Bits per sample of each sample format.
+#define OI_SAMPLE_BITS(format)                                            \
+	((format) == OI_SAMPLE_FORMAT_14 ? 14u                                \
+			: (format) == OI_SAMPLE_FORMAT_12 ? 12u : 16u)
+// Bytes of samples recorded from each ADC for a shot of nSamples rows.
+#define OI_RX_SHOT_BYTES(nSamples, format)                                \
+	((nSamples) * (OI_N_CHAN / OI_RX_N_CHIPS) * OI_SAMPLE_BITS(format) / 8u)
+// As OI_RX_SHOT_BYTES, with the shot's header.
+#define OI_RX_SHOT_RECORD_BYTES(nSamples, format)                         \
+	(OI_SHOT_HEADER_BYTES + OI_RX_SHOT_BYTES(nSamples, format))
+
+
+//********************************  Functions  *******************************//
+// These are portable, and built into both the firmware and host software.
+
+oi_error_t oiTxRleValidate(
+		const OI_TX_RLE* pRle,
+		const OI_TX_TEMPLATE* pTemplates,
+		uint32_t nTemplates
+);
+void oiTxRleExpand(
+		OI_TX* pTx,
+		const OI_TX_RLE* pRle,
+		const OI_TX_TEMPLATE* pTemplates
+);
+
+oi_error_t oiRxValidate(const OI_RX_COMPACT* pRx);
+oi_error_t oiRxValidateFormat(uint32_t sampleFormat, uint32_t nSamples);
+void oiRxExpand(OI_RX* pRx, const OI_RX_COMPACT* pCompact);
+void oiTgcRender(uint8_t* pLevels, const OI_TGC_CURVE* pCurve);
+
+oi_error_t oiTxPlanFocus(
+		OI_TX_RLE* pRle,
+		const OI_TX_FOCUS* pFocus,
+		uint32_t pitchNm,
+		uint32_t speedOfSound
+);
+double oiSine(double x);
+uint64_t oiIsqrt(uint64_t x);
+
+oi_error_t oiIqValidate(const OI_IQ_CONFIG* pCfg);
+void oiIqDemodulate(
+		int16_t* pIq,
+		const int16_t* pRf,
+		uint32_t nSamples,
+		const OI_IQ_CONFIG* pCfg
+);
+
+oi_error_t oiBfValidate(const OI_BF_CONFIG* pCfg);
+void oiBfDelays(uint32_t* pDelays, const OI_BF_CONFIG* pCfg, uint32_t iShot);
+void oiBfSum(
+		int32_t* pLine,
+		const int16_t* const* ppRf,
+		uint32_t nSamples,
+		const uint32_t* pDelays,
+		const OI_BF_CONFIG* pCfg
+);
+
+uint32_t oiPackEncode(uint32_t* pOut, const int16_t* pIn, uint32_t nRows);
+
+void oiTimingDefaults(OI_TIMING_CAL* pCal);
+oi_error_t oiTimingEstimate(
+		OI_FRAME_ESTIMATE* pEst,
+		const OI_ESTIMATE_REQ* pReq,
+		const OI_TIMING_CAL* pCal
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __OPEN_IMAGE_PROTOCOL_H__ */
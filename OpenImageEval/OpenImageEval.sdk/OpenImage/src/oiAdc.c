@@ -13,13 +13,18 @@
 #include <xspips.h>
 
 //********************************  Constants  *******************************//
-// ADC Settings.
+// ADC Settings.  These are the defaults; the link is calibrated at boot
+//  (see oiAdcCal.c).
 #define FCO_ROTATE_ADC0                                                  -2
 #define DCO_DELAY_ADC0                                                  200
 
 #define FCO_ROTATE_ADC1                                                  -2
 #define DCO_DELAY_ADC1                                                  300
 
+// Time allowed after programming for the ADCs' clocks to settle, and between
+//  attempts to talk to an ADC that does not answer.
+#define SETTLE_USEC                                                  100000u
+
 //**********************************  Types  *********************************//
 typedef struct tag_verified_reg {
 	uint16_t reg;
@@ -162,6 +167,18 @@ static const struct tag_test_choice {
 
 static XSpiPs hSpi;
 
+// When the ADCs will have settled after oiAdcInit.
+static uint32_t settledUsec;
+
+// Current link settings of each ADC.
+static struct tag_link {
+	int32_t fcoRotate;
+	uint32_t dcoDelayPs;
+} link[OI_RX_N_CHIPS] = {
+	{ FCO_ROTATE_ADC0, DCO_DELAY_ADC0 },
+	{ FCO_ROTATE_ADC1, DCO_DELAY_ADC1 },
+};
+
 static const uint32_t adcBaseAddr[] = {
 	XPAR_AD9670_AXI4_0_S_AXI_BASEADDR,
 	XPAR_AD9670_AXI4_1_S_AXI_BASEADDR
@@ -216,13 +233,13 @@ void oiAdcInit(void)
 		// Note that AFE1 is mapped to Channel 0.
 		// Indicate which chip select to use:
 		hSpi.SlaveSelect = (!iAdc) << XSPIPS_CR_SSCTRL_SHIFT;   // TODO fix
-		// Perform a read of the ID register.
-		const uint8_t id = readReg(AD9670_REG_CHIP_ID);
-
 		bool result = false;
 		uint32_t onoff = 0u;
 		
 		while (result == false) {
+			// Perform a read of the ID register.
+			const uint8_t id = readReg(AD9670_REG_CHIP_ID);
+			
 			if (id == AD9670_CHIP_ID_AD9670) {
 				// Ok.  We're talking successfully to the chip.  Reset it.
 				result = writeRegisterTable(AD9670_REGS, _countof(AD9670_REGS));
@@ -239,9 +256,14 @@ void oiAdcInit(void)
 				result = false;
 			}
 	
-			XGpioPs_WritePin(&hGpio, USER_LED_PIN, onoff);
-			onoff ^= 1u;
-			WAIT_USEC(100000u);  // 100 msec
+			if (!result) {
+				// Blink, and try again.
+				XGpioPs_WritePin(&hGpio, USER_LED_PIN, onoff);
+				onoff ^= 1u;
+				WAIT_USEC(SETTLE_USEC);
+			} else {
+				// Ok.
+			}
 		}
 		
 		if (!result) {
@@ -254,6 +276,17 @@ void oiAdcInit(void)
 	
 	// Set the GPIO output to enable the ADC:
 	EMIO_GPIO_SET_PIN(EMIO_GPIO_PIN_ADC_ENABLE);	
+	
+	// Rather than wait for the clocks to settle here, let the rest of the
+	//  boot proceed; see oiAdcWaitReady.
+	settledUsec = oiBootUsec() + SETTLE_USEC;
+}
+
+// Waits for whatever remains of the time for the ADCs to settle after
+//  oiAdcInit; before anything is recorded.
+void oiAdcWaitReady(void)
+{
+	oiBootWaitUntil(settledUsec);
 }
 
 void oiAdcVisit(void)
@@ -317,7 +350,17 @@ void oiAdcSetup(const OI_RX* pRx)
 		
 	}
 	
-	oiAdcDmaSetup(pRx->nSamples);
+#if OI_SAMPLE_PACK
+	// Select the format in which the samples are packed on their way to
+	//  the DMA; both ADCs share the setting.
+	EMIO_GPIO_CLEAR_PIN(EMIO_GPIO_PIN_SAMPLE_FORMAT_0);
+	EMIO_GPIO_CLEAR_PIN(EMIO_GPIO_PIN_SAMPLE_FORMAT_1);
+	EMIO_GPIO_SET_PINS((pRx->sampleFormat & 3u)
+			<< EMIO_GPIO_PIN_SAMPLE_FORMAT_0);
+#endif
+	
+	// The DMA is set up after this, by the shot manager, which times it
+	//  apart from the SPI writes.
 
 	// Set the GPIO output to enable the ADC:	
 //	EMIO_GPIO_SET_PIN(EMIO_GPIO_PIN_ADC_ENABLE);	
@@ -339,6 +382,75 @@ void oiAdcSetup(const OI_RX* pRx)
 #endif
 }
 
+// Sets the frame clock rotation and data clock delay of an ADC's LVDS
+//  outputs.  Returns false if the registers did not verify.
+bool oiAdcSetLink(uint32_t iAdc, int32_t fcoRotate, uint32_t dcoDelayPs)
+{
+	const verified_reg_t regs[] = {
+		{ AD9670_REG_SERIAL_FORMAT,
+			AD9670_SERIAL_FORMAT_FCO_START_CODE_EN
+			| AD9670_SERIAL_FORMAT_FCO_CONTINUOUS
+			| AD9670_SERIAL_FORMAT_FCO_ROTATE(fcoRotate),
+			AD9670_SERIAL_FORMAT_MASK },
+		{ AD9670_REG_FLEX_OUT_DEL,
+			AD9670_FLEX_OUT_DEL_ENABLE
+			| AD9670_FLEX_OUT_DEL_PSEC(dcoDelayPs),
+			AD9670_FLEX_OUT_DEL_MASK },
+	};
+	
+	hSpi.SlaveSelect = (!iAdc) << XSPIPS_CR_SSCTRL_SHIFT;   // TODO fix
+	const bool result = writeRegisterTable(regs, _countof(regs));
+	
+	link[iAdc].fcoRotate = fcoRotate;
+	link[iAdc].dcoDelayPs = dcoDelayPs;
+	
+	return result;
+}
+
+void oiAdcGetLink(uint32_t iAdc, int32_t* pFcoRotate, uint32_t* pDcoDelayPs)
+{
+	*pFcoRotate = link[iAdc].fcoRotate;
+	*pDcoDelayPs = link[iAdc].dcoDelayPs;
+}
+
+// Switches both ADCs between the user patterns (USR_PAT1..4, repeated) and
+//  normal operation.
+void oiAdcSetUserPattern(bool isOn)
+{
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		hSpi.SlaveSelect = (!iAdc) << XSPIPS_CR_SSCTRL_SHIFT;   // TODO fix
+		
+		if (isOn) {
+			writeRegisterTable(
+					TEST_USER_IO_REGS, 
+					_countof(TEST_USER_IO_REGS)
+			);
+		} else {
+			writeRegisterTable(
+					TEST_NORMAL_OPERATION_REGS,
+					_countof(TEST_NORMAL_OPERATION_REGS)
+			);
+		}
+	}
+}
+
+// Resets and triggers both ADC IPs from software, rather than the pulser.
+void oiAdcSoftTrigger(void)
+{
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		AD9670_IP_REG_CONTROL(adcBaseAddr[iAdc]) = AD9670_IP_CONTROL_RESET;
+		WAIT_USEC(1);
+		AD9670_IP_REG_CONTROL(adcBaseAddr[iAdc]) = 0u;
+	}
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		AD9670_IP_REG_CONTROL(adcBaseAddr[iAdc]) = AD9670_IP_CONTROL_TRIGGER;
+	}
+	WAIT_USEC(1);
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		AD9670_IP_REG_CONTROL(adcBaseAddr[iAdc]) = 0u;
+	}
+}
+
 //***********************  Local Function Definitions  ***********************//
 static uint8_t readReg(uint32_t reg)
 {
@@ -0,0 +1,327 @@
+/*
+	oiAdcCal.c
+
+	Calibration of the ADC LVDS links at boot.  Each ADC sends its user
+	patterns, and the data clock delay (DCO) and frame clock rotation
+	(FCO) are chosen so that they arrive intact:
+
+	1. The delay is swept coarsely.  At each point, the samples are
+	   checked for being the patterns shifted by some number of bits,
+	   which shows that the bits are sampled cleanly even if the word
+	   boundaries are wrong.
+	2. The widest run of clean points is refined to the edges of the eye
+	   at the fine step, and the delay is set to its centre.
+	3. The shift seen at the centre suggests the frame clock rotation;
+	   the likely rotations are tried first, then the rest.
+
+	This takes a few dozen captures rather than the several hundred of a
+	full sweep.  The result is stored in the QSPI flash, and on the next
+	boot is used directly if one capture with it is clean.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image.h"
+
+#include <stddef.h>
+#include <xil_printf.h>
+
+//********************************  Constants  *******************************//
+// Samples (of each channel) captured for each check.
+#define CAL_ROWS                                                         64u
+#define N_LANES                                (OI_N_CHAN / OI_RX_N_CHIPS)
+#define ROW_BYTES                                (N_LANES * sizeof(uint16_t))
+
+// Range of the settings; as the AD9670 allows.
+#define FCO_ROTATE_MIN                                                   -4
+#define FCO_ROTATE_MAX                                                    7
+#define DCO_DELAY_MAX_PS                                              3200u
+#define DCO_COARSE_PS                                                  400u
+#define DCO_FINE_PS                                                    100u
+#define N_COARSE                       (DCO_DELAY_MAX_PS / DCO_COARSE_PS + 1u)
+
+// Longest wait for a capture to complete.
+#define CAPTURE_TIMEOUT_USEC                                          1000u
+
+#define N_PATTERNS                                                        4u
+#define WORD_BITS                                                        16u
+
+// Stored calibration.
+#define CAL_MAGIC                                               0x4C414349u  // "ICAL"
+#define CAL_VERSION                                                       1u
+
+//**********************************  Types  *********************************//
+typedef struct tag_adc_cal {
+	uint32_t
+		magic,
+		version;
+	int32_t fcoRotate[OI_RX_N_CHIPS];
+	uint32_t dcoDelayPs[OI_RX_N_CHIPS];
+	uint64_t hash;       // of the above
+} adc_cal_t;
+
+//*******************************  Module Data  ******************************//
+// As programmed into AD9670_REG_USR_PAT1..4 (see oiAdc.c).
+static const uint16_t PATTERNS[N_PATTERNS] = { 0x1234, 0xDEAD, 0xF00D, 0xFACE };
+
+//***********************  Local Function Declarations  **********************//
+static bool search(uint32_t iAdc);
+static int32_t findShift(uint32_t iAdc);
+static int32_t laneShift(const uint16_t* pRows, uint32_t iLane);
+static const uint16_t* capture(uint32_t iAdc);
+static uint64_t hashCal(const adc_cal_t* pCal);
+
+//****************************  Global Functions  ****************************//
+
+// Called once at boot, before the links are used.  On failure, the
+//  defaults in oiAdc.c are kept.
+void oiAdcCalibrate(void)
+{
+	adc_cal_t stored, cal;
+	bool
+		isStored = oiFlashRead(OI_FLASH_CAL_OFFSET, &stored, sizeof(stored))
+				&& stored.magic == CAL_MAGIC
+				&& stored.version == CAL_VERSION
+				&& stored.hash == hashCal(&stored),
+		isChanged = false,
+		isOk = true;
+
+	oiAdcSetUserPattern(true);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		bool isGood = false;
+
+		if (isStored) {
+			// Quick check of what worked last time:
+			oiAdcSetLink(
+					iAdc,
+					stored.fcoRotate[iAdc],
+					stored.dcoDelayPs[iAdc]
+			);
+			isGood = findShift(iAdc) == 0;
+		} else {
+			// Nothing stored.
+		}
+
+		if (isGood) {
+			// Ok.
+		} else if (search(iAdc)) {
+			isChanged = true;
+		} else {
+			xil_printf("ADC %u link calibration failed\r\n", iAdc);
+			isOk = false;
+		}
+
+		oiAdcGetLink(iAdc, &cal.fcoRotate[iAdc], &cal.dcoDelayPs[iAdc]);
+		xil_printf("ADC %u link: FCO %d, DCO %u ps\r\n", iAdc,
+				cal.fcoRotate[iAdc], cal.dcoDelayPs[iAdc]);
+	}
+
+	oiAdcSetUserPattern(false);
+	oiAdcDmaRestartRecording();
+
+	if (isOk && isChanged) {
+		cal.magic = CAL_MAGIC;
+		cal.version = CAL_VERSION;
+		cal.hash = hashCal(&cal);
+
+		if (!oiFlashWriteSector(OI_FLASH_CAL_OFFSET, &cal, sizeof(cal))) {
+			xil_printf("ADC link calibration not saved\r\n");
+		} else {
+			// Saved.
+		}
+	} else {
+		// Nothing new to keep, or not worth keeping.
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Full search for one ADC; returns false, with the defaults restored, if
+//  no clean setting was found.
+static bool search(uint32_t iAdc)
+{
+	int32_t fcoRotate;
+	uint32_t dcoDelayPs;
+	oiAdcGetLink(iAdc, &fcoRotate, &dcoDelayPs);
+	const int32_t fcoDefault = fcoRotate;
+	const uint32_t dcoDefault = dcoDelayPs;
+
+	// 1. Coarse sweep of the delay:
+	bool isClean[N_COARSE];
+	for (uint32_t k = 0u; k < N_COARSE; ++k) {
+		oiAdcSetLink(iAdc, fcoRotate, k * DCO_COARSE_PS);
+		isClean[k] = findShift(iAdc) >= 0;
+	}
+
+	// 2. Widest run of clean points, refined at the fine step:
+	uint32_t bestStart = 0u, bestLength = 0u;
+	for (uint32_t k = 0u; k < N_COARSE; ) {
+		uint32_t n = 0u;
+		while (k + n < N_COARSE && isClean[k + n]) {
+			++n;
+		}
+
+		if (n > bestLength) {
+			bestStart = k;
+			bestLength = n;
+		} else {
+			// Narrower.
+		}
+		k += n + 1u;
+	}
+
+	bool result = bestLength > 0u;
+	int32_t shift = -1;
+
+	if (result) {
+		const uint32_t centre
+			= (bestStart * 2u + bestLength - 1u) * DCO_COARSE_PS / 2u;
+		uint32_t lo = centre, hi = centre;
+
+		while (lo >= DCO_FINE_PS) {
+			oiAdcSetLink(iAdc, fcoRotate, lo - DCO_FINE_PS);
+			if (findShift(iAdc) < 0) {
+				break;
+			} else {
+				lo -= DCO_FINE_PS;
+			}
+		}
+		while (hi + DCO_FINE_PS <= DCO_DELAY_MAX_PS) {
+			oiAdcSetLink(iAdc, fcoRotate, hi + DCO_FINE_PS);
+			if (findShift(iAdc) < 0) {
+				break;
+			} else {
+				hi += DCO_FINE_PS;
+			}
+		}
+
+		dcoDelayPs = (lo + hi) / 2u / DCO_FINE_PS * DCO_FINE_PS;
+		oiAdcSetLink(iAdc, fcoRotate, dcoDelayPs);
+		shift = findShift(iAdc);
+		result = shift >= 0;
+	} else {
+		// The eye was never open.
+	}
+
+	// 3. The frame clock; the rotations the shift suggests first:
+	if (result && shift != 0) {
+		const int32_t likely[] = { fcoRotate - shift, fcoRotate + shift };
+		result = false;
+
+		for (uint32_t i = 0u; i < _countof(likely) && !result; ++i) {
+			if (likely[i] >= FCO_ROTATE_MIN && likely[i] <= FCO_ROTATE_MAX) {
+				oiAdcSetLink(iAdc, likely[i], dcoDelayPs);
+				result = findShift(iAdc) == 0;
+			} else {
+				// Out of range.
+			}
+		}
+		for (int32_t f = FCO_ROTATE_MIN; f <= FCO_ROTATE_MAX && !result; ++f) {
+			oiAdcSetLink(iAdc, f, dcoDelayPs);
+			result = findShift(iAdc) == 0;
+		}
+	} else {
+		// Already aligned, or failed.
+	}
+
+	if (!result) {
+		oiAdcSetLink(iAdc, fcoDefault, dcoDefault);
+	} else {
+		// Keep.
+	}
+
+	return result;
+}
+
+// Captures, and returns the number of bits (0 to 15) by which every lane of
+//  the ADC is shifted from the patterns; or -1 if they do not agree, or
+//  any lane is not the patterns at all.
+static int32_t findShift(uint32_t iAdc)
+{
+	const uint16_t* const pRows = capture(iAdc);
+	int32_t result = pRows != NULL ? laneShift(pRows, 0u) : -1;
+
+	for (uint32_t iLane = 1u; iLane < N_LANES && result >= 0; ++iLane) {
+		if (laneShift(pRows, iLane) != result) {
+			result = -1;
+		} else {
+			// Agrees.
+		}
+	}
+
+	return result;
+}
+
+// Finds the shift, phase and polarity that explain every sample of one
+//  lane.  Some channels are inverted (see AD9670_REG_OUTPUT_MODE in
+//  oiAdc.c), so either polarity is accepted.
+static int32_t laneShift(const uint16_t* pRows, uint32_t iLane)
+{
+	int32_t result = -1;
+
+	for (uint32_t shift = 0u; shift < WORD_BITS && result < 0; ++shift) {
+		for (uint32_t phase = 0u; phase < N_PATTERNS && result < 0; ++phase) {
+			for (uint32_t invert = 0u; invert <= 1u && result < 0; ++invert) {
+				bool isMatch = true;
+
+				for (uint32_t n = 0u; n < CAL_ROWS && isMatch; ++n) {
+					// The word seen straddles two sent words:
+					const uint32_t
+						a = PATTERNS[(phase + n) % N_PATTERNS],
+						b = PATTERNS[(phase + n + 1u) % N_PATTERNS],
+						expected = ((a << shift) | (b >> (WORD_BITS - shift)))
+								& 0xFFFFu;
+
+					isMatch = (pRows[n * N_LANES + iLane]
+							^ (invert ? 0xFFFFu : 0u)) == expected;
+				}
+
+				result = isMatch ? (int32_t) shift : -1;
+			}
+		}
+	}
+
+	return result;
+}
+
+// Records CAL_ROWS rows from both ADCs, and returns those of one; NULL if
+//  the DMA did not finish.  They land at the start of each buffer, which
+//  the FSBL initializes before handoff, so this never waits on its scrub.
+static const uint16_t* capture(uint32_t iAdc)
+{
+	const OI_FRAME_DATA_REQ req = {
+		iAdc, OI_SHOT_HEADER_BYTES, CAL_ROWS * ROW_BYTES
+	};
+	uint32_t waited = 0u;
+
+	oiAdcDmaRestartRecording();
+	if (!oiAdcDmaSetup(CAL_ROWS * ROW_BYTES)) {
+		return NULL;
+	} else {
+		// Ok.
+	}
+	oiAdcSoftTrigger();
+
+	while (!oiAdcDmaIsDone() && waited < CAPTURE_TIMEOUT_USEC) {
+		WAIT_USEC(1);
+		++waited;
+	}
+
+	const bool isDone = oiAdcDmaIsDone();
+	oiAdcDmaDiscardShot();
+
+	return isDone ? (const uint16_t*) oiAdcDmaGetFrameData(&req) : NULL;
+}
+
+static uint64_t hashCal(const adc_cal_t* pCal)
+{
+	const uint8_t* const pBytes = (const uint8_t*) pCal;
+	uint64_t hash = FNV_OFFSET_BASIS;
+
+	for (uint32_t i = 0u; i < offsetof(adc_cal_t, hash); ++i) {
+		hash = (hash ^ pBytes[i]) * FNV_PRIME;
+	}
+
+	return hash;
+}
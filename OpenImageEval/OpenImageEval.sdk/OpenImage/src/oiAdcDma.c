@@ -22,7 +22,7 @@
 #define SAMPLE_BUFFER_SPACE                                      0x20000000
 
 // Size of each transfer.
-#define MAX_PKT_LEN		                                               2048
+#define MAX_PKT_LEN		                                    OI_DMA_BD_BYTES
 
 // Sets the IRQThreshold bits in the DMA CR register.
 // This is the number of transfers per each interrupt.
@@ -42,14 +42,40 @@ static XAxiDma hAxiDma[2];
 //  successive shot.
 static uint32_t recStart[OI_RX_N_CHIPS];
 
+// Whether the FPGA writes the first half of each shot's header; if not,
+//  the DMA records after the header, all of which the firmware writes.
+static bool isFpgaHeader = false;
+
+// Header of the shot being recorded by each ADC, and what it should hold.
+static OI_SHOT_HEADER* pHeader[OI_RX_N_CHIPS];
+static uint32_t
+	shotHandle,
+	shotIndex,
+	shotBytes;
+static bool isShotPending = false;
+
+// FPGA sequence number of each ADC's previous shot, once there is one.
+static uint32_t prevSequence[OI_RX_N_CHIPS];
+static bool isSequenceKnown[OI_RX_N_CHIPS];
+
+// Shots recorded since power-up, and those flagged in their headers.
+static uint32_t
+	nShots,
+	nBadShots;
+
 //***********************  Local Function Declarations  **********************//
-static int RxSetup(uint32_t iAdc, uint32_t nSamples);
-static bool setupDma(uint32_t iAdc, uint32_t nSamples);
+static int RxSetup(uint32_t iAdc, uint32_t nBytes);
+static bool setupDma(uint32_t iAdc, uint32_t nBytes);
 static bool startDma(uint32_t iAdc);
+static void finishShot(void);
+static uint32_t reclaimBds(uint32_t iAdc);
 
 //****************************  Global Functions  ****************************//
 void oiAdcDmaInit(void)
 {
+	isFpgaHeader = (XGpioPs_Read(&hGpio, EMIO_GPIO_BANK)
+			>> EMIO_GPIO_PIN_SHOT_HEADER & 1u) != 0u;
+	
 	oiAdcDmaRestartRecording();
 }
 
@@ -60,14 +86,22 @@ void oiAdcDmaRestartRecording(void)
 	}
 }
 
+// Polled from the main loop:  once both DMAs are idle, finishes the shot's
+//  headers and tells the shot manager.
 void oiAdcDmaVisit(void)
 {
-	// TODO
 	if (oiSmGetState() == STATE_RECORD) {
-		// Is DMA 0 done?
-		if (XAxiDma_Busy(&hAxiDma[0], XAXIDMA_DEVICE_TO_DMA)) {
+		// Are both DMAs done?  Both headers are checked at once.
+		if (XAxiDma_Busy(&hAxiDma[0], XAXIDMA_DEVICE_TO_DMA)
+				|| XAxiDma_Busy(&hAxiDma[1], XAXIDMA_DEVICE_TO_DMA)) {
 			// Wait
 		} else {
+			if (isShotPending) {
+				finishShot();
+			} else {
+				// Already done; waiting for the state to change.
+			}
+			
 			// Signal recording for this shot is done.
 			oiSmSetEvent(EVENT_SHOT_DONE);
 
@@ -81,14 +115,96 @@ void oiAdcDmaVisit(void)
 	}
 }
 
-void oiAdcDmaSetup(uint32_t nSamples)
+// Prepares each DMA to record one shot of nBytes of samples (see
+//  OI_RX_SHOT_BYTES), after its header; false, recording nothing, if the
+//  FSBL failed to initialize the ECC of where it would go.
+bool oiAdcDmaSetup(uint32_t nBytes)
 {
+	bool isUsable = true;
+	
+	// The buffers' ECC, which the FSBL may still be at:
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		isUsable = oiBootWaitScrubbed(recStart[iAdc],
+				OI_SHOT_HEADER_BYTES + nBytes) && isUsable;
+	}
+	if (!isUsable) {
+		// Counted, as a shot that recorded nothing.
+		++nShots;
+		++nBadShots;
+		return false;
+	} else {
+		// Ok.
+	}
+	
+	shotBytes = nBytes;
+	isShotPending = true;
+	
 	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {	
-		setupDma(iAdc, nSamples);
+		pHeader[iAdc] = (OI_SHOT_HEADER*)(UINTPTR) recStart[iAdc];
+		if (isFpgaHeader) {
+			// Cleared, so that a shot that never arrives is not mistaken
+			//  for whichever was recorded here before.
+			pHeader[iAdc]->magic = 0u;
+			setupDma(iAdc, OI_SHOT_HEADER_BYTES + nBytes);
+		} else {
+			// Skip the header; the samples land where they would after the
+			//  FPGA's.
+			recStart[iAdc] += OI_SHOT_HEADER_BYTES;
+			setupDma(iAdc, nBytes);
+		}
 	}
 	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {	
 		startDma(iAdc);
 	}
+	
+	return true;
+}
+
+// Whether a frame whose shots total nBytes (see OI_RX_SHOT_RECORD_BYTES)
+//  may be recorded from the start of the buffers.
+bool oiAdcDmaIsUsable(uint32_t nBytes)
+{
+	bool isUsable = true;
+	
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		isUsable = oiBootIsUsable(
+				SAMPLE_BUFFER_ADDRESS + SAMPLE_BUFFER_SPACE * iAdc, nBytes)
+				&& isUsable;
+	}
+	
+	return isUsable;
+}
+
+// Whether both DMAs have finished their transfers.
+bool oiAdcDmaIsDone(void)
+{
+	return !XAxiDma_Busy(&hAxiDma[0], XAXIDMA_DEVICE_TO_DMA)
+			&& !XAxiDma_Busy(&hAxiDma[1], XAXIDMA_DEVICE_TO_DMA);
+}
+
+// Ends a shot that the firmware recorded for itself (see oiAdcCal.c),
+//  which oiAdcDmaVisit never sees:  takes back its buffer descriptors, and
+//  leaves it out of the shot counts and sequence checks.
+void oiAdcDmaDiscardShot(void)
+{
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		reclaimBds(iAdc);
+		isSequenceKnown[iAdc] = false;
+	}
+	isShotPending = false;
+}
+
+// Sets what the firmware's half of the next shot's headers will say.
+void oiAdcDmaLabelShot(uint32_t handle, uint32_t iShot)
+{
+	shotHandle = handle;
+	shotIndex = iShot;
+}
+
+void oiAdcDmaGetShotCounts(uint32_t* pnShots, uint32_t* pnBadShots)
+{
+	*pnShots = nShots;
+	*pnBadShots = nBadShots;
 }
 
 const uint8_t* oiAdcDmaGetFrameData(const OI_FRAME_DATA_REQ* pReq)
@@ -101,7 +217,7 @@ const uint8_t* oiAdcDmaGetFrameData(const OI_FRAME_DATA_REQ* pReq)
 
 //***********************  Local Function Definitions  ***********************//
 
-static int RxSetup(uint32_t iAdc, uint32_t nSamples)
+static int RxSetup(uint32_t iAdc, uint32_t nBytes)
 {
 	XAxiDma_BdRing *RxRingPtr;
 	int Status;
@@ -148,7 +264,7 @@ static int RxSetup(uint32_t iAdc, uint32_t nSamples)
 	
 	// Compute the number of BD actually needed.
 	const uint32_t
-		totalBytes = nSamples * (OI_N_CHAN / OI_RX_N_CHIPS * sizeof(int16_t)), 
+		totalBytes = nBytes, 
 		neededBd = CEIL_DIV(totalBytes, MAX_PKT_LEN);
 	FreeBdCount = MIN(neededBd, FreeBdCount);
 
@@ -226,7 +342,7 @@ static int RxSetup(uint32_t iAdc, uint32_t nSamples)
 	return XST_SUCCESS;
 }
 
-static bool setupDma(uint32_t iAdc, uint32_t nSamples)
+static bool setupDma(uint32_t iAdc, uint32_t nBytes)
 {
 	bool result;
 	const int Status = XAxiDma_CfgInitialize(
@@ -237,7 +353,7 @@ static bool setupDma(uint32_t iAdc, uint32_t nSamples)
 		result = false;
 	} else {
 		// Ok
-		const int rxStatus = RxSetup(iAdc, nSamples);
+		const int rxStatus = RxSetup(iAdc, nBytes);
 		
 		if (rxStatus == XST_SUCCESS) {
 			result = true;
@@ -258,3 +374,81 @@ static bool startDma(uint32_t iAdc)
 	return XAxiDma_BdRingStart(RxRingPtr) == XST_SUCCESS ? true : false;
 }
 
+// Checks the FPGA's half of each ADC's header, and fills in the rest; or
+//  writes all of it, if the FPGA does not.  The cores that see these
+//  buffers do not cache them (see oiCore.c).
+static void finishShot(void)
+{
+	bool isBad = false;
+	
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		OI_SHOT_HEADER* const pHdr = pHeader[iAdc];
+		const uint32_t 
+			headerBytes = isFpgaHeader ? OI_SHOT_HEADER_BYTES : 0u,
+			nBytes = reclaimBds(iAdc);
+		uint32_t flags = 0u;
+		
+		if (!isFpgaHeader) {
+			pHdr->magic = OI_SHOT_MAGIC;
+			pHdr->sequence = nShots;
+			pHdr->timestampLo = 0u;
+			pHdr->timestampHi = 0u;
+		} else if (pHdr->magic != OI_SHOT_MAGIC) {
+			// Nothing arrived; the data are stale.
+			flags |= OI_SHOT_FLAG_MAGIC;
+			isSequenceKnown[iAdc] = false;
+		} else {
+			if (isSequenceKnown[iAdc] 
+					&& pHdr->sequence != prevSequence[iAdc] + 1u) {
+				flags |= OI_SHOT_FLAG_SEQUENCE;
+			} else {
+				// In sequence, or the first since power-up.
+			}
+			prevSequence[iAdc] = pHdr->sequence;
+			isSequenceKnown[iAdc] = true;
+		}
+		
+		if (nBytes != headerBytes + shotBytes) {
+			flags |= OI_SHOT_FLAG_LENGTH;
+		} else {
+			// Ok.
+		}
+		
+		pHdr->handle = shotHandle;
+		pHdr->iShot = shotIndex;
+		pHdr->nBytes = nBytes > headerBytes ? nBytes - headerBytes : 0u;
+		pHdr->flags = flags;
+		
+		isBad = isBad || flags != 0u;
+	}
+	
+	++nShots;
+	nBadShots += isBad ? 1u : 0u;
+	isShotPending = false;
+}
+
+// Takes back the completed buffer descriptors of an ADC's DMA; returns the
+//  number of bytes that they received.
+static uint32_t reclaimBds(uint32_t iAdc)
+{
+	XAxiDma_BdRing * const RxRingPtr = XAxiDma_GetRxRing(&hAxiDma[iAdc]);
+	XAxiDma_Bd *BdPtr;
+	uint32_t nBytes = 0u;
+	
+	const int nBds = XAxiDma_BdRingFromHw(RxRingPtr, XAXIDMA_ALL_BDS, &BdPtr);
+	
+	XAxiDma_Bd *BdCurPtr = BdPtr;
+	for (int i = 0; i < nBds; ++i) {
+		nBytes += XAxiDma_BdGetActualLength(BdCurPtr, 
+				RxRingPtr->MaxTransferLen);
+		BdCurPtr = (XAxiDma_Bd *)XAxiDma_BdRingNext(RxRingPtr, BdCurPtr);
+	}
+	
+	if (nBds > 0) {
+		XAxiDma_BdRingFree(RxRingPtr, nBds, BdPtr);
+	} else {
+		// Nothing completed.
+	}
+	
+	return nBytes;
+}
@@ -0,0 +1,225 @@
+/*
+	oiBeamform.c
+
+	Delay-and-sum receive beamforming of one shot into one A-line:
+	computation of the receive delays from the array geometry, and the
+	interpolated, apodized summation over the channels.  Portable; also
+	built into the host software.  Uses NEON where available, with a
+	scalar version that gives identical results.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+#include <stddef.h>
+
+#if defined(__ARM_NEON)
+#	include <arm_neon.h>
+#endif
+
+//********************************  Constants  *******************************//
+// Channels recorded by each ADC, interleaved in each sample (one AXI beat).
+#define N_LANES                                (OI_N_CHAN / OI_RX_N_CHIPS)
+
+#define NM_PER_UM                                                     1000u
+#define NM_PER_M                                               1000000000.0
+
+// Delays are in samples, with this many fractional bits.
+#define DELAY_FRAC_BITS                                                   8
+#define DELAY_ONE                                   (1u << DELAY_FRAC_BITS)
+
+// Marks a delay that falls before the start of the recording.
+#define DELAY_NONE                                               UINT32_MAX
+
+// Deepest point that may be beamformed; this bounds the arithmetic.
+#define MAX_DEPTH_UM                                               1000000u
+
+//***********************  Local Function Declarations  **********************//
+static uint64_t sqrtNear(uint64_t x, uint64_t guess);
+static void gather(
+		int16_t* pS0,
+		int16_t* pS1,
+		int16_t* pFrac,
+		const int16_t* pRf,
+		uint32_t nSamples,
+		const uint32_t* pDelays
+);
+
+//****************************  Global Functions  ****************************//
+
+oi_error_t oiBfValidate(const OI_BF_CONFIG* pCfg)
+{
+	oi_error_t result = OI_ERR_NONE;
+
+	if (!pCfg->enable) {
+		// Anything goes; it won't be used.
+	} else if (pCfg->pitchNm == 0u
+			|| pCfg->speedOfSound == 0u
+			|| pCfg->sampleRateHz == 0u
+			|| pCfg->nDepth == 0u
+			|| pCfg->nDepth > OI_BF_MAX_N_DEPTH
+			|| pCfg->depthStartUm > MAX_DEPTH_UM
+			|| (uint64_t) pCfg->nDepth * pCfg->depthStepUm
+					> MAX_DEPTH_UM - pCfg->depthStartUm) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		for (uint32_t iShot = 0u; iShot < OI_MAX_N_SHOTS; ++iShot) {
+			const int32_t x = pCfg->lineXUm[iShot];
+			if (x > (int32_t) MAX_DEPTH_UM || x < -(int32_t) MAX_DEPTH_UM) {
+				result = OI_ERR_INVALID_PARAMETER;
+			} else {
+				// Ok.
+			}
+		}
+	}
+
+	return result;
+}
+
+// Computes the receive delays of shot iShot:  pDelays[d*OI_N_CHAN + c] is
+//  the delay of channel c at depth d, in samples with DELAY_FRAC_BITS
+//  fractional bits.  The transmit is taken to travel straight down the
+//  line, so the delay is that of the path from the face of the array to
+//  the point, and back to the element, less the configured offset.
+void oiBfDelays(uint32_t* pDelays, const OI_BF_CONFIG* pCfg, uint32_t iShot)
+{
+	// Doubled nanometres of path to delay units:
+	const double scale = (double) pCfg->sampleRateHz * DELAY_ONE
+			/ (2.0 * NM_PER_M * pCfg->speedOfSound);
+	const int64_t lineX2 = (int64_t) pCfg->lineXUm[iShot] * NM_PER_UM * 2;
+
+	// Positions are doubled, so that the centre of the array is integral;
+	//  as oiTxPlanFocus.
+	int64_t dx2[OI_N_CHAN];
+	// Distance to each element at the previous depth:
+	uint64_t r2[OI_N_CHAN];
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		dx2[iChan] = ((int64_t) iChan * 2 - (OI_N_CHAN - 1u)) * pCfg->pitchNm
+				- lineX2;
+		r2[iChan] = 0u;
+	}
+
+	for (uint32_t iDepth = 0u; iDepth < pCfg->nDepth; ++iDepth) {
+		const int64_t z2 = ((int64_t) pCfg->depthStartUm
+				+ (int64_t) iDepth * pCfg->depthStepUm) * NM_PER_UM * 2;
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			const uint64_t x = 
+					(uint64_t) (dx2[iChan] * dx2[iChan]) + (uint64_t) (z2 * z2);
+			
+			// The distance changes little from one depth to the next.
+			r2[iChan] = iDepth == 0u ? oiIsqrt(x) : sqrtNear(x, r2[iChan]);
+
+			const double delay 
+				= (double) ((uint64_t) z2 + r2[iChan]) * scale - pCfg->offsetQ8;
+
+			pDelays[iDepth * OI_N_CHAN + iChan] = delay < 0.0
+					? DELAY_NONE
+					: (uint32_t) (delay + 0.5);
+		}
+	}
+}
+
+// Beamforms one line of pCfg->nDepth points from the recordings of both
+//  ADCs.  Channel c is lane c % N_LANES of ADC c / N_LANES.  Samples are
+//  interpolated linearly; those beyond the recording contribute nothing.
+void oiBfSum(
+		int32_t* pLine,
+		const int16_t* const* ppRf,
+		uint32_t nSamples,
+		const uint32_t* pDelays,
+		const OI_BF_CONFIG* pCfg
+) {
+	for (uint32_t iDepth = 0u; iDepth < pCfg->nDepth; ++iDepth) {
+		int64_t sum = 0;
+
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			const int16_t* const pApod = &pCfg->apodization[iAdc * N_LANES];
+			int16_t s0[N_LANES], s1[N_LANES], frac[N_LANES];
+
+			// There is no gather in NEON; the lanes are loaded one at a time.
+			gather(s0, s1, frac, ppRf[iAdc], nSamples,
+					&pDelays[iDepth * OI_N_CHAN + iAdc * N_LANES]);
+
+#if defined(__ARM_NEON)
+			const int16x8_t
+				v0 = vld1q_s16(s0),
+				v1 = vld1q_s16(s1),
+				vf = vld1q_s16(frac),
+				va = vld1q_s16(pApod);
+
+			// s0 + (s1 - s0) * frac, rounded back to a sample:
+			const int32x4_t
+				lo = vrshrq_n_s32(vmlaq_s32(
+						vshll_n_s16(vget_low_s16(v0), DELAY_FRAC_BITS),
+						vsubl_s16(vget_low_s16(v1), vget_low_s16(v0)),
+						vmovl_s16(vget_low_s16(vf))), DELAY_FRAC_BITS),
+				hi = vrshrq_n_s32(vmlaq_s32(
+						vshll_high_n_s16(v0, DELAY_FRAC_BITS),
+						vsubl_high_s16(v1, v0),
+						vmovl_high_s16(vf)), DELAY_FRAC_BITS);
+
+			sum += vaddlvq_s32(vmulq_s32(lo, vmovl_s16(vget_low_s16(va))))
+					+ vaddlvq_s32(vmulq_s32(hi, vmovl_high_s16(va)));
+#else
+			for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+				const int32_t
+					interp = ((int32_t) s0[iLane] << DELAY_FRAC_BITS)
+							+ ((int32_t) s1[iLane] - s0[iLane]) * frac[iLane],
+					sample = (interp + (1 << (DELAY_FRAC_BITS - 1)))
+							>> DELAY_FRAC_BITS;
+
+				sum += sample * (int32_t) pApod[iLane];
+			}
+#endif
+		}
+
+		// Apodization is in Q15:
+		pLine[iDepth] = (int32_t) ((sum + (1 << 14)) >> 15);
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Integer square root, rounded down, given a close guess:  one Newton step,
+//  then correction of the last bit.
+static uint64_t sqrtNear(uint64_t x, uint64_t guess)
+{
+	uint64_t root = guess == 0u ? oiIsqrt(x) : (guess + x / guess) / 2u;
+
+	while (root * root > x) {
+		--root;
+	}
+	while ((root + 1u) * (root + 1u) <= x) {
+		++root;
+	}
+
+	return root;
+}
+
+// Loads the pair of samples about each lane's delay.
+static void gather(
+		int16_t* pS0,
+		int16_t* pS1,
+		int16_t* pFrac,
+		const int16_t* pRf,
+		uint32_t nSamples,
+		const uint32_t* pDelays
+) {
+	for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+		const uint32_t
+			delay = pDelays[iLane],
+			n = delay >> DELAY_FRAC_BITS;
+
+		if (delay == DELAY_NONE || n + 1u >= nSamples) {
+			pS0[iLane] = 0;
+			pS1[iLane] = 0;
+			pFrac[iLane] = 0;
+		} else {
+			pS0[iLane] = pRf[(size_t) n * N_LANES + iLane];
+			pS1[iLane] = pRf[(size_t) (n + 1u) * N_LANES + iLane];
+			pFrac[iLane] = (int16_t) (delay & (DELAY_ONE - 1u));
+		}
+	}
+}
@@ -0,0 +1,155 @@
+/*
+	oiBf.c
+
+	Module for the optional beamforming of recorded shots into A-lines,
+	so that only the lines need be sent to the host.  The kernels are in
+	oiBeamform.c.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image.h"
+
+#include <string.h>
+#include <xil_cache.h>
+#include <xil_printf.h>
+
+//********************************  Constants  *******************************//
+// Storage for the lines.  This lies between the buffer descriptors and the
+//  IQ data (see oiIq.c).
+#define BF_BUFFER_ADDRESS                                        0x28000000
+#define BF_BUFFER_SPACE                                          0x08000000
+
+// Channels recorded by each ADC.
+#define N_ADC_CHAN                             (OI_N_CHAN / OI_RX_N_CHIPS)
+
+// Delays of the longest line:  one for each channel at each depth.
+#define MAX_N_DELAYS                          (OI_BF_MAX_N_DEPTH * OI_N_CHAN)
+
+// Cores that beamform:  the workers (see oiCore.c), or core 0 alone.
+#if OI_SMP
+#	define N_BF_CORES                                          OI_N_WORKERS
+#	define BF_CORE()                     (oiCoreId() - OI_CORE_WORKER_0)
+#else
+#	define N_BF_CORES                                                    1u
+#	define BF_CORE()                                                     0u
+#endif
+
+//*******************************  Module Data  ******************************//
+static OI_BF_CONFIG config;
+
+// Receive delays of the shot being beamformed, by each core that does so.
+static uint32_t delays[N_BF_CORES][MAX_N_DELAYS];
+
+// Byte offsets of the next shot to process, in the raw and line buffers.
+static uint32_t
+	rawOffset,
+	bfOffset;
+
+//***********************  Local Function Declarations  **********************//
+
+//****************************  Global Functions  ****************************//
+void oiBfInit(void)
+{
+	memset(&config, 0, sizeof(config));
+	oiBfRestart();
+}
+
+oi_error_t oiBfConfigure(const void* pBytes, uint32_t nBytes)
+{
+	oi_error_t result = OI_ERR_NONE;
+	OI_BF_CONFIG cfg;
+
+	if (oiSmGetState() != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes != sizeof(cfg)) {
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy to guarantee the alignment:
+		memcpy(&cfg, pBytes, sizeof(cfg));
+		result = oiBfValidate(&cfg);
+	}
+
+	if (result != OI_ERR_NONE) {
+		// Keep the previous configuration.
+	} else if (cfg.enable && oiIqIsEnabled()) {
+		// Only one product at a time.
+		result = OI_ERR_ILLEGAL_STATE;
+	} else {
+		config = cfg;
+	}
+
+	return result;
+}
+
+bool oiBfIsEnabled(void) { return config.enable != 0u; }
+
+// Called as each frame is started.
+void oiBfRestart(void)
+{
+	rawOffset = 0u;
+	bfOffset = 0u;
+}
+
+// Plans the oldest shot that has not yet been planned:  fills in the job
+//  that will beamform it.  Shots must be planned in order.  Returns false,
+//  and loses the shot, if the line buffer is full.
+bool oiBfPlanShot(shot_job_t* pJob, uint32_t iShot, uint32_t nSamples)
+{
+	const uint32_t
+		rawBytes = nSamples * N_ADC_CHAN * sizeof(int16_t),
+		bfBytes = config.nDepth * sizeof(int32_t);
+	const bool isRoom = bfOffset + bfBytes <= BF_BUFFER_SPACE;
+
+	if (isRoom) {
+		pJob->product = PRODUCT_BF;
+		pJob->iShot = iShot;
+		pJob->nSamples = nSamples;
+		pJob->rawOffset = rawOffset + OI_SHOT_HEADER_BYTES;
+		pJob->outOffset = bfOffset;
+		pJob->cfg.bf = config;
+
+		bfOffset += bfBytes;
+	} else {
+		// Out of room; this shot is lost.
+		xil_printf("BF buffer full\r\n");
+	}
+
+	rawOffset += OI_SHOT_HEADER_BYTES + rawBytes;
+
+	return isRoom;
+}
+
+// Beamforms a planned shot; this is done on a worker (or on core 0, without
+//  OI_SMP), while later shots record.  As oiIqProcessShot, the samples are invalidated before
+//  reading and the line written back afterwards.
+void oiBfProcessShot(const shot_job_t* pJob)
+{
+	const uint32_t
+		rawBytes = pJob->nSamples * N_ADC_CHAN * sizeof(int16_t),
+		bfBytes = pJob->cfg.bf.nDepth * sizeof(int32_t);
+	uint32_t* const pDelays = delays[BF_CORE()];
+	int32_t* const pLine
+		= (int32_t*)((uint64_t) BF_BUFFER_ADDRESS + pJob->outOffset);
+	const int16_t* pRf[OI_RX_N_CHIPS];
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const OI_FRAME_DATA_REQ req = { iAdc, pJob->rawOffset, rawBytes };
+		pRf[iAdc] = (const int16_t*) oiAdcDmaGetFrameData(&req);
+		Xil_DCacheInvalidateRange((UINTPTR) pRf[iAdc], rawBytes);
+	}
+
+	oiBfDelays(pDelays, &pJob->cfg.bf, pJob->iShot);
+	oiBfSum(pLine, pRf, pJob->nSamples, pDelays, &pJob->cfg.bf);
+	Xil_DCacheFlushRange((UINTPTR) pLine, bfBytes);
+}
+
+// The lines are formed from both ADCs, so the ADC index is ignored.
+const uint8_t* oiBfGetFrameData(const OI_FRAME_DATA_REQ* pReq)
+{
+	return (uint8_t*)((uint64_t) BF_BUFFER_ADDRESS
+			+ (pReq->byteOffset & BF_BUFFER_SPACE-1u) // block illegal accesses
+	);
+}
+
+//***********************  Local Function Definitions  ***********************//
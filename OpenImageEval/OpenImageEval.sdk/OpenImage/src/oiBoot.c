@@ -0,0 +1,229 @@
+/*
+	oiBoot.c
+
+	The boot timeline:  when each stage of the boot was reached (see
+	oi_boot_stage_t), from the FSBL's handoff onward, as reported by
+	OI_CMD_GET_STATUS; and the FSBL's own profile, which it leaves in OCM
+	(see xfsbl_profile.c), as reported by OI_CMD_GET_BOOT_PROFILE.  Also the
+	time base used to overlap the slow parts of the bring-up; rather than
+	waiting in place for a device to settle, its module notes a deadline,
+	and waits only for what remains of it when the device is first needed.
+
+	The FSBL initializes the ECC of the sample buffers' DDR (from
+	SAMPLE_BUFFER_ADDRESS up) with ADMA channels that are still running at
+	handoff, and leaves a record in OCM of which, and of the range of each
+	(see XFsbl_DdrEccInit); the start of each ADC's buffer, where the
+	calibration records, it initializes before handoff.  Reading that DDR
+	before its channel is done would be an ECC error, so
+	oiBootWaitScrubbed() is called for a range before anything is recorded
+	there.  A channel that fails is latched:  its range is never used, and
+	the failure is reported by OI_CMD_GET_STATUS (OI_STATUS_FLAG_SCRUB_FAILED)
+	and in the boot profile (OI_BOOT_EVENT_SCRUB_FAILED).
+
+	Times are microseconds of the system counter, which the FSBL starts;
+	they wrap after about 71 minutes.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image.h"
+
+#include <string.h>
+#include <xil_printf.h>
+#include <xtime_l.h>
+
+//********************************  Constants  *******************************//
+// Where the FSBL leaves its profile; XFSBL_PROFILE_ADDRESS.
+#define FSBL_PROFILE_ADDRESS                                     0xFFFEA000u
+
+// Where the FSBL leaves its record of the scrub; XFSBL_ECC_SCRUB_ADDRESS.
+#define FSBL_SCRUB_ADDRESS                                       0xFFFEA400u
+#define FSBL_SCRUB_MAGIC                                   0x42524353u // SCRB
+
+// Of LPD DMA (ADMA) channel n:
+#define ADMA_CH_ISR(n)                                                      \
+		(*(volatile uint32_t*)(UINTPTR)(0xFFA80100u + 0x10000u * (n)))
+#define ADMA_CH_STATUS(n)                                                   \
+		(*(volatile uint32_t*)(UINTPTR)(0xFFA8011Cu + 0x10000u * (n)))
+#define ADMA_ISR_DMA_DONE                                            0x400u
+#define ADMA_STATUS_STATE                                              0x3u
+#define ADMA_STATE_ERR                                                 0x3u
+#define ADMA_N_CHANNELS                                                  8u
+
+//**********************************  Types  *********************************//
+// As XFsblPs_EccScrub:
+typedef struct {
+	uint32_t magic;
+	uint32_t channelMask;  // those still scrubbing at handoff
+	uint64_t 
+		start[ADMA_N_CHANNELS],  // of each channel's range
+		length[ADMA_N_CHANNELS];
+} fsbl_scrub_t;
+
+//*******************************  Module Data  ******************************//
+static uint32_t timeline[OI_N_BOOT_STAGES];
+
+static OI_BOOT_PROFILE profile;
+
+static fsbl_scrub_t scrub;
+static uint32_t 
+	scrubMask,      // channels not yet seen to finish
+	scrubFailMask;  // channels that failed
+
+//***********************  Local Function Declarations  **********************//
+static uint32_t getScrubChannels(uint64_t address, uint64_t nBytes);
+static void failScrub(uint32_t ch);
+
+//****************************  Global Functions  ****************************//
+void oiBootInit(void)
+{
+	// Copy the FSBL's profile, before anything may reuse the OCM:
+	memcpy(&profile, (const void*) FSBL_PROFILE_ADDRESS, sizeof(profile));
+	
+	if (profile.magic != OI_BOOT_PROFILE_MAGIC
+			|| profile.nEvents > OI_BOOT_PROFILE_MAX_EVENTS) {
+		// Not started by the FSBL (e.g., by the debugger).
+		memset(&profile, 0, sizeof(profile));
+	} else {
+		// The last handoff is ours.
+		for (uint32_t i = 0u; i < profile.nEvents; ++i) {
+			if (profile.events[i].event == OI_BOOT_EVENT_HANDOFF) {
+				timeline[OI_BOOT_FSBL_HANDOFF] = profile.events[i].usec;
+			} else {
+				// Earlier stage.
+			}
+		}
+	}
+	
+	// And the record of the scrub:
+	memcpy(&scrub, (const void*) FSBL_SCRUB_ADDRESS, sizeof(scrub));
+	if (scrub.magic == FSBL_SCRUB_MAGIC) {
+		scrubMask = scrub.channelMask & ((1u << ADMA_N_CHANNELS) - 1u);
+	} else {
+		// Scrubbed before handoff, or not at all.
+		scrubMask = 0u;
+	}
+}
+
+// Whether the FSBL's scrub of the sample buffers' DDR is over, whether or
+//  not every channel succeeded.
+bool oiBootIsScrubbed(void)
+{
+	for (uint32_t ch = 0u; ch < ADMA_N_CHANNELS; ++ch) {
+		if ((scrubMask & (1u << ch)) == 0u) {
+			// Done already, or not used.
+		} else if ((ADMA_CH_STATUS(ch) & ADMA_STATUS_STATE) == ADMA_STATE_ERR) {
+			failScrub(ch);
+		} else if ((ADMA_CH_ISR(ch) & ADMA_ISR_DMA_DONE) != 0u) {
+			scrubMask &= ~(1u << ch);
+		} else {
+			// Still running.
+		}
+	}
+	
+	return scrubMask == 0u;
+}
+
+// Whether any of the scrub failed; latched.
+bool oiBootIsScrubFailed(void)
+{
+	oiBootIsScrubbed();
+	
+	return scrubFailMask != 0u;
+}
+
+// Whether a range of DDR may be recorded into:  no channel that failed
+//  covers it.  It may still be scrubbing.
+bool oiBootIsUsable(uint64_t address, uint64_t nBytes)
+{
+	oiBootIsScrubbed();
+	
+	return (getScrubChannels(address, nBytes) & scrubFailMask) == 0u;
+}
+
+// Waits for only the channels that cover a range of DDR; false if any of
+//  them failed.
+bool oiBootWaitScrubbed(uint64_t address, uint64_t nBytes)
+{
+	const uint32_t channels = getScrubChannels(address, nBytes);
+	
+	while (!oiBootIsScrubbed() && (scrubMask & channels) != 0u) {
+		// Wait.
+	}
+	
+	return (scrubFailMask & channels) == 0u;
+}
+
+uint32_t oiBootUsec(void)
+{
+	XTime t;
+	XTime_GetTime(&t);
+
+	// Whole seconds apart, so that the product cannot overflow:
+	return (uint32_t) (t / COUNTS_PER_SECOND * USEC_PER_SEC
+			+ t % COUNTS_PER_SECOND * USEC_PER_SEC / COUNTS_PER_SECOND);
+}
+
+// Waits until the given time, if it has not already passed.  The clock
+//  wraps every 71 minutes, so the time must be within 35 of now.
+void oiBootWaitUntil(uint32_t usec)
+{
+	while ((int32_t) (usec - oiBootUsec()) > 0) {
+		// Wait.
+	}
+}
+
+// Records that a stage has been reached; only the first time counts.
+void oiBootMark(oi_boot_stage_t stage)
+{
+	if (timeline[stage] == 0u) {
+		timeline[stage] = oiBootUsec();
+	} else {
+		// Already reached.
+	}
+}
+
+void oiBootGetTimeline(uint32_t* pUsec)
+{
+	memcpy(pUsec, timeline, sizeof(timeline));
+}
+
+const OI_BOOT_PROFILE* oiBootGetProfile(void) { return &profile; }
+
+//***********************  Local Function Definitions  ***********************//
+
+// The channels of the scrub whose ranges overlap the given one.
+static uint32_t getScrubChannels(uint64_t address, uint64_t nBytes)
+{
+	uint32_t channels = 0u;
+	
+	for (uint32_t ch = 0u; ch < ADMA_N_CHANNELS; ++ch) {
+		if ((scrub.channelMask & (1u << ch)) != 0u
+				&& address < scrub.start[ch] + scrub.length[ch]
+				&& address + nBytes > scrub.start[ch]) {
+			channels |= 1u << ch;
+		} else {
+			// Not used, or elsewhere.
+		}
+	}
+	
+	return channels;
+}
+
+// Latches the failure of a channel, and adds it to the boot profile.
+static void failScrub(uint32_t ch)
+{
+	xil_printf("DDR scrub failed on ADMA channel %d\r\n", ch);
+	scrubMask &= ~(1u << ch);
+	scrubFailMask |= 1u << ch;
+	
+	if (profile.magic == OI_BOOT_PROFILE_MAGIC
+			&& profile.nEvents < OI_BOOT_PROFILE_MAX_EVENTS) {
+		profile.events[profile.nEvents].event = OI_BOOT_EVENT_SCRUB_FAILED;
+		profile.events[profile.nEvents].partition = (uint16_t) ch;
+		profile.events[profile.nEvents].usec = oiBootUsec();
+		++profile.nEvents;
+	} else {
+		// Not started by the FSBL, or no room; the status still says so.
+	}
+}
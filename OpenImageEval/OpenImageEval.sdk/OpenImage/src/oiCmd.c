@@ -10,10 +10,43 @@
 #include "open_image.h"
 
 #include <assert.h>
+#include <xil_cache.h>
+
+//********************************  Constants  *******************************//
+// Bytes of each row of raw data:  one sample of each of an ADC's channels.
+#define RAW_ROW_BYTES        (OI_N_CHAN / OI_RX_N_CHIPS * sizeof(int16_t))
+
+// Of the Cortex-A53's data cache.
+#define CACHE_LINE_BYTES                                                 64u
+
+#if OI_PACK_MAX_PACKED_BYTES(                                          \
+		OI_PACK_MAX_BYTES / (OI_N_CHAN / OI_RX_N_CHIPS * 2u))                \
+		> OI_MAX_REPLY_BYTES
+#	error A packed reply must always fit in OI_MAX_REPLY_BYTES.
+#endif
+
+//**********************************  Types  *********************************//
+// Reply to OI_CMD_GET_FRAME_PACKED, as written by a worker.  Whole cache
+//  lines of its own, as the worker caches it and this core does not.
+typedef struct tag_packed_reply {
+	uint32_t nBytes;
+	uint32_t data[
+		OI_PACK_MAX_PACKED_BYTES(OI_PACK_MAX_BYTES / RAW_ROW_BYTES) 
+				/ sizeof(uint32_t)
+	];
+} __attribute__((aligned(CACHE_LINE_BYTES))) packed_reply_t;
 
 //*******************************  Module Data  ******************************//
 static const char buildDate[] = __DATE__ " " __TIME__;
 
+static packed_reply_t packed;
+
+// Set while a worker packs the reply to OI_CMD_GET_FRAME_PACKED.
+static bool isPacking = false;
+
+// Aligned copy of an OI_CMD_ESTIMATE_FRAME request.
+static OI_ESTIMATE_REQ estimateReq;
+
 //***********************  Local Function Declarations  **********************//
 
 //****************************  Global Functions  ****************************//
@@ -57,19 +90,71 @@ void oiCmdHandle(void *pPacket, uint32_t nBytes)
 				memset(&status, 0, sizeof(status));
 				
 				status.state = state;
-				status.flags = 0u; //TODO
+				status.flags = (oiIqIsEnabled() ? OI_STATUS_FLAG_IQ : 0u)
+						| (oiBfIsEnabled() ? OI_STATUS_FLAG_BEAMFORM : 0u)
+						| (oiBootIsScrubFailed() 
+							? OI_STATUS_FLAG_SCRUB_FAILED : 0u);
 				memcpy(status.buildDate, buildDate, sizeof(buildDate));
+				oiAdcDmaGetShotCounts(&status.nShots, &status.nBadShots);
+				oiBootGetTimeline(status.bootUsec);
 				
 				oiServerReply(OI_RES_STATUS, &status, sizeof(status));
 			}
 			break;
 			
+			case OI_CMD_GET_BOOT_PROFILE:
+			oiServerReply(
+					OI_RES_BOOT_PROFILE, 
+					oiBootGetProfile(), 
+					sizeof(OI_BOOT_PROFILE)
+			);
+			break;
+			
+			case OI_CMD_GET_TIMING:
+			oiServerReply(
+					OI_RES_TIMING, 
+					oiShotManGetTiming(), 
+					sizeof(OI_TIMING_CAL)
+			);
+			break;
+			
+			case OI_CMD_GET_VERSION: {
+				const uint32_t version = OI_PROTOCOL_VERSION;
+				oiServerReply(OI_RES_VERSION, &version, sizeof(version));
+			}
+			break;
+			
 			case OI_CMD_QUEUE_FRAME:
 			// Pass the raw bytes to the shot manager.
-			nack = oiShotManQueueFrame(pBytes, nBytes);
+			nack = oiShotManQueueFrame(pBytes, nBytes, false);
 			ack = true;  // ACK if not NACK'd
 			break;				
 			
+			case OI_CMD_QUEUE_FRAME_FORMATTED:
+			nack = oiShotManQueueFrame(pBytes, nBytes, true);
+			ack = true;  // ACK if not NACK'd
+			break;
+			
+			case OI_CMD_QUEUE_FRAME_RLE:
+			nack = oiShotManQueueFrameRle(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+			
+			case OI_CMD_QUEUE_FRAME_FOCUSED:
+			nack = oiShotManQueueFrameFocused(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+			
+			case OI_CMD_SET_IQ:
+			nack = oiIqConfigure(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+			
+			case OI_CMD_SET_BEAMFORM:
+			nack = oiBfConfigure(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+			
 			case OI_CMD_GET_FRAME:
 			if (state != STATE_READY) {
 				nack = OI_ERR_ILLEGAL_STATE;
@@ -80,14 +165,90 @@ void oiCmdHandle(void *pPacket, uint32_t nBytes)
 				
 				// Copy the request to guarantee the alignment:
 				memcpy(&req, pBytes, sizeof(req));
-				oiServerReply(
-						OI_RES_FRAME, 
-						oiAdcDmaGetFrameData(&req),
-						req.nBytes
-				);
+				
+				// Serve the product, if any:
+				const uint8_t* pData;
+				if (oiIqIsEnabled()) {
+					pData = oiIqGetFrameData(&req);
+				} else if (oiBfIsEnabled()) {
+					pData = oiBfGetFrameData(&req);
+				} else {
+					pData = oiAdcDmaGetFrameData(&req);
+				}
+				oiServerReply(OI_RES_FRAME, pData, req.nBytes);
 			}
 			break;					
 			
+			case OI_CMD_GET_FRAME_PACKED:
+			if (state != STATE_READY) {
+				nack = OI_ERR_ILLEGAL_STATE;
+			} else if (nBytes != sizeof(OI_FRAME_DATA_REQ)) {
+				nack = OI_ERR_INCORRECT_SIZE;
+			} else {
+				OI_FRAME_DATA_REQ req;
+				
+				// Copy the request to guarantee the alignment:
+				memcpy(&req, pBytes, sizeof(req));
+				
+				if (oiIqIsEnabled() || oiBfIsEnabled()
+						|| !oiShotManIsFullWidth()) {
+					// Only raw, 16-bit data is packed.
+					nack = OI_ERR_ILLEGAL_STATE;
+				} else if (req.byteOffset % RAW_ROW_BYTES != 0u
+						|| req.nBytes % RAW_ROW_BYTES != 0u
+						|| req.nBytes > OI_PACK_MAX_BYTES) {
+					nack = OI_ERR_INVALID_PARAMETER;
+				} else {
+					// The previous packed reply may still be queued:
+					oiCoreWaitForReplies();
+					
+					// Packed by a worker, which caches the samples; the
+					//  reply is sent by oiCmdVisit.
+					shot_job_t job;
+					memset(&job, 0, sizeof(job));
+					job.product = PRODUCT_PACK;
+					job.cfg.pack = req;
+					isPacking = true;
+					oiCoreRunJob(&job);
+					oiCmdVisit();
+				}
+			}
+			break;
+			
+			case OI_CMD_ESTIMATE_FRAME:
+			// Estimated in any state; nothing is recorded.
+			if (nBytes < OI_ESTIMATE_REQ_BYTES(0u) 
+					|| nBytes > sizeof(estimateReq)) {
+				nack = OI_ERR_INCORRECT_SIZE;
+			} else {
+				memcpy(&estimateReq, pBytes, nBytes);
+				
+				if (estimateReq.nShots > OI_MAX_N_SHOTS) {
+					nack = OI_ERR_INVALID_PARAMETER;
+				} else if (nBytes 
+						!= OI_ESTIMATE_REQ_BYTES(estimateReq.nShots)) {
+					nack = OI_ERR_INCORRECT_SIZE;
+				} else {
+					OI_FRAME_ESTIMATE estimate;
+					
+					nack = oiTimingEstimate(
+							&estimate, 
+							&estimateReq, 
+							oiShotManGetTiming()
+					);
+					if (nack == OI_ERR_NONE) {
+						oiServerReply(
+								OI_RES_ESTIMATE, 
+								&estimate, 
+								sizeof(estimate)
+						);
+					} else {
+						// NACK'd.
+					}
+				}
+			}
+			break;
+			
 			default:
 			nack = OI_ERR_UNRECOGNIZED_COMMAND;
 			break;
@@ -109,5 +270,37 @@ void oiCmdHandle(void *pPacket, uint32_t nBytes)
 	}
 }
 
+// Called by the main loop of the acquisition core.  Sends the packed reply
+//  once the worker is done with it.
+void oiCmdVisit(void)
+{
+	if (isPacking && oiCoreIsIdle()) {
+		isPacking = false;
+		oiServerReply(OI_RES_FRAME_PACKED, packed.data, packed.nBytes);
+	} else {
+		// Nothing to send yet.
+	}
+}
+
+// True while a reply is pending; the next command must wait for it.
+bool oiCmdIsBusy(void) { return isPacking; }
+
+// Packs the rows of an OI_CMD_GET_FRAME_PACKED request, on a worker.  As
+//  oiIqProcessShot, the samples are invalidated before reading, and the
+//  reply written back afterwards.
+void oiCmdPackShot(const shot_job_t* pJob)
+{
+	const int16_t* const pRaw
+		= (const int16_t*) oiAdcDmaGetFrameData(&pJob->cfg.pack);
+	
+	Xil_DCacheInvalidateRange((UINTPTR) pRaw, pJob->cfg.pack.nBytes);
+	packed.nBytes = oiPackEncode(
+			packed.data, 
+			pRaw, 
+			pJob->cfg.pack.nBytes / RAW_ROW_BYTES
+	);
+	Xil_DCacheFlushRange((UINTPTR) &packed, sizeof(packed));
+}
+
 //***********************  Local Function Definitions  ***********************//
 
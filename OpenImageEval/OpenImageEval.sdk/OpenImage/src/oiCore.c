@@ -0,0 +1,462 @@
+/*
+	oiCore.c
+
+	Module that spreads the work over the four Cortex-A53 cores, within the
+	one image:  the network core (0) keeps lwIP, whose timer and Ethernet
+	interrupts are routed to it; the acquisition core (1) handles commands,
+	the state machine and the sequencing of shots, all of which are polled;
+	and the worker cores (2, 3) process the recorded shots, and pack raw
+	data for the host (see oiCmdPackShot).
+
+	The cores communicate only through single-producer, single-consumer
+	rings (see oiRing.c) in a shared region that is not cached.  The network
+	and acquisition cores run without the data cache, as before (see
+	oiInit); the workers enable it, and maintain it explicitly where they
+	touch DMA'd samples and products (see oiIqProcessShot).
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image.h"
+
+#include "oi_ring.h"
+
+#include <string.h>
+#include <xil_mmu.h>
+#include <xil_printf.h>
+
+//********************************  Constants  *******************************//
+// Shared region, between the buffer descriptors (see oiAdcDma.c) and the
+//  lines (see oiBf.c).  Whole 2 MB translation blocks, so that the region
+//  may be marked not cacheable.
+#define SHARED_ADDRESS                                           0x27C00000
+#define SHARED_SPACE                                             0x00400000
+#define MMU_BLOCK_BYTES                                          0x00200000
+
+// Buffers for packets passed from the network to the acquisition core;
+//  each holds the largest packet that oiServer.c will defragment.
+#define N_PACKETS                                                        3u
+#define PACKET_SPACE                                               0x100000
+
+// Slots of each ring; powers of two.
+#define N_REQUEST_SLOTS                                                  4u
+#define N_REPLY_SLOTS                                                   16u
+#define N_JOB_SLOTS                                                      8u
+
+// Replies up to this size are copied into the ring; larger ones (frame
+//  data) are passed by address, as they stay valid until the next frame.
+#define REPLY_INLINE_BYTES                                             256u
+
+// Time to wait for each secondary core to start.
+#define START_TIMEOUT_USEC                                           100000u
+
+/////  Registers  /////
+// Reset vector of each core.
+#define APU_RVBARADDR_L(n)                                                  \
+		(*(volatile uint32_t*)(UINTPTR)(0xFD5C0040u + 8u * (n)))
+#define APU_RVBARADDR_H(n)                                                  \
+		(*(volatile uint32_t*)(UINTPTR)(0xFD5C0044u + 8u * (n)))
+
+#define CRF_APB_RST_FPD_APU            (*(volatile uint32_t*)0xFD1A0104u)
+#define ACPU_RESET(n)                                           (1u << (n))
+#define ACPU_PWRON_RESET(n)                                 (0x400u << (n))
+
+#define PMU_GLOBAL_REQ_PWRUP_STATUS    (*(volatile uint32_t*)0xFFD80110u)
+#define PMU_GLOBAL_REQ_PWRUP_INT_EN    (*(volatile uint32_t*)0xFFD80118u)
+#define PMU_GLOBAL_REQ_PWRUP_TRIG      (*(volatile uint32_t*)0xFFD80120u)
+#define PWR_STATE_ACPU(n)                                       (1u << (n))
+
+// Data and instruction cache enables.
+#define SCTLR_C                                                  (1u << 2)
+#define SCTLR_I                                                 (1u << 12)
+
+//*********************************  Macros  *********************************//
+#define READ_SYSREG(reg, v)   __asm__ volatile("mrs %0, " #reg : "=r" (v))
+
+#define LOAD_ACQUIRE(p)                   __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v)          __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+//**********************************  Types  *********************************//
+// A packet in buffer iPacket, for the acquisition core.
+typedef struct tag_request {
+	uint32_t
+		iPacket,
+		nBytes;
+} request_t;
+
+// A reply, for the network core.
+typedef struct tag_reply {
+	uint32_t
+		cmd,
+		nData;
+	const void* pData;  // NULL if the data is inline
+	uint8_t data[REPLY_INLINE_BYTES];
+} reply_t;
+
+typedef struct tag_shared {
+	OI_RING
+		requests,
+		replies,
+		jobs[OI_N_WORKERS];
+	
+	request_t requestSlots[N_REQUEST_SLOTS];
+	reply_t replySlots[N_REPLY_SLOTS];
+	shot_job_t jobSlots[OI_N_WORKERS][N_JOB_SLOTS];
+	
+	// Written only by each worker:
+	volatile uint32_t nJobsDone[OI_N_WORKERS];
+	// Set by the network core, cleared by the acquisition core:
+	volatile uint32_t isPacketBusy[N_PACKETS];
+	// Set by each core as it starts:
+	volatile uint32_t isRunning[OI_N_CORES];
+	// Written only by the network core, as it sends each reply:
+	volatile uint32_t nRepliesSent;
+	
+	uint8_t packets[N_PACKETS][PACKET_SPACE] __attribute__((aligned(64)));
+} shared_t;
+
+_Static_assert(sizeof(shared_t) <= SHARED_SPACE, "shared region too small");
+
+//*******************************  Global Data  ******************************//
+// Read by oiCoreEntry.S:  the stacks of the secondary cores, and the system
+//  registers that give them the same translation as core 0.
+uint8_t oiCoreStacks[OI_N_CORES - 1u][OI_CORE_STACK_BYTES] 
+	__attribute__((aligned(16)));
+uint64_t 
+	oiCoreMair,
+	oiCoreTcr,
+	oiCoreTtbr0,
+	oiCoreSctlr[OI_N_CORES];
+
+//*******************************  Module Data  ******************************//
+static shared_t* const pShared = (shared_t*) SHARED_ADDRESS;
+
+// Jobs sent to each worker, by the acquisition core.
+static uint32_t nJobsSent[OI_N_WORKERS];
+static uint32_t iNextWorker = 0u;
+
+// Replies queued by the acquisition core.
+static uint32_t nRepliesQueued = 0u;
+
+//***********************  Local Function Declarations  **********************//
+extern void oiCoreEntry(void);
+void oiCoreMain(void);
+
+static void startCore(uint32_t iCore);
+static void runAcquisition(void);
+static void runWorker(uint32_t iWorker);
+static void processJob(const shot_job_t* pJob);
+
+//****************************  Global Functions  ****************************//
+
+// Called by core 0 at the end of initialization, with the data cache
+//  disabled.  Starts the other cores, which take over their modules.
+void oiCoreStart(void)
+{
+#if OI_SMP
+	for (uint32_t offset = 0u; offset < SHARED_SPACE; 
+			offset += MMU_BLOCK_BYTES) {
+		Xil_SetTlbAttributes(SHARED_ADDRESS + offset, NORM_NONCACHE);
+	}
+	
+	oiRingInit(&pShared->requests, pShared->requestSlots, 
+			N_REQUEST_SLOTS, sizeof(request_t));
+	oiRingInit(&pShared->replies, pShared->replySlots, 
+			N_REPLY_SLOTS, sizeof(reply_t));
+	for (uint32_t iW = 0u; iW < OI_N_WORKERS; ++iW) {
+		oiRingInit(&pShared->jobs[iW], pShared->jobSlots[iW], 
+				N_JOB_SLOTS, sizeof(shot_job_t));
+		pShared->nJobsDone[iW] = 0u;
+		nJobsSent[iW] = 0u;
+	}
+	memset((void*) pShared->isPacketBusy, 0, sizeof(pShared->isPacketBusy));
+	memset((void*) pShared->isRunning, 0, sizeof(pShared->isRunning));
+	pShared->isRunning[OI_CORE_NETWORK] = 1u;
+	pShared->nRepliesSent = 0u;
+	
+	// The secondaries share core 0's translation tables.  Acquisition runs
+	//  without the data cache, as core 0; the workers cache.
+	uint64_t sctlr;
+	READ_SYSREG(mair_el3, oiCoreMair);
+	READ_SYSREG(tcr_el3, oiCoreTcr);
+	READ_SYSREG(ttbr0_el3, oiCoreTtbr0);
+	READ_SYSREG(sctlr_el3, sctlr);
+	for (uint32_t iCore = 0u; iCore < OI_N_CORES; ++iCore) {
+		oiCoreSctlr[iCore] = iCore >= OI_CORE_WORKER_0 
+				? sctlr | SCTLR_C | SCTLR_I
+				: sctlr;
+	}
+	__asm__ volatile("dsb sy" ::: "memory");
+	
+	for (uint32_t iCore = 1u; iCore < OI_N_CORES; ++iCore) {
+		startCore(iCore);
+	}
+#else
+	// Everything runs on core 0.
+#endif
+}
+
+// Called by the main loop of the network core.  Sends the replies of the
+//  acquisition core, in order, as the send buffer has room for them.
+void oiCoreVisit(void)
+{
+#if OI_SMP
+	static reply_t reply;
+	static bool isHeld = false;  // popped, but not yet sent
+	
+	bool isSending = true;
+	
+	while (isSending) {
+		isHeld = isHeld || oiRingPop(&pShared->replies, &reply);
+		isSending = isHeld && oiServerCanReply(reply.nData);
+		
+		if (isSending) {
+			oiServerReply(
+					(uint8_t) reply.cmd,
+					reply.pData ? reply.pData : reply.data,
+					reply.nData
+			);
+			isHeld = false;
+			STORE_RELEASE(&pShared->nRepliesSent, pShared->nRepliesSent + 1u);
+		} else {
+			// Nothing to send, or no room for it yet.
+		}
+	}
+#else
+	// Nothing is queued.
+#endif
+}
+
+uint32_t oiCoreId(void)
+{
+	uint64_t mpidr;
+	
+	READ_SYSREG(mpidr_el1, mpidr);
+	
+	return (uint32_t) (mpidr & 0xFFu);
+}
+
+// True if a packet may be passed on now.  If not, the network core should
+//  refuse it, so that lwIP delivers it again later.
+bool oiCoreIsReadyForPacket(void)
+{
+	bool result = true;
+	
+#if OI_SMP
+	result = false;
+	for (uint32_t iP = 0u; iP < N_PACKETS; ++iP) {
+		result = result || !LOAD_ACQUIRE(&pShared->isPacketBusy[iP]);
+	}
+#endif
+	
+	return result;
+}
+
+// Passes a complete packet from the network core to the command module.
+//  The packet is copied, so the caller may free it on return.  Every packet
+//  is passed on, to be answered:  if the caller did not check
+//  oiCoreIsReadyForPacket, this waits for a buffer, which the acquisition
+//  core frees as it handles each.
+void oiCoreHandlePacket(const void* pPacket, uint32_t nBytes)
+{
+#if OI_SMP
+	uint32_t iP = 0u;
+	while (LOAD_ACQUIRE(&pShared->isPacketBusy[iP])) {
+		iP = (iP + 1u) % N_PACKETS;
+	}
+	
+	const request_t req = { iP, nBytes };
+	if (nBytes <= PACKET_SPACE) {
+		memcpy(pShared->packets[iP], pPacket, nBytes);
+	} else {
+		// Too large to copy whole.  Its header is enough for the command
+		//  module to refuse it, by its length, as a bad packet.
+		memcpy(pShared->packets[iP], pPacket, PACKET_SPACE);
+	}
+	pShared->isPacketBusy[iP] = 1u;
+	// There are more slots than packets, so this cannot fail:
+	oiRingPush(&pShared->requests, &req, sizeof(req));
+#else
+	oiCmdHandle((void*) pPacket, nBytes);
+#endif
+}
+
+// Queues a reply from the acquisition core, for the network core to send.
+void oiCoreQueueReply(uint8_t cmd, const void* pData, uint32_t nData)
+{
+	static reply_t reply;
+	
+	reply.cmd = cmd;
+	reply.nData = nData;
+	if (nData <= REPLY_INLINE_BYTES) {
+		reply.pData = NULL;
+		memcpy(reply.data, pData, nData);
+	} else {
+		reply.pData = pData;
+	}
+	
+	// The network core drains the replies constantly:
+	while (!oiRingPush(&pShared->replies, &reply, sizeof(reply))) {
+		// Wait.
+	}
+	++nRepliesQueued;
+}
+
+// Waits until every queued reply has been sent, so that the data of one
+//  passed by address may be overwritten.
+void oiCoreWaitForReplies(void)
+{
+#if OI_SMP
+	while (LOAD_ACQUIRE(&pShared->nRepliesSent) != nRepliesQueued) {
+		// Wait.
+	}
+#else
+	// Replies are sent at once.
+#endif
+}
+
+// Processes a planned shot:  on the next worker with room, or at once if
+//  there are no workers.
+void oiCoreRunJob(const shot_job_t* pJob)
+{
+#if OI_SMP
+	bool isSent = false;
+	
+	while (!isSent) {
+		isSent = oiRingPush(
+				&pShared->jobs[iNextWorker], 
+				pJob, 
+				sizeof(*pJob)
+		);
+		if (isSent) {
+			++nJobsSent[iNextWorker];
+		} else {
+			// Full; try the other.
+		}
+		iNextWorker = (iNextWorker + 1u) % OI_N_WORKERS;
+	}
+#else
+	processJob(pJob);
+#endif
+}
+
+// True once every job has been processed.
+bool oiCoreIsIdle(void)
+{
+	bool result = true;
+	
+#if OI_SMP
+	for (uint32_t iW = 0u; iW < OI_N_WORKERS; ++iW) {
+		result = result 
+				&& LOAD_ACQUIRE(&pShared->nJobsDone[iW]) == nJobsSent[iW];
+	}
+#endif
+	
+	return result;
+}
+
+// Entered from oiCoreEntry.S on each secondary core, with its stack, MMU and
+//  caches set up.  Does not return.
+void oiCoreMain(void)
+{
+	const uint32_t iCore = oiCoreId();
+	
+	STORE_RELEASE(&pShared->isRunning[iCore], 1u);
+	
+	if (iCore == OI_CORE_ACQUISITION) {
+		runAcquisition();
+	} else {
+		runWorker(iCore - OI_CORE_WORKER_0);
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Powers up a secondary core, and releases it from reset at oiCoreEntry.
+//  The sequence is that of the FSBL's handoff.
+static void startCore(uint32_t iCore)
+{
+	const uint64_t entry = (uint64_t) (UINTPTR) &oiCoreEntry;
+	
+	APU_RVBARADDR_L(iCore) = (uint32_t) entry;
+	APU_RVBARADDR_H(iCore) = (uint32_t) (entry >> 32);
+	
+	// Request power-up; the L2 and floating point units are already on,
+	//  for core 0.
+	PMU_GLOBAL_REQ_PWRUP_INT_EN = PWR_STATE_ACPU(iCore);
+	PMU_GLOBAL_REQ_PWRUP_TRIG = PWR_STATE_ACPU(iCore);
+	while (PMU_GLOBAL_REQ_PWRUP_STATUS & PWR_STATE_ACPU(iCore)) {
+		// Wait.
+	}
+	
+	// The APU clock is shared with core 0, so it is already running.
+	CRF_APB_RST_FPD_APU &= ~(ACPU_RESET(iCore) | ACPU_PWRON_RESET(iCore));
+	
+	uint32_t nWaits = 0u;
+	while (!LOAD_ACQUIRE(&pShared->isRunning[iCore]) 
+			&& nWaits < START_TIMEOUT_USEC) {
+		WAIT_USEC(1u);
+		++nWaits;
+	}
+	
+	if (nWaits < START_TIMEOUT_USEC) {
+		xil_printf("core %d started\r\n", iCore);
+	} else {
+		xil_printf("core %d failed to start\r\n", iCore);
+	}
+}
+
+// Main loop of the acquisition core:  the modules that were polled in the
+//  main loop, besides the network.
+static void runAcquisition(void)
+{
+	static request_t req;
+	
+	for (;;) {
+		// While a reply is being prepared by a worker, the next command
+		//  waits, so that the replies stay in order.
+		if (!oiCmdIsBusy() && oiRingPop(&pShared->requests, &req)) {
+			oiCmdHandle(pShared->packets[req.iPacket], req.nBytes);
+			STORE_RELEASE(&pShared->isPacketBusy[req.iPacket], 0u);
+		} else {
+			// No command.
+		}
+		
+		oiAdcVisit();
+		oiAdcDmaVisit();
+		oiPulserVisit();
+		oiShotManVisit();
+		oiSmVisit();
+		oiCmdVisit();
+	}
+}
+
+static void runWorker(uint32_t iWorker)
+{
+	shot_job_t job;
+	
+	for (;;) {
+		if (oiRingPop(&pShared->jobs[iWorker], &job)) {
+			processJob(&job);
+			STORE_RELEASE(
+					&pShared->nJobsDone[iWorker], 
+					pShared->nJobsDone[iWorker] + 1u
+			);
+		} else {
+			// Idle.
+		}
+	}
+}
+
+static void processJob(const shot_job_t* pJob)
+{
+	if (pJob->product == PRODUCT_IQ) {
+		oiIqProcessShot(pJob);
+	} else if (pJob->product == PRODUCT_BF) {
+		oiBfProcessShot(pJob);
+	} else if (pJob->product == PRODUCT_PACK) {
+		oiCmdPackShot(pJob);
+	} else {
+		// Nothing to do.
+	}
+}
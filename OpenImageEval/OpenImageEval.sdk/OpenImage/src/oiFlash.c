@@ -0,0 +1,199 @@
+/*
+	oiFlash.c
+
+	Module for the storage of small per-board records (such as the ADC
+	link calibration) in the QSPI flash, alongside the boot image.  Only
+	the lower flash is used, in single-bit SPI mode, with 4-byte
+	addresses; this is slow but is only done at boot.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image.h"
+
+#include <minmax.h>
+#include <string.h>
+#include <xqspipsu.h>
+
+//********************************  Constants  *******************************//
+// Commands common to the Micron MT25Q and similar parts:
+#define CMD_WRITE_ENABLE                                               0x06u
+#define CMD_READ_STATUS                                                0x05u
+#define CMD_READ_4B                                                    0x13u
+#define CMD_PAGE_PROGRAM_4B                                            0x12u
+#define CMD_SECTOR_ERASE_4B                                            0xDCu
+
+#define STATUS_BUSY                                                    0x01u
+
+#define PAGE_BYTES                                                      256u
+
+// Polls of the status register before giving up on a program or erase;
+//  a sector erase takes up to about a second.
+#define MAX_BUSY_POLLS                                              2000000u
+
+//*******************************  Module Data  ******************************//
+static XQspiPsu hQspi;
+static bool isReady = false;
+
+//***********************  Local Function Declarations  **********************//
+static bool command(uint8_t cmd, uint32_t address, bool hasAddress);
+static bool transfer(
+		uint8_t cmd,
+		uint32_t address,
+		const uint8_t* pTx,
+		uint8_t* pRx,
+		uint32_t nBytes
+);
+static bool waitReady(void);
+
+//****************************  Global Functions  ****************************//
+void oiFlashInit(void)
+{
+	XQspiPsu_Config* const pCfg
+		= XQspiPsu_LookupConfig(XPAR_XQSPIPSU_0_DEVICE_ID);
+
+	if (pCfg == NULL
+			|| XQspiPsu_CfgInitialize(&hQspi, pCfg, pCfg->BaseAddress)
+					!= XST_SUCCESS
+			|| XQspiPsu_SetOptions(&hQspi, XQSPIPSU_MANUAL_START_OPTION)
+					!= XST_SUCCESS
+			|| XQspiPsu_SetClkPrescaler(&hQspi, XQSPIPSU_CLK_PRESCALE_8)
+					!= XST_SUCCESS) {
+		isReady = false;
+	} else {
+		XQspiPsu_SelectFlash(
+				&hQspi,
+				XQSPIPSU_SELECT_FLASH_CS_LOWER,
+				XQSPIPSU_SELECT_FLASH_BUS_LOWER
+		);
+		isReady = true;
+	}
+}
+
+bool oiFlashRead(uint32_t offset, void* pData, uint32_t nBytes)
+{
+	return isReady && transfer(CMD_READ_4B, offset, NULL, pData, nBytes);
+}
+
+// Erases the sector at 'offset' (which must start one), and writes nBytes
+//  to it.  Returns true if the data read back correctly.
+bool oiFlashWriteSector(uint32_t offset, const void* pData, uint32_t nBytes)
+{
+	const uint8_t* const pBytes = (const uint8_t*) pData;
+	bool result = isReady
+			&& nBytes <= OI_FLASH_SECTOR_BYTES
+			&& command(CMD_WRITE_ENABLE, 0u, false)
+			&& command(CMD_SECTOR_ERASE_4B, offset, true)
+			&& waitReady();
+
+	for (uint32_t done = 0u; result && done < nBytes; done += PAGE_BYTES) {
+		const uint32_t n = MIN(PAGE_BYTES, nBytes - done);
+
+		result = command(CMD_WRITE_ENABLE, 0u, false)
+				&& transfer(
+						CMD_PAGE_PROGRAM_4B,
+						offset + done,
+						&pBytes[done],
+						NULL,
+						n
+				)
+				&& waitReady();
+	}
+
+	// Verify, a page at a time:
+	for (uint32_t done = 0u; result && done < nBytes; done += PAGE_BYTES) {
+		uint8_t page[PAGE_BYTES];
+		const uint32_t n = MIN(PAGE_BYTES, nBytes - done);
+
+		result = transfer(CMD_READ_4B, offset + done, NULL, page, n)
+				&& memcmp(page, &pBytes[done], n) == 0;
+	}
+
+	return result;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static bool command(uint8_t cmd, uint32_t address, bool hasAddress)
+{
+	uint8_t bytes[] = {
+		cmd,
+		(uint8_t) (address >> 24),
+		(uint8_t) (address >> 16),
+		(uint8_t) (address >> 8),
+		(uint8_t) address
+	};
+	XQspiPsu_Msg msg = {
+		.TxBfrPtr = bytes,
+		.RxBfrPtr = NULL,
+		.ByteCount = hasAddress ? sizeof(bytes) : 1u,
+		.BusWidth = XQSPIPSU_SELECT_MODE_SPI,
+		.Flags = XQSPIPSU_MSG_FLAG_TX
+	};
+
+	return XQspiPsu_PolledTransfer(&hQspi, &msg, 1u) == XST_SUCCESS;
+}
+
+// A command with a 4-byte address, followed by data in one direction.
+static bool transfer(
+		uint8_t cmd,
+		uint32_t address,
+		const uint8_t* pTx,
+		uint8_t* pRx,
+		uint32_t nBytes
+) {
+	uint8_t bytes[] = {
+		cmd,
+		(uint8_t) (address >> 24),
+		(uint8_t) (address >> 16),
+		(uint8_t) (address >> 8),
+		(uint8_t) address
+	};
+	XQspiPsu_Msg msgs[] = { {
+		.TxBfrPtr = bytes,
+		.RxBfrPtr = NULL,
+		.ByteCount = sizeof(bytes),
+		.BusWidth = XQSPIPSU_SELECT_MODE_SPI,
+		.Flags = XQSPIPSU_MSG_FLAG_TX
+	}, {
+		.TxBfrPtr = (uint8_t*) pTx,
+		.RxBfrPtr = pRx,
+		.ByteCount = nBytes,
+		.BusWidth = XQSPIPSU_SELECT_MODE_SPI,
+		.Flags = pRx != NULL ? XQSPIPSU_MSG_FLAG_RX : XQSPIPSU_MSG_FLAG_TX
+	} };
+
+	return XQspiPsu_PolledTransfer(&hQspi, msgs, _countof(msgs))
+			== XST_SUCCESS;
+}
+
+static bool waitReady(void)
+{
+	bool result = false;
+
+	for (uint32_t iPoll = 0u; iPoll < MAX_BUSY_POLLS && !result; ++iPoll) {
+		uint8_t cmd = CMD_READ_STATUS, status = STATUS_BUSY;
+		XQspiPsu_Msg msgs[] = { {
+			.TxBfrPtr = &cmd,
+			.RxBfrPtr = NULL,
+			.ByteCount = 1u,
+			.BusWidth = XQSPIPSU_SELECT_MODE_SPI,
+			.Flags = XQSPIPSU_MSG_FLAG_TX
+		}, {
+			.TxBfrPtr = NULL,
+			.RxBfrPtr = &status,
+			.ByteCount = 1u,
+			.BusWidth = XQSPIPSU_SELECT_MODE_SPI,
+			.Flags = XQSPIPSU_MSG_FLAG_RX
+		} };
+
+		if (XQspiPsu_PolledTransfer(&hQspi, msgs, _countof(msgs))
+				!= XST_SUCCESS) {
+			break;
+		} else {
+			result = (status & STATUS_BUSY) == 0u;
+		}
+	}
+
+	return result;
+}
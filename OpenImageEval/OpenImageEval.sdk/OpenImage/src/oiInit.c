@@ -22,25 +22,51 @@ static void initGpio(void);
 
 //****************************  Global Functions  ****************************//
 
+// The boot is ordered so that the devices that must settle (the ADCs'
+//  clocks, the pulsers' regulators) are started first, and settle while the
+//  PHY negotiates, which takes the longest; each is waited for only when it
+//  is needed, if at all.  See oiBoot.c.
 void oiInit(void)
 {
+	oiBootInit();
+	
 	// Setup timers and interrupts for the TCP/IP stack:
 	init_platform();
 	
 	// Initialize global GPIO:
 	initGpio();
+	oiBootMark(OI_BOOT_PLATFORM);
 	
-	// Initialize the software and hardware modules:
+	// Start the hardware that must settle:
 	oiAdcInit();
-	oiAdcDmaInit();
 	oiPulserInit();
-	oiServerInit();
+	
+	// Initialize the software modules:
+	oiAdcDmaInit();
+	oiIqInit();
+	oiBfInit();
 	oiShotManInit();
 	
+	// Bring up the network; this blocks for the PHY's autonegotiation.
+	oiServerInit();
+	oiBootMark(OI_BOOT_NETWORK);
+	
 	// Disable caching:
 	Xil_DCacheDisable();	
 	
+	oiAdcWaitReady();
+	oiBootMark(OI_BOOT_ADC);
+	
+	// Align the ADC links, now that the DMA sees what the CPU sees:
+	oiFlashInit();
+	oiAdcCalibrate();
+	oiBootMark(OI_BOOT_CALIBRATED);
+	
 	oiSmSetEvent(EVENT_INIT_COMPLETE);
+	oiBootMark(OI_BOOT_READY);
+	
+	// Hand the modules over to the other cores:
+	oiCoreStart();
 }
 
 //***********************  Local Function Definitions  ***********************//
@@ -49,10 +75,11 @@ static void initGpio(void)
 	const XGpioPs_Config* const
 		pCfg = XGpioPs_LookupConfig(XPAR_PSU_GPIO_0_DEVICE_ID);
 	XGpioPs_CfgInitialize(&hGpio,  pCfg, pCfg->BaseAddr);
-	// Set all pins on EMIO (Bank 3) as output:
-	XGpioPs_SetDirection(&hGpio, EMIO_GPIO_BANK, UINT32_MAX);
+	// Set all pins on EMIO (Bank 3) but the capability input as output:
+	const uint32_t outputs = ~(1u << EMIO_GPIO_PIN_SHOT_HEADER);
+	XGpioPs_SetDirection(&hGpio, EMIO_GPIO_BANK, outputs);
 	// Enable the output driver:
-	XGpioPs_SetOutputEnable(&hGpio, EMIO_GPIO_BANK, UINT32_MAX);
+	XGpioPs_SetOutputEnable(&hGpio, EMIO_GPIO_BANK, outputs);
 	
 	// Setup the LED output:
 	XGpioPs_SetDirectionPin(&hGpio, USER_LED_PIN, XGPIOPS_DIRECTION_OUTPUT);
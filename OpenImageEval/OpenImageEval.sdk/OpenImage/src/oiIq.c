@@ -0,0 +1,140 @@
+/*
+	oiIq.c
+
+	Module for the optional demodulation of recorded shots to baseband IQ,
+	which reduces the data to be sent to the host.  The kernels are in
+	oiIqDemod.c.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image.h"
+
+#include <string.h>
+#include <xil_cache.h>
+#include <xil_printf.h>
+
+//********************************  Constants  *******************************//
+// Storage for the IQ data, for each ADC.  This lies between the buffer
+//  descriptors and the raw samples (see oiAdcDma.c).
+#define IQ_BUFFER_ADDRESS                                        0x30000000
+#define IQ_BUFFER_SPACE                                          0x08000000
+
+// Channels recorded by each ADC.
+#define N_ADC_CHAN                             (OI_N_CHAN / OI_RX_N_CHIPS)
+
+//*******************************  Module Data  ******************************//
+static OI_IQ_CONFIG config;
+
+// Byte offsets of the next shot to process, in the raw and IQ buffers.
+static uint32_t
+	rawOffset,
+	iqOffset;
+
+//***********************  Local Function Declarations  **********************//
+
+//****************************  Global Functions  ****************************//
+void oiIqInit(void)
+{
+	memset(&config, 0, sizeof(config));
+	oiIqRestart();
+}
+
+oi_error_t oiIqConfigure(const void* pBytes, uint32_t nBytes)
+{
+	oi_error_t result = OI_ERR_NONE;
+	OI_IQ_CONFIG cfg;
+
+	if (oiSmGetState() != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes != sizeof(cfg)) {
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy to guarantee the alignment:
+		memcpy(&cfg, pBytes, sizeof(cfg));
+		result = oiIqValidate(&cfg);
+	}
+
+	if (result != OI_ERR_NONE) {
+		// Keep the previous configuration.
+	} else if (cfg.enable && oiBfIsEnabled()) {
+		// Only one product at a time.
+		result = OI_ERR_ILLEGAL_STATE;
+	} else {
+		config = cfg;
+	}
+
+	return result;
+}
+
+bool oiIqIsEnabled(void) { return config.enable != 0u; }
+
+// Called as each frame is started.
+void oiIqRestart(void)
+{
+	rawOffset = 0u;
+	iqOffset = 0u;
+}
+
+// Plans the oldest shot that has not yet been planned:  fills in the job
+//  that will demodulate it.  Shots must be planned in order.  Returns false,
+//  and loses the shot, if the IQ buffer is full.
+bool oiIqPlanShot(shot_job_t* pJob, uint32_t nSamples)
+{
+	const uint32_t
+		rawBytes = nSamples * N_ADC_CHAN * sizeof(int16_t),
+		iqBytes = OI_IQ_N_OUT(nSamples, config.decimation)
+				* N_ADC_CHAN * 2u * sizeof(int16_t);
+	const bool isRoom = iqOffset + iqBytes <= IQ_BUFFER_SPACE;
+
+	if (isRoom) {
+		pJob->product = PRODUCT_IQ;
+		pJob->nSamples = nSamples;
+		pJob->rawOffset = rawOffset + OI_SHOT_HEADER_BYTES;
+		pJob->outOffset = iqOffset;
+		pJob->cfg.iq = config;
+
+		iqOffset += iqBytes;
+	} else {
+		// Out of room; this shot is lost.
+		xil_printf("IQ buffer full\r\n");
+	}
+
+	rawOffset += OI_SHOT_HEADER_BYTES + rawBytes;
+
+	return isRoom;
+}
+
+// Demodulates a planned shot; this may be done on any core, and while
+//  later shots record.  A worker core caches data that neither the DMA nor
+//  the network core see (see oiCore.c), so drop any stale copy of the
+//  samples before reading them, and write the IQ back afterwards.
+void oiIqProcessShot(const shot_job_t* pJob)
+{
+	const uint32_t
+		rawBytes = pJob->nSamples * N_ADC_CHAN * sizeof(int16_t),
+		iqBytes = OI_IQ_N_OUT(pJob->nSamples, pJob->cfg.iq.decimation)
+				* N_ADC_CHAN * 2u * sizeof(int16_t);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const OI_FRAME_DATA_REQ req = { iAdc, pJob->rawOffset, rawBytes };
+		const int16_t* const pRf
+			= (const int16_t*) oiAdcDmaGetFrameData(&req);
+		int16_t* const pIq = (int16_t*)((uint64_t) IQ_BUFFER_ADDRESS
+				+ IQ_BUFFER_SPACE * iAdc + pJob->outOffset);
+
+		Xil_DCacheInvalidateRange((UINTPTR) pRf, rawBytes);
+		oiIqDemodulate(pIq, pRf, pJob->nSamples, &pJob->cfg.iq);
+		Xil_DCacheFlushRange((UINTPTR) pIq, iqBytes);
+	}
+}
+
+const uint8_t* oiIqGetFrameData(const OI_FRAME_DATA_REQ* pReq)
+{
+	return (uint8_t*)((uint64_t) IQ_BUFFER_ADDRESS
+			+ IQ_BUFFER_SPACE * (pReq->iAdc & 1u)     // block illegal
+			+ (pReq->byteOffset & IQ_BUFFER_SPACE-1u) //  accesses
+	);
+}
+
+//***********************  Local Function Definitions  ***********************//
@@ -0,0 +1,201 @@
+/*
+	oiIqDemod.c
+
+	Demodulation of received RF to baseband IQ:  mixing with a local
+	oscillator, low-pass filtering and decimation.  Portable; also built
+	into the host software.  Uses NEON where available, with a scalar
+	version that gives identical results.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+#include <stddef.h>
+
+#if defined(__ARM_NEON)
+#	include <arm_neon.h>
+#endif
+
+//********************************  Constants  *******************************//
+// Channels recorded by each ADC, interleaved in each sample (one AXI beat).
+#define N_LANES                                (OI_N_CHAN / OI_RX_N_CHIPS)
+
+// Local oscillator table; one period of cosine in Q15.
+#define LO_TABLE_BITS                                                    10u
+#define LO_TABLE_SIZE                                  (1u << LO_TABLE_BITS)
+#define LO_TABLE_MASK                                    (LO_TABLE_SIZE - 1u)
+#define Q15_ONE                                                      32767.0
+
+// Right shift of the accumulators to the output:  Q15 coefficients, and a
+//  gain of two to restore the amplitude lost to mixing.
+#define OUT_SHIFT                                                        14
+
+// Limit on the sum of the magnitudes of the taps (just under 2.0), which
+//  keeps the 32-bit accumulators from overflowing, allowing for rounding.
+#define MAX_TAP_SUM                                                  65408u
+
+#define PI                                              3.14159265358979324
+
+//*******************************  Module Data  ******************************//
+static int16_t cosTable[LO_TABLE_SIZE];
+static bool isTableBuilt = false;
+
+//***********************  Local Function Declarations  **********************//
+static void buildTable(void);
+static int16_t mulQ15(int32_t a, int32_t b);
+#if !defined(__ARM_NEON)
+static int16_t narrow(int32_t acc);
+#endif
+
+//****************************  Global Functions  ****************************//
+
+oi_error_t oiIqValidate(const OI_IQ_CONFIG* pCfg)
+{
+	oi_error_t result = OI_ERR_NONE;
+
+	if (!pCfg->enable) {
+		// Anything goes; it won't be used.
+	} else if (pCfg->decimation == 0u
+			|| pCfg->decimation > OI_IQ_MAX_DECIMATION
+			|| pCfg->nTaps == 0u
+			|| pCfg->nTaps > OI_IQ_MAX_N_TAPS) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		uint32_t sum = 0u;
+		for (uint32_t k = 0u; k < pCfg->nTaps; ++k) {
+			const int32_t tap = pCfg->taps[k];
+			sum += (uint32_t) (tap < 0 ? -tap : tap);
+		}
+
+		if (sum > MAX_TAP_SUM) {
+			result = OI_ERR_INVALID_PARAMETER;
+		} else {
+			// Ok.
+		}
+	}
+
+	return result;
+}
+
+// Demodulates one shot from one ADC.  pRf holds nSamples samples of
+//  N_LANES interleaved channels, as recorded.  pIq receives
+//  OI_IQ_N_OUT(nSamples, decimation) samples, each of which is N_LANES
+//  interleaved (I, Q) pairs.  Output m is centred on input sample
+//  m*decimation; samples outside the shot are taken as zero.
+void oiIqDemodulate(
+		int16_t* pIq,
+		const int16_t* pRf,
+		uint32_t nSamples,
+		const OI_IQ_CONFIG* pCfg
+) {
+	const uint32_t
+		nTaps = pCfg->nTaps,
+		half = (nTaps - 1u) / 2u,
+		nOut = OI_IQ_N_OUT(nSamples, pCfg->decimation);
+
+	if (!isTableBuilt) {
+		buildTable();
+	} else {
+		// Already done.
+	}
+
+	for (uint32_t m = 0u; m < nOut; ++m) {
+		// Tap k applies to sample n0 - k, where n0 is the newest sample:
+		const uint32_t
+			n0 = m * pCfg->decimation + half,
+			kLo = n0 >= nSamples ? n0 - (nSamples - 1u) : 0u,
+			kHi = n0 + 1u < nTaps ? n0 + 1u : nTaps;
+
+#if defined(__ARM_NEON)
+		int32x4_t
+			accI0 = vdupq_n_s32(0),
+			accI1 = vdupq_n_s32(0),
+			accQ0 = vdupq_n_s32(0),
+			accQ1 = vdupq_n_s32(0);
+#else
+		int32_t
+			accI[N_LANES] = { 0 },
+			accQ[N_LANES] = { 0 };
+#endif
+
+		for (uint32_t k = kLo; k < kHi; ++k) {
+			const uint32_t n = n0 - k;
+			// Mixing and filtering are combined into one coefficient each
+			//  for I and Q:  x * exp(-j*phase) = x*cos - j*x*sin.
+			const uint32_t iLo = n * pCfg->phaseInc >> (32u - LO_TABLE_BITS);
+			const int16_t
+				cI = mulQ15(pCfg->taps[k], cosTable[iLo]),
+				cQ = mulQ15(-pCfg->taps[k],
+						cosTable[(iLo - LO_TABLE_SIZE / 4u) & LO_TABLE_MASK]);
+			const int16_t* const pRow = &pRf[(size_t) n * N_LANES];
+
+#if defined(__ARM_NEON)
+			const int16x8_t x = vld1q_s16(pRow);
+			accI0 = vmlal_n_s16(accI0, vget_low_s16(x), cI);
+			accI1 = vmlal_high_n_s16(accI1, x, cI);
+			accQ0 = vmlal_n_s16(accQ0, vget_low_s16(x), cQ);
+			accQ1 = vmlal_high_n_s16(accQ1, x, cQ);
+#else
+			for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+				accI[iLane] += (int32_t) cI * pRow[iLane];
+				accQ[iLane] += (int32_t) cQ * pRow[iLane];
+			}
+#endif
+		}
+
+		int16_t* const pOut = &pIq[(size_t) m * N_LANES * 2u];
+#if defined(__ARM_NEON)
+		int16x8x2_t iq;
+		iq.val[0] = vcombine_s16(
+				vqrshrn_n_s32(accI0, OUT_SHIFT),
+				vqrshrn_n_s32(accI1, OUT_SHIFT)
+		);
+		iq.val[1] = vcombine_s16(
+				vqrshrn_n_s32(accQ0, OUT_SHIFT),
+				vqrshrn_n_s32(accQ1, OUT_SHIFT)
+		);
+		vst2q_s16(pOut, iq);
+#else
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			pOut[2u * iLane] = narrow(accI[iLane]);
+			pOut[2u * iLane + 1u] = narrow(accQ[iLane]);
+		}
+#endif
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static void buildTable(void)
+{
+	for (uint32_t i = 0u; i < LO_TABLE_SIZE; ++i) {
+		const double theta = 2.0 * PI * i / LO_TABLE_SIZE;
+		// Fold into the range of oiSine:
+		const double c = i <= LO_TABLE_SIZE / 2u
+				? oiSine(PI / 2.0 - theta)
+				: oiSine(theta - 3.0 * PI / 2.0);
+
+		cosTable[i] = (int16_t) (c * Q15_ONE + (c < 0.0 ? -0.5 : 0.5));
+	}
+
+	isTableBuilt = true;
+}
+
+// Rounded product of two Q15 values.
+static int16_t mulQ15(int32_t a, int32_t b)
+{
+	return (int16_t) ((a * b + (1 << 14)) >> 15);
+}
+
+#if !defined(__ARM_NEON)
+// Rounding, saturating narrow of an accumulator; as vqrshrn_n_s32.
+static int16_t narrow(int32_t acc)
+{
+	const int64_t out = ((int64_t) acc + (1 << (OUT_SHIFT - 1))) >> OUT_SHIFT;
+
+	return out > INT16_MAX ? INT16_MAX
+			: out < INT16_MIN ? INT16_MIN
+			: (int16_t) out;
+}
+#endif
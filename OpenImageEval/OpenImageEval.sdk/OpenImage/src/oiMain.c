@@ -22,12 +22,19 @@ int main(void)
 	oiInit();
 
 	for (;;) {
+#if OI_SMP
+		// The other modules run on the other cores; see oiCore.c.
+		oiServerVisit();
+		oiCoreVisit();
+#else
 		oiAdcVisit();
 		oiAdcDmaVisit();
 		oiPulserVisit();	
 		oiServerVisit();
 		oiShotManVisit();
 		oiSmVisit();
+		oiCmdVisit();
+#endif
 	
 		// Blocks TCP/IP from proper functioning, perhaps because it is polled.
 //		IDLE();
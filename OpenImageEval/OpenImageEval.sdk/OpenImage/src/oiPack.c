@@ -0,0 +1,265 @@
+/*
+	oiPack.c
+
+	Lossless compression of recorded samples, for OI_CMD_GET_FRAME_PACKED.
+	Each lane (channel) is predicted by a fixed polynomial of order 0, 1 or
+	2, chosen per block, and the residuals are Rice coded.  Portable; the
+	host decodes with oiPack.h.  Uses NEON for the prediction where
+	available, with a scalar version that gives identical results.
+
+	Format, as a little-endian stream of 32-bit words, filled from the
+	least significant bit.  For each block of up to OI_PACK_BLOCK_ROWS
+	rows:
+		4 bits   shift; every sample of the block is a multiple of 2^shift
+		for each lane:
+			2 bits   order of the predictor
+			5 bits   Rice parameter k
+			for each row:  the zigzagged residual u, as
+				q = u >> k ones, a zero, then the low k bits of u; or, if
+				q >= OI_PACK_ESCAPE_Q, that many ones and then u in
+				OI_PACK_ESCAPE_BITS bits.
+	Prediction is of the shifted samples, from the two before them in the
+	same lane; samples before the first of the range are taken as zero.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+#include <stddef.h>
+
+#if defined(__ARM_NEON)
+#	include <arm_neon.h>
+#endif
+
+//********************************  Constants  *******************************//
+// Channels recorded by each ADC, interleaved in each sample (one AXI beat).
+#define N_LANES                                (OI_N_CHAN / OI_RX_N_CHIPS)
+
+#define N_ORDERS                                                         3u
+#define MAX_SHIFT                                                       15u
+
+//**********************************  Types  *********************************//
+typedef struct tag_bit_writer {
+	uint64_t acc;
+	uint32_t nAcc;
+	uint32_t* pWord;
+} bit_writer_t;
+
+//***********************  Local Function Declarations  **********************//
+static uint32_t blockShift(const int16_t* pIn, uint32_t nRows);
+static void predict(
+		uint32_t pU[N_ORDERS][OI_PACK_BLOCK_ROWS][N_LANES],
+		uint32_t pSum[N_ORDERS][N_LANES],
+		const int16_t* pIn,
+		uint32_t nRows,
+		uint32_t shift,
+		int32_t* pX1,
+		int32_t* pX2
+);
+static uint32_t riceParameter(uint32_t sum, uint32_t nRows);
+static void put(bit_writer_t* pW, uint32_t value, uint32_t nBits);
+
+//****************************  Global Functions  ****************************//
+
+// Compresses nRows rows of N_LANES interleaved samples, as recorded by one
+//  ADC.  pOut must hold OI_PACK_MAX_PACKED_BYTES(nRows).  Returns the
+//  number of bytes written, a multiple of four.
+uint32_t oiPackEncode(uint32_t* pOut, const int16_t* pIn, uint32_t nRows)
+{
+	bit_writer_t w = { 0u, 0u, pOut };
+	int32_t
+		x1[N_LANES] = { 0 },  // previous sample of each lane
+		x2[N_LANES] = { 0 };  // and the one before
+
+	for (uint32_t row0 = 0u; row0 < nRows; row0 += OI_PACK_BLOCK_ROWS) {
+		const int16_t* const pBlock = &pIn[(size_t) row0 * N_LANES];
+		const uint32_t 
+			nB = nRows - row0 < OI_PACK_BLOCK_ROWS 
+					? nRows - row0 
+					: OI_PACK_BLOCK_ROWS,
+			shift = blockShift(pBlock, nB);
+		uint32_t
+			u[N_ORDERS][OI_PACK_BLOCK_ROWS][N_LANES],
+			sum[N_ORDERS][N_LANES];
+
+		predict(u, sum, pBlock, nB, shift, x1, x2);
+
+		put(&w, shift, 4u);
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			// The predictor that leaves the least:
+			uint32_t order = 0u;
+			for (uint32_t o = 1u; o < N_ORDERS; ++o) {
+				order = sum[o][iLane] < sum[order][iLane] ? o : order;
+			}
+			const uint32_t k = riceParameter(sum[order][iLane], nB);
+
+			put(&w, order | k << 2, 7u);
+			for (uint32_t r = 0u; r < nB; ++r) {
+				const uint32_t 
+					value = u[order][r][iLane],
+					q = value >> k;
+
+				if (q < OI_PACK_ESCAPE_Q) {
+					put(&w, (1u << q) - 1u, q + 1u);
+					put(&w, value & ((1u << k) - 1u), k);
+				} else {
+					put(&w, (1u << OI_PACK_ESCAPE_Q) - 1u, OI_PACK_ESCAPE_Q);
+					put(&w, value, OI_PACK_ESCAPE_BITS);
+				}
+			}
+		}
+	}
+
+	// Flush the last partial word:
+	if (w.nAcc > 0u) {
+		*w.pWord++ = (uint32_t) w.acc;
+	} else {
+		// Ends on a word.
+	}
+
+	return (uint32_t) (w.pWord - pOut) * sizeof(uint32_t);
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Number of low bits that are zero in every sample of the block, e.g.
+//  because the ADC's 14 bits are justified in a 16-bit word.
+static uint32_t blockShift(const int16_t* pIn, uint32_t nRows)
+{
+	uint32_t bits = 0u;
+
+#if defined(__ARM_NEON)
+	uint16x8_t acc = vdupq_n_u16(0u);
+	for (uint32_t r = 0u; r < nRows; ++r) {
+		acc = vorrq_u16(acc, vreinterpretq_u16_s16(
+				vld1q_s16(&pIn[(size_t) r * N_LANES])));
+	}
+	const uint16x4_t a = vorr_u16(vget_low_u16(acc), vget_high_u16(acc));
+	bits = (uint32_t) (vget_lane_u16(a, 0) | vget_lane_u16(a, 1) 
+			| vget_lane_u16(a, 2) | vget_lane_u16(a, 3));
+#else
+	for (uint32_t i = 0u; i < nRows * N_LANES; ++i) {
+		bits |= (uint16_t) pIn[i];
+	}
+#endif
+
+	// An all-zero block needs no shift.
+	const uint32_t shift = bits == 0u ? 0u : (uint32_t) __builtin_ctz(bits);
+
+	return shift < MAX_SHIFT ? shift : MAX_SHIFT;
+}
+
+// Computes the zigzagged residual of every sample of the block, for each
+//  order of predictor, and their sums for each lane.  Updates the history
+//  of each lane.
+static void predict(
+		uint32_t pU[N_ORDERS][OI_PACK_BLOCK_ROWS][N_LANES],
+		uint32_t pSum[N_ORDERS][N_LANES],
+		const int16_t* pIn,
+		uint32_t nRows,
+		uint32_t shift,
+		int32_t* pX1,
+		int32_t* pX2
+) {
+#if defined(__ARM_NEON)
+	const int32x4_t down = vdupq_n_s32(-(int32_t) shift);
+	int32x4_t
+		x1[2] = { vld1q_s32(pX1), vld1q_s32(pX1 + 4) },
+		x2[2] = { vld1q_s32(pX2), vld1q_s32(pX2 + 4) };
+	uint32x4_t sum[N_ORDERS][2];
+	for (uint32_t o = 0u; o < N_ORDERS; ++o) {
+		sum[o][0] = vdupq_n_u32(0u);
+		sum[o][1] = vdupq_n_u32(0u);
+	}
+
+	for (uint32_t r = 0u; r < nRows; ++r) {
+		const int16x8_t v = vld1q_s16(&pIn[(size_t) r * N_LANES]);
+		const int32x4_t x[2] = { vmovl_s16(vget_low_s16(v)), vmovl_high_s16(v) };
+
+		for (uint32_t h = 0u; h < 2u; ++h) {
+			const int32x4_t
+				s0 = vshlq_s32(x[h], down),
+				s1 = vshlq_s32(x1[h], down),
+				s2 = vshlq_s32(x2[h], down),
+				d1 = vsubq_s32(s0, s1),
+				res[N_ORDERS] = { 
+					s0, 
+					d1, 
+					vsubq_s32(d1, vsubq_s32(s1, s2)) 
+				};
+
+			for (uint32_t o = 0u; o < N_ORDERS; ++o) {
+				const uint32x4_t u = vreinterpretq_u32_s32(veorq_s32(
+						vshlq_n_s32(res[o], 1), vshrq_n_s32(res[o], 31)));
+				vst1q_u32(&pU[o][r][4u * h], u);
+				sum[o][h] = vaddq_u32(sum[o][h], u);
+			}
+
+			x2[h] = x1[h];
+			x1[h] = x[h];
+		}
+	}
+
+	for (uint32_t o = 0u; o < N_ORDERS; ++o) {
+		vst1q_u32(&pSum[o][0], sum[o][0]);
+		vst1q_u32(&pSum[o][4], sum[o][1]);
+	}
+	vst1q_s32(pX1, x1[0]);
+	vst1q_s32(pX1 + 4, x1[1]);
+	vst1q_s32(pX2, x2[0]);
+	vst1q_s32(pX2 + 4, x2[1]);
+#else
+	for (uint32_t o = 0u; o < N_ORDERS; ++o) {
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			pSum[o][iLane] = 0u;
+		}
+	}
+
+	for (uint32_t r = 0u; r < nRows; ++r) {
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			const int32_t
+				x = pIn[(size_t) r * N_LANES + iLane],
+				s0 = x >> shift,
+				s1 = pX1[iLane] >> shift,
+				s2 = pX2[iLane] >> shift,
+				res[N_ORDERS] = { s0, s0 - s1, s0 - 2 * s1 + s2 };
+
+			for (uint32_t o = 0u; o < N_ORDERS; ++o) {
+				const uint32_t u 
+					= (uint32_t) res[o] << 1 ^ (uint32_t) (res[o] >> 31);
+				pU[o][r][iLane] = u;
+				pSum[o][iLane] += u;
+			}
+
+			pX2[iLane] = pX1[iLane];
+			pX1[iLane] = x;
+		}
+	}
+#endif
+}
+
+// Rice parameter for residuals of the given mean.
+static uint32_t riceParameter(uint32_t sum, uint32_t nRows)
+{
+	const uint32_t 
+		mean = sum / nRows,
+		k = mean == 0u ? 0u : 31u - (uint32_t) __builtin_clz(mean);
+
+	return k < OI_PACK_MAX_K ? k : OI_PACK_MAX_K;
+}
+
+// Appends the low nBits of value.
+static void put(bit_writer_t* pW, uint32_t value, uint32_t nBits)
+{
+	pW->acc |= (uint64_t) value << pW->nAcc;
+	pW->nAcc += nBits;
+
+	if (pW->nAcc >= 32u) {
+		*pW->pWord++ = (uint32_t) pW->acc;
+		pW->acc >>= 32;
+		pW->nAcc -= 32u;
+	} else {
+		// Not yet a word.
+	}
+}
@@ -16,6 +16,9 @@
 
 #define N_CHAN_PER_CHIP                             (OI_N_CHAN / N_PULSERS)
 
+// Time for the pulsers' internal voltage regulators to stabilize.
+#define REGULATOR_SETTLE_USEC                                          1000u
+
 //*******************************  Module Data  ******************************//
 static const uint32_t baseAddr[] = {
 	XPAR_HV7321_AXI4_0_S_AXI_BASEADDR,
@@ -24,6 +27,12 @@ static const uint32_t baseAddr[] = {
 	XPAR_HV7321_AXI4_3_S_AXI_BASEADDR,
 };	
 
+// When the regulators, enabled at init, will have stabilized, and whether
+//  that has been waited for.  They stay enabled, so it is waited for only
+//  once; the boot clock wraps.
+static uint32_t regulatorUsec;
+static bool isRegulatorSettled = false;
+
 //***********************  Local Function Declarations  **********************//
 static void armPulsers(void);
 static void setAllControl(uint32_t controlBits);
@@ -39,8 +48,11 @@ void oiPulserInit(void)
 
 	WAIT_USEC(1);
 	
-	// Take them out of reset.
-	setAllControl(0u);
+	// Take them out of reset, and enable the internal voltage regulators,
+	//  so that they settle during the rest of the boot rather than when
+	//  first armed.  The outputs stay disabled.
+	setAllControl(HV7321_CONTROL_REN | HV7321_CONTROL_OUT_CLK_DISABLE);
+	regulatorUsec = oiBootUsec() + REGULATOR_SETTLE_USEC;
 }
 
 void oiPulserVisit(void)
@@ -146,8 +158,14 @@ static void armPulsers(void)
 	// Enable the pulser's internal voltage regulators:
 	setAllControl(HV7321_CONTROL_REN | HV7321_CONTROL_OUT_CLK_DISABLE);
 
-	// Wait for them to stabilize.
-	WAIT_USEC(1000);
+	// Wait for them to stabilize; they are left enabled from init, so this
+	//  has normally already passed.
+	if (!isRegulatorSettled) {
+		oiBootWaitUntil(regulatorUsec);
+		isRegulatorSettled = true;
+	} else {
+		// Long since.
+	}
 	
 	// Enable the outputs:
 	setAllControl(HV7321_CONTROL_REN | HV7321_CONTROL_OEN);
@@ -0,0 +1,78 @@
+/*
+	oiRing.c
+
+	Lock-free single-producer, single-consumer ring.  Each index is written
+	by one side only; a store-release of an index publishes the slot that
+	it covers, and the other side reads it with a load-acquire.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oi_ring.h"
+
+#include <string.h>
+
+//*********************************  Macros  *********************************//
+#define LOAD_ACQUIRE(p)                   __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v)          __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+
+//****************************  Global Functions  ****************************//
+
+void oiRingInit(OI_RING* pRing, void* pSlots, uint32_t nSlots, uint32_t slotBytes)
+{
+	pRing->head = 0u;
+	pRing->tail = 0u;
+	pRing->nSlots = nSlots;
+	pRing->slotBytes = slotBytes;
+	pRing->pSlots = (uint8_t*) pSlots;
+}
+
+// Producer.  Returns false if the ring is full, or the message too large.
+bool oiRingPush(OI_RING* pRing, const void* pMsg, uint32_t nBytes)
+{
+	const uint32_t
+		head = pRing->head,
+		tail = LOAD_ACQUIRE(&pRing->tail);
+	const bool ok = head - tail < pRing->nSlots && nBytes <= pRing->slotBytes;
+
+	if (ok) {
+		memcpy(
+				&pRing->pSlots[(head & (pRing->nSlots - 1u)) * pRing->slotBytes],
+				pMsg,
+				nBytes
+		);
+		STORE_RELEASE(&pRing->head, head + 1u);
+	} else {
+		// Full.
+	}
+
+	return ok;
+}
+
+// Consumer.  Copies out a whole slot; returns false if the ring is empty.
+bool oiRingPop(OI_RING* pRing, void* pMsg)
+{
+	const uint32_t
+		tail = pRing->tail,
+		head = LOAD_ACQUIRE(&pRing->head);
+	const bool ok = head != tail;
+
+	if (ok) {
+		memcpy(
+				pMsg,
+				&pRing->pSlots[(tail & (pRing->nSlots - 1u)) * pRing->slotBytes],
+				pRing->slotBytes
+		);
+		STORE_RELEASE(&pRing->tail, tail + 1u);
+	} else {
+		// Empty.
+	}
+
+	return ok;
+}
+
+// Number of messages waiting; exact only when called by either side.
+uint32_t oiRingCount(const OI_RING* pRing)
+{
+	return LOAD_ACQUIRE(&pRing->head) - LOAD_ACQUIRE(&pRing->tail);
+}
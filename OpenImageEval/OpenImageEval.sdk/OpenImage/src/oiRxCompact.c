@@ -0,0 +1,113 @@
+/*
+	oiRxCompact.c
+
+	Expansion of compact receive descriptions, including rendering of
+	parametric TGC curves.  Portable; also built into the host software.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+#include <string.h>
+
+//***********************  Local Function Declarations  **********************//
+static uint8_t toCode(uint32_t level);
+
+//****************************  Global Functions  ****************************//
+
+oi_error_t oiRxValidate(const OI_RX_COMPACT* pRx)
+{
+	oi_error_t result = oiRxValidateFormat(pRx->sampleFormat, pRx->nSamples);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const OI_TGC_CURVE* const pCurve = &pRx->tgc[iAdc];
+
+		if (pCurve->nSegments > OI_TGC_MAX_N_SEGMENTS) {
+			result = OI_ERR_INVALID_PARAMETER;
+		} else {
+			for (uint32_t iSeg = 0u; iSeg < pCurve->nSegments; ++iSeg) {
+				if (pCurve->segments[iSeg].duration == 0u) {
+					result = OI_ERR_INVALID_PARAMETER;
+				} else {
+					// Ok.
+				}
+			}
+		}
+	}
+
+	return result;
+}
+
+// Packed sample formats must end each shot on a whole AXI beat, and need
+//  the packer (OI_SAMPLE_PACK).
+oi_error_t oiRxValidateFormat(uint32_t sampleFormat, uint32_t nSamples)
+{
+	oi_error_t result = OI_ERR_NONE;
+
+	if (sampleFormat >= OI_N_SAMPLE_FORMATS) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else if (sampleFormat != OI_SAMPLE_FORMAT_16 && !OI_SAMPLE_PACK) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else if (sampleFormat != OI_SAMPLE_FORMAT_16
+			&& nSamples % OI_SAMPLE_FORMAT_ROWS != 0u) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		// Ok.
+	}
+
+	return result;
+}
+
+void oiRxExpand(OI_RX* pRx, const OI_RX_COMPACT* pCompact)
+{
+	memcpy(pRx->channels, pCompact->channels, sizeof(pRx->channels));
+	pRx->nSamples = pCompact->nSamples;
+	pRx->sampleFormat = pCompact->sampleFormat;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		pRx->nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		oiTgcRender(pRx->tgc[iAdc], &pCompact->tgc[iAdc]);
+
+		pRx->lpfMul[iAdc] = pCompact->lpfMul[iAdc];
+		pRx->lpfDiv[iAdc] = pCompact->lpfDiv[iAdc];
+		pRx->lna[iAdc] = pCompact->lna[iAdc];
+		pRx->pga[iAdc] = pCompact->pga[iAdc];
+		pRx->hpf_divisor[iAdc] = pCompact->hpf_divisor[iAdc];
+		pRx->testMode[iAdc] = pCompact->testMode[iAdc];
+	}
+}
+
+// Renders a validated curve into OI_RX_MAX_N_TGC DAC codes.
+void oiTgcRender(uint8_t* pLevels, const OI_TGC_CURVE* pCurve)
+{
+	uint32_t
+		iPoint = 0u,
+		start = pCurve->startLevel;
+
+	for (uint32_t iSeg = 0u; iSeg < pCurve->nSegments; ++iSeg) {
+		const OI_TGC_SEGMENT* const pSeg = &pCurve->segments[iSeg];
+		const int32_t rise = (int32_t) pSeg->endLevel - (int32_t) start;
+
+		for (uint32_t k = 0u; k < pSeg->duration && iPoint < OI_RX_MAX_N_TGC;
+				++k) {
+			pLevels[iPoint++] = toCode((uint32_t) ((int32_t) start 
+					+ rise * (int32_t) k / (int32_t) pSeg->duration));
+		}
+
+		start = pSeg->endLevel;
+	}
+
+	// Hold the final level:
+	memset(&pLevels[iPoint], toCode(start), OI_RX_MAX_N_TGC - iPoint);
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Rounds an 8.8 fixed point level to a DAC code.
+static uint8_t toCode(uint32_t level)
+{
+	const uint32_t code = (level + 0x80u) >> 8;
+
+	return code > UINT8_MAX ? UINT8_MAX : (uint8_t) code;
+}
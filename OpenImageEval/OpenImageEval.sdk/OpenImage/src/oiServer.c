@@ -36,6 +36,16 @@
 #endif
 
 
+//********************************  Constants  *******************************//
+// Every packet, each way, starts with OI_MAGIC, the command or response
+//  code, and the length of the payload (16 bits, little-endian).
+#define PACKET_HEADER_BYTES                                              4u
+
+#if TCP_SND_BUF < OI_MAX_REPLY_BYTES + PACKET_HEADER_BYTES
+#	error The largest reply must fit in the TCP send buffer.
+#endif
+
+
 //*******************************  Module Data  ******************************//
 extern volatile int TcpFastTmrFlag;
 extern volatile int TcpSlowTmrFlag;
@@ -55,6 +65,7 @@ void tcp_slowtmr(void);
 
 static void print_ip(char *msg, ip_addr_t *ip);
 static void print_ip_settings(ip_addr_t *ip, ip_addr_t *mask, ip_addr_t *gw);
+static void dispatchPackets(void);
 
 
 //****************************  Global Functions  ****************************//
@@ -124,11 +135,38 @@ void oiServerVisit(void)
 	transfer_data();
 }
 
+// Sends a reply, the one to the request being handled.  A reply too large
+//  to ever send is NACK'd instead, and one that there is no room for now
+//  (the client has not read the replies before it) is NACK'd if that fits,
+//  so that the client is not left waiting.
 void oiServerReply(uint8_t cmd, const void* pData, uint32_t nData)
 {
-	if (replyPcb) {
-		if (tcp_sndbuf(replyPcb) > nData) {
-			uint8_t hdr[] = {
+	static const uint8_t tooLarge = OI_ERR_INCORRECT_SIZE;
+	static const uint8_t busy = OI_ERR_BUSY;
+	
+	if (nData > OI_MAX_REPLY_BYTES) {
+		cmd = OI_RES_NACK;
+		pData = &tooLarge;
+		nData = sizeof(tooLarge);
+	} else {
+		// Fits.
+	}
+	
+	if (oiCoreId() != OI_CORE_NETWORK) {
+		// Only the network core may call lwIP; it sends this later.
+		oiCoreQueueReply(cmd, pData, nData);
+	} else if (replyPcb) {
+		if (tcp_sndbuf(replyPcb) < nData + PACKET_HEADER_BYTES
+				&& tcp_sndbuf(replyPcb) >= sizeof(busy) + PACKET_HEADER_BYTES) {
+			cmd = OI_RES_NACK;
+			pData = &busy;
+			nData = sizeof(busy);
+		} else {
+			// Room, or not even for that.
+		}
+		
+		if (tcp_sndbuf(replyPcb) >= nData + PACKET_HEADER_BYTES) {
+			uint8_t hdr[PACKET_HEADER_BYTES] = {
 				OI_MAGIC,
 				cmd,
 				nData & 0xFF,
@@ -136,6 +174,9 @@ void oiServerReply(uint8_t cmd, const void* pData, uint32_t nData)
 			};
 			err_t err = tcp_write(replyPcb, hdr, sizeof(hdr), 1);
 			err = tcp_write(replyPcb, pData, nData, 1);
+			// Now, rather than at the next timer; a client may be waiting
+			//  on it to send more.  (lwIP defers this within its callbacks.)
+			err = tcp_output(replyPcb);
 			UNUSED(err);
 		} else {
 			xil_printf("no space in tcp_sndbuf\r\n");
@@ -146,6 +187,20 @@ void oiServerReply(uint8_t cmd, const void* pData, uint32_t nData)
 	}
 }
 
+// Whether a reply of nData bytes may be sent now:  the send buffer has room
+//  for it, or for the NACK that replaces one too large to send.  A client
+//  may send many requests without waiting, so a reply may have to wait
+//  until the client has acknowledged the earlier ones; as it is sent whole,
+//  it always may in the end.
+bool oiServerCanReply(uint32_t nData)
+{
+	const uint32_t nSent = nData > OI_MAX_REPLY_BYTES ? 1u : nData;
+	
+	return !replyPcb
+			|| (tcp_sndbuf(replyPcb) >= nSent + PACKET_HEADER_BYTES
+				&& tcp_sndqueuelen(replyPcb) + 2u < TCP_SND_QUEUELEN);
+}
+
 //***********************  Local Function Definitions  ***********************//
 static void print_ip(char *msg, ip_addr_t *ip)
 {
@@ -164,6 +219,8 @@ static void print_ip_settings(ip_addr_t *ip, ip_addr_t *mask, ip_addr_t *gw)
 
 
 int transfer_data() {
+	// Packets that the command module could not take when they arrived:
+	dispatchPackets();
 	return 0;
 }
 
@@ -177,8 +234,11 @@ void print_app_header()
 	xil_printf("TCP packets sent to port 6001 will be echoed back\r\n");
 }
 
-static uint8_t defrag[0x100000];
-static uint32_t nDefrag;
+// Bytes received but not yet passed on; see dispatchPackets().
+static uint8_t stream[0x100000];
+static uint32_t
+	iStream,    // start of the first packet not yet passed on
+	nStream;    // end of what has been received
 
 err_t recv_callback(void *arg, struct tcp_pcb *tpcb,
                                struct pbuf *p, err_t err)
@@ -187,50 +247,37 @@ err_t recv_callback(void *arg, struct tcp_pcb *tpcb,
 	if (!p) {
 		tcp_close(tpcb);
 		tcp_recv(tpcb, NULL);
+		iStream = nStream = 0u;
 		return ERR_OK;
 	}
 	
 	replyPcb = tpcb;
-
-	/* indicate that the packet has been received */
-	tcp_recved(tpcb, p->len);
 	
-	void* toHandle;
-	uint32_t handleLen = 0u;
-	bool doDefrag = false;
-	if (p->len == echo_netif->mtu - 40) {
-		// The packet filled the MTU.  Assume that this is a fragment of
-		//  a larger packet; defrag.
-		doDefrag = true;
-	} else if (nDefrag > 0) {
-		// This will finish a fragmented packet.
-		doDefrag = true;
-		toHandle = defrag;
-		handleLen = nDefrag + p->len;
+	if (nStream + p->tot_len > sizeof(stream) && iStream > 0u) {
+		// Make room, by moving what is left to the start:
+		memmove(stream, &stream[iStream], nStream - iStream);
+		nStream -= iStream;
+		iStream = 0u;
 	} else {
-		// Smaller than the MTU.  No fragmentation.
-		doDefrag = false;
-		toHandle = p->payload;
-		handleLen = p->len;
+		// Room enough, or nothing to move.
 	}
 	
-	if (doDefrag) {
-		memcpy(&defrag[nDefrag], p->payload, p->len);
-		nDefrag += p->len;
-	} else {
-		// Not a fragment.
+	if (nStream + p->tot_len > sizeof(stream)) {
+		// The acquisition core is still busy with earlier packets.  Refuse
+		//  this data; lwIP will offer it again.
+		return ERR_MEM;
 	}
+
+	pbuf_copy_partial(p, &stream[nStream], p->tot_len, 0u);
+	nStream += p->tot_len;
 	
-	if (handleLen > 0) {
-		// Pass the packet to the command module:
-		oiCmdHandle(toHandle, handleLen);
-		nDefrag = 0u;
-	} else {
-		// Continue to defrag.
-	}
+	/* indicate that the packet has been received */
+	tcp_recved(tpcb, p->tot_len);
 
 	/* free the received pbuf */
 	pbuf_free(p);
+	
+	dispatchPackets();
 
 	return ERR_OK;
 }
@@ -290,6 +337,42 @@ int start_application()
 	return 0;
 }
 
-
-
-
+// Passes each complete packet received to the command module, in order,
+//  while it will take them.  TCP is a stream:  a client that sends several
+//  packets without waiting for the replies may have them arrive together,
+//  or split anywhere, so they are found by the length in each header.
+static void dispatchPackets(void)
+{
+	bool isReady = true;
+	
+	while (isReady && nStream - iStream >= PACKET_HEADER_BYTES) {
+		const uint8_t* const pPacket = &stream[iStream];
+		uint32_t nPacket = PACKET_HEADER_BYTES 
+				+ (pPacket[2] | (uint32_t) pPacket[3] << 8);
+		
+		if (pPacket[0] != OI_MAGIC) {
+			// Out of step with the client.  Pass on all that is left, which
+			//  is refused as a bad packet.
+			nPacket = nStream - iStream;
+		} else {
+			// A header.
+		}
+		
+		if (nStream - iStream < nPacket) {
+			// Wait for the rest.
+			isReady = false;
+		} else if (!oiCoreIsReadyForPacket()) {
+			// Offered again by transfer_data().
+			isReady = false;
+		} else {
+			oiCoreHandlePacket(pPacket, nPacket);
+			iStream += nPacket;
+		}
+	}
+	
+	if (iStream == nStream) {
+		iStream = nStream = 0u;
+	} else {
+		// Part of a packet, or packets waiting.
+	}
+}
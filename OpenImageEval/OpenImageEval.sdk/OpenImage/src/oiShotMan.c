@@ -8,18 +8,65 @@
 
 #include "open_image.h"
 
+#include <stddef.h>
+#include <xtime_l.h>
+
+//********************************  Constants  *******************************//
+#define NS_PER_SEC                                            1000000000ull
+
+// A shot of OI_CMD_QUEUE_FRAME is an OI_SHOT up to its sample format:
+_Static_assert(offsetof(OI_SHOT, rx.sampleFormat) == OI_SHOT_V1_BYTES, 
+		"OI_RX.sampleFormat must be the last of OI_SHOT");
+
+// Each measurement moves a calibrated cost this fraction of the way.
+#define TIMING_WEIGHT                                                    8
+
 //*******************************  Module Data  ******************************//
 static OI_FRAME frame;
 
+// Staging for run-length encoded frames, which are expanded into 'frame'.
+static OI_FRAME_RLE rleFrame;
+
+// Staging for focused frames, which are planned into 'rleFrame'.
+static OI_FRAME_FOCUSED focusedFrame;
+
 static uint32_t iShot;
 
+// Set once the last shot is recorded, until all of its processing is done.
+static bool isFinishing = false;
+
+// Whether every shot of the last frame started was recorded as 16 bits.
+static bool isFullWidth = true;
+
+// Costs of the shot pipeline, as measured (see oiTiming.c).
+static OI_TIMING_CAL timing;
+static XTime
+	armStart,       // when the frame was queued
+	prevStart;      // when the previous shot's setup started
+// The previous shot's setup and samples, which the rest of its period is
+//  measured beyond.
+static uint64_t prevBusyNs;
+
 //***********************  Local Function Declarations  **********************//
+static oi_error_t loadRleFrame(void);
+static oi_error_t checkCounts(uint32_t nShots, uint32_t nTemplates);
+static oi_error_t checkFormat(uint32_t sampleFormat, uint32_t nSamples);
+static oi_error_t checkBuffers(void);
+static void startFrame(void);
 static void startShot(void);
+static void processShot(uint32_t iS);
+static void timeShot(
+		const XTime* pTimes, 
+		const OI_RX* pRx, 
+		bool isTgcLoaded
+);
+static void measure(uint32_t* pNs, uint64_t ns);
+static uint64_t toNs(XTime counts);
 
 //****************************  Global Functions  ****************************//
 void oiShotManInit(void)
 {
-	// NOP
+	oiTimingDefaults(&timing);
 }
 
 void oiShotManVisit(void)
@@ -40,13 +87,19 @@ void oiShotManVisit(void)
 					// Yes.  Start it immediately.
 					startShot();
 				} else {
-					// No, this was the last shot.
-					oiSmSetEvent(EVENT_REC_DONE);
+					// No, this was the last shot.  Finish processing it before
+					//  the data may be requested.
+					processShot(iShot - 1u);
+					isFinishing = true;
 				}
 			} else {
 				// Logic error.
 				assert(false);
 			}
+		} else if (state == STATE_RECORD && iShot > 0u) {
+			// The pulsers have fired, so process the previous shot while
+			//  this one records.
+			processShot(iShot - 1u);
 		} else {
 			// Ignore other transitions.
 		}		
@@ -56,52 +109,412 @@ void oiShotManVisit(void)
 		// No transition.
 	}
 	
+	if (isFinishing && oiCoreIsIdle()) {
+		// Every shot has been processed.
+		isFinishing = false;
+		oiSmSetEvent(EVENT_REC_DONE);
+		oiBootMark(OI_BOOT_FIRST_FRAME);
+	} else {
+		// Still recording or processing, or idle.
+	}
 }
 
-oi_error_t oiShotManQueueFrame(const void* pBytes, uint32_t nBytes)
-{
+// Of OI_CMD_QUEUE_FRAME_FORMATTED if isFormatted; else of OI_CMD_QUEUE_FRAME,
+//  whose shots are those of protocol version 1, and record 16 bits.
+oi_error_t oiShotManQueueFrame(
+		const void* pBytes, 
+		uint32_t nBytes, 
+		bool isFormatted
+) {
+	const uint32_t shotBytes = isFormatted ? sizeof(OI_SHOT) : OI_SHOT_V1_BYTES;
 	oi_error_t result = OI_ERR_NONE;
 	
 	if (oiSmGetState() != STATE_READY) {
 		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes < sizeof(frame)-sizeof(frame.shots)) {
+		// Not even a complete header.
+		result = OI_ERR_INCORRECT_SIZE;
 	} else {
 		// Copy the header (everything but the shots):
 		memcpy(&frame, pBytes, sizeof(frame)-sizeof(frame.shots));
+		result = checkCounts(frame.nShots, 0u);
+	}
+	
+	if (result != OI_ERR_NONE) {
+		// Rejected.
+	} else if (nBytes != sizeof(frame)-sizeof(frame.shots)
+			+ shotBytes * frame.nShots) {
+		// Not the size that the shots should be.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Ok.  Copy the shots that were sent into our frame object.
+		const uint8_t* const pShots = (const uint8_t*) pBytes 
+				+ (sizeof(frame)-sizeof(frame.shots));
+		for (uint32_t iS = 0u; iS < frame.nShots; ++iS) {
+			memcpy(&frame.shots[iS], pShots + shotBytes * iS, shotBytes);
+			if (!isFormatted) {
+				frame.shots[iS].rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+			} else {
+				// Sent.
+			}
+		}
 		
-		// Compute what the frame size should be:
-		const uint32_t frameSize = sizeof(frame)-sizeof(frame.shots)
-				+ sizeof(OI_SHOT) * frame.nShots;
-	
-		if (nBytes != frameSize || frameSize > sizeof(frame)) {
-			// Wrong size, or they sent too many shots:
-			result = OI_ERR_INCORRECT_SIZE;
-		} else if (frame.nShots == 0u) {
-			// A frame with no shots is illegal.
-			result = OI_ERR_INVALID_PARAMETER;
+		for (uint32_t iS = 0u; iS < frame.nShots && !result; ++iS) {
+			result = checkFormat(
+					frame.shots[iS].rx.sampleFormat,
+					frame.shots[iS].rx.nSamples
+			);
+		}
+		
+		if (result == OI_ERR_NONE) {
+			result = checkBuffers();
 		} else {
-			// Ok.  Copy into our frame object.
-			memcpy(&frame, pBytes, sizeof(frame));
-			// Reset shot counter:
-			iShot = 0u;
-			// Restart recording:
-			oiAdcDmaRestartRecording();
-			// Arm the pulsers:
-			oiSmSetEvent(EVENT_ARM);
+			// Already failed.
+		}
+		if (result == OI_ERR_NONE) {
+			startFrame();
+		} else {
+			// Reject.
 		}
 	}
 	
 	return result;
 }
 
+oi_error_t oiShotManQueueFrameRle(const void* pBytes, uint32_t nBytes)
+{
+	oi_error_t result = OI_ERR_NONE;
+	
+	if (oiSmGetState() != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes < sizeof(rleFrame)-sizeof(rleFrame.shots)) {
+		// Not even a complete header.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy the header and templates (everything but the shots):
+		memcpy(&rleFrame, pBytes, sizeof(rleFrame)-sizeof(rleFrame.shots));
+		result = checkCounts(rleFrame.nShots, rleFrame.nTemplates);
+	}
+	
+	if (result != OI_ERR_NONE) {
+		// Rejected.
+	} else if (nBytes != sizeof(rleFrame)-sizeof(rleFrame.shots)
+			+ sizeof(OI_SHOT_RLE) * rleFrame.nShots) {
+		// Not the size that the shots should be.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		memcpy(&rleFrame, pBytes, nBytes);
+		result = loadRleFrame();
+	}
+	
+	return result;
+}
+
+oi_error_t oiShotManQueueFrameFocused(const void* pBytes, uint32_t nBytes)
+{
+	oi_error_t result = OI_ERR_NONE;
+	
+	if (oiSmGetState() != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes < sizeof(focusedFrame)-sizeof(focusedFrame.shots)) {
+		// Not even a complete header.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy the header and templates (everything but the shots):
+		memcpy(
+				&focusedFrame, 
+				pBytes, 
+				sizeof(focusedFrame)-sizeof(focusedFrame.shots)
+		);
+		result = checkCounts(focusedFrame.nShots, focusedFrame.nTemplates);
+	}
+	
+	if (result != OI_ERR_NONE) {
+		// Rejected.
+	} else if (nBytes != sizeof(focusedFrame)-sizeof(focusedFrame.shots)
+			+ sizeof(OI_SHOT_FOCUSED) * focusedFrame.nShots) {
+		// Not the size that the shots should be.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		memcpy(&focusedFrame, pBytes, nBytes);
+		
+		// Plan the delays of each shot, which gives an RLE frame:
+		rleFrame.handle = focusedFrame.handle;
+		rleFrame.nShots = focusedFrame.nShots;
+		rleFrame.nTemplates = focusedFrame.nTemplates;
+		memcpy(
+				rleFrame.templates, 
+				focusedFrame.templates,
+				sizeof(rleFrame.templates)
+		);
+		
+		for (uint32_t iS = 0u; iS < focusedFrame.nShots && !result; ++iS) {
+			result = oiTxPlanFocus(
+					&rleFrame.shots[iS].tx,
+					&focusedFrame.shots[iS].tx,
+					focusedFrame.pitchNm,
+					focusedFrame.speedOfSound
+			);
+			rleFrame.shots[iS].rx = focusedFrame.shots[iS].rx;
+		}
+		
+		if (result == OI_ERR_NONE) {
+			result = loadRleFrame();
+		} else {
+			// Reject.
+		}
+	}
+	
+	return result;
+}
+
+// Whether the raw data of the last frame are all 16-bit samples, which is
+//  what the on-device processing and packing expect.
+bool oiShotManIsFullWidth(void) { return isFullWidth; }
+
+// The costs of the shot pipeline, with which frames are estimated.
+const OI_TIMING_CAL* oiShotManGetTiming(void) { return &timing; }
+
 //***********************  Local Function Definitions  ***********************//
 
+// Bounds the counts in a frame's header before the frame's size is computed
+//  from them, so that no count can wrap the size into agreement and index
+//  past the shots or templates.
+static oi_error_t checkCounts(uint32_t nShots, uint32_t nTemplates)
+{
+	oi_error_t result = OI_ERR_NONE;
+	
+	if (nShots == 0u) {
+		// A frame with no shots is illegal.
+		result = OI_ERR_INVALID_PARAMETER;
+	} else if (nShots > OI_MAX_N_SHOTS) {
+		// They sent too many shots.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else if (nTemplates > OI_TX_MAX_N_TEMPLATES) {
+		// More templates than the frame holds.
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		// Ok.
+	}
+	
+	return result;
+}
+
+// The packed sample formats are only for raw data; IQ and beamforming
+//  read 16-bit samples.
+static oi_error_t checkFormat(uint32_t sampleFormat, uint32_t nSamples)
+{
+	oi_error_t result = oiRxValidateFormat(sampleFormat, nSamples);
+	
+	if (result != OI_ERR_NONE) {
+		// Already failed.
+	} else if (sampleFormat != OI_SAMPLE_FORMAT_16 
+			&& (oiIqIsEnabled() || oiBfIsEnabled())) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else {
+		// Ok.
+	}
+	
+	return result;
+}
+
+// Refuses a frame that would record into DDR whose ECC the FSBL failed to
+//  initialize (see oiBoot.c).
+static oi_error_t checkBuffers(void)
+{
+	uint32_t nBytes = 0u;
+	
+	for (uint32_t iS = 0u; iS < frame.nShots; ++iS) {
+		nBytes += OI_RX_SHOT_RECORD_BYTES(
+				frame.shots[iS].rx.nSamples,
+				frame.shots[iS].rx.sampleFormat
+		);
+	}
+	
+	return oiAdcDmaIsUsable(nBytes) ? OI_ERR_NONE : OI_ERR_ILLEGAL_STATE;
+}
+
+// Validates the staged RLE frame, and if it is good, expands it into our
+//  frame object so that the shots are fired exactly as an uncompressed
+//  frame.  This renders the TGC curves.
+static oi_error_t loadRleFrame(void)
+{
+	oi_error_t result = OI_ERR_NONE;
+	
+	// Validate every shot before touching the current frame:
+	for (uint32_t iS = 0u; iS < rleFrame.nShots && !result; ++iS) {
+		result = oiTxRleValidate(
+				&rleFrame.shots[iS].tx,
+				rleFrame.templates,
+				rleFrame.nTemplates
+		);
+		if (result == OI_ERR_NONE) {
+			result = oiRxValidate(&rleFrame.shots[iS].rx);
+		} else {
+			// Already failed.
+		}
+		if (result == OI_ERR_NONE) {
+			result = checkFormat(
+					rleFrame.shots[iS].rx.sampleFormat,
+					rleFrame.shots[iS].rx.nSamples
+			);
+		} else {
+			// Already failed.
+		}
+	}
+		
+	if (result == OI_ERR_NONE) {
+		frame.handle = rleFrame.handle;
+		frame.nShots = rleFrame.nShots;
+		
+		for (uint32_t iS = 0u; iS < rleFrame.nShots; ++iS) {
+			oiTxRleExpand(
+					&frame.shots[iS].tx,
+					&rleFrame.shots[iS].tx,
+					rleFrame.templates
+			);
+			oiRxExpand(&frame.shots[iS].rx, &rleFrame.shots[iS].rx);
+		}
+		
+		result = checkBuffers();
+	} else {
+		// Reject.
+	}
+	
+	if (result == OI_ERR_NONE) {
+		startFrame();
+	} else {
+		// Reject.
+	}
+	
+	return result;
+}
+
+// Begins acquisition of a newly queued frame.
+static void startFrame(void)
+{
+	// A client may queue this frame before it has the last one's data; the
+	//  replies that carry them refer to the buffers about to be reused.
+	oiCoreWaitForReplies();
+	
+	isFullWidth = true;
+	for (uint32_t iS = 0u; iS < frame.nShots; ++iS) {
+		isFullWidth = isFullWidth 
+				&& frame.shots[iS].rx.sampleFormat == OI_SAMPLE_FORMAT_16;
+	}
+	
+	// Reset shot counter:
+	iShot = 0u;
+	XTime_GetTime(&armStart);
+	oiIqRestart();
+	oiBfRestart();
+	// Restart recording:
+	oiAdcDmaRestartRecording();
+	// Arm the pulsers:
+	oiSmSetEvent(EVENT_ARM);
+}
+
 static void startShot(void)
 {
+	const OI_RX* const pRx = &frame.shots[iShot].rx;
+	// Before each step of the setup, and after the last:
+	XTime times[5];
+	
 EMIO_GPIO_SET_PIN(EMIO_GPIO_PIN_PMOD1_6);		
+	XTime_GetTime(&times[0]);
 	oiPulserSetup(&frame.shots[iShot].tx);
-	oiTgcSetup(&frame.shots[iShot].rx);
-	oiAdcSetup(&frame.shots[iShot].rx);
+	XTime_GetTime(&times[1]);
+	const bool isTgcLoaded = oiTgcSetup(pRx);
+	XTime_GetTime(&times[2]);
+	oiAdcDmaLabelShot(frame.handle, iShot);
+	oiAdcSetup(pRx);
+	XTime_GetTime(&times[3]);
+	// If its buffers' scrub failed since the frame was queued, nothing is
+	//  recorded, and the DMA is found done at once:
+	(void) oiAdcDmaSetup(OI_RX_SHOT_BYTES(pRx->nSamples, pRx->sampleFormat));
+	XTime_GetTime(&times[4]);
 EMIO_GPIO_CLEAR_PIN(EMIO_GPIO_PIN_PMOD1_6);
 	oiSmSetEvent(EVENT_SHOT);
+	
+	// The shot records while this is worked out:
+	timeShot(times, pRx, isTgcLoaded);
+}
+
+// Folds the times of the shot just set up into the calibration.  The
+//  first shot of a frame times the arming; each later one times the
+//  period of the shot before it, beyond that shot's setup and samples.
+static void timeShot(
+		const XTime* pTimes, 
+		const OI_RX* pRx, 
+		bool isTgcLoaded
+) {
+	const uint32_t nBds = OI_RX_N_CHIPS * CEIL_DIV(
+			OI_RX_SHOT_RECORD_BYTES(pRx->nSamples, pRx->sampleFormat),
+			OI_DMA_BD_BYTES
+	);
+	
+	if (iShot == 0u) {
+		measure(&timing.armNs, toNs(pTimes[0] - armStart));
+	} else {
+		const uint64_t periodNs = toNs(pTimes[0] - prevStart);
+		if (periodNs > prevBusyNs) {
+			measure(&timing.shotNs, periodNs - prevBusyNs);
+		} else {
+			// Nothing beyond; the clock is coarser than the shot.
+		}
+	}
+	
+	measure(&timing.pulserNs, toNs(pTimes[1] - pTimes[0]));
+	if (isTgcLoaded) {
+		measure(&timing.tgcNs, toNs(pTimes[2] - pTimes[1]));
+	} else {
+		// Skipped; this is only the check.
+	}
+	measure(&timing.adcNs, toNs(pTimes[3] - pTimes[2]));
+	measure(&timing.bdNs, toNs(pTimes[4] - pTimes[3]) / nBds);
+	++timing.nMeasured;
+	
+	prevStart = pTimes[0];
+	prevBusyNs = toNs(pTimes[4] - pTimes[0]) 
+			+ pRx->nSamples * NS_PER_SEC / timing.sampleRateHz;
+}
+
+// Moves a calibrated cost toward a measurement of it.
+static void measure(uint32_t* pNs, uint64_t ns)
+{
+	const int64_t delta = (int64_t) (ns > UINT32_MAX ? UINT32_MAX : ns) 
+			- (int64_t) *pNs;
+	
+	*pNs = (uint32_t) ((int64_t) *pNs + delta / TIMING_WEIGHT);
+}
+
+// Whole seconds and the remainder apart, so that the product cannot
+//  overflow 64 bits, however long the device has been up.
+static uint64_t toNs(XTime counts)
+{
+	return counts / COUNTS_PER_SECOND * NS_PER_SEC
+			+ counts % COUNTS_PER_SECOND * NS_PER_SEC / COUNTS_PER_SECOND;
 }
 
+// Produces the configured product, if any, from a recorded shot.  The work
+//  is passed to a worker core, if there are any.
+static void processShot(uint32_t iS)
+{
+	static shot_job_t job;
+	const uint32_t nSamples = frame.shots[iS].rx.nSamples;
+	bool isPlanned = false;
+	
+	if (oiIqIsEnabled()) {
+		isPlanned = oiIqPlanShot(&job, nSamples);
+	} else if (oiBfIsEnabled()) {
+		isPlanned = oiBfPlanShot(&job, iS, nSamples);
+	} else {
+		// Raw data.
+	}
+	
+	if (isPlanned) {
+		oiCoreRunJob(&job);
+	} else {
+		// Nothing to do.
+	}
+}
@@ -9,30 +9,52 @@
 #include "open_image.h"
 
 #include <ad5424_axi4.h>
+#include <string.h>
 
 #if OI_RX_MAX_N_TGC != AD5424_N_WAVEFORM
 #	error Number of TGC values inconsistent with hardware.
 #endif
 
+//*******************************  Module Data  ******************************//
+// The waveforms in the DAC memory, if any.
+static bool isLoaded = false;
+static uint8_t loadedTgc[OI_RX_N_CHIPS][OI_RX_MAX_N_TGC];
+
 //****************************  Global Functions  ****************************//
 void oiTgcInit(void)
 {
-	// NOP
+	isLoaded = false;
 }
 
-void oiTgcSetup(const OI_RX* pRx)
+// Loads the shot's TGC waveforms, unless they are already.  Returns
+//  whether they were loaded.  The comparison is of the whole of both
+//  waveforms, which costs far less than the AXI writes it saves.
+bool oiTgcSetup(const OI_RX* pRx)
 {
+	bool isLoading;
+	
 	// Lower the start flag:
 	EMIO_GPIO_CLEAR_PIN(EMIO_GPIO_PIN_DAC_START);
 	
 EMIO_GPIO_CLEAR_PIN(EMIO_GPIO_PIN_PMOD1_5);	
 	
-	// Setup the waveform.
-	for (uint32_t iW = 0; iW < AD5424_N_WAVEFORM; ++iW) {
-		AD5424_REG_WAVEFORM(XPAR_AD5424_AXI4_0_S_AXI_BASEADDR, iW) 
-				= AD5424_WAVEFORM(0, pRx->tgc[0][iW])   // DAC 0
-				| AD5424_WAVEFORM(1, pRx->tgc[1][iW]);  // DAC 1
+	if (isLoaded && memcmp(loadedTgc, pRx->tgc, sizeof(loadedTgc)) == 0) {
+		// Same curves as the last shot; the DAC memory is already correct.
+		isLoading = false;
+	} else {
+		// Setup the waveform.
+		for (uint32_t iW = 0; iW < AD5424_N_WAVEFORM; ++iW) {
+			AD5424_REG_WAVEFORM(XPAR_AD5424_AXI4_0_S_AXI_BASEADDR, iW) 
+					= AD5424_WAVEFORM(0, pRx->tgc[0][iW])   // DAC 0
+					| AD5424_WAVEFORM(1, pRx->tgc[1][iW]);  // DAC 1
+		}
+		
+		isLoaded = true;
+		memcpy(loadedTgc, pRx->tgc, sizeof(loadedTgc));
+		isLoading = true;
 	}
+	
+	return isLoading;
 }
 
 
@@ -0,0 +1,167 @@
+/*
+	oiTiming.c
+
+	Timing model of the shot pipeline:  predicts how long a frame of raw
+	data takes, from arming to having its data on the host, and so the
+	rate of its shots and frames and how busy it keeps the link.  Each shot
+	is set up (pulsers, TGC waveforms if they change, ADCs, and a DMA
+	buffer descriptor for every OI_DMA_BD_BYTES of its record), recorded
+	for its samples (the round trip to the depth recorded), and finished;
+	the shots follow one another, and the data are read once the last is
+	done.  Nothing waits for deeper echoes to die out, so the shots that
+	fire before those of a given depth are back are only counted.  The
+	costs are those of OI_TIMING_CAL, as measured by the device.
+	Portable; also built into the host software.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+//********************************  Constants  *******************************//
+#define NS_PER_SEC                                            1000000000ull
+#define MILLI_PER_UNIT                                              1000ull
+#define NM_PER_UM                                                   1000ull
+
+#define DEFAULT_SPEED_OF_SOUND                                        1540u
+
+//***********************  Local Function Declarations  **********************//
+static uint32_t saturate(uint64_t x);
+static uint32_t perMille(uint64_t x, uint64_t y);
+
+//****************************  Global Functions  ****************************//
+
+void oiTimingDefaults(OI_TIMING_CAL* pCal)
+{
+	pCal->armNs = OI_TIMING_DEFAULT_ARM_NS;
+	pCal->shotNs = OI_TIMING_DEFAULT_SHOT_NS;
+	pCal->pulserNs = OI_TIMING_DEFAULT_PULSER_NS;
+	pCal->tgcNs = OI_TIMING_DEFAULT_TGC_NS;
+	pCal->adcNs = OI_TIMING_DEFAULT_ADC_NS;
+	pCal->bdNs = OI_TIMING_DEFAULT_BD_NS;
+	pCal->requestNs = OI_TIMING_DEFAULT_REQUEST_NS;
+	pCal->linkBytesPerSec = OI_TIMING_DEFAULT_LINK_BYTES_PER_SEC;
+	pCal->sampleRateHz = OI_TIMING_DEFAULT_SAMPLE_RATE_HZ;
+	pCal->nMeasured = 0u;
+}
+
+// Estimates the frame described by pReq.  Returns
+//  OI_ERR_INVALID_PARAMETER, and leaves pEst alone, if the device would
+//  refuse any of its shots, or the request or costs cannot be estimated.
+oi_error_t oiTimingEstimate(
+		OI_FRAME_ESTIMATE* pEst,
+		const OI_ESTIMATE_REQ* pReq,
+		const OI_TIMING_CAL* pCal
+) {
+	oi_error_t result = OI_ERR_NONE;
+
+	if (pReq->nShots == 0u || pReq->nShots > OI_MAX_N_SHOTS
+			|| pReq->chunkBytes == 0u || pCal->linkBytesPerSec == 0u
+			|| pCal->sampleRateHz == 0u) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		for (uint32_t iS = 0u; iS < pReq->nShots && !result; ++iS) {
+			result = oiRxValidateFormat(
+					pReq->shots[iS].sampleFormat,
+					pReq->shots[iS].nSamples
+			);
+		}
+	}
+
+	if (result == OI_ERR_NONE) {
+		const uint64_t
+			speedOfSound = pReq->speedOfSound != 0u ? pReq->speedOfSound
+					: DEFAULT_SPEED_OF_SOUND,
+			// Round trip to the depth whose echoes should die out:
+			echoNs = 2u * (uint64_t) pReq->clearDepthUm * NM_PER_UM
+					/ speedOfSound;
+		uint64_t
+			setupNs = 0u,
+			recordNs = 0u,
+			nBytes = 0u,       // of each ADC
+			nBds = 0u;
+		uint32_t nEchoOverlap = 0u;
+
+		for (uint32_t iS = 0u; iS < pReq->nShots; ++iS) {
+			const OI_ESTIMATE_SHOT* const pShot = &pReq->shots[iS];
+			const uint64_t
+				shotBytes = OI_RX_SHOT_RECORD_BYTES(
+						(uint64_t) pShot->nSamples,
+						pShot->sampleFormat
+				),
+				shotBds = (shotBytes + OI_DMA_BD_BYTES - 1u)
+						/ OI_DMA_BD_BYTES,
+				shotSetupNs = (uint64_t) pCal->pulserNs
+						+ ((pShot->flags & OI_ESTIMATE_TGC_LOAD) != 0u
+								? pCal->tgcNs : 0u)
+						+ pCal->adcNs
+						+ pCal->bdNs * shotBds * OI_RX_N_CHIPS,
+				samplesNs = (uint64_t) pShot->nSamples * NS_PER_SEC
+						/ pCal->sampleRateHz;
+
+			// The next shot fires after this one's period:
+			if (shotSetupNs + pCal->shotNs + samplesNs < echoNs) {
+				++nEchoOverlap;
+			} else {
+				// Its echoes are gone by then.
+			}
+
+			setupNs += shotSetupNs;
+			recordNs += samplesNs;
+			nBytes += shotBytes;
+			nBds += shotBds;
+		}
+
+		const uint64_t
+			shotsNs = setupNs + recordNs
+					+ (uint64_t) pCal->shotNs * pReq->nShots,
+			uploadNs = (uint64_t) pReq->programBytes * NS_PER_SEC
+					/ pCal->linkBytesPerSec + pCal->requestNs,
+			// The requests are pipelined, so the data flow as fast as the
+			//  slower of the link and the device's handling of them, after
+			//  the first request:
+			nRequests = OI_RX_N_CHIPS
+					* ((nBytes + pReq->chunkBytes - 1u) / pReq->chunkBytes),
+			wireNs = OI_RX_N_CHIPS * nBytes * NS_PER_SEC
+					/ pCal->linkBytesPerSec,
+			handleNs = nRequests * pCal->requestNs,
+			transferNs = (wireNs > handleNs ? wireNs : handleNs)
+					+ pCal->requestNs,
+			pollNs = pReq->pollNs / 2u,
+			frameNs = uploadNs + pCal->armNs + shotsNs + pollNs + transferNs,
+			linkNs = wireNs + (uint64_t) pReq->programBytes * NS_PER_SEC
+					/ pCal->linkBytesPerSec;
+
+		pEst->uploadNs = saturate(uploadNs);
+		pEst->armNs = pCal->armNs;
+		pEst->setupNs = saturate(setupNs);
+		pEst->recordNs = saturate(recordNs);
+		pEst->shotsNs = saturate(shotsNs);
+		pEst->pollNs = saturate(pollNs);
+		pEst->transferNs = saturate(transferNs);
+		pEst->frameNs = saturate(frameNs);
+		pEst->prfMilliHz = perMille(pReq->nShots * NS_PER_SEC, shotsNs);
+		pEst->frameRateMilliHz = perMille(NS_PER_SEC, frameNs);
+		pEst->linkPermille = perMille(linkNs, frameNs);
+		pEst->nBds = saturate(nBds);
+		pEst->nEchoOverlap = nEchoOverlap;
+	} else {
+		// Leave the estimate.
+	}
+
+	return result;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static uint32_t saturate(uint64_t x)
+{
+	return x > UINT32_MAX ? UINT32_MAX : (uint32_t) x;
+}
+
+// Thousandths of x / y, or zero if y is; e.g., milliHertz from a count and
+//  nanoseconds times NS_PER_SEC.
+static uint32_t perMille(uint64_t x, uint64_t y)
+{
+	return y != 0u ? saturate(x * MILLI_PER_UNIT / y) : 0u;
+}
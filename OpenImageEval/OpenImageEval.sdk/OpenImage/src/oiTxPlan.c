@@ -0,0 +1,163 @@
+/*
+	oiTxPlan.c
+
+	Transmit planner: computes the per-channel transmit delays for a
+	focused or steered shot.  Portable; also built into the host software.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+//********************************  Constants  *******************************//
+#define NM_PER_UM                                                     1000
+#define NM_PER_M                                               1000000000.0
+
+// Largest allowed steering angle.
+#define MAX_STEER_MDEG                                               90000
+
+// Largest allowed focal coordinates and element pitch, so that the squared
+//  distances to the focus, in doubled nanometres, fit in 63 bits.
+#define MAX_FOCUS_UM                                                500000
+#define MAX_PITCH_NM                                              10000000u
+
+#define PI                                              3.14159265358979324
+
+//***********************  Local Function Declarations  **********************//
+
+//****************************  Global Functions  ****************************//
+
+// Plans the delays of one shot, and writes them to pRle.  The result still
+//  needs to be validated against the templates (oiTxRleValidate).
+oi_error_t oiTxPlanFocus(
+		OI_TX_RLE* pRle,
+		const OI_TX_FOCUS* pFocus,
+		uint32_t pitchNm,
+		uint32_t speedOfSound
+) {
+	oi_error_t result = OI_ERR_NONE;
+
+	// Positions are doubled, so that the centre of the array is integral.
+	int64_t x2[OI_N_CHAN];
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		x2[iChan] = ((int64_t) iChan * 2 - (OI_N_CHAN - 1u)) * pitchNm;
+	}
+
+	// Time of flight to the focus, in doubled nanometres, or the time
+	//  of arrival of the plane wave in clocks:
+	double tof[OI_N_CHAN];
+
+	if (pFocus->apertureMask == 0u || pitchNm == 0u || speedOfSound == 0u
+			|| pFocus->iTemplate >= OI_TX_MAX_N_TEMPLATES) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else if (pitchNm > MAX_PITCH_NM
+			|| pFocus->focusXUm > MAX_FOCUS_UM
+			|| pFocus->focusXUm < -MAX_FOCUS_UM
+			|| pFocus->focusZUm > MAX_FOCUS_UM) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else if (pFocus->focusZUm > 0) {
+		// Focused.  The farthest element fires first.
+		const int64_t
+			fx2 = (int64_t) pFocus->focusXUm * NM_PER_UM * 2,
+			fz2 = (int64_t) pFocus->focusZUm * NM_PER_UM * 2;
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			const int64_t dx = x2[iChan] - fx2;
+			tof[iChan] = -(double) oiIsqrt(
+					(uint64_t) (dx * dx) + (uint64_t) (fz2 * fz2)
+			);
+		}
+	} else if (pFocus->steerMdeg > MAX_STEER_MDEG
+			|| pFocus->steerMdeg < -MAX_STEER_MDEG) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		// Plane wave.  The wavefront arrives first at the element that is
+		//  farthest from the direction of steering.
+		const double s = oiSine(pFocus->steerMdeg * (PI / 180000.0));
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			tof[iChan] = (double) x2[iChan] * s;
+		}
+	}
+
+	if (result == OI_ERR_NONE) {
+		// Reference everything to the first element to fire:
+		double first = 0.0;
+		bool any = false;
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			if (pFocus->apertureMask >> iChan & 1u) {
+				if (!any || tof[iChan] < first) {
+					first = tof[iChan];
+					any = true;
+				} else {
+					// Later.
+				}
+			} else {
+				// Outside the aperture.
+			}
+		}
+
+		// Convert doubled nanometres of path to clocks:
+		const double scale
+			= (double) OI_TX_CLOCK_HZ / (2.0 * NM_PER_M * speedOfSound);
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			OI_TX_RLE_CHANNEL* const pCh = &pRle->channels[iChan];
+			const double delay = (tof[iChan] - first) * scale + 0.5;
+
+			pCh->enable = pFocus->apertureMask >> iChan & 1u;
+			pCh->iTemplate = (uint8_t) pFocus->iTemplate;
+
+			if (!pCh->enable) {
+				pCh->delay = 0u;
+			} else if (delay >= OI_MAX_N_LEVEL_SEQUENCE) {
+				// The aperture is too wide for the sequencer.
+				result = OI_ERR_INVALID_PARAMETER;
+				pCh->delay = 0u;
+			} else {
+				pCh->delay = (uint16_t) delay;
+			}
+		}
+	} else {
+		// Fail.
+	}
+
+	return result;
+}
+
+// Taylor series; accurate to a few ppm over [-pi/2, pi/2].  This avoids
+//  linking libm into the firmware.
+double oiSine(double x)
+{
+	const double x2 = x * x;
+
+	return x * (1.0 - x2 / 6.0 * (1.0 - x2 / 20.0 * (1.0 - x2 / 42.0
+			* (1.0 - x2 / 72.0 * (1.0 - x2 / 110.0)))));
+}
+
+// Integer square root, rounded down.
+uint64_t oiIsqrt(uint64_t x)
+{
+	uint64_t
+		root = 0u,
+		bit = (uint64_t) 1u << 62;
+
+	while (bit > x) {
+		bit >>= 2;
+	}
+
+	while (bit) {
+		if (x >= root + bit) {
+			x -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
+
+//***********************  Local Function Definitions  ***********************//
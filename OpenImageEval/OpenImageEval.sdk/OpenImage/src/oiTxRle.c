@@ -0,0 +1,108 @@
+/*
+	oiTxRle.c
+
+	Expansion of run-length encoded transmit waveforms into level
+	sequences.  Portable; also built into the host software.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+#include <string.h>
+
+//***********************  Local Function Declarations  **********************//
+static uint32_t templateLength(const OI_TX_TEMPLATE* pTemplate);
+
+//****************************  Global Functions  ****************************//
+
+// Checks that every enabled channel refers to a valid template, and fits
+//  within the level sequencer.
+oi_error_t oiTxRleValidate(
+		const OI_TX_RLE* pRle,
+		const OI_TX_TEMPLATE* pTemplates,
+		uint32_t nTemplates
+) {
+	oi_error_t result = OI_ERR_NONE;
+
+	if (nTemplates > OI_TX_MAX_N_TEMPLATES) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			const OI_TX_RLE_CHANNEL* const pCh = &pRle->channels[iChan];
+
+			if (!pCh->enable) {
+				// Unused.
+			} else if (pCh->iTemplate >= nTemplates
+					|| pTemplates[pCh->iTemplate].nRuns > OI_TX_MAX_N_RUNS) {
+				result = OI_ERR_INVALID_PARAMETER;
+				break;
+			} else if (pCh->delay + templateLength(&pTemplates[pCh->iTemplate])
+					> OI_MAX_N_LEVEL_SEQUENCE) {
+				// Will not fit, or contains an empty run.
+				result = OI_ERR_INVALID_PARAMETER;
+				break;
+			} else {
+				// Ok.
+			}
+		}
+	}
+
+	return result;
+}
+
+// Expands a validated run-length encoded transmit description.
+void oiTxRleExpand(
+		OI_TX* pTx,
+		const OI_TX_RLE* pRle,
+		const OI_TX_TEMPLATE* pTemplates
+) {
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		const OI_TX_RLE_CHANNEL* const pIn = &pRle->channels[iChan];
+		OI_TX_CHANNEL* const pOut = &pTx->channels[iChan];
+
+		pOut->enable = pIn->enable;
+
+		if (pIn->enable) {
+			const OI_TX_TEMPLATE* const pTemplate = &pTemplates[pIn->iTemplate];
+			uint32_t n = pIn->delay;
+
+			// Leading delay is RTZ:
+			memset(pOut->levelSequence, 0, n);
+
+			for (uint32_t iRun = 0u; iRun < pTemplate->nRuns; ++iRun) {
+				memset(
+						&pOut->levelSequence[n],
+						pTemplate->runs[iRun].level,
+						pTemplate->runs[iRun].count
+				);
+				n += pTemplate->runs[iRun].count;
+			}
+
+			pOut->nLevelSequence = n;
+		} else {
+			// The pulser ignores the sequence of a disabled channel.
+			pOut->nLevelSequence = 0u;
+		}
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Returns the number of clocks in the template, or a length that can never
+//  fit if any run is empty.
+static uint32_t templateLength(const OI_TX_TEMPLATE* pTemplate)
+{
+	uint32_t n = 0u;
+
+	for (uint32_t iRun = 0u; iRun < pTemplate->nRuns; ++iRun) {
+		if (pTemplate->runs[iRun].count == 0u) {
+			n = UINT32_MAX / 2u;
+			break;
+		} else {
+			n += pTemplate->runs[iRun].count;
+		}
+	}
+
+	return n;
+}
@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+// Create Date:   2026-10-19
+// Module Name:   axis_sample_pack_tb
+// Project Name:  Open Imager
+// Description:   Self-checking testbench of axis_sample_pack.
+//
+//                Sends packets of random rows in each format, one after
+//                the other and with the format changed between them, with
+//                gaps in s_axis_tvalid and stalls on m_axis_tready, and
+//                checks each output beat against the bit order that the
+//                host unpacks (OI_SAMPLE_FORMAT_* in open_image_protocol.h,
+//                oiSamples.h):  sample j of a packet, its top b bits, at
+//                bits [b*j, b*j + b).  Also checks that the format is held
+//                for the whole of a packet when i_format changes within it,
+//                and that tlast comes on the packet's last beat only.
+//
+//                Ends with "PASS" or "FAIL" and the count of errors.
+//
+// Dependencies:  axis_sample_pack
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`timescale 1ns / 1ps
+
+module axis_sample_pack_tb;
+
+   //===========================================================================
+   // Constants
+   //===========================================================================
+   localparam  CLOCK_NS  = 10;
+   localparam  MAX_ROWS  = 64;          // per packet; a multiple of 8
+   localparam  N_PACKETS = 24;
+
+   //===========================================================================
+   // Device under test
+   //===========================================================================
+   reg          aclk = 1'b0;
+   reg          aresetn = 1'b0;
+   reg  [1:0]   i_format = 2'd0;
+
+   reg  [127:0] s_axis_tdata = 128'b0;
+   reg          s_axis_tvalid = 1'b0;
+   reg          s_axis_tlast = 1'b0;
+   wire         s_axis_tready;
+
+   wire [127:0] m_axis_tdata;
+   wire  [15:0] m_axis_tkeep;
+   wire         m_axis_tvalid;
+   wire         m_axis_tlast;
+   reg          m_axis_tready = 1'b0;
+
+   axis_sample_pack dut
+     (
+      .aclk          (aclk),
+      .aresetn       (aresetn),
+      .i_format      (i_format),
+      .s_axis_tdata  (s_axis_tdata),
+      .s_axis_tvalid (s_axis_tvalid),
+      .s_axis_tlast  (s_axis_tlast),
+      .s_axis_tready (s_axis_tready),
+      .m_axis_tdata  (m_axis_tdata),
+      .m_axis_tkeep  (m_axis_tkeep),
+      .m_axis_tvalid (m_axis_tvalid),
+      .m_axis_tlast  (m_axis_tlast),
+      .m_axis_tready (m_axis_tready)
+      );
+
+   always #(CLOCK_NS / 2) aclk = ~aclk;
+
+   //===========================================================================
+   // The current packet, and what should come out of it
+   //===========================================================================
+   reg [127:0] rows [0:MAX_ROWS - 1];
+   reg [127:0] expected [0:MAX_ROWS - 1];
+   integer     n_rows = 0;
+   integer     n_beats = 0;
+   integer     n_bits;               // per sample
+   integer     n_seen = 0;           // beats of the packet checked
+   integer     n_errors = 0;
+   integer     seed = 32'h4F49;
+
+   // Packs rows[0 .. n_rows) into expected[0 .. n_beats), a bit at a time.
+   task make_expected;
+      integer g, j, k;
+      begin
+         n_beats = n_rows * n_bits / 16;
+         for (k = 0; k < n_beats; k = k + 1)
+            expected[k] = 128'b0;
+         for (g = 0; g < n_beats * 128; g = g + 1) begin
+            j = g / n_bits;
+            k = 16 * (j % 8) + 16 - n_bits + g % n_bits;
+            expected[g / 128][g % 128] = rows[j / 8][k];
+         end
+      end
+   endtask
+
+   //===========================================================================
+   // Checking of the output
+   //===========================================================================
+   always @(posedge aclk)
+      if (aresetn) begin
+         m_axis_tready <= ($random(seed) & 3) != 0;
+
+         if (m_axis_tvalid && m_axis_tready) begin
+            if (n_seen >= n_beats) begin
+               $display("%t  beat %0d of a packet of %0d", $time, n_seen,
+                        n_beats);
+               n_errors = n_errors + 1;
+            end
+            else begin
+               if (m_axis_tdata !== expected[n_seen]) begin
+                  $display("%t  beat %0d:  %h, not %h", $time, n_seen,
+                           m_axis_tdata, expected[n_seen]);
+                  n_errors = n_errors + 1;
+               end
+               if (m_axis_tlast !== (n_seen == n_beats - 1)) begin
+                  $display("%t  beat %0d:  tlast %b", $time, n_seen,
+                           m_axis_tlast);
+                  n_errors = n_errors + 1;
+               end
+               if (m_axis_tkeep !== 16'hFFFF) begin
+                  $display("%t  beat %0d:  tkeep %h", $time, n_seen,
+                           m_axis_tkeep);
+                  n_errors = n_errors + 1;
+               end
+            end
+            n_seen = n_seen + 1;
+         end
+      end
+
+   //===========================================================================
+   // Stimulus
+   //===========================================================================
+   // Sends rows[0 .. n_rows), with random gaps, in format; i_format is
+   //  changed after the first beat, which must not change the packing.
+   task send_packet;
+      input [1:0] format;
+      integer r;
+      begin
+         i_format <= format;
+         for (r = 0; r < n_rows; r = r + 1) begin
+            while (($random(seed) & 3) == 0) begin
+               s_axis_tvalid <= 1'b0;
+               @(posedge aclk);
+            end
+            s_axis_tdata  <= rows[r];
+            s_axis_tlast  <= r == n_rows - 1;
+            s_axis_tvalid <= 1'b1;
+            @(posedge aclk);
+            while (!s_axis_tready)
+               @(posedge aclk);
+            i_format <= ($random(seed) & 32'h7FFFFFFF) % 3;
+         end
+         s_axis_tvalid <= 1'b0;
+         s_axis_tlast  <= 1'b0;
+      end
+   endtask
+
+   integer p, r, i;
+   reg [1:0] format;
+
+   initial begin
+      repeat (4) @(posedge aclk);
+      aresetn <= 1'b1;
+      @(posedge aclk);
+
+      for (p = 0; p < N_PACKETS; p = p + 1) begin
+         format = p % 3;
+         n_bits = format == 2'd1 ? 14 : format == 2'd2 ? 12 : 16;
+         n_rows = 8 * (1 + ($random(seed) & 32'h7FFFFFFF)
+                  % (MAX_ROWS / 8));
+         for (r = 0; r < n_rows; r = r + 1)
+            for (i = 0; i < 4; i = i + 1)
+               rows[r][32*i +: 32] = $random(seed);
+         make_expected;
+         n_seen = 0;
+
+         send_packet(format);
+
+         // Drain.
+         repeat (8) @(posedge aclk);
+         while (n_seen < n_beats)
+            @(posedge aclk);
+         if (n_seen != n_beats) begin
+            $display("packet %0d:  %0d beats, not %0d", p, n_seen, n_beats);
+            n_errors = n_errors + 1;
+         end
+      end
+
+      if (n_errors == 0)
+         $display("PASS");
+      else
+         $display("FAIL:  %0d errors", n_errors);
+      $finish;
+   end
+
+endmodule
@@ -0,0 +1,197 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+// Create Date:   2026-10-19
+// Module Name:   axis_shot_header_tb
+// Project Name:  Open Imager
+// Description:   Self-checking testbench of axis_shot_header.
+//
+//                Sends packets of random lengths and data, with gaps in
+//                s_axis_tvalid and stalls on m_axis_tready, and checks what
+//                comes out against OI_SHOT_HEADER (open_image_protocol.h):
+//                each packet is preceded by a beat of OI_SHOT_MAGIC, the
+//                packet's index and a timestamp within a clock or two of
+//                when its first beat was offered, and by a beat of zeros;
+//                its beats then pass unchanged, with tlast on the last.
+//
+//                Ends with "PASS" or "FAIL" and the count of errors.
+//
+// Dependencies:  axis_shot_header
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+`timescale 1ns / 1ps
+
+module axis_shot_header_tb;
+
+   //===========================================================================
+   // Constants
+   //===========================================================================
+   localparam  CLOCK_NS  = 10;
+   localparam  MAX_BEATS = 32;          // per packet
+   localparam  N_PACKETS = 20;
+   localparam  MAGIC     = 32'h4853494F;
+
+   //===========================================================================
+   // Device under test
+   //===========================================================================
+   reg          aclk = 1'b0;
+   reg          aresetn = 1'b0;
+
+   reg  [127:0] s_axis_tdata = 128'b0;
+   reg          s_axis_tvalid = 1'b0;
+   reg          s_axis_tlast = 1'b0;
+   wire         s_axis_tready;
+
+   wire [127:0] m_axis_tdata;
+   wire  [15:0] m_axis_tkeep;
+   wire         m_axis_tvalid;
+   wire         m_axis_tlast;
+   reg          m_axis_tready = 1'b0;
+
+   axis_shot_header dut
+     (
+      .aclk          (aclk),
+      .aresetn       (aresetn),
+      .s_axis_tdata  (s_axis_tdata),
+      .s_axis_tvalid (s_axis_tvalid),
+      .s_axis_tlast  (s_axis_tlast),
+      .s_axis_tready (s_axis_tready),
+      .m_axis_tdata  (m_axis_tdata),
+      .m_axis_tkeep  (m_axis_tkeep),
+      .m_axis_tvalid (m_axis_tvalid),
+      .m_axis_tlast  (m_axis_tlast),
+      .m_axis_tready (m_axis_tready)
+      );
+
+   always #(CLOCK_NS / 2) aclk = ~aclk;
+
+   // Clocks since reset, as the DUT counts them.
+   reg [63:0] clocks = 64'b0;
+   always @(posedge aclk)
+      if (aresetn == 1'b0)
+         clocks <= 64'b0;
+      else
+         clocks <= clocks + 1;
+
+   //===========================================================================
+   // What was sent, and what should come out
+   //===========================================================================
+   reg [127:0] beats [0:MAX_BEATS - 1];
+   integer     n_beats = 0;          // of the current packet
+   integer     i_packet = 0;
+   reg  [63:0] offered = 64'b0;      // clocks when its first beat was offered
+   reg  [63:0] prev_timestamp = 64'b0;
+   integer     n_seen = 0;           // beats out, headers included
+   integer     n_errors = 0;
+   integer     seed = 32'h4F49;
+
+   //===========================================================================
+   // Checking of the output
+   //===========================================================================
+   always @(posedge aclk)
+      if (aresetn) begin
+         m_axis_tready <= ($random(seed) & 3) != 0;
+
+         if (m_axis_tvalid && m_axis_tready) begin
+            if (m_axis_tkeep !== 16'hFFFF) begin
+               $display("%t  tkeep %h", $time, m_axis_tkeep);
+               n_errors = n_errors + 1;
+            end
+
+            if (n_seen == 0) begin
+               if (m_axis_tdata[31:0] !== MAGIC
+                     || m_axis_tdata[63:32] !== i_packet
+                     || m_axis_tdata[127:64] < offered
+                     || m_axis_tdata[127:64] > offered + 2
+                     || (i_packet > 0
+                        && m_axis_tdata[127:64] <= prev_timestamp)) begin
+                  $display("%t  packet %0d:  header %h, offered at %0d",
+                           $time, i_packet, m_axis_tdata, offered);
+                  n_errors = n_errors + 1;
+               end
+               prev_timestamp = m_axis_tdata[127:64];
+            end
+            else if (n_seen == 1) begin
+               if (m_axis_tdata !== 128'b0) begin
+                  $display("%t  packet %0d:  second beat %h", $time,
+                           i_packet, m_axis_tdata);
+                  n_errors = n_errors + 1;
+               end
+            end
+            else if (n_seen - 2 >= n_beats) begin
+               $display("%t  packet %0d:  beat %0d of %0d", $time, i_packet,
+                        n_seen - 2, n_beats);
+               n_errors = n_errors + 1;
+            end
+            else if (m_axis_tdata !== beats[n_seen - 2]) begin
+               $display("%t  packet %0d:  beat %0d:  %h, not %h", $time,
+                        i_packet, n_seen - 2, m_axis_tdata,
+                        beats[n_seen - 2]);
+               n_errors = n_errors + 1;
+            end
+
+            if (m_axis_tlast !== (n_seen == n_beats + 1)) begin
+               $display("%t  packet %0d:  beat %0d:  tlast %b", $time,
+                        i_packet, n_seen, m_axis_tlast);
+               n_errors = n_errors + 1;
+            end
+            n_seen = n_seen + 1;
+         end
+      end
+
+   //===========================================================================
+   // Stimulus
+   //===========================================================================
+   // Sends beats[0 .. n_beats), with random gaps.
+   task send_packet;
+      integer b;
+      begin
+         for (b = 0; b < n_beats; b = b + 1) begin
+            while (($random(seed) & 3) == 0) begin
+               s_axis_tvalid <= 1'b0;
+               @(posedge aclk);
+            end
+            if (b == 0)
+               offered = clocks;
+            s_axis_tdata  <= beats[b];
+            s_axis_tlast  <= b == n_beats - 1;
+            s_axis_tvalid <= 1'b1;
+            @(posedge aclk);
+            while (!s_axis_tready)
+               @(posedge aclk);
+         end
+         s_axis_tvalid <= 1'b0;
+         s_axis_tlast  <= 1'b0;
+      end
+   endtask
+
+   integer b, w;
+
+   initial begin
+      repeat (4) @(posedge aclk);
+      aresetn <= 1'b1;
+      @(posedge aclk);
+
+      for (i_packet = 0; i_packet < N_PACKETS; i_packet = i_packet + 1) begin
+         n_beats = 1 + ($random(seed) & 32'h7FFFFFFF) % MAX_BEATS;
+         for (b = 0; b < n_beats; b = b + 1)
+            for (w = 0; w < 4; w = w + 1)
+               beats[b][32*w +: 32] = $random(seed);
+         n_seen = 0;
+
+         send_packet;
+
+         // Drain.
+         while (n_seen < n_beats + 2)
+            @(posedge aclk);
+         repeat ($random(seed) & 7) @(posedge aclk);
+      end
+
+      if (n_errors == 0)
+         $display("PASS");
+      else
+         $display("FAIL:  %0d errors", n_errors);
+      $finish;
+   end
+
+endmodule
@@ -117,6 +117,33 @@ if { $nRet != 0 } {
    return $nRet
 }
 
+set bCheckModules 1
+if { $bCheckModules == 1 } {
+   set list_check_mods "\ 
+axis_sample_pack\
+axis_shot_header\
+"
+
+   set list_mods_missing ""
+   common::send_msg_id "BD_TCL-006" "INFO" "Checking if the following modules exist in the project's sources: $list_check_mods ."
+
+   foreach mod_vlnv $list_check_mods {
+      if { [can_resolve_reference $mod_vlnv] == 0 } {
+         lappend list_mods_missing $mod_vlnv
+      }
+   }
+
+   if { $list_mods_missing ne "" } {
+      catch {common::send_msg_id "BD_TCL-115" "ERROR" "The following module(s) are not found in the project: $list_mods_missing" }
+      common::send_msg_id "BD_TCL-008" "INFO" "Please add source files for the missing module(s) above."
+      set nRet 1
+   }
+}
+
+if { $nRet != 0 } {
+   return $nRet
+}
+
 ##################################################################
 # DESIGN PROCs
 ##################################################################
@@ -341,6 +368,13 @@ proc create_root_design { parentCell } {
    CONFIG.NUM_OUT_CLKS {3} \
  ] $System_Clock_Sources
 
+  # Create instance: SHOT_HEADER_PRESENT, and set properties
+  set SHOT_HEADER_PRESENT [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlconstant:1.1 SHOT_HEADER_PRESENT ]
+  set_property -dict [ list \
+   CONFIG.CONST_VAL {134217728} \
+   CONFIG.CONST_WIDTH {28} \
+ ] $SHOT_HEADER_PRESENT
+
   # Create instance: TRIG_BUF, and set properties
   set TRIG_BUF [ create_bd_cell -type ip -vlnv xilinx.com:ip:util_ds_buf:2.1 TRIG_BUF ]
   set_property -dict [ list \
@@ -382,6 +416,50 @@ proc create_root_design { parentCell } {
    CONFIG.c_sg_include_stscntrl_strm {0} \
  ] $axi_dma_0
 
+  # Create instance: axis_sample_pack_0, and set properties
+  set block_name axis_sample_pack
+  set block_cell_name axis_sample_pack_0
+  if { [catch {set axis_sample_pack_0 [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
+     catch {common::send_msg_id "BD_TCL-105" "ERROR" "Unable to add referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   } elseif { $axis_sample_pack_0 eq "" } {
+     catch {common::send_msg_id "BD_TCL-106" "ERROR" "Unable to referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   }
+  
+  # Create instance: axis_sample_pack_1, and set properties
+  set block_name axis_sample_pack
+  set block_cell_name axis_sample_pack_1
+  if { [catch {set axis_sample_pack_1 [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
+     catch {common::send_msg_id "BD_TCL-105" "ERROR" "Unable to add referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   } elseif { $axis_sample_pack_1 eq "" } {
+     catch {common::send_msg_id "BD_TCL-106" "ERROR" "Unable to referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   }
+  
+  # Create instance: axis_shot_header_0, and set properties
+  set block_name axis_shot_header
+  set block_cell_name axis_shot_header_0
+  if { [catch {set axis_shot_header_0 [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
+     catch {common::send_msg_id "BD_TCL-105" "ERROR" "Unable to add referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   } elseif { $axis_shot_header_0 eq "" } {
+     catch {common::send_msg_id "BD_TCL-106" "ERROR" "Unable to referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   }
+  
+  # Create instance: axis_shot_header_1, and set properties
+  set block_name axis_shot_header
+  set block_cell_name axis_shot_header_1
+  if { [catch {set axis_shot_header_1 [create_bd_cell -type module -reference $block_name $block_cell_name] } errmsg] } {
+     catch {common::send_msg_id "BD_TCL-105" "ERROR" "Unable to add referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   } elseif { $axis_shot_header_1 eq "" } {
+     catch {common::send_msg_id "BD_TCL-106" "ERROR" "Unable to referenced block <$block_name>. Please add the files for ${block_name}'s definition into the project."}
+     return 1
+   }
+  
   # Create instance: axi_dma_1, and set properties
   set axi_dma_1 [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_dma:7.1 axi_dma_1 ]
   set_property -dict [ list \
@@ -424,7 +502,7 @@ proc create_root_design { parentCell } {
   set_property -dict [ list \
    CONFIG.DIN_FROM {1} \
    CONFIG.DIN_TO {1} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
    CONFIG.DOUT_WIDTH {1} \
  ] $xlslice_adc_enable
 
@@ -433,7 +511,7 @@ proc create_root_design { parentCell } {
   set_property -dict [ list \
    CONFIG.DIN_FROM {0} \
    CONFIG.DIN_TO {0} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
    CONFIG.DOUT_WIDTH {1} \
  ] $xlslice_dac_start
 
@@ -442,7 +520,7 @@ proc create_root_design { parentCell } {
   set_property -dict [ list \
    CONFIG.DIN_FROM {7} \
    CONFIG.DIN_TO {3} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
    CONFIG.DOUT_WIDTH {5} \
  ] $xlslice_leds
 
@@ -451,7 +529,7 @@ proc create_root_design { parentCell } {
   set_property -dict [ list \
    CONFIG.DIN_FROM {15} \
    CONFIG.DIN_TO {8} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
    CONFIG.DOUT_WIDTH {8} \
  ] $xlslice_pmod0
 
@@ -460,7 +538,7 @@ proc create_root_design { parentCell } {
   set_property -dict [ list \
    CONFIG.DIN_FROM {7} \
    CONFIG.DIN_TO {3} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
    CONFIG.DOUT_WIDTH {5} \
  ] $xlslice_pmod1
 
@@ -469,15 +547,24 @@ proc create_root_design { parentCell } {
   set_property -dict [ list \
    CONFIG.DIN_FROM {0} \
    CONFIG.DIN_TO {0} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
  ] $xlslice_pulser_start
 
+  # Create instance: xlslice_sample_format, and set properties
+  set xlslice_sample_format [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlslice:1.0 xlslice_sample_format ]
+  set_property -dict [ list \
+   CONFIG.DIN_FROM {26} \
+   CONFIG.DIN_TO {25} \
+   CONFIG.DIN_WIDTH {28} \
+   CONFIG.DOUT_WIDTH {2} \
+ ] $xlslice_sample_format
+
   # Create instance: xlslice_sdio_ctrl, and set properties
   set xlslice_sdio_ctrl [ create_bd_cell -type ip -vlnv xilinx.com:ip:xlslice:1.0 xlslice_sdio_ctrl ]
   set_property -dict [ list \
    CONFIG.DIN_FROM {2} \
    CONFIG.DIN_TO {2} \
-   CONFIG.DIN_WIDTH {25} \
+   CONFIG.DIN_WIDTH {28} \
    CONFIG.DOUT_WIDTH {1} \
  ] $xlslice_sdio_ctrl
 
@@ -1541,9 +1628,9 @@ proc create_root_design { parentCell } {
    CONFIG.PSU__GPIO1_MIO__IO {MIO 26 .. 51} \
    CONFIG.PSU__GPIO1_MIO__PERIPHERAL__ENABLE {1} \
    CONFIG.PSU__GPIO2_MIO__PERIPHERAL__ENABLE {0} \
-   CONFIG.PSU__GPIO_EMIO_WIDTH {25} \
+   CONFIG.PSU__GPIO_EMIO_WIDTH {28} \
    CONFIG.PSU__GPIO_EMIO__PERIPHERAL__ENABLE {1} \
-   CONFIG.PSU__GPIO_EMIO__PERIPHERAL__IO {25} \
+   CONFIG.PSU__GPIO_EMIO__PERIPHERAL__IO {28} \
    CONFIG.PSU__GPIO_EMIO__WIDTH {[94:0]} \
    CONFIG.PSU__GPU_PP0__POWER__ON {1} \
    CONFIG.PSU__GPU_PP1__POWER__ON {1} \
@@ -2013,8 +2100,12 @@ proc create_root_design { parentCell } {
  ] $zynq_ultra_ps_e_0
 
   # Create interface connections
-  connect_bd_intf_net -intf_net ad9670_axi4_0_m_axis [get_bd_intf_pins ad9670_axi4_0/m_axis] [get_bd_intf_pins axi_dma_0/S_AXIS_S2MM]
-  connect_bd_intf_net -intf_net ad9670_axi4_1_m_axis [get_bd_intf_pins ad9670_axi4_1/m_axis] [get_bd_intf_pins axi_dma_1/S_AXIS_S2MM]
+  connect_bd_intf_net -intf_net ad9670_axi4_0_m_axis [get_bd_intf_pins ad9670_axi4_0/m_axis] [get_bd_intf_pins axis_sample_pack_0/s_axis]
+  connect_bd_intf_net -intf_net ad9670_axi4_1_m_axis [get_bd_intf_pins ad9670_axi4_1/m_axis] [get_bd_intf_pins axis_sample_pack_1/s_axis]
+  connect_bd_intf_net -intf_net axis_sample_pack_0_m_axis [get_bd_intf_pins axis_sample_pack_0/m_axis] [get_bd_intf_pins axis_shot_header_0/s_axis]
+  connect_bd_intf_net -intf_net axis_sample_pack_1_m_axis [get_bd_intf_pins axis_sample_pack_1/m_axis] [get_bd_intf_pins axis_shot_header_1/s_axis]
+  connect_bd_intf_net -intf_net axis_shot_header_0_m_axis [get_bd_intf_pins axi_dma_0/S_AXIS_S2MM] [get_bd_intf_pins axis_shot_header_0/m_axis]
+  connect_bd_intf_net -intf_net axis_shot_header_1_m_axis [get_bd_intf_pins axi_dma_1/S_AXIS_S2MM] [get_bd_intf_pins axis_shot_header_1/m_axis]
   connect_bd_intf_net -intf_net axi_dma_0_M_AXI_S2MM [get_bd_intf_pins axi_dma_0/M_AXI_S2MM] [get_bd_intf_pins zynq_ultra_ps_e_0/S_AXI_HP2_FPD]
   connect_bd_intf_net -intf_net axi_dma_0_M_AXI_SG [get_bd_intf_pins axi_dma_0/M_AXI_SG] [get_bd_intf_pins zynq_ultra_ps_e_0/S_AXI_HP0_FPD]
   connect_bd_intf_net -intf_net axi_dma_1_M_AXI_S2MM [get_bd_intf_pins axi_dma_1/M_AXI_S2MM] [get_bd_intf_pins zynq_ultra_ps_e_0/S_AXI_HP3_FPD]
@@ -2042,6 +2133,7 @@ proc create_root_design { parentCell } {
   connect_bd_net -net REN_CONCAT_dout [get_bd_pins REN_CONCAT/dout] [get_bd_pins REN_OR/Op1]
   connect_bd_net -net RX01_OR_Res [get_bd_ports rx_0] [get_bd_pins RX01_OR/Res]
   connect_bd_net -net RX23_OR_Res [get_bd_ports rx_1] [get_bd_pins RX23_OR/Res]
+  connect_bd_net -net SHOT_HEADER_PRESENT_dout [get_bd_pins SHOT_HEADER_PRESENT/dout] [get_bd_pins zynq_ultra_ps_e_0/emio_gpio_i]
   connect_bd_net -net System_Clock_Sources_clk_out2 [get_bd_pins System_Clock_Sources/clk_out2] [get_bd_pins ad5424_axi4_0/src_clk]
   connect_bd_net -net System_Clock_Sources_clk_out3 [get_bd_pins AFE_CLK_BUF/OBUF_IN] [get_bd_pins System_Clock_Sources/clk_out3]
   connect_bd_net -net TRIG_BUF_OBUF_DS_N [get_bd_ports tx_trig_out_n] [get_bd_pins TRIG_BUF/OBUF_DS_N]
@@ -2098,7 +2190,7 @@ proc create_root_design { parentCell } {
   connect_bd_net -net lvds_fco_p_0_1 [get_bd_ports lvds_fco_p_0] [get_bd_pins ad9670_axi4_0/lvds_fco_p]
   connect_bd_net -net lvds_fco_p_1_1 [get_bd_ports lvds_fco_p_1] [get_bd_pins ad9670_axi4_1/lvds_fco_p]
   connect_bd_net -net otp_n_0_1 [get_bd_ports otp_n] [get_bd_pins hv7321_axi4_0/otp_n] [get_bd_pins hv7321_axi4_1/otp_n] [get_bd_pins hv7321_axi4_2/otp_n] [get_bd_pins hv7321_axi4_3/otp_n]
-  connect_bd_net -net rst_ps8_0_99M_peripheral_aresetn [get_bd_pins ad5424_axi4_0/S_AXI_ARESETN] [get_bd_pins ad9670_axi4_0/S_AXI_ARESETN] [get_bd_pins ad9670_axi4_1/S_AXI_ARESETN] [get_bd_pins axi_dma_0/axi_resetn] [get_bd_pins axi_dma_1/axi_resetn] [get_bd_pins hv7321_axi4_0/S_AXI_ARESETN] [get_bd_pins hv7321_axi4_1/S_AXI_ARESETN] [get_bd_pins hv7321_axi4_2/S_AXI_ARESETN] [get_bd_pins hv7321_axi4_3/S_AXI_ARESETN] [get_bd_pins ps8_0_axi_periph/ARESETN] [get_bd_pins ps8_0_axi_periph/M00_ARESETN] [get_bd_pins ps8_0_axi_periph/M01_ARESETN] [get_bd_pins ps8_0_axi_periph/M02_ARESETN] [get_bd_pins ps8_0_axi_periph/M03_ARESETN] [get_bd_pins ps8_0_axi_periph/M04_ARESETN] [get_bd_pins ps8_0_axi_periph/M05_ARESETN] [get_bd_pins ps8_0_axi_periph/M06_ARESETN] [get_bd_pins ps8_0_axi_periph/M07_ARESETN] [get_bd_pins ps8_0_axi_periph/M08_ARESETN] [get_bd_pins ps8_0_axi_periph/S00_ARESETN] [get_bd_pins rst_ps8_0_99M/peripheral_aresetn]
+  connect_bd_net -net rst_ps8_0_99M_peripheral_aresetn [get_bd_pins ad5424_axi4_0/S_AXI_ARESETN] [get_bd_pins ad9670_axi4_0/S_AXI_ARESETN] [get_bd_pins ad9670_axi4_1/S_AXI_ARESETN] [get_bd_pins axi_dma_0/axi_resetn] [get_bd_pins axi_dma_1/axi_resetn] [get_bd_pins axis_sample_pack_0/aresetn] [get_bd_pins axis_sample_pack_1/aresetn] [get_bd_pins axis_shot_header_0/aresetn] [get_bd_pins axis_shot_header_1/aresetn] [get_bd_pins hv7321_axi4_0/S_AXI_ARESETN] [get_bd_pins hv7321_axi4_1/S_AXI_ARESETN] [get_bd_pins hv7321_axi4_2/S_AXI_ARESETN] [get_bd_pins hv7321_axi4_3/S_AXI_ARESETN] [get_bd_pins ps8_0_axi_periph/ARESETN] [get_bd_pins ps8_0_axi_periph/M00_ARESETN] [get_bd_pins ps8_0_axi_periph/M01_ARESETN] [get_bd_pins ps8_0_axi_periph/M02_ARESETN] [get_bd_pins ps8_0_axi_periph/M03_ARESETN] [get_bd_pins ps8_0_axi_periph/M04_ARESETN] [get_bd_pins ps8_0_axi_periph/M05_ARESETN] [get_bd_pins ps8_0_axi_periph/M06_ARESETN] [get_bd_pins ps8_0_axi_periph/M07_ARESETN] [get_bd_pins ps8_0_axi_periph/M08_ARESETN] [get_bd_pins ps8_0_axi_periph/S00_ARESETN] [get_bd_pins rst_ps8_0_99M/peripheral_aresetn]
   connect_bd_net -net rst_ps8_0_99M_peripheral_reset [get_bd_pins System_Clock_Sources/reset] [get_bd_pins rst_ps8_0_99M/peripheral_reset]
   connect_bd_net -net start_0_1 [get_bd_pins hv7321_axi4_0/start] [get_bd_pins hv7321_axi4_1/start] [get_bd_pins hv7321_axi4_2/start] [get_bd_pins hv7321_axi4_3/start] [get_bd_pins xlslice_pulser_start/Dout]
   connect_bd_net -net util_reduced_logic_0_Res [get_bd_ports ren] [get_bd_pins REN_OR/Res]
@@ -2111,12 +2203,13 @@ proc create_root_design { parentCell } {
   connect_bd_net -net xlslice_leds_Dout [get_bd_ports leds] [get_bd_pins xlslice_leds/Dout]
   connect_bd_net -net xlslice_pmod1_Dout [get_bd_ports pmod1] [get_bd_pins xlslice_pmod1/Dout]
   connect_bd_net -net xlslice_pulser_start1_Dout [get_bd_pins DAC_START_CONCAT/In0] [get_bd_pins xlslice_dac_start/Dout]
-  connect_bd_net -net zynq_ultra_ps_e_0_emio_gpio_o [get_bd_pins xlslice_adc_enable/Din] [get_bd_pins xlslice_dac_start/Din] [get_bd_pins xlslice_leds/Din] [get_bd_pins xlslice_pmod0/Din] [get_bd_pins xlslice_pmod1/Din] [get_bd_pins xlslice_pulser_start/Din] [get_bd_pins xlslice_sdio_ctrl/Din] [get_bd_pins zynq_ultra_ps_e_0/emio_gpio_o]
+  connect_bd_net -net xlslice_sample_format_Dout [get_bd_pins axis_sample_pack_0/i_format] [get_bd_pins axis_sample_pack_1/i_format] [get_bd_pins xlslice_sample_format/Dout]
+  connect_bd_net -net zynq_ultra_ps_e_0_emio_gpio_o [get_bd_pins xlslice_adc_enable/Din] [get_bd_pins xlslice_dac_start/Din] [get_bd_pins xlslice_leds/Din] [get_bd_pins xlslice_pmod0/Din] [get_bd_pins xlslice_pmod1/Din] [get_bd_pins xlslice_pulser_start/Din] [get_bd_pins xlslice_sample_format/Din] [get_bd_pins xlslice_sdio_ctrl/Din] [get_bd_pins zynq_ultra_ps_e_0/emio_gpio_o]
   connect_bd_net -net zynq_ultra_ps_e_0_emio_spi0_m_o [get_bd_pins AFE_SDIO_BUF/IOBUF_IO_I] [get_bd_pins zynq_ultra_ps_e_0/emio_spi0_m_o]
   connect_bd_net -net zynq_ultra_ps_e_0_emio_spi0_sclk_o [get_bd_ports afe_sck] [get_bd_pins zynq_ultra_ps_e_0/emio_spi0_sclk_o]
   connect_bd_net -net zynq_ultra_ps_e_0_emio_spi0_ss1_o_n [get_bd_ports afe1_csn] [get_bd_pins zynq_ultra_ps_e_0/emio_spi0_ss1_o_n]
   connect_bd_net -net zynq_ultra_ps_e_0_emio_spi0_ss_o_n [get_bd_ports afe0_csn] [get_bd_pins zynq_ultra_ps_e_0/emio_spi0_ss_o_n]
-  connect_bd_net -net zynq_ultra_ps_e_0_pl_clk0 [get_bd_pins System_Clock_Sources/clk_in1] [get_bd_pins ad5424_axi4_0/S_AXI_ACLK] [get_bd_pins ad9670_axi4_0/S_AXI_ACLK] [get_bd_pins ad9670_axi4_0/m_axis_aclk] [get_bd_pins ad9670_axi4_1/S_AXI_ACLK] [get_bd_pins ad9670_axi4_1/m_axis_aclk] [get_bd_pins axi_dma_0/m_axi_s2mm_aclk] [get_bd_pins axi_dma_0/m_axi_sg_aclk] [get_bd_pins axi_dma_0/s_axi_lite_aclk] [get_bd_pins axi_dma_1/m_axi_s2mm_aclk] [get_bd_pins axi_dma_1/m_axi_sg_aclk] [get_bd_pins axi_dma_1/s_axi_lite_aclk] [get_bd_pins hv7321_axi4_0/S_AXI_ACLK] [get_bd_pins hv7321_axi4_1/S_AXI_ACLK] [get_bd_pins hv7321_axi4_2/S_AXI_ACLK] [get_bd_pins hv7321_axi4_3/S_AXI_ACLK] [get_bd_pins ps8_0_axi_periph/ACLK] [get_bd_pins ps8_0_axi_periph/M00_ACLK] [get_bd_pins ps8_0_axi_periph/M01_ACLK] [get_bd_pins ps8_0_axi_periph/M02_ACLK] [get_bd_pins ps8_0_axi_periph/M03_ACLK] [get_bd_pins ps8_0_axi_periph/M04_ACLK] [get_bd_pins ps8_0_axi_periph/M05_ACLK] [get_bd_pins ps8_0_axi_periph/M06_ACLK] [get_bd_pins ps8_0_axi_periph/M07_ACLK] [get_bd_pins ps8_0_axi_periph/M08_ACLK] [get_bd_pins ps8_0_axi_periph/S00_ACLK] [get_bd_pins rst_ps8_0_99M/slowest_sync_clk] [get_bd_pins zynq_ultra_ps_e_0/maxihpm0_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/pl_clk0] [get_bd_pins zynq_ultra_ps_e_0/saxihp0_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/saxihp1_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/saxihp2_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/saxihp3_fpd_aclk]
+  connect_bd_net -net zynq_ultra_ps_e_0_pl_clk0 [get_bd_pins System_Clock_Sources/clk_in1] [get_bd_pins ad5424_axi4_0/S_AXI_ACLK] [get_bd_pins ad9670_axi4_0/S_AXI_ACLK] [get_bd_pins ad9670_axi4_0/m_axis_aclk] [get_bd_pins ad9670_axi4_1/S_AXI_ACLK] [get_bd_pins ad9670_axi4_1/m_axis_aclk] [get_bd_pins axi_dma_0/m_axi_s2mm_aclk] [get_bd_pins axi_dma_0/m_axi_sg_aclk] [get_bd_pins axi_dma_0/s_axi_lite_aclk] [get_bd_pins axi_dma_1/m_axi_s2mm_aclk] [get_bd_pins axi_dma_1/m_axi_sg_aclk] [get_bd_pins axi_dma_1/s_axi_lite_aclk] [get_bd_pins axis_sample_pack_0/aclk] [get_bd_pins axis_sample_pack_1/aclk] [get_bd_pins axis_shot_header_0/aclk] [get_bd_pins axis_shot_header_1/aclk] [get_bd_pins hv7321_axi4_0/S_AXI_ACLK] [get_bd_pins hv7321_axi4_1/S_AXI_ACLK] [get_bd_pins hv7321_axi4_2/S_AXI_ACLK] [get_bd_pins hv7321_axi4_3/S_AXI_ACLK] [get_bd_pins ps8_0_axi_periph/ACLK] [get_bd_pins ps8_0_axi_periph/M00_ACLK] [get_bd_pins ps8_0_axi_periph/M01_ACLK] [get_bd_pins ps8_0_axi_periph/M02_ACLK] [get_bd_pins ps8_0_axi_periph/M03_ACLK] [get_bd_pins ps8_0_axi_periph/M04_ACLK] [get_bd_pins ps8_0_axi_periph/M05_ACLK] [get_bd_pins ps8_0_axi_periph/M06_ACLK] [get_bd_pins ps8_0_axi_periph/M07_ACLK] [get_bd_pins ps8_0_axi_periph/M08_ACLK] [get_bd_pins ps8_0_axi_periph/S00_ACLK] [get_bd_pins rst_ps8_0_99M/slowest_sync_clk] [get_bd_pins zynq_ultra_ps_e_0/maxihpm0_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/pl_clk0] [get_bd_pins zynq_ultra_ps_e_0/saxihp0_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/saxihp1_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/saxihp2_fpd_aclk] [get_bd_pins zynq_ultra_ps_e_0/saxihp3_fpd_aclk]
   connect_bd_net -net zynq_ultra_ps_e_0_pl_resetn0 [get_bd_pins rst_ps8_0_99M/ext_reset_in] [get_bd_pins zynq_ultra_ps_e_0/pl_resetn0]
 
   # Create address segments
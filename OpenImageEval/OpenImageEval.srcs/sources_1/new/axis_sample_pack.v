@@ -0,0 +1,165 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+// Create Date:   2026-10-19
+// Module Name:   axis_sample_pack
+// Project Name:  Open Imager
+// Description:   Packs the 16-bit samples of the ad9670_axi4 stream into
+//                14 or 12 bits each, on their way to the AXI DMA, so that
+//                less memory and bandwidth is used for each shot.
+//
+//                Each input beat is one row:  eight channels of 16 bits,
+//                MSB justified.  The top i_format bits of each sample are
+//                kept, and packed LSB first with no gaps across the beats
+//                of a packet (OI_SAMPLE_FORMAT_* in open_image_protocol.h).
+//                A row packs into 7 (14-bit) or 6 (12-bit) half-words, so
+//                the fill of the accumulator is always a whole number of
+//                half-words; the shift is then an 8-way mux, not a barrel
+//                shifter.  16-bit passes through with one cycle of latency.
+//
+//                The format is sampled at the first beat of each packet.
+//                Packets of a multiple of 8 rows end on a whole beat; any
+//                other packet has its last beat zero-padded, and loses
+//                whatever did not fit.  Full rate:  one beat in and at most
+//                one beat out per clock.
+//
+// Dependencies:  none
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+module axis_sample_pack
+  (
+   (* X_INTERFACE_PARAMETER = "ASSOCIATED_BUSIF s_axis:m_axis, ASSOCIATED_RESET aresetn" *)
+   input             aclk,
+   (* X_INTERFACE_PARAMETER = "POLARITY ACTIVE_LOW" *)
+   input             aresetn,
+
+   // OI_SAMPLE_FORMAT_*:  0 = 16-bit, 1 = 14-bit, 2 = 12-bit
+   input      [1:0]  i_format,
+
+   input    [127:0]  s_axis_tdata,
+   input             s_axis_tvalid,
+   input             s_axis_tlast,
+   output            s_axis_tready,
+
+   output   [127:0]  m_axis_tdata,
+   output    [15:0]  m_axis_tkeep,
+   output            m_axis_tvalid,
+   output            m_axis_tlast,
+   input             m_axis_tready
+   );
+
+   //===========================================================================
+   // Constants
+   //===========================================================================
+   localparam  FORMAT_16 = 2'd0;
+   localparam  FORMAT_14 = 2'd1;
+   localparam  FORMAT_12 = 2'd2;
+
+   //===========================================================================
+   // Register declarations
+   //===========================================================================
+   reg         in_packet;     // a beat of the current packet has been taken
+   reg  [1:0]  format_q;      // format of the current packet
+   reg [255:0] acc;           // bits not yet sent, LSB first
+   reg  [3:0]  fill;          // half-words held in acc (0 to 7)
+
+   reg [127:0] m_tdata;
+   reg         m_tvalid;
+   reg         m_tlast;
+
+   //===========================================================================
+   // Packing of one row
+   //===========================================================================
+   wire  [1:0] format = in_packet ? format_q : i_format;
+   wire        take   = s_axis_tvalid && s_axis_tready;
+
+   wire [111:0] row_14;
+   wire  [95:0] row_12;
+
+   genvar i;
+   generate
+      for (i = 0; i < 8; i = i + 1) begin : g_lane
+         assign row_14[14*i +: 14] = s_axis_tdata[16*i + 2 +: 14];
+         assign row_12[12*i +: 12] = s_axis_tdata[16*i + 4 +: 12];
+      end
+   endgenerate
+
+   // The row, and its width in half-words:
+   reg [127:0] row;
+   reg  [3:0]  row_hw;
+   always @(*)
+      case (format)
+         FORMAT_14: begin row = {16'b0, row_14}; row_hw = 4'd7; end
+         FORMAT_12: begin row = {32'b0, row_12}; row_hw = 4'd6; end
+         default:   begin row = s_axis_tdata;    row_hw = 4'd8; end
+      endcase
+
+   // Appended to what is held; fill is at most 7, so this is a mux.
+   reg [255:0] appended;
+   always @(*)
+      case (fill[2:0])
+         3'd0:    appended = acc | {128'b0, row};
+         3'd1:    appended = acc | {112'b0, row,  16'b0};
+         3'd2:    appended = acc | { 96'b0, row,  32'b0};
+         3'd3:    appended = acc | { 80'b0, row,  48'b0};
+         3'd4:    appended = acc | { 64'b0, row,  64'b0};
+         3'd5:    appended = acc | { 48'b0, row,  80'b0};
+         3'd6:    appended = acc | { 32'b0, row,  96'b0};
+         default: appended = acc | { 16'b0, row, 112'b0};
+      endcase
+
+   wire  [4:0] total = fill + row_hw;
+   wire        emit  = (total >= 5'd8) || s_axis_tlast;
+
+   //===========================================================================
+   // Sequencing
+   //===========================================================================
+   assign s_axis_tready = !m_tvalid || m_axis_tready;
+
+   always @(posedge aclk)
+      if (aresetn == 1'b0) begin
+         in_packet <= 1'b0;
+         format_q  <= FORMAT_16;
+         acc       <= 256'b0;
+         fill      <= 4'd0;
+      end
+      else if (take) begin
+         in_packet <= !s_axis_tlast;
+         if (!in_packet)
+            format_q <= i_format;
+
+         if (s_axis_tlast) begin
+            acc  <= 256'b0;
+            fill <= 4'd0;
+         end
+         else if (emit) begin
+            acc  <= {128'b0, appended[255:128]};
+            fill <= total - 5'd8;
+         end
+         else begin
+            acc  <= appended;
+            fill <= total[3:0];
+         end
+      end
+
+   always @(posedge aclk)
+      if (aresetn == 1'b0) begin
+         m_tdata  <= 128'b0;
+         m_tvalid <= 1'b0;
+         m_tlast  <= 1'b0;
+      end
+      else if (take && emit) begin
+         m_tdata  <= appended[127:0];
+         m_tvalid <= 1'b1;
+         m_tlast  <= s_axis_tlast;
+      end
+      else if (m_axis_tready) begin
+         m_tvalid <= 1'b0;
+      end
+
+   assign m_axis_tdata  = m_tdata;
+   assign m_axis_tkeep  = 16'hFFFF;
+   assign m_axis_tvalid = m_tvalid;
+   assign m_axis_tlast  = m_tlast;
+
+endmodule
@@ -0,0 +1,111 @@
+//////////////////////////////////////////////////////////////////////////////////
+//
+// Create Date:   2026-10-19
+// Module Name:   axis_shot_header
+// Project Name:  Open Imager
+// Description:   Prepends a header (OI_SHOT_HEADER in open_image_protocol.h)
+//                to each packet of the sample stream, on its way to the AXI
+//                DMA, so that each shot in DDR says where it came from.
+//
+//                The first beat is written here:  OI_SHOT_MAGIC, the count
+//                of packets passed since reset, and the count of stream
+//                clocks when the packet's first beat arrived.  The second
+//                beat is zero, and is filled in by the firmware once the
+//                transfer is done.
+//
+//                Sits after axis_sample_pack, so that the header is never
+//                packed.  Costs two clocks per packet.
+//
+// Dependencies:  none
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+module axis_shot_header
+  (
+   (* X_INTERFACE_PARAMETER = "ASSOCIATED_BUSIF s_axis:m_axis, ASSOCIATED_RESET aresetn" *)
+   input             aclk,
+   (* X_INTERFACE_PARAMETER = "POLARITY ACTIVE_LOW" *)
+   input             aresetn,
+
+   input    [127:0]  s_axis_tdata,
+   input             s_axis_tvalid,
+   input             s_axis_tlast,
+   output            s_axis_tready,
+
+   output   [127:0]  m_axis_tdata,
+   output    [15:0]  m_axis_tkeep,
+   output            m_axis_tvalid,
+   output            m_axis_tlast,
+   input             m_axis_tready
+   );
+
+   //===========================================================================
+   // Constants
+   //===========================================================================
+   localparam  MAGIC = 32'h4853494F;   // "OISH"
+
+   localparam  S_IDLE   = 2'd0;
+   localparam  S_FIXED  = 2'd1;        // sending the first beat of the header
+   localparam  S_BLANK  = 2'd2;        // sending the second
+   localparam  S_DATA   = 2'd3;
+
+   //===========================================================================
+   // Register declarations
+   //===========================================================================
+   reg  [1:0]  state;
+   reg [63:0]  clocks;                 // free-running timestamp
+   reg [31:0]  n_packets;              // packets passed
+   reg [127:0] header;
+
+   //===========================================================================
+   // Sequencing
+   //===========================================================================
+   always @(posedge aclk)
+      if (aresetn == 1'b0)
+         clocks <= 64'b0;
+      else
+         clocks <= clocks + 1;
+
+   always @(posedge aclk)
+      if (aresetn == 1'b0) begin
+         state     <= S_IDLE;
+         n_packets <= 32'b0;
+         header    <= 128'b0;
+      end
+      else
+         case (state)
+            S_IDLE:
+               // Hold the first beat until the header has gone.
+               if (s_axis_tvalid) begin
+                  header <= {clocks, n_packets, MAGIC};
+                  state  <= S_FIXED;
+               end
+            S_FIXED:
+               if (m_axis_tready)
+                  state <= S_BLANK;
+            S_BLANK:
+               if (m_axis_tready)
+                  state <= S_DATA;
+            default:
+               if (s_axis_tvalid && m_axis_tready && s_axis_tlast) begin
+                  n_packets <= n_packets + 1;
+                  state     <= S_IDLE;
+               end
+         endcase
+
+   //===========================================================================
+   // Outputs
+   //===========================================================================
+   wire is_data = (state == S_DATA);
+
+   assign s_axis_tready = is_data && m_axis_tready;
+
+   assign m_axis_tdata  = (state == S_FIXED) ? header
+                        : (state == S_BLANK) ? 128'b0
+                        : s_axis_tdata;
+   assign m_axis_tkeep  = 16'hFFFF;
+   assign m_axis_tvalid = (state == S_FIXED) || (state == S_BLANK)
+                        || (is_data && s_axis_tvalid);
+   assign m_axis_tlast  = is_data && s_axis_tlast;
+
+endmodule
@@ -0,0 +1,174 @@
+/*
+	oiAggregator.h
+
+	Host-side aggregation of several Open Imagers into one array of
+	nUnits * OI_N_CHAN elements:  element e is channel e % OI_N_CHAN of unit
+	e / OI_N_CHAN.  A frame of the array (ArrayProgram) is split into one
+	frame for each unit, holding that unit's channels of every shot; the
+	units are armed together, and each one's data are read and merged into
+	the one channel space.  The units must record raw data, not IQ or
+	beamformed lines.
+
+	The units share no trigger, so each records its shots on its own
+	clock.  The shots' headers tell whether they line up:  each unit's
+	shots must be its frame's, good, and consecutive in its sequence; and
+	the time between them must agree with unit 0's, within a tolerance, so
+	that shot s of every unit is one shot of the array.  That needs the
+	shots' timestamps, which only bitstreams with the shot-header block
+	write; without them every timestamp is zero, and the units' frames are
+	refused unless isUntimedAllowed, as nothing shows that they line up.
+
+	Each unit has a thread, which waits for its frame to be recorded, then
+	reads and merges it, so that the host keeps up with the units as more
+	are added.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_AGGREGATOR_H__
+#define __OI_AGGREGATOR_H__
+
+#include "oiClient.h"
+#include "oiDeinterleave.h"
+#include "oiFrameProgram.h"
+
+#include "open_image_protocol.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+class ArrayProgram {
+public:
+	explicit ArrayProgram(uint32_t nUnits, uint32_t handle = 0u);
+
+	void clear();
+	void setHandle(uint32_t h) { handle = h; }
+
+	// Adds a shot of the array:  element e transmits pTx[e] and receives as
+	//  pRx[e], for each of getNElements().  The rest of the receive
+	//  settings, which each unit applies to all of its channels, are those
+	//  of settings.rx; its channels are ignored.  Returns false if the
+	//  frame already has OI_MAX_N_SHOTS.
+	bool addShot(const OI_SHOT& settings, const OI_TX_CHANNEL* pTx,
+			const OI_RX_CHANNEL* pRx);
+
+	// Builds each unit's frame.  Returns OI_ERR_NONE, or the first error
+	//  that a unit would refuse its frame with (see FrameProgram::build).
+	oi_error_t build();
+
+	uint32_t getHandle() const { return handle; }
+	uint32_t getNUnits() const { return (uint32_t) units.size(); }
+	uint32_t getNElements() const { return getNUnits() * OI_N_CHAN; }
+	uint32_t getNShots() const { return units.front().getNShots(); }
+
+	// The frame of one unit.
+	const FrameProgram& getUnit(uint32_t iUnit) const { return units[iUnit]; }
+
+private:
+	uint32_t handle;
+	std::vector<FrameProgram> units;
+};
+
+struct AggregatorOptions {
+	// Most sample clocks by which any unit's shots may drift from unit 0's
+	//  over a frame, from the first shot:  the difference of the units'
+	//  clocks, and of when each starts a shot.
+	uint32_t maxSkewClocks = 64u;
+
+	// Whether the frames of units that do not timestamp their shots (all
+	//  zero, or all the same) are accepted, without being aligned.
+	bool isUntimedAllowed = false;
+
+	// Between each unit's polls of its status while it records; polling
+	//  faster only takes time from the device.
+	std::chrono::microseconds pollPeriod{ 100 };
+	std::chrono::milliseconds recordTimeout{ 5000 };
+
+	ClientOptions client;                // of each unit's connection
+};
+
+// How a frame of the array was acquired.
+struct ArrayResult {
+	bool ok = false;                     // every unit's, read and aligned
+	bool isTimed = false;                // every unit's shots timestamped
+	uint32_t
+		nBadShots = 0u,      // of the units:  flagged, or out of sequence
+		nMisaligned = 0u,    // shots of the array beyond maxSkewClocks
+		maxSkewClocks = 0u;  // the most that any unit's shots drifted
+	double armUs = 0.0;      // until every unit had acknowledged its frame
+};
+
+class Aggregator {
+public:
+	explicit Aggregator(const AggregatorOptions& options = AggregatorOptions());
+	~Aggregator();
+
+	Aggregator(const Aggregator&) = delete;
+	Aggregator& operator=(const Aggregator&) = delete;
+
+	// Connects to the units, in the order of their elements, each as
+	//  "host" or "host:port".  Returns false if any cannot be, or it is
+	//  already connected.
+	bool connect(const std::vector<std::string>& hosts);
+
+	// Closes every unit's connection.
+	void close();
+
+	uint32_t getNUnits() const { return (uint32_t) units.size(); }
+
+	// The lanes of a unit's ADCs (see oiDeinterleave.h); the board's
+	//  until set.
+	void setChannelMap(uint32_t iUnit, const ChannelMap& map);
+
+	// Queues a built frame on every unit at once, waits until each has
+	//  recorded it, and reads and merges the data:  element e of shot s
+	//  starts at pOut + (s*nElements + e)*stride, with the shot's nSamples.
+	//  The result is not ok if the program is not for these units, or the
+	//  stride is too short.
+	ArrayResult acquire(const ArrayProgram& program, int16_t* pOut,
+			std::size_t stride);
+	ArrayResult acquire(const ArrayProgram& program, float* pOut,
+			std::size_t stride);
+
+private:
+	struct Unit;
+
+	ArrayResult run(const ArrayProgram& program, void* pOut, bool isFloat,
+			std::size_t stride);
+	void runUnit(Unit& unit);
+	bool recordUnit(Unit& unit);
+	void checkUnit(Unit& unit);
+	void mergeUnit(Unit& unit);
+	void align(ArrayResult& result) const;
+	void work(Unit& unit, uint64_t seen);
+
+	const AggregatorOptions options;
+	std::vector<std::unique_ptr<Unit>> units;
+
+	/////  Frame being acquired  /////
+	const ArrayProgram* pProgram = nullptr;
+	std::vector<std::size_t> shotOffset;     // in each unit's ADC data
+	void* pOut = nullptr;
+	bool isFloat = false;
+	std::size_t stride = 0u;
+
+	/////  Units' threads  /////
+	std::mutex mutex;
+	std::condition_variable start, done;
+	uint64_t generation = 0u;
+	unsigned nRunning = 0u;
+	bool isStopping = false;
+};
+
+} // namespace oi
+
+#endif /* __OI_AGGREGATOR_H__ */
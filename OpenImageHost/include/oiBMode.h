@@ -0,0 +1,156 @@
+/*
+	oiBMode.h
+
+	Host-side conversion of beamformed lines into a B-mode image:  envelope
+	detection, log compression and scan conversion, fused.  The output is
+	cut into tiles; for each, the envelope of just the lines and samples
+	that it needs is found (with a Hilbert FIR), compressed, and kept in a
+	small buffer from which the tile's pixels are interpolated, so the
+	whole frame is passed over once.  Linear, sector and curvilinear scans
+	are converted alike, from each line's origin and angle.
+
+	The interpolation tables are computed by plan, and kept for as long as
+	the geometry is the same; a frame allocates nothing.  Each step has an
+	AVX2 kernel, chosen at run time, that matches the scalar version.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_BMODE_H__
+#define __OI_BMODE_H__
+
+#include "oiDas.h"
+#include "oiFrameProgram.h"
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+// Where the lines lie.  Line i starts at (originXUm[i], originZUm[i]),
+//  relative to the centre of the array face, and runs at angleDeg[i] from
+//  straight down, positive toward the last element; its sample j is
+//  startUm + j*stepUm along it.  Lines are in order across the image.
+struct ScanGeometry {
+	std::vector<float>
+		originXUm,
+		originZUm,
+		angleDeg;
+	float
+		startUm = 0.0f,
+		stepUm = 0.0f;
+	uint32_t nSamples = 0u;
+
+	bool operator==(const ScanGeometry& o) const
+	{
+		return originXUm == o.originXUm && originZUm == o.originZUm
+				&& angleDeg == o.angleDeg && startUm == o.startUm
+				&& stepUm == o.stepUm && nSamples == o.nSamples;
+	}
+};
+
+// The pixels:  width by height, from (xStartUm, zStartUm) at the top left.
+struct ScanGrid {
+	uint32_t
+		width = 0u,
+		height = 0u;
+	float
+		xStartUm = 0.0f,
+		zStartUm = 0.0f,
+		pixelUm = 0.0f;
+
+	bool operator==(const ScanGrid& o) const
+	{
+		return width == o.width && height == o.height
+				&& xStartUm == o.xStartUm && zStartUm == o.zStartUm
+				&& pixelUm == o.pixelUm;
+	}
+};
+
+// An envelope of topDb (20 log10 of its amplitude) is shown as 255, and
+//  one dynamicRangeDb below it, or less, as 0.
+struct BModeCompression {
+	float
+		topDb = 80.0f,
+		dynamicRangeDb = 60.0f;
+};
+
+class BModeConverter {
+public:
+	explicit BModeConverter(bool isSimd = true);
+
+	// Computes the tables from lines to pixels, unless they are already of
+	//  this geometry and grid.  Returns false if there are fewer than two
+	//  lines or samples, or no pixels.
+	bool plan(const ScanGeometry& geometry, const ScanGrid& grid);
+
+	// Converts one frame of lines, line i starting at pLines + i*stride,
+	//  into pImage:  the grid's rows, top to bottom, of 'width' pixels.
+	//  Pixels outside the scan are zero.  Returns false if nothing is
+	//  planned, or the stride is too short.
+	bool convert(
+			uint8_t* pImage,
+			const float* pLines,
+			std::size_t stride,
+			const BModeCompression& compression
+	);
+
+private:
+	// The lines and samples that a tile of pixels needs.
+	struct Tile {
+		uint32_t
+			x0, y0, width, height,
+			line0, nLines,
+			sample0, nSamples;
+		std::size_t iFirstPixel;     // in the tables
+	};
+
+	void compress(
+			const Tile& tile,
+			const float* pLines,
+			std::size_t stride,
+			float scale,
+			float shift
+	);
+
+	const bool isSimd;
+
+	ScanGeometry geometry;
+	ScanGrid grid;
+	std::vector<Tile> tiles;
+
+	// For each pixel, tile by tile and row by row within each:  its offset
+	//  in the tile's box of compressed samples (or -1, outside the scan),
+	//  and its fractions between lines and between samples.
+	std::vector<int32_t> offset;
+	std::vector<float> lineFrac, sampleFrac;
+
+	// The Hilbert filter's taps, for odd offsets 1, 3, ...
+	std::vector<float> taps;
+
+	// Scratch, sized by plan:  one line with the filter's margins, and the
+	//  compressed box of a tile.
+	std::vector<float> padded, box;
+};
+
+//********************************  Functions  *******************************//
+
+// The lines of a beamformed image (oiDas.h):  its columns, straight down.
+ScanGeometry scanOfImage(const DasImage& image);
+
+// One line per shot of the program, of the shots' nSamples, at the depth
+//  that the round trip gives each sample.  The lines' origins and angles
+//  are zero, for the caller to set.
+ScanGeometry scanOfFrame(
+		const FrameProgram& program,
+		float speedOfSound,
+		double sampleRateHz
+);
+
+} // namespace oi
+
+#endif /* __OI_BMODE_H__ */
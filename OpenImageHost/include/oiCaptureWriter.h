@@ -0,0 +1,146 @@
+/*
+	oiCaptureWriter.h
+
+	Writes frames to a recording (oiRecording.h) as fast as the disk takes
+	them, from a ring of page-aligned buffers allocated once.  The thread
+	that receives a frame takes a free buffer, fills it as a frame of the
+	recording, and commits it; a writer thread writes it with io_uring,
+	bypassing the page cache (O_DIRECT), and frees it when the write
+	completes.  Buffers pass between the threads through lock-free queues.
+
+	Writes may complete out of order; the header's frame count is
+	rewritten, once the frames before it are all on disk, so that readers
+	see only complete frames.  The file is extended ahead of the writes, so
+	that they do not each extend it.  Where io_uring or O_DIRECT are not
+	available, frames are written with pwrite, through the page cache.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_CAPTURE_WRITER_H__
+#define __OI_CAPTURE_WRITER_H__
+
+#include "oiFrameProgram.h"
+#include "oiRecording.h"
+#include "oiSpscQueue.h"
+#include "oiUring.h"
+
+#include "open_image_protocol.h"
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+struct CaptureWriterOptions {
+	std::size_t nBuffers = 32u;          // frames received or being written
+	unsigned nWrites = 8u;               // in flight at once
+	bool isDirect = true;                // O_DIRECT, where it can be
+	bool isUring = true;                 // io_uring, where it can be
+	uint64_t extendBytes = 256u << 20;   // by which the file is extended
+};
+
+// Counts since the recording was created.
+struct CaptureWriterStats {
+	uint64_t
+		nCommitted,      // frames given to write
+		nWritten,        // frames on disk
+		nBytesWritten,
+		nErrors;         // failed writes; none is counted after one
+	std::size_t maxQueued;   // most frames waiting for a write
+};
+
+class CaptureWriter {
+public:
+	explicit CaptureWriter(
+			const CaptureWriterOptions& options = CaptureWriterOptions());
+	~CaptureWriter() { close(); }
+
+	CaptureWriter(const CaptureWriter&) = delete;
+	CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+	// Creates (or replaces) a recording of frames of the program, and
+	//  starts writing.  Returns false if it cannot.
+	bool create(const std::string& path, const FrameProgram& program);
+
+	// Of one thread:  a free buffer, or null if every one is in use.  The
+	//  data of ADC i go at getAdcData(pBuffer, i).
+	uint8_t* acquire();
+	uint8_t* getAdcData(uint8_t* pBuffer, uint32_t iAdc) const
+	{
+		return pBuffer + header.adcOffset[iAdc];
+	}
+
+	// Of one thread, which may be other than acquire's:  gives a filled
+	//  buffer to be written, or one not filled back.
+	void commit(uint8_t* pBuffer, uint64_t receivedNs);
+	void discard(uint8_t* pBuffer);
+
+	// Writes what is committed, then the index, and closes the file.
+	//  Returns false if any write failed.
+	bool close();
+
+	bool isOpen() const { return fd >= 0; }
+	bool isDirect() const { return isFileDirect; }
+	bool isUring() const { return isRingUsed; }
+	std::size_t getFrameBytes() const { return header.frameStride; }
+	std::size_t getNQueued() const { return ready.size(); }
+	CaptureWriterStats getStats() const;
+
+private:
+	struct Item {
+		uint32_t iBuffer;
+		bool isFilled;
+		uint64_t receivedNs;
+	};
+
+	void push(const Item& item);
+	void write();
+	void writeRing();
+	void writeSync();
+	void wake();
+	void extendTo(uint64_t end);
+	bool writeAt(const void* pData, std::size_t nBytes, uint64_t offset);
+
+	const CaptureWriterOptions options;
+
+	int fd = -1;
+	int wakeFd = -1;                     // eventfd, signalled by push
+	bool isFileDirect = false;
+	bool isRingUsed = false;
+	std::unique_ptr<Uring> ring;
+	RecordingHeader header = {};
+	std::vector<std::size_t> shotOffset;
+
+	// The buffers, and the header's page; page-aligned.
+	uint8_t* pBuffers = nullptr;
+	uint8_t* pHeaderPage = nullptr;
+
+	SpscQueue<uint32_t> idle;            // writer to acquire
+	SpscQueue<Item> ready;               // commit to writer
+	std::thread writer;
+	std::atomic<bool> isStopping{ false };
+
+	/////  Of the writer thread  /////
+	std::vector<RecordingIndexEntry> index;
+	std::vector<uint64_t> frameOf;       // that each buffer holds
+	uint64_t extendedTo = 0u;
+	uint64_t wakeCount = 0u;            // read from wakeFd
+
+	/////  Counts  /////
+	std::atomic<uint64_t>
+		nCommitted{ 0u },
+		nWritten{ 0u },
+		nErrors{ 0u };
+	std::atomic<std::size_t> maxQueued{ 0u };
+};
+
+} // namespace oi
+
+#endif /* __OI_CAPTURE_WRITER_H__ */
@@ -0,0 +1,176 @@
+/*
+	oiClient.h
+
+	Host-side client of the Open Image protocol.  Requests are sent as soon
+	as they are made, without waiting for the replies to earlier ones; the
+	device answers each request once, in order, so a thread receives the
+	replies and completes the requests in turn.  Frame data are read in
+	many OI_CMD_GET_FRAME requests in flight at once, for both ADCs, and
+	received directly into buffers of the caller.
+
+	Each request completes either through a callback, which runs on the
+	receiving thread and so must not wait on other requests, or through a
+	future.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_CLIENT_H__
+#define __OI_CLIENT_H__
+
+#include "oiFrameProgram.h"
+
+#include "open_image_protocol.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+// The device's answer to one request.  A code of zero means that there
+//  was none:  the connection failed or was closed first.
+struct Reply {
+	uint8_t code = 0u;                   // OI_RES_*
+	oi_error_t error = OI_ERR_NONE;      // of OI_RES_NACK
+	std::size_t nBytes = 0u;             // of the payload
+
+	// The payload, unless it was received into the caller's buffer.
+	std::vector<uint8_t> data;
+
+	bool isAck() const { return code == OI_RES_ACK; }
+
+	// Copies out a payload of the given type; false if it is not one.
+	template <class T>
+	bool get(T& out) const
+	{
+		const bool ok = data.size() == sizeof(T);
+		if (ok) {
+			std::memcpy(&out, data.data(), sizeof(T));
+		} else {
+			// Wrong reply.
+		}
+		return ok;
+	}
+};
+
+// Where the data of a frame are received:  the first nBytes of each ADC's
+//  data, as OI_CMD_GET_FRAME serves them, into pData.  An ADC with no
+//  bytes is skipped.
+struct FrameBuffers {
+	uint8_t* pData[OI_RX_N_CHIPS];
+	std::size_t nBytes[OI_RX_N_CHIPS];
+};
+
+struct FrameResult {
+	bool ok = false;                     // every byte arrived
+	oi_error_t error = OI_ERR_NONE;      // the first NACK, if any
+	std::size_t nBytes[OI_RX_N_CHIPS] = {};
+};
+
+struct ClientOptions {
+	// Most requests sent and not yet answered; more wait for room.
+	std::size_t maxInFlight = 64u;
+
+	// Bytes asked for by each OI_CMD_GET_FRAME, up to OI_MAX_REPLY_BYTES
+	//  (more are asked for as that).  Two of these fit in the device's TCP
+	//  send buffer, so that one may be sent while the other is
+	//  acknowledged.
+	std::size_t chunkBytes = 4096u;
+};
+
+class Client {
+public:
+	using Callback = std::function<void(const Reply&)>;
+	using FrameCallback = std::function<void(const FrameResult&)>;
+
+	explicit Client(const ClientOptions& options = ClientOptions());
+	~Client();
+
+	Client(const Client&) = delete;
+	Client& operator=(const Client&) = delete;
+
+	// Connects to a device by name or address.  Returns false if it
+	//  cannot, or is already connected.
+	bool connect(const std::string& host, uint16_t port = OI_TCP_PORT);
+
+	// Closes the connection.  Requests still waiting complete with no
+	//  reply.
+	void close();
+
+	bool isConnected() const;
+
+	// Sends one request.  'done' is called exactly once:  with the reply,
+	//  or at once, on this thread, if the request cannot be sent.  Waits
+	//  while maxInFlight requests are outstanding.
+	void send(uint8_t cmd, const void* pPayload, std::size_t nPayload,
+			Callback done);
+	std::future<Reply> send(uint8_t cmd, const void* pPayload,
+			std::size_t nPayload);
+
+	std::future<Reply> getStatus();
+	std::future<Reply> getBootProfile();
+	std::future<Reply> getTiming();
+	// A uint32_t, OI_PROTOCOL_VERSION; NACK'd by devices of version 1.
+	std::future<Reply> getVersion();
+	std::future<Reply> estimateFrame(const OI_ESTIMATE_REQ& req);
+	std::future<Reply> queueFrame(const FrameProgram& program);
+	std::future<Reply> setIq(const OI_IQ_CONFIG& cfg);
+	std::future<Reply> setBeamform(const OI_BF_CONFIG& cfg);
+
+	// Reads the data of the last frame into the buffers, which must remain
+	//  until 'done' is called, once every request has been answered.  The
+	//  requests are sent on this thread, which waits for room among the
+	//  maxInFlight as the replies come; so it returns only once the last is
+	//  sent, and must not be called from a callback.
+	void readFrame(const FrameBuffers& buffers, FrameCallback done);
+	std::future<FrameResult> readFrame(const FrameBuffers& buffers);
+
+private:
+	struct FrameState;
+
+	struct Pending {
+		uint8_t replyCode;       // whose payload goes to pDest
+		uint8_t* pDest;
+		std::size_t nDest;
+		Callback done;
+	};
+
+	void request(uint8_t cmd, const void* pPayload, std::size_t nPayload,
+			uint8_t* pDest, std::size_t nDest, Callback done);
+	void readPiece(uint8_t* pData, uint32_t iAdc, std::size_t offset,
+			std::size_t n, const std::shared_ptr<FrameState>& pState);
+	void receive();
+	bool writeAll(const uint8_t* pHeader, const void* pPayload,
+			std::size_t nPayload);
+	bool readAll(void* pOut, std::size_t nBytes);
+
+	const ClientOptions options;
+
+	int fd = -1;
+	std::thread receiver;
+
+	// Held across each request, so that the requests are sent in the order
+	//  of 'pending'.
+	std::mutex sendMutex;
+
+	// Of 'pending' and 'isOpen'.
+	mutable std::mutex mutex;
+	std::condition_variable room;
+	std::deque<Pending> pending;
+	bool isOpen = false;
+};
+
+} // namespace oi
+
+#endif /* __OI_CLIENT_H__ */
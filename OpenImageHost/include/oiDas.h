@@ -0,0 +1,146 @@
+/*
+	oiDas.h
+
+	Host-side delay-and-sum beamforming of whole frames, from the channels
+	of each shot as oiDeinterleave.h lays them out.  Either each shot forms
+	its own line, as the device's beamformer (OI_BF_CONFIG), or every shot
+	is summed into every point of a grid, e.g. to compound plane waves.
+
+	The delays and apodization of every point are tabulated once per frame
+	program.  Each shot's transmit is timed by the first clock of each
+	element's level sequence that is not RTZ; the transmit reaches a point
+	when the wavefront, the stationary arrival over the elements that fire,
+	does (oiDas.cpp).  Samples are interpolated linearly, eight points at a
+	time with AVX2 where the CPU has it, and the image is split into tiles
+	of columns and depths that a pool of threads sums.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_DAS_H__
+#define __OI_DAS_H__
+
+#include "oiFrameProgram.h"
+
+#include "open_image_protocol.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+struct DasGeometry {
+	// Position of each element along the face of the array, relative to
+	//  its centre, in order across it.
+	float elementXUm[OI_N_CHAN];
+
+	float speedOfSound = 1540.0f;    // m/s
+	double sampleRateHz = 40.0e6;    // of the ADCs
+
+	// Subtracted from every delay, in samples; e.g., the time from the
+	//  first clock of a pulse to its centre.  As OI_BF_CONFIG.offsetQ8.
+	float offsetSamples = 0.0f;
+
+	// Receive apodization of each channel, times a Hann window over an
+	//  aperture of depth / fNumber about each point; with an fNumber of
+	//  zero, the whole array.
+	float apodization[OI_N_CHAN];
+	float fNumber = 0.0f;
+};
+
+// The points beamformed:  nDepth points down from each column.
+struct DasImage {
+	std::vector<float> columnXUm;
+	float
+		depthStartUm = 0.0f,
+		depthStepUm = 0.0f;
+	uint32_t nDepth = 0u;
+
+	// Whether column i is formed from shot i alone; else from every shot.
+	bool isLinePerShot = false;
+};
+
+class DasBeamformer {
+public:
+	// Sums with nThreads threads, the caller's among them; zero for one per
+	//  processor.  Without SIMD, the scalar version is used throughout.
+	explicit DasBeamformer(unsigned nThreads = 0u, bool isSimd = true);
+	~DasBeamformer();
+
+	DasBeamformer(const DasBeamformer&) = delete;
+	DasBeamformer& operator=(const DasBeamformer&) = delete;
+
+	// Tabulates the delays and apodization of the program's shots.  Returns
+	//  false if the image is empty, has not one column per shot when
+	//  isLinePerShot, or a shot records fewer than two samples.
+	bool plan(
+			const FrameProgram& program,
+			const DasGeometry& geometry,
+			const DasImage& image
+	);
+
+	// Beamforms a frame of the planned program into pImage:  nDepth points
+	//  for each column, one column after the other.  Channel c of shot s
+	//  starts at pRf + (s*OI_N_CHAN + c)*stride, with the shot's nSamples.
+	//  Returns false if nothing is planned, or the stride is too short.
+	bool beamform(float* pImage, const float* pRf, std::size_t stride);
+
+	uint32_t getNColumns() const { return nColumns; }
+	uint32_t getNDepth() const { return nDepth; }
+	unsigned getNThreads() const { return (unsigned) workers.size() + 1u; }
+
+private:
+	void runTiles();
+	void sumTile(std::size_t iTile);
+	void work();
+
+	const bool isSimd;
+
+	/////  Plan  /////
+	uint32_t
+		nColumns = 0u,
+		nDepth = 0u,
+		nTilesDeep = 0u;
+	std::size_t maxNSamples = 0u;
+	std::vector<uint32_t> shotNSamples;
+
+	// Per channel, then point:  the receive delay in samples, less the
+	//  offset, and the apodization.
+	std::vector<float> rxDelay, apodization;
+
+	// The shots of column i are pairShot[pairStart[i]..pairStart[i + 1]),
+	//  and pair k's transmit delays are txDelay[k*nDepth..].
+	std::vector<uint32_t> pairStart, pairShot;
+	std::vector<float> txDelay;
+
+	/////  Frame being beamformed  /////
+	float* pImage = nullptr;
+	const float* pRf = nullptr;
+	std::size_t stride = 0u;
+	std::atomic<std::size_t> nextTile{ 0u };
+	std::size_t nTiles = 0u;
+
+	/////  Pool  /////
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable start, done;
+	uint64_t generation = 0u;
+	unsigned nRunning = 0u;
+	bool isStopping = false;
+};
+
+//********************************  Functions  *******************************//
+
+// A linear array of the given pitch, centred as oiBfDelays does, with unit
+//  apodization.
+DasGeometry makeLinearArray(uint32_t pitchNm);
+
+} // namespace oi
+
+#endif /* __OI_DAS_H__ */
@@ -0,0 +1,85 @@
+/*
+	oiDeinterleave.h
+
+	Host-side conversion of the raw samples of a shot, as each ADC records
+	them (rows of its OI_N_CHAN / OI_RX_N_CHIPS lanes, interleaved), into a
+	matrix of [channel][sample], as float or int16_t.  In the same pass,
+	each lane is taken to its channel of the array, the inversion that the
+	firmware sets on some lanes (AD9670_REG_OUTPUT_MODE in oiAdc.c) is
+	undone, and each channel's DC offset and gain are corrected.
+
+	Kernels for AVX2 and AVX-512 are chosen at run time; the scalar version
+	is the reference that they match exactly.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_DEINTERLEAVE_H__
+#define __OI_DEINTERLEAVE_H__
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Lanes of each ADC's rows.
+static const uint32_t DEINTERLEAVE_N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+
+enum DeinterleaveIsa {
+	DEINTERLEAVE_SCALAR,
+	DEINTERLEAVE_AVX2,
+	DEINTERLEAVE_AVX512,         // F and BW
+
+	DEINTERLEAVE_BEST            // the best that the CPU supports
+};
+
+//**********************************  Types  *********************************//
+
+struct ChannelMap {
+	// Channel of the array that each lane of each ADC records; each channel
+	//  must appear once.
+	uint8_t channel[OI_RX_N_CHIPS][DEINTERLEAVE_N_LANES];
+
+	// Per channel:  whether its ADC inverts it (every bit), then the offset
+	//  to subtract and the gain to apply, in the units of the raw samples.
+	bool isInverted[OI_N_CHAN];
+	float
+		offset[OI_N_CHAN],
+		gain[OI_N_CHAN];
+};
+
+//********************************  Functions  *******************************//
+
+// The board's:  lane l of ADC a is channel 8a + l, with channel 7 (lane 7
+//  of ADC 0) and channel 8 (lane 0 of ADC 1) inverted, no offset, unit gain.
+ChannelMap defaultChannelMap();
+
+// The best kernel that this CPU runs.
+DeinterleaveIsa bestDeinterleaveIsa();
+
+// Converts nSamples rows of each ADC's samples, ppRaw[iAdc], into pOut,
+//  where channel c's samples start at pOut + c*stride.  Integer outputs are
+//  rounded to nearest (ties to even) and saturated.  Returns false if the
+//  map is not a permutation, or the kernel is not supported.
+bool deinterleave(
+		float* pOut,
+		std::size_t stride,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const ChannelMap& map,
+		DeinterleaveIsa isa = DEINTERLEAVE_BEST
+);
+bool deinterleave(
+		int16_t* pOut,
+		std::size_t stride,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const ChannelMap& map,
+		DeinterleaveIsa isa = DEINTERLEAVE_BEST
+);
+
+} // namespace oi
+
+#endif /* __OI_DEINTERLEAVE_H__ */
@@ -0,0 +1,167 @@
+/*
+	oiEmulator.h
+
+	An emulator of the Open Imager for Linux, so that host software may be
+	developed and tested without one.  It serves the protocol on a TCP port
+	as the firmware does:  the same commands and checks (oiCmd.c and
+	oiShotMan.c), the same states (oiSm.c), and the same layouts of the
+	raw, IQ and beamformed data.  The shots record synthetic echoes or the
+	ADCs' test patterns (oiSynth.h), with a configurable timing, so that
+	the throughput and latency of a client may be measured.  As on the
+	device, each shot's data are produced by a worker while the next
+	records, and the frame is done once they all are.
+
+	One client is served at a time, as the firmware's single reply context.
+	The emulator never faults.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_EMULATOR_H__
+#define __OI_EMULATOR_H__
+
+#include "oiSynth.h"
+
+#include "open_image_protocol.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+struct EmulatorOptions {
+	uint16_t port = OI_TCP_PORT;     // zero for any free port
+
+	// Timing of a frame:  from its queueing to the first shot, and from the
+	//  end of each shot to the start of the next.  Each shot records for
+	//  its nSamples at the model's sample rate.
+	uint32_t
+		armUs = 50u,
+		shotSetupUs = 20u;
+
+	// Time to handle each request, before its reply is sent.
+	uint32_t replyUs = 0u;
+
+	// Rate at which replies leave; zero for as fast as the socket allows.
+	double linkBytesPerSec = 0.0;
+
+	// lwIP's TCP_SND_BUF:  replies that cannot fit in it, with their
+	//  header, are NACK'd, as the firmware does (oiServerReply).
+	std::size_t sendBufferBytes = OI_MAX_REPLY_BYTES + 4u;
+
+	// Whether the bitstream writes the FPGA's half of each shot's header
+	//  (axis_shot_header.v), with the stream clocks at its first sample.
+	//  If not, as the firmware does without it (oiAdcDma.c), the timestamps
+	//  are zero; the sequence counts the shots either way.
+	bool isFpgaHeader = false;
+
+	SynthModel model;
+	uint32_t seed = 1u;              // of the noise
+};
+
+class Emulator {
+public:
+	explicit Emulator(const EmulatorOptions& options = EmulatorOptions());
+	~Emulator();
+
+	Emulator(const Emulator&) = delete;
+	Emulator& operator=(const Emulator&) = delete;
+
+	// Listens for clients, and starts acquiring.  Returns false if the port
+	//  cannot be had, or it is already started.
+	bool start();
+
+	// Closes the connection and the port, abandoning any frame being
+	//  recorded.
+	void stop();
+
+	// The port listened on, once started.
+	uint16_t getPort() const { return port; }
+
+	// Handles one packet (header and payload), as oiCmdHandle.  Returns the
+	//  reply packet:  every request has one.  Safe to call without a
+	//  connection, but not alongside one.
+	std::vector<uint8_t> handlePacket(const uint8_t* pPacket,
+			std::size_t nBytes);
+
+private:
+	struct Staging;
+
+	// A recorded shot, whose data are to be produced.
+	struct Job {
+		uint32_t iShot;
+		uint64_t timestamp;          // sample clocks since the emulator began
+	};
+
+	// The data of the last frame, for each ADC, as laid out by the firmware.
+	//  Only what was recorded is kept; the rest of each space reads as zero.
+	struct Buffers {
+		std::vector<uint8_t>
+			raw[OI_RX_N_CHIPS],
+			iq[OI_RX_N_CHIPS],
+			bf;
+	};
+
+	oi_error_t queueFrame(const uint8_t* pBytes, std::size_t nBytes,
+			bool isFormatted);
+	oi_error_t queueFrameRle(const uint8_t* pBytes, std::size_t nBytes);
+	oi_error_t queueFrameFocused(const uint8_t* pBytes, std::size_t nBytes);
+	oi_error_t loadRleFrame();
+	oi_error_t checkFormat(uint32_t sampleFormat, uint32_t nSamples) const;
+	oi_error_t setIq(const uint8_t* pBytes, std::size_t nBytes);
+	oi_error_t setBeamform(const uint8_t* pBytes, std::size_t nBytes);
+	void startFrame();
+	void readFrameData(uint8_t* pOut, const OI_FRAME_DATA_REQ& req,
+			bool isRaw) const;
+	std::vector<uint8_t> makeReply(uint8_t code, const void* pData,
+			std::size_t nData) const;
+
+	void acquire();
+	void process();
+	void recordShot(const Job& job);
+
+	void serve();
+	void serveClient(int fd);
+	bool sendReply(int fd, const std::vector<uint8_t>& reply);
+
+	const EmulatorOptions options;
+	const std::unique_ptr<Staging> pStaging;
+
+	int listenFd = -1;
+	std::atomic<int> clientFd{ -1 };
+	uint16_t port = 0u;
+	std::thread server, acquirer, worker;
+	std::atomic<bool> isStopping{ false };
+
+	// When the link is next free to send, on the server's thread.
+	std::chrono::steady_clock::time_point linkFree;
+
+	// Of everything below.  The buffers and frame are only written while
+	//  recording, and only read while ready.
+	std::mutex mutex;
+	std::condition_variable armed, work;
+	std::deque<Job> jobs;
+	bool isProcessing = false;
+	state_t state = STATE_READY;
+	OI_IQ_CONFIG iqConfig = {};
+	OI_BF_CONFIG bfConfig = {};
+	bool isFullWidth = true;
+	uint32_t
+		nShots = 0u,
+		sequence = 0u;
+	Buffers buffers;
+	std::chrono::steady_clock::time_point startTime;
+};
+
+} // namespace oi
+
+#endif /* __OI_EMULATOR_H__ */
@@ -0,0 +1,76 @@
+/*
+	oiFrameProgram.h
+
+	Host-side construction of frames for OI_CMD_QUEUE_FRAME,
+	OI_CMD_QUEUE_FRAME_FORMATTED and OI_CMD_QUEUE_FRAME_RLE.  The shots are
+	given in full (OI_SHOT), checked as the firmware will check them, and
+	sent in whichever form carries them in one packet:  an OI_FRAME holds
+	only a few shots within the 16-bit length of a packet, so frames whose
+	pulses and TGC waveforms can be represented exactly are run-length
+	encoded.  Others are sent as OI_CMD_QUEUE_FRAME, which devices of every
+	protocol version take, unless a shot records a packed sample format.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_FRAME_PROGRAM_H__
+#define __OI_FRAME_PROGRAM_H__
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Largest payload of one packet; its header gives the length in 16 bits.
+static const std::size_t PACKET_MAX_PAYLOAD = 0xFFFFu;
+
+//**********************************  Types  *********************************//
+
+class FrameProgram {
+public:
+	explicit FrameProgram(uint32_t handle = 0u) : handle(handle) {}
+
+	void clear() { shots.clear(); bytes.clear(); }
+	void setHandle(uint32_t h) { handle = h; }
+
+	// Adds a shot.  Returns false if the frame already has OI_MAX_N_SHOTS.
+	bool addShot(const OI_SHOT& shot);
+
+	// Checks the shots and encodes the frame.  Returns OI_ERR_NONE, or the
+	//  error that the device would refuse the frame with:  the firmware's
+	//  own checks, and those of the level sequences (see OI_TX_CHANNEL).
+	//  OI_ERR_INCORRECT_SIZE means that the frame fits in one packet in
+	//  neither form.
+	oi_error_t build();
+
+	uint32_t getHandle() const { return handle; }
+	uint32_t getNShots() const { return (uint32_t) shots.size(); }
+	const OI_SHOT& getShot(uint32_t iShot) const { return shots[iShot]; }
+
+	// Once built:  the command, and its payload.
+	uint8_t getCommand() const { return command; }
+	const std::vector<uint8_t>& getBytes() const { return bytes; }
+
+	// Bytes of raw data that each ADC records for the frame:  the shots'
+	//  records (OI_RX_SHOT_RECORD_BYTES), one after the other.
+	std::size_t getRawBytes() const;
+
+private:
+	uint32_t handle;
+	std::vector<OI_SHOT> shots;
+
+	uint8_t command = 0u;
+	std::vector<uint8_t> bytes;
+};
+
+//********************************  Functions  *******************************//
+
+// Checks one shot's transmit waveforms and receive settings.
+oi_error_t validateShot(const OI_SHOT& shot);
+
+} // namespace oi
+
+#endif /* __OI_FRAME_PROGRAM_H__ */
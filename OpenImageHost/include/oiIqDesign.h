@@ -0,0 +1,43 @@
+/*
+	oiIqDesign.h
+
+	Host-side design of the on-device baseband IQ demodulation
+	(OI_IQ_CONFIG), and the layout of the data it returns.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_IQ_DESIGN_H__
+#define __OI_IQ_DESIGN_H__
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+
+namespace oi {
+
+//********************************  Functions  *******************************//
+
+// Designs a demodulator centred on 'centerHz' that passes 'bandwidthHz'
+//  (two-sided), using a Hamming-windowed sinc of 'nTaps' taps with unity
+//  gain at DC.  Returns false if the parameters cannot be represented, or
+//  the decimated rate would alias the band.
+bool makeIqConfig(
+		OI_IQ_CONFIG& out,
+		double sampleRateHz,
+		double centerHz,
+		double bandwidthHz,
+		uint32_t decimation,
+		uint32_t nTaps = OI_IQ_MAX_N_TAPS
+);
+
+// Number of bytes of IQ data for one shot from one ADC.
+inline std::size_t iqShotBytes(uint32_t nSamples, const OI_IQ_CONFIG& cfg)
+{
+	return (std::size_t) OI_IQ_N_OUT(nSamples, cfg.decimation)
+			* (OI_N_CHAN / OI_RX_N_CHIPS) * 2u * sizeof(int16_t);
+}
+
+} // namespace oi
+
+#endif /* __OI_IQ_DESIGN_H__ */
@@ -0,0 +1,38 @@
+/*
+	oiLz4.h
+
+	Host-side compression of boot partitions, in the form the FSBL
+	decompresses as it loads them (see xfsbl_lz4.h):  LZ4 blocks of
+	XFSBL_LZ4_BLOCK_SIZE, each standing alone.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_LZ4_H__
+#define __OI_LZ4_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace oi {
+
+//********************************  Functions  *******************************//
+
+// Compresses nBytes as a compressed partition, padded to a word.  Blocks
+//  that do not compress are stored.
+std::vector<uint8_t> lz4Compress(const uint8_t* pData, std::size_t nBytes);
+
+// Decompresses a compressed partition with the FSBL's own decoder, handing
+//  it chunkBytes at a time, as the boot device would.  Returns false if the
+//  partition is malformed.
+bool lz4Decompress(
+		std::vector<uint8_t>& out,
+		const uint8_t* pPacked,
+		std::size_t nPacked,
+		std::size_t chunkBytes
+);
+
+} // namespace oi
+
+#endif /* __OI_LZ4_H__ */
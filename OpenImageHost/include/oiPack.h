@@ -0,0 +1,49 @@
+/*
+	oiPack.h
+
+	Host-side decoding of packed raw frame data (OI_CMD_GET_FRAME_PACKED).
+	The format is described in oiPack.c of the firmware.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_PACK_H__
+#define __OI_PACK_H__
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Channels recorded by each ADC, i.e. the samples in each row.
+static const uint32_t PACK_N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+
+//********************************  Functions  *******************************//
+
+// Decodes nRows rows of packed data into pOut, which receives
+//  nRows * PACK_N_LANES samples, interleaved as recorded.  Returns false
+//  if the data are malformed or too short.
+bool unpackRaw(
+		int16_t* pOut,
+		uint32_t nRows,
+		const uint8_t* pPacked,
+		std::size_t nPacked
+);
+
+// Packs nRows rows exactly as the firmware does; pOut must hold
+//  packedBytesMax(nRows).  Returns the number of bytes written.
+inline std::size_t packRaw(uint32_t* pOut, const int16_t* pIn, uint32_t nRows)
+{
+	return oiPackEncode(pOut, pIn, nRows);
+}
+
+inline std::size_t packedBytesMax(uint32_t nRows)
+{
+	return OI_PACK_MAX_PACKED_BYTES(nRows);
+}
+
+} // namespace oi
+
+#endif /* __OI_PACK_H__ */
@@ -0,0 +1,81 @@
+/*
+	oiPlanner.h
+
+	Host-side planning of frames with the timing model of the shot
+	pipeline (oiTiming.c):  predicts a frame's PRF, frame rate and use of
+	the link before it is run, and finds the most shots or samples that
+	reach a frame rate.  The costs are the device's own (OI_CMD_GET_TIMING),
+	or the defaults.  Frames are taken to be repeated back to back, so the
+	first shot follows the last; a shot loads its TGC waveforms if they
+	differ from those of the shot before it.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_PLANNER_H__
+#define __OI_PLANNER_H__
+
+#include "oiFrameProgram.h"
+
+#include "open_image_protocol.h"
+
+#include <chrono>
+#include <cstddef>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+struct PlannerOptions {
+	// Of each request for the data, as ClientOptions.
+	std::size_t chunkBytes = 4096u;
+
+	// Between the client's polls of the status while the frame records.
+	std::chrono::microseconds pollPeriod{ 100 };
+
+	// Depth whose echoes should die out before each next shot fires; the
+	//  shots that fire sooner are counted (OI_FRAME_ESTIMATE.nEchoOverlap).
+	uint32_t clearDepthUm = 0u;
+	uint32_t speedOfSound = 1540u;      // m/s
+};
+
+class FramePlanner {
+public:
+	// With the default costs.
+	explicit FramePlanner(const PlannerOptions& options = PlannerOptions());
+	FramePlanner(const OI_TIMING_CAL& timing,
+			const PlannerOptions& options = PlannerOptions());
+
+	void setTiming(const OI_TIMING_CAL& t) { timing = t; }
+	const OI_TIMING_CAL& getTiming() const { return timing; }
+
+	// What the device estimates a frame from (OI_CMD_ESTIMATE_FRAME).  The
+	//  program must have been built.
+	OI_ESTIMATE_REQ makeRequest(const FrameProgram& program) const;
+
+	// Estimates a built frame.  Returns false if it cannot be:  the
+	//  program is not built, or the costs are degenerate.
+	bool estimate(const FrameProgram& program, OI_FRAME_ESTIMATE& out) const;
+
+	// The most shots, each as 'shot', that a frame may have and still be
+	//  repeated at frameRateHz; zero if not even one.
+	uint32_t fitShots(const OI_SHOT& shot, double frameRateHz) const;
+
+	// The most samples that each of nShots shots, otherwise as 'shot', may
+	//  record and the frame still be repeated at frameRateHz, at most
+	//  maxSamples; zero if none.  Packed formats keep whole blocks of
+	//  OI_SAMPLE_FORMAT_ROWS.
+	uint32_t fitSamples(const OI_SHOT& shot, uint32_t nShots,
+			double frameRateHz, uint32_t maxSamples) const;
+
+private:
+	bool reaches(const OI_SHOT& shot, uint32_t nShots,
+			double frameRateHz) const;
+
+	OI_TIMING_CAL timing;
+	const PlannerOptions options;
+};
+
+} // namespace oi
+
+#endif /* __OI_PLANNER_H__ */
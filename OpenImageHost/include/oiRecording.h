@@ -0,0 +1,193 @@
+/*
+	oiRecording.h
+
+	Host-side recordings of raw frames, with the frame program that produced
+	them.  A recording file is:
+
+		a header page (RecordingHeader), rewritten as frames are added;
+		the program:  its handle and shots (OI_SHOT), from the next page;
+		the frames, from the next page, one every frameStride bytes:  the
+			data of each ADC as OI_CMD_GET_FRAME serves them (the shots'
+			records, one after the other), each starting on a page;
+		once closed, the index:  a RecordingIndexEntry per frame.
+
+	Pages are of RECORDING_PAGE_BYTES.  Every frame is of the one program,
+	so where each shot lies follows from the program alone.  The header's
+	frame count is written after each frame's data, so that a recording may
+	be read, up to the frames counted, while it is still being written, or
+	after the writer stopped without closing it.
+
+	The reader maps the file, so shots and channels are read in place.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_RECORDING_H__
+#define __OI_RECORDING_H__
+
+#include "oiDeinterleave.h"
+#include "oiFrameProgram.h"
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// "OIRC"
+static const uint32_t RECORDING_MAGIC = 0x4352494Fu;
+static const uint32_t RECORDING_VERSION = 1u;
+static const std::size_t RECORDING_PAGE_BYTES = 4096u;
+
+//**********************************  Types  *********************************//
+
+// At the start of the file, little-endian as all of it.
+struct RecordingHeader {
+	uint32_t
+		magic,             // RECORDING_MAGIC
+		version,           // RECORDING_VERSION
+		handle,            // of the frame program
+		nShots;
+	uint64_t
+		programOffset,     // of the shots
+		frameOffset,       // of the first frame
+		frameStride,       // bytes from one frame to the next
+		adcOffset[OI_RX_N_CHIPS],    // of each ADC's data in a frame
+		adcBytes[OI_RX_N_CHIPS],     // of each ADC's data
+		nFrames,           // whose data are complete
+		indexOffset,       // zero until closed
+		createdNs;         // since the Unix epoch
+};
+
+struct RecordingIndexEntry {
+	uint64_t
+		offset,            // of the frame
+		receivedNs;        // since the Unix epoch, as given to append
+	uint32_t
+		handle,            // of the shots' headers, from ADC 0's first shot
+		nBadShots;         // whose headers, from either ADC, are not good
+};
+
+// Samples of one channel of a shot, in place:  pSamples[i*stride].
+struct ChannelView {
+	const int16_t* pSamples = nullptr;
+	std::size_t
+		stride = 0u,
+		nSamples = 0u;
+};
+
+class RecordingWriter {
+public:
+	RecordingWriter() = default;
+	~RecordingWriter() { close(); }
+
+	RecordingWriter(const RecordingWriter&) = delete;
+	RecordingWriter& operator=(const RecordingWriter&) = delete;
+
+	// Creates (or replaces) a recording of frames of the program.  Returns
+	//  false if the program has no shots, or the file cannot be written.
+	bool create(const std::string& path, const FrameProgram& program);
+
+	// Appends a frame:  getRawBytes() of each ADC's data, as the client
+	//  reads them (FrameBuffers).  Returns false if it cannot be written.
+	bool append(const uint8_t* const ppData[OI_RX_N_CHIPS],
+			uint64_t receivedNs);
+
+	// Flushes the frames so far to the disk.
+	bool sync();
+
+	// Writes the index, and closes the file.  Returns false if that fails;
+	//  the frames counted remain readable.
+	bool close();
+
+	bool isOpen() const { return fd >= 0; }
+	uint64_t getNFrames() const { return header.nFrames; }
+
+private:
+	bool writeAt(uint64_t offset, const void* pData, std::size_t nBytes);
+
+	int fd = -1;
+	RecordingHeader header = {};
+	std::vector<std::size_t> shotOffset;     // within an ADC's data
+	std::vector<RecordingIndexEntry> index;
+};
+
+class RecordingReader {
+public:
+	RecordingReader() = default;
+	~RecordingReader() { close(); }
+
+	RecordingReader(const RecordingReader&) = delete;
+	RecordingReader& operator=(const RecordingReader&) = delete;
+
+	// Opens and maps a recording, complete or still being written.
+	//  Returns false if it cannot, or it is not a recording.
+	bool open(const std::string& path);
+	void close();
+
+	// Counts the frames written since, mapping them.  Views of frames
+	//  read before may move.  Returns the number of frames.
+	uint64_t refresh();
+
+	uint64_t getNFrames() const { return nFrames; }
+	bool isComplete() const { return isClosed; }
+	const RecordingHeader& getHeader() const { return header; }
+	const FrameProgram& getProgram() const { return program; }
+
+	// Of a complete recording; false if it is not, or has no such frame.
+	bool getIndexEntry(uint64_t iFrame, RecordingIndexEntry& entry) const;
+
+	// The record of a shot from one ADC:  its OI_SHOT_HEADER, then its
+	//  samples.  Null if there is no such frame or shot.
+	const uint8_t* getShotRecord(uint64_t iFrame, uint32_t iShot,
+			uint32_t iAdc) const;
+
+	// The 16-bit samples of a shot from one ADC, interleaved as recorded,
+	//  as deinterleave() takes them.  Null if there is no such frame or
+	//  shot, or it is of a packed format.
+	const int16_t* getShotSamples(uint64_t iFrame, uint32_t iShot,
+			uint32_t iAdc) const;
+
+	// One channel of a shot, as the map places the channels on the ADCs'
+	//  lanes; raw, not inverted.  Empty where getShotSamples is null.
+	ChannelView getChannel(uint64_t iFrame, uint32_t iShot, uint32_t iChan,
+			const ChannelMap& map) const;
+
+private:
+	bool remap(std::size_t nBytes);
+
+	int fd = -1;
+	const uint8_t* pMap = nullptr;
+	std::size_t nMapped = 0u;
+
+	RecordingHeader header = {};
+	FrameProgram program;
+	std::vector<std::size_t> shotOffset;     // within an ADC's data
+	uint64_t nFrames = 0u;
+	bool isClosed = false;                   // the index is read
+	std::vector<RecordingIndexEntry> index;
+};
+
+//********************************  Functions  *******************************//
+
+// The header of a new recording of the program:  its layout, and no
+//  frames.
+RecordingHeader makeRecordingHeader(const FrameProgram& program);
+
+// Where each shot's record starts in an ADC's data.
+std::vector<std::size_t> recordingShotOffsets(const FrameProgram& program);
+
+// The index entry of a frame, written at the given offset, from its data.
+RecordingIndexEntry indexRecordingFrame(
+		const uint8_t* const ppData[OI_RX_N_CHIPS],
+		const std::vector<std::size_t>& shotOffset,
+		uint64_t offset,
+		uint64_t receivedNs
+);
+
+} // namespace oi
+
+#endif /* __OI_RECORDING_H__ */
@@ -0,0 +1,65 @@
+/*
+	oiSamples.h
+
+	Host-side handling of raw frame data:  the layout of the shots, and
+	conversion of the packed sample formats (OI_RX.sampleFormat) back to
+	16-bit samples.  The packing is done in the FPGA by axis_sample_pack.v.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_SAMPLES_H__
+#define __OI_SAMPLES_H__
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+
+namespace oi {
+
+//********************************  Functions  *******************************//
+
+// Bytes of nRows rows (samples of each channel of one ADC) in a format.
+inline std::size_t sampleBytes(std::size_t nRows, uint32_t format)
+{
+	return OI_RX_SHOT_BYTES(nRows, format);
+}
+
+// Bytes that a shot takes in the raw data, with its header; the shots of
+//  a frame follow each other.
+inline std::size_t shotRecordBytes(std::size_t nRows, uint32_t format)
+{
+	return OI_RX_SHOT_RECORD_BYTES(nRows, format);
+}
+
+// Whether a shot's header (at the start of its record) shows that its
+//  samples are complete and fresh.  The caller checks the handle and shot.
+inline bool isShotGood(const OI_SHOT_HEADER& header)
+{
+	return header.magic == OI_SHOT_MAGIC && header.flags == 0u;
+}
+
+// Expands nRows rows of samples in the given format into pOut, which
+//  receives nRows * OI_N_CHAN / OI_RX_N_CHIPS samples, interleaved as
+//  recorded.  Samples keep their scale:  the bits that were dropped read
+//  as zero.  Returns false if the format is unknown.
+bool unpackSamples(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows,
+		uint32_t format
+);
+
+// Packs nRows rows exactly as the FPGA does, dropping the low bits of
+//  each sample; pOut must hold sampleBytes(nRows, format).  Returns false
+//  if the format is unknown.
+bool packSamples(
+		uint8_t* pOut,
+		const int16_t* pIn,
+		std::size_t nRows,
+		uint32_t format
+);
+
+} // namespace oi
+
+#endif /* __OI_SAMPLES_H__ */
@@ -0,0 +1,107 @@
+/*
+	oiSpscQueue.h
+
+	A bounded queue between one producing thread and one consuming thread,
+	without locks.  Each side owns its index, and keeps a copy of the
+	other's that it reads again only when the queue looks full or empty, so
+	that the two share a cache line only when they must.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_SPSC_QUEUE_H__
+#define __OI_SPSC_QUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const std::size_t CACHE_LINE_BYTES = 64u;
+
+//**********************************  Types  *********************************//
+
+template <class T>
+class SpscQueue {
+public:
+	// Holds at least 'capacity' items:  the next power of two.
+	explicit SpscQueue(std::size_t capacity)
+		: slots(roundToPowerOf2(capacity)), mask(slots.size() - 1u) {}
+
+	SpscQueue(const SpscQueue&) = delete;
+	SpscQueue& operator=(const SpscQueue&) = delete;
+
+	// Of the producer.  Returns false if the queue is full.
+	bool push(const T& item)
+	{
+		const std::size_t t = tail.load(std::memory_order_relaxed);
+		if (t - headSeen == slots.size()) {
+			headSeen = head.load(std::memory_order_acquire);
+			if (t - headSeen == slots.size()) {
+				return false;
+			} else {
+				// Room after all.
+			}
+		} else {
+			// Room.
+		}
+
+		slots[t & mask] = item;
+		tail.store(t + 1u, std::memory_order_release);
+		return true;
+	}
+
+	// Of the consumer.  Returns false if the queue is empty.
+	bool pop(T& item)
+	{
+		const std::size_t h = head.load(std::memory_order_relaxed);
+		if (h == tailSeen) {
+			tailSeen = tail.load(std::memory_order_acquire);
+			if (h == tailSeen) {
+				return false;
+			} else {
+				// Something after all.
+			}
+		} else {
+			// Something.
+		}
+
+		item = slots[h & mask];
+		head.store(h + 1u, std::memory_order_release);
+		return true;
+	}
+
+	// Items queued, as of some moment during the call.
+	std::size_t size() const
+	{
+		const std::size_t h = head.load(std::memory_order_acquire);
+		return tail.load(std::memory_order_acquire) - h;
+	}
+
+	std::size_t capacity() const { return slots.size(); }
+
+private:
+	static std::size_t roundToPowerOf2(std::size_t n)
+	{
+		std::size_t p = 1u;
+		while (p < n) {
+			p *= 2u;
+		}
+		return p;
+	}
+
+	std::vector<T> slots;
+	const std::size_t mask;
+
+	// The consumer's line, then the producer's.
+	alignas(CACHE_LINE_BYTES) std::atomic<std::size_t> head{ 0u };
+	std::size_t tailSeen = 0u;
+	alignas(CACHE_LINE_BYTES) std::atomic<std::size_t> tail{ 0u };
+	std::size_t headSeen = 0u;
+};
+
+} // namespace oi
+
+#endif /* __OI_SPSC_QUEUE_H__ */
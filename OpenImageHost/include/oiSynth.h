@@ -0,0 +1,84 @@
+/*
+	oiSynth.h
+
+	Host-side synthesis of the samples that the ADCs record for a shot:
+	the echoes of point targets, as the shot's transmit waveforms fire and
+	its TGC amplifies them, or the AD9670 test pattern that the shot
+	selects (OI_RX.testMode, as the TEST_CHOICES of oiAdc.c).  Used by the
+	emulator, and to test the processing of frames.
+
+	The array is that of oiBeamform.c:  element c at ((2c - 15)/2) pitches
+	from the centre, recorded by lane c % 8 of ADC c / 8.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_SYNTH_H__
+#define __OI_SYNTH_H__
+
+#include "open_image_protocol.h"
+
+#include <vector>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Test modes, as OI_RX.testMode; others are normal operation.
+enum SynthTestMode {
+	SYNTH_TEST_NORMAL,
+	SYNTH_TEST_CHAN_ID,      // each channel's index
+	SYNTH_TEST_SINE,         // digital sine
+	SYNTH_TEST_ANA_TONES,    // analog tone, through the gain
+	SYNTH_TEST_USER_IO,      // USR_PAT1..4, repeated
+
+	SYNTH_N_TEST_MODES
+};
+
+//**********************************  Types  *********************************//
+
+// A point scatterer, relative to the centre of the array face.  Its echo
+//  peaks at 'amplitude' of full scale when every element fires at it, at
+//  the reference gain of the TGC.
+struct SynthTarget {
+	double
+		xUm,
+		zUm,
+		amplitude;
+};
+
+struct SynthModel {
+	uint32_t
+		pitchNm = 300000u,
+		speedOfSound = 1540u;     // m/s
+
+	double
+		sampleRateHz = 40.0e6,
+		centreHz = 5.0e6,         // of the transducer
+		noiseRms = 8.0,           // codes, after the gain
+		tgcDbPerCode = 40.0 / 255.0;
+	uint8_t tgcRefCode = 128u;    // TGC code of unity gain
+
+	std::vector<SynthTarget> targets = {
+		{ 0.0, 10000.0, 0.5 },
+		{ 0.0, 20000.0, 0.5 },
+		{ -1500.0, 30000.0, 0.4 },
+		{ 1500.0, 40000.0, 0.3 },
+	};
+};
+
+//********************************  Functions  *******************************//
+
+// Synthesizes a shot into ppOut[iAdc], which each receive nSamples rows
+//  of the ADC's OI_N_CHAN / OI_RX_N_CHIPS channels, interleaved, as 14-bit
+//  samples in the upper bits of each int16_t.  The noise is drawn from
+//  'seed'.
+void synthesizeShot(
+		int16_t* const ppOut[OI_RX_N_CHIPS],
+		const OI_SHOT& shot,
+		const SynthModel& model,
+		uint32_t seed
+);
+
+} // namespace oi
+
+#endif /* __OI_SYNTH_H__ */
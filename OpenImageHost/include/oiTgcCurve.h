@@ -0,0 +1,59 @@
+/*
+	oiTgcCurve.h
+
+	Host-side construction of parametric Time Gain Compensation curves
+	(OI_TGC_CURVE).
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_TGC_CURVE_H__
+#define __OI_TGC_CURVE_H__
+
+#include "open_image_protocol.h"
+
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+// A constant slope of gain, in dB/usec, held for 'durationUs'.
+struct TgcRamp {
+	double
+		durationUs,
+		slopeDbPerUs;
+};
+
+// Relation of gain to DAC code for a board: gain = offsetDb + code*dbPerCode.
+struct TgcCalibration {
+	double
+		offsetDb,
+		dbPerCode;
+};
+
+//********************************  Functions  *******************************//
+
+// Builds a curve from a starting gain and a list of ramps.  Returns false
+//  if there are more than OI_TGC_MAX_N_SEGMENTS ramps, a ramp is shorter
+//  than half a TGC point, or the calibration is degenerate.  Gains
+//  outside the range of the DAC are clamped.
+bool makeTgcCurve(
+		OI_TGC_CURVE& out,
+		double startDb,
+		const std::vector<TgcRamp>& ramps,
+		const TgcCalibration& cal
+);
+
+// Finds a curve that renders exactly to the given OI_RX_MAX_N_TGC codes.
+//  Returns false if it finds none of OI_TGC_MAX_N_SEGMENTS or fewer; the
+//  search is greedy, so it may rarely miss one that exists.
+bool fitTgcCurve(OI_TGC_CURVE& out, const uint8_t* pCodes);
+
+// Converts a full receive description to its compact form.  Returns false
+//  if a TGC waveform cannot be represented exactly.
+bool compactRx(OI_RX_COMPACT& out, const OI_RX& in);
+
+} // namespace oi
+
+#endif /* __OI_TGC_CURVE_H__ */
@@ -0,0 +1,78 @@
+/*
+	oiTxEncode.h
+
+	Host-side encoding of transmit waveforms into the run-length encoded
+	format (OI_FRAME_RLE), and planning of focused frames.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_TX_ENCODE_H__
+#define __OI_TX_ENCODE_H__
+
+#include "open_image_protocol.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+// Collects the distinct pulse shapes of a frame into shared templates.
+class TxRleEncoder {
+public:
+	void clear() { templates.clear(); }
+
+	// Encodes the transmit description of one shot.  Returns false if
+	//  the shot cannot be represented, i.e. it needs more than
+	//  OI_TX_MAX_N_TEMPLATES distinct pulse shapes (counting those of the
+	//  shots already encoded), or a pulse shape has more than
+	//  OI_TX_MAX_N_RUNS runs.
+	bool encode(const OI_TX& tx, OI_TX_RLE& out);
+
+	uint32_t getNTemplates() const { return (uint32_t) templates.size(); }
+	const OI_TX_TEMPLATE* getTemplates() const { return templates.data(); }
+
+private:
+	bool encodeChannel(const OI_TX_CHANNEL& in, OI_TX_RLE_CHANNEL& out);
+	int findOrAddTemplate(const OI_TX_TEMPLATE& shape);
+
+	std::vector<OI_TX_TEMPLATE> templates;
+};
+
+//********************************  Functions  *******************************//
+
+// Encodes a complete frame.  Returns false if the frame cannot be
+//  represented (see TxRleEncoder::encode and compactRx).
+bool encodeFrameRle(const OI_FRAME& in, OI_FRAME_RLE& out);
+
+// Expands an encoded frame exactly as the firmware does.
+void decodeFrameRle(const OI_FRAME_RLE& in, OI_FRAME& out);
+
+// Plans the delays of a focused frame exactly as the firmware does; e.g.,
+//  to check a scan before sending it.
+oi_error_t planFrameFocused(const OI_FRAME_FOCUSED& in, OI_FRAME_RLE& out);
+
+// Number of bytes to send for each format.
+inline std::size_t frameBytes(const OI_FRAME& f)
+{
+	return OI_FRAME_BYTES(f.nShots);
+}
+// Of OI_CMD_QUEUE_FRAME, whose shots are those of protocol version 1.
+inline std::size_t frameV1Bytes(const OI_FRAME& f)
+{
+	return OI_FRAME_V1_BYTES(f.nShots);
+}
+inline std::size_t frameBytes(const OI_FRAME_RLE& f)
+{
+	return OI_FRAME_RLE_BYTES(f.nShots);
+}
+inline std::size_t frameBytes(const OI_FRAME_FOCUSED& f)
+{
+	return OI_FRAME_FOCUSED_BYTES(f.nShots);
+}
+
+} // namespace oi
+
+#endif /* __OI_TX_ENCODE_H__ */
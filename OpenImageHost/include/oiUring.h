@@ -0,0 +1,75 @@
+/*
+	oiUring.h
+
+	A minimal io_uring (Linux 5.6 and later), over the system calls alone:
+	reads and writes are queued in the submission ring, submitted together,
+	and their completions taken from the completion ring, each identified
+	by the caller's tag.  Not thread-safe; one thread owns a ring.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_URING_H__
+#define __OI_URING_H__
+
+#include <cstddef>
+#include <cstdint>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+struct UringCompletion {
+	uint64_t tag;
+	int32_t result;          // bytes transferred, or -errno
+};
+
+class Uring {
+public:
+	// A ring of at least nEntries submissions.  isOpen tells whether the
+	//  kernel provided one.
+	explicit Uring(unsigned nEntries);
+	~Uring();
+
+	Uring(const Uring&) = delete;
+	Uring& operator=(const Uring&) = delete;
+
+	bool isOpen() const { return fd >= 0; }
+
+	// Queue an operation, to be submitted by the next submit.  Returns
+	//  false if the submission ring is full.
+	bool write(int file, const void* pData, uint32_t nBytes, uint64_t offset,
+			uint64_t tag);
+	bool read(int file, void* pData, uint32_t nBytes, uint64_t offset,
+			uint64_t tag);
+
+	// Submits what is queued, then waits until at least minComplete
+	//  operations have completed.  Returns false on error.
+	bool submit(unsigned minComplete);
+
+	// Takes a completion.  Returns false if there is none.
+	bool complete(UringCompletion& completion);
+
+private:
+	void release();
+	bool queue(uint8_t opcode, int file, uint64_t address, uint32_t nBytes,
+			uint64_t offset, uint64_t tag);
+
+	int fd = -1;
+	unsigned nQueued = 0u;
+
+	// Mapped rings.
+	void* pSqRing = nullptr;
+	void* pCqRing = nullptr;
+	void* pSqes = nullptr;
+	std::size_t sqRingBytes = 0u, cqRingBytes = 0u, sqesBytes = 0u;
+
+	unsigned *pSqHead = nullptr, *pSqTail = nullptr, *pSqArray = nullptr;
+	unsigned *pCqHead = nullptr, *pCqTail = nullptr;
+	unsigned sqMask = 0u, cqMask = 0u, nSqEntries = 0u;
+	void* pCqes = nullptr;
+};
+
+} // namespace oi
+
+#endif /* __OI_URING_H__ */
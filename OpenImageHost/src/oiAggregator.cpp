@@ -0,0 +1,453 @@
+/*
+	oiAggregator.cpp
+
+	Host-side aggregation of several Open Imagers.  A frame is armed by
+	asking every unit for its count of shots, then queueing every unit's
+	frame, each before any reply is awaited, so that the units start
+	within a request of each other.  Each unit's thread then polls its
+	status until the frame is recorded, reads the data over its own
+	connection, checks the shots' headers and deinterleaves its shots into
+	its elements' rows; the units' clocks are compared once every one is
+	done.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiAggregator.h"
+#include "oiRecording.h"
+#include "oiSamples.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <thread>
+
+namespace oi {
+
+//**********************************  Types  *********************************//
+
+struct Aggregator::Unit {
+	Unit(uint32_t iUnit, const ClientOptions& options)
+		: iUnit(iUnit), client(options), map(defaultChannelMap()) {}
+
+	const uint32_t iUnit;
+	Client client;
+	ChannelMap map;
+	std::thread thread;
+
+	// The frame's data, as read, and each ADC's samples of a shot, as 16
+	//  bits, when recorded in a packed format.
+	std::vector<uint8_t> raw[OI_RX_N_CHIPS];
+	std::vector<int16_t> unpacked[OI_RX_N_CHIPS];
+
+	/////  Frame being acquired  /////
+	uint32_t nShotsBefore = 0u;          // counted before it was queued
+	bool ok = false;                     // recorded, read and merged
+	uint32_t nBadShots = 0u;
+	std::vector<uint64_t> timestamp;     // of each shot, in sample clocks
+};
+
+//***********************  Local Function Declarations  **********************//
+static bool parseHost(const std::string& name, std::string& host,
+		uint16_t& port);
+
+//****************************  Global Functions  ****************************//
+
+ArrayProgram::ArrayProgram(uint32_t nUnits, uint32_t handle)
+	: handle(handle), units(std::max(nUnits, 1u))
+{
+}
+
+void ArrayProgram::clear()
+{
+	for (FrameProgram& unit : units) {
+		unit.clear();
+	}
+}
+
+bool ArrayProgram::addShot(const OI_SHOT& settings, const OI_TX_CHANNEL* pTx,
+		const OI_RX_CHANNEL* pRx)
+{
+	if (getNShots() >= OI_MAX_N_SHOTS) {
+		return false;
+	} else {
+		// Room.
+	}
+
+	for (uint32_t iUnit = 0u; iUnit < getNUnits(); ++iUnit) {
+		OI_SHOT shot = settings;
+		std::memcpy(shot.tx.channels, pTx + iUnit * OI_N_CHAN,
+				sizeof(shot.tx.channels));
+		std::memcpy(shot.rx.channels, pRx + iUnit * OI_N_CHAN,
+				sizeof(shot.rx.channels));
+		units[iUnit].addShot(shot);
+	}
+
+	return true;
+}
+
+oi_error_t ArrayProgram::build()
+{
+	oi_error_t error = OI_ERR_NONE;
+
+	for (FrameProgram& unit : units) {
+		unit.setHandle(handle);
+		const oi_error_t unitError = unit.build();
+		error = error == OI_ERR_NONE ? unitError : error;
+	}
+
+	return error;
+}
+
+Aggregator::Aggregator(const AggregatorOptions& options)
+	: options(options)
+{
+}
+
+Aggregator::~Aggregator() { close(); }
+
+bool Aggregator::connect(const std::vector<std::string>& hosts)
+{
+	if (!units.empty() || hosts.empty()) {
+		return false;
+	} else {
+		// Not yet connected.
+	}
+
+	bool ok = true;
+	for (const std::string& name : hosts) {
+		std::string host;
+		uint16_t port;
+		units.emplace_back(new Unit((uint32_t) units.size(), options.client));
+		ok = ok && parseHost(name, host, port)
+				&& units.back()->client.connect(host, port);
+	}
+
+	if (ok) {
+		for (const std::unique_ptr<Unit>& pUnit : units) {
+			pUnit->thread = std::thread(&Aggregator::work, this,
+					std::ref(*pUnit), generation);
+		}
+	} else {
+		units.clear();
+	}
+
+	return ok;
+}
+
+void Aggregator::close()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	start.notify_all();
+	for (const std::unique_ptr<Unit>& pUnit : units) {
+		if (pUnit->thread.joinable()) {
+			pUnit->thread.join();
+		} else {
+			// Never started.
+		}
+	}
+
+	units.clear();
+	isStopping = false;
+}
+
+void Aggregator::setChannelMap(uint32_t iUnit, const ChannelMap& map)
+{
+	if (iUnit < units.size()) {
+		units[iUnit]->map = map;
+	} else {
+		// No such unit.
+	}
+}
+
+ArrayResult Aggregator::acquire(const ArrayProgram& program, int16_t* pOut,
+		std::size_t stride)
+{
+	return run(program, pOut, false, stride);
+}
+
+ArrayResult Aggregator::acquire(const ArrayProgram& program, float* pOut,
+		std::size_t stride)
+{
+	return run(program, pOut, true, stride);
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+ArrayResult Aggregator::run(const ArrayProgram& program, void* pOut,
+		bool isFloat, std::size_t stride)
+{
+	ArrayResult result;
+	const uint32_t nUnits = getNUnits();
+	bool ok = nUnits > 0u && program.getNUnits() == nUnits
+			&& program.getNShots() > 0u && pOut != nullptr;
+
+	for (uint32_t iUnit = 0u; iUnit < nUnits && ok; ++iUnit) {
+		ok = !program.getUnit(iUnit).getBytes().empty();
+	}
+	for (uint32_t iShot = 0u; iShot < program.getNShots() && ok; ++iShot) {
+		ok = stride >= program.getUnit(0u).getShot(iShot).rx.nSamples;
+	}
+	if (!ok) {
+		return result;
+	} else {
+		// A built frame of these units.
+	}
+
+	pProgram = &program;
+	shotOffset = recordingShotOffsets(program.getUnit(0u));
+	this->pOut = pOut;
+	this->isFloat = isFloat;
+	this->stride = stride;
+
+	// Each unit's count of shots, then its frame, each request sent before
+	//  any reply is awaited.
+	std::vector<std::future<Reply>> replies;
+	for (const std::unique_ptr<Unit>& pUnit : units) {
+		replies.push_back(pUnit->client.getStatus());
+	}
+	for (uint32_t iUnit = 0u; iUnit < nUnits; ++iUnit) {
+		OI_STATUS status;
+		ok = replies[iUnit].get().get(status) && ok;
+		units[iUnit]->nShotsBefore = ok ? status.nShots : 0u;
+	}
+
+	const auto armed = std::chrono::steady_clock::now();
+	replies.clear();
+	for (uint32_t iUnit = 0u; iUnit < nUnits && ok; ++iUnit) {
+		replies.push_back(units[iUnit]->client.queueFrame(
+				program.getUnit(iUnit)));
+	}
+	for (std::future<Reply>& reply : replies) {
+		ok = reply.get().isAck() && ok;
+	}
+	result.armUs = std::chrono::duration<double, std::micro>(
+			std::chrono::steady_clock::now() - armed).count();
+	if (!ok) {
+		return result;
+	} else {
+		// Every unit is recording.
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		nRunning = nUnits;
+		++generation;
+	}
+	start.notify_all();
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		done.wait(lock, [this] { return nRunning == 0u; });
+	}
+
+	for (const std::unique_ptr<Unit>& pUnit : units) {
+		ok = ok && pUnit->ok;
+		result.nBadShots += pUnit->nBadShots;
+	}
+	if (ok) {
+		align(result);
+	} else {
+		// Some unit's shots have no times.
+	}
+	result.ok = ok && result.nBadShots == 0u && result.nMisaligned == 0u
+			&& (result.isTimed || options.isUntimedAllowed || nUnits == 1u);
+
+	return result;
+}
+
+// On the unit's thread:  acquires its part of the frame.
+void Aggregator::runUnit(Unit& unit)
+{
+	const FrameProgram& frame = pProgram->getUnit(unit.iUnit);
+
+	unit.nBadShots = 0u;
+	unit.ok = recordUnit(unit);
+	if (unit.ok) {
+		FrameBuffers buffers;
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			unit.raw[iAdc].resize(frame.getRawBytes());
+			buffers.pData[iAdc] = unit.raw[iAdc].data();
+			buffers.nBytes[iAdc] = unit.raw[iAdc].size();
+		}
+		unit.ok = unit.client.readFrame(buffers).get().ok;
+	} else {
+		// Not recorded.
+	}
+
+	if (unit.ok) {
+		checkUnit(unit);
+		mergeUnit(unit);
+	} else {
+		// Nothing to merge.
+	}
+}
+
+// Polls until the unit has recorded its frame's shots and is ready.
+bool Aggregator::recordUnit(Unit& unit)
+{
+	const uint32_t nShots = pProgram->getNShots();
+	const auto began = std::chrono::steady_clock::now();
+	OI_STATUS status;
+	bool ok = unit.client.getStatus().get().get(status);
+
+	while (ok && (status.state != STATE_READY
+			|| (int32_t) (status.nShots - unit.nShotsBefore - nShots) < 0)) {
+		std::this_thread::sleep_for(options.pollPeriod);
+		ok = std::chrono::steady_clock::now() - began < options.recordTimeout
+				&& unit.client.getStatus().get().get(status);
+	}
+
+	return ok;
+}
+
+// Counts the shots that are not the frame's, in order, and good on both
+//  ADCs, and takes each shot's time.
+void Aggregator::checkUnit(Unit& unit)
+{
+	const uint32_t nShots = pProgram->getNShots();
+	uint32_t firstSequence = 0u;
+
+	unit.timestamp.assign(nShots, 0u);
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		OI_SHOT_HEADER shot[OI_RX_N_CHIPS];
+		bool isGood = true;
+
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			std::memcpy(&shot[iAdc], &unit.raw[iAdc][shotOffset[iShot]],
+					sizeof(shot[iAdc]));
+			isGood = isGood && isShotGood(shot[iAdc])
+					&& shot[iAdc].handle == pProgram->getHandle()
+					&& shot[iAdc].iShot == iShot
+					&& shot[iAdc].sequence == shot[0].sequence;
+		}
+
+		firstSequence = iShot == 0u ? shot[0].sequence : firstSequence;
+		isGood = isGood && shot[0].sequence - firstSequence == iShot;
+		unit.nBadShots += isGood ? 0u : 1u;
+		unit.timestamp[iShot] = (uint64_t) shot[0].timestampHi << 32
+				| shot[0].timestampLo;
+	}
+}
+
+// Deinterleaves each shot into the rows of the unit's elements.
+void Aggregator::mergeUnit(Unit& unit)
+{
+	const FrameProgram& frame = pProgram->getUnit(unit.iUnit);
+	const std::size_t nElements = pProgram->getNElements();
+
+	for (uint32_t iShot = 0u; iShot < frame.getNShots() && unit.ok; ++iShot) {
+		const OI_RX& rx = frame.getShot(iShot).rx;
+		const int16_t* ppRaw[OI_RX_N_CHIPS];
+
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			const uint8_t* const pSamples = &unit.raw[iAdc][shotOffset[iShot]]
+					+ OI_SHOT_HEADER_BYTES;
+
+			if (rx.sampleFormat == OI_SAMPLE_FORMAT_16) {
+				ppRaw[iAdc] = (const int16_t*) pSamples;
+			} else {
+				std::vector<int16_t>& samples = unit.unpacked[iAdc];
+				samples.resize((std::size_t) rx.nSamples * DEINTERLEAVE_N_LANES);
+				unpackSamples(samples.data(), pSamples, rx.nSamples,
+						rx.sampleFormat);
+				ppRaw[iAdc] = samples.data();
+			}
+		}
+
+		const std::size_t first
+			= ((std::size_t) iShot * nElements + unit.iUnit * OI_N_CHAN) * stride;
+		unit.ok = isFloat
+				? deinterleave((float*) pOut + first, stride, ppRaw, rx.nSamples,
+						unit.map)
+				: deinterleave((int16_t*) pOut + first, stride, ppRaw,
+						rx.nSamples, unit.map);
+	}
+}
+
+// Compares each unit's shot times with unit 0's:  the difference at the
+//  first shot is the units' offset, and any change in it after is skew.
+//  Times that are all zero, or of several shots all the same, are not
+//  times:  the bitstream did not write them, and would show no skew.
+void Aggregator::align(ArrayResult& result) const
+{
+	const std::vector<uint64_t>& reference = units.front()->timestamp;
+
+	result.isTimed = true;
+	for (const std::unique_ptr<Unit>& pUnit : units) {
+		const std::vector<uint64_t>& timestamp = pUnit->timestamp;
+		const bool isConstant = std::all_of(timestamp.begin(),
+				timestamp.end(), [&timestamp](uint64_t t) {
+			return t == timestamp.front();
+		});
+		result.isTimed = result.isTimed
+				&& !(isConstant && (timestamp.front() == 0u
+					|| timestamp.size() > 1u));
+	}
+	if (!result.isTimed) {
+		return;
+	} else {
+		// Times to compare.
+	}
+
+	for (uint32_t iShot = 0u; iShot < pProgram->getNShots(); ++iShot) {
+		bool isAligned = true;
+
+		for (std::size_t iUnit = 1u; iUnit < units.size(); ++iUnit) {
+			const std::vector<uint64_t>& timestamp = units[iUnit]->timestamp;
+			const int64_t skew = (int64_t) (timestamp[iShot] - reference[iShot])
+					- (int64_t) (timestamp[0] - reference[0]);
+			const uint32_t nClocks = (uint32_t) std::min<uint64_t>(
+					(uint64_t) std::llabs(skew), UINT32_MAX);
+
+			result.maxSkewClocks = std::max(result.maxSkewClocks, nClocks);
+			isAligned = isAligned && nClocks <= options.maxSkewClocks;
+		}
+
+		result.nMisaligned += isAligned ? 0u : 1u;
+	}
+}
+
+// Runs on the unit's thread, from the generation when it was started.
+void Aggregator::work(Unit& unit, uint64_t seen)
+{
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start.wait(lock, [&] { return isStopping || generation != seen; });
+			if (isStopping) {
+				return;
+			} else {
+				seen = generation;
+			}
+		}
+
+		runUnit(unit);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--nRunning == 0u) {
+			done.notify_all();
+		} else {
+			// Other units are still acquiring.
+		}
+	}
+}
+
+// Splits "host[:port]", with the device's port by default.
+static bool parseHost(const std::string& name, std::string& host,
+		uint16_t& port)
+{
+	const std::size_t colon = name.rfind(':');
+
+	host = name.substr(0u, colon);
+	port = colon != std::string::npos
+			? (uint16_t) std::strtoul(name.c_str() + colon + 1u, nullptr, 0)
+			: (uint16_t) OI_TCP_PORT;
+
+	return !host.empty() && port != 0u;
+}
+
+} // namespace oi
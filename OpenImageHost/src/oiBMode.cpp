@@ -0,0 +1,579 @@
+/*
+	oiBMode.cpp
+
+	Host-side B-mode conversion.  For each tile of pixels:  each line of its
+	box is copied with the Hilbert filter's margins (zero beyond the
+	recording), filtered, and its power x^2 + H{x}^2 compressed straight
+	from the log2 of the power, which a polynomial gives; then each pixel
+	is interpolated bilinearly from the box.  The AVX2 kernels do the
+	scalar versions' arithmetic in the same order, so the images match.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiBMode.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define OI_BMODE_X86 1
+#	include <immintrin.h>
+#else
+#	define OI_BMODE_X86 0
+#endif
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const double PI = 3.14159265358979324;
+static const double UM_PER_M = 1.0e6;
+
+// Pixels of each tile.
+static const uint32_t TILE_WIDTH = 64u;
+static const uint32_t TILE_HEIGHT = 32u;
+
+// The Hilbert filter reaches this far either side, with taps at the odd
+//  offsets only; it is Hamming windowed.
+static const uint32_t HILBERT_REACH = 15u;
+static const uint32_t N_TAPS = (HILBERT_REACH + 1u) / 2u;
+
+// log2(1 + t) over [0, 1), within 1.5e-5:  coefficients of t to t^5.
+static const float LOG2_POLY[] = {
+	1.441965040e+00f, -7.096572833e-01f, 4.175790894e-01f,
+	-1.962497468e-01f, 4.637718371e-02f
+};
+
+// dB of power per unit of its log2.
+static const float DB_PER_LOG2 = 3.0102999566f;
+
+// Powers are taken as at least this, which keeps them normal.
+static const float MIN_POWER = 1.0e-30f;
+
+static const float WHITE = 255.0f;
+
+//***********************  Local Function Declarations  **********************//
+static bool hasAvx2();
+static bool locate(
+		const ScanGeometry& geometry,
+		double x,
+		double z,
+		uint32_t& iLine,
+		float& lineFrac,
+		uint32_t& iSample,
+		float& sampleFrac
+);
+static uint32_t envelopeScalar(
+		float* pOut,
+		const float* pIn,
+		uint32_t n,
+		const float* pTaps,
+		float scale,
+		float offset
+);
+static uint32_t scanScalar(
+		uint8_t* pOut,
+		const float* pBox,
+		uint32_t boxStride,
+		const int32_t* pOffset,
+		const float* pLineFrac,
+		const float* pSampleFrac,
+		uint32_t n
+);
+#if OI_BMODE_X86
+static uint32_t envelopeAvx2(
+		float* pOut,
+		const float* pIn,
+		uint32_t n,
+		const float* pTaps,
+		float scale,
+		float offset
+);
+static uint32_t scanAvx2(
+		uint8_t* pOut,
+		const float* pBox,
+		uint32_t boxStride,
+		const int32_t* pOffset,
+		const float* pLineFrac,
+		const float* pSampleFrac,
+		uint32_t n
+);
+#endif
+
+//****************************  Global Functions  ****************************//
+
+ScanGeometry scanOfImage(const DasImage& image)
+{
+	ScanGeometry geometry;
+
+	geometry.originXUm = image.columnXUm;
+	geometry.originZUm.assign(image.columnXUm.size(), 0.0f);
+	geometry.angleDeg.assign(image.columnXUm.size(), 0.0f);
+	geometry.startUm = image.depthStartUm;
+	geometry.stepUm = image.depthStepUm;
+	geometry.nSamples = image.nDepth;
+
+	return geometry;
+}
+
+ScanGeometry scanOfFrame(
+		const FrameProgram& program,
+		float speedOfSound,
+		double sampleRateHz
+) {
+	ScanGeometry geometry;
+	const uint32_t nShots = program.getNShots();
+
+	geometry.originXUm.assign(nShots, 0.0f);
+	geometry.originZUm.assign(nShots, 0.0f);
+	geometry.angleDeg.assign(nShots, 0.0f);
+	geometry.stepUm = (float) (speedOfSound * UM_PER_M / (2.0 * sampleRateHz));
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		geometry.nSamples = std::max(geometry.nSamples,
+				program.getShot(iShot).rx.nSamples);
+	}
+
+	return geometry;
+}
+
+BModeConverter::BModeConverter(bool isSimd)
+	: isSimd(isSimd && hasAvx2())
+{
+	for (uint32_t k = 0u; k < N_TAPS; ++k) {
+		const double n = 2.0 * k + 1.0;
+		taps.push_back((float) (2.0 / (PI * n)
+				* (0.54 + 0.46 * std::cos(PI * n / (HILBERT_REACH + 1u)))));
+	}
+}
+
+bool BModeConverter::plan(const ScanGeometry& geometry, const ScanGrid& grid)
+{
+	const std::size_t nLines = geometry.originXUm.size();
+
+	if (!tiles.empty() && geometry == this->geometry && grid == this->grid) {
+		return true;
+	} else if (nLines < 2u || geometry.originZUm.size() != nLines
+			|| geometry.angleDeg.size() != nLines
+			|| geometry.nSamples < 2u || geometry.stepUm <= 0.0f
+			|| grid.width == 0u || grid.height == 0u || grid.pixelUm <= 0.0f) {
+		tiles.clear();
+		return false;
+	} else {
+		// New tables.
+	}
+
+	this->geometry = geometry;
+	this->grid = grid;
+	tiles.clear();
+	offset.clear();
+	lineFrac.clear();
+	sampleFrac.clear();
+
+	std::size_t boxMax = 0u;
+	uint32_t nSamplesMax = 0u;
+	std::vector<uint32_t> iLines, iSamples;
+
+	for (uint32_t y0 = 0u; y0 < grid.height; y0 += TILE_HEIGHT) {
+		for (uint32_t x0 = 0u; x0 < grid.width; x0 += TILE_WIDTH) {
+			Tile tile = {
+				x0, y0,
+				std::min(TILE_WIDTH, grid.width - x0),
+				std::min(TILE_HEIGHT, grid.height - y0),
+				0u, 0u, 0u, 0u,
+				offset.size()
+			};
+			uint32_t
+				line0 = UINT32_MAX, line1 = 0u,
+				sample0 = UINT32_MAX, sample1 = 0u;
+
+			iLines.clear();
+			iSamples.clear();
+			for (uint32_t y = y0; y < y0 + tile.height; ++y) {
+				for (uint32_t x = x0; x < x0 + tile.width; ++x) {
+					uint32_t iLine = 0u, iSample = 0u;
+					float fLine = 0.0f, fSample = 0.0f;
+					const bool isIn = locate(
+							geometry,
+							grid.xStartUm + (double) x * grid.pixelUm,
+							grid.zStartUm + (double) y * grid.pixelUm,
+							iLine, fLine, iSample, fSample
+					);
+
+					if (isIn) {
+						line0 = std::min(line0, iLine);
+						line1 = std::max(line1, iLine + 1u);
+						sample0 = std::min(sample0, iSample);
+						sample1 = std::max(sample1, iSample + 1u);
+					} else {
+						iLine = UINT32_MAX;
+					}
+					iLines.push_back(iLine);
+					iSamples.push_back(iSample);
+					lineFrac.push_back(fLine);
+					sampleFrac.push_back(fSample);
+				}
+			}
+
+			if (line0 != UINT32_MAX) {
+				tile.line0 = line0;
+				tile.nLines = line1 - line0 + 1u;
+				tile.sample0 = sample0;
+				tile.nSamples = sample1 - sample0 + 1u;
+				boxMax = std::max(boxMax,
+						(std::size_t) tile.nLines * tile.nSamples);
+				nSamplesMax = std::max(nSamplesMax, tile.nSamples);
+			} else {
+				// Entirely outside the scan.
+			}
+			for (std::size_t i = 0u; i < iLines.size(); ++i) {
+				offset.push_back(iLines[i] == UINT32_MAX
+						? -1
+						: (int32_t) ((iLines[i] - tile.line0) * tile.nSamples
+								+ iSamples[i] - tile.sample0));
+			}
+
+			tiles.push_back(tile);
+		}
+	}
+
+	box.assign(boxMax, 0.0f);
+	padded.assign(nSamplesMax + 2u * HILBERT_REACH, 0.0f);
+
+	return true;
+}
+
+bool BModeConverter::convert(
+		uint8_t* pImage,
+		const float* pLines,
+		std::size_t stride,
+		const BModeCompression& compression
+) {
+	if (tiles.empty() || stride < geometry.nSamples) {
+		return false;
+	} else {
+		// Planned.
+	}
+
+	// From the log2 of the power to the grey level:
+	const float
+		scale = DB_PER_LOG2 * WHITE / compression.dynamicRangeDb,
+		shift = -(compression.topDb - compression.dynamicRangeDb) * WHITE
+				/ compression.dynamicRangeDb;
+
+	for (const Tile& tile : tiles) {
+		if (tile.nLines > 0u) {
+			compress(tile, pLines, stride, scale, shift);
+		} else {
+			// Nothing to compress.
+		}
+
+		for (uint32_t y = 0u; y < tile.height; ++y) {
+			const std::size_t k = tile.iFirstPixel + (std::size_t) y * tile.width;
+			uint8_t* const pOut = pImage
+					+ (std::size_t) (tile.y0 + y) * grid.width + tile.x0;
+			uint32_t nDone = 0u;
+
+#if OI_BMODE_X86
+			if (isSimd) {
+				nDone = scanAvx2(pOut, box.data(), tile.nSamples,
+						&offset[k], &lineFrac[k], &sampleFrac[k], tile.width);
+			} else {
+				// Scalar only.
+			}
+#endif
+			scanScalar(pOut + nDone, box.data(), tile.nSamples,
+					&offset[k + nDone], &lineFrac[k + nDone],
+					&sampleFrac[k + nDone], tile.width - nDone);
+		}
+	}
+
+	return true;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Fills the tile's box with the compressed envelope of its lines.
+void BModeConverter::compress(
+		const Tile& tile,
+		const float* pLines,
+		std::size_t stride,
+		float scale,
+		float shift
+) {
+	const int64_t first = (int64_t) tile.sample0 - HILBERT_REACH;
+	const uint32_t nPadded = tile.nSamples + 2u * HILBERT_REACH;
+
+	for (uint32_t iLine = 0u; iLine < tile.nLines; ++iLine) {
+		const float* const pIn = pLines + (tile.line0 + iLine) * stride;
+		float* const pOut = &box[(std::size_t) iLine * tile.nSamples];
+
+		// The recording, and zero either side:
+		const int64_t
+			i0 = std::max<int64_t>(first, 0),
+			i1 = std::min<int64_t>(first + nPadded, geometry.nSamples);
+		std::fill_n(padded.data(), nPadded, 0.0f);
+		if (i1 > i0) {
+			std::memcpy(&padded[i0 - first], pIn + i0,
+					(std::size_t) (i1 - i0) * sizeof(float));
+		} else {
+			// All margin.
+		}
+
+		const float* const pCentre = &padded[HILBERT_REACH];
+		uint32_t nDone = 0u;
+#if OI_BMODE_X86
+		if (isSimd) {
+			nDone = envelopeAvx2(pOut, pCentre, tile.nSamples, taps.data(),
+					scale, shift);
+		} else {
+			// Scalar only.
+		}
+#endif
+		envelopeScalar(pOut + nDone, pCentre + nDone, tile.nSamples - nDone,
+				taps.data(), scale, shift);
+	}
+}
+
+static bool hasAvx2()
+{
+#if OI_BMODE_X86
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// Finds the lines either side of a point, from its signed distance across
+//  each (which falls from line to line), and where it lies along them.
+//  Returns false if it lies outside the scan.
+static bool locate(
+		const ScanGeometry& geometry,
+		double x,
+		double z,
+		uint32_t& iLine,
+		float& lineFrac,
+		uint32_t& iSample,
+		float& sampleFrac
+) {
+	const uint32_t nLines = (uint32_t) geometry.originXUm.size();
+	const auto across = [&](uint32_t i) {
+		const double a = geometry.angleDeg[i] * PI / 180.0;
+		return (x - geometry.originXUm[i]) * std::cos(a)
+				- (z - geometry.originZUm[i]) * std::sin(a);
+	};
+	const auto along = [&](uint32_t i) {
+		const double a = geometry.angleDeg[i] * PI / 180.0;
+		return (x - geometry.originXUm[i]) * std::sin(a)
+				+ (z - geometry.originZUm[i]) * std::cos(a);
+	};
+
+	uint32_t lo = 0u, hi = nLines - 1u;
+	double dLo = across(lo), dHi = across(hi);
+	if (dLo < 0.0 || dHi > 0.0) {
+		return false;
+	} else {
+		// Between the first and last lines.
+	}
+	while (hi - lo > 1u) {
+		const uint32_t mid = (lo + hi) / 2u;
+		const double d = across(mid);
+		if (d >= 0.0) {
+			lo = mid;
+			dLo = d;
+		} else {
+			hi = mid;
+			dHi = d;
+		}
+	}
+
+	const double
+		f = dLo > dHi ? dLo / (dLo - dHi) : 0.0,
+		t = along(lo) + (along(hi) - along(lo)) * f,
+		s = (t - geometry.startUm) / geometry.stepUm;
+	if (s < 0.0 || s > geometry.nSamples - 1.0) {
+		return false;
+	} else {
+		// Within the recording.
+	}
+
+	iLine = lo;
+	lineFrac = (float) f;
+	iSample = std::min((uint32_t) s, geometry.nSamples - 2u);
+	sampleFrac = (float) (s - iSample);
+
+	return true;
+}
+
+// Compresses n samples, which have HILBERT_REACH samples of margin either
+//  side.  Returns n.
+static uint32_t envelopeScalar(
+		float* pOut,
+		const float* pIn,
+		uint32_t n,
+		const float* pTaps,
+		float scale,
+		float shift
+) {
+	for (uint32_t i = 0u; i < n; ++i) {
+		float h = 0.0f;
+		for (uint32_t k = 0u; k < N_TAPS; ++k) {
+			const uint32_t d = 2u * k + 1u;
+			h += pTaps[k] * (pIn[(int32_t) i - (int32_t) d] - pIn[i + d]);
+		}
+
+		const float power = std::max(pIn[i] * pIn[i] + h * h, MIN_POWER);
+		uint32_t bits;
+		std::memcpy(&bits, &power, sizeof(bits));
+		const float exponent = (float) ((int32_t) (bits >> 23) - 127);
+		const uint32_t mBits = (bits & 0x007FFFFFu) | 0x3F800000u;
+		float m;
+		std::memcpy(&m, &mBits, sizeof(m));
+
+		const float
+			t = m - 1.0f,
+			log2 = exponent + t * (LOG2_POLY[0] + t * (LOG2_POLY[1]
+					+ t * (LOG2_POLY[2] + t * (LOG2_POLY[3]
+					+ t * LOG2_POLY[4])))),
+			grey = log2 * scale + shift;
+
+		pOut[i] = std::min(std::max(grey, 0.0f), WHITE);
+	}
+
+	return n;
+}
+
+// Interpolates n pixels of a row from the box, whose lines are boxStride
+//  samples.  Returns n.
+static uint32_t scanScalar(
+		uint8_t* pOut,
+		const float* pBox,
+		uint32_t boxStride,
+		const int32_t* pOffset,
+		const float* pLineFrac,
+		const float* pSampleFrac,
+		uint32_t n
+) {
+	for (uint32_t i = 0u; i < n; ++i) {
+		if (pOffset[i] >= 0) {
+			const float* const p = pBox + pOffset[i];
+			const float
+				a = p[0] + (p[1] - p[0]) * pSampleFrac[i],
+				b = p[boxStride] + (p[boxStride + 1u] - p[boxStride])
+						* pSampleFrac[i];
+
+			pOut[i] = (uint8_t) std::nearbyint(a + (b - a) * pLineFrac[i]);
+		} else {
+			pOut[i] = 0u;
+		}
+	}
+
+	return n;
+}
+
+#if OI_BMODE_X86
+
+// As envelopeScalar, eight samples at a time.  Returns the number done.
+__attribute__((target("avx2")))
+static uint32_t envelopeAvx2(
+		float* pOut,
+		const float* pIn,
+		uint32_t n,
+		const float* pTaps,
+		float scale,
+		float shift
+) {
+	const __m256
+		minPower = _mm256_set1_ps(MIN_POWER),
+		one = _mm256_set1_ps(1.0f),
+		zero = _mm256_setzero_ps(),
+		white = _mm256_set1_ps(WHITE),
+		vScale = _mm256_set1_ps(scale),
+		vShift = _mm256_set1_ps(shift);
+	const __m256i
+		mantissa = _mm256_set1_epi32(0x007FFFFF),
+		oneBits = _mm256_set1_epi32(0x3F800000),
+		bias = _mm256_set1_epi32(127);
+	const uint32_t nDone = n & ~7u;
+
+	for (uint32_t i = 0u; i < nDone; i += 8u) {
+		const __m256 x = _mm256_loadu_ps(pIn + i);
+		__m256 h = zero;
+		for (uint32_t k = 0u; k < N_TAPS; ++k) {
+			const uint32_t d = 2u * k + 1u;
+			h = _mm256_add_ps(h, _mm256_mul_ps(_mm256_set1_ps(pTaps[k]),
+					_mm256_sub_ps(_mm256_loadu_ps(pIn + i - d),
+							_mm256_loadu_ps(pIn + i + d))));
+		}
+
+		const __m256 power = _mm256_max_ps(_mm256_add_ps(_mm256_mul_ps(x, x),
+				_mm256_mul_ps(h, h)), minPower);
+		const __m256i bits = _mm256_castps_si256(power);
+		const __m256
+			exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(
+					_mm256_srli_epi32(bits, 23), bias)),
+			t = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(
+					_mm256_and_si256(bits, mantissa), oneBits)), one);
+		__m256 poly = _mm256_set1_ps(LOG2_POLY[4]);
+		for (int j = 3; j >= 0; --j) {
+			poly = _mm256_add_ps(_mm256_set1_ps(LOG2_POLY[j]),
+					_mm256_mul_ps(t, poly));
+		}
+		const __m256 grey = _mm256_add_ps(_mm256_mul_ps(
+				_mm256_add_ps(exponent, _mm256_mul_ps(t, poly)), vScale),
+				vShift);
+
+		_mm256_storeu_ps(pOut + i,
+				_mm256_min_ps(_mm256_max_ps(grey, zero), white));
+	}
+
+	return nDone;
+}
+
+// As scanScalar, eight pixels at a time; pixels outside the scan gather
+//  the box's first samples, and are zeroed.  Returns the number done.
+__attribute__((target("avx2")))
+static uint32_t scanAvx2(
+		uint8_t* pOut,
+		const float* pBox,
+		uint32_t boxStride,
+		const int32_t* pOffset,
+		const float* pLineFrac,
+		const float* pSampleFrac,
+		uint32_t n
+) {
+	const __m256i
+		one = _mm256_set1_epi32(1),
+		next = _mm256_set1_epi32((int32_t) boxStride),
+		none = _mm256_set1_epi32(-1);
+	const uint32_t nDone = n & ~7u;
+
+	for (uint32_t i = 0u; i < nDone; i += 8u) {
+		const __m256i offset = _mm256_loadu_si256((const __m256i*) (pOffset + i));
+		const __m256i isIn = _mm256_cmpgt_epi32(offset, none);
+		const __m256i
+			k00 = _mm256_and_si256(offset, isIn),
+			k10 = _mm256_add_epi32(k00, next);
+		const __m256
+			p00 = _mm256_i32gather_ps(pBox, k00, 4),
+			p01 = _mm256_i32gather_ps(pBox, _mm256_add_epi32(k00, one), 4),
+			p10 = _mm256_i32gather_ps(pBox, k10, 4),
+			p11 = _mm256_i32gather_ps(pBox, _mm256_add_epi32(k10, one), 4),
+			fs = _mm256_loadu_ps(pSampleFrac + i),
+			a = _mm256_add_ps(p00, _mm256_mul_ps(_mm256_sub_ps(p01, p00), fs)),
+			b = _mm256_add_ps(p10, _mm256_mul_ps(_mm256_sub_ps(p11, p10), fs)),
+			v = _mm256_and_ps(_mm256_add_ps(a, _mm256_mul_ps(_mm256_sub_ps(b, a),
+					_mm256_loadu_ps(pLineFrac + i))), _mm256_castsi256_ps(isIn));
+		const __m256i grey = _mm256_cvtps_epi32(v);
+		const __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(grey),
+				_mm256_extracti128_si256(grey, 1));
+
+		_mm_storel_epi64((__m128i*) (pOut + i), _mm_packus_epi16(words, words));
+	}
+
+	return nDone;
+}
+
+#endif
+
+} // namespace oi
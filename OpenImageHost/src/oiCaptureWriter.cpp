@@ -0,0 +1,420 @@
+/*
+	oiCaptureWriter.cpp
+
+	Writes frames to a recording, on a thread of its own.  With io_uring,
+	the thread keeps up to nWrites frames in flight, and a read of the
+	eventfd that commit signals, so that one wait serves both:  a write
+	completing, or another frame to write.  The header's page is written
+	once its last write has completed, and only then rewritten.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiCaptureWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Tags of the ring's operations other than frames, whose tags are their
+//  buffers.
+static const uint64_t WAKE_TAG = ~0ull;
+static const uint64_t HEADER_TAG = ~0ull - 1u;
+
+//***********************  Local Function Declarations  **********************//
+static uint64_t roundToPage(uint64_t nBytes);
+
+//****************************  Global Functions  ****************************//
+
+CaptureWriter::CaptureWriter(const CaptureWriterOptions& options)
+	: options(options), idle(options.nBuffers), ready(options.nBuffers)
+{}
+
+bool CaptureWriter::create(const std::string& path,
+		const FrameProgram& program)
+{
+	close();
+	if (program.getNShots() == 0u || options.nBuffers == 0u) {
+		return false;
+	} else {
+		// Something to record.
+	}
+
+	const int flags = O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC;
+	fd = options.isDirect ? ::open(path.c_str(), flags | O_DIRECT, 0644) : -1;
+	isFileDirect = fd >= 0;
+	fd = isFileDirect ? fd : ::open(path.c_str(), flags, 0644);
+	wakeFd = ::eventfd(0u, EFD_CLOEXEC);
+	if (fd < 0 || wakeFd < 0) {
+		close();
+		return false;
+	} else {
+		// Open.
+	}
+
+	header = makeRecordingHeader(program);
+	shotOffset = recordingShotOffsets(program);
+	pBuffers = (uint8_t*) std::aligned_alloc(RECORDING_PAGE_BYTES,
+			options.nBuffers * header.frameStride);
+	pHeaderPage = (uint8_t*) std::aligned_alloc(RECORDING_PAGE_BYTES,
+			header.frameOffset);
+	if (pBuffers == nullptr || pHeaderPage == nullptr) {
+		close();
+		return false;
+	} else {
+		// Touch every page now, rather than as each is first received into.
+		std::memset(pBuffers, 0, options.nBuffers * header.frameStride);
+		std::memset(pHeaderPage, 0, header.frameOffset);
+	}
+
+	// The header and program:
+	std::memcpy(pHeaderPage, &header, sizeof(header));
+	for (uint32_t iShot = 0u; iShot < header.nShots; ++iShot) {
+		std::memcpy(pHeaderPage + header.programOffset + iShot * sizeof(OI_SHOT),
+				&program.getShot(iShot), sizeof(OI_SHOT));
+	}
+	if (!writeAt(pHeaderPage, header.frameOffset, 0u)) {
+		close();
+		return false;
+	} else {
+		// Ready for frames.
+	}
+
+	for (uint32_t iBuffer = 0u; iBuffer < options.nBuffers; ++iBuffer) {
+		idle.push(iBuffer);
+	}
+	index.clear();
+	frameOf.assign(options.nBuffers, 0u);
+	extendedTo = header.frameOffset;
+	nCommitted = 0u;
+	nWritten = 0u;
+	nErrors = 0u;
+	maxQueued = 0u;
+	isStopping = false;
+
+	ring.reset(options.isUring ? new Uring(options.nWrites + 2u) : nullptr);
+	isRingUsed = ring != nullptr && ring->isOpen();
+	writer = std::thread(&CaptureWriter::write, this);
+
+	return true;
+}
+
+uint8_t* CaptureWriter::acquire()
+{
+	uint32_t iBuffer;
+	return idle.pop(iBuffer) ? pBuffers + iBuffer * header.frameStride : nullptr;
+}
+
+void CaptureWriter::commit(uint8_t* pBuffer, uint64_t receivedNs)
+{
+	++nCommitted;
+	push({ (uint32_t) ((pBuffer - pBuffers) / header.frameStride), true,
+			receivedNs });
+}
+
+void CaptureWriter::discard(uint8_t* pBuffer)
+{
+	push({ (uint32_t) ((pBuffer - pBuffers) / header.frameStride), false,
+			0u });
+}
+
+bool CaptureWriter::close()
+{
+	if (writer.joinable()) {
+		isStopping = true;
+		wake();
+		writer.join();
+	} else {
+		// Not writing.
+	}
+
+	bool ok = true;
+	if (fd >= 0 && pHeaderPage != nullptr) {
+		// The index, whole pages of it, then the header that finds it:
+		index.resize(header.nFrames);
+		header.indexOffset = header.frameOffset
+				+ header.nFrames * header.frameStride;
+		const std::size_t
+			nIndex = index.size() * sizeof(RecordingIndexEntry),
+			nPages = roundToPage(nIndex);
+		uint8_t* const pIndex = nPages > 0u
+				? (uint8_t*) std::aligned_alloc(RECORDING_PAGE_BYTES, nPages)
+				: nullptr;
+		if (pIndex != nullptr) {
+			std::memset(pIndex, 0, nPages);
+			std::memcpy(pIndex, index.data(), nIndex);
+			ok = writeAt(pIndex, nPages, header.indexOffset);
+			std::free(pIndex);
+		} else {
+			ok = nPages == 0u;
+		}
+
+		std::memcpy(pHeaderPage, &header, sizeof(header));
+		ok = ok && writeAt(pHeaderPage, RECORDING_PAGE_BYTES, 0u)
+				&& ::ftruncate(fd, (off_t) (header.indexOffset + nIndex)) == 0
+				&& nErrors == 0u;
+	} else {
+		// Nothing written.
+	}
+
+	if (fd >= 0) {
+		::close(fd);
+		fd = -1;
+	} else {
+		// Not open.
+	}
+	if (wakeFd >= 0) {
+		::close(wakeFd);
+		wakeFd = -1;
+	} else {
+		// Not open.
+	}
+	ring.reset();
+	isRingUsed = false;
+	std::free(pBuffers);
+	std::free(pHeaderPage);
+	pBuffers = nullptr;
+	pHeaderPage = nullptr;
+
+	// The writer has stopped, so this thread may empty both queues.
+	uint32_t iBuffer;
+	Item item;
+	while (idle.pop(iBuffer) || ready.pop(item)) {
+		// Dropped.
+	}
+
+	return ok;
+}
+
+CaptureWriterStats CaptureWriter::getStats() const
+{
+	CaptureWriterStats stats;
+
+	stats.nCommitted = nCommitted;
+	stats.nWritten = nWritten;
+	stats.nBytesWritten = stats.nWritten * header.frameStride;
+	stats.nErrors = nErrors;
+	stats.maxQueued = maxQueued;
+
+	return stats;
+}
+
+void CaptureWriter::push(const Item& item)
+{
+	// There are no more items than buffers, for which there is room.
+	ready.push(item);
+	maxQueued = std::max<std::size_t>(maxQueued, ready.size());
+	wake();
+}
+
+void CaptureWriter::write()
+{
+	if (isRingUsed) {
+		writeRing();
+	} else {
+		writeSync();
+	}
+}
+
+void CaptureWriter::writeRing()
+{
+	const std::size_t nBuffers = options.nBuffers;
+	std::vector<bool> isDone(nBuffers, false);    // by frame, modulo nBuffers
+	uint64_t nFrames = 0u, nOnDisk = 0u;
+	unsigned nInFlight = 0u;
+	bool ok = true, isWakeArmed = false, isHeaderBusy = false;
+
+	while (true) {
+		// Start writing what is ready, while there is room, and the frames
+		//  not yet counted have each their own slot in isDone:
+		Item item;
+		while (nInFlight < options.nWrites
+				&& (!ok || nFrames - nOnDisk < nBuffers) && ready.pop(item)) {
+			uint8_t* const pBuffer = pBuffers + item.iBuffer * header.frameStride;
+			if (item.isFilled && ok) {
+				const uint64_t offset = header.frameOffset
+						+ nFrames * header.frameStride;
+				const uint8_t* const ppData[OI_RX_N_CHIPS] = {
+					pBuffer + header.adcOffset[0], pBuffer + header.adcOffset[1]
+				};
+				extendTo(offset + header.frameStride);
+				index.push_back(indexRecordingFrame(ppData, shotOffset, offset,
+						item.receivedNs));
+				frameOf[item.iBuffer] = nFrames++;
+				ring->write(fd, pBuffer, (uint32_t) header.frameStride, offset,
+						item.iBuffer);
+				++nInFlight;
+			} else {
+				// Not received, or not to be written after a failure.
+				idle.push(item.iBuffer);
+			}
+		}
+
+		// Count the frames now on disk, in order, in the header:
+		while (nOnDisk < nFrames && isDone[nOnDisk % nBuffers]) {
+			isDone[nOnDisk % nBuffers] = false;
+			++nOnDisk;
+		}
+		nWritten = nOnDisk;
+		if (!isHeaderBusy && header.nFrames < nOnDisk) {
+			header.nFrames = nOnDisk;
+			std::memcpy(pHeaderPage, &header, sizeof(header));
+			ring->write(fd, pHeaderPage, RECORDING_PAGE_BYTES, 0u, HEADER_TAG);
+			isHeaderBusy = true;
+		} else {
+			// Being written, or current.
+		}
+
+		if (isStopping && nInFlight == 0u && !isHeaderBusy
+				&& ready.size() == 0u) {
+			break;
+		} else if (!isWakeArmed) {
+			ring->read(wakeFd, &wakeCount, sizeof(wakeCount), 0u, WAKE_TAG);
+			isWakeArmed = true;
+		} else {
+			// Already waiting for a commit.
+		}
+
+		if (!ring->submit(1u)) {
+			++nErrors;
+			break;
+		} else {
+			// Something completed.
+		}
+
+		UringCompletion completion;
+		while (ring->complete(completion)) {
+			if (completion.tag == WAKE_TAG) {
+				isWakeArmed = false;
+			} else if (completion.tag == HEADER_TAG) {
+				isHeaderBusy = false;
+				if (completion.result != (int32_t) RECORDING_PAGE_BYTES) {
+					ok = false;
+					++nErrors;
+				} else {
+					// Written.
+				}
+			} else {
+				const uint32_t iBuffer = (uint32_t) completion.tag;
+				--nInFlight;
+				if (completion.result == (int32_t) header.frameStride) {
+					isDone[frameOf[iBuffer] % nBuffers] = true;
+				} else {
+					// Never counted, nor any frame after it.
+					ok = false;
+					++nErrors;
+				}
+				idle.push(iBuffer);
+			}
+		}
+	}
+}
+
+void CaptureWriter::writeSync()
+{
+	bool ok = true;
+
+	while (true) {
+		Item item;
+
+		if (ready.pop(item)) {
+			uint8_t* const pBuffer = pBuffers + item.iBuffer * header.frameStride;
+			if (item.isFilled && ok) {
+				const uint64_t offset = header.frameOffset
+						+ header.nFrames * header.frameStride;
+				const uint8_t* const ppData[OI_RX_N_CHIPS] = {
+					pBuffer + header.adcOffset[0], pBuffer + header.adcOffset[1]
+				};
+				extendTo(offset + header.frameStride);
+				index.push_back(indexRecordingFrame(ppData, shotOffset, offset,
+						item.receivedNs));
+				ok = writeAt(pBuffer, header.frameStride, offset);
+				if (ok) {
+					++header.nFrames;
+					std::memcpy(pHeaderPage, &header, sizeof(header));
+					ok = writeAt(pHeaderPage, RECORDING_PAGE_BYTES, 0u);
+					nWritten = header.nFrames;
+				} else {
+					// Not counted.
+				}
+				nErrors += ok ? 0u : 1u;
+			} else {
+				// Not received, or not to be written after a failure.
+			}
+			idle.push(item.iBuffer);
+		} else if (isStopping) {
+			break;
+		} else if (::read(wakeFd, &wakeCount, sizeof(wakeCount)) < 0
+				&& errno != EINTR) {
+			++nErrors;
+			break;
+		} else {
+			// Woken.
+		}
+	}
+}
+
+void CaptureWriter::wake()
+{
+	const uint64_t one = 1u;
+	while (::write(wakeFd, &one, sizeof(one)) < 0 && errno == EINTR) {
+		// Again.
+	}
+}
+
+// Extends the file by at least extendBytes beyond end, if it is not yet
+//  that long; where that is not supported, the writes extend it.
+void CaptureWriter::extendTo(uint64_t end)
+{
+	if (end > extendedTo) {
+		const uint64_t to = std::max(end, extendedTo + options.extendBytes);
+#if defined(__linux__)
+		const bool ok = ::fallocate(fd, 0, (off_t) extendedTo,
+				(off_t) (to - extendedTo)) == 0;
+#else
+		const bool ok = false;
+#endif
+		extendedTo = ok ? to : ~0ull;
+	} else {
+		// Long enough.
+	}
+}
+
+bool CaptureWriter::writeAt(const void* pData, std::size_t nBytes,
+		uint64_t offset)
+{
+	const uint8_t* p = (const uint8_t*) pData;
+	bool ok = true;
+
+	while (nBytes > 0u && ok) {
+		const ssize_t n = ::pwrite(fd, p, nBytes, (off_t) offset);
+		if (n > 0) {
+			p += n;
+			offset += (uint64_t) n;
+			nBytes -= (std::size_t) n;
+		} else {
+			ok = n < 0 && errno == EINTR;
+		}
+	}
+
+	return ok;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static uint64_t roundToPage(uint64_t nBytes)
+{
+	return (nBytes + RECORDING_PAGE_BYTES - 1u) / RECORDING_PAGE_BYTES
+			* RECORDING_PAGE_BYTES;
+}
+
+} // namespace oi
@@ -0,0 +1,430 @@
+/*
+	oiClient.cpp
+
+	Host-side client of the Open Image protocol, over POSIX sockets.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiClient.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <memory>
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// OI_MAGIC, the command or response code, and the payload's length.
+static const std::size_t HEADER_BYTES = 4u;
+
+//**********************************  Types  *********************************//
+// A frame being read, shared by the requests for its pieces.
+struct Client::FrameState {
+	std::mutex mutex;
+	FrameResult result;
+	std::size_t nLeft;                   // requests not yet answered
+	FrameCallback done;
+};
+
+//****************************  Global Functions  ****************************//
+
+Client::Client(const ClientOptions& options) : options(options) {}
+
+Client::~Client() { close(); }
+
+bool Client::connect(const std::string& host, uint16_t port)
+{
+	if (fd >= 0) {
+		return false;
+	} else {
+		// Not yet.
+	}
+
+	addrinfo hints = {}, *pInfo = nullptr;
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	const std::string service = std::to_string(port);
+	if (getaddrinfo(host.c_str(), service.c_str(), &hints, &pInfo) != 0) {
+		return false;
+	} else {
+		// Resolved.
+	}
+
+	for (const addrinfo* p = pInfo; p != nullptr && fd < 0; p = p->ai_next) {
+		fd = ::socket(p->ai_family, p->ai_socktype, p->ai_protocol);
+		if (fd >= 0 && ::connect(fd, p->ai_addr, p->ai_addrlen) != 0) {
+			::close(fd);
+			fd = -1;
+		} else {
+			// Connected, or no socket.
+		}
+	}
+	freeaddrinfo(pInfo);
+
+	if (fd >= 0) {
+		// Requests are small, and each is waited on:  send them at once.
+		const int one = 1;
+		setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		isOpen = true;
+		receiver = std::thread(&Client::receive, this);
+	} else {
+		// No address would connect.
+	}
+
+	return fd >= 0;
+}
+
+void Client::close()
+{
+	if (fd >= 0) {
+		// The receiver fails whatever is still pending.
+		shutdown(fd, SHUT_RDWR);
+		receiver.join();
+		::close(fd);
+		fd = -1;
+	} else {
+		// Not connected.
+	}
+}
+
+bool Client::isConnected() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return isOpen;
+}
+
+void Client::send(uint8_t cmd, const void* pPayload, std::size_t nPayload,
+		Callback done)
+{
+	request(cmd, pPayload, nPayload, nullptr, 0u, std::move(done));
+}
+
+std::future<Reply> Client::send(uint8_t cmd, const void* pPayload,
+		std::size_t nPayload)
+{
+	const auto pPromise = std::make_shared<std::promise<Reply>>();
+	std::future<Reply> future = pPromise->get_future();
+
+	send(cmd, pPayload, nPayload,
+			[pPromise](const Reply& reply) { pPromise->set_value(reply); });
+
+	return future;
+}
+
+std::future<Reply> Client::getStatus()
+{
+	return send(OI_CMD_GET_STATUS, nullptr, 0u);
+}
+
+std::future<Reply> Client::getBootProfile()
+{
+	return send(OI_CMD_GET_BOOT_PROFILE, nullptr, 0u);
+}
+
+std::future<Reply> Client::getTiming()
+{
+	return send(OI_CMD_GET_TIMING, nullptr, 0u);
+}
+
+std::future<Reply> Client::getVersion()
+{
+	return send(OI_CMD_GET_VERSION, nullptr, 0u);
+}
+
+// Sends only the request's nShots shots.
+std::future<Reply> Client::estimateFrame(const OI_ESTIMATE_REQ& req)
+{
+	return send(OI_CMD_ESTIMATE_FRAME, &req,
+			OI_ESTIMATE_REQ_BYTES(std::min<uint32_t>(req.nShots,
+					OI_MAX_N_SHOTS)));
+}
+
+// The program must have been built.
+std::future<Reply> Client::queueFrame(const FrameProgram& program)
+{
+	return send(program.getCommand(), program.getBytes().data(),
+			program.getBytes().size());
+}
+
+std::future<Reply> Client::setIq(const OI_IQ_CONFIG& cfg)
+{
+	return send(OI_CMD_SET_IQ, &cfg, sizeof(cfg));
+}
+
+std::future<Reply> Client::setBeamform(const OI_BF_CONFIG& cfg)
+{
+	return send(OI_CMD_SET_BEAMFORM, &cfg, sizeof(cfg));
+}
+
+// The pieces of the two ADCs alternate, so that both arrive together.
+void Client::readFrame(const FrameBuffers& buffers, FrameCallback done)
+{
+	const std::size_t chunk = std::min(std::max<std::size_t>(
+			options.chunkBytes, 1u), (std::size_t) OI_MAX_REPLY_BYTES);
+	const auto pState = std::make_shared<FrameState>();
+	std::size_t maxBytes = 0u;
+
+	pState->result.ok = true;
+	pState->nLeft = 0u;
+	pState->done = std::move(done);
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		pState->nLeft += (buffers.nBytes[iAdc] + chunk - 1u) / chunk;
+		maxBytes = std::max(maxBytes, buffers.nBytes[iAdc]);
+	}
+
+	if (pState->nLeft == 0u) {
+		pState->done(pState->result);
+	} else {
+		// Ask for the pieces.
+	}
+
+	for (std::size_t offset = 0u; offset < maxBytes; offset += chunk) {
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			if (offset < buffers.nBytes[iAdc]) {
+				readPiece(buffers.pData[iAdc], iAdc, offset,
+						std::min(chunk, buffers.nBytes[iAdc] - offset), pState);
+			} else {
+				// This ADC's data are all asked for.
+			}
+		}
+	}
+}
+
+std::future<FrameResult> Client::readFrame(const FrameBuffers& buffers)
+{
+	const auto pPromise = std::make_shared<std::promise<FrameResult>>();
+	std::future<FrameResult> future = pPromise->get_future();
+
+	readFrame(buffers, [pPromise](const FrameResult& result) {
+		pPromise->set_value(result);
+	});
+
+	return future;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Queues a request and sends it.  The payload of the expected reply, if
+//  any, is received into pDest.
+void Client::request(uint8_t cmd, const void* pPayload, std::size_t nPayload,
+		uint8_t* pDest, std::size_t nDest, Callback done)
+{
+	if (nPayload > PACKET_MAX_PAYLOAD) {
+		done(Reply());
+		return;
+	} else {
+		// Fits in a packet.
+	}
+
+	const uint8_t header[HEADER_BYTES] = {
+		OI_MAGIC,
+		cmd,
+		(uint8_t) nPayload,
+		(uint8_t) (nPayload >> 8)
+	};
+	const uint8_t replyCode = cmd == OI_CMD_GET_FRAME ? OI_RES_FRAME
+			: cmd == OI_CMD_GET_FRAME_PACKED ? OI_RES_FRAME_PACKED
+			: OI_RES_ACK;
+
+	// Queued and written under sendMutex, so that the replies come in the
+	//  order of 'pending'; but 'done' is called after, as it may send.
+	bool isQueued;
+	{
+		std::lock_guard<std::mutex> sendLock(sendMutex);
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			room.wait(lock, [this] {
+				return !isOpen || pending.size() < options.maxInFlight;
+			});
+			isQueued = isOpen;
+			if (isQueued) {
+				pending.push_back({ replyCode, pDest, nDest, std::move(done) });
+			} else {
+				// Closed.
+			}
+		}
+
+		if (isQueued && !writeAll(header, pPayload, nPayload)) {
+			// The receiver fails this request with the others.
+			shutdown(fd, SHUT_RDWR);
+		} else {
+			// Sent, or not queued.
+		}
+	}
+
+	if (!isQueued) {
+		done(Reply());
+	} else {
+		// The receiver completes it.
+	}
+}
+
+// Asks for n bytes of an ADC's data, at offset, into pData + offset.
+void Client::readPiece(uint8_t* pData, uint32_t iAdc, std::size_t offset,
+		std::size_t n, const std::shared_ptr<FrameState>& pState)
+{
+	const OI_FRAME_DATA_REQ req = {
+		iAdc,
+		(uint32_t) offset,
+		(uint32_t) n
+	};
+
+	request(OI_CMD_GET_FRAME, &req, sizeof(req), &pData[offset], n,
+			[pState, iAdc, n](const Reply& reply) {
+		FrameCallback done;
+		{
+			std::lock_guard<std::mutex> lock(pState->mutex);
+			FrameResult& result = pState->result;
+
+			if (reply.code == OI_RES_FRAME && reply.nBytes == n
+					&& reply.data.empty()) {
+				result.nBytes[iAdc] += n;
+			} else {
+				result.ok = false;
+				result.error = result.error != OI_ERR_NONE
+						? result.error : reply.error;
+			}
+			if (--pState->nLeft == 0u) {
+				done = std::move(pState->done);
+			} else {
+				// More to come.
+			}
+		}
+		if (done) {
+			done(pState->result);
+		} else {
+			// Not the last.
+		}
+	});
+}
+
+// Runs on its own thread until the connection fails or is closed.
+void Client::receive()
+{
+	bool ok = true;
+
+	while (ok) {
+		uint8_t header[HEADER_BYTES];
+		Pending* pFront = nullptr;
+		Reply reply;
+
+		ok = readAll(header, sizeof(header)) && header[0] == OI_MAGIC;
+		if (ok) {
+			// Only this thread removes requests, so the front stays put.
+			std::lock_guard<std::mutex> lock(mutex);
+			ok = !pending.empty();
+			pFront = ok ? &pending.front() : nullptr;
+		} else {
+			// Closed, or out of step with the device.
+		}
+
+		if (ok) {
+			reply.code = header[1];
+			reply.nBytes = header[2] | (std::size_t) header[3] << 8;
+
+			if (pFront->pDest != nullptr && reply.code == pFront->replyCode
+					&& reply.nBytes <= pFront->nDest) {
+				ok = readAll(pFront->pDest, reply.nBytes);
+			} else {
+				reply.data.resize(reply.nBytes);
+				ok = readAll(reply.data.data(), reply.nBytes);
+			}
+
+			if (reply.code == OI_RES_NACK && !reply.data.empty()) {
+				reply.error = (oi_error_t) reply.data[0];
+			} else {
+				// Not refused.
+			}
+		} else {
+			// A reply to nothing.
+		}
+
+		if (ok) {
+			Pending done;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				done = std::move(pending.front());
+				pending.pop_front();
+			}
+			room.notify_all();
+			done.done(reply);
+		} else {
+			// Failed.
+		}
+	}
+
+	std::deque<Pending> failed;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isOpen = false;
+		failed.swap(pending);
+	}
+	room.notify_all();
+	for (Pending& p : failed) {
+		p.done(Reply());
+	}
+}
+
+bool Client::writeAll(const uint8_t* pHeader, const void* pPayload,
+		std::size_t nPayload)
+{
+	iovec iov[2] = {
+		{ const_cast<uint8_t*>(pHeader), HEADER_BYTES },
+		{ const_cast<void*>(pPayload), nPayload }
+	};
+	msghdr msg = {};
+	msg.msg_iov = iov;
+	msg.msg_iovlen = nPayload > 0u ? 2u : 1u;
+	bool ok = true;
+
+	while (ok && msg.msg_iovlen > 0u) {
+		const ssize_t n = ::sendmsg(fd, &msg, MSG_NOSIGNAL);
+		ok = n >= 0 || errno == EINTR;
+
+		// Skip what was sent:
+		for (std::size_t left = n > 0 ? (std::size_t) n : 0u; left > 0u; ) {
+			const std::size_t used = std::min(left, msg.msg_iov->iov_len);
+			msg.msg_iov->iov_base = (uint8_t*) msg.msg_iov->iov_base + used;
+			msg.msg_iov->iov_len -= used;
+			left -= used;
+			if (msg.msg_iov->iov_len == 0u) {
+				++msg.msg_iov;
+				--msg.msg_iovlen;
+			} else {
+				// Part of it left.
+			}
+		}
+	}
+
+	return ok;
+}
+
+bool Client::readAll(void* pOut, std::size_t nBytes)
+{
+	uint8_t* p = (uint8_t*) pOut;
+	bool ok = true;
+
+	while (ok && nBytes > 0u) {
+		const ssize_t n = ::recv(fd, p, nBytes, MSG_WAITALL);
+		if (n > 0) {
+			p += n;
+			nBytes -= (std::size_t) n;
+		} else {
+			ok = n < 0 && errno == EINTR;
+		}
+	}
+
+	return ok;
+}
+
+} // namespace oi
@@ -0,0 +1,491 @@
+/*
+	oiDas.cpp
+
+	Host-side delay-and-sum beamforming.  Each tile of the image is summed
+	channel by channel:  the interpolated samples of each of the column's
+	shots are added into a sum the size of the tile, one row of samples at
+	a time, and the sum is weighted by the channel's apodization and added
+	to the image.  A point's sum is therefore made in the same order
+	whatever the number of threads, and the AVX2 kernel, which gathers the
+	samples about eight delays at once, does the arithmetic of the scalar
+	version in the same order, so that every result is identical.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiDas.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define OI_DAS_X86 1
+#	include <immintrin.h>
+#else
+#	define OI_DAS_X86 0
+#endif
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const double PI = 3.14159265358979324;
+static const double UM_PER_M = 1.0e6;
+static const double UM_PER_NM = 1.0e-3;
+
+// Points of each column summed as one tile.
+static const uint32_t TILE_DEPTH = 256u;
+
+// The transmit delay of a point that no element's wave reaches; it puts
+//  every delay before the recording.
+static const float NO_DELAY = -1.0e30f;
+
+//**********************************  Types  *********************************//
+
+// An element that fires, and when, in samples.
+struct Firing {
+	double
+		xUm,
+		delay;
+};
+
+//***********************  Local Function Declarations  **********************//
+static bool hasAvx2();
+static std::vector<Firing> getFirings(
+		const OI_SHOT& shot,
+		const DasGeometry& geometry
+);
+static float arrival(
+		const std::vector<Firing>& firings,
+		double xUm,
+		double zUm,
+		double samplesPerUm
+);
+static uint32_t addRowScalar(
+		float* pSum,
+		const float* pRow,
+		const float* pTx,
+		const float* pRx,
+		uint32_t n,
+		uint32_t nSamples
+);
+#if OI_DAS_X86
+static uint32_t addRowAvx2(
+		float* pSum,
+		const float* pRow,
+		const float* pTx,
+		const float* pRx,
+		uint32_t n,
+		uint32_t nSamples
+);
+#endif
+
+//****************************  Global Functions  ****************************//
+
+DasGeometry makeLinearArray(uint32_t pitchNm)
+{
+	DasGeometry geometry;
+
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		geometry.elementXUm[iChan] = (float) (((double) iChan
+				- (OI_N_CHAN - 1u) / 2.0) * pitchNm * UM_PER_NM);
+		geometry.apodization[iChan] = 1.0f;
+	}
+
+	return geometry;
+}
+
+DasBeamformer::DasBeamformer(unsigned nThreads, bool isSimd)
+	: isSimd(isSimd && hasAvx2())
+{
+	if (nThreads == 0u) {
+		nThreads = std::max(1u, std::thread::hardware_concurrency());
+	} else {
+		// As asked.
+	}
+	for (unsigned iThread = 1u; iThread < nThreads; ++iThread) {
+		workers.emplace_back(&DasBeamformer::work, this);
+	}
+}
+
+DasBeamformer::~DasBeamformer()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		isStopping = true;
+	}
+	start.notify_all();
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+}
+
+bool DasBeamformer::plan(
+		const FrameProgram& program,
+		const DasGeometry& geometry,
+		const DasImage& image
+) {
+	const uint32_t
+		nShots = program.getNShots(),
+		nCols = (uint32_t) image.columnXUm.size();
+
+	nColumns = 0u;
+	nDepth = 0u;
+	if (nShots == 0u || nCols == 0u || image.nDepth == 0u
+			|| (image.isLinePerShot && nShots != nCols)) {
+		return false;
+	} else {
+		// Ok.
+	}
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		if (program.getShot(iShot).rx.nSamples < 2u) {
+			return false;
+		} else {
+			// Something to interpolate.
+		}
+	}
+
+	const double samplesPerUm
+		= geometry.sampleRateHz / (geometry.speedOfSound * UM_PER_M);
+	const std::size_t nPoints = (std::size_t) nCols * image.nDepth;
+
+	/////  Receive  /////
+	rxDelay.resize(OI_N_CHAN * nPoints);
+	apodization.resize(OI_N_CHAN * nPoints);
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		for (uint32_t iCol = 0u; iCol < nCols; ++iCol) {
+			const double dx = (double) geometry.elementXUm[iChan]
+					- image.columnXUm[iCol];
+			const std::size_t k0 = iChan * nPoints
+					+ (std::size_t) iCol * image.nDepth;
+
+			for (uint32_t iDepth = 0u; iDepth < image.nDepth; ++iDepth) {
+				const double
+					z = image.depthStartUm + (double) iDepth * image.depthStepUm,
+					half = geometry.fNumber > 0.0f
+							? z / (2.0 * geometry.fNumber)
+							: 0.0;
+				double weight = geometry.apodization[iChan];
+
+				if (geometry.fNumber <= 0.0f) {
+					// The whole array.
+				} else if (std::fabs(dx) < half) {
+					weight *= 0.5 * (1.0 + std::cos(PI * dx / half));
+				} else {
+					weight = 0.0;
+				}
+
+				rxDelay[k0 + iDepth] = (float) (std::hypot(dx, z) * samplesPerUm
+						- geometry.offsetSamples);
+				apodization[k0 + iDepth] = (float) weight;
+			}
+		}
+	}
+
+	/////  Transmit  /////
+	std::vector<std::vector<Firing>> firings(nShots);
+	shotNSamples.resize(nShots);
+	maxNSamples = 0u;
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		firings[iShot] = getFirings(program.getShot(iShot), geometry);
+		shotNSamples[iShot] = program.getShot(iShot).rx.nSamples;
+		maxNSamples = std::max<std::size_t>(maxNSamples, shotNSamples[iShot]);
+	}
+
+	pairStart.assign(1u, 0u);
+	pairShot.clear();
+	for (uint32_t iCol = 0u; iCol < nCols; ++iCol) {
+		for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+			if (!image.isLinePerShot || iShot == iCol) {
+				pairShot.push_back(iShot);
+			} else {
+				// Another column's.
+			}
+		}
+		pairStart.push_back((uint32_t) pairShot.size());
+	}
+
+	txDelay.resize(pairShot.size() * image.nDepth);
+	for (uint32_t iCol = 0u; iCol < nCols; ++iCol) {
+		for (uint32_t k = pairStart[iCol]; k < pairStart[iCol + 1u]; ++k) {
+			for (uint32_t iDepth = 0u; iDepth < image.nDepth; ++iDepth) {
+				txDelay[(std::size_t) k * image.nDepth + iDepth] = arrival(
+						firings[pairShot[k]],
+						image.columnXUm[iCol],
+						image.depthStartUm + (double) iDepth * image.depthStepUm,
+						samplesPerUm
+				);
+			}
+		}
+	}
+
+	nColumns = nCols;
+	nDepth = image.nDepth;
+	nTilesDeep = (nDepth + TILE_DEPTH - 1u) / TILE_DEPTH;
+
+	return true;
+}
+
+bool DasBeamformer::beamform(float* pImage, const float* pRf,
+		std::size_t stride)
+{
+	if (nColumns == 0u || stride < maxNSamples) {
+		return false;
+	} else {
+		// Planned.
+	}
+
+	this->pImage = pImage;
+	this->pRf = pRf;
+	this->stride = stride;
+	nTiles = (std::size_t) nColumns * nTilesDeep;
+	nextTile = 0u;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		nRunning = (unsigned) workers.size();
+		++generation;
+	}
+	start.notify_all();
+
+	runTiles();
+
+	std::unique_lock<std::mutex> lock(mutex);
+	done.wait(lock, [this] { return nRunning == 0u; });
+
+	return true;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+void DasBeamformer::runTiles()
+{
+	for (std::size_t iTile = nextTile++; iTile < nTiles; iTile = nextTile++) {
+		sumTile(iTile);
+	}
+}
+
+void DasBeamformer::sumTile(std::size_t iTile)
+{
+	const uint32_t
+		iCol = (uint32_t) (iTile / nTilesDeep),
+		iFirst = (uint32_t) (iTile % nTilesDeep) * TILE_DEPTH,
+		n = std::min(TILE_DEPTH, nDepth - iFirst);
+	const std::size_t
+		nPoints = (std::size_t) nColumns * nDepth,
+		k0 = (std::size_t) iCol * nDepth + iFirst;
+	float* const pOut = pImage + k0;
+	float sum[TILE_DEPTH];
+
+	std::fill_n(pOut, n, 0.0f);
+
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		const float* const pRx = &rxDelay[iChan * nPoints + k0];
+		const float* const pWeight = &apodization[iChan * nPoints + k0];
+
+		if (std::all_of(pWeight, pWeight + n,
+				[](float w) { return w == 0.0f; })) {
+			continue;
+		} else {
+			// In the aperture.
+		}
+
+		std::fill_n(sum, n, 0.0f);
+		for (uint32_t k = pairStart[iCol]; k < pairStart[iCol + 1u]; ++k) {
+			const uint32_t iShot = pairShot[k];
+			const float* const pRow
+				= pRf + ((std::size_t) iShot * OI_N_CHAN + iChan) * stride;
+			const float* const pTx = &txDelay[(std::size_t) k * nDepth + iFirst];
+			uint32_t iDone = 0u;
+
+#if OI_DAS_X86
+			if (isSimd) {
+				iDone = addRowAvx2(sum, pRow, pTx, pRx, n, shotNSamples[iShot]);
+			} else {
+				// Scalar only.
+			}
+#endif
+			addRowScalar(sum + iDone, pRow, pTx + iDone, pRx + iDone,
+					n - iDone, shotNSamples[iShot]);
+		}
+
+		for (uint32_t i = 0u; i < n; ++i) {
+			pOut[i] += sum[i] * pWeight[i];
+		}
+	}
+}
+
+void DasBeamformer::work()
+{
+	uint64_t seen = 0u;
+
+	for (;;) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start.wait(lock, [&] { return isStopping || generation != seen; });
+			if (isStopping) {
+				return;
+			} else {
+				seen = generation;
+			}
+		}
+
+		runTiles();
+
+		std::lock_guard<std::mutex> lock(mutex);
+		if (--nRunning == 0u) {
+			done.notify_all();
+		} else {
+			// Others are still summing.
+		}
+	}
+}
+
+static bool hasAvx2()
+{
+#if OI_DAS_X86
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// Each element fires at the first clock of its level sequence that is not
+//  RTZ.
+static std::vector<Firing> getFirings(
+		const OI_SHOT& shot,
+		const DasGeometry& geometry
+) {
+	std::vector<Firing> firings;
+
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		const OI_TX_CHANNEL& tx = shot.tx.channels[iChan];
+		const uint32_t n = std::min<uint32_t>(tx.nLevelSequence,
+				OI_MAX_N_LEVEL_SEQUENCE);
+		uint32_t iFirst = 0u;
+
+		while (iFirst < n && tx.levelSequence[iFirst] == 0) {
+			++iFirst;
+		}
+		if (tx.enable && iFirst < n) {
+			firings.push_back({ geometry.elementXUm[iChan],
+					iFirst * geometry.sampleRateHz / OI_TX_CLOCK_HZ });
+		} else {
+			// Silent.
+		}
+	}
+
+	return firings;
+}
+
+// When the transmitted wavefront reaches a point, in samples:  the arrival
+//  over the aperture that is stationary.  That is a minimum inside the
+//  aperture for waves that diverge (a single element, plane waves, and
+//  focused waves beyond the focus), and a maximum for waves that converge
+//  (before the focus).  Where there is neither, as to the side of a beam,
+//  the first arrival is taken.
+static float arrival(
+		const std::vector<Firing>& firings,
+		double xUm,
+		double zUm,
+		double samplesPerUm
+) {
+	const std::size_t n = firings.size();
+	std::size_t iMin = 0u, iMax = 0u;
+	double a[OI_N_CHAN];
+
+	if (n == 0u) {
+		return NO_DELAY;
+	} else {
+		// Something fires.
+	}
+
+	for (std::size_t i = 0u; i < n; ++i) {
+		a[i] = firings[i].delay
+				+ std::hypot(xUm - firings[i].xUm, zUm) * samplesPerUm;
+		iMin = a[i] < a[iMin] ? i : iMin;
+		iMax = a[i] > a[iMax] ? i : iMax;
+	}
+
+	if (iMin > 0u && iMin + 1u < n) {
+		return (float) a[iMin];
+	} else if (iMax > 0u && iMax + 1u < n) {
+		return (float) a[iMax];
+	} else {
+		return (float) a[iMin];
+	}
+}
+
+// Adds the samples of one row at n points' delays into pSum.  A delay of
+//  d samples interpolates samples floor(d) and floor(d) + 1, so it must be
+//  less than nSamples - 1.  Returns n.
+static uint32_t addRowScalar(
+		float* pSum,
+		const float* pRow,
+		const float* pTx,
+		const float* pRx,
+		uint32_t n,
+		uint32_t nSamples
+) {
+	const float last = (float) nSamples - 1.0f;
+
+	for (uint32_t i = 0u; i < n; ++i) {
+		const float d = pTx[i] + pRx[i];
+
+		if (d >= 0.0f && d < last) {
+			const int32_t iSample = (int32_t) d;
+			const float
+				frac = d - (float) iSample,
+				s0 = pRow[iSample],
+				s1 = pRow[iSample + 1];
+
+			pSum[i] += s0 + (s1 - s0) * frac;
+		} else {
+			// Outside the recording.
+		}
+	}
+
+	return n;
+}
+
+#if OI_DAS_X86
+
+// As addRowScalar, eight points at a time.  Points outside the recording
+//  gather sample 0, and add nothing.  Returns the number of points done.
+__attribute__((target("avx2")))
+static uint32_t addRowAvx2(
+		float* pSum,
+		const float* pRow,
+		const float* pTx,
+		const float* pRx,
+		uint32_t n,
+		uint32_t nSamples
+) {
+	const __m256
+		zero = _mm256_setzero_ps(),
+		last = _mm256_set1_ps((float) nSamples - 1.0f);
+	const uint32_t nDone = n & ~7u;
+
+	for (uint32_t i = 0u; i < nDone; i += 8u) {
+		const __m256 d = _mm256_add_ps(_mm256_loadu_ps(pTx + i),
+				_mm256_loadu_ps(pRx + i));
+		const __m256 isIn = _mm256_and_ps(
+				_mm256_cmp_ps(d, zero, _CMP_GE_OQ),
+				_mm256_cmp_ps(d, last, _CMP_LT_OQ));
+		const __m256i idx = _mm256_and_si256(_mm256_cvttps_epi32(d),
+				_mm256_castps_si256(isIn));
+
+		const __m256
+			s0 = _mm256_i32gather_ps(pRow, idx, 4),
+			s1 = _mm256_i32gather_ps(pRow + 1, idx, 4),
+			frac = _mm256_sub_ps(d, _mm256_cvtepi32_ps(idx)),
+			v = _mm256_add_ps(s0, _mm256_mul_ps(_mm256_sub_ps(s1, s0), frac));
+
+		_mm256_storeu_ps(pSum + i, _mm256_add_ps(_mm256_loadu_ps(pSum + i),
+				_mm256_and_ps(v, isIn)));
+	}
+
+	return nDone;
+}
+
+#endif
+
+} // namespace oi
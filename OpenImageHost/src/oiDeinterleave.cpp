@@ -0,0 +1,515 @@
+/*
+	oiDeinterleave.cpp
+
+	Host-side deinterleaving of raw samples.  The rows of each ADC are
+	transposed eight at a time, within each 128-bit lane of a register
+	(16 rows per step with AVX2, 32 with AVX-512), which leaves each lane's
+	samples of those rows contiguous; each lane is then XORed with its
+	inversion, widened to float, corrected, and stored to its channel's
+	row.  The scalar version does the rest, and does the same arithmetic in
+	the same order, so that the kernels match it exactly.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiDeinterleave.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define OI_DEINTERLEAVE_X86 1
+#	include <immintrin.h>
+#else
+#	define OI_DEINTERLEAVE_X86 0
+#endif
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const uint32_t N_LANES = DEINTERLEAVE_N_LANES;
+
+// As set by AD9670_REG_OUTPUT_MODE in oiAdc.c:  lane 7 of ADC 0, lane 0 of
+//  ADC 1.
+static const uint32_t INVERTED_CHANNELS[] = { 7u, 8u };
+
+// The range of int16_t outputs.
+static const float INT16_MIN_F = -32768.0f;
+static const float INT16_MAX_F = 32767.0f;
+
+//**********************************  Types  *********************************//
+
+// The map, by lane:  where each lane's row starts in the output, and its
+//  corrections.
+struct LaneTable {
+	std::size_t start[OI_RX_N_CHIPS][N_LANES];
+	int16_t flip[OI_RX_N_CHIPS][N_LANES];        // 0, or -1 to invert
+	float
+		offset[OI_RX_N_CHIPS][N_LANES],
+		gain[OI_RX_N_CHIPS][N_LANES];
+};
+
+//***********************  Local Function Declarations  **********************//
+static bool makeLaneTable(
+		LaneTable& table,
+		const ChannelMap& map,
+		std::size_t stride
+);
+static bool isSupported(DeinterleaveIsa isa);
+template <typename T>
+static bool deinterleaveAny(
+		T* pOut,
+		std::size_t stride,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const ChannelMap& map,
+		DeinterleaveIsa isa
+);
+template <typename T>
+static void deinterleaveScalar(
+		T* pOut,
+		const LaneTable& table,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t iFirst,
+		std::size_t nSamples
+);
+static inline void storeScalar(float* p, float v);
+static inline void storeScalar(int16_t* p, float v);
+#if OI_DEINTERLEAVE_X86
+template <typename T>
+__attribute__((target("avx2")))
+static std::size_t deinterleaveAvx2(
+		T* pOut,
+		const LaneTable& table,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples
+);
+template <typename T>
+__attribute__((target("avx512f,avx512bw")))
+static std::size_t deinterleaveAvx512(
+		T* pOut,
+		const LaneTable& table,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples
+);
+#endif
+
+//****************************  Global Functions  ****************************//
+
+ChannelMap defaultChannelMap()
+{
+	ChannelMap map;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			map.channel[iAdc][iLane] = (uint8_t) (iAdc * N_LANES + iLane);
+		}
+	}
+	std::fill_n(map.isInverted, OI_N_CHAN, false);
+	for (uint32_t iChan : INVERTED_CHANNELS) {
+		map.isInverted[iChan] = true;
+	}
+	std::fill_n(map.offset, OI_N_CHAN, 0.0f);
+	std::fill_n(map.gain, OI_N_CHAN, 1.0f);
+
+	return map;
+}
+
+DeinterleaveIsa bestDeinterleaveIsa()
+{
+	if (isSupported(DEINTERLEAVE_AVX512)) {
+		return DEINTERLEAVE_AVX512;
+	} else if (isSupported(DEINTERLEAVE_AVX2)) {
+		return DEINTERLEAVE_AVX2;
+	} else {
+		return DEINTERLEAVE_SCALAR;
+	}
+}
+
+bool deinterleave(
+		float* pOut,
+		std::size_t stride,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const ChannelMap& map,
+		DeinterleaveIsa isa
+) {
+	return deinterleaveAny(pOut, stride, ppRaw, nSamples, map, isa);
+}
+
+bool deinterleave(
+		int16_t* pOut,
+		std::size_t stride,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const ChannelMap& map,
+		DeinterleaveIsa isa
+) {
+	return deinterleaveAny(pOut, stride, ppRaw, nSamples, map, isa);
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static bool makeLaneTable(
+		LaneTable& table,
+		const ChannelMap& map,
+		std::size_t stride
+) {
+	bool isSeen[OI_N_CHAN] = {};
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			const uint32_t iChan = map.channel[iAdc][iLane];
+
+			if (iChan >= OI_N_CHAN || isSeen[iChan]) {
+				return false;
+			} else {
+				isSeen[iChan] = true;
+			}
+			table.start[iAdc][iLane] = iChan * stride;
+			table.flip[iAdc][iLane] = map.isInverted[iChan] ? -1 : 0;
+			table.offset[iAdc][iLane] = map.offset[iChan];
+			table.gain[iAdc][iLane] = map.gain[iChan];
+		}
+	}
+
+	return true;
+}
+
+static bool isSupported(DeinterleaveIsa isa)
+{
+	switch (isa) {
+	case DEINTERLEAVE_SCALAR:
+		return true;
+#if OI_DEINTERLEAVE_X86
+	case DEINTERLEAVE_AVX2:
+		return __builtin_cpu_supports("avx2");
+	case DEINTERLEAVE_AVX512:
+		return __builtin_cpu_supports("avx512f")
+				&& __builtin_cpu_supports("avx512bw");
+#endif
+	default:
+		return false;
+	}
+}
+
+template <typename T>
+static bool deinterleaveAny(
+		T* pOut,
+		std::size_t stride,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const ChannelMap& map,
+		DeinterleaveIsa isa
+) {
+	LaneTable table;
+	std::size_t nDone = 0u;
+
+	if (isa == DEINTERLEAVE_BEST) {
+		isa = bestDeinterleaveIsa();
+	} else {
+		// As asked.
+	}
+	if (stride < nSamples || !isSupported(isa)
+			|| !makeLaneTable(table, map, stride)) {
+		return false;
+	} else {
+		// Ok.
+	}
+
+#if OI_DEINTERLEAVE_X86
+	if (isa == DEINTERLEAVE_AVX512) {
+		nDone = deinterleaveAvx512(pOut, table, ppRaw, nSamples);
+	} else if (isa == DEINTERLEAVE_AVX2) {
+		nDone = deinterleaveAvx2(pOut, table, ppRaw, nSamples);
+	} else {
+		// Scalar only.
+	}
+#endif
+	deinterleaveScalar(pOut, table, ppRaw, nDone, nSamples);
+
+	return true;
+}
+
+// The reference:  samples iFirst to nSamples of each lane.
+template <typename T>
+static void deinterleaveScalar(
+		T* pOut,
+		const LaneTable& table,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t iFirst,
+		std::size_t nSamples
+) {
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		for (std::size_t i = iFirst; i < nSamples; ++i) {
+			const int16_t* pRow = ppRaw[iAdc] + i * N_LANES;
+
+			for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+				const float v = (float) (int16_t) (pRow[iLane]
+						^ table.flip[iAdc][iLane]);
+
+				storeScalar(
+						pOut + table.start[iAdc][iLane] + i,
+						(v - table.offset[iAdc][iLane])
+								* table.gain[iAdc][iLane]
+				);
+			}
+		}
+	}
+}
+
+static inline void storeScalar(float* p, float v) { *p = v; }
+
+// Saturated, then rounded as the kernels' conversions (to nearest, ties to
+//  even, in the default rounding mode).
+static inline void storeScalar(int16_t* p, float v)
+{
+	*p = (int16_t) std::nearbyint(std::min(std::max(v, INT16_MIN_F),
+			INT16_MAX_F));
+}
+
+#if OI_DEINTERLEAVE_X86
+
+// Transposes the 8x8 blocks of 16-bit samples in each 128-bit lane:  on
+//  return, x[j] holds lane j of rows 0..7 of each block.
+__attribute__((target("avx2")))
+static inline void transposeAvx2(__m256i x[N_LANES])
+{
+	const __m256i
+		t0 = _mm256_unpacklo_epi16(x[0], x[1]),
+		t1 = _mm256_unpackhi_epi16(x[0], x[1]),
+		t2 = _mm256_unpacklo_epi16(x[2], x[3]),
+		t3 = _mm256_unpackhi_epi16(x[2], x[3]),
+		t4 = _mm256_unpacklo_epi16(x[4], x[5]),
+		t5 = _mm256_unpackhi_epi16(x[4], x[5]),
+		t6 = _mm256_unpacklo_epi16(x[6], x[7]),
+		t7 = _mm256_unpackhi_epi16(x[6], x[7]);
+	const __m256i
+		u0 = _mm256_unpacklo_epi32(t0, t2),
+		u1 = _mm256_unpackhi_epi32(t0, t2),
+		u2 = _mm256_unpacklo_epi32(t1, t3),
+		u3 = _mm256_unpackhi_epi32(t1, t3),
+		u4 = _mm256_unpacklo_epi32(t4, t6),
+		u5 = _mm256_unpackhi_epi32(t4, t6),
+		u6 = _mm256_unpacklo_epi32(t5, t7),
+		u7 = _mm256_unpackhi_epi32(t5, t7);
+
+	x[0] = _mm256_unpacklo_epi64(u0, u4);
+	x[1] = _mm256_unpackhi_epi64(u0, u4);
+	x[2] = _mm256_unpacklo_epi64(u1, u5);
+	x[3] = _mm256_unpackhi_epi64(u1, u5);
+	x[4] = _mm256_unpacklo_epi64(u2, u6);
+	x[5] = _mm256_unpackhi_epi64(u2, u6);
+	x[6] = _mm256_unpacklo_epi64(u3, u7);
+	x[7] = _mm256_unpackhi_epi64(u3, u7);
+}
+
+__attribute__((target("avx2")))
+static inline void storeAvx2(float* p, __m256 lo, __m256 hi)
+{
+	_mm256_storeu_ps(p, lo);
+	_mm256_storeu_ps(p + 8, hi);
+}
+
+// The pack interleaves the halves of lo and hi; the permute restores them.
+__attribute__((target("avx2")))
+static inline void storeAvx2(int16_t* p, __m256 lo, __m256 hi)
+{
+	const __m256
+		min = _mm256_set1_ps(INT16_MIN_F),
+		max = _mm256_set1_ps(INT16_MAX_F);
+	const __m256i
+		a = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(lo, min), max)),
+		b = _mm256_cvtps_epi32(_mm256_min_ps(_mm256_max_ps(hi, min), max));
+
+	_mm256_storeu_si256((__m256i*) p,
+			_mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8));
+}
+
+// Rows i..i+7 go to the low half of each register, and i+8..i+15 to the
+//  high, so each lane's 16 samples come out in order.  Returns the number
+//  of samples done.
+template <typename T>
+__attribute__((target("avx2")))
+static std::size_t deinterleaveAvx2(
+		T* pOut,
+		const LaneTable& table,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples
+) {
+	const std::size_t n = nSamples & ~(std::size_t) 15u;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const int16_t* pRaw = ppRaw[iAdc];
+		__m256i flip[N_LANES];
+		__m256 offset[N_LANES], gain[N_LANES];
+
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			flip[iLane] = _mm256_set1_epi16(table.flip[iAdc][iLane]);
+			offset[iLane] = _mm256_set1_ps(table.offset[iAdc][iLane]);
+			gain[iLane] = _mm256_set1_ps(table.gain[iAdc][iLane]);
+		}
+
+		for (std::size_t i = 0u; i < n; i += 16u) {
+			__m256i x[N_LANES];
+
+			for (uint32_t iRow = 0u; iRow < 8u; ++iRow) {
+				x[iRow] = _mm256_inserti128_si256(
+						_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)
+								(pRaw + (i + iRow) * N_LANES))),
+						_mm_loadu_si128((const __m128i*)
+								(pRaw + (i + 8u + iRow) * N_LANES)),
+						1
+				);
+			}
+			transposeAvx2(x);
+
+			for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+				const __m256i v = _mm256_xor_si256(x[iLane], flip[iLane]);
+				const __m256
+					lo = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+							_mm256_castsi256_si128(v))),
+					hi = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+							_mm256_extracti128_si256(v, 1)));
+
+				storeAvx2(
+						pOut + table.start[iAdc][iLane] + i,
+						_mm256_mul_ps(_mm256_sub_ps(lo, offset[iLane]),
+								gain[iLane]),
+						_mm256_mul_ps(_mm256_sub_ps(hi, offset[iLane]),
+								gain[iLane])
+				);
+			}
+		}
+	}
+
+	return n;
+}
+
+// GCC 12 warns of the undefined passthrough within the AVX-512 intrinsics
+//  (GCC bug 105593).
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+// As transposeAvx2, in each of the four 128-bit lanes.
+__attribute__((target("avx512f,avx512bw")))
+static inline void transposeAvx512(__m512i x[N_LANES])
+{
+	const __m512i
+		t0 = _mm512_unpacklo_epi16(x[0], x[1]),
+		t1 = _mm512_unpackhi_epi16(x[0], x[1]),
+		t2 = _mm512_unpacklo_epi16(x[2], x[3]),
+		t3 = _mm512_unpackhi_epi16(x[2], x[3]),
+		t4 = _mm512_unpacklo_epi16(x[4], x[5]),
+		t5 = _mm512_unpackhi_epi16(x[4], x[5]),
+		t6 = _mm512_unpacklo_epi16(x[6], x[7]),
+		t7 = _mm512_unpackhi_epi16(x[6], x[7]);
+	const __m512i
+		u0 = _mm512_unpacklo_epi32(t0, t2),
+		u1 = _mm512_unpackhi_epi32(t0, t2),
+		u2 = _mm512_unpacklo_epi32(t1, t3),
+		u3 = _mm512_unpackhi_epi32(t1, t3),
+		u4 = _mm512_unpacklo_epi32(t4, t6),
+		u5 = _mm512_unpackhi_epi32(t4, t6),
+		u6 = _mm512_unpacklo_epi32(t5, t7),
+		u7 = _mm512_unpackhi_epi32(t5, t7);
+
+	x[0] = _mm512_unpacklo_epi64(u0, u4);
+	x[1] = _mm512_unpackhi_epi64(u0, u4);
+	x[2] = _mm512_unpacklo_epi64(u1, u5);
+	x[3] = _mm512_unpackhi_epi64(u1, u5);
+	x[4] = _mm512_unpacklo_epi64(u2, u6);
+	x[5] = _mm512_unpackhi_epi64(u2, u6);
+	x[6] = _mm512_unpacklo_epi64(u3, u7);
+	x[7] = _mm512_unpackhi_epi64(u3, u7);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static inline void storeAvx512(float* p, __m512 lo, __m512 hi)
+{
+	_mm512_storeu_ps(p, lo);
+	_mm512_storeu_ps(p + 16, hi);
+}
+
+// The narrowing saturates, but the conversion to int32_t does not, so the
+//  clamp comes first, as in storeScalar.
+__attribute__((target("avx512f,avx512bw")))
+static inline void storeAvx512(int16_t* p, __m512 lo, __m512 hi)
+{
+	const __m512
+		min = _mm512_set1_ps(INT16_MIN_F),
+		max = _mm512_set1_ps(INT16_MAX_F);
+
+	_mm256_storeu_si256((__m256i*) p, _mm512_cvtsepi32_epi16(
+			_mm512_cvtps_epi32(_mm512_min_ps(_mm512_max_ps(lo, min), max))));
+	_mm256_storeu_si256((__m256i*) (p + 16), _mm512_cvtsepi32_epi16(
+			_mm512_cvtps_epi32(_mm512_min_ps(_mm512_max_ps(hi, min), max))));
+}
+
+// As deinterleaveAvx2, with rows i, i+8, i+16 and i+24 in the four 128-bit
+//  lanes of each register.
+template <typename T>
+__attribute__((target("avx512f,avx512bw")))
+static std::size_t deinterleaveAvx512(
+		T* pOut,
+		const LaneTable& table,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples
+) {
+	const std::size_t n = nSamples & ~(std::size_t) 31u;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const int16_t* pRaw = ppRaw[iAdc];
+		__m512i flip[N_LANES];
+		__m512 offset[N_LANES], gain[N_LANES];
+
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			flip[iLane] = _mm512_set1_epi16(table.flip[iAdc][iLane]);
+			offset[iLane] = _mm512_set1_ps(table.offset[iAdc][iLane]);
+			gain[iLane] = _mm512_set1_ps(table.gain[iAdc][iLane]);
+		}
+
+		for (std::size_t i = 0u; i < n; i += 32u) {
+			__m512i x[N_LANES];
+
+			for (uint32_t iRow = 0u; iRow < 8u; ++iRow) {
+				const int16_t* p = pRaw + (i + iRow) * N_LANES;
+				__m512i r = _mm512_castsi128_si512(
+						_mm_loadu_si128((const __m128i*) p));
+
+				r = _mm512_inserti32x4(r, _mm_loadu_si128((const __m128i*)
+						(p + 8u * N_LANES)), 1);
+				r = _mm512_inserti32x4(r, _mm_loadu_si128((const __m128i*)
+						(p + 16u * N_LANES)), 2);
+				x[iRow] = _mm512_inserti32x4(r, _mm_loadu_si128(
+						(const __m128i*) (p + 24u * N_LANES)), 3);
+			}
+			transposeAvx512(x);
+
+			for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+				const __m512i v = _mm512_xor_si512(x[iLane], flip[iLane]);
+				const __m512
+					lo = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(
+							_mm512_castsi512_si256(v))),
+					hi = _mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(
+							_mm512_extracti64x4_epi64(v, 1)));
+
+				storeAvx512(
+						pOut + table.start[iAdc][iLane] + i,
+						_mm512_mul_ps(_mm512_sub_ps(lo, offset[iLane]),
+								gain[iLane]),
+						_mm512_mul_ps(_mm512_sub_ps(hi, offset[iLane]),
+								gain[iLane])
+				);
+			}
+		}
+	}
+
+	return n;
+}
+
+#pragma GCC diagnostic pop
+
+#endif
+
+} // namespace oi
@@ -0,0 +1,969 @@
+/*
+	oiEmulator.cpp
+
+	An emulator of the Open Imager, over POSIX sockets.  The server's thread
+	frames the stream into packets and answers each in turn, as oiServer.c;
+	the acquiring thread steps each queued frame through the states of
+	oiSm.c, writing each shot's data as it completes.  The checks, the
+	products and the packing are the firmware's own portable sources.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiEmulator.h"
+
+#include "oiFrameProgram.h"
+#include "oiSamples.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// OI_MAGIC, the command or response code, and the payload's length.
+static const std::size_t HEADER_BYTES = 4u;
+
+// Channels recorded by each ADC, and the bytes of one row of them.
+static const uint32_t N_ADC_CHAN = OI_N_CHAN / OI_RX_N_CHIPS;
+static const uint32_t RAW_ROW_BYTES = N_ADC_CHAN * sizeof(int16_t);
+
+// Address spaces of each ADC's raw data, and of the products (see
+//  oiAdcDma.c, oiIq.c and oiBf.c); offsets wrap within them.
+static const uint32_t RAW_SPACE = 0x20000000u;
+static const uint32_t IQ_SPACE = 0x08000000u;
+static const uint32_t BF_SPACE = 0x08000000u;
+
+static const std::size_t RECV_BYTES = 0x10000u;
+
+static const char BUILD_DATE[] = __DATE__ " " __TIME__;
+
+//**********************************  Types  *********************************//
+// The frame being recorded, and those being checked before they replace
+//  it, as oiShotMan.c.
+struct Emulator::Staging {
+	OI_FRAME frame;
+	OI_FRAME_RLE rleFrame;
+	OI_FRAME_FOCUSED focusedFrame;
+};
+
+//***********************  Local Function Declarations  **********************//
+static void readSpace(uint8_t* pOut, const std::vector<uint8_t>& space,
+		uint32_t byteOffset, uint32_t mask, std::size_t nBytes);
+static std::chrono::steady_clock::duration microseconds(double us);
+static OI_TIMING_CAL makeTiming(const EmulatorOptions& options,
+		uint32_t nShots);
+
+//****************************  Global Functions  ****************************//
+
+Emulator::Emulator(const EmulatorOptions& options)
+	: options(options), pStaging(new Staging())
+{
+	startTime = std::chrono::steady_clock::now();
+}
+
+Emulator::~Emulator() { stop(); }
+
+bool Emulator::start()
+{
+	if (listenFd >= 0) {
+		return false;
+	} else {
+		// Not yet.
+	}
+
+	sockaddr_in addr = {};
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_ANY);
+	addr.sin_port = htons(options.port);
+	socklen_t nAddr = sizeof(addr);
+	const int one = 1;
+
+	listenFd = ::socket(AF_INET, SOCK_STREAM, 0);
+	const bool ok = listenFd >= 0
+			&& setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one,
+					sizeof(one)) == 0
+			&& bind(listenFd, (const sockaddr*) &addr, sizeof(addr)) == 0
+			&& listen(listenFd, 1) == 0
+			&& getsockname(listenFd, (sockaddr*) &addr, &nAddr) == 0;
+
+	if (ok) {
+		port = ntohs(addr.sin_port);
+		isStopping = false;
+		server = std::thread(&Emulator::serve, this);
+		acquirer = std::thread(&Emulator::acquire, this);
+		worker = std::thread(&Emulator::process, this);
+	} else if (listenFd >= 0) {
+		::close(listenFd);
+		listenFd = -1;
+	} else {
+		// No socket.
+	}
+
+	return ok;
+}
+
+void Emulator::stop()
+{
+	if (listenFd >= 0) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			isStopping = true;
+		}
+		armed.notify_all();
+		work.notify_all();
+
+		// Wakes the server from accept() or recv():
+		shutdown(listenFd, SHUT_RDWR);
+		const int fd = clientFd;
+		if (fd >= 0) {
+			shutdown(fd, SHUT_RDWR);
+		} else {
+			// No client.
+		}
+
+		server.join();
+		acquirer.join();
+		worker.join();
+		::close(listenFd);
+		listenFd = -1;
+	} else {
+		// Not started.
+	}
+}
+
+std::vector<uint8_t> Emulator::handlePacket(const uint8_t* pPacket,
+		std::size_t nBytes)
+{
+	bool
+		ok = true,
+		ack = false;
+	oi_error_t nack = OI_ERR_NONE;
+	std::vector<uint8_t> reply;
+
+	if (nBytes < HEADER_BYTES || pPacket[0] != OI_MAGIC) {
+		// Bad packet.
+		ok = false;
+	} else if ((pPacket[2] | (std::size_t) pPacket[3] << 8)
+			!= nBytes - HEADER_BYTES) {
+		// Incorrect reported size.
+		ok = false;
+	} else {
+		// So far so good.
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (ok) {
+		const uint8_t cmd = pPacket[1];
+
+		// Payload after header:
+		const uint8_t* const pBytes = &pPacket[HEADER_BYTES];
+		nBytes -= HEADER_BYTES;
+
+		switch (cmd) {
+			case OI_CMD_GET_STATUS: {
+				OI_STATUS status;
+				std::memset(&status, 0, sizeof(status));
+
+				status.state = state;
+				status.flags = (iqConfig.enable ? OI_STATUS_FLAG_IQ : 0u)
+						| (bfConfig.enable ? OI_STATUS_FLAG_BEAMFORM : 0u);
+				std::memcpy(status.buildDate, BUILD_DATE, sizeof(BUILD_DATE));
+				status.nShots = nShots;
+
+				reply = makeReply(OI_RES_STATUS, &status, sizeof(status));
+			}
+			break;
+
+			case OI_CMD_GET_BOOT_PROFILE: {
+				// As when the FSBL left none.
+				OI_BOOT_PROFILE profile;
+				std::memset(&profile, 0, sizeof(profile));
+
+				reply = makeReply(OI_RES_BOOT_PROFILE, &profile,
+						sizeof(profile));
+			}
+			break;
+
+			case OI_CMD_GET_TIMING: {
+				const OI_TIMING_CAL timing = makeTiming(options, nShots);
+				reply = makeReply(OI_RES_TIMING, &timing, sizeof(timing));
+			}
+			break;
+
+			case OI_CMD_GET_VERSION: {
+				const uint32_t version = OI_PROTOCOL_VERSION;
+				reply = makeReply(OI_RES_VERSION, &version, sizeof(version));
+			}
+			break;
+
+			case OI_CMD_QUEUE_FRAME:
+			nack = queueFrame(pBytes, nBytes, false);
+			ack = true;  // ACK if not NACK'd
+			break;
+
+			case OI_CMD_QUEUE_FRAME_FORMATTED:
+			nack = queueFrame(pBytes, nBytes, true);
+			ack = true;  // ACK if not NACK'd
+			break;
+
+			case OI_CMD_QUEUE_FRAME_RLE:
+			nack = queueFrameRle(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+
+			case OI_CMD_QUEUE_FRAME_FOCUSED:
+			nack = queueFrameFocused(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+
+			case OI_CMD_SET_IQ:
+			nack = setIq(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+
+			case OI_CMD_SET_BEAMFORM:
+			nack = setBeamform(pBytes, nBytes);
+			ack = true;  // ACK if not NACK'd
+			break;
+
+			case OI_CMD_GET_FRAME:
+			if (state != STATE_READY) {
+				nack = OI_ERR_ILLEGAL_STATE;
+			} else if (nBytes != sizeof(OI_FRAME_DATA_REQ)) {
+				nack = OI_ERR_INCORRECT_SIZE;
+			} else {
+				OI_FRAME_DATA_REQ req;
+				std::memcpy(&req, pBytes, sizeof(req));
+
+				// Only what could be sent is read:
+				std::vector<uint8_t> data(std::min<std::size_t>(req.nBytes,
+						options.sendBufferBytes));
+				readFrameData(data.data(), req, false);
+				reply = makeReply(OI_RES_FRAME, data.data(), req.nBytes);
+			}
+			break;
+
+			case OI_CMD_GET_FRAME_PACKED:
+			if (state != STATE_READY) {
+				nack = OI_ERR_ILLEGAL_STATE;
+			} else if (nBytes != sizeof(OI_FRAME_DATA_REQ)) {
+				nack = OI_ERR_INCORRECT_SIZE;
+			} else {
+				OI_FRAME_DATA_REQ req;
+				std::memcpy(&req, pBytes, sizeof(req));
+
+				if (iqConfig.enable || bfConfig.enable || !isFullWidth) {
+					// Only raw, 16-bit data is packed.
+					nack = OI_ERR_ILLEGAL_STATE;
+				} else if (req.byteOffset % RAW_ROW_BYTES != 0u
+						|| req.nBytes % RAW_ROW_BYTES != 0u
+						|| req.nBytes > OI_PACK_MAX_BYTES) {
+					nack = OI_ERR_INVALID_PARAMETER;
+				} else {
+					std::vector<int16_t> rows(req.nBytes / sizeof(int16_t));
+					std::vector<uint32_t> packed(OI_PACK_MAX_PACKED_BYTES(
+							req.nBytes / RAW_ROW_BYTES) / sizeof(uint32_t) + 1u);
+
+					readFrameData((uint8_t*) rows.data(), req, true);
+					const uint32_t nPacked = oiPackEncode(packed.data(),
+							rows.data(), req.nBytes / RAW_ROW_BYTES);
+					reply = makeReply(OI_RES_FRAME_PACKED, packed.data(),
+							nPacked);
+				}
+			}
+			break;
+
+			case OI_CMD_ESTIMATE_FRAME: {
+				// Estimated in any state; nothing is recorded.
+				OI_ESTIMATE_REQ req;
+				if (nBytes < OI_ESTIMATE_REQ_BYTES(0u) || nBytes > sizeof(req)) {
+					nack = OI_ERR_INCORRECT_SIZE;
+				} else {
+					std::memcpy(&req, pBytes, nBytes);
+
+					if (req.nShots > OI_MAX_N_SHOTS) {
+						nack = OI_ERR_INVALID_PARAMETER;
+					} else if (nBytes != OI_ESTIMATE_REQ_BYTES(req.nShots)) {
+						nack = OI_ERR_INCORRECT_SIZE;
+					} else {
+						const OI_TIMING_CAL timing
+							= makeTiming(options, nShots);
+						OI_FRAME_ESTIMATE estimate;
+
+						nack = oiTimingEstimate(&estimate, &req, &timing);
+						if (nack == OI_ERR_NONE) {
+							reply = makeReply(OI_RES_ESTIMATE, &estimate,
+									sizeof(estimate));
+						} else {
+							// NACK'd.
+						}
+					}
+				}
+			}
+			break;
+
+			default:
+			nack = OI_ERR_UNRECOGNIZED_COMMAND;
+			break;
+		}
+	} else {
+		// Error with the packet.
+		nack = OI_ERR_BAD_PACKET;
+	}
+
+	if (nack) {
+		const uint8_t error = (uint8_t) nack;
+		reply = makeReply(OI_RES_NACK, &error, 1u);
+	} else if (ack) {
+		reply = makeReply(OI_RES_ACK, nullptr, 0u);
+	} else {
+		// Already replied.
+	}
+
+	return reply;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// As oiShotManQueueFrame():  the shots of OI_CMD_QUEUE_FRAME are those of
+//  protocol version 1.
+oi_error_t Emulator::queueFrame(const uint8_t* pBytes, std::size_t nBytes,
+		bool isFormatted)
+{
+	OI_FRAME& frame = pStaging->frame;
+	const std::size_t
+		headerBytes = sizeof(frame) - sizeof(frame.shots),
+		shotBytes = isFormatted ? sizeof(OI_SHOT) : OI_SHOT_V1_BYTES;
+	oi_error_t result = OI_ERR_NONE;
+
+	if (state != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes < headerBytes) {
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy the header (everything but the shots):
+		std::memcpy(&frame, pBytes, headerBytes);
+
+		// Compute what the frame size should be:
+		const std::size_t frameSize = headerBytes
+				+ shotBytes * (std::size_t) frame.nShots;
+
+		if (nBytes != frameSize || frame.nShots > OI_MAX_N_SHOTS) {
+			// Wrong size, or they sent too many shots:
+			result = OI_ERR_INCORRECT_SIZE;
+		} else if (frame.nShots == 0u) {
+			// A frame with no shots is illegal.
+			result = OI_ERR_INVALID_PARAMETER;
+		} else {
+			for (uint32_t iS = 0u; iS < frame.nShots; ++iS) {
+				std::memcpy(&frame.shots[iS],
+						pBytes + headerBytes + shotBytes * iS, shotBytes);
+				if (!isFormatted) {
+					frame.shots[iS].rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+				} else {
+					// Sent.
+				}
+			}
+
+			for (uint32_t iS = 0u; iS < frame.nShots && !result; ++iS) {
+				result = checkFormat(
+						frame.shots[iS].rx.sampleFormat,
+						frame.shots[iS].rx.nSamples
+				);
+			}
+
+			if (result == OI_ERR_NONE) {
+				startFrame();
+			} else {
+				// Reject.
+			}
+		}
+	}
+
+	return result;
+}
+
+oi_error_t Emulator::queueFrameRle(const uint8_t* pBytes, std::size_t nBytes)
+{
+	OI_FRAME_RLE& rleFrame = pStaging->rleFrame;
+	const std::size_t headerBytes = sizeof(rleFrame) - sizeof(rleFrame.shots);
+	oi_error_t result = OI_ERR_NONE;
+
+	if (state != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes < headerBytes) {
+		// Not even a complete header.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy the header and templates (everything but the shots):
+		std::memcpy(&rleFrame, pBytes, headerBytes);
+
+		const std::size_t frameSize = headerBytes
+				+ sizeof(OI_SHOT_RLE) * (std::size_t) rleFrame.nShots;
+
+		if (nBytes != frameSize || frameSize > sizeof(rleFrame)) {
+			result = OI_ERR_INCORRECT_SIZE;
+		} else if (rleFrame.nShots == 0u) {
+			result = OI_ERR_INVALID_PARAMETER;
+		} else {
+			std::memcpy(&rleFrame, pBytes, frameSize);
+			result = loadRleFrame();
+		}
+	}
+
+	return result;
+}
+
+oi_error_t Emulator::queueFrameFocused(const uint8_t* pBytes,
+		std::size_t nBytes)
+{
+	OI_FRAME_FOCUSED& focusedFrame = pStaging->focusedFrame;
+	OI_FRAME_RLE& rleFrame = pStaging->rleFrame;
+	const std::size_t headerBytes
+		= sizeof(focusedFrame) - sizeof(focusedFrame.shots);
+	oi_error_t result = OI_ERR_NONE;
+
+	if (state != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes < headerBytes) {
+		// Not even a complete header.
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Copy the header and templates (everything but the shots):
+		std::memcpy(&focusedFrame, pBytes, headerBytes);
+
+		const std::size_t frameSize = headerBytes
+				+ sizeof(OI_SHOT_FOCUSED) * (std::size_t) focusedFrame.nShots;
+
+		if (nBytes != frameSize || frameSize > sizeof(focusedFrame)) {
+			result = OI_ERR_INCORRECT_SIZE;
+		} else if (focusedFrame.nShots == 0u) {
+			result = OI_ERR_INVALID_PARAMETER;
+		} else {
+			std::memcpy(&focusedFrame, pBytes, frameSize);
+
+			// Plan the delays of each shot, which gives an RLE frame:
+			rleFrame.handle = focusedFrame.handle;
+			rleFrame.nShots = focusedFrame.nShots;
+			rleFrame.nTemplates = focusedFrame.nTemplates;
+			std::memcpy(rleFrame.templates, focusedFrame.templates,
+					sizeof(rleFrame.templates));
+
+			for (uint32_t iS = 0u; iS < focusedFrame.nShots && !result; ++iS) {
+				result = oiTxPlanFocus(
+						&rleFrame.shots[iS].tx,
+						&focusedFrame.shots[iS].tx,
+						focusedFrame.pitchNm,
+						focusedFrame.speedOfSound
+				);
+				rleFrame.shots[iS].rx = focusedFrame.shots[iS].rx;
+			}
+
+			if (result == OI_ERR_NONE) {
+				result = loadRleFrame();
+			} else {
+				// Reject.
+			}
+		}
+	}
+
+	return result;
+}
+
+// Validates the staged RLE frame, and if it is good, expands it into the
+//  frame to record.
+oi_error_t Emulator::loadRleFrame()
+{
+	const OI_FRAME_RLE& rleFrame = pStaging->rleFrame;
+	OI_FRAME& frame = pStaging->frame;
+	oi_error_t result = OI_ERR_NONE;
+
+	for (uint32_t iS = 0u; iS < rleFrame.nShots && !result; ++iS) {
+		result = oiTxRleValidate(
+				&rleFrame.shots[iS].tx,
+				rleFrame.templates,
+				rleFrame.nTemplates
+		);
+		if (result == OI_ERR_NONE) {
+			result = oiRxValidate(&rleFrame.shots[iS].rx);
+		} else {
+			// Already failed.
+		}
+		if (result == OI_ERR_NONE) {
+			result = checkFormat(
+					rleFrame.shots[iS].rx.sampleFormat,
+					rleFrame.shots[iS].rx.nSamples
+			);
+		} else {
+			// Already failed.
+		}
+	}
+
+	if (result == OI_ERR_NONE) {
+		frame.handle = rleFrame.handle;
+		frame.nShots = rleFrame.nShots;
+
+		for (uint32_t iS = 0u; iS < rleFrame.nShots; ++iS) {
+			oiTxRleExpand(
+					&frame.shots[iS].tx,
+					&rleFrame.shots[iS].tx,
+					rleFrame.templates
+			);
+			oiRxExpand(&frame.shots[iS].rx, &rleFrame.shots[iS].rx);
+		}
+
+		startFrame();
+	} else {
+		// Reject.
+	}
+
+	return result;
+}
+
+// The packed sample formats are only for raw data; IQ and beamforming
+//  read 16-bit samples.
+oi_error_t Emulator::checkFormat(uint32_t sampleFormat, uint32_t nSamples)
+		const
+{
+	oi_error_t result = oiRxValidateFormat(sampleFormat, nSamples);
+
+	if (result != OI_ERR_NONE) {
+		// Already failed.
+	} else if (sampleFormat != OI_SAMPLE_FORMAT_16
+			&& (iqConfig.enable || bfConfig.enable)) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else {
+		// Ok.
+	}
+
+	return result;
+}
+
+oi_error_t Emulator::setIq(const uint8_t* pBytes, std::size_t nBytes)
+{
+	oi_error_t result = OI_ERR_NONE;
+	OI_IQ_CONFIG cfg;
+
+	if (state != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes != sizeof(cfg)) {
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		std::memcpy(&cfg, pBytes, sizeof(cfg));
+		result = oiIqValidate(&cfg);
+	}
+
+	if (result != OI_ERR_NONE) {
+		// Keep the previous configuration.
+	} else if (cfg.enable && bfConfig.enable) {
+		// Only one product at a time.
+		result = OI_ERR_ILLEGAL_STATE;
+	} else {
+		iqConfig = cfg;
+	}
+
+	return result;
+}
+
+oi_error_t Emulator::setBeamform(const uint8_t* pBytes, std::size_t nBytes)
+{
+	oi_error_t result = OI_ERR_NONE;
+	OI_BF_CONFIG cfg;
+
+	if (state != STATE_READY) {
+		result = OI_ERR_ILLEGAL_STATE;
+	} else if (nBytes != sizeof(cfg)) {
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		std::memcpy(&cfg, pBytes, sizeof(cfg));
+		result = oiBfValidate(&cfg);
+	}
+
+	if (result != OI_ERR_NONE) {
+		// Keep the previous configuration.
+	} else if (cfg.enable && iqConfig.enable) {
+		// Only one product at a time.
+		result = OI_ERR_ILLEGAL_STATE;
+	} else {
+		bfConfig = cfg;
+	}
+
+	return result;
+}
+
+// Begins acquisition of a newly queued frame; its data replace the last's.
+void Emulator::startFrame()
+{
+	const OI_FRAME& frame = pStaging->frame;
+
+	isFullWidth = true;
+	for (uint32_t iS = 0u; iS < frame.nShots; ++iS) {
+		isFullWidth = isFullWidth
+				&& frame.shots[iS].rx.sampleFormat == OI_SAMPLE_FORMAT_16;
+	}
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		buffers.raw[iAdc].clear();
+		buffers.iq[iAdc].clear();
+	}
+	buffers.bf.clear();
+
+	state = STATE_ARMED;
+	armed.notify_all();
+}
+
+// Reads the data that OI_CMD_GET_FRAME would serve, or with isRaw, the raw
+//  data whatever the product.
+void Emulator::readFrameData(uint8_t* pOut, const OI_FRAME_DATA_REQ& req,
+		bool isRaw) const
+{
+	const std::size_t nBytes = std::min<std::size_t>(req.nBytes,
+			options.sendBufferBytes);
+
+	if (iqConfig.enable && !isRaw) {
+		readSpace(pOut, buffers.iq[req.iAdc & 1u], req.byteOffset,
+				IQ_SPACE - 1u, nBytes);
+	} else if (bfConfig.enable && !isRaw) {
+		// The lines are formed from both ADCs, so the ADC index is ignored.
+		readSpace(pOut, buffers.bf, req.byteOffset, BF_SPACE - 1u, nBytes);
+	} else {
+		readSpace(pOut, buffers.raw[req.iAdc & 1u], req.byteOffset,
+				RAW_SPACE - 1u, nBytes);
+	}
+}
+
+// A reply packet, or as the firmware does (oiServerReply), a NACK in its
+//  place if it cannot fit in lwIP's send buffer with its header.
+std::vector<uint8_t> Emulator::makeReply(uint8_t code, const void* pData,
+		std::size_t nData) const
+{
+	std::vector<uint8_t> reply;
+
+	if (nData > OI_MAX_REPLY_BYTES
+			|| nData + HEADER_BYTES > options.sendBufferBytes) {
+		const uint8_t nack = OI_ERR_INCORRECT_SIZE;
+		reply = makeReply(OI_RES_NACK, &nack, sizeof(nack));
+	} else {
+		reply.resize(HEADER_BYTES + nData);
+		reply[0] = OI_MAGIC;
+		reply[1] = code;
+		reply[2] = (uint8_t) nData;
+		reply[3] = (uint8_t) (nData >> 8);
+		if (nData > 0u) {
+			std::memcpy(&reply[HEADER_BYTES], pData, nData);
+		} else {
+			// Just the header.
+		}
+	}
+
+	return reply;
+}
+
+// Runs on its own thread:  steps each frame through its shots.  Arming
+//  takes armUs; each shot then records for its samples, and takes
+//  shotSetupUs before the next.  The frame is done once the worker has
+//  produced every shot's data.
+void Emulator::acquire()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!isStopping) {
+		armed.wait(lock, [this] {
+			return isStopping || state == STATE_ARMED;
+		});
+
+		auto next = std::chrono::steady_clock::now()
+				+ microseconds(options.armUs);
+		const uint32_t nShotsInFrame = pStaging->frame.nShots;
+
+		for (uint32_t iS = 0u; iS < nShotsInFrame && !isStopping; ++iS) {
+			const Job job = {
+				iS,
+				(uint64_t) (options.model.sampleRateHz
+						* std::chrono::duration<double>(next - startTime).count())
+			};
+
+			lock.unlock();
+			std::this_thread::sleep_until(next);
+			lock.lock();
+			state = STATE_RECORD;
+
+			next += microseconds(pStaging->frame.shots[iS].rx.nSamples * 1.0e6
+					/ options.model.sampleRateHz);
+			lock.unlock();
+			std::this_thread::sleep_until(next);
+			lock.lock();
+
+			state = STATE_ARMED;
+			++nShots;
+			jobs.push_back(job);
+			work.notify_all();
+			next += microseconds(options.shotSetupUs);
+		}
+
+		work.wait(lock, [this] {
+			return isStopping || (jobs.empty() && !isProcessing);
+		});
+		state = STATE_READY;
+	}
+}
+
+// Runs on its own thread:  produces the data of each shot once recorded,
+//  as the worker cores of the device (see oiCore.c).
+void Emulator::process()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (!isStopping) {
+		work.wait(lock, [this] { return isStopping || !jobs.empty(); });
+
+		if (!jobs.empty()) {
+			const Job job = jobs.front();
+			jobs.pop_front();
+			isProcessing = true;
+
+			// The data are not read until the frame is done.
+			lock.unlock();
+			recordShot(job);
+			lock.lock();
+
+			isProcessing = false;
+			work.notify_all();
+		} else {
+			// Stopping.
+		}
+	}
+}
+
+// Writes one shot's raw data, and its product if any, as the ADCs' DMA and
+//  the firmware's processing would.
+void Emulator::recordShot(const Job& job)
+{
+	const uint32_t iShot = job.iShot;
+	const uint64_t timestamp = options.isFpgaHeader ? job.timestamp : 0u;
+	const OI_SHOT& shot = pStaging->frame.shots[iShot];
+	const uint32_t
+		nSamples = shot.rx.nSamples,
+		format = shot.rx.sampleFormat;
+	const std::size_t nSampleBytes = sampleBytes(nSamples, format);
+
+	std::vector<int16_t> rf[OI_RX_N_CHIPS];
+	int16_t* pRf[OI_RX_N_CHIPS];
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		rf[iAdc].resize((std::size_t) nSamples * N_ADC_CHAN);
+		pRf[iAdc] = rf[iAdc].data();
+	}
+	synthesizeShot(pRf, shot, options.model,
+			options.seed ^ sequence * 0x9E3779B9u);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		std::vector<uint8_t>& raw = buffers.raw[iAdc];
+		const std::size_t offset = raw.size();
+		const OI_SHOT_HEADER header = {
+			OI_SHOT_MAGIC,
+			sequence,
+			(uint32_t) timestamp,
+			(uint32_t) (timestamp >> 32),
+			pStaging->frame.handle,
+			iShot,
+			(uint32_t) nSampleBytes,
+			0u
+		};
+
+		raw.resize(offset + OI_SHOT_HEADER_BYTES + nSampleBytes);
+		std::memcpy(&raw[offset], &header, sizeof(header));
+		packSamples(&raw[offset + OI_SHOT_HEADER_BYTES], pRf[iAdc], nSamples,
+				format);
+	}
+
+	if (iqConfig.enable) {
+		const std::size_t
+			offset = buffers.iq[0].size(),
+			iqBytes = OI_IQ_N_OUT(nSamples, iqConfig.decimation)
+					* N_ADC_CHAN * 2u * sizeof(int16_t);
+
+		if (offset + iqBytes <= IQ_SPACE) {
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+				buffers.iq[iAdc].resize(offset + iqBytes);
+				oiIqDemodulate((int16_t*) &buffers.iq[iAdc][offset], pRf[iAdc],
+						nSamples, &iqConfig);
+			}
+		} else {
+			// Out of room; this shot is lost.
+			std::fprintf(stderr, "IQ buffer full\n");
+		}
+	} else if (bfConfig.enable) {
+		const std::size_t
+			offset = buffers.bf.size(),
+			bfBytes = bfConfig.nDepth * sizeof(int32_t);
+
+		if (offset + bfBytes <= BF_SPACE) {
+			std::vector<uint32_t> delays((std::size_t) bfConfig.nDepth
+					* OI_N_CHAN);
+			const int16_t* const ppRf[OI_RX_N_CHIPS] = { pRf[0], pRf[1] };
+
+			buffers.bf.resize(offset + bfBytes);
+			oiBfDelays(delays.data(), &bfConfig, iShot);
+			oiBfSum((int32_t*) &buffers.bf[offset], ppRf, nSamples,
+					delays.data(), &bfConfig);
+		} else {
+			// Out of room; this shot is lost.
+			std::fprintf(stderr, "BF buffer full\n");
+		}
+	} else {
+		// Raw data.
+	}
+
+	++sequence;
+}
+
+// Runs on its own thread:  serves one client after another.
+void Emulator::serve()
+{
+	while (!isStopping) {
+		const int fd = ::accept(listenFd, nullptr, nullptr);
+
+		if (fd >= 0) {
+			clientFd = fd;
+			serveClient(fd);
+			clientFd = -1;
+			::close(fd);
+		} else if (errno != EINTR && !isStopping) {
+			std::fprintf(stderr, "accept failed:  %s\n", std::strerror(errno));
+			isStopping = true;
+		} else {
+			// Stopped, or interrupted.
+		}
+	}
+}
+
+// Frames the client's stream into packets, and answers each in turn, until
+//  it disconnects.
+void Emulator::serveClient(int fd)
+{
+	const int one = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	linkFree = std::chrono::steady_clock::now();
+
+	std::vector<uint8_t> stream;
+	std::vector<uint8_t> received(RECV_BYTES);
+	bool ok = true;
+
+	while (ok && !isStopping) {
+		const ssize_t n = ::recv(fd, received.data(), received.size(), 0);
+		ok = n > 0 || (n < 0 && errno == EINTR);
+		stream.insert(stream.end(), received.begin(),
+				received.begin() + std::max<ssize_t>(n, 0));
+
+		std::size_t iStream = 0u;
+		bool isWhole = true;
+		while (ok && isWhole && stream.size() - iStream >= HEADER_BYTES) {
+			const uint8_t* const pPacket = &stream[iStream];
+			std::size_t nPacket = HEADER_BYTES
+					+ (pPacket[2] | (std::size_t) pPacket[3] << 8);
+
+			if (pPacket[0] != OI_MAGIC) {
+				// Out of step with the client.  Pass on all that is left,
+				//  which is refused as a bad packet.
+				nPacket = stream.size() - iStream;
+			} else {
+				// A header.
+			}
+
+			isWhole = stream.size() - iStream >= nPacket;
+			if (isWhole) {
+				const std::vector<uint8_t> reply
+					= handlePacket(pPacket, nPacket);
+				std::this_thread::sleep_for(microseconds(options.replyUs));
+				ok = sendReply(fd, reply);
+				iStream += nPacket;
+			} else {
+				// Wait for the rest.
+			}
+		}
+		stream.erase(stream.begin(), stream.begin() + iStream);
+	}
+}
+
+// Sends a reply once the link has carried the one before.  As into lwIP's
+//  send buffer, the reply is handed over while it is still to be carried,
+//  so that the next request is handled meanwhile.
+bool Emulator::sendReply(int fd, const std::vector<uint8_t>& reply)
+{
+	if (options.linkBytesPerSec > 0.0) {
+		std::this_thread::sleep_until(linkFree);
+		linkFree = std::max(linkFree, std::chrono::steady_clock::now())
+				+ microseconds(reply.size() * 1.0e6 / options.linkBytesPerSec);
+	} else {
+		// Unlimited.
+	}
+
+	std::size_t iSent = 0u;
+	bool ok = true;
+	while (ok && iSent < reply.size()) {
+		const ssize_t n = ::send(fd, &reply[iSent], reply.size() - iSent,
+				MSG_NOSIGNAL);
+		iSent += n > 0 ? (std::size_t) n : 0u;
+		ok = n >= 0 || errno == EINTR;
+	}
+
+	return ok;
+}
+
+// Copies nBytes of a buffer from byteOffset, wrapped by mask; what was not
+//  recorded reads as zero.
+static void readSpace(uint8_t* pOut, const std::vector<uint8_t>& space,
+		uint32_t byteOffset, uint32_t mask, std::size_t nBytes)
+{
+	const std::size_t
+		offset = byteOffset & mask,
+		nKept = offset < space.size()
+				? std::min(nBytes, space.size() - offset) : 0u;
+
+	if (nKept > 0u) {
+		std::memcpy(pOut, &space[offset], nKept);
+	} else {
+		// Nothing recorded there.
+	}
+	std::memset(pOut + nKept, 0, nBytes - nKept);
+}
+
+static std::chrono::steady_clock::duration microseconds(double us)
+{
+	return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double, std::micro>(us));
+}
+
+// The emulator's costs are as configured:  its shots take no setup beyond
+//  shotSetupUs, and its link, when unlimited, is taken as the device's.
+static OI_TIMING_CAL makeTiming(const EmulatorOptions& options,
+		uint32_t nShots)
+{
+	OI_TIMING_CAL timing;
+	oiTimingDefaults(&timing);
+
+	timing.armNs = options.armUs * 1000u;
+	timing.shotNs = options.shotSetupUs * 1000u;
+	timing.pulserNs = 0u;
+	timing.tgcNs = 0u;
+	timing.adcNs = 0u;
+	timing.bdNs = 0u;
+	timing.requestNs = options.replyUs * 1000u;
+	timing.linkBytesPerSec = options.linkBytesPerSec > 0.0
+			? (uint32_t) options.linkBytesPerSec : timing.linkBytesPerSec;
+	timing.sampleRateHz = (uint32_t) options.model.sampleRateHz;
+	timing.nMeasured = nShots;
+
+	return timing;
+}
+
+} // namespace oi
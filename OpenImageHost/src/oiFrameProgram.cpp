@@ -0,0 +1,181 @@
+/*
+	oiFrameProgram.cpp
+
+	Host-side construction of frames.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiFrameProgram.h"
+
+#include "oiSamples.h"
+#include "oiTxEncode.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Levels of a level sequence (OI_TX_CHANNEL):  Vnn0 to Vpp0.
+static const int8_t MIN_LEVEL = -2;
+static const int8_t MAX_LEVEL = 2;
+
+//***********************  Local Function Declarations  **********************//
+static oi_error_t validateChannel(const OI_TX_CHANNEL& channel);
+static bool isFormat16(const OI_SHOT& shot);
+
+//****************************  Global Functions  ****************************//
+
+bool FrameProgram::addShot(const OI_SHOT& shot)
+{
+	const bool ok = shots.size() < OI_MAX_N_SHOTS;
+
+	if (ok) {
+		shots.push_back(shot);
+		bytes.clear();
+	} else {
+		// Full.
+	}
+
+	return ok;
+}
+
+oi_error_t FrameProgram::build()
+{
+	oi_error_t result = shots.empty() ? OI_ERR_INVALID_PARAMETER : OI_ERR_NONE;
+	const uint32_t nShots = getNShots();
+
+	bytes.clear();
+	for (uint32_t iS = 0u; iS < nShots && !result; ++iS) {
+		result = validateShot(shots[iS]);
+	}
+
+	// The frames are too large for the stack.
+	std::unique_ptr<OI_FRAME> pFrame(new OI_FRAME);
+	std::unique_ptr<OI_FRAME_RLE> pRle(new OI_FRAME_RLE);
+	if (result == OI_ERR_NONE) {
+		pFrame->handle = handle;
+		pFrame->nShots = nShots;
+		std::copy(shots.begin(), shots.end(), pFrame->shots);
+	} else {
+		// Already failed.
+	}
+
+	if (result != OI_ERR_NONE) {
+		// Already failed.
+	} else if (encodeFrameRle(*pFrame, *pRle)) {
+		// As loadRleFrame() in oiShotMan.c:
+		for (uint32_t iS = 0u; iS < nShots && !result; ++iS) {
+			result = oiTxRleValidate(&pRle->shots[iS].tx, pRle->templates,
+					pRle->nTemplates);
+			if (result == OI_ERR_NONE) {
+				result = oiRxValidate(&pRle->shots[iS].rx);
+			} else {
+				// Already failed.
+			}
+		}
+		command = OI_CMD_QUEUE_FRAME_RLE;
+		bytes.resize(frameBytes(*pRle));
+		std::memcpy(bytes.data(), pRle.get(), bytes.size());
+	} else if (std::all_of(shots.begin(), shots.end(), isFormat16)) {
+		// Not representable; sent as it is, in the shots of protocol
+		//  version 1, which any device takes.
+		command = OI_CMD_QUEUE_FRAME;
+		bytes.resize(frameV1Bytes(*pFrame));
+		std::memcpy(bytes.data(), pFrame.get(), OI_FRAME_BYTES(0u));
+		for (uint32_t iS = 0u; iS < nShots; ++iS) {
+			std::memcpy(&bytes[OI_FRAME_V1_BYTES(iS)], &pFrame->shots[iS],
+					OI_SHOT_V1_BYTES);
+		}
+	} else {
+		// Not representable; sent as it is, with its sample formats.
+		command = OI_CMD_QUEUE_FRAME_FORMATTED;
+		bytes.resize(frameBytes(*pFrame));
+		std::memcpy(bytes.data(), pFrame.get(), bytes.size());
+	}
+
+	if (result == OI_ERR_NONE && bytes.size() > PACKET_MAX_PAYLOAD) {
+		result = OI_ERR_INCORRECT_SIZE;
+	} else {
+		// Fits, or already failed.
+	}
+
+	if (result != OI_ERR_NONE) {
+		bytes.clear();
+	} else {
+		// Built.
+	}
+
+	return result;
+}
+
+std::size_t FrameProgram::getRawBytes() const
+{
+	std::size_t n = 0u;
+	for (const OI_SHOT& shot : shots) {
+		n += shotRecordBytes(shot.rx.nSamples, shot.rx.sampleFormat);
+	}
+
+	return n;
+}
+
+oi_error_t validateShot(const OI_SHOT& shot)
+{
+	oi_error_t result = oiRxValidateFormat(
+			shot.rx.sampleFormat,
+			shot.rx.nSamples
+	);
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN && !result; ++iC) {
+		result = validateChannel(shot.tx.channels[iC]);
+	}
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && !result; ++iAdc) {
+		if (shot.rx.nTgc[iAdc] > OI_RX_MAX_N_TGC) {
+			result = OI_ERR_INVALID_PARAMETER;
+		} else {
+			// Ok.
+		}
+	}
+
+	return result;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// A level sequence must fit, hold only the five levels, and begin and end
+//  with RTZ.
+static oi_error_t validateChannel(const OI_TX_CHANNEL& channel)
+{
+	oi_error_t result = OI_ERR_NONE;
+	const uint32_t n = channel.nLevelSequence;
+
+	if (!channel.enable) {
+		// Not played.
+	} else if (n > OI_MAX_N_LEVEL_SEQUENCE) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else if (n > 0u && (channel.levelSequence[0] != 0
+			|| channel.levelSequence[n - 1u] != 0)) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		for (uint32_t i = 0u; i < n; ++i) {
+			if (channel.levelSequence[i] < MIN_LEVEL
+					|| channel.levelSequence[i] > MAX_LEVEL) {
+				result = OI_ERR_INVALID_PARAMETER;
+			} else {
+				// Ok.
+			}
+		}
+	}
+
+	return result;
+}
+
+// Whether the shot records 16 bits, as all did in protocol version 1.
+static bool isFormat16(const OI_SHOT& shot)
+{
+	return shot.rx.sampleFormat == OI_SAMPLE_FORMAT_16;
+}
+
+} // namespace oi
@@ -0,0 +1,84 @@
+/*
+	oiIqDesign.cpp
+
+	Host-side design of the on-device baseband IQ demodulation.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiIqDesign.h"
+
+#include <cmath>
+#include <cstring>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const double PI = 3.14159265358979324;
+static const double Q15_ONE = 32768.0;
+static const double TWO_TO_32 = 4294967296.0;
+
+//****************************  Global Functions  ****************************//
+
+bool makeIqConfig(
+		OI_IQ_CONFIG& out,
+		double sampleRateHz,
+		double centerHz,
+		double bandwidthHz,
+		uint32_t decimation,
+		uint32_t nTaps
+) {
+	bool ok = sampleRateHz > 0.0 
+			&& bandwidthHz > 0.0 
+			&& decimation > 0u
+			&& decimation <= OI_IQ_MAX_DECIMATION
+			&& nTaps > 0u
+			&& nTaps <= OI_IQ_MAX_N_TAPS
+			// The complex output rate must hold the band:
+			&& bandwidthHz <= sampleRateHz / decimation;
+
+	std::memset(&out, 0, sizeof(out));
+
+	if (ok) {
+		// Wrap the LO into [0, fs):
+		const double 
+			cycles = centerHz / sampleRateHz,
+			fLo = cycles - std::floor(cycles);
+		out.enable = 1u;
+		out.phaseInc = (uint32_t) std::llround(fLo * TWO_TO_32);
+		out.decimation = (uint16_t) decimation;
+		out.nTaps = (uint16_t) nTaps;
+
+		// Low-pass at half the bandwidth:
+		const double 
+			fc = 0.5 * bandwidthHz / sampleRateHz,
+			mid = 0.5 * (nTaps - 1u);
+		double h[OI_IQ_MAX_N_TAPS], sum = 0.0;
+
+		for (uint32_t k = 0u; k < nTaps; ++k) {
+			const double 
+				t = k - mid,
+				sinc = t == 0.0 
+						? 2.0 * fc 
+						: std::sin(2.0 * PI * fc * t) / (PI * t),
+				window = nTaps == 1u ? 1.0 
+						: 0.54 - 0.46 * std::cos(2.0 * PI * k / (nTaps - 1u));
+			h[k] = sinc * window;
+			sum += h[k];
+		}
+
+		for (uint32_t k = 0u; k < nTaps; ++k) {
+			out.taps[k] = (int16_t) std::lround(
+					std::fmin(h[k] / sum * Q15_ONE, Q15_ONE - 1.0)
+			);
+		}
+
+		ok = oiIqValidate(&out) == OI_ERR_NONE;
+	} else {
+		// Fail.
+	}
+
+	return ok;
+}
+
+} // namespace oi
@@ -0,0 +1,230 @@
+/*
+	oiLz4.cpp
+
+	Host-side compression of boot partitions.  The compressor is greedy,
+	taking at each position the longest match found along a hash chain of
+	the earlier positions of the block; slow by LZ4's standards, but it is
+	run once per image, and each byte saved is a byte not read at boot.
+	The rules of the LZ4 block format are kept (the last five bytes are
+	literals, and no match starts within twelve of the end), so that the
+	blocks are also valid for other LZ4 decoders.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiLz4.h"
+
+#include "xfsbl_lz4.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const uint32_t MIN_MATCH = 4u;
+static const uint32_t LAST_LITERALS = 5u;
+static const uint32_t MATCH_LIMIT = 12u;  // from the end, for a match's start
+static const uint32_t RUN_MASK = 15u;
+static const uint32_t MAX_OFFSET = UINT16_MAX;
+
+static const uint32_t HASH_BITS = 15u;
+static const uint32_t MAX_CHAIN = 64u;     // candidates tried per position
+static const int32_t NONE = -1;
+
+//***********************  Local Function Declarations  **********************//
+static std::size_t compressBlock(
+		uint8_t* pOut,
+		const uint8_t* pIn,
+		uint32_t nIn
+);
+static uint8_t* putLength(uint8_t* p, uint32_t length);
+static void putWord(std::vector<uint8_t>& out, uint32_t word);
+static uint32_t hash4(const uint8_t* p);
+
+//****************************  Global Functions  ****************************//
+
+std::vector<uint8_t> lz4Compress(const uint8_t* pData, std::size_t nBytes)
+{
+	std::vector<uint8_t> out, block(XFSBL_LZ4_BLOCK_SIZE * 2u);
+
+	putWord(out, XFSBL_LZ4_MAGIC);
+	putWord(out, (uint32_t) nBytes);
+
+	for (std::size_t done = 0u; done < nBytes; ) {
+		const uint32_t n = (uint32_t) std::min<std::size_t>(
+				XFSBL_LZ4_BLOCK_SIZE, nBytes - done);
+		const std::size_t nPacked = compressBlock(block.data(), &pData[done], n);
+
+		if (nPacked < n) {
+			putWord(out, (uint32_t) nPacked);
+			out.insert(out.end(), block.begin(), block.begin() + nPacked);
+		} else {
+			// Would grow; stored as it is.
+			putWord(out, n | XFSBL_LZ4_STORED);
+			out.insert(out.end(), &pData[done], &pData[done + n]);
+		}
+		done += n;
+	}
+
+	putWord(out, 0u);
+	out.resize((out.size() + 3u) & ~(std::size_t) 3u, 0u);
+
+	return out;
+}
+
+bool lz4Decompress(
+		std::vector<uint8_t>& out,
+		const uint8_t* pPacked,
+		std::size_t nPacked,
+		std::size_t chunkBytes
+) {
+	uint32_t length = 0u;
+	if (nPacked >= 2u * sizeof(uint32_t)) {
+		std::memcpy(&length, &pPacked[sizeof(uint32_t)], sizeof(length));
+	} else {
+		// Too short; the decoder will say so.
+	}
+	out.assign(length, 0u);
+
+	XFsblLz4 lz4;
+	XFsbl_Lz4Init(&lz4, out.data(), length);
+
+	uint32_t result = XFSBL_LZ4_MORE;
+	for (std::size_t pos = 0u; pos < nPacked && result != XFSBL_LZ4_DONE
+			&& result != XFSBL_LZ4_ERROR; ) {
+		const std::size_t chunkEnd = std::min(nPacked,
+				(pos / chunkBytes + 1u) * chunkBytes);
+
+		// As the FSBL does, until the chunk is used:
+		while (pos < chunkEnd && result != XFSBL_LZ4_DONE
+				&& result != XFSBL_LZ4_ERROR) {
+			uint32_t used = 0u;
+			result = XFsbl_Lz4Decode(&lz4, &pPacked[pos],
+					(uint32_t) (chunkEnd - pos), &used);
+			pos += used;
+		}
+		pos = chunkEnd;
+	}
+
+	return result == XFSBL_LZ4_DONE;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Compresses one block into pOut, which must hold twice nIn; returns the
+//  length written.
+static std::size_t compressBlock(
+		uint8_t* pOut,
+		const uint8_t* pIn,
+		uint32_t nIn
+) {
+	std::vector<int32_t> head(1u << HASH_BITS, NONE), prev(nIn, NONE);
+	uint8_t* p = pOut;
+	uint32_t anchor = 0u, pos = 0u;
+
+	while (nIn > MATCH_LIMIT && pos < nIn - MATCH_LIMIT) {
+		// Longest match along the chain:
+		const uint32_t
+			h = hash4(&pIn[pos]),
+			maxLength = nIn - LAST_LITERALS - pos;
+		uint32_t bestLength = 0u, bestOffset = 0u, nTried = 0u;
+
+		for (int32_t cand = head[h]; cand != NONE && nTried < MAX_CHAIN
+				&& pos - (uint32_t) cand <= MAX_OFFSET;
+				cand = prev[cand], ++nTried) {
+			uint32_t length = 0u;
+			while (length < maxLength && pIn[cand + length] == pIn[pos + length]) {
+				++length;
+			}
+			if (length > bestLength) {
+				bestLength = length;
+				bestOffset = pos - (uint32_t) cand;
+			} else {
+				// Shorter.
+			}
+		}
+		prev[pos] = head[h];
+		head[h] = (int32_t) pos;
+
+		if (bestLength < MIN_MATCH) {
+			++pos;
+			continue;
+		} else {
+			// Found one.
+		}
+
+		// The sequence:  literals since the anchor, then the match.
+		const uint32_t
+			nLiterals = pos - anchor,
+			matchCode = bestLength - MIN_MATCH;
+		*p++ = (uint8_t) ((std::min(nLiterals, RUN_MASK) << 4)
+				| std::min(matchCode, RUN_MASK));
+		if (nLiterals >= RUN_MASK) {
+			p = putLength(p, nLiterals - RUN_MASK);
+		} else {
+			// In the token.
+		}
+		std::memcpy(p, &pIn[anchor], nLiterals);
+		p += nLiterals;
+		*p++ = (uint8_t) bestOffset;
+		*p++ = (uint8_t) (bestOffset >> 8);
+		if (matchCode >= RUN_MASK) {
+			p = putLength(p, matchCode - RUN_MASK);
+		} else {
+			// In the token.
+		}
+
+		// Positions within the match are still chained, for later matches:
+		const uint32_t end = pos + bestLength;
+		for (++pos; pos < end && pos + MIN_MATCH <= nIn; ++pos) {
+			const uint32_t hPos = hash4(&pIn[pos]);
+			prev[pos] = head[hPos];
+			head[hPos] = (int32_t) pos;
+		}
+		pos = end;
+		anchor = end;
+	}
+
+	// The last literals:
+	const uint32_t nLiterals = nIn - anchor;
+	*p++ = (uint8_t) (std::min(nLiterals, RUN_MASK) << 4);
+	if (nLiterals >= RUN_MASK) {
+		p = putLength(p, nLiterals - RUN_MASK);
+	} else {
+		// In the token.
+	}
+	std::memcpy(p, &pIn[anchor], nLiterals);
+	p += nLiterals;
+
+	return (std::size_t) (p - pOut);
+}
+
+// The part of a length beyond its token:  255s, then the remainder.
+static uint8_t* putLength(uint8_t* p, uint32_t length)
+{
+	while (length >= 255u) {
+		*p++ = 255u;
+		length -= 255u;
+	}
+	*p++ = (uint8_t) length;
+
+	return p;
+}
+
+static void putWord(std::vector<uint8_t>& out, uint32_t word)
+{
+	for (uint32_t i = 0u; i < 4u; ++i) {
+		out.push_back((uint8_t) (word >> (8u * i)));
+	}
+}
+
+static uint32_t hash4(const uint8_t* p)
+{
+	uint32_t word;
+	std::memcpy(&word, p, sizeof(word));
+
+	return (word * 2654435761u) >> (32u - HASH_BITS);
+}
+
+} // namespace oi
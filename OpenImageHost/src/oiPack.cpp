@@ -0,0 +1,145 @@
+/*
+	oiPack.cpp
+
+	Host-side decoding of packed raw frame data.  The bits are read from a
+	64-bit window, refilled eight bytes at a time where possible, and the
+	unary quotients are counted with one instruction.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiPack.h"
+
+#include <cstring>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const uint32_t N_ORDERS = 3u;
+
+//**********************************  Types  *********************************//
+
+// Reader of the least-significant-bit first stream.
+class BitReader {
+public:
+	BitReader(const uint8_t* p, std::size_t n) : pNext(p), pEnd(p + n) {}
+
+	// Makes at least 57 bits available, if the stream has them.
+	void refill()
+	{
+		if (pEnd - pNext >= 8) {
+			uint64_t word;
+			std::memcpy(&word, pNext, sizeof(word));  // little-endian host
+			window |= word << nWindow;
+			pNext += (63u - nWindow) >> 3;
+			nWindow |= 56u;
+		} else {
+			while (nWindow <= 56u && pNext < pEnd) {
+				window |= (uint64_t) *pNext++ << nWindow;
+				nWindow += 8u;
+			}
+		}
+	}
+
+	// The caller refills first; returns false if the stream is exhausted.
+	bool get(uint32_t nBits, uint32_t& value)
+	{
+		const bool ok = nBits <= nWindow;
+		if (ok) {
+			value = (uint32_t) (window & ((1ull << nBits) - 1u));
+			window = nBits < 64u ? window >> nBits : 0u;
+			nWindow -= nBits;
+		} else {
+			// Truncated.
+		}
+		return ok;
+	}
+
+	// Count of the ones before the first zero, up to 'limit'.
+	uint32_t countOnes(uint32_t limit) const
+	{
+		const uint32_t n = ~window == 0u 
+				? 64u 
+				: (uint32_t) __builtin_ctzll(~window);
+		return n < limit ? n : limit;
+	}
+
+private:
+	const uint8_t* pNext;
+	const uint8_t* const pEnd;
+	uint64_t window = 0u;
+	uint32_t nWindow = 0u;
+};
+
+//****************************  Global Functions  ****************************//
+
+bool unpackRaw(
+		int16_t* pOut,
+		uint32_t nRows,
+		const uint8_t* pPacked,
+		std::size_t nPacked
+) {
+	BitReader in(pPacked, nPacked);
+	int32_t
+		x1[PACK_N_LANES] = { 0 },
+		x2[PACK_N_LANES] = { 0 };
+	bool ok = true;
+
+	for (uint32_t row0 = 0u; row0 < nRows && ok; row0 += OI_PACK_BLOCK_ROWS) {
+		const uint32_t nB = nRows - row0 < OI_PACK_BLOCK_ROWS 
+				? nRows - row0 
+				: OI_PACK_BLOCK_ROWS;
+		uint32_t shift = 0u;
+
+		in.refill();
+		ok = in.get(4u, shift);
+
+		for (uint32_t iLane = 0u; iLane < PACK_N_LANES && ok; ++iLane) {
+			uint32_t header = 0u;
+			in.refill();
+			ok = in.get(7u, header);
+
+			const uint32_t
+				order = header & 3u,
+				k = header >> 2;
+			ok = ok && order < N_ORDERS && k <= OI_PACK_MAX_K;
+
+			int32_t 
+				p1 = x1[iLane],
+				p2 = x2[iLane];
+			for (uint32_t r = 0u; r < nB && ok; ++r) {
+				in.refill();
+				const uint32_t q = in.countOnes(OI_PACK_ESCAPE_Q);
+				uint32_t u = 0u, low = 0u, skip = 0u;
+
+				if (q < OI_PACK_ESCAPE_Q) {
+					ok = in.get(q + 1u, skip) && in.get(k, low);
+					u = q << k | low;
+				} else {
+					ok = in.get(OI_PACK_ESCAPE_Q, skip)
+							&& in.get(OI_PACK_ESCAPE_BITS, u);
+				}
+
+				const int32_t
+					res = (int32_t) (u >> 1) ^ -(int32_t) (u & 1u),
+					s1 = p1 >> shift,
+					s2 = p2 >> shift,
+					pred = order == 0u ? 0 : order == 1u ? s1 : 2 * s1 - s2,
+					x = (int32_t) ((uint32_t) (pred + res) << shift);
+
+				ok = ok && x >= INT16_MIN && x <= INT16_MAX;
+				pOut[(std::size_t) (row0 + r) * PACK_N_LANES + iLane] 
+					= (int16_t) x;
+				p2 = p1;
+				p1 = x;
+			}
+
+			x1[iLane] = p1;
+			x2[iLane] = p2;
+		}
+	}
+
+	return ok;
+}
+
+} // namespace oi
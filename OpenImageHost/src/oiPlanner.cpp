@@ -0,0 +1,133 @@
+/*
+	oiPlanner.cpp
+
+	Host-side planning of frames with the timing model of the shot
+	pipeline.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiPlanner.h"
+
+#include <cstring>
+
+namespace oi {
+
+//****************************  Global Functions  ****************************//
+
+FramePlanner::FramePlanner(const PlannerOptions& options)
+	: options(options)
+{
+	oiTimingDefaults(&timing);
+}
+
+FramePlanner::FramePlanner(const OI_TIMING_CAL& timing,
+		const PlannerOptions& options)
+	: timing(timing), options(options)
+{
+}
+
+OI_ESTIMATE_REQ FramePlanner::makeRequest(const FrameProgram& program) const
+{
+	OI_ESTIMATE_REQ req;
+	std::memset(&req, 0, sizeof(req));
+
+	const uint32_t nShots = program.getNShots();
+	req.nShots = nShots;
+	req.programBytes = (uint32_t) program.getBytes().size();
+	req.chunkBytes = (uint32_t) options.chunkBytes;
+	req.pollNs = (uint32_t) std::chrono::duration_cast<
+			std::chrono::nanoseconds>(options.pollPeriod).count();
+	req.clearDepthUm = options.clearDepthUm;
+	req.speedOfSound = options.speedOfSound;
+
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		const OI_RX& rx = program.getShot(iS).rx;
+		// The shot before the first is the last, of the frame before:
+		const OI_RX& prev = program.getShot(iS > 0u ? iS - 1u : nShots - 1u).rx;
+
+		req.shots[iS].nSamples = rx.nSamples;
+		req.shots[iS].sampleFormat = rx.sampleFormat;
+		req.shots[iS].flags = std::memcmp(rx.tgc, prev.tgc, sizeof(rx.tgc))
+				!= 0 ? OI_ESTIMATE_TGC_LOAD : 0u;
+	}
+
+	return req;
+}
+
+bool FramePlanner::estimate(const FrameProgram& program,
+		OI_FRAME_ESTIMATE& out) const
+{
+	bool ok = !program.getBytes().empty();
+
+	if (ok) {
+		const OI_ESTIMATE_REQ req = makeRequest(program);
+		ok = oiTimingEstimate(&out, &req, &timing) == OI_ERR_NONE;
+	} else {
+		// Not built.
+	}
+
+	return ok;
+}
+
+// The frame time grows with the shots, so the most that reach the rate
+//  are found by bisection.
+uint32_t FramePlanner::fitShots(const OI_SHOT& shot, double frameRateHz) const
+{
+	uint32_t
+		lo = 0u,                     // reaches, or none
+		hi = OI_MAX_N_SHOTS + 1u;    // does not, or too many
+
+	while (hi - lo > 1u) {
+		const uint32_t mid = lo + (hi - lo) / 2u;
+		if (reaches(shot, mid, frameRateHz)) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+// As fitShots, in steps of whole blocks for the packed formats.
+uint32_t FramePlanner::fitSamples(const OI_SHOT& shot, uint32_t nShots,
+		double frameRateHz, uint32_t maxSamples) const
+{
+	const uint32_t step = shot.rx.sampleFormat != OI_SAMPLE_FORMAT_16
+			? OI_SAMPLE_FORMAT_ROWS : 1u;
+	OI_SHOT s = shot;
+	uint32_t
+		lo = 0u,                     // steps that reach, or none
+		hi = maxSamples / step + 1u; // steps that do not, or too many
+
+	while (hi - lo > 1u) {
+		const uint32_t mid = lo + (hi - lo) / 2u;
+		s.rx.nSamples = mid * step;
+		if (reaches(s, nShots, frameRateHz)) {
+			lo = mid;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo * step;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Whether a frame of nShots of the shot estimates at frameRateHz or more.
+bool FramePlanner::reaches(const OI_SHOT& shot, uint32_t nShots,
+		double frameRateHz) const
+{
+	FrameProgram program;
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		program.addShot(shot);
+	}
+
+	OI_FRAME_ESTIMATE est;
+	return program.build() == OI_ERR_NONE && estimate(program, est)
+			&& est.frameRateMilliHz >= frameRateHz * 1.0e3;
+}
+
+} // namespace oi
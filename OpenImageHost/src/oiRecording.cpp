@@ -0,0 +1,413 @@
+/*
+	oiRecording.cpp
+
+	Host-side recordings of raw frames, over POSIX files.  The writer writes
+	each frame's data, then the header's frame count, each with one pwrite,
+	so that a reader which reads the count finds the data before it.  The
+	reader reads the header with pread, and maps the file up to the frames
+	counted, mapping it again as it grows.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiRecording.h"
+
+#include "oiSamples.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace oi {
+
+//***********************  Local Function Declarations  **********************//
+static uint64_t roundToPage(uint64_t nBytes);
+static bool readAt(int fd, uint64_t offset, void* pOut, std::size_t nBytes);
+
+//****************************  Global Functions  ****************************//
+
+bool RecordingWriter::create(const std::string& path,
+		const FrameProgram& program)
+{
+	close();
+	if (program.getNShots() == 0u) {
+		return false;
+	} else {
+		// Something to record.
+	}
+
+	fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (fd < 0) {
+		return false;
+	} else {
+		// Created.
+	}
+
+	const uint32_t nShots = program.getNShots();
+	header = makeRecordingHeader(program);
+	shotOffset = recordingShotOffsets(program);
+	index.clear();
+
+	bool ok = true;
+	for (uint32_t iShot = 0u; iShot < nShots && ok; ++iShot) {
+		ok = writeAt(header.programOffset + iShot * sizeof(OI_SHOT),
+				&program.getShot(iShot), sizeof(OI_SHOT));
+	}
+	ok = ok && writeAt(0u, &header, sizeof(header));
+	if (!ok) {
+		::close(fd);
+		fd = -1;
+	} else {
+		// Ready for frames.
+	}
+
+	return ok;
+}
+
+bool RecordingWriter::append(const uint8_t* const ppData[OI_RX_N_CHIPS],
+		uint64_t receivedNs)
+{
+	if (fd < 0) {
+		return false;
+	} else {
+		// Open.
+	}
+
+	const RecordingIndexEntry entry = indexRecordingFrame(ppData, shotOffset,
+			header.frameOffset + header.nFrames * header.frameStride,
+			receivedNs);
+
+	bool ok = true;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && ok; ++iAdc) {
+		ok = writeAt(entry.offset + header.adcOffset[iAdc], ppData[iAdc],
+				header.adcBytes[iAdc]);
+	}
+
+	// Then count it:
+	if (ok) {
+		++header.nFrames;
+		ok = writeAt(offsetof(RecordingHeader, nFrames), &header.nFrames,
+				sizeof(header.nFrames));
+		index.push_back(entry);
+	} else {
+		// Not counted; the next frame overwrites it.
+	}
+
+	return ok;
+}
+
+bool RecordingWriter::sync()
+{
+	return fd >= 0 && ::fdatasync(fd) == 0;
+}
+
+bool RecordingWriter::close()
+{
+	if (fd < 0) {
+		return true;
+	} else {
+		// Open.
+	}
+
+	header.indexOffset = header.frameOffset
+			+ header.nFrames * header.frameStride;
+	const bool ok = writeAt(header.indexOffset, index.data(),
+			index.size() * sizeof(RecordingIndexEntry))
+			&& writeAt(0u, &header, sizeof(header));
+
+	::close(fd);
+	fd = -1;
+
+	return ok;
+}
+
+bool RecordingWriter::writeAt(uint64_t offset, const void* pData,
+		std::size_t nBytes)
+{
+	const uint8_t* p = (const uint8_t*) pData;
+	bool ok = true;
+
+	while (nBytes > 0u && ok) {
+		const ssize_t n = ::pwrite(fd, p, nBytes, (off_t) offset);
+		if (n > 0) {
+			p += n;
+			offset += (uint64_t) n;
+			nBytes -= (std::size_t) n;
+		} else {
+			ok = n < 0 && errno == EINTR;
+		}
+	}
+
+	return ok;
+}
+
+bool RecordingReader::open(const std::string& path)
+{
+	close();
+	fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	bool ok = fd >= 0 && readAt(fd, 0u, &header, sizeof(header))
+			&& header.magic == RECORDING_MAGIC
+			&& header.version == RECORDING_VERSION
+			&& header.nShots > 0u && header.nShots <= OI_MAX_N_SHOTS;
+
+	program.clear();
+	program.setHandle(header.handle);
+	for (uint32_t iShot = 0u; iShot < header.nShots && ok; ++iShot) {
+		OI_SHOT shot;
+		ok = readAt(fd, header.programOffset + iShot * sizeof(OI_SHOT), &shot,
+				sizeof(shot));
+		program.addShot(shot);
+	}
+
+	// The layout must be the program's:
+	if (ok) {
+		shotOffset = recordingShotOffsets(program);
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			ok = ok && header.adcBytes[iAdc] == program.getRawBytes()
+					&& header.adcOffset[iAdc] + header.adcBytes[iAdc]
+							<= header.frameStride;
+		}
+	} else {
+		// Not a recording.
+	}
+
+	if (ok) {
+		refresh();
+	} else {
+		close();
+	}
+
+	return ok;
+}
+
+void RecordingReader::close()
+{
+	if (pMap != nullptr) {
+		::munmap((void*) pMap, nMapped);
+		pMap = nullptr;
+		nMapped = 0u;
+	} else {
+		// Not mapped.
+	}
+	if (fd >= 0) {
+		::close(fd);
+		fd = -1;
+	} else {
+		// Not open.
+	}
+
+	header = {};
+	nFrames = 0u;
+	isClosed = false;
+	index.clear();
+}
+
+uint64_t RecordingReader::refresh()
+{
+	if (fd < 0 || isClosed
+			|| !readAt(fd, 0u, &header, sizeof(header))) {
+		return nFrames;
+	} else {
+		// Read again.
+	}
+
+	const uint64_t nBytes = header.indexOffset != 0u
+			? header.indexOffset + header.nFrames * sizeof(RecordingIndexEntry)
+			: header.frameOffset + header.nFrames * header.frameStride;
+	if (remap((std::size_t) nBytes)) {
+		nFrames = header.nFrames;
+		if (header.indexOffset != 0u) {
+			const RecordingIndexEntry* const pIndex =
+					(const RecordingIndexEntry*) (pMap + header.indexOffset);
+			index.assign(pIndex, pIndex + nFrames);
+			isClosed = true;
+		} else {
+			// Still being written.
+		}
+	} else {
+		// Keep what is mapped.
+	}
+
+	return nFrames;
+}
+
+bool RecordingReader::getIndexEntry(uint64_t iFrame,
+		RecordingIndexEntry& entry) const
+{
+	const bool ok = iFrame < index.size();
+	if (ok) {
+		entry = index[iFrame];
+	} else {
+		// Incomplete, or no such frame.
+	}
+
+	return ok;
+}
+
+const uint8_t* RecordingReader::getShotRecord(uint64_t iFrame,
+		uint32_t iShot, uint32_t iAdc) const
+{
+	return iFrame < nFrames && iShot < header.nShots && iAdc < OI_RX_N_CHIPS
+			? pMap + header.frameOffset + iFrame * header.frameStride
+					+ header.adcOffset[iAdc] + shotOffset[iShot]
+			: nullptr;
+}
+
+const int16_t* RecordingReader::getShotSamples(uint64_t iFrame,
+		uint32_t iShot, uint32_t iAdc) const
+{
+	const uint8_t* const pRecord = getShotRecord(iFrame, iShot, iAdc);
+
+	return pRecord != nullptr
+			&& program.getShot(iShot).rx.sampleFormat == OI_SAMPLE_FORMAT_16
+			? (const int16_t*) (pRecord + OI_SHOT_HEADER_BYTES)
+			: nullptr;
+}
+
+ChannelView RecordingReader::getChannel(uint64_t iFrame, uint32_t iShot,
+		uint32_t iChan, const ChannelMap& map) const
+{
+	ChannelView view;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		for (uint32_t iLane = 0u; iLane < DEINTERLEAVE_N_LANES; ++iLane) {
+			const int16_t* const pSamples = map.channel[iAdc][iLane] == iChan
+					? getShotSamples(iFrame, iShot, iAdc)
+					: nullptr;
+			if (pSamples != nullptr) {
+				view.pSamples = pSamples + iLane;
+				view.stride = DEINTERLEAVE_N_LANES;
+				view.nSamples = program.getShot(iShot).rx.nSamples;
+			} else {
+				// Another lane, or nothing recorded.
+			}
+		}
+	}
+
+	return view;
+}
+
+// Maps at least nBytes of the file, whole; pages past its end are never
+//  read.
+bool RecordingReader::remap(std::size_t nBytes)
+{
+	if (nBytes <= nMapped) {
+		return true;
+	} else {
+		// Grown.
+	}
+
+	void* const p = ::mmap(nullptr, nBytes, PROT_READ, MAP_SHARED, fd, 0);
+	const bool ok = p != MAP_FAILED;
+	if (ok) {
+		if (pMap != nullptr) {
+			::munmap((void*) pMap, nMapped);
+		} else {
+			// First mapping.
+		}
+		pMap = (const uint8_t*) p;
+		nMapped = nBytes;
+	} else {
+		// Keep the old one.
+	}
+
+	return ok;
+}
+
+RecordingHeader makeRecordingHeader(const FrameProgram& program)
+{
+	RecordingHeader header = {};
+
+	header.magic = RECORDING_MAGIC;
+	header.version = RECORDING_VERSION;
+	header.handle = program.getHandle();
+	header.nShots = program.getNShots();
+	header.programOffset = RECORDING_PAGE_BYTES;
+	header.frameOffset = roundToPage(header.programOffset
+			+ header.nShots * sizeof(OI_SHOT));
+	uint64_t offset = 0u;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		header.adcOffset[iAdc] = offset;
+		header.adcBytes[iAdc] = program.getRawBytes();
+		offset = roundToPage(offset + header.adcBytes[iAdc]);
+	}
+	header.frameStride = offset;
+	header.createdNs = (uint64_t) std::chrono::duration_cast<
+			std::chrono::nanoseconds>(
+					std::chrono::system_clock::now().time_since_epoch()).count();
+
+	return header;
+}
+
+std::vector<std::size_t> recordingShotOffsets(const FrameProgram& program)
+{
+	std::vector<std::size_t> offsets;
+	std::size_t offset = 0u;
+
+	for (uint32_t iShot = 0u; iShot < program.getNShots(); ++iShot) {
+		const OI_RX& rx = program.getShot(iShot).rx;
+		offsets.push_back(offset);
+		offset += shotRecordBytes(rx.nSamples, rx.sampleFormat);
+	}
+
+	return offsets;
+}
+
+RecordingIndexEntry indexRecordingFrame(
+		const uint8_t* const ppData[OI_RX_N_CHIPS],
+		const std::vector<std::size_t>& shotOffset,
+		uint64_t offset,
+		uint64_t receivedNs
+) {
+	RecordingIndexEntry entry = {};
+
+	entry.offset = offset;
+	entry.receivedNs = receivedNs;
+	std::memcpy(&entry.handle, ppData[0] + offsetof(OI_SHOT_HEADER, handle),
+			sizeof(entry.handle));
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		for (const std::size_t o : shotOffset) {
+			OI_SHOT_HEADER shot;
+			std::memcpy(&shot, ppData[iAdc] + o, sizeof(shot));
+			entry.nBadShots += isShotGood(shot) ? 0u : 1u;
+		}
+	}
+
+	return entry;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static uint64_t roundToPage(uint64_t nBytes)
+{
+	return (nBytes + RECORDING_PAGE_BYTES - 1u) / RECORDING_PAGE_BYTES
+			* RECORDING_PAGE_BYTES;
+}
+
+static bool readAt(int fd, uint64_t offset, void* pOut, std::size_t nBytes)
+{
+	uint8_t* p = (uint8_t*) pOut;
+	bool ok = true;
+
+	while (nBytes > 0u && ok) {
+		const ssize_t n = ::pread(fd, p, nBytes, (off_t) offset);
+		if (n > 0) {
+			p += n;
+			offset += (uint64_t) n;
+			nBytes -= (std::size_t) n;
+		} else {
+			ok = n < 0 && errno == EINTR;
+		}
+	}
+
+	return ok;
+}
+
+} // namespace oi
@@ -0,0 +1,232 @@
+/*
+	oiSamples.cpp
+
+	Host-side conversion of packed sample formats.  Each packed row is a
+	whole number of bytes (14 or 12), so rows are unpacked independently:
+	on x86 with one byte shuffle and one multiply per eight samples, which
+	moves each sample to the top of its lane; elsewhere, and for the last
+	rows (which the 16-byte loads would overrun), with the scalar version.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiSamples.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#	define OI_SAMPLES_X86 1
+#	include <immintrin.h>
+#else
+#	define OI_SAMPLES_X86 0
+#endif
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Samples in each row.
+static const uint32_t N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+
+//***********************  Local Function Declarations  **********************//
+static void unpackScalar(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows,
+		uint32_t bits
+);
+#if OI_SAMPLES_X86
+static std::size_t unpack14Sse(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows
+);
+static std::size_t unpack12Ssse3(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows
+);
+#endif
+
+//****************************  Global Functions  ****************************//
+
+bool unpackSamples(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows,
+		uint32_t format
+) {
+	const bool ok = format < OI_N_SAMPLE_FORMATS;
+	const uint32_t bits = OI_SAMPLE_BITS(format);
+	std::size_t nDone = 0u;
+
+	if (!ok) {
+		// Unknown format.
+	} else if (format == OI_SAMPLE_FORMAT_16) {
+		std::memcpy(pOut, pIn, nRows * N_LANES * sizeof(int16_t));
+		nDone = nRows;
+	} else {
+#if OI_SAMPLES_X86
+		if (format == OI_SAMPLE_FORMAT_14
+				&& __builtin_cpu_supports("sse4.1")) {
+			nDone = unpack14Sse(pOut, pIn, nRows);
+		} else if (format == OI_SAMPLE_FORMAT_12
+				&& __builtin_cpu_supports("ssse3")) {
+			nDone = unpack12Ssse3(pOut, pIn, nRows);
+		} else {
+			// Scalar only.
+		}
+#endif
+	}
+
+	if (ok && nDone < nRows) {
+		const std::size_t rowBytes = N_LANES * bits / 8u;
+		unpackScalar(
+				pOut + nDone * N_LANES,
+				pIn + nDone * rowBytes,
+				nRows - nDone,
+				bits
+		);
+	} else {
+		// Finished, or failed.
+	}
+
+	return ok;
+}
+
+bool packSamples(
+		uint8_t* pOut,
+		const int16_t* pIn,
+		std::size_t nRows,
+		uint32_t format
+) {
+	const bool ok = format < OI_N_SAMPLE_FORMATS;
+
+	if (ok) {
+		const uint32_t bits = OI_SAMPLE_BITS(format);
+		uint64_t window = 0u;
+		uint32_t nWindow = 0u;
+
+		for (std::size_t i = 0u; i < nRows * N_LANES; ++i) {
+			window |= (uint64_t) ((uint16_t) pIn[i] >> (16u - bits))
+					<< nWindow;
+			nWindow += bits;
+
+			while (nWindow >= 8u) {
+				*pOut++ = (uint8_t) window;
+				window >>= 8;
+				nWindow -= 8u;
+			}
+		}
+		// Rows are whole bytes, so nothing is left over.
+	} else {
+		// Unknown format.
+	}
+
+	return ok;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Sample j of a row starts at bit bits*j; it spans at most three bytes, and
+//  only needs the third if it does not fit in the first two.
+static void unpackScalar(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows,
+		uint32_t bits
+) {
+	const std::size_t rowBytes = N_LANES * bits / 8u;
+	const uint32_t mask = (1u << bits) - 1u;
+
+	for (std::size_t iRow = 0u; iRow < nRows; ++iRow) {
+		const uint8_t* const pRow = pIn + iRow * rowBytes;
+
+		for (uint32_t j = 0u; j < N_LANES; ++j) {
+			const uint32_t
+				iByte = bits * j / 8u,
+				shift = bits * j % 8u;
+			uint32_t v = pRow[iByte] | (uint32_t) pRow[iByte + 1u] << 8;
+			if (shift + bits > 16u) {
+				v |= (uint32_t) pRow[iByte + 2u] << 16;
+			} else {
+				// Within two bytes.
+			}
+
+			*pOut++ = (int16_t) (uint16_t) (((v >> shift) & mask)
+					<< (16u - bits));
+		}
+	}
+}
+
+#if OI_SAMPLES_X86
+
+// Each sample is gathered into a 32-bit lane, shifted up by a multiply so
+//  that it ends at bit 31, masked, and brought down with its sign.  Returns
+//  the number of rows done; the last row is left, as its 16-byte load
+//  would overrun by two.
+__attribute__((target("sse4.1")))
+static std::size_t unpack14Sse(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows
+) {
+	const __m128i
+		idxLo = _mm_setr_epi8(0,1,2,3, 1,2,3,4, 3,4,5,6, 5,6,7,8),
+		idxHi = _mm_setr_epi8(7,8,9,10, 8,9,10,11, 10,11,12,13, 12,13,-1,-1),
+		// 2^(18 - shift) for the bit offset of each sample in its bytes:
+		mul = _mm_setr_epi32(1 << 18, 1 << 12, 1 << 14, 1 << 16),
+		mask = _mm_set1_epi32((int32_t) 0xFFFC0000u);
+	const std::size_t n = nRows > 1u ? nRows - 1u : 0u;
+
+	for (std::size_t iRow = 0u; iRow < n; ++iRow) {
+		const __m128i row
+			= _mm_loadu_si128((const __m128i*) (pIn + iRow * 14u));
+		const __m128i
+			lo = _mm_srai_epi32(_mm_and_si128(_mm_mullo_epi32(
+					_mm_shuffle_epi8(row, idxLo), mul), mask), 16),
+			hi = _mm_srai_epi32(_mm_and_si128(_mm_mullo_epi32(
+					_mm_shuffle_epi8(row, idxHi), mul), mask), 16);
+
+		_mm_storeu_si128(
+				(__m128i*) (pOut + iRow * N_LANES),
+				_mm_packs_epi32(lo, hi)
+		);
+	}
+
+	return n;
+}
+
+// As unpack14Sse, in 16-bit lanes:  even samples start on a byte and are
+//  shifted up by four, odd samples already end at the top.  The 16-byte
+//  load overruns a 12-byte row by four, so the last row is left.
+__attribute__((target("ssse3")))
+static std::size_t unpack12Ssse3(
+		int16_t* pOut,
+		const uint8_t* pIn,
+		std::size_t nRows
+) {
+	const __m128i
+		idx = _mm_setr_epi8(0,1, 1,2, 3,4, 4,5, 6,7, 7,8, 9,10, 10,11),
+		mul = _mm_setr_epi16(16, 1, 16, 1, 16, 1, 16, 1),
+		mask = _mm_set1_epi16((int16_t) 0xFFF0u);
+	const std::size_t n = nRows > 1u ? nRows - 1u : 0u;
+
+	for (std::size_t iRow = 0u; iRow < n; ++iRow) {
+		const __m128i row
+			= _mm_loadu_si128((const __m128i*) (pIn + iRow * 12u));
+
+		_mm_storeu_si128(
+				(__m128i*) (pOut + iRow * N_LANES),
+				_mm_and_si128(
+						_mm_mullo_epi16(_mm_shuffle_epi8(row, idx), mul),
+						mask
+				)
+		);
+	}
+
+	return n;
+}
+
+#endif
+
+} // namespace oi
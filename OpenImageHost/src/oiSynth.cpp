@@ -0,0 +1,262 @@
+/*
+	oiSynth.cpp
+
+	Host-side synthesis of recorded samples.  Each element that transmits
+	sends a Gaussian tone burst at the transducer's centre frequency, at
+	the first clock of its level sequence that is not RTZ; each target
+	returns it to each receiving element after the round trip.  The sum is
+	amplified by the TGC level of each moment, noise is added, and the
+	result is quantized as the AD9670's 14 bits.  The burst and the noise
+	are tabulated, so that a shot takes little longer to synthesize than
+	to record.
+
+	The test patterns approximate what the AD9670 sends with the settings
+	of oiAdc.c; the emulator needs them to be recognizable, not exact.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiSynth.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+static const uint32_t N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+
+static const double PI = 3.14159265358979324;
+static const double FULL_SCALE = 32767.0;
+static const double M_PER_UM = 1.0e-6;
+static const double M_PER_NM = 1.0e-9;
+static const double SEC_PER_TGC_POINT = OI_TGC_POINT_NS * 1.0e-9;
+
+// The burst's Gaussian envelope, in cycles of the centre frequency:  its
+//  standard deviation, and how far either side of the peak it is drawn.
+//  It is tabulated at this many points per sample.
+static const double BURST_SIGMA_CYCLES = 0.5;
+static const double BURST_EXTENT_SIGMAS = 3.0;
+static const double BURST_OVERSAMPLE = 32.0;
+
+// Unit Gaussian noise is read from a table, from a random start for each
+//  lane of each shot, rather than drawn for every sample.
+static const std::size_t N_NOISE = 0x10000u;
+static const uint32_t NOISE_SEED = 0x4F49u;
+
+// The 14 bits of the AD9670, in the upper bits of each sample.
+static const int16_t SAMPLE_MASK = (int16_t) 0xFFFC;
+
+// As AD9670_REG_USR_PAT1..4 (see oiAdcCal.c).
+static const uint16_t USER_PATTERNS[] = { 0x1234u, 0xDEADu, 0xF00Du, 0xFACEu };
+static const uint32_t N_USER_PATTERNS = 4u;
+
+// The digital sine and analog tone of TEST_SINE_REGS and
+//  TEST_ANA_TONES_REGS:  cycles per sample, and amplitude.
+static const double SINE_CYCLES = 1.0 / 32.0;
+static const double SINE_AMPLITUDE = 0.5;
+static const double TONE_CYCLES = 1.0 / 16.0;
+static const double TONE_AMPLITUDE = 0.25;
+
+//***********************  Local Function Declarations  **********************//
+static void synthesizeEchoes(
+		double* pOut,
+		const OI_SHOT& shot,
+		const SynthModel& model,
+		uint32_t iAdc
+);
+static double elementXm(uint32_t iChan, uint32_t pitchNm);
+static std::vector<double> renderGain(const OI_RX& rx, uint32_t iAdc,
+		const SynthModel& model);
+static const std::vector<double>& getNoise();
+
+//****************************  Global Functions  ****************************//
+
+void synthesizeShot(
+		int16_t* const ppOut[OI_RX_N_CHIPS],
+		const OI_SHOT& shot,
+		const SynthModel& model,
+		uint32_t seed
+) {
+	const uint32_t nSamples = shot.rx.nSamples;
+	const std::vector<double>& noise = getNoise();
+	std::mt19937 random(seed);
+	std::vector<double> acc((std::size_t) nSamples * N_LANES);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const uint32_t mode = shot.rx.testMode[iAdc];
+		const std::vector<double> gain = renderGain(shot.rx, iAdc, model);
+		int16_t* const pOut = ppOut[iAdc];
+
+		std::fill(acc.begin(), acc.end(), 0.0);
+		if (mode == SYNTH_TEST_NORMAL || mode >= SYNTH_N_TEST_MODES) {
+			synthesizeEchoes(acc.data(), shot, model, iAdc);
+			for (uint32_t i = 0u; i < nSamples; ++i) {
+				for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+					acc[(std::size_t) i * N_LANES + iLane] *= gain[i];
+				}
+			}
+		} else if (mode == SYNTH_TEST_SINE) {
+			for (uint32_t i = 0u; i < nSamples; ++i) {
+				std::fill_n(&acc[(std::size_t) i * N_LANES], N_LANES,
+						SINE_AMPLITUDE * FULL_SCALE
+								* std::sin(2.0 * PI * SINE_CYCLES * i));
+			}
+		} else if (mode == SYNTH_TEST_ANA_TONES) {
+			for (uint32_t i = 0u; i < nSamples; ++i) {
+				std::fill_n(&acc[(std::size_t) i * N_LANES], N_LANES,
+						TONE_AMPLITUDE * FULL_SCALE * gain[i]
+								* std::sin(2.0 * PI * TONE_CYCLES * i));
+			}
+		} else {
+			// A digital pattern, set below.
+		}
+
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			const uint32_t iChan = iAdc * N_LANES + iLane;
+			std::size_t iNoise = random() % N_NOISE;
+
+			for (uint32_t i = 0u; i < nSamples; ++i) {
+				const std::size_t k = (std::size_t) i * N_LANES + iLane;
+
+				if (mode == SYNTH_TEST_CHAN_ID) {
+					pOut[k] = (int16_t) (iChan << 2);
+				} else if (mode == SYNTH_TEST_USER_IO) {
+					pOut[k] = (int16_t) USER_PATTERNS[i % N_USER_PATTERNS];
+				} else if (!shot.rx.channels[iChan].enable
+						&& mode != SYNTH_TEST_SINE) {
+					pOut[k] = 0;
+				} else {
+					const double v = std::round(acc[k]
+							+ model.noiseRms * noise[iNoise]);
+					pOut[k] = (int16_t) (std::min(std::max(v, -FULL_SCALE - 1.0),
+							FULL_SCALE)) & SAMPLE_MASK;
+				}
+				iNoise = (iNoise + 1u) % N_NOISE;
+			}
+		}
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Adds the echoes of every target to one ADC's rows, before the gain and
+//  the noise.
+static void synthesizeEchoes(
+		double* pOut,
+		const OI_SHOT& shot,
+		const SynthModel& model,
+		uint32_t iAdc
+) {
+	const double
+		c = model.speedOfSound,
+		fs = model.sampleRateHz,
+		sigma = BURST_SIGMA_CYCLES / model.centreHz,
+		extent = BURST_EXTENT_SIGMAS * sigma,
+		step = 1.0 / (fs * BURST_OVERSAMPLE);
+	const uint32_t nSamples = shot.rx.nSamples;
+
+	// When each element fires:
+	std::vector<double> txX, txT;
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		const OI_TX_CHANNEL& tx = shot.tx.channels[iChan];
+		const uint32_t n = std::min<uint32_t>(tx.nLevelSequence,
+				OI_MAX_N_LEVEL_SEQUENCE);
+		uint32_t iFirst = 0u;
+		while (iFirst < n && tx.levelSequence[iFirst] == 0) {
+			++iFirst;
+		}
+		if (tx.enable && iFirst < n) {
+			txX.push_back(elementXm(iChan, model.pitchNm));
+			txT.push_back((double) iFirst / OI_TX_CLOCK_HZ);
+		} else {
+			// Silent.
+		}
+	}
+	if (txX.empty()) {
+		return;
+	} else {
+		// Something fires.
+	}
+
+	// The burst, from -extent to +extent:
+	std::vector<double> burst((std::size_t) (2.0 * extent / step) + 2u);
+	for (std::size_t j = 0u; j < burst.size(); ++j) {
+		const double t = j * step - extent;
+		burst[j] = std::exp(-0.5 * t * t / (sigma * sigma))
+				* std::sin(2.0 * PI * model.centreHz * t);
+	}
+
+	for (const SynthTarget& target : model.targets) {
+		const double
+			x = target.xUm * M_PER_UM,
+			z = target.zUm * M_PER_UM,
+			a = target.amplitude * FULL_SCALE / txX.size();
+
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			const double
+				rxX = elementXm(iAdc * N_LANES + iLane, model.pitchNm),
+				back = std::hypot(x - rxX, z) / c;
+
+			for (std::size_t iTx = 0u; iTx < txX.size(); ++iTx) {
+				const double
+					arrival = txT[iTx] + std::hypot(x - txX[iTx], z) / c + back;
+				const int64_t
+					i0 = std::max<int64_t>(0,
+							(int64_t) std::ceil((arrival - extent) * fs)),
+					i1 = std::min<int64_t>(nSamples,
+							(int64_t) std::floor((arrival + extent) * fs) + 1);
+
+				for (int64_t i = i0; i < i1; ++i) {
+					const std::size_t j = (std::size_t) std::lround(
+							(i / fs - arrival + extent) / step);
+					pOut[(std::size_t) i * N_LANES + iLane]
+							+= a * burst[std::min(j, burst.size() - 1u)];
+				}
+			}
+		}
+	}
+}
+
+static double elementXm(uint32_t iChan, uint32_t pitchNm)
+{
+	return ((double) iChan - (OI_N_CHAN - 1u) / 2.0) * pitchNm * M_PER_NM;
+}
+
+// Gain of the TGC at each sample; the last level holds.
+static std::vector<double> renderGain(const OI_RX& rx, uint32_t iAdc,
+		const SynthModel& model)
+{
+	const uint32_t nTgc = std::min<uint32_t>(rx.nTgc[iAdc], OI_RX_MAX_N_TGC);
+	std::vector<double> level(nTgc), gain(rx.nSamples);
+
+	for (uint32_t iPoint = 0u; iPoint < nTgc; ++iPoint) {
+		level[iPoint] = std::pow(10.0, ((double) rx.tgc[iAdc][iPoint]
+				- model.tgcRefCode) * model.tgcDbPerCode / 20.0);
+	}
+	for (uint32_t i = 0u; i < rx.nSamples; ++i) {
+		const uint32_t iPoint = (uint32_t) (i / model.sampleRateHz
+				/ SEC_PER_TGC_POINT);
+		gain[i] = nTgc > 0u ? level[std::min(iPoint, nTgc - 1u)] : 1.0;
+	}
+
+	return gain;
+}
+
+static const std::vector<double>& getNoise()
+{
+	static const std::vector<double> noise = [] {
+		std::mt19937 random(NOISE_SEED);
+		std::normal_distribution<double> normal;
+		std::vector<double> n(N_NOISE);
+		for (double& v : n) {
+			v = normal(random);
+		}
+		return n;
+	}();
+
+	return noise;
+}
+
+} // namespace oi
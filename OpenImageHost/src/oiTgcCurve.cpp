@@ -0,0 +1,357 @@
+/*
+	oiTgcCurve.cpp
+
+	Host-side construction of parametric Time Gain Compensation curves.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiTgcCurve.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace oi {
+
+//********************************  Constants  *******************************//
+// Largest 8.8 fixed point level that still rounds to a valid code.
+static const double MAX_LEVEL = 255.0 * 256.0;
+
+// Longest segment that the 16-bit duration can hold.
+static const uint32_t MAX_DURATION = UINT16_MAX;
+
+// Number of 8.8 fixed point levels that round to each code.
+static const uint32_t N_WINDOW = 256u;
+
+// Durations, short of the longest, tried for each segment of a fit.
+static const uint32_t N_LOOKAHEAD = 4u;
+
+//***********************  Local Function Declarations  **********************//
+static uint16_t toLevel(double db, const TgcCalibration& cal);
+static int64_t windowBase(uint8_t code);
+static uint32_t longestSegment(
+		const int32_t* pFrom,
+		int64_t fromBase,
+		const uint8_t* pCodes,
+		uint32_t iPoint
+);
+static bool isReachable(
+		const int32_t* pFrom,
+		int64_t fromBase,
+		const uint8_t* pCodes,
+		uint32_t duration,
+		int32_t* pTo,
+		int64_t toBase
+);
+static bool fitRise(
+		const uint8_t* pCodes,
+		uint32_t duration,
+		int64_t startLevel,
+		int sign,
+		int64_t& lo,
+		int64_t& hi
+);
+static int64_t floorDiv(int64_t a, int64_t b);
+
+//****************************  Global Functions  ****************************//
+
+bool makeTgcCurve(
+		OI_TGC_CURVE& out,
+		double startDb,
+		const std::vector<TgcRamp>& ramps,
+		const TgcCalibration& cal
+) {
+	bool ok = ramps.size() <= OI_TGC_MAX_N_SEGMENTS && cal.dbPerCode != 0.0;
+
+	std::memset(&out, 0, sizeof(out));
+
+	if (ok) {
+		out.startLevel = toLevel(startDb, cal);
+		out.nSegments = (uint16_t) ramps.size();
+
+		double db = startDb;
+		for (std::size_t iSeg = 0u; iSeg < ramps.size(); ++iSeg) {
+			const double points
+				= ramps[iSeg].durationUs * 1000.0 / OI_TGC_POINT_NS;
+
+			db += ramps[iSeg].slopeDbPerUs * ramps[iSeg].durationUs;
+			out.segments[iSeg].duration = (uint16_t) std::lround(
+					std::clamp(points, 0.0, (double) MAX_DURATION)
+			);
+			out.segments[iSeg].endLevel = toLevel(db, cal);
+
+			// The firmware rejects empty segments.
+			ok = out.segments[iSeg].duration != 0u && ok;
+		}
+	} else {
+		// Fail.
+	}
+
+	return ok;
+}
+
+// Greedy:  each segment is extended for as long as some start level that
+//  the segments before it can reach, and some rise, make the firmware's
+//  rendering reproduce the codes exactly.  Every level that a segment can
+//  end on is kept, with the start it came from, so that the next segment
+//  is free to begin on any of them; the choice is made once the curve is
+//  complete, by tracing back from the level that the last segment began on.
+bool fitTgcCurve(OI_TGC_CURVE& out, const uint8_t* pCodes)
+{
+	// The levels that each segment may start on, which round to its first
+	//  code, and the start of the segment before that reaches each; the
+	//  start of the first segment is any that rounds to the first code.
+	int32_t from[OI_TGC_MAX_N_SEGMENTS + 1u][N_WINDOW];
+	int64_t base[OI_TGC_MAX_N_SEGMENTS + 1u];
+	uint32_t iPoint = 0u;
+	uint32_t nSegments = 0u;
+	bool ok = true;
+	bool isDone = false;
+
+	std::memset(&out, 0, sizeof(out));
+	base[0] = windowBase(pCodes[0]);
+	for (uint32_t i = 0u; i < N_WINDOW; ++i) {
+		from[0][i] = base[0] + i >= 0 ? 0 : -1;
+	}
+
+	while (ok && !isDone) {
+		if (std::all_of(
+				&pCodes[iPoint],
+				&pCodes[OI_RX_MAX_N_TGC],
+				[pCodes, iPoint](uint8_t c) { return c == pCodes[iPoint]; })) {
+			// Holding any of the start levels finishes the curve.
+			isDone = true;
+		} else if (nSegments == OI_TGC_MAX_N_SEGMENTS) {
+			ok = false;
+		} else {
+			// The longest segment may end on levels that start the next one
+			//  badly, so those a little shorter are tried too, for the one
+			//  that covers the most with the segment after it.
+			const uint32_t longest = longestSegment(from[nSegments],
+					base[nSegments], &pCodes[iPoint], iPoint);
+			uint32_t
+				best = 0u,
+				bestCover = 0u;
+
+			for (uint32_t d = longest; d > 0u && d + N_LOOKAHEAD > longest;
+					--d) {
+				int32_t next[N_WINDOW];
+				const int64_t nextBase = windowBase(pCodes[iPoint + d]);
+				if (isReachable(from[nSegments], base[nSegments],
+						&pCodes[iPoint], d, next, nextBase)) {
+					const uint32_t cover = d + longestSegment(next, nextBase,
+							&pCodes[iPoint + d], iPoint + d);
+					if (cover > bestCover) {
+						best = d;
+						bestCover = cover;
+					} else {
+						// Longer and no worse is preferred.
+					}
+				} else {
+					// Does not fit.
+				}
+			}
+
+			if (best == 0u) {
+				// Cannot happen for valid codes, as a segment of one point
+				//  may start on any level that rounds to it.
+				ok = false;
+			} else {
+				out.segments[nSegments].duration = (uint16_t) best;
+				base[nSegments + 1u] = windowBase(pCodes[iPoint + best]);
+				isReachable(from[nSegments], base[nSegments],
+						&pCodes[iPoint], best, from[nSegments + 1u],
+						base[nSegments + 1u]);
+				iPoint += best;
+				++nSegments;
+			}
+		}
+	}
+
+	if (ok) {
+		// Trace back from any level the last segment (or the hold) reaches.
+		out.nSegments = (uint16_t) nSegments;
+		int64_t level = -1;
+		for (uint32_t i = 0u; i < N_WINDOW && level < 0; ++i) {
+			level = from[nSegments][i] >= 0 ? base[nSegments] + i : -1;
+		}
+		for (uint32_t iSeg = nSegments; iSeg > 0u && level >= 0; --iSeg) {
+			out.segments[iSeg - 1u].endLevel = (uint16_t) level;
+			level = from[iSeg][level - base[iSeg]];
+		}
+		out.startLevel = (uint16_t) level;
+
+		// Check against the firmware's own rendering, to be certain:
+		uint8_t rendered[OI_RX_MAX_N_TGC];
+		oiTgcRender(rendered, &out);
+		ok = level >= 0
+				&& std::memcmp(rendered, pCodes, sizeof(rendered)) == 0;
+	} else {
+		// Fail.
+	}
+
+	return ok;
+}
+
+bool compactRx(OI_RX_COMPACT& out, const OI_RX& in)
+{
+	bool ok = true;
+
+	std::memcpy(out.channels, in.channels, sizeof(out.channels));
+	out.nSamples = in.nSamples;
+	out.sampleFormat = in.sampleFormat;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		ok = fitTgcCurve(out.tgc[iAdc], in.tgc[iAdc]) && ok;
+
+		out.lpfMul[iAdc] = in.lpfMul[iAdc];
+		out.lpfDiv[iAdc] = in.lpfDiv[iAdc];
+		out.lna[iAdc] = in.lna[iAdc];
+		out.pga[iAdc] = in.pga[iAdc];
+		out.hpf_divisor[iAdc] = in.hpf_divisor[iAdc];
+		out.testMode[iAdc] = in.testMode[iAdc];
+	}
+
+	return ok;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static uint16_t toLevel(double db, const TgcCalibration& cal)
+{
+	const double level = (db - cal.offsetDb) / cal.dbPerCode * 256.0;
+
+	return (uint16_t) std::lround(std::clamp(level, 0.0, MAX_LEVEL));
+}
+
+// The lowest level that rounds to the code, less than zero for code 0.
+static int64_t windowBase(uint8_t code)
+{
+	return (int64_t) code * 256 - 128;
+}
+
+// The most points, of those from iPoint on (with pCodes at iPoint), that
+//  one segment starting on any of the levels marked in pFrom covers:  all
+//  of them, if it need only hold the level.  Each segment ends before the
+//  last point, which the hold then renders.
+static uint32_t longestSegment(
+		const int32_t* pFrom,
+		int64_t fromBase,
+		const uint8_t* pCodes,
+		uint32_t iPoint
+) {
+	const uint32_t nPoints = OI_RX_MAX_N_TGC - iPoint;
+	uint32_t longest = 0u;
+
+	if (std::all_of(pCodes, pCodes + nPoints,
+			[pCodes](uint8_t c) { return c == pCodes[0]; })) {
+		longest = nPoints;
+	} else {
+		for (uint32_t d = 1u; d < nPoints
+				&& isReachable(pFrom, fromBase, pCodes, d, NULL, 0); ++d) {
+			longest = d;
+		}
+	}
+
+	return longest;
+}
+
+// Whether a segment of the given duration, starting on any of the levels
+//  marked in pFrom (those of its first code, from fromBase), reproduces
+//  pCodes[0 .. duration-1] and ends on a level that rounds to
+//  pCodes[duration].  If pTo is given, each such end level (those of that
+//  code, from toBase) is marked there with a start that reaches it.
+static bool isReachable(
+		const int32_t* pFrom,
+		int64_t fromBase,
+		const uint8_t* pCodes,
+		uint32_t duration,
+		int32_t* pTo,
+		int64_t toBase
+) {
+	bool isAny = false;
+
+	if (pTo != NULL) {
+		std::fill(pTo, pTo + N_WINDOW, -1);
+	} else {
+		// Only whether there is one.
+	}
+
+	for (uint32_t i = 0u; i < N_WINDOW && (pTo != NULL || !isAny); ++i) {
+		const int64_t start = fromBase + i;
+		for (int sign : { +1, -1 }) {
+			int64_t lo, hi;
+			if (pFrom[i] < 0
+					|| !fitRise(pCodes, duration, start, sign, lo, hi)) {
+				// Not reached, or no rise works.
+			} else {
+				isAny = true;
+				for (int64_t r = lo; r <= hi && pTo != NULL; ++r) {
+					const int64_t iTo = start + sign * r - toBase;
+					if (iTo >= 0 && iTo < (int64_t) N_WINDOW
+							&& pTo[iTo] < 0) {
+						pTo[iTo] = (int32_t) start;
+					} else {
+						// Marked already.
+					}
+				}
+			}
+		}
+	}
+
+	return isAny;
+}
+
+// The firmware renders point k as start + rise*k/duration, truncated
+//  toward zero.  For a rise of the given sign, this intersects the range
+//  of rises that round each point to its code, and the end level (where
+//  the next segment, or the hold, begins) to pCodes[duration].
+static bool fitRise(
+		const uint8_t* pCodes,
+		uint32_t duration,
+		int64_t startLevel,
+		int sign,
+		int64_t& lo,
+		int64_t& hi
+) {
+	const int64_t d = duration;
+
+	// Bounds on |rise|:
+	lo = 0;
+	hi = sign > 0 ? (int64_t) MAX_LEVEL + 0xFF - startLevel : startLevel;
+
+	for (uint32_t k = 1u; k <= duration && lo <= hi; ++k) {
+		// Levels that round to the code:
+		const int64_t
+			levelLo = std::max<int64_t>((int64_t) pCodes[k] * 256 - 128, 0),
+			levelHi = (int64_t) pCodes[k] * 256 + 127;
+		// Bounds on floor(|rise|*k/d):
+		const int64_t
+			a = sign > 0 ? levelLo - startLevel : startLevel - levelHi,
+			b = sign > 0 ? levelHi - startLevel : startLevel - levelLo;
+
+		if (b < 0) {
+			hi = -1;
+		} else if (k == duration) {
+			// The end level itself, with no truncation.
+			lo = std::max(lo, a);
+			hi = std::min(hi, b);
+		} else {
+			// floor(r*k/d) >= a  <=>  r >= ceil(a*d/k)
+			lo = std::max(lo, -floorDiv(-a * d, k));
+			// floor(r*k/d) <= b  <=>  r*k < (b+1)*d
+			hi = std::min(hi, floorDiv((b + 1) * d - 1, k));
+		}
+	}
+
+	// The start level itself must also round to the first code:
+	return lo <= hi && (startLevel + 0x80) >> 8 == pCodes[0];
+}
+
+static int64_t floorDiv(int64_t a, int64_t b)
+{
+	return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+} // namespace oi
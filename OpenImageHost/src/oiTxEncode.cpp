@@ -0,0 +1,196 @@
+/*
+	oiTxEncode.cpp
+
+	Host-side encoding of transmit waveforms into the run-length encoded
+	format.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiTxEncode.h"
+
+#include "oiTgcCurve.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace oi {
+
+//****************************  Global Functions  ****************************//
+
+bool encodeFrameRle(const OI_FRAME& in, OI_FRAME_RLE& out)
+{
+	TxRleEncoder encoder;
+	bool ok = in.nShots <= OI_MAX_N_SHOTS;
+
+	std::memset(&out, 0, OI_FRAME_RLE_BYTES(0));
+	out.handle = in.handle;
+	out.nShots = in.nShots;
+
+	for (uint32_t iShot = 0u; ok && iShot < in.nShots; ++iShot) {
+		ok = encoder.encode(in.shots[iShot].tx, out.shots[iShot].tx)
+				&& compactRx(out.shots[iShot].rx, in.shots[iShot].rx);
+	}
+
+	if (ok) {
+		out.nTemplates = encoder.getNTemplates();
+		std::copy_n(encoder.getTemplates(), out.nTemplates, out.templates);
+	} else {
+		// Fail.
+	}
+
+	return ok;
+}
+
+void decodeFrameRle(const OI_FRAME_RLE& in, OI_FRAME& out)
+{
+	out.handle = in.handle;
+	out.nShots = std::min<uint32_t>(in.nShots, OI_MAX_N_SHOTS);
+
+	for (uint32_t iShot = 0u; iShot < out.nShots; ++iShot) {
+		oiTxRleExpand(&out.shots[iShot].tx, &in.shots[iShot].tx, in.templates);
+		oiRxExpand(&out.shots[iShot].rx, &in.shots[iShot].rx);
+	}
+}
+
+oi_error_t planFrameFocused(const OI_FRAME_FOCUSED& in, OI_FRAME_RLE& out)
+{
+	oi_error_t result = OI_ERR_NONE;
+
+	if (in.nShots == 0u || in.nShots > OI_MAX_N_SHOTS) {
+		result = OI_ERR_INVALID_PARAMETER;
+	} else {
+		out.handle = in.handle;
+		out.nShots = in.nShots;
+		out.nTemplates = in.nTemplates;
+		std::copy_n(in.templates, OI_TX_MAX_N_TEMPLATES, out.templates);
+	}
+
+	for (uint32_t iShot = 0u; !result && iShot < in.nShots; ++iShot) {
+		result = oiTxPlanFocus(
+				&out.shots[iShot].tx,
+				&in.shots[iShot].tx,
+				in.pitchNm,
+				in.speedOfSound
+		);
+		if (result == OI_ERR_NONE) {
+			result = oiTxRleValidate(
+					&out.shots[iShot].tx, 
+					out.templates, 
+					out.nTemplates
+			);
+		} else {
+			// Fail.
+		}
+		if (result == OI_ERR_NONE) {
+			result = oiRxValidate(&in.shots[iShot].rx);
+		} else {
+			// Fail.
+		}
+		if (result == OI_ERR_NONE) {
+			out.shots[iShot].rx = in.shots[iShot].rx;
+		} else {
+			// Fail.
+		}
+	}
+
+	return result;
+}
+
+//*****************************  TxRleEncoder  *******************************//
+
+bool TxRleEncoder::encode(const OI_TX& tx, OI_TX_RLE& out)
+{
+	bool ok = true;
+
+	for (uint32_t iChan = 0u; ok && iChan < OI_N_CHAN; ++iChan) {
+		ok = encodeChannel(tx.channels[iChan], out.channels[iChan]);
+	}
+
+	return ok;
+}
+
+bool TxRleEncoder::encodeChannel(
+		const OI_TX_CHANNEL& in,
+		OI_TX_RLE_CHANNEL& out
+) {
+	bool ok = true;
+
+	out = OI_TX_RLE_CHANNEL();
+
+	if (in.enable) {
+		const uint32_t n = std::min(in.nLevelSequence, OI_MAX_N_LEVEL_SEQUENCE);
+		const int8_t* const seq = in.levelSequence;
+
+		// Leading RTZ becomes the delay, so that steered or focused
+		//  copies of one pulse share a template.
+		uint32_t i = 0u;
+		while (i < n && seq[i] == 0) {
+			++i;
+		}
+
+		OI_TX_TEMPLATE shape;
+		std::memset(&shape, 0, sizeof(shape));
+
+		while (ok && i < n) {
+			uint32_t count = 1u;
+			while (i + count < n && seq[i + count] == seq[i] && count < 255u) {
+				++count;
+			}
+
+			if (shape.nRuns < OI_TX_MAX_N_RUNS) {
+				shape.runs[shape.nRuns].level = seq[i];
+				shape.runs[shape.nRuns].count = (uint8_t) count;
+				++shape.nRuns;
+				i += count;
+			} else {
+				// Too many runs.
+				ok = false;
+			}
+		}
+
+		const int iTemplate = ok ? findOrAddTemplate(shape) : -1;
+
+		if (iTemplate < 0) {
+			ok = false;
+		} else {
+			out.enable = 1u;
+			out.iTemplate = (uint8_t) iTemplate;
+			// The template holds everything after the leading RTZ.
+			uint32_t length = 0u;
+			for (uint32_t iRun = 0u; iRun < shape.nRuns; ++iRun) {
+				length += shape.runs[iRun].count;
+			}
+			out.delay = (uint16_t) (n - length);
+		}
+	} else {
+		// Disabled channels are left zeroed.
+	}
+
+	return ok;
+}
+
+int TxRleEncoder::findOrAddTemplate(const OI_TX_TEMPLATE& shape)
+{
+	int result = -1;
+
+	for (std::size_t iT = 0u; iT < templates.size(); ++iT) {
+		if (std::memcmp(&templates[iT], &shape, sizeof(shape)) == 0) {
+			result = (int) iT;
+			break;
+		}
+	}
+
+	if (result >= 0) {
+		// Shared.
+	} else if (templates.size() < OI_TX_MAX_N_TEMPLATES) {
+		result = (int) templates.size();
+		templates.push_back(shape);
+	} else {
+		// No room.
+	}
+
+	return result;
+}
+
+} // namespace oi
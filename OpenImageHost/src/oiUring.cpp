@@ -0,0 +1,206 @@
+/*
+	oiUring.cpp
+
+	A minimal io_uring, over io_uring_setup and io_uring_enter.  The kernel
+	reads the submission ring's tail and writes the completion ring's, so
+	those are read and written with acquire and release; elsewhere, where
+	io_uring is not, the ring never opens.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiUring.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+#	include <linux/io_uring.h>
+#	include <sys/mman.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#	define OI_URING_LINUX 1
+#else
+#	define OI_URING_LINUX 0
+#endif
+
+namespace oi {
+
+//****************************  Global Functions  ****************************//
+
+#if OI_URING_LINUX
+
+Uring::Uring(unsigned nEntries)
+{
+	io_uring_params params;
+	std::memset(&params, 0, sizeof(params));
+	fd = (int) ::syscall(__NR_io_uring_setup, nEntries, &params);
+	if (fd < 0) {
+		return;
+	} else {
+		// Map the rings.
+	}
+
+	sqRingBytes = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	cqRingBytes = params.cq_off.cqes
+			+ params.cq_entries * sizeof(io_uring_cqe);
+	sqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+
+	pSqRing = ::mmap(nullptr, sqRingBytes, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+	pCqRing = ::mmap(nullptr, cqRingBytes, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+	pSqes = ::mmap(nullptr, sqesBytes, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+	if (pSqRing == MAP_FAILED || pCqRing == MAP_FAILED || pSqes == MAP_FAILED) {
+		pSqRing = pSqRing == MAP_FAILED ? nullptr : pSqRing;
+		pCqRing = pCqRing == MAP_FAILED ? nullptr : pCqRing;
+		pSqes = pSqes == MAP_FAILED ? nullptr : pSqes;
+		release();
+		return;
+	} else {
+		// Mapped.
+	}
+
+	uint8_t* const pSq = (uint8_t*) pSqRing;
+	uint8_t* const pCq = (uint8_t*) pCqRing;
+	pSqHead = (unsigned*) (pSq + params.sq_off.head);
+	pSqTail = (unsigned*) (pSq + params.sq_off.tail);
+	pSqArray = (unsigned*) (pSq + params.sq_off.array);
+	sqMask = *(unsigned*) (pSq + params.sq_off.ring_mask);
+	nSqEntries = params.sq_entries;
+	pCqHead = (unsigned*) (pCq + params.cq_off.head);
+	pCqTail = (unsigned*) (pCq + params.cq_off.tail);
+	cqMask = *(unsigned*) (pCq + params.cq_off.ring_mask);
+	pCqes = pCq + params.cq_off.cqes;
+}
+
+Uring::~Uring() { release(); }
+
+void Uring::release()
+{
+	if (pSqes != nullptr) {
+		::munmap(pSqes, sqesBytes);
+	} else {
+		// Not mapped.
+	}
+	if (pCqRing != nullptr) {
+		::munmap(pCqRing, cqRingBytes);
+	} else {
+		// Not mapped.
+	}
+	if (pSqRing != nullptr) {
+		::munmap(pSqRing, sqRingBytes);
+	} else {
+		// Not mapped.
+	}
+	if (fd >= 0) {
+		::close(fd);
+	} else {
+		// Not open.
+	}
+
+	pSqes = pCqRing = pSqRing = nullptr;
+	fd = -1;
+}
+
+bool Uring::write(int file, const void* pData, uint32_t nBytes,
+		uint64_t offset, uint64_t tag)
+{
+	return queue(IORING_OP_WRITE, file, (uint64_t) (uintptr_t) pData, nBytes,
+			offset, tag);
+}
+
+bool Uring::read(int file, void* pData, uint32_t nBytes, uint64_t offset,
+		uint64_t tag)
+{
+	return queue(IORING_OP_READ, file, (uint64_t) (uintptr_t) pData, nBytes,
+			offset, tag);
+}
+
+bool Uring::submit(unsigned minComplete)
+{
+	if (fd < 0) {
+		return false;
+	} else {
+		// Open.
+	}
+
+	bool ok = true;
+	do {
+		const long n = ::syscall(__NR_io_uring_enter, fd, nQueued, minComplete,
+				minComplete > 0u ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+		if (n >= 0) {
+			nQueued -= (unsigned) n;
+			minComplete = 0u;
+		} else {
+			ok = errno == EINTR;
+		}
+	} while (ok && (nQueued > 0u || minComplete > 0u));
+
+	return ok;
+}
+
+bool Uring::complete(UringCompletion& completion)
+{
+	const unsigned head = fd >= 0 ? *pCqHead : 0u;
+	if (fd < 0 || head == __atomic_load_n(pCqTail, __ATOMIC_ACQUIRE)) {
+		return false;
+	} else {
+		// One waiting.
+	}
+
+	const io_uring_cqe& cqe = ((const io_uring_cqe*) pCqes)[head & cqMask];
+	completion.tag = cqe.user_data;
+	completion.result = cqe.res;
+	__atomic_store_n(pCqHead, head + 1u, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+bool Uring::queue(uint8_t opcode, int file, uint64_t address,
+		uint32_t nBytes, uint64_t offset, uint64_t tag)
+{
+	const unsigned tail = fd >= 0 ? *pSqTail : 0u;
+	if (fd < 0
+			|| tail - __atomic_load_n(pSqHead, __ATOMIC_ACQUIRE) >= nSqEntries) {
+		return false;
+	} else {
+		// Room.
+	}
+
+	io_uring_sqe& sqe = ((io_uring_sqe*) pSqes)[tail & sqMask];
+	std::memset(&sqe, 0, sizeof(sqe));
+	sqe.opcode = opcode;
+	sqe.fd = file;
+	sqe.addr = address;
+	sqe.len = nBytes;
+	sqe.off = offset;
+	sqe.user_data = tag;
+	pSqArray[tail & sqMask] = tail & sqMask;
+	__atomic_store_n(pSqTail, tail + 1u, __ATOMIC_RELEASE);
+	++nQueued;
+
+	return true;
+}
+
+#else
+
+Uring::Uring(unsigned) {}
+Uring::~Uring() {}
+void Uring::release() {}
+bool Uring::write(int, const void*, uint32_t, uint64_t, uint64_t)
+{
+	return false;
+}
+bool Uring::read(int, void*, uint32_t, uint64_t, uint64_t) { return false; }
+bool Uring::submit(unsigned) { return false; }
+bool Uring::complete(UringCompletion&) { return false; }
+bool Uring::queue(uint8_t, int, uint64_t, uint32_t, uint64_t, uint64_t)
+{
+	return false;
+}
+
+#endif
+
+} // namespace oi
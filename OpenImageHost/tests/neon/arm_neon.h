@@ -0,0 +1,328 @@
+/*
+	arm_neon.h
+
+	Scalar model of the AArch64 NEON intrinsics that the firmware's
+	kernels use, for the tests only:  those kernels are built for the host
+	with __ARM_NEON defined and this directory first on the include path,
+	so that their NEON paths are run, and checked against their scalar
+	ones, without an Arm target.  Each intrinsic does, lane by lane, what
+	the Arm ACLE specifies; only those in use are modelled.
+
+	2026-10-19  agent  Created.
+*/
+
+#ifndef __OI_ARM_NEON_H__
+#define __OI_ARM_NEON_H__
+
+#include <stdint.h>
+
+//**********************************  Types  *********************************//
+typedef struct { int16_t val[4]; } int16x4_t;
+typedef struct { int16_t val[8]; } int16x8_t;
+typedef struct { uint16_t val[4]; } uint16x4_t;
+typedef struct { uint16_t val[8]; } uint16x8_t;
+typedef struct { int32_t val[4]; } int32x4_t;
+typedef struct { uint32_t val[4]; } uint32x4_t;
+typedef struct { int16x8_t val[2]; } int16x8x2_t;
+
+//********************************  Functions  *******************************//
+
+/////  Load, store and set  /////
+static inline int16x8_t vld1q_s16(const int16_t* p)
+{
+	int16x8_t r;
+	for (int i = 0; i < 8; ++i) { r.val[i] = p[i]; }
+	return r;
+}
+
+static inline int32x4_t vld1q_s32(const int32_t* p)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = p[i]; }
+	return r;
+}
+
+// Interleaves the two vectors, as pairs.
+static inline void vst2q_s16(int16_t* p, int16x8x2_t a)
+{
+	for (int i = 0; i < 8; ++i) {
+		p[2 * i] = a.val[0].val[i];
+		p[2 * i + 1] = a.val[1].val[i];
+	}
+}
+
+static inline void vst1q_s32(int32_t* p, int32x4_t a)
+{
+	for (int i = 0; i < 4; ++i) { p[i] = a.val[i]; }
+}
+
+static inline void vst1q_u32(uint32_t* p, uint32x4_t a)
+{
+	for (int i = 0; i < 4; ++i) { p[i] = a.val[i]; }
+}
+
+static inline uint16x8_t vdupq_n_u16(uint16_t v)
+{
+	uint16x8_t r;
+	for (int i = 0; i < 8; ++i) { r.val[i] = v; }
+	return r;
+}
+
+static inline int32x4_t vdupq_n_s32(int32_t v)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = v; }
+	return r;
+}
+
+static inline uint32x4_t vdupq_n_u32(uint32_t v)
+{
+	uint32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = v; }
+	return r;
+}
+
+/////  Halves and lanes  /////
+static inline int16x4_t vget_low_s16(int16x8_t a)
+{
+	int16x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i]; }
+	return r;
+}
+
+static inline uint16x4_t vget_low_u16(uint16x8_t a)
+{
+	uint16x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i]; }
+	return r;
+}
+
+static inline uint16x4_t vget_high_u16(uint16x8_t a)
+{
+	uint16x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[4 + i]; }
+	return r;
+}
+
+static inline int16x8_t vcombine_s16(int16x4_t lo, int16x4_t hi)
+{
+	int16x8_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = lo.val[i];
+		r.val[4 + i] = hi.val[i];
+	}
+	return r;
+}
+
+#define vget_lane_u16(a, n)                                   ((a).val[(n)])
+
+static inline uint16x8_t vreinterpretq_u16_s16(int16x8_t a)
+{
+	uint16x8_t r;
+	for (int i = 0; i < 8; ++i) { r.val[i] = (uint16_t) a.val[i]; }
+	return r;
+}
+
+static inline uint32x4_t vreinterpretq_u32_s32(int32x4_t a)
+{
+	uint32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = (uint32_t) a.val[i]; }
+	return r;
+}
+
+/////  Widening  /////
+static inline int32x4_t vmovl_s16(int16x4_t a)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i]; }
+	return r;
+}
+
+static inline int32x4_t vmovl_high_s16(int16x8_t a)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[4 + i]; }
+	return r;
+}
+
+static inline int32x4_t vshll_n_s16(int16x4_t a, int n)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) (int32_t) a.val[i] << n);
+	}
+	return r;
+}
+
+static inline int32x4_t vshll_high_n_s16(int16x8_t a, int n)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) (int32_t) a.val[4 + i] << n);
+	}
+	return r;
+}
+
+static inline int32x4_t vsubl_s16(int16x4_t a, int16x4_t b)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) a.val[i] - b.val[i];
+	}
+	return r;
+}
+
+static inline int32x4_t vsubl_high_s16(int16x8_t a, int16x8_t b)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) a.val[4 + i] - b.val[4 + i];
+	}
+	return r;
+}
+
+/////  Narrowing  /////
+// Shifts right by n, rounding, and saturates to 16 bits.
+static inline int16x4_t vqrshrn_n_s32(int32x4_t a, int n)
+{
+	int16x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		const int64_t v = ((int64_t) a.val[i] + (1 << (n - 1))) >> n;
+		r.val[i] = v > INT16_MAX ? INT16_MAX
+				: v < INT16_MIN ? INT16_MIN
+				: (int16_t) v;
+	}
+	return r;
+}
+
+/////  Arithmetic and logic  /////
+static inline uint16x8_t vorrq_u16(uint16x8_t a, uint16x8_t b)
+{
+	uint16x8_t r;
+	for (int i = 0; i < 8; ++i) { r.val[i] = a.val[i] | b.val[i]; }
+	return r;
+}
+
+static inline uint16x4_t vorr_u16(uint16x4_t a, uint16x4_t b)
+{
+	uint16x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i] | b.val[i]; }
+	return r;
+}
+
+static inline int32x4_t veorq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i] ^ b.val[i]; }
+	return r;
+}
+
+// Wraps, as the instructions do.
+static inline int32x4_t vsubq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) a.val[i] - (uint32_t) b.val[i]);
+	}
+	return r;
+}
+
+static inline uint32x4_t vaddq_u32(uint32x4_t a, uint32x4_t b)
+{
+	uint32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i] + b.val[i]; }
+	return r;
+}
+
+static inline int32x4_t vmulq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) a.val[i] * (uint32_t) b.val[i]);
+	}
+	return r;
+}
+
+static inline int32x4_t vmlaq_s32(int32x4_t a, int32x4_t b, int32x4_t c)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) a.val[i]
+				+ (uint32_t) b.val[i] * (uint32_t) c.val[i]);
+	}
+	return r;
+}
+
+// Sum of the lanes, widened.
+static inline int64_t vaddlvq_s32(int32x4_t a)
+{
+	int64_t sum = 0;
+	for (int i = 0; i < 4; ++i) { sum += a.val[i]; }
+	return sum;
+}
+
+// Multiply-accumulate, widening, by a scalar; wraps, as the instructions
+//  do.
+static inline int32x4_t vmlal_n_s16(int32x4_t a, int16x4_t b, int16_t c)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) a.val[i]
+				+ (uint32_t) ((int32_t) b.val[i] * c));
+	}
+	return r;
+}
+
+static inline int32x4_t vmlal_high_n_s16(int32x4_t a, int16x8_t b, int16_t c)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) a.val[i]
+				+ (uint32_t) ((int32_t) b.val[4 + i] * c));
+	}
+	return r;
+}
+
+/////  Shifts  /////
+// By the signed low byte of each lane of b:  left if positive, else right,
+//  arithmetically.
+static inline int32x4_t vshlq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		const int8_t n = (int8_t) b.val[i];
+		r.val[i] = n >= 32 ? 0
+				: n >= 0 ? (int32_t) ((uint32_t) a.val[i] << n)
+				: n > -32 ? a.val[i] >> -n
+				: a.val[i] >> 31;
+	}
+	return r;
+}
+
+static inline int32x4_t vshlq_n_s32(int32x4_t a, int n)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) ((uint32_t) a.val[i] << n);
+	}
+	return r;
+}
+
+static inline int32x4_t vshrq_n_s32(int32x4_t a, int n)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) { r.val[i] = a.val[i] >> n; }
+	return r;
+}
+
+// Shifts right by n, rounding; the sum does not overflow.
+static inline int32x4_t vrshrq_n_s32(int32x4_t a, int n)
+{
+	int32x4_t r;
+	for (int i = 0; i < 4; ++i) {
+		r.val[i] = (int32_t) (((int64_t) a.val[i] + (1 << (n - 1))) >> n);
+	}
+	return r;
+}
+
+#endif /* __OI_ARM_NEON_H__ */
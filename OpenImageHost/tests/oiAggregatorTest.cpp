@@ -0,0 +1,175 @@
+/*
+	oiAggregatorTest.cpp
+
+	Checks the aggregation of units into one array (oiAggregator.h), with
+	two emulators:  that each unit's channels land in their rows of the
+	merged frame, each shot leaving a different element silent; that
+	units which timestamp their shots are aligned; and that units which do
+	not, as bitstreams without the shot-header block, have their frames
+	refused, unless isUntimedAllowed.
+
+	Usage:  oiAggregatorTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiAggregator.h"
+#include "oiEmulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t
+	N_UNITS = 2u,
+	N_SHOTS = 6u,
+	N_SAMPLES = 512u;
+
+//***********************  Local Function Declarations  **********************//
+static oi::ArrayResult acquire(bool isFpgaHeader, bool isUntimedAllowed,
+		bool& isPlaced);
+static oi::ArrayProgram makeFrame();
+static bool isSilentPlaced(const std::vector<int16_t>& frame,
+		uint32_t nElements);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	bool ok = true;
+
+	// Timestamped:  aligned.
+	{
+		bool placed;
+		const oi::ArrayResult result = acquire(true, false, placed);
+		ok = expect("timed units aligned",
+				result.ok && result.isTimed && result.nMisaligned == 0u
+				&& placed)
+				&& ok;
+	}
+
+	// Not timestamped:  refused, or accepted unaligned if allowed.
+	{
+		bool placed;
+		const oi::ArrayResult result = acquire(false, false, placed);
+		ok = expect("untimed units refused",
+				!result.ok && !result.isTimed && result.nBadShots == 0u)
+				&& ok;
+	}
+	{
+		bool placed;
+		const oi::ArrayResult result = acquire(false, true, placed);
+		ok = expect("untimed units allowed",
+				result.ok && !result.isTimed && placed)
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Acquires one frame from N_UNITS emulators.
+static oi::ArrayResult acquire(bool isFpgaHeader, bool isUntimedAllowed,
+		bool& isPlaced)
+{
+	std::vector<std::unique_ptr<oi::Emulator>> emulators;
+	std::vector<std::string> hosts;
+	bool ok = true;
+
+	for (uint32_t iUnit = 0u; iUnit < N_UNITS && ok; ++iUnit) {
+		oi::EmulatorOptions options;
+		options.port = 0u;
+		options.seed = iUnit + 1u;
+		options.isFpgaHeader = isFpgaHeader;
+		emulators.emplace_back(new oi::Emulator(options));
+		ok = emulators.back()->start();
+		hosts.push_back("127.0.0.1:"
+				+ std::to_string(emulators.back()->getPort()));
+	}
+
+	oi::AggregatorOptions options;
+	options.isUntimedAllowed = isUntimedAllowed;
+	oi::Aggregator aggregator(options);
+	oi::ArrayProgram program = makeFrame();
+	std::vector<int16_t> frame((std::size_t) N_SHOTS
+			* program.getNElements() * N_SAMPLES);
+	oi::ArrayResult result;
+
+	if (ok && aggregator.connect(hosts) && program.build() == OI_ERR_NONE) {
+		result = aggregator.acquire(program, frame.data(), N_SAMPLES);
+	} else {
+		std::fprintf(stderr, "cannot start the units\n");
+	}
+	isPlaced = isSilentPlaced(frame, program.getNElements());
+
+	return result;
+}
+
+// Every element transmits; each shot leaves a different one silent.
+static oi::ArrayProgram makeFrame()
+{
+	oi::ArrayProgram program(N_UNITS);
+	const uint32_t nElements = program.getNElements();
+
+	OI_SHOT settings;
+	std::memset(&settings, 0, sizeof(settings));
+	settings.rx.nSamples = N_SAMPLES;
+	settings.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		settings.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(settings.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	std::vector<OI_TX_CHANNEL> tx(nElements);
+	std::vector<OI_RX_CHANNEL> rx(nElements);
+	for (OI_TX_CHANNEL& channel : tx) {
+		std::memset(&channel, 0, sizeof(channel));
+		channel.enable = 1u;
+		channel.nLevelSequence = sizeof(PULSE);
+		std::memcpy(channel.levelSequence, PULSE, sizeof(PULSE));
+	}
+
+	for (uint32_t iS = 0u; iS < N_SHOTS; ++iS) {
+		for (uint32_t iE = 0u; iE < nElements; ++iE) {
+			rx[iE].enable = iE != iS * 5u % nElements ? 1u : 0u;
+		}
+		program.addShot(settings, tx.data(), rx.data());
+	}
+
+	return program;
+}
+
+// Only the silent element's row of each shot is constant.
+static bool isSilentPlaced(const std::vector<int16_t>& frame,
+		uint32_t nElements)
+{
+	bool ok = true;
+
+	for (uint32_t iS = 0u; iS < N_SHOTS; ++iS) {
+		for (uint32_t iE = 0u; iE < nElements; ++iE) {
+			const int16_t* const pRow
+				= &frame[((std::size_t) iS * nElements + iE) * N_SAMPLES];
+			const bool isSilent = std::all_of(pRow, pRow + N_SAMPLES,
+					[pRow](int16_t v) { return v == pRow[0]; });
+			ok = ok && isSilent == (iE == iS * 5u % nElements);
+		}
+	}
+
+	return ok;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
@@ -0,0 +1,330 @@
+/*
+	oiBModeTest.cpp
+
+	Checks the host's B-mode conversion (oiBMode.h), for a sector and a
+	linear scan, into images whose sizes are and are not whole tiles:  that
+	the SIMD image matches the scalar one exactly; that an echo's brightest
+	pixel lies where the echo is; that a tone comes out at the grey level
+	that its amplitude is compressed to, and pixels outside the scan are
+	zero; that a frame, and planning again for the same geometry, allocate
+	nothing; and that what cannot be converted is refused.
+
+	Usage:  oiBModeTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiBMode.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t N_LINES = 64u;
+static const uint32_t N_SAMPLES = 2400u;
+
+static const double SAMPLE_RATE_HZ = 40.0e6;
+static const float SPEED_OF_SOUND = 1540.0f;
+static const double PI = 3.14159265358979324;
+static const double CENTRE_HZ = 5.0e6;
+
+// The echo:  a Gaussian-windowed burst at the centre frequency, on the
+//  middle line and those either side, at ECHO_DEPTH of the recording.
+static const double BURST_SAMPLES = 6.0;
+static const float ECHO_AMPLITUDE = 1000.0f;
+static const double ECHO_DEPTH = 0.6;
+static const float NOISE_AMPLITUDE = 1.0f;
+
+// The sector's lines fan over this, from one point at the array's centre;
+//  the linear scan's cover this width.
+static const float SECTOR_DEG = 60.0f;
+static const float LINEAR_WIDTH_UM = 19200.0f;
+
+// Square images:  of whole tiles, and not.
+static const uint32_t SIZES[] = { 256u, 301u };
+
+// The brightest pixel must lie this close to the echo, in pixels.
+static const double PEAK_TOLERANCE_PX = 3.0;
+
+// A tone half the dynamic range below the top is mid-grey, to within this.
+static const int MID_GREY = 128;
+static const int GREY_TOLERANCE = 4;
+
+//***********************  Local Function Declarations  **********************//
+static std::vector<float> makeEcho();
+static std::vector<float> makeTone(float amplitude);
+static oi::ScanGrid makeGrid(const oi::ScanGeometry& geometry, uint32_t size);
+static double peakOffset(const std::vector<uint8_t>& image,
+		const oi::ScanGeometry& geometry, const oi::ScanGrid& grid);
+static int centreGrey(const std::vector<uint8_t>& image,
+		const oi::ScanGeometry& geometry, const oi::ScanGrid& grid);
+static bool expect(const char* name, bool ok);
+
+//*******************************  Module Data  ******************************//
+// Allocations made by this program, counted by operator new.
+static std::atomic<unsigned long> nAllocations{ 0u };
+
+//****************************  Global Functions  ****************************//
+
+void* operator new(std::size_t nBytes)
+{
+	++nAllocations;
+	void* const p = std::malloc(nBytes != 0u ? nBytes : 1u);
+	if (p == nullptr) {
+		throw std::bad_alloc();
+	} else {
+		// Ok.
+	}
+
+	return p;
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main()
+{
+	// A line per shot, as the device records them.
+	oi::FrameProgram program;
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+	shot.rx.nSamples = N_SAMPLES;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iLine = 0u; iLine < N_LINES; ++iLine) {
+		program.addShot(shot);
+	}
+
+	oi::ScanGeometry sector = oi::scanOfFrame(program, SPEED_OF_SOUND,
+			SAMPLE_RATE_HZ);
+	oi::ScanGeometry linear = sector;
+	for (uint32_t iLine = 0u; iLine < N_LINES; ++iLine) {
+		const float f = (float) iLine / (N_LINES - 1u) - 0.5f;
+		sector.angleDeg[iLine] = f * SECTOR_DEG;
+		linear.originXUm[iLine] = f * LINEAR_WIDTH_UM;
+	}
+	const struct {
+		const char* name;
+		const oi::ScanGeometry& geometry;
+		bool isSector;
+	} scans[] = {
+		{ "sector", sector, true },
+		{ "linear", linear, false },
+	};
+
+	const oi::BModeCompression compression;
+	const std::vector<float>
+		echo = makeEcho(),
+		tone = makeTone(std::pow(10.0f,
+				(compression.topDb - 0.5f * compression.dynamicRangeDb)
+						/ 20.0f));
+	bool ok = true;
+
+	for (const auto& scan : scans) {
+		for (const uint32_t size : SIZES) {
+			const oi::ScanGrid grid = makeGrid(scan.geometry, size);
+			std::vector<uint8_t>
+				expected((std::size_t) grid.width * grid.height),
+				image(expected.size());
+			oi::BModeConverter reference(false), converter;
+			char name[64];
+
+			/////  SIMD  /////
+			std::snprintf(name, sizeof(name), "%s %u:  SIMD as scalar",
+					scan.name, size);
+			ok = expect(name,
+					reference.plan(scan.geometry, grid)
+					&& reference.convert(expected.data(), echo.data(),
+						N_SAMPLES, compression)
+					&& converter.plan(scan.geometry, grid)
+					&& converter.convert(image.data(), echo.data(), N_SAMPLES,
+						compression)
+					&& image == expected)
+					&& ok;
+
+			/////  Echo  /////
+			std::snprintf(name, sizeof(name), "%s %u:  echo in place",
+					scan.name, size);
+			ok = expect(name,
+					peakOffset(image, scan.geometry, grid) <= PEAK_TOLERANCE_PX)
+					&& ok;
+
+			/////  Compression  /////
+			// The sector's top corners are outside it.
+			converter.convert(image.data(), tone.data(), N_SAMPLES,
+					compression);
+			std::snprintf(name, sizeof(name), "%s %u:  tone mid-grey",
+					scan.name, size);
+			ok = expect(name,
+					std::abs(centreGrey(image, scan.geometry, grid) - MID_GREY)
+							<= GREY_TOLERANCE
+					&& (!scan.isSector
+						|| (image.front() == 0u
+							&& image[grid.width - 1u] == 0u)))
+					&& ok;
+
+			/////  Allocation  /////
+			const unsigned long nBefore = nAllocations;
+			converter.plan(scan.geometry, grid);
+			converter.convert(image.data(), echo.data(), N_SAMPLES,
+					compression);
+			std::snprintf(name, sizeof(name), "%s %u:  frame allocates none",
+					scan.name, size);
+			ok = expect(name, nAllocations == nBefore) && ok;
+		}
+	}
+
+	/////  Refused  /////
+	{
+		const oi::ScanGrid grid = makeGrid(linear, SIZES[0]);
+		std::vector<uint8_t> image((std::size_t) grid.width * grid.height);
+		oi::BModeConverter converter;
+
+		ok = expect("convert before plan refused",
+				!converter.convert(image.data(), echo.data(), N_SAMPLES,
+					compression))
+				&& ok;
+
+		oi::ScanGeometry one = linear;
+		one.originXUm.resize(1u);
+		one.originZUm.resize(1u);
+		one.angleDeg.resize(1u);
+		ok = expect("one line refused", !converter.plan(one, grid)) && ok;
+
+		oi::ScanGeometry shortLines = linear;
+		shortLines.nSamples = 1u;
+		ok = expect("one sample refused", !converter.plan(shortLines, grid))
+				&& ok;
+
+		oi::ScanGrid empty = grid;
+		empty.width = 0u;
+		ok = expect("no pixels refused", !converter.plan(linear, empty)) && ok;
+
+		ok = expect("short stride refused",
+				converter.plan(linear, grid)
+				&& !converter.convert(image.data(), echo.data(),
+					N_SAMPLES - 1u, compression))
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// As oiBModeBench:  the echo on the middle line, at half amplitude on
+//  those either side, and a little uniform noise everywhere.
+static std::vector<float> makeEcho()
+{
+	std::vector<float> lines((std::size_t) N_LINES * N_SAMPLES);
+	const double depth = ECHO_DEPTH * (N_SAMPLES - 1u);
+	uint32_t seed = 1u;
+
+	for (uint32_t iLine = 0u; iLine < N_LINES; ++iLine) {
+		const int32_t fromEcho = (int32_t) iLine - (int32_t) (N_LINES / 2u);
+		const float amplitude = std::abs(fromEcho) <= 1
+				? ECHO_AMPLITUDE / (1 + std::abs(fromEcho))
+				: 0.0f;
+
+		for (uint32_t i = 0u; i < N_SAMPLES; ++i) {
+			const double t = i - depth;
+			seed = seed * 1664525u + 1013904223u;
+			lines[(std::size_t) iLine * N_SAMPLES + i] = amplitude
+					* (float) (std::exp(-0.5 * t * t
+							/ (BURST_SAMPLES * BURST_SAMPLES))
+					* std::cos(2.0 * PI * CENTRE_HZ / SAMPLE_RATE_HZ * t))
+					+ NOISE_AMPLITUDE
+							* ((float) (seed >> 8) / (1u << 24) - 0.5f);
+		}
+	}
+
+	return lines;
+}
+
+// A tone at the centre frequency, of the given amplitude, on every line.
+static std::vector<float> makeTone(float amplitude)
+{
+	std::vector<float> lines((std::size_t) N_LINES * N_SAMPLES);
+
+	for (std::size_t i = 0u; i < lines.size(); ++i) {
+		lines[i] = amplitude * (float) std::cos(2.0 * PI * CENTRE_HZ
+				/ SAMPLE_RATE_HZ * (double) (i % N_SAMPLES));
+	}
+
+	return lines;
+}
+
+// A square grid over the scan's extent, as oiBModeBench.
+static oi::ScanGrid makeGrid(const oi::ScanGeometry& geometry, uint32_t size)
+{
+	float xMin = 1.0e30f, xMax = -1.0e30f, zMax = 0.0f;
+	const float reach = geometry.startUm
+			+ (geometry.nSamples - 1u) * geometry.stepUm;
+	for (std::size_t i = 0u; i < geometry.angleDeg.size(); ++i) {
+		const double a = geometry.angleDeg[i] * PI / 180.0;
+		const float x = geometry.originXUm[i] + (float) (reach * std::sin(a));
+		xMin = std::min({ xMin, x, geometry.originXUm[i] });
+		xMax = std::max({ xMax, x, geometry.originXUm[i] });
+		zMax = std::max(zMax, geometry.originZUm[i]
+				+ (float) (reach * std::cos(a)));
+	}
+
+	oi::ScanGrid grid;
+	grid.width = size;
+	grid.height = size;
+	grid.pixelUm = std::max(xMax - xMin, zMax) / (size - 1u);
+	grid.xStartUm = 0.5f * (xMin + xMax) - 0.5f * (size - 1u) * grid.pixelUm;
+	grid.zStartUm = 0.0f;
+
+	return grid;
+}
+
+// Distance, in pixels, from the brightest pixel to the echo.
+static double peakOffset(const std::vector<uint8_t>& image,
+		const oi::ScanGeometry& geometry, const oi::ScanGrid& grid)
+{
+	const std::size_t iPeak = std::max_element(image.begin(), image.end())
+			- image.begin();
+	const uint32_t iLine = (uint32_t) geometry.originXUm.size() / 2u;
+	const double
+		a = geometry.angleDeg[iLine] * PI / 180.0,
+		along = geometry.startUm
+				+ ECHO_DEPTH * (geometry.nSamples - 1u) * geometry.stepUm,
+		x = (geometry.originXUm[iLine] + along * std::sin(a) - grid.xStartUm)
+				/ grid.pixelUm,
+		z = (geometry.originZUm[iLine] + along * std::cos(a) - grid.zStartUm)
+				/ grid.pixelUm;
+
+	return std::hypot((double) (iPeak % grid.width) - x,
+			(double) (iPeak / grid.width) - z);
+}
+
+// Grey level of the pixel half way down the middle line.
+static int centreGrey(const std::vector<uint8_t>& image,
+		const oi::ScanGeometry& geometry, const oi::ScanGrid& grid)
+{
+	const uint32_t iLine = (uint32_t) geometry.originXUm.size() / 2u;
+	const double
+		a = geometry.angleDeg[iLine] * PI / 180.0,
+		along = geometry.startUm
+				+ 0.5 * (geometry.nSamples - 1u) * geometry.stepUm;
+	const long
+		x = std::lround((geometry.originXUm[iLine] + along * std::sin(a)
+				- grid.xStartUm) / grid.pixelUm),
+		z = std::lround((geometry.originZUm[iLine] + along * std::cos(a)
+				- grid.zStartUm) / grid.pixelUm);
+
+	return image[(std::size_t) z * grid.width + (std::size_t) x];
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-36s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
@@ -0,0 +1,221 @@
+/*
+	oiBeamformTest.cpp
+
+	Checks the delay-and-sum beamforming of the firmware (oiBeamform.c, as
+	built for the host):  the receive delays against the geometry in double
+	precision; the scalar summation against a direct reference; and the
+	NEON summation, built over the scalar model of the intrinsics in
+	neon/arm_neon.h, against the scalar one, which it must match exactly.
+	The delays include those before the recording and past its end, and
+	the samples and apodization span their whole ranges.
+
+	Usage:  oiBeamformTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "open_image_protocol.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+
+// Channels recorded by each ADC.
+static const uint32_t N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+
+static const uint32_t N_SAMPLES = 2048u;
+
+// As oiBeamform.c.
+static const uint32_t DELAY_FRAC_BITS = 8u;
+static const uint32_t DELAY_NONE = UINT32_MAX;
+
+//***********************  Local Function Declarations  **********************//
+// The NEON path of oiBeamform.c, as built for this test (see CMakeLists.txt).
+extern "C" void oiBfSumNeon(
+		int32_t* pLine,
+		const int16_t* const* ppRf,
+		uint32_t nSamples,
+		const uint32_t* pDelays,
+		const OI_BF_CONFIG* pCfg
+);
+
+static OI_BF_CONFIG makeConfig(uint32_t nDepth, std::mt19937& random);
+static double maxDelayError(const std::vector<uint32_t>& delays,
+		const OI_BF_CONFIG& cfg, uint32_t iShot);
+static std::vector<int32_t> sumReference(
+		const std::vector<int16_t>* pRf,
+		const std::vector<uint32_t>& delays,
+		const OI_BF_CONFIG& cfg
+);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	const OI_BF_CONFIG cfg = makeConfig(OI_BF_MAX_N_DEPTH, random);
+	ok = expect("config valid", oiBfValidate(&cfg) == OI_ERR_NONE) && ok;
+
+	// Full-scale noise on every channel:
+	std::vector<int16_t> rf[OI_RX_N_CHIPS];
+	const int16_t* ppRf[OI_RX_N_CHIPS];
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		rf[iAdc].resize(N_SAMPLES * N_LANES);
+		for (int16_t& v : rf[iAdc]) {
+			v = (int16_t) (uint16_t) random();
+		}
+		ppRf[iAdc] = rf[iAdc].data();
+	}
+
+	std::vector<uint32_t> delays(OI_BF_MAX_N_DEPTH * OI_N_CHAN);
+	std::vector<int32_t>
+		line(OI_BF_MAX_N_DEPTH),
+		lineNeon(OI_BF_MAX_N_DEPTH);
+	bool
+		isNear = true,
+		isExact = true,
+		isSame = true;
+	uint32_t
+		nBefore = 0u,
+		nPast = 0u;
+
+	for (uint32_t iShot = 0u; iShot < OI_MAX_N_SHOTS; iShot += 17u) {
+		/////  Delays  /////
+		oiBfDelays(delays.data(), &cfg, iShot);
+		isNear = maxDelayError(delays, cfg, iShot) <= 1.0 && isNear;
+		for (const uint32_t d : delays) {
+			nBefore += d == DELAY_NONE ? 1u : 0u;
+			nPast += d != DELAY_NONE && (d >> DELAY_FRAC_BITS) + 1u >= N_SAMPLES
+					? 1u : 0u;
+		}
+
+		/////  Summation  /////
+		oiBfSum(line.data(), ppRf, N_SAMPLES, delays.data(), &cfg);
+		oiBfSumNeon(lineNeon.data(), ppRf, N_SAMPLES, delays.data(), &cfg);
+		isExact = line == sumReference(rf, delays, cfg) && isExact;
+		isSame = lineNeon == line && isSame;
+	}
+	const bool isSpanned = nBefore > 0u && nPast > 0u;
+
+	ok = expect("delays within 1/256 sample", isNear) && ok;
+	ok = expect("delays before and past recording", isSpanned) && ok;
+	ok = expect("scalar sum as reference", isExact) && ok;
+	ok = expect("NEON sum as scalar", isSame) && ok;
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// A 0.3 mm array, its lines spread across it, to a depth that runs past
+//  the recording, and an offset that puts the shallowest points before it.
+//  The apodization spans its whole range.
+static OI_BF_CONFIG makeConfig(uint32_t nDepth, std::mt19937& random)
+{
+	OI_BF_CONFIG cfg = {};
+
+	cfg.enable = 1u;
+	cfg.pitchNm = 300000u;
+	cfg.speedOfSound = 1540u;
+	cfg.sampleRateHz = 40000000u;
+	cfg.nDepth = nDepth;
+	cfg.depthStartUm = 0u;
+	cfg.depthStepUm = 10u;
+	cfg.offsetQ8 = 20 * 256;
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		cfg.apodization[iChan] = (int16_t) (uint16_t) random();
+	}
+	cfg.apodization[0] = INT16_MIN;
+	cfg.apodization[OI_N_CHAN - 1u] = INT16_MAX;
+	for (uint32_t iShot = 0u; iShot < OI_MAX_N_SHOTS; ++iShot) {
+		cfg.lineXUm[iShot] = (int32_t) (iShot * 5000u / OI_MAX_N_SHOTS) - 2500;
+	}
+
+	return cfg;
+}
+
+// Largest difference of any delay from that of the geometry, in delay
+//  units.
+static double maxDelayError(const std::vector<uint32_t>& delays,
+		const OI_BF_CONFIG& cfg, uint32_t iShot)
+{
+	const double
+		scale = (double) cfg.sampleRateHz * (1u << DELAY_FRAC_BITS)
+				/ cfg.speedOfSound,
+		lineX = cfg.lineXUm[iShot] * 1.0e-6;
+	double worst = 0.0;
+
+	for (uint32_t iDepth = 0u; iDepth < cfg.nDepth; ++iDepth) {
+		const double z
+			= (cfg.depthStartUm + (double) iDepth * cfg.depthStepUm) * 1.0e-6;
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			const double
+				x = ((double) iChan - (OI_N_CHAN - 1u) / 2.0) * cfg.pitchNm
+						* 1.0e-9 - lineX,
+				delay = (z + std::hypot(x, z)) * scale - cfg.offsetQ8;
+			const uint32_t d = delays[iDepth * OI_N_CHAN + iChan];
+
+			if (delay < -0.5) {
+				worst = std::max(worst, d == DELAY_NONE ? 0.0 : HUGE_VAL);
+			} else if (d == DELAY_NONE) {
+				worst = std::max(worst, delay < 0.5 ? 0.0 : HUGE_VAL);
+			} else {
+				worst = std::max(worst, std::fabs(d - delay));
+			}
+		}
+	}
+
+	return worst;
+}
+
+// The line, as oiBfSum's comment describes it:  each channel's samples
+//  interpolated at its delay, rounded, weighted and summed, then rounded
+//  from Q15.
+static std::vector<int32_t> sumReference(
+		const std::vector<int16_t>* pRf,
+		const std::vector<uint32_t>& delays,
+		const OI_BF_CONFIG& cfg
+) {
+	std::vector<int32_t> line(cfg.nDepth);
+
+	for (uint32_t iDepth = 0u; iDepth < cfg.nDepth; ++iDepth) {
+		int64_t sum = 0;
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			const std::vector<int16_t>& rf = pRf[iChan / N_LANES];
+			const uint32_t
+				iLane = iChan % N_LANES,
+				d = delays[iDepth * OI_N_CHAN + iChan],
+				n = d >> DELAY_FRAC_BITS;
+
+			if (d != DELAY_NONE && n + 1u < N_SAMPLES) {
+				const int32_t
+					s0 = rf[n * N_LANES + iLane],
+					s1 = rf[(n + 1u) * N_LANES + iLane],
+					frac = (int32_t) (d & ((1u << DELAY_FRAC_BITS) - 1u)),
+					sample = (int32_t) std::floor(
+						(s0 * 256.0 + (s1 - s0) * (double) frac) / 256.0 + 0.5);
+				sum += (int64_t) sample * cfg.apodization[iChan];
+			} else {
+				// Nothing recorded there.
+			}
+		}
+		line[iDepth] = (int32_t) std::floor(sum / 32768.0 + 0.5);
+	}
+
+	return line;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
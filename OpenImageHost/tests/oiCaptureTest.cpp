@@ -0,0 +1,432 @@
+/*
+	oiCaptureTest.cpp
+
+	Checks continuous capture to disk:  that the io_uring (oiUring.h)
+	writes and reads buffers as tagged, refuses operations beyond its ring,
+	and reports errors as -errno; that the capture writer
+	(oiCaptureWriter.h), through io_uring with and without O_DIRECT and
+	through pwrite, records every frame committed and none discarded, from
+	fewer buffers than frames, so that a reader never counts a frame whose
+	data are not yet on disk; and that frames captured from the emulator
+	(oiEmulator.h), as oiCaptured captures them, are recorded in order.
+	Where the kernel has no io_uring, only pwrite is checked.
+
+	Usage:  oiCaptureTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiCaptureWriter.h"
+#include "oiClient.h"
+#include "oiEmulator.h"
+#include "oiRecording.h"
+#include "oiSamples.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//********************************  Constants  *******************************//
+static const char* const PATH = "oiCaptureTest.oir";
+
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t N_SHOTS = 3u;
+static const uint32_t N_SAMPLES = 1000u;
+
+// Frames given to the writer, through fewer buffers and writes in flight;
+//  every DISCARD_EVERY'th is discarded.
+static const uint32_t N_FRAMES = 40u;
+static const std::size_t N_BUFFERS = 4u;
+static const unsigned N_WRITES = 2u;
+static const uint32_t DISCARD_EVERY = 7u;
+
+// Frames captured from the emulator.
+static const uint32_t N_CAPTURED = 6u;
+
+static const unsigned N_RING_ENTRIES = 4u;
+static const uint32_t RING_BYTES = 4096u;
+
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+static const std::chrono::microseconds BUFFER_POLL_PERIOD(100);
+
+//***********************  Local Function Declarations  **********************//
+static bool checkRing();
+static bool checkWriter(bool isUring, bool isDirect);
+static bool checkCaptured(bool isUring);
+static oi::FrameProgram makeFrame(uint32_t handle);
+static void fillFrame(oi::CaptureWriter& writer, uint8_t* pBuffer,
+		const oi::FrameProgram& program, uint32_t iFrame);
+static bool checkFrame(const oi::RecordingReader& reader, uint64_t iRecorded,
+		uint32_t iFrame);
+static bool record(oi::Client& client, const oi::FrameProgram& program);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	const bool isUring = oi::Uring(1u).isOpen();
+	bool ok = true;
+
+	if (isUring) {
+		ok = expect("io_uring", checkRing()) && ok;
+		ok = expect("writer:  io_uring, O_DIRECT", checkWriter(true, true))
+				&& ok;
+		ok = expect("writer:  io_uring, page cache",
+				checkWriter(true, false))
+				&& ok;
+	} else {
+		std::printf("%-32s %s\n", "io_uring", "not available, skipped");
+	}
+	ok = expect("writer:  pwrite", checkWriter(false, false)) && ok;
+	ok = expect("captured from emulator", checkCaptured(isUring)) && ok;
+
+	std::remove(PATH);
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Writes buffers of distinct bytes, then reads them back, all at once;
+//  fills the ring until it refuses; and reads from a file not open.
+static bool checkRing()
+{
+	oi::Uring ring(N_RING_ENTRIES);
+	const int fd = ::open(PATH, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	std::vector<uint8_t>
+		data(N_RING_ENTRIES * RING_BYTES),
+		back(data.size(), 0u);
+	for (std::size_t i = 0u; i < data.size(); ++i) {
+		data[i] = (uint8_t) (i * 7u + i / RING_BYTES);
+	}
+
+	bool ok = ring.isOpen() && fd >= 0;
+	for (const bool isWrite : { true, false }) {
+		for (uint32_t i = 0u; i < N_RING_ENTRIES && ok; ++i) {
+			ok = isWrite
+					? ring.write(fd, &data[i * RING_BYTES], RING_BYTES,
+						i * RING_BYTES, 100u + i)
+					: ring.read(fd, &back[i * RING_BYTES], RING_BYTES,
+						i * RING_BYTES, 200u + i);
+		}
+		ok = ok && ring.submit(N_RING_ENTRIES);
+
+		// Each tag once, whole:
+		std::vector<bool> isSeen(N_RING_ENTRIES, false);
+		oi::UringCompletion completion;
+		while (ok && ring.complete(completion)) {
+			const uint64_t i = completion.tag - (isWrite ? 100u : 200u);
+			ok = i < N_RING_ENTRIES && !isSeen[i]
+					&& completion.result == (int32_t) RING_BYTES;
+			if (ok) {
+				isSeen[i] = true;
+			} else {
+				// Not queued, twice, or short.
+			}
+		}
+		for (const bool is : isSeen) {
+			ok = ok && is;
+		}
+	}
+	ok = ok && back == data;
+
+	// Queued until refused, then all submitted:
+	unsigned nQueued = 0u;
+	while (ok && nQueued <= 4u * N_RING_ENTRIES
+			&& ring.read(fd, back.data(), RING_BYTES, 0u, nQueued)) {
+		++nQueued;
+	}
+	ok = ok && nQueued >= N_RING_ENTRIES && nQueued <= 4u * N_RING_ENTRIES
+			&& ring.submit(nQueued);
+	oi::UringCompletion completion;
+	for (unsigned i = 0u; i < nQueued && ok; ++i) {
+		ok = ring.complete(completion)
+				&& completion.result == (int32_t) RING_BYTES;
+	}
+	ok = ok && !ring.complete(completion);
+
+	// Failed, as -errno:
+	ok = ok && ring.read(-1, back.data(), RING_BYTES, 0u, 300u)
+			&& ring.submit(1u) && ring.complete(completion)
+			&& completion.tag == 300u && completion.result == -EBADF;
+
+	if (fd >= 0) {
+		::close(fd);
+	} else {
+		// Not opened.
+	}
+
+	return ok;
+}
+
+// Gives the writer N_FRAMES frames, discarding some, waiting for buffers as
+//  they are written, and checking, as each is committed, the frames that a
+//  reader counts; then every frame once closed.
+static bool checkWriter(bool isUring, bool isDirect)
+{
+	const oi::FrameProgram program = makeFrame(0u);
+	oi::CaptureWriterOptions options;
+	options.nBuffers = N_BUFFERS;
+	options.nWrites = N_WRITES;
+	options.isDirect = isDirect;
+	options.isUring = isUring;
+	oi::CaptureWriter writer(options);
+	oi::RecordingReader reader;
+
+	bool ok = writer.create(PATH, program) && writer.isUring() == isUring
+			&& reader.open(PATH) && reader.getNFrames() == 0u;
+	ok = ok && (writer.isDirect() || !isDirect);
+
+	std::vector<uint32_t> committed;
+	for (uint32_t iFrame = 0u; iFrame < N_FRAMES && ok; ++iFrame) {
+		uint8_t* pBuffer = writer.acquire();
+		const auto start = std::chrono::steady_clock::now();
+		while (pBuffer == nullptr
+				&& std::chrono::steady_clock::now() - start < RECORD_TIMEOUT) {
+			std::this_thread::sleep_for(BUFFER_POLL_PERIOD);
+			pBuffer = writer.acquire();
+		}
+		ok = pBuffer != nullptr;
+
+		if (ok && iFrame % DISCARD_EVERY == DISCARD_EVERY - 1u) {
+			writer.discard(pBuffer);
+		} else if (ok) {
+			fillFrame(writer, pBuffer, program, iFrame);
+			writer.commit(pBuffer, iFrame);
+			committed.push_back(iFrame);
+		} else {
+			// Never freed.
+		}
+
+		// What a reader counts is on disk:
+		const uint64_t nRead = reader.refresh();
+		ok = ok && nRead <= committed.size()
+				&& (nRead == 0u
+					|| checkFrame(reader, nRead - 1u, committed[nRead - 1u]));
+	}
+
+	ok = writer.close() && ok;
+	const oi::CaptureWriterStats stats = writer.getStats();
+	ok = ok && stats.nCommitted == committed.size()
+			&& stats.nWritten == committed.size() && stats.nErrors == 0u
+			&& stats.maxQueued <= N_BUFFERS;
+
+	ok = ok && reader.refresh() == committed.size() && reader.isComplete();
+	for (uint64_t i = 0u; i < reader.getNFrames() && ok; ++i) {
+		oi::RecordingIndexEntry entry;
+		ok = checkFrame(reader, i, committed[i])
+				&& reader.getIndexEntry(i, entry)
+				&& entry.receivedNs == committed[i]
+				&& entry.handle == committed[i] && entry.nBadShots == 0u;
+	}
+
+	return ok;
+}
+
+// Captures N_CAPTURED frames from the emulator, as oiCaptured does:  each
+//  recorded, then read into a buffer of the writer, and committed as its
+//  read completes.
+static bool checkCaptured(bool isUring)
+{
+	oi::EmulatorOptions emulatorOptions;
+	emulatorOptions.port = 0u;
+	oi::Emulator emulator(emulatorOptions);
+	oi::Client client;
+	oi::CaptureWriterOptions options;
+	options.nBuffers = N_BUFFERS;
+	options.isUring = isUring;
+	oi::CaptureWriter writer(options);
+
+	bool ok = emulator.start()
+			&& client.connect("127.0.0.1", emulator.getPort())
+			&& writer.create(PATH, makeFrame(0u));
+
+	for (uint32_t iFrame = 0u; iFrame < N_CAPTURED && ok; ++iFrame) {
+		const oi::FrameProgram program = makeFrame(iFrame);
+		ok = record(client, program);
+
+		// A buffer for it, freed as the frames before it are written:
+		uint8_t* pBuffer = ok ? writer.acquire() : nullptr;
+		const auto start = std::chrono::steady_clock::now();
+		while (ok && pBuffer == nullptr
+				&& std::chrono::steady_clock::now() - start < RECORD_TIMEOUT) {
+			std::this_thread::sleep_for(BUFFER_POLL_PERIOD);
+			pBuffer = writer.acquire();
+		}
+		ok = ok && pBuffer != nullptr;
+
+		if (ok) {
+			oi::FrameBuffers buffers;
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+				buffers.pData[iAdc] = writer.getAdcData(pBuffer, iAdc);
+				buffers.nBytes[iAdc] = program.getRawBytes();
+			}
+			client.readFrame(buffers,
+					[&writer, pBuffer, iFrame](const oi::FrameResult& result) {
+				if (result.ok) {
+					writer.commit(pBuffer, iFrame);
+				} else {
+					writer.discard(pBuffer);
+				}
+			});
+		} else {
+			// Not recorded, or no buffer.
+		}
+	}
+
+	// The replies come in order, so the frames' reads are done with this:
+	ok = ok && client.getStatus().get().code != 0u;
+	client.close();
+	ok = writer.close() && ok;
+
+	oi::RecordingReader reader;
+	ok = ok && reader.open(PATH) && reader.isComplete()
+			&& reader.getNFrames() == N_CAPTURED;
+	for (uint32_t iFrame = 0u; iFrame < N_CAPTURED && ok; ++iFrame) {
+		oi::RecordingIndexEntry entry;
+		ok = reader.getIndexEntry(iFrame, entry)
+				&& entry.receivedNs == iFrame && entry.handle == iFrame
+				&& entry.nBadShots == 0u;
+		for (uint32_t iShot = 0u; iShot < N_SHOTS && ok; ++iShot) {
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && ok; ++iAdc) {
+				OI_SHOT_HEADER header;
+				std::memcpy(&header,
+						reader.getShotRecord(iFrame, iShot, iAdc),
+						sizeof(header));
+				ok = oi::isShotGood(header) && header.handle == iFrame
+						&& header.iShot == iShot;
+			}
+		}
+	}
+
+	return ok;
+}
+
+// N_SHOTS shots of N_SAMPLES, on every channel.
+static oi::FrameProgram makeFrame(uint32_t handle)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+	shot.rx.nSamples = N_SAMPLES;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	oi::FrameProgram program;
+	program.setHandle(handle);
+	for (uint32_t iS = 0u; iS < N_SHOTS; ++iS) {
+		program.addShot(shot);
+	}
+	program.build();
+
+	return program;
+}
+
+// Good headers, handled with the frame's number, and samples that identify
+//  the frame, ADC and place.
+static void fillFrame(oi::CaptureWriter& writer, uint8_t* pBuffer,
+		const oi::FrameProgram& program, uint32_t iFrame)
+{
+	const std::size_t
+		nRecord = oi::shotRecordBytes(N_SAMPLES, OI_SAMPLE_FORMAT_16),
+		nWords = (nRecord - OI_SHOT_HEADER_BYTES) / sizeof(uint16_t);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		uint8_t* const pData = writer.getAdcData(pBuffer, iAdc);
+		for (uint32_t iShot = 0u; iShot < program.getNShots(); ++iShot) {
+			uint8_t* const pRecord = pData + iShot * nRecord;
+			OI_SHOT_HEADER header = {};
+			header.magic = OI_SHOT_MAGIC;
+			header.handle = iFrame;
+			header.iShot = iShot;
+			header.nBytes = (uint32_t) (nRecord - OI_SHOT_HEADER_BYTES);
+			std::memcpy(pRecord, &header, sizeof(header));
+
+			for (std::size_t i = 0u; i < nWords; ++i) {
+				const uint16_t value
+					= (uint16_t) (i * 7u + iShot * 131u + iAdc * 4099u
+						+ iFrame * 257u);
+				std::memcpy(pRecord + OI_SHOT_HEADER_BYTES + 2u * i, &value,
+						sizeof(value));
+			}
+		}
+	}
+}
+
+// The recorded frame, as fillFrame filled frame iFrame.
+static bool checkFrame(const oi::RecordingReader& reader, uint64_t iRecorded,
+		uint32_t iFrame)
+{
+	const std::size_t
+		nRecord = oi::shotRecordBytes(N_SAMPLES, OI_SAMPLE_FORMAT_16),
+		nWords = (nRecord - OI_SHOT_HEADER_BYTES) / sizeof(uint16_t);
+	bool ok = true;
+
+	for (uint32_t iShot = 0u; iShot < N_SHOTS && ok; ++iShot) {
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && ok; ++iAdc) {
+			const uint8_t* const pRecord
+				= reader.getShotRecord(iRecorded, iShot, iAdc);
+			OI_SHOT_HEADER header;
+			ok = pRecord != nullptr;
+			if (ok) {
+				std::memcpy(&header, pRecord, sizeof(header));
+				ok = oi::isShotGood(header) && header.handle == iFrame
+						&& header.iShot == iShot;
+			} else {
+				// No such shot.
+			}
+
+			for (std::size_t i = 0u; i < nWords && ok; ++i) {
+				uint16_t value;
+				std::memcpy(&value, pRecord + OI_SHOT_HEADER_BYTES + 2u * i,
+						sizeof(value));
+				ok = value == (uint16_t) (i * 7u + iShot * 131u + iAdc * 4099u
+						+ iFrame * 257u);
+			}
+		}
+	}
+
+	return ok;
+}
+
+// Queues the frame, and waits until it is recorded.
+static bool record(oi::Client& client, const oi::FrameProgram& program)
+{
+	const auto start = std::chrono::steady_clock::now();
+	OI_STATUS status;
+	bool ok = client.queueFrame(program).get().isAck();
+
+	do {
+		ok = ok && std::chrono::steady_clock::now() - start < RECORD_TIMEOUT
+				&& client.getStatus().get().get(status);
+	} while (ok && status.state != STATE_READY);
+
+	return ok;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
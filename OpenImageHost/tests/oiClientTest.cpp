@@ -0,0 +1,252 @@
+/*
+	oiClientTest.cpp
+
+	Checks the client (oiClient.h) against the emulator (oiEmulator.h) on
+	the loopback:  that a frame read with many requests in flight, in
+	pieces of a size that splits the shots anywhere, matches one read a
+	piece at a time; that refused requests are answered with NACKs, in
+	order with the others, including a piece too large for the device to
+	send; and that closing with requests in flight completes each of them
+	exactly once.
+
+	Usage:  oiClientTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiClient.h"
+#include "oiEmulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t
+	N_SHOTS = 8u,
+	N_SAMPLES = 1000u;
+
+// Pieces of the pipelined read:  not a divisor of a shot's record.
+static const std::size_t PIPELINED_CHUNK = 1000u;
+
+// Arming of the emulator whose frame is read while it records.
+static const uint32_t SLOW_ARM_US = 500000u;
+
+// Requests in flight when the client is closed; each reply is delayed
+//  by REPLY_US, so that most are still waiting.
+static const uint32_t N_IN_FLIGHT = 32u;
+static const uint32_t REPLY_US = 2000u;
+
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+
+//***********************  Local Function Declarations  **********************//
+static oi::FrameProgram makeFrame();
+static bool record(oi::Client& client, const oi::FrameProgram& program);
+static oi::FrameResult readFrame(oi::Client& client,
+		const oi::FrameProgram& program,
+		std::vector<uint8_t> (&data)[OI_RX_N_CHIPS]);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	oi::EmulatorOptions emulatorOptions;
+	emulatorOptions.port = 0u;
+	oi::Emulator emulator(emulatorOptions);
+	bool ok = true;
+
+	if (!emulator.start()) {
+		std::fprintf(stderr, "cannot start the emulator\n");
+		return 1;
+	} else {
+		// Serving.
+	}
+
+	const oi::FrameProgram program = makeFrame();
+
+	/////  readFrame  /////
+	// Pipelined, against a piece at a time.
+	{
+		oi::ClientOptions serial, pipelined;
+		serial.maxInFlight = 1u;
+		serial.chunkBytes = OI_MAX_REPLY_BYTES;
+		pipelined.chunkBytes = PIPELINED_CHUNK;
+		oi::Client one(serial), many(pipelined);
+		std::vector<uint8_t> expected[OI_RX_N_CHIPS], data[OI_RX_N_CHIPS];
+
+		bool same = one.connect("127.0.0.1", emulator.getPort())
+				&& record(one, program)
+				&& readFrame(one, program, expected).ok;
+		one.close();
+		same = same && many.connect("127.0.0.1", emulator.getPort())
+				&& readFrame(many, program, data).ok;
+		bool isRecorded = false;
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			same = same && data[iAdc] == expected[iAdc];
+			for (uint8_t b : data[iAdc]) {
+				isRecorded = isRecorded || b != 0u;
+			}
+		}
+		ok = expect("pipelined readFrame", same && isRecorded) && ok;
+	}
+
+	/////  NACKs  /////
+	{
+		oi::Client client;
+		bool isNacked = client.connect("127.0.0.1", emulator.getPort());
+
+		// A piece larger than the device can send, between two that it
+		//  can:  each is answered, in order.
+		const OI_FRAME_DATA_REQ small = { 0u, 0u, 16u };
+		const OI_FRAME_DATA_REQ large = { 0u, 0u, OI_MAX_REPLY_BYTES + 1u };
+		std::future<oi::Reply> before = client.send(OI_CMD_GET_FRAME, &small,
+				sizeof(small));
+		std::future<oi::Reply> refused = client.send(OI_CMD_GET_FRAME, &large,
+				sizeof(large));
+		std::future<oi::Reply> after = client.send(OI_CMD_GET_FRAME, &small,
+				sizeof(small));
+		oi::Reply reply = before.get();
+		isNacked = isNacked && reply.code == OI_RES_FRAME
+				&& reply.nBytes == small.nBytes;
+		reply = refused.get();
+		isNacked = isNacked && reply.code == OI_RES_NACK
+				&& reply.error == OI_ERR_INCORRECT_SIZE;
+		reply = after.get();
+		isNacked = isNacked && reply.code == OI_RES_FRAME
+				&& reply.nBytes == small.nBytes;
+		ok = expect("oversized piece NACK'd", isNacked) && ok;
+	}
+
+	emulator.stop();
+
+	// A frame read while the next is recorded.
+	{
+		oi::EmulatorOptions slowOptions = emulatorOptions;
+		slowOptions.armUs = SLOW_ARM_US;
+		oi::Emulator slow(slowOptions);
+		oi::Client client;
+		bool isNacked = slow.start()
+				&& client.connect("127.0.0.1", slow.getPort());
+
+		std::future<oi::Reply> queued = client.queueFrame(program);
+		std::vector<uint8_t> data[OI_RX_N_CHIPS];
+		const oi::FrameResult result = readFrame(client, program, data);
+		ok = expect("read while recording NACK'd",
+				isNacked && queued.get().isAck() && !result.ok
+				&& result.error == OI_ERR_ILLEGAL_STATE)
+				&& ok;
+	}
+
+	/////  close  /////
+	{
+		oi::EmulatorOptions slowOptions = emulatorOptions;
+		slowOptions.replyUs = REPLY_US;
+		oi::Emulator slow(slowOptions);
+		oi::Client client;
+		std::vector<uint32_t> nCalls(N_IN_FLIGHT, 0u);
+		std::vector<uint8_t> codes(N_IN_FLIGHT, 0u);
+		bool isClosed = slow.start()
+				&& client.connect("127.0.0.1", slow.getPort());
+
+		for (uint32_t i = 0u; i < N_IN_FLIGHT && isClosed; ++i) {
+			client.send(OI_CMD_GET_STATUS, nullptr, 0u,
+					[&nCalls, &codes, i](const oi::Reply& reply) {
+				++nCalls[i];
+				codes[i] = reply.code;
+			});
+		}
+		client.close();
+
+		// Each once; those answered before the close first, in order.
+		bool isUnanswered = false;
+		for (uint32_t i = 0u; i < N_IN_FLIGHT; ++i) {
+			isClosed = isClosed && nCalls[i] == 1u
+					&& (codes[i] == OI_RES_STATUS
+						? !isUnanswered : codes[i] == 0u);
+			isUnanswered = isUnanswered || codes[i] == 0u;
+		}
+		ok = expect("close in flight", isClosed && isUnanswered
+				&& !client.isConnected())
+				&& ok;
+
+		// Nothing more is sent.
+		ok = expect("send after close",
+				client.getStatus().get().code == 0u)
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// N_SHOTS shots of N_SAMPLES, on every channel.
+static oi::FrameProgram makeFrame()
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+	shot.rx.nSamples = N_SAMPLES;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	oi::FrameProgram program;
+	for (uint32_t iS = 0u; iS < N_SHOTS; ++iS) {
+		program.addShot(shot);
+	}
+	program.build();
+
+	return program;
+}
+
+// Queues the frame, and waits until it is recorded.
+static bool record(oi::Client& client, const oi::FrameProgram& program)
+{
+	const auto start = std::chrono::steady_clock::now();
+	OI_STATUS status;
+	bool ok = client.queueFrame(program).get().isAck();
+
+	do {
+		ok = ok && std::chrono::steady_clock::now() - start < RECORD_TIMEOUT
+				&& client.getStatus().get().get(status);
+	} while (ok && status.state != STATE_READY);
+
+	return ok;
+}
+
+static oi::FrameResult readFrame(oi::Client& client,
+		const oi::FrameProgram& program,
+		std::vector<uint8_t> (&data)[OI_RX_N_CHIPS])
+{
+	oi::FrameBuffers buffers;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		data[iAdc].assign(program.getRawBytes(), 0u);
+		buffers.pData[iAdc] = data[iAdc].data();
+		buffers.nBytes[iAdc] = data[iAdc].size();
+	}
+
+	return client.readFrame(buffers).get();
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
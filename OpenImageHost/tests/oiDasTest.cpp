@@ -0,0 +1,277 @@
+/*
+	oiDasTest.cpp
+
+	Checks the host's delay-and-sum beamformer (oiDas.h) on a frame of
+	steered plane waves, synthesized (oiSynth.h) and deinterleaved as a
+	client would:  that every number of threads, with SIMD and without,
+	forms exactly the image of one thread without SIMD, both compounded
+	into a grid and as a line per shot; that the compounded image's
+	brightest point lies on one of the model's targets; and that plans and
+	frames that cannot be beamformed are refused.
+
+	Usage:  oiDasTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiDas.h"
+#include "oiDeinterleave.h"
+#include "oiSynth.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t N_SHOTS = 11u;
+static const uint32_t N_SAMPLES = 2400u;
+
+// Steering of the outermost plane waves, either side of straight down.
+static const double MAX_STEER_DEG = 10.0;
+
+// A cycle at the centre frequency:  half at each polarity.
+static const uint32_t HALF_CYCLE_CLOCKS = 22u;
+static const uint8_t TGC_LEVEL = 128u;
+
+static const double PI = 3.14159265358979324;
+
+// The imaged region.  Its depths are not a multiple of the SIMD width, so
+//  that every tile's tail is summed.
+static const float WIDTH_UM = 4800.0f;
+static const float DEPTH_START_UM = 5000.0f;
+static const float DEPTH_UM = 40000.0f;
+static const uint32_t N_COLUMNS = 64u;
+static const uint32_t N_DEPTH = 509u;
+
+// Threads besides one:  fewer and more than there are tiles of columns,
+//  whatever the number of processors.
+static const unsigned N_THREADS[] = { 2u, 3u, 8u };
+
+// The brightest point must lie this close to a target.
+static const double PEAK_TOLERANCE_UM = 300.0;
+
+//***********************  Local Function Declarations  **********************//
+static oi::FrameProgram makeFrame(uint32_t nShots,
+		const oi::DasGeometry& geometry);
+static oi::DasImage makeImage(uint32_t nColumns, bool isLinePerShot);
+static bool isSameForAll(const oi::FrameProgram& program,
+		const oi::DasGeometry& geometry, const oi::DasImage& shape,
+		const std::vector<float>& rf, std::vector<float>& expected);
+static double peakDistance(const std::vector<float>& image,
+		const oi::DasImage& shape, const oi::SynthModel& model);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	const oi::SynthModel model;
+	oi::DasGeometry geometry = oi::makeLinearArray(model.pitchNm);
+	geometry.speedOfSound = (float) model.speedOfSound;
+	geometry.sampleRateHz = model.sampleRateHz;
+	geometry.fNumber = 1.0f;
+	bool ok = true;
+
+	/////  Record  /////
+	// The synthesized lanes are not inverted, as the board's are.
+	const oi::FrameProgram program = makeFrame(N_SHOTS, geometry);
+	oi::ChannelMap map = oi::defaultChannelMap();
+	std::fill_n(map.isInverted, OI_N_CHAN, false);
+
+	std::vector<float> rf((std::size_t) N_SHOTS * OI_N_CHAN * N_SAMPLES);
+	std::vector<int16_t> raw[OI_RX_N_CHIPS];
+	int16_t* ppRaw[OI_RX_N_CHIPS];
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		raw[iAdc].resize((std::size_t) N_SAMPLES * oi::DEINTERLEAVE_N_LANES);
+		ppRaw[iAdc] = raw[iAdc].data();
+	}
+	for (uint32_t iShot = 0u; iShot < N_SHOTS; ++iShot) {
+		oi::synthesizeShot(ppRaw, program.getShot(iShot), model, iShot + 1u);
+		oi::deinterleave(&rf[(std::size_t) iShot * OI_N_CHAN * N_SAMPLES],
+				N_SAMPLES, ppRaw, N_SAMPLES, map);
+	}
+
+	/////  Compounded  /////
+	{
+		const oi::DasImage shape = makeImage(N_COLUMNS, false);
+		std::vector<float> image;
+		ok = expect("grid:  threads and SIMD exact",
+				isSameForAll(program, geometry, shape, rf, image))
+				&& ok;
+		ok = expect("grid:  brightest on a target",
+				peakDistance(image, shape, model) <= PEAK_TOLERANCE_UM)
+				&& ok;
+	}
+
+	/////  Line per shot  /////
+	{
+		const oi::DasImage shape = makeImage(N_SHOTS, true);
+		std::vector<float> image;
+		ok = expect("lines:  threads and SIMD exact",
+				isSameForAll(program, geometry, shape, rf, image))
+				&& ok;
+	}
+
+	/////  Refused  /////
+	{
+		oi::DasBeamformer beamformer(2u);
+		std::vector<float> image((std::size_t) N_COLUMNS * N_DEPTH);
+
+		ok = expect("beamform before plan refused",
+				!beamformer.beamform(image.data(), rf.data(), N_SAMPLES))
+				&& ok;
+		ok = expect("empty image refused",
+				!beamformer.plan(program, geometry, makeImage(0u, false)))
+				&& ok;
+		ok = expect("line per shot, wrong columns refused",
+				!beamformer.plan(program, geometry,
+					makeImage(N_SHOTS + 1u, true)))
+				&& ok;
+
+		OI_SHOT shot = program.getShot(0u);
+		shot.rx.nSamples = 1u;
+		oi::FrameProgram shortProgram;
+		shortProgram.addShot(shot);
+		ok = expect("shot of one sample refused",
+				!beamformer.plan(shortProgram, geometry,
+					makeImage(N_COLUMNS, false)))
+				&& ok;
+
+		ok = expect("short stride refused",
+				beamformer.plan(program, geometry, makeImage(N_COLUMNS, false))
+				&& !beamformer.beamform(image.data(), rf.data(),
+					N_SAMPLES - 1u))
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Plane waves steered evenly from -MAX_STEER_DEG to +MAX_STEER_DEG, as
+//  oiDasBench.  Each element's pulse starts after the clocks that steer it.
+static oi::FrameProgram makeFrame(uint32_t nShots,
+		const oi::DasGeometry& geometry)
+{
+	const double clocksPerUm = OI_TX_CLOCK_HZ / (geometry.speedOfSound * 1.0e6);
+	oi::FrameProgram program;
+
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		const double steer = nShots > 1u
+				? (-1.0 + 2.0 * iShot / (nShots - 1u))
+						* MAX_STEER_DEG * PI / 180.0
+				: 0.0;
+		const double xFirst = steer >= 0.0
+				? geometry.elementXUm[0]
+				: geometry.elementXUm[OI_N_CHAN - 1u];
+		OI_SHOT shot;
+		std::memset(&shot, 0, sizeof(shot));
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			OI_TX_CHANNEL& tx = shot.tx.channels[iChan];
+			const uint32_t delay = (uint32_t) std::lround(
+					(geometry.elementXUm[iChan] - xFirst) * std::sin(steer)
+							* clocksPerUm);
+			uint32_t n = 1u + delay;
+
+			std::fill_n(&tx.levelSequence[n], HALF_CYCLE_CLOCKS, (int8_t) 2);
+			n += HALF_CYCLE_CLOCKS;
+			std::fill_n(&tx.levelSequence[n], HALF_CYCLE_CLOCKS, (int8_t) -2);
+			n += HALF_CYCLE_CLOCKS;
+			tx.nLevelSequence = n + 1u;
+			tx.enable = 1u;
+
+			shot.rx.channels[iChan].enable = 1u;
+		}
+
+		shot.rx.nSamples = N_SAMPLES;
+		shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+			std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+		}
+
+		program.addShot(shot);
+	}
+
+	return program;
+}
+
+static oi::DasImage makeImage(uint32_t nColumns, bool isLinePerShot)
+{
+	oi::DasImage image;
+
+	for (uint32_t iCol = 0u; iCol < nColumns; ++iCol) {
+		image.columnXUm.push_back(WIDTH_UM
+				* ((iCol + 0.5f) / nColumns - 0.5f));
+	}
+	image.depthStartUm = DEPTH_START_UM;
+	image.depthStepUm = DEPTH_UM / N_DEPTH;
+	image.nDepth = N_DEPTH;
+	image.isLinePerShot = isLinePerShot;
+
+	return image;
+}
+
+// Beamforms the frame with one thread and no SIMD, into 'expected', then
+//  with each number of threads, with SIMD and without.  True if every
+//  image is bit for bit the first.
+static bool isSameForAll(const oi::FrameProgram& program,
+		const oi::DasGeometry& geometry, const oi::DasImage& shape,
+		const std::vector<float>& rf, std::vector<float>& expected)
+{
+	const std::size_t nPoints = shape.columnXUm.size() * shape.nDepth;
+	std::vector<float> image(nPoints);
+	bool ok = true;
+
+	expected.assign(nPoints, 0.0f);
+	oi::DasBeamformer reference(1u, false);
+	ok = reference.plan(program, geometry, shape)
+			&& reference.beamform(expected.data(), rf.data(), N_SAMPLES);
+
+	for (const bool isSimd : { false, true }) {
+		for (const unsigned nThreads : N_THREADS) {
+			oi::DasBeamformer beamformer(nThreads, isSimd);
+			std::fill(image.begin(), image.end(), NAN);
+			ok = ok && beamformer.getNThreads() == nThreads
+					&& beamformer.plan(program, geometry, shape)
+					&& beamformer.beamform(image.data(), rf.data(), N_SAMPLES)
+					&& std::memcmp(image.data(), expected.data(),
+						nPoints * sizeof(float)) == 0;
+		}
+	}
+
+	return ok;
+}
+
+// Distance from the brightest point of the image to the nearest target.
+static double peakDistance(const std::vector<float>& image,
+		const oi::DasImage& shape, const oi::SynthModel& model)
+{
+	std::size_t iPeak = 0u;
+	for (std::size_t i = 0u; i < image.size(); ++i) {
+		iPeak = std::fabs(image[i]) > std::fabs(image[iPeak]) ? i : iPeak;
+	}
+
+	const double
+		x = shape.columnXUm[iPeak / shape.nDepth],
+		z = shape.depthStartUm
+				+ (double) (iPeak % shape.nDepth) * shape.depthStepUm;
+	double nearest = HUGE_VAL;
+	for (const oi::SynthTarget& target : model.targets) {
+		nearest = std::min(nearest,
+				std::hypot(x - target.xUm, z - target.zUm));
+	}
+
+	return nearest;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-36s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
@@ -0,0 +1,190 @@
+/*
+	oiDeinterleaveTest.cpp
+
+	Checks the conversion of raw shots into [channel][sample] matrices
+	(oiDeinterleave.h):  the scalar version against a direct reference,
+	then each kernel that the CPU runs against the scalar version, which it
+	must match exactly, to float and to int16_t.  The map is shuffled, with
+	inversions, offsets and gains large enough to saturate, and the shots
+	are of lengths that leave each kernel every size of tail.  Padding after
+	each channel's row catches writes past it.
+
+	Usage:  oiDeinterleaveTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiDeinterleave.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+
+// Around the widths of the kernels, and one long enough for every tail.
+static const std::size_t N_SAMPLES[] = {
+	1u, 7u, 15u, 16u, 17u, 31u, 32u, 33u, 63u, 64u, 65u, 4093u
+};
+
+// Samples of padding after each channel's row, and their value.
+static const std::size_t N_PAD = 7u;
+static const int16_t PAD = 7;
+
+static const char* const ISA_NAMES[] = { "scalar", "avx2", "avx512" };
+
+//***********************  Local Function Declarations  **********************//
+static oi::ChannelMap makeCheckMap(std::mt19937& random);
+template <typename T>
+static std::vector<T> reference(
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const oi::ChannelMap& map
+);
+template <typename T>
+static bool check(
+		oi::DeinterleaveIsa isa,
+		const std::vector<T>& expected,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const oi::ChannelMap& map
+);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	const oi::DeinterleaveIsa best = oi::bestDeinterleaveIsa();
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	if (best == oi::DEINTERLEAVE_SCALAR) {
+		std::printf("no kernels on this CPU; the scalar version only\n");
+	} else {
+		// Check them.
+	}
+
+	for (std::size_t nSamples : N_SAMPLES) {
+		// Every code, in the 14 bits of the ADC, with the extremes:
+		std::vector<int16_t> raw[OI_RX_N_CHIPS];
+		const int16_t* ppRaw[OI_RX_N_CHIPS];
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			raw[iAdc].resize(nSamples * oi::DEINTERLEAVE_N_LANES);
+			for (int16_t& v : raw[iAdc]) {
+				v = (int16_t) (random() & 0xFFFCu);
+			}
+			raw[iAdc][0] = INT16_MIN;
+			raw[iAdc][1] = (int16_t) 0x7FFC;
+			ppRaw[iAdc] = raw[iAdc].data();
+		}
+
+		const oi::ChannelMap map = makeCheckMap(random);
+		const std::vector<float> toFloat = reference<float>(ppRaw, nSamples,
+				map);
+		const std::vector<int16_t> toInt16 = reference<int16_t>(ppRaw,
+				nSamples, map);
+
+		for (int isa = oi::DEINTERLEAVE_SCALAR; isa <= best; ++isa) {
+			char name[64];
+			std::snprintf(name, sizeof(name), "%s %zu samples", ISA_NAMES[isa],
+					nSamples);
+			ok = expect(name,
+					check((oi::DeinterleaveIsa) isa, toFloat, ppRaw, nSamples,
+							map)
+					&& check((oi::DeinterleaveIsa) isa, toInt16, ppRaw,
+							nSamples, map))
+					&& ok;
+		}
+	}
+
+	// A map that is not a permutation is refused.
+	{
+		oi::ChannelMap map = oi::defaultChannelMap();
+		map.channel[1][0] = map.channel[0][0];
+		const int16_t row[OI_N_CHAN] = {};
+		const int16_t* const ppRaw[OI_RX_N_CHIPS] = { row, row };
+		float out[OI_N_CHAN];
+		ok = expect("bad map refused",
+				!oi::deinterleave(out, 1u, ppRaw, 1u, map,
+						oi::DEINTERLEAVE_SCALAR))
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// The lanes shuffled, random inversions and offsets, and gains up to 16.
+static oi::ChannelMap makeCheckMap(std::mt19937& random)
+{
+	oi::ChannelMap map = oi::defaultChannelMap();
+	uint8_t* const pChannel = &map.channel[0][0];
+
+	std::shuffle(pChannel, pChannel + OI_N_CHAN, random);
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		map.isInverted[iChan] = (random() & 1u) != 0u;
+		map.offset[iChan] = (float) ((int) (random() % 2001u) - 1000) / 8.0f;
+		map.gain[iChan] = (float) (random() % 1024u) / 64.0f;
+	}
+
+	return map;
+}
+
+// Each sample as the header describes it, with the padding.
+template <typename T>
+static std::vector<T> reference(
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const oi::ChannelMap& map
+) {
+	const std::size_t stride = nSamples + N_PAD;
+	std::vector<T> out(stride * OI_N_CHAN, (T) PAD);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		for (uint32_t iLane = 0u; iLane < oi::DEINTERLEAVE_N_LANES; ++iLane) {
+			const uint32_t iChan = map.channel[iAdc][iLane];
+			for (std::size_t i = 0u; i < nSamples; ++i) {
+				const int16_t code = ppRaw[iAdc][i * oi::DEINTERLEAVE_N_LANES
+						+ iLane];
+				const float v = ((float) (map.isInverted[iChan]
+						? (int16_t) ~code : code) - map.offset[iChan])
+						* map.gain[iChan];
+				if (sizeof(T) == sizeof(int16_t)) {
+					out[iChan * stride + i] = (T) std::nearbyint(
+							std::min(std::max(v, -32768.0f), 32767.0f));
+				} else {
+					out[iChan * stride + i] = (T) v;
+				}
+			}
+		}
+	}
+
+	return out;
+}
+
+template <typename T>
+static bool check(
+		oi::DeinterleaveIsa isa,
+		const std::vector<T>& expected,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const oi::ChannelMap& map
+) {
+	std::vector<T> out(expected.size(), (T) PAD);
+
+	return oi::deinterleave(out.data(), nSamples + N_PAD, ppRaw, nSamples,
+					map, isa)
+			&& out == expected;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
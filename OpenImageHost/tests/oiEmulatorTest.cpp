@@ -0,0 +1,178 @@
+/*
+	oiEmulatorTest.cpp
+
+	Checks the headers of the shots that the emulator (oiEmulator.h)
+	records against what the firmware writes (oiAdcDma.c):  by default, as
+	without the FPGA's shot-header block, each has the magic, the frame's
+	handle, the shot's index and length, a sequence that counts the shots
+	across frames, and a timestamp of zero; with isFpgaHeader, the
+	timestamps rise from shot to shot by at least each shot's samples.
+
+	Usage:  oiEmulatorTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiClient.h"
+#include "oiEmulator.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t
+	N_FRAMES = 3u,
+	N_SHOTS = 5u,
+	N_SAMPLES = 512u;
+
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+
+//***********************  Local Function Declarations  **********************//
+static bool recordFrames(bool isFpgaHeader,
+		std::vector<OI_SHOT_HEADER>& headers);
+static oi::FrameProgram makeFrame(uint32_t handle);
+static bool record(oi::Client& client, const oi::FrameProgram& program);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	const std::size_t recordBytes = OI_RX_SHOT_RECORD_BYTES(N_SAMPLES,
+			OI_SAMPLE_FORMAT_16);
+	bool ok = true;
+
+	/////  As the firmware  /////
+	{
+		std::vector<OI_SHOT_HEADER> headers;
+		bool same = recordFrames(false, headers);
+		for (std::size_t i = 0u; i < headers.size() && same; ++i) {
+			const OI_SHOT_HEADER& h = headers[i];
+			same = h.magic == OI_SHOT_MAGIC
+					&& h.handle == i / N_SHOTS
+					&& h.iShot == i % N_SHOTS
+					&& h.nBytes == recordBytes - OI_SHOT_HEADER_BYTES
+					&& h.flags == 0u
+					&& h.sequence == headers[0].sequence + i;
+		}
+		ok = expect("headers as firmware", same) && ok;
+
+		bool isZero = !headers.empty();
+		for (const OI_SHOT_HEADER& h : headers) {
+			isZero = isZero && h.timestampLo == 0u && h.timestampHi == 0u;
+		}
+		ok = expect("no timestamps", isZero) && ok;
+	}
+
+	/////  With the FPGA's headers  /////
+	{
+		std::vector<OI_SHOT_HEADER> headers;
+		bool isRising = recordFrames(true, headers);
+		for (std::size_t i = 1u; i < headers.size() && isRising; ++i) {
+			const uint64_t
+				before = headers[i - 1u].timestampLo
+						| (uint64_t) headers[i - 1u].timestampHi << 32,
+				at = headers[i].timestampLo
+						| (uint64_t) headers[i].timestampHi << 32;
+			isRising = headers[i].magic == OI_SHOT_MAGIC
+					&& headers[i].sequence == headers[i - 1u].sequence + 1u
+					&& at >= before + N_SAMPLES;
+		}
+		ok = expect("FPGA timestamps", isRising) && ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Records N_FRAMES frames, handled 0, 1, ..., and collects the headers of
+//  their shots from the first ADC.
+static bool recordFrames(bool isFpgaHeader,
+		std::vector<OI_SHOT_HEADER>& headers)
+{
+	oi::EmulatorOptions options;
+	options.port = 0u;
+	options.isFpgaHeader = isFpgaHeader;
+	oi::Emulator emulator(options);
+	oi::Client client;
+	bool ok = emulator.start()
+			&& client.connect("127.0.0.1", emulator.getPort());
+
+	headers.clear();
+	for (uint32_t iFrame = 0u; iFrame < N_FRAMES && ok; ++iFrame) {
+		const oi::FrameProgram program = makeFrame(iFrame);
+		std::vector<uint8_t> data(program.getRawBytes());
+		oi::FrameBuffers buffers = {};
+		buffers.pData[0] = data.data();
+		buffers.nBytes[0] = data.size();
+
+		ok = record(client, program) && client.readFrame(buffers).get().ok;
+		for (uint32_t iS = 0u; iS < N_SHOTS && ok; ++iS) {
+			OI_SHOT_HEADER header;
+			std::memcpy(&header, &data[iS * data.size() / N_SHOTS],
+					sizeof(header));
+			headers.push_back(header);
+		}
+	}
+
+	return ok;
+}
+
+// N_SHOTS shots of N_SAMPLES, on every channel.
+static oi::FrameProgram makeFrame(uint32_t handle)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+	shot.rx.nSamples = N_SAMPLES;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	oi::FrameProgram program;
+	program.setHandle(handle);
+	for (uint32_t iS = 0u; iS < N_SHOTS; ++iS) {
+		program.addShot(shot);
+	}
+	program.build();
+
+	return program;
+}
+
+// Queues the frame, and waits until it is recorded.
+static bool record(oi::Client& client, const oi::FrameProgram& program)
+{
+	const auto start = std::chrono::steady_clock::now();
+	OI_STATUS status;
+	bool ok = client.queueFrame(program).get().isAck();
+
+	do {
+		ok = ok && std::chrono::steady_clock::now() - start < RECORD_TIMEOUT
+				&& client.getStatus().get().get(status);
+	} while (ok && status.state != STATE_READY);
+
+	return ok;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
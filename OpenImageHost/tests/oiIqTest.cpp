@@ -0,0 +1,239 @@
+/*
+	oiIqTest.cpp
+
+	Checks the baseband IQ demodulation (oiIqDemod.c, as built for the
+	host) against a reference in double precision that mixes with the
+	exact local oscillator and filters with the same taps, including the
+	samples at the ends of the shot.  Checks too that a tone at the centre
+	frequency comes out at its own amplitude and one outside the band is
+	rejected, for the filters that makeIqConfig designs; and that the NEON
+	path of oiIqDemod.c, built over the scalar model of the intrinsics in
+	neon/arm_neon.h, gives exactly what the scalar path gives.
+
+	Usage:  oiIqTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiIqDesign.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const double SAMPLE_RATE_HZ = 40.0e6;
+static const double PI = 3.14159265358979324;
+static const double TWO_TO_32 = 4294967296.0;
+static const uint32_t SEED = 0x4F49u;
+
+// Channels recorded by each ADC.
+static const uint32_t N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+
+static const uint32_t N_SAMPLES = 1021u;
+static const double AMPLITUDE = 6000.0;
+
+// Largest error allowed against the reference, in LSBs.  The phase of the
+//  local oscillator is truncated to its table of 2^10 entries, and each
+//  coefficient and output is rounded; with noise for input, the errors of
+//  the taps add as a random walk, to several LSBs.
+static const double MAX_ERROR = 16.0;
+
+//**********************************  Types  *********************************//
+
+struct Design {
+	double
+		centerHz,
+		bandwidthHz;
+	uint32_t
+		decimation,
+		nTaps;
+};
+
+//***********************  Local Function Declarations  **********************//
+// The NEON path of oiIqDemod.c, as built for this test (see CMakeLists.txt).
+extern "C" void oiIqDemodulateNeon(
+		int16_t* pIq,
+		const int16_t* pRf,
+		uint32_t nSamples,
+		const OI_IQ_CONFIG* pCfg
+);
+
+static std::vector<int16_t> makeTones(
+		double frequencyHz,
+		double amplitude,
+		std::mt19937& random
+);
+static double maxError(
+		const std::vector<int16_t>& rf,
+		const std::vector<int16_t>& iq,
+		const OI_IQ_CONFIG& cfg
+);
+static double meanMagnitude(
+		const std::vector<int16_t>& iq,
+		const OI_IQ_CONFIG& cfg
+);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	static const Design DESIGNS[] = {
+		{ 5.0e6, 4.0e6, 4u, OI_IQ_MAX_N_TAPS },
+		{ 7.5e6, 2.0e6, 8u, 31u },
+		{ 2.5e6, 1.0e6, OI_IQ_MAX_DECIMATION, 48u },
+		{ 47.5e6, 2.0e6, 8u, 63u },   // aliases to 7.5 MHz
+	};
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	for (const Design& d : DESIGNS) {
+		char name[64];
+		OI_IQ_CONFIG cfg;
+
+		std::snprintf(name, sizeof(name), "%4.1f MHz /%-2u %2u taps design",
+				d.centerHz / 1.0e6, d.decimation, d.nTaps);
+		const bool isDesigned = oi::makeIqConfig(cfg, SAMPLE_RATE_HZ,
+				d.centerHz, d.bandwidthHz, d.decimation, d.nTaps);
+		ok = expect(name, isDesigned) && ok;
+		if (!isDesigned) {
+			continue;
+		} else {
+			// Test it.
+		}
+
+		// Full-scale noise, against the reference:
+		std::vector<int16_t> rf(N_SAMPLES * N_LANES);
+		for (int16_t& v : rf) {
+			v = (int16_t) (random() & 0xFFFCu);
+		}
+		std::vector<int16_t> iq(oi::iqShotBytes(N_SAMPLES, cfg) / 2u);
+		oiIqDemodulate(iq.data(), rf.data(), N_SAMPLES, &cfg);
+		std::snprintf(name, sizeof(name), "%4.1f MHz /%-2u %2u taps reference",
+				d.centerHz / 1.0e6, d.decimation, d.nTaps);
+		ok = expect(name, maxError(rf, iq, cfg) <= MAX_ERROR) && ok;
+
+		// The same from the NEON path:
+		std::vector<int16_t> iqNeon(iq.size());
+		oiIqDemodulateNeon(iqNeon.data(), rf.data(), N_SAMPLES, &cfg);
+		std::snprintf(name, sizeof(name), "%4.1f MHz /%-2u %2u taps NEON",
+				d.centerHz / 1.0e6, d.decimation, d.nTaps);
+		ok = expect(name, iqNeon == iq) && ok;
+
+		// A tone at the centre keeps its amplitude:
+		rf = makeTones(d.centerHz, AMPLITUDE, random);
+		oiIqDemodulate(iq.data(), rf.data(), N_SAMPLES, &cfg);
+		std::snprintf(name, sizeof(name), "%4.1f MHz /%-2u %2u taps passband",
+				d.centerHz / 1.0e6, d.decimation, d.nTaps);
+		ok = expect(name,
+				std::fabs(meanMagnitude(iq, cfg) - AMPLITUDE)
+						<= 0.02 * AMPLITUDE)
+				&& ok;
+
+		// One well outside the band is rejected, by the longer filters:
+		if (cfg.nTaps >= 31u) {
+			rf = makeTones(d.centerHz + 3.0 * d.bandwidthHz, AMPLITUDE,
+					random);
+			oiIqDemodulate(iq.data(), rf.data(), N_SAMPLES, &cfg);
+			std::snprintf(name, sizeof(name),
+					"%4.1f MHz /%-2u %2u taps stopband",
+					d.centerHz / 1.0e6, d.decimation, d.nTaps);
+			ok = expect(name, meanMagnitude(iq, cfg) <= 0.05 * AMPLITUDE)
+					&& ok;
+		} else {
+			// No stopband to speak of.
+		}
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Interleaved shot of a tone on every lane, each of its own phase.
+static std::vector<int16_t> makeTones(
+		double frequencyHz,
+		double amplitude,
+		std::mt19937& random
+) {
+	std::vector<int16_t> rf(N_SAMPLES * N_LANES);
+	std::uniform_real_distribution<double> phase(0.0, 2.0 * PI);
+
+	for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+		const double p = phase(random);
+		for (uint32_t n = 0u; n < N_SAMPLES; ++n) {
+			rf[n * N_LANES + iLane] = (int16_t) std::lround(amplitude
+					* std::cos(2.0 * PI * frequencyHz / SAMPLE_RATE_HZ * n + p));
+		}
+	}
+
+	return rf;
+}
+
+// Largest difference of any I or Q from the reference.
+static double maxError(
+		const std::vector<int16_t>& rf,
+		const std::vector<int16_t>& iq,
+		const OI_IQ_CONFIG& cfg
+) {
+	const uint32_t
+		half = (cfg.nTaps - 1u) / 2u,
+		nOut = OI_IQ_N_OUT(N_SAMPLES, cfg.decimation);
+	const double omega = 2.0 * PI * cfg.phaseInc / TWO_TO_32;
+	double worst = 0.0;
+
+	for (uint32_t m = 0u; m < nOut; ++m) {
+		const int64_t n0 = (int64_t) m * cfg.decimation + half;
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			double i = 0.0, q = 0.0;
+			for (uint32_t k = 0u; k < cfg.nTaps; ++k) {
+				const int64_t n = n0 - k;
+				if (n >= 0 && n < (int64_t) N_SAMPLES) {
+					const double x = 2.0 * cfg.taps[k] / 32768.0
+							* rf[n * N_LANES + iLane];
+					i += x * std::cos(omega * n);
+					q -= x * std::sin(omega * n);
+				} else {
+					// Outside the shot; zero.
+				}
+			}
+			const int16_t* const pOut = &iq[(m * N_LANES + iLane) * 2u];
+			worst = std::max({ worst, std::fabs(pOut[0] - i),
+					std::fabs(pOut[1] - q) });
+		}
+	}
+
+	return worst;
+}
+
+// Mean magnitude of the outputs clear of the ends of the shot.
+static double meanMagnitude(
+		const std::vector<int16_t>& iq,
+		const OI_IQ_CONFIG& cfg
+) {
+	const uint32_t
+		nOut = OI_IQ_N_OUT(N_SAMPLES, cfg.decimation),
+		margin = cfg.nTaps / cfg.decimation + 1u;
+	double sum = 0.0;
+	uint32_t n = 0u;
+
+	for (uint32_t m = margin; m + margin < nOut; ++m) {
+		for (uint32_t iLane = 0u; iLane < N_LANES; ++iLane) {
+			const int16_t* const pOut = &iq[(m * N_LANES + iLane) * 2u];
+			sum += std::hypot((double) pOut[0], (double) pOut[1]);
+			++n;
+		}
+	}
+
+	return n != 0u ? sum / n : 0.0;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-36s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
@@ -0,0 +1,301 @@
+/*
+	oiLz4Test.cpp
+
+	Checks the FSBL's decoder of compressed partitions (xfsbl_lz4.c, as
+	built for the host):  that what lz4Compress writes comes back, however
+	the boot device cuts it up, and that malformed partitions (literals cut
+	short, matches reaching before the start of their block or of the
+	output, and runs longer than the room for them) are refused without a
+	byte written past the buffer.  Each malformed partition is fed whole
+	and a byte at a time, and has a well-formed twin that must decode, so
+	that it is the fault that is refused.
+
+	Usage:  oiLz4Test
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiLz4.h"
+
+#include "xfsbl_lz4.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+
+// Bytes after the output buffer that must not be written.
+static const uint32_t N_GUARD = 64u;
+static const uint8_t GUARD = 0xA5u;
+
+//***********************  Local Function Declarations  **********************//
+static std::vector<uint8_t> makeData(std::size_t nBytes, std::mt19937& random);
+static std::vector<uint8_t> makePartition(
+		uint32_t length,
+		const std::vector<std::vector<uint8_t>>& blocks,
+		const std::vector<bool>& isStored
+);
+static uint32_t decode(
+		const std::vector<uint8_t>& packed,
+		uint32_t outSize,
+		uint32_t chunkBytes,
+		bool& isGuardKept
+);
+static bool isRefused(const std::vector<uint8_t>& packed, uint32_t outSize);
+static bool isDecoded(const std::vector<uint8_t>& packed, uint32_t outSize);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	/////  Well formed  /////
+	// Several blocks, the last short, in the pieces of several boot devices.
+	{
+		const std::vector<uint8_t> data = makeData(
+				3u * XFSBL_LZ4_BLOCK_SIZE + 1000u, random);
+		const std::vector<uint8_t> packed = oi::lz4Compress(data.data(),
+				data.size());
+		bool same = packed.size() < data.size();
+		for (std::size_t chunk : { 1u, 7u, 4096u, 1u << 20 }) {
+			std::vector<uint8_t> out;
+			same = same && oi::lz4Decompress(out, packed.data(), packed.size(),
+					chunk) && out == data;
+		}
+		ok = expect("round trip", same) && ok;
+
+		// And into a buffer of exactly its length:
+		ok = expect("round trip guarded",
+				isDecoded(packed, (uint32_t) data.size())) && ok;
+
+		// Cut short in its last block:
+		std::vector<uint8_t> out;
+		ok = expect("truncated partition refused",
+				!oi::lz4Decompress(out, packed.data(), packed.size() - 16u,
+						4096u))
+				&& ok;
+	}
+
+	// Incompressible, so stored.
+	{
+		std::vector<uint8_t> data(XFSBL_LZ4_BLOCK_SIZE + 5u);
+		for (uint8_t& b : data) {
+			b = (uint8_t) random();
+		}
+		const std::vector<uint8_t> packed = oi::lz4Compress(data.data(),
+				data.size());
+		std::vector<uint8_t> out;
+		ok = expect("stored round trip",
+				oi::lz4Decompress(out, packed.data(), packed.size(), 512u)
+				&& out == data)
+				&& ok;
+	}
+
+	/////  Literals cut short  /////
+	// Five literals in the token, four left in the block.
+	ok = expect("literals past block refused",
+			isRefused(makePartition(4u, { { 0x50, 'a', 'b', 'c', 'd' } },
+					{ false }), 64u)
+			&& isDecoded(makePartition(4u, { { 0x40, 'a', 'b', 'c', 'd' } },
+					{ false }), 64u))
+			&& ok;
+
+	// Literals whose length goes on past the end of the block.
+	ok = expect("literal length past block",
+			isRefused(makePartition(15u, { { 0xF0 } }, { false }), 64u)
+			&& isRefused(makePartition(270u, { { 0xF0, 255u } }, { false }),
+					1024u))
+			&& ok;
+
+	/////  Matches reaching back too far  /////
+	// Offset zero, and beyond the start of the output.
+	ok = expect("zero offset refused",
+			isRefused(makePartition(9u, { { 0x40, 'a', 'b', 'c', 'd',
+					0u, 0u, 0x10, 'e' } }, { false }), 64u))
+			&& ok;
+	ok = expect("offset before output refused",
+			isRefused(makePartition(9u, { { 0x40, 'a', 'b', 'c', 'd',
+					5u, 0u, 0x10, 'e' } }, { false }), 64u)
+			&& isDecoded(makePartition(9u, { { 0x40, 'a', 'b', 'c', 'd',
+					4u, 0u, 0x10, 'e' } }, { false }), 64u))
+			&& ok;
+
+	// Beyond the start of the block, into the one before, although that
+	//  is in the buffer.
+	ok = expect("offset before block refused",
+			isRefused(makePartition(14u, { { 'a', 'b', 'c', 'd', 'e', 'f' },
+					{ 0x10, 'g', 4u, 0u, 0x30, 'h', 'i', 'j' } },
+					{ true, false }), 64u)
+			&& isDecoded(makePartition(15u, { { 'a', 'b', 'c', 'd', 'e', 'f' },
+					{ 0x40, 'g', 'h', 'i', 'j', 4u, 0u, 0x10, 'k' } },
+					{ true, false }), 64u))
+			&& ok;
+
+	/////  Output overrun  /////
+	// A match longer than the partition's length.
+	ok = expect("match past length refused",
+			isRefused(makePartition(11u, { { 0x44, 'a', 'b', 'c', 'd',
+					4u, 0u, 0x10, 'e' } }, { false }), 64u)
+			&& isDecoded(makePartition(13u, { { 0x44, 'a', 'b', 'c', 'd',
+					4u, 0u, 0x10, 'e' } }, { false }), 64u))
+			&& ok;
+
+	// A match, of a long length, longer than the buffer.
+	ok = expect("long match past buffer refused",
+			isRefused(makePartition(1000u, { { 0x1F, 'a', 1u, 0u,
+					255u, 255u, 10u, 0x10, 'b' } }, { false }), 64u)
+			&& isDecoded(makePartition(541u, { { 0x1F, 'a', 1u, 0u,
+					255u, 255u, 10u, 0x10, 'b' } }, { false }), 541u))
+			&& ok;
+
+	// Literals longer than the buffer.
+	{
+		std::vector<uint8_t> block = { 0xF0, 255u, 0u };
+		block.resize(block.size() + 15u + 255u, 'x');
+		ok = expect("literals past buffer refused",
+				isRefused(makePartition(270u, { block }, { false }), 128u)
+				&& isDecoded(makePartition(270u, { block }, { false }), 270u))
+				&& ok;
+	}
+
+	// A stored block longer than the buffer, or the partition's length.
+	{
+		const std::vector<uint8_t> block(100u, 'y');
+		ok = expect("stored past buffer refused",
+				isRefused(makePartition(100u, { block }, { true }), 99u)
+				&& isRefused(makePartition(99u, { block }, { true }), 128u)
+				&& isDecoded(makePartition(100u, { block }, { true }), 100u))
+				&& ok;
+	}
+
+	// Blocks that decode to less than the partition's length.
+	ok = expect("short partition refused",
+			isRefused(makePartition(5u, { { 0x40, 'a', 'b', 'c', 'd' } },
+					{ false }), 64u))
+			&& ok;
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Runs of a small alphabet, with repeats near and far:  compressible, but
+//  not trivially.
+static std::vector<uint8_t> makeData(std::size_t nBytes, std::mt19937& random)
+{
+	std::vector<uint8_t> data;
+
+	while (data.size() < nBytes) {
+		const std::size_t n = 4u + random() % 60u;
+		if (data.size() > 1024u && random() % 2u == 0u) {
+			const std::size_t from = data.size() - 1u - random() % 1024u;
+			for (std::size_t k = 0u; k < n; ++k) {
+				data.push_back(data[from + k]);
+			}
+		} else {
+			for (std::size_t k = 0u; k < n; ++k) {
+				data.push_back((uint8_t) ('a' + random() % 16u));
+			}
+		}
+	}
+	data.resize(nBytes);
+
+	return data;
+}
+
+// A partition of the given blocks, with 'length' in its header whatever
+//  they decode to.
+static std::vector<uint8_t> makePartition(
+		uint32_t length,
+		const std::vector<std::vector<uint8_t>>& blocks,
+		const std::vector<bool>& isStored
+) {
+	std::vector<uint8_t> packed;
+	const auto putWord = [&packed](uint32_t word) {
+		for (uint32_t i = 0u; i < 4u; ++i) {
+			packed.push_back((uint8_t) (word >> (8u * i)));
+		}
+	};
+
+	putWord(XFSBL_LZ4_MAGIC);
+	putWord(length);
+	for (std::size_t iB = 0u; iB < blocks.size(); ++iB) {
+		putWord((uint32_t) blocks[iB].size()
+				| (isStored[iB] ? XFSBL_LZ4_STORED : 0u));
+		packed.insert(packed.end(), blocks[iB].begin(), blocks[iB].end());
+	}
+	putWord(0u);
+
+	return packed;
+}
+
+// Decodes into a buffer of outSize, followed by guard bytes, handing the
+//  decoder chunkBytes at a time until it stops; returns its last result.
+static uint32_t decode(
+		const std::vector<uint8_t>& packed,
+		uint32_t outSize,
+		uint32_t chunkBytes,
+		bool& isGuardKept
+) {
+	std::vector<uint8_t> out(outSize + N_GUARD, GUARD);
+	XFsblLz4 lz4;
+	XFsbl_Lz4Init(&lz4, out.data(), outSize);
+
+	uint32_t result = XFSBL_LZ4_MORE;
+	for (std::size_t pos = 0u; pos < packed.size()
+			&& (result == XFSBL_LZ4_MORE || result == XFSBL_LZ4_BLOCK); ) {
+		const uint32_t n = (uint32_t) std::min<std::size_t>(chunkBytes,
+				packed.size() - pos);
+		uint32_t used = 0u;
+		result = XFsbl_Lz4Decode(&lz4, &packed[pos], n, &used);
+		pos += used;
+	}
+
+	isGuardKept = true;
+	for (uint32_t k = outSize; k < out.size(); ++k) {
+		isGuardKept = isGuardKept && out[k] == GUARD;
+	}
+
+	return result;
+}
+
+// Refused, whole and a byte at a time, with the guard untouched.
+static bool isRefused(const std::vector<uint8_t>& packed, uint32_t outSize)
+{
+	bool ok = true;
+
+	for (uint32_t chunk : { 1u, (uint32_t) packed.size() }) {
+		bool isGuardKept = false;
+		ok = decode(packed, outSize, chunk, isGuardKept) == XFSBL_LZ4_ERROR
+				&& isGuardKept && ok;
+	}
+
+	return ok;
+}
+
+// Decoded, whole and a byte at a time, with the guard untouched.
+static bool isDecoded(const std::vector<uint8_t>& packed, uint32_t outSize)
+{
+	bool ok = true;
+
+	for (uint32_t chunk : { 1u, (uint32_t) packed.size() }) {
+		bool isGuardKept = false;
+		ok = decode(packed, outSize, chunk, isGuardKept) == XFSBL_LZ4_DONE
+				&& isGuardKept && ok;
+	}
+
+	return ok;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
@@ -0,0 +1,164 @@
+/*
+	oiPackTest.cpp
+
+	Checks the packing of raw frame data (OI_CMD_GET_FRAME_PACKED):  that
+	what oiPack.c packs, oiPack.h unpacks exactly, for any number of rows
+	and for samples that are noisy, smooth, justified, constant or at the
+	extremes, within OI_PACK_MAX_PACKED_BYTES; that truncated data are
+	refused; and that the NEON path of oiPack.c, built over the scalar
+	model of the intrinsics in neon/arm_neon.h, packs the same bytes as
+	the scalar path.
+
+	Usage:  oiPackTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiPack.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+static const double PI = 3.14159265358979324;
+
+// Rows of the ranges packed:  one, part of a block, a block and one more,
+//  and the most that one request may cover.
+static const uint32_t N_ROWS[] = {
+	1u,
+	3u,
+	OI_PACK_BLOCK_ROWS,
+	OI_PACK_BLOCK_ROWS + 1u,
+	OI_PACK_MAX_BYTES / (oi::PACK_N_LANES * sizeof(int16_t)),
+};
+
+//**********************************  Types  *********************************//
+enum Signal {
+	SIGNAL_NOISE,     // over the whole 16-bit range
+	SIGNAL_ECHO,      // smooth, as recorded
+	SIGNAL_JUSTIFIED, // 14 bits, in the top of each word
+	SIGNAL_ZERO,
+	SIGNAL_EXTREMES,  // alternating, to escape every residual
+
+	N_SIGNALS
+};
+
+//***********************  Local Function Declarations  **********************//
+// The NEON path of oiPack.c, as built for this test (see CMakeLists.txt).
+extern "C" uint32_t oiPackEncodeNeon(
+		uint32_t* pOut,
+		const int16_t* pIn,
+		uint32_t nRows
+);
+
+static std::vector<int16_t> makeRows(Signal signal, uint32_t nRows,
+		std::mt19937& random);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	std::mt19937 random(SEED);
+	bool
+		ok = true,
+		isExact = true,
+		isBounded = true,
+		isRefused = true,
+		isSame = true;
+
+	for (uint32_t s = 0u; s < N_SIGNALS; ++s) {
+		for (const uint32_t nRows : N_ROWS) {
+			const std::vector<int16_t> rows
+				= makeRows((Signal) s, nRows, random);
+			const std::size_t maxBytes = oi::packedBytesMax(nRows);
+			std::vector<uint32_t>
+				packed(maxBytes / sizeof(uint32_t) + 1u),
+				packedNeon(packed.size());
+			std::vector<int16_t> out(rows.size());
+
+			/////  Round trip  /////
+			const std::size_t nPacked
+				= oi::packRaw(packed.data(), rows.data(), nRows);
+			isBounded = nPacked <= maxBytes && isBounded;
+			isExact = oi::unpackRaw(out.data(), nRows,
+					(const uint8_t*) packed.data(), nPacked)
+					&& out == rows && isExact;
+
+			/////  Truncated  /////
+			isRefused = !oi::unpackRaw(out.data(), nRows,
+					(const uint8_t*) packed.data(),
+					nPacked - sizeof(uint32_t))
+					&& isRefused;
+
+			/////  NEON  /////
+			const std::size_t nPackedNeon
+				= oiPackEncodeNeon(packedNeon.data(), rows.data(), nRows);
+			isSame = nPackedNeon == nPacked
+					&& std::equal(packed.begin(),
+						packed.begin() + nPacked / sizeof(uint32_t),
+						packedNeon.begin())
+					&& isSame;
+		}
+	}
+
+	ok = expect("round trip exact", isExact) && ok;
+	ok = expect("within OI_PACK_MAX_PACKED_BYTES", isBounded) && ok;
+	ok = expect("truncated refused", isRefused) && ok;
+	ok = expect("NEON as scalar", isSame) && ok;
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// nRows rows of the given signal, on every lane.
+static std::vector<int16_t> makeRows(Signal signal, uint32_t nRows,
+		std::mt19937& random)
+{
+	std::vector<int16_t> rows((std::size_t) nRows * oi::PACK_N_LANES);
+	std::normal_distribution<double> noise(0.0, 20.0);
+
+	for (std::size_t i = 0u; i < rows.size(); ++i) {
+		const uint32_t
+			iRow = (uint32_t) (i / oi::PACK_N_LANES),
+			iLane = (uint32_t) (i % oi::PACK_N_LANES);
+		const double echo = 8000.0 * std::sin(2.0 * PI * iRow / 13.0 + iLane)
+				* std::exp(-(double) iRow / 300.0) + noise(random);
+
+		switch (signal) {
+			case SIGNAL_NOISE:
+			rows[i] = (int16_t) (uint16_t) random();
+			break;
+
+			case SIGNAL_ECHO:
+			rows[i] = (int16_t) std::lround(echo);
+			break;
+
+			case SIGNAL_JUSTIFIED:
+			rows[i] = (int16_t) (std::lround(echo) * 4);
+			break;
+
+			case SIGNAL_ZERO:
+			rows[i] = 0;
+			break;
+
+			default:
+			rows[i] = (iRow + iLane) % 2u == 0u ? INT16_MIN : INT16_MAX;
+			break;
+		}
+	}
+
+	return rows;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
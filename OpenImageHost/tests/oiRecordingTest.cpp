@@ -0,0 +1,345 @@
+/*
+	oiRecordingTest.cpp
+
+	Checks recordings (oiRecording.h) of a program whose shots differ in
+	length, one of them packed:  that the header lays the frames out on
+	pages; that the program, every shot's record and every channel read
+	back as written, while the recording is being written, after its
+	writer stopped without closing it, and once it is closed; that the
+	index gives each frame's offset, time, handle and bad shots; and that
+	what is not a recording, or not in one, is refused.
+
+	Usage:  oiRecordingTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiRecording.h"
+#include "oiSamples.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const char* const PATH = "oiRecordingTest.oir";
+static const char* const COPY_PATH = "oiRecordingTest.copy.oir";
+
+static const uint32_t HANDLE = 0x1234u;
+static const uint32_t N_SHOTS = 5u;
+static const uint32_t N_FRAMES = 8u;
+
+// Frames written before the recording is first read.
+static const uint32_t N_EARLY_FRAMES = 3u;
+
+// The shot recorded in OI_SAMPLE_FORMAT_12, and the frame of which one
+//  shot's header, from ADC 1, is not good.
+static const uint32_t PACKED_SHOT = 2u;
+static const uint32_t BAD_FRAME = 5u;
+
+static const uint64_t RECEIVED_NS = 1000000u;
+
+//***********************  Local Function Declarations  **********************//
+static oi::FrameProgram makeProgram();
+static void makeFrame(std::vector<uint8_t> data[OI_RX_N_CHIPS],
+		const oi::FrameProgram& program, uint32_t iFrame);
+static int16_t sampleOf(uint32_t iFrame, uint32_t iShot, uint32_t iAdc,
+		std::size_t i);
+static bool checkFrames(const oi::RecordingReader& reader,
+		const std::vector<std::vector<uint8_t>>& frames, uint64_t iFirst);
+static bool checkIndex(const oi::RecordingReader& reader);
+static bool copyFile(const char* from, const char* to);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	const oi::FrameProgram program = makeProgram();
+	const std::size_t nRawBytes = program.getRawBytes();
+	bool ok = expect("program of shots", program.getNShots() == N_SHOTS);
+
+	// Every frame's data, each ADC's after the other:
+	std::vector<std::vector<uint8_t>> frames;
+	for (uint32_t iFrame = 0u; iFrame < N_FRAMES; ++iFrame) {
+		std::vector<uint8_t> data[OI_RX_N_CHIPS];
+		makeFrame(data, program, iFrame);
+		frames.emplace_back();
+		for (const std::vector<uint8_t>& adc : data) {
+			frames.back().insert(frames.back().end(), adc.begin(), adc.end());
+		}
+	}
+
+	/////  Write  /////
+	oi::RecordingWriter writer;
+	oi::RecordingReader reader;
+	ok = expect("created", writer.create(PATH, program)) && ok;
+
+	bool
+		isAppended = true,
+		isEarlyRead = false;
+	for (uint32_t iFrame = 0u; iFrame < N_FRAMES; ++iFrame) {
+		const uint8_t* ppData[OI_RX_N_CHIPS];
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			ppData[iAdc] = &frames[iFrame][iAdc * nRawBytes];
+		}
+		isAppended = writer.append(ppData, RECEIVED_NS + iFrame)
+				&& writer.getNFrames() == iFrame + 1u && isAppended;
+
+		// Read what there is so far:
+		if (iFrame + 1u == N_EARLY_FRAMES) {
+			isEarlyRead = reader.open(PATH)
+					&& reader.getNFrames() == N_EARLY_FRAMES
+					&& !reader.isComplete()
+					&& checkFrames(reader, frames, 0u);
+		} else {
+			// Not yet, or done.
+		}
+	}
+	ok = expect("frames appended", isAppended) && ok;
+	ok = expect("read while writing", isEarlyRead) && ok;
+
+	// The rest, as they were counted:
+	ok = expect("more read while writing",
+			reader.refresh() == N_FRAMES && !reader.isComplete()
+			&& checkFrames(reader, frames, N_EARLY_FRAMES))
+			&& ok;
+
+	// The file as the writer left it, had it stopped here:
+	const bool isCopied = writer.sync() && copyFile(PATH, COPY_PATH);
+	ok = expect("closed", writer.close() && !writer.isOpen()) && ok;
+
+	/////  Not closed  /////
+	{
+		oi::RecordingReader unclosed;
+		oi::RecordingIndexEntry entry;
+		ok = expect("read if never closed",
+				isCopied && unclosed.open(COPY_PATH)
+				&& unclosed.getNFrames() == N_FRAMES && !unclosed.isComplete()
+				&& !unclosed.getIndexEntry(0u, entry)
+				&& checkFrames(unclosed, frames, 0u))
+				&& ok;
+	}
+
+	/////  Closed  /////
+	ok = expect("complete once closed",
+			reader.refresh() == N_FRAMES && reader.isComplete())
+			&& ok;
+	ok = expect("reread when complete", checkFrames(reader, frames, 0u))
+			&& ok;
+
+	const oi::RecordingHeader& header = reader.getHeader();
+	bool isPaged = header.programOffset % oi::RECORDING_PAGE_BYTES == 0u
+			&& header.frameOffset % oi::RECORDING_PAGE_BYTES == 0u
+			&& header.frameStride % oi::RECORDING_PAGE_BYTES == 0u
+			&& header.frameOffset >= header.programOffset
+					+ N_SHOTS * sizeof(OI_SHOT);
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		isPaged = isPaged
+				&& header.adcOffset[iAdc] % oi::RECORDING_PAGE_BYTES == 0u
+				&& header.adcBytes[iAdc] == nRawBytes;
+	}
+	ok = expect("frames on pages", isPaged) && ok;
+
+	bool isProgram = reader.getProgram().getHandle() == HANDLE
+			&& reader.getProgram().getNShots() == N_SHOTS;
+	for (uint32_t iShot = 0u; iShot < N_SHOTS && isProgram; ++iShot) {
+		isProgram = std::memcmp(&reader.getProgram().getShot(iShot),
+				&program.getShot(iShot), sizeof(OI_SHOT)) == 0;
+	}
+	ok = expect("program read back", isProgram) && ok;
+	ok = expect("index", checkIndex(reader)) && ok;
+
+	/////  Packed  /////
+	ok = expect("packed shot not as samples",
+			reader.getShotRecord(0u, PACKED_SHOT, 0u) != nullptr
+			&& reader.getShotSamples(0u, PACKED_SHOT, 0u) == nullptr
+			&& reader.getChannel(0u, PACKED_SHOT, 0u,
+				oi::defaultChannelMap()).pSamples == nullptr)
+			&& ok;
+
+	/////  Refused  /////
+	{
+		oi::RecordingIndexEntry entry;
+		ok = expect("no such frame, shot or ADC",
+				reader.getShotRecord(N_FRAMES, 0u, 0u) == nullptr
+				&& reader.getShotRecord(0u, N_SHOTS, 0u) == nullptr
+				&& reader.getShotRecord(0u, 0u, OI_RX_N_CHIPS) == nullptr
+				&& reader.getChannel(0u, 0u, OI_N_CHAN,
+					oi::defaultChannelMap()).pSamples == nullptr
+				&& !reader.getIndexEntry(N_FRAMES, entry))
+				&& ok;
+
+		oi::RecordingWriter empty;
+		const uint8_t* ppData[OI_RX_N_CHIPS] = {};
+		ok = expect("empty program refused",
+				!empty.create(COPY_PATH, oi::FrameProgram())
+				&& !empty.isOpen() && !empty.append(ppData, 0u))
+				&& ok;
+
+		// A page of zeros, then no file at all:
+		std::ofstream(COPY_PATH, std::ios::binary | std::ios::trunc)
+				<< std::string(oi::RECORDING_PAGE_BYTES, '\0');
+		oi::RecordingReader other;
+		bool isRefused = !other.open(COPY_PATH) && other.getNFrames() == 0u;
+		std::remove(COPY_PATH);
+		isRefused = !other.open(COPY_PATH) && isRefused;
+		ok = expect("not a recording refused", isRefused) && ok;
+	}
+
+	reader.close();
+	std::remove(PATH);
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Shots of different lengths, none a multiple of a page, and one packed.
+static oi::FrameProgram makeProgram()
+{
+	oi::FrameProgram program;
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	program.setHandle(HANDLE);
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		shot.rx.channels[iChan].enable = 1u;
+	}
+	for (uint32_t iShot = 0u; iShot < N_SHOTS; ++iShot) {
+		shot.rx.nSamples = 1000u + 24u * iShot;
+		shot.rx.sampleFormat = iShot == PACKED_SHOT
+				? OI_SAMPLE_FORMAT_12
+				: OI_SAMPLE_FORMAT_16;
+		program.addShot(shot);
+	}
+
+	return program;
+}
+
+// Good headers, but for one shot of BAD_FRAME, and samples that identify
+//  their frame, shot, ADC and place; the packed shot's bytes likewise.
+static void makeFrame(std::vector<uint8_t> data[OI_RX_N_CHIPS],
+		const oi::FrameProgram& program, uint32_t iFrame)
+{
+	const std::vector<std::size_t> offsets
+		= oi::recordingShotOffsets(program);
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		data[iAdc].assign(program.getRawBytes(), 0u);
+		for (uint32_t iShot = 0u; iShot < program.getNShots(); ++iShot) {
+			const OI_RX& rx = program.getShot(iShot).rx;
+			const std::size_t nRecord
+				= oi::shotRecordBytes(rx.nSamples, rx.sampleFormat);
+			uint8_t* const pRecord = &data[iAdc][offsets[iShot]];
+
+			OI_SHOT_HEADER header = {};
+			header.magic = iFrame == BAD_FRAME && iAdc == 1u && iShot == 1u
+					? ~OI_SHOT_MAGIC
+					: OI_SHOT_MAGIC;
+			header.handle = iFrame;
+			header.iShot = iShot;
+			header.nBytes = (uint32_t) (nRecord - OI_SHOT_HEADER_BYTES);
+			std::memcpy(pRecord, &header, sizeof(header));
+
+			for (std::size_t i = 0u; 2u * i + 1u < header.nBytes; ++i) {
+				const int16_t value = sampleOf(iFrame, iShot, iAdc, i);
+				std::memcpy(pRecord + OI_SHOT_HEADER_BYTES + 2u * i, &value,
+						sizeof(value));
+			}
+		}
+	}
+}
+
+static int16_t sampleOf(uint32_t iFrame, uint32_t iShot, uint32_t iAdc,
+		std::size_t i)
+{
+	return (int16_t) (i * 7u + iShot * 131u + iAdc * 4099u + iFrame * 257u);
+}
+
+// The frames from iFirst to those read:  every shot's record from each ADC
+//  as written, and every channel of the 16-bit shots, through the map.
+static bool checkFrames(const oi::RecordingReader& reader,
+		const std::vector<std::vector<uint8_t>>& frames, uint64_t iFirst)
+{
+	const oi::FrameProgram& program = reader.getProgram();
+	const oi::ChannelMap map = oi::defaultChannelMap();
+	const std::vector<std::size_t> offsets
+		= oi::recordingShotOffsets(program);
+	const std::size_t nRawBytes = program.getRawBytes();
+	bool ok = iFirst < reader.getNFrames();
+
+	for (uint64_t iFrame = iFirst; iFrame < reader.getNFrames() && ok;
+			++iFrame) {
+		for (uint32_t iShot = 0u; iShot < program.getNShots() && ok; ++iShot) {
+			const OI_RX& rx = program.getShot(iShot).rx;
+			const std::size_t nRecord
+				= oi::shotRecordBytes(rx.nSamples, rx.sampleFormat);
+
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && ok; ++iAdc) {
+				const uint8_t* const pRecord
+					= reader.getShotRecord(iFrame, iShot, iAdc);
+				ok = pRecord != nullptr && std::memcmp(pRecord,
+						&frames[iFrame][iAdc * nRawBytes + offsets[iShot]],
+						nRecord) == 0;
+			}
+
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && ok
+					&& rx.sampleFormat == OI_SAMPLE_FORMAT_16; ++iAdc) {
+				for (uint32_t iLane = 0u;
+						iLane < oi::DEINTERLEAVE_N_LANES && ok; ++iLane) {
+					const oi::ChannelView view = reader.getChannel(iFrame,
+							iShot, map.channel[iAdc][iLane], map);
+					ok = view.pSamples != nullptr
+							&& view.nSamples == rx.nSamples;
+					for (std::size_t i = 0u; i < view.nSamples && ok; ++i) {
+						ok = view.pSamples[i * view.stride] == sampleOf(
+								(uint32_t) iFrame, iShot, iAdc,
+								i * oi::DEINTERLEAVE_N_LANES + iLane);
+					}
+				}
+			}
+		}
+	}
+
+	return ok;
+}
+
+// Each frame's entry:  where it was written, when it was received, its
+//  handle, and the one bad shot of BAD_FRAME.
+static bool checkIndex(const oi::RecordingReader& reader)
+{
+	const oi::RecordingHeader& header = reader.getHeader();
+	bool ok = reader.getNFrames() == N_FRAMES;
+
+	for (uint32_t iFrame = 0u; iFrame < N_FRAMES && ok; ++iFrame) {
+		oi::RecordingIndexEntry entry;
+		ok = reader.getIndexEntry(iFrame, entry)
+				&& entry.offset
+					== header.frameOffset + iFrame * header.frameStride
+				&& entry.receivedNs == RECEIVED_NS + iFrame
+				&& entry.handle == iFrame
+				&& entry.nBadShots == (iFrame == BAD_FRAME ? 1u : 0u);
+	}
+
+	return ok;
+}
+
+static bool copyFile(const char* from, const char* to)
+{
+	std::ifstream in(from, std::ios::binary);
+	std::ofstream out(to, std::ios::binary | std::ios::trunc);
+	out << in.rdbuf();
+
+	return in.good() && out.good();
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
@@ -0,0 +1,189 @@
+/*
+	oiSamplesTest.cpp
+
+	Checks the packed sample formats (oiSamples.h) against the FPGA's
+	packer:  that packSamples writes, for shots of whole beats, the bytes
+	that a beat-by-beat model of axis_sample_pack.v sends to the DMA, as
+	does its testbench (axis_sample_pack_tb.v); and that unpackSamples
+	gives back each sample's top bits, on its SIMD path and its scalar one,
+	for any number of rows.
+
+	Usage:  oiSamplesTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiSamples.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+
+// Samples in each row, and half-words in each AXI beat.
+static const uint32_t N_LANES = OI_N_CHAN / OI_RX_N_CHIPS;
+static const uint32_t BEAT_HALF_WORDS = 8u;
+
+static const uint32_t FORMATS[] = {
+	OI_SAMPLE_FORMAT_16, OI_SAMPLE_FORMAT_14, OI_SAMPLE_FORMAT_12
+};
+
+// Rows of the shots unpacked:  one, fewer than the SIMD paths take at a
+//  time, and many, of which the last is always left to the scalar path.
+static const std::size_t N_ROWS[] = { 1u, 3u, 8u, 9u, 1000u };
+
+//***********************  Local Function Declarations  **********************//
+static std::vector<uint8_t> packRtl(const std::vector<int16_t>& samples,
+		uint32_t format);
+static std::vector<int16_t> makeSamples(std::mt19937& random,
+		std::size_t nRows);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	/////  packSamples  /////
+	// As axis_sample_pack, for shots of OI_SAMPLE_FORMAT_ROWS rows and more.
+	{
+		bool same = true;
+		for (uint32_t format : FORMATS) {
+			for (std::size_t nRows = OI_SAMPLE_FORMAT_ROWS; nRows <= 64u;
+					nRows += OI_SAMPLE_FORMAT_ROWS) {
+				const std::vector<int16_t> samples
+					= makeSamples(random, nRows);
+				std::vector<uint8_t> packed(oi::sampleBytes(nRows, format));
+				same = oi::packSamples(packed.data(), samples.data(), nRows,
+						format)
+						&& packed == packRtl(samples, format) && same;
+			}
+		}
+		ok = expect("pack as axis_sample_pack", same) && ok;
+	}
+
+	/////  unpackSamples  /////
+	// Back to the top bits of each sample, through both paths.
+	{
+		bool same = true;
+		for (uint32_t format : FORMATS) {
+			const uint32_t bits = OI_SAMPLE_BITS(format);
+			const uint16_t mask = (uint16_t) (0xFFFFu << (16u - bits));
+			for (std::size_t nRows : N_ROWS) {
+				const std::vector<int16_t> samples
+					= makeSamples(random, nRows);
+				std::vector<uint8_t> packed(oi::sampleBytes(nRows, format));
+				std::vector<int16_t> unpacked(samples.size());
+				same = oi::packSamples(packed.data(), samples.data(), nRows,
+						format)
+						&& oi::unpackSamples(unpacked.data(), packed.data(),
+							nRows, format)
+						&& same;
+				for (std::size_t i = 0u; i < samples.size(); ++i) {
+					same = same && unpacked[i]
+							== (int16_t) ((uint16_t) samples[i] & mask);
+				}
+			}
+		}
+		ok = expect("unpack round trip", same) && ok;
+	}
+
+	// An unknown format.
+	{
+		int16_t sample = 0;
+		uint8_t byte = 0u;
+		ok = expect("unknown format refused",
+				!oi::packSamples(&byte, &sample, 1u, OI_N_SAMPLE_FORMATS)
+				&& !oi::unpackSamples(&sample, &byte, 1u,
+					OI_N_SAMPLE_FORMATS))
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Packs one packet of rows as axis_sample_pack.v does, beat by beat:  the
+//  kept bits of each lane, appended to the half-words held, and a beat
+//  sent whenever eight are held, or on the last row.  Beats are written
+//  little-endian, as the DMA writes them.
+static std::vector<uint8_t> packRtl(const std::vector<int16_t>& samples,
+		uint32_t format)
+{
+	const uint32_t bits = OI_SAMPLE_BITS(format);
+	const uint32_t rowHalfWords = N_LANES * bits / 16u;
+	const std::size_t nRows = samples.size() / N_LANES;
+	uint16_t acc[2u * BEAT_HALF_WORDS] = {};
+	uint32_t fill = 0u;
+	std::vector<uint8_t> out;
+
+	for (std::size_t iRow = 0u; iRow < nRows; ++iRow) {
+		// row_14 or row_12:  lane i's top bits at bits [bits*i, bits*(i+1)).
+		uint16_t row[BEAT_HALF_WORDS] = {};
+		for (uint32_t i = 0u; i < N_LANES; ++i) {
+			const uint16_t sample = (uint16_t) samples[iRow * N_LANES + i];
+			for (uint32_t t = 0u; t < bits; ++t) {
+				const uint32_t g = bits * i + t;
+				row[g / 16u] = (uint16_t) (row[g / 16u]
+						| ((sample >> (16u - bits + t)) & 1u) << (g % 16u));
+			}
+		}
+
+		// appended, total and emit.
+		for (uint32_t k = 0u; k < rowHalfWords; ++k) {
+			acc[fill + k] = (uint16_t) (acc[fill + k] | row[k]);
+		}
+		const uint32_t total = fill + rowHalfWords;
+		const bool isLast = iRow + 1u == nRows;
+
+		if (total >= BEAT_HALF_WORDS || isLast) {
+			for (uint32_t k = 0u; k < BEAT_HALF_WORDS; ++k) {
+				out.push_back((uint8_t) acc[k]);
+				out.push_back((uint8_t) (acc[k] >> 8));
+			}
+		} else {
+			// Held.
+		}
+
+		if (isLast) {
+			std::memset(acc, 0, sizeof(acc));
+			fill = 0u;
+		} else if (total >= BEAT_HALF_WORDS) {
+			std::memmove(acc, acc + BEAT_HALF_WORDS,
+					BEAT_HALF_WORDS * sizeof(acc[0]));
+			std::memset(acc + BEAT_HALF_WORDS, 0,
+					BEAT_HALF_WORDS * sizeof(acc[0]));
+			fill = total - BEAT_HALF_WORDS;
+		} else {
+			fill = total;
+		}
+	}
+
+	return out;
+}
+
+// nRows rows of random samples, over the whole 16-bit range.
+static std::vector<int16_t> makeSamples(std::mt19937& random,
+		std::size_t nRows)
+{
+	std::vector<int16_t> samples(nRows * N_LANES);
+
+	for (int16_t& sample : samples) {
+		sample = (int16_t) (uint16_t) random();
+	}
+
+	return samples;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
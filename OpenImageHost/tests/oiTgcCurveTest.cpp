@@ -0,0 +1,225 @@
+/*
+	oiTgcCurveTest.cpp
+
+	Checks the fitting of TGC curves to DAC codes (oiTgcCurve.h) against
+	the firmware's rendering of them (oiRxCompact.c):  that codes rendered
+	from random curves are nearly all fitted, and any fitted are rendered
+	back exactly; that ramps
+	which saturate the DAC, and flat tables, are fitted; and that tables
+	which would need more than OI_TGC_MAX_N_SEGMENTS are refused.  Then that
+	compactRx and oiRxExpand give back the receive description they began
+	with, and that compactRx refuses one whose TGC it cannot represent.
+
+	Usage:  oiTgcCurveTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiTgcCurve.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+
+static const uint32_t N_RANDOM_CURVES = 1000u;
+
+// Segments in the random curves.  The fit is greedy, so it is only held to
+//  finding a curve for those with room to spare, and for all but one in
+//  MAX_MISSED_PER of them.
+static const uint32_t MAX_RANDOM_SEGMENTS = OI_TGC_MAX_N_SEGMENTS / 2u;
+static const uint32_t MAX_MISSED_PER = 100u;
+
+//***********************  Local Function Declarations  **********************//
+static OI_TGC_CURVE makeRandomCurve(std::mt19937& random);
+static bool isFitExact(const uint8_t* pCodes, bool& isFitted);
+static bool isFitExact(const uint8_t* pCodes);
+static OI_RX makeRx(std::mt19937& random);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	/////  fitTgcCurve  /////
+	// Codes rendered from random curves.
+	{
+		bool same = true;
+		uint32_t nMissed = 0u;
+		for (uint32_t i = 0u; i < N_RANDOM_CURVES; ++i) {
+			const OI_TGC_CURVE curve = makeRandomCurve(random);
+			uint8_t codes[OI_RX_MAX_N_TGC];
+			bool isFitted;
+			oiTgcRender(codes, &curve);
+			same = isFitExact(codes, isFitted) && same;
+			nMissed += isFitted ? 0u : 1u;
+		}
+		std::printf("%u of %u random curves not fitted\n", nMissed,
+				N_RANDOM_CURVES);
+		ok = expect("random curves fitted",
+				same && nMissed * MAX_MISSED_PER <= N_RANDOM_CURVES)
+				&& ok;
+	}
+
+	// Flat, at both ends of the DAC and between.
+	{
+		bool same = true;
+		for (uint32_t code : { 0u, 1u, 128u, 254u, 255u }) {
+			uint8_t codes[OI_RX_MAX_N_TGC];
+			std::memset(codes, (int) code, sizeof(codes));
+			OI_TGC_CURVE curve;
+			same = isFitExact(codes) && oi::fitTgcCurve(curve, codes)
+					&& curve.nSegments == 0u && same;
+		}
+		ok = expect("flat fitted", same) && ok;
+	}
+
+	// Ramps that saturate at the top of the DAC, and bottom out at zero.
+	{
+		uint8_t up[OI_RX_MAX_N_TGC], down[OI_RX_MAX_N_TGC];
+		for (uint32_t k = 0u; k < OI_RX_MAX_N_TGC; ++k) {
+			up[k] = (uint8_t) std::min(40u + k, 255u);
+			down[k] = (uint8_t) (k < 200u ? 200u - k : 0u);
+		}
+		ok = expect("saturating ramps fitted",
+				isFitExact(up) && isFitExact(down))
+				&& ok;
+	}
+
+	// A step every point, and a sawtooth of more teeth than segments.
+	{
+		uint8_t steps[OI_RX_MAX_N_TGC], saw[OI_RX_MAX_N_TGC];
+		for (uint32_t k = 0u; k < OI_RX_MAX_N_TGC; ++k) {
+			steps[k] = (uint8_t) (k % 2u == 0u ? 10u : 200u);
+			saw[k] = (uint8_t) (k % 30u * 8u);
+		}
+		OI_TGC_CURVE curve;
+		ok = expect("too many segments refused",
+				!oi::fitTgcCurve(curve, steps) && !oi::fitTgcCurve(curve, saw))
+				&& ok;
+	}
+
+	/////  compactRx  /////
+	// Round trip, through the firmware's expansion.
+	{
+		bool same = true;
+		for (uint32_t i = 0u; i < 100u && same; ++i) {
+			const OI_RX rx = makeRx(random);
+			OI_RX_COMPACT compact;
+			OI_RX expanded;
+			std::memset(&compact, 0, sizeof(compact));
+			std::memset(&expanded, 0, sizeof(expanded));
+			same = oi::compactRx(compact, rx)
+					&& oiRxValidate(&compact) == OI_ERR_NONE;
+			oiRxExpand(&expanded, &compact);
+			same = same && std::memcmp(&expanded, &rx, sizeof(rx)) == 0;
+		}
+		ok = expect("compactRx round trip", same) && ok;
+	}
+
+	// A TGC that needs too many segments, on either ADC.
+	{
+		bool refused = true;
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			OI_RX rx = makeRx(random);
+			for (uint32_t k = 0u; k < OI_RX_MAX_N_TGC; ++k) {
+				rx.tgc[iAdc][k] = (uint8_t) (k % 2u == 0u ? 10u : 200u);
+			}
+			OI_RX_COMPACT compact;
+			refused = !oi::compactRx(compact, rx) && refused;
+		}
+		ok = expect("compactRx refuses bad TGC", refused) && ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Up to MAX_RANDOM_SEGMENTS segments, of levels anywhere in the DAC's
+//  range, that end within the table or run past it.
+static OI_TGC_CURVE makeRandomCurve(std::mt19937& random)
+{
+	OI_TGC_CURVE curve;
+	std::memset(&curve, 0, sizeof(curve));
+
+	curve.startLevel = (uint16_t) (random() % (255u * 256u + 1u));
+	curve.nSegments = (uint16_t) (random() % (MAX_RANDOM_SEGMENTS + 1u));
+	for (uint32_t iSeg = 0u; iSeg < curve.nSegments; ++iSeg) {
+		curve.segments[iSeg].duration = (uint16_t) (1u
+				+ random() % (OI_RX_MAX_N_TGC / curve.nSegments + 20u));
+		curve.segments[iSeg].endLevel
+			= (uint16_t) (random() % (255u * 256u + 1u));
+	}
+
+	return curve;
+}
+
+// If fitted, valid and rendered back to the same codes.
+static bool isFitExact(const uint8_t* pCodes, bool& isFitted)
+{
+	OI_TGC_CURVE curve;
+	OI_RX_COMPACT rx;
+	uint8_t rendered[OI_RX_MAX_N_TGC];
+	bool ok = true;
+
+	isFitted = oi::fitTgcCurve(curve, pCodes);
+	if (isFitted) {
+		std::memset(&rx, 0, sizeof(rx));
+		rx.tgc[0] = curve;
+		oiTgcRender(rendered, &curve);
+		ok = oiRxValidate(&rx) == OI_ERR_NONE
+				&& std::memcmp(rendered, pCodes, sizeof(rendered)) == 0;
+	} else {
+		// Not fitted.
+	}
+
+	return ok;
+}
+
+// Fitted, valid, and rendered back to the same codes.
+static bool isFitExact(const uint8_t* pCodes)
+{
+	bool isFitted;
+
+	return isFitExact(pCodes, isFitted) && isFitted;
+}
+
+// Every field random, and each TGC rendered from a random curve.
+static OI_RX makeRx(std::mt19937& random)
+{
+	OI_RX rx;
+	std::memset(&rx, 0, sizeof(rx));
+
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		rx.channels[iChan].enable = random() & 1u;
+	}
+	rx.nSamples = 1u + random() % 4096u;
+	rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		const OI_TGC_CURVE curve = makeRandomCurve(random);
+		rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		oiTgcRender(rx.tgc[iAdc], &curve);
+		rx.lpfMul[iAdc] = (uint8_t) random();
+		rx.lpfDiv[iAdc] = (uint8_t) random();
+		rx.lna[iAdc] = (uint8_t) random();
+		rx.pga[iAdc] = (uint8_t) random();
+		rx.hpf_divisor[iAdc] = (uint8_t) random();
+		rx.testMode[iAdc] = (uint8_t) random();
+	}
+
+	return rx;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
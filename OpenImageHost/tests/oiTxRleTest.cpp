@@ -0,0 +1,304 @@
+/*
+	oiTxRleTest.cpp
+
+	Checks that frames survive encoding into OI_FRAME_RLE and expanding as
+	the firmware does (encodeFrameRle, decodeFrameRle), and that
+	FrameProgram falls back to OI_CMD_QUEUE_FRAME, unchanged, for the
+	frames that cannot be encoded:  too many pulse shapes, a pulse shape
+	of too many runs, and a TGC waveform that no curve renders; and to
+	OI_CMD_QUEUE_FRAME_FORMATTED for such a frame of packed samples.
+
+	Usage:  oiTxRleTest
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiFrameProgram.h"
+#include "oiTgcCurve.h"
+#include "oiTxEncode.h"
+
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t SEED = 0x4F49u;
+
+// A bipolar pulse of two cycles, with its RTZ.
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 2, 2, -2, -2, 0 };
+
+static const uint32_t N_SAMPLES = 2048u;
+
+// 2 dB/usec, then 0.5 dB/usec, then held, over the 30 usec of the TGC.
+static const std::vector<oi::TgcRamp> TGC_RAMPS = {
+	{ 5.0, 2.0 }, { 15.0, 0.5 }, { 10.0, 0.0 }
+};
+static const oi::TgcCalibration TGC_CAL = { -10.0, 0.25 };
+
+//***********************  Local Function Declarations  **********************//
+static OI_SHOT makeShot(uint32_t iShot);
+static void setPulse(OI_TX_CHANNEL& channel, uint32_t delay,
+		const int8_t* pPulse, uint32_t nPulse);
+static bool sameShot(const OI_SHOT& a, const OI_SHOT& b);
+static bool roundTrip(const oi::FrameProgram& program);
+static bool expect(const char* name, bool ok);
+
+//****************************  Global Functions  ****************************//
+
+int main()
+{
+	std::mt19937 random(SEED);
+	bool ok = true;
+
+	/////  Encoded  /////
+	// A steered frame:  one pulse, delayed across the aperture, with the
+	//  TGC ramps.
+	{
+		oi::FrameProgram program;
+		for (uint32_t iS = 0u; iS < OI_MAX_N_SHOTS; ++iS) {
+			program.addShot(makeShot(iS));
+		}
+		ok = expect("steered frame encodes",
+				program.build() == OI_ERR_NONE
+				&& program.getCommand() == OI_CMD_QUEUE_FRAME_RLE)
+				&& ok;
+		ok = expect("steered frame round trip", roundTrip(program)) && ok;
+	}
+
+	// As many pulse shapes as may be shared, disabled channels, and TGC
+	//  waveforms of several segments.
+	{
+		oi::FrameProgram program;
+		for (uint32_t iS = 0u; iS < OI_TX_MAX_N_TEMPLATES; ++iS) {
+			OI_SHOT shot = makeShot(iS);
+			int8_t pulse[2u * OI_TX_MAX_N_TEMPLATES + 2u] = {};
+			for (uint32_t k = 1u; k <= 2u * iS + 1u; ++k) {
+				pulse[k] = (k & 1u) ? 1 : -1;
+			}
+			for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+				if (iC % (iS + 2u) == 0u) {
+					shot.tx.channels[iC].enable = 0u;
+				} else {
+					setPulse(shot.tx.channels[iC], iC, pulse, 2u * iS + 3u);
+				}
+			}
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+				for (uint32_t iT = 0u; iT < OI_RX_MAX_N_TGC; ++iT) {
+					shot.rx.tgc[iAdc][iT] = (uint8_t) (iT < 100u ? 20u
+							: iT < 200u ? 20u + (iT - 100u) : 120u);
+				}
+			}
+			program.addShot(shot);
+		}
+		ok = expect("shared templates encode",
+				program.build() == OI_ERR_NONE
+				&& program.getCommand() == OI_CMD_QUEUE_FRAME_RLE)
+				&& ok;
+		ok = expect("shared templates round trip", roundTrip(program)) && ok;
+	}
+
+	/////  Sent as OI_FRAME  /////
+	// One more pulse shape than there are templates.
+	{
+		oi::FrameProgram program;
+		for (uint32_t iS = 0u; iS <= OI_TX_MAX_N_TEMPLATES; ++iS) {
+			OI_SHOT shot = makeShot(iS);
+			int8_t pulse[] = { 0, 2, 2, -2, 0 };
+			pulse[2] = (int8_t) ((int) (iS % 5u) - 2);
+			pulse[3] = (int8_t) ((int) (iS / 5u) - 2);
+			setPulse(shot.tx.channels[0], 0u, pulse, sizeof(pulse));
+			program.addShot(shot);
+		}
+		ok = expect("too many templates falls back",
+				program.build() == OI_ERR_NONE
+				&& program.getCommand() == OI_CMD_QUEUE_FRAME)
+				&& ok;
+		ok = expect("too many templates round trip", roundTrip(program))
+				&& ok;
+	}
+
+	// A pulse of more runs than a template holds.
+	{
+		oi::FrameProgram program;
+		OI_SHOT shot = makeShot(0u);
+		int8_t pulse[OI_TX_MAX_N_RUNS + 3u] = {};
+		for (uint32_t k = 1u; k <= OI_TX_MAX_N_RUNS + 1u; ++k) {
+			pulse[k] = (k & 1u) ? 2 : -2;
+		}
+		setPulse(shot.tx.channels[OI_N_CHAN - 1u], 3u, pulse, sizeof(pulse));
+		program.addShot(shot);
+		ok = expect("too many runs falls back",
+				program.build() == OI_ERR_NONE
+				&& program.getCommand() == OI_CMD_QUEUE_FRAME)
+				&& ok;
+		ok = expect("too many runs round trip", roundTrip(program)) && ok;
+	}
+
+	// A TGC waveform of noise.
+	{
+		oi::FrameProgram program;
+		for (uint32_t iS = 0u; iS < 4u; ++iS) {
+			OI_SHOT shot = makeShot(iS);
+			for (uint32_t iT = 0u; iT < OI_RX_MAX_N_TGC; ++iT) {
+				shot.rx.tgc[1][iT] = (uint8_t) random();
+			}
+			program.addShot(shot);
+		}
+		ok = expect("noisy TGC falls back",
+				program.build() == OI_ERR_NONE
+				&& program.getCommand() == OI_CMD_QUEUE_FRAME)
+				&& ok;
+		ok = expect("noisy TGC round trip", roundTrip(program)) && ok;
+
+		// The same, recording 14 bits:  not a frame of version 1.
+		oi::FrameProgram packed;
+		for (uint32_t iS = 0u; iS < program.getNShots(); ++iS) {
+			OI_SHOT shot = program.getShot(iS);
+			shot.rx.sampleFormat = OI_SAMPLE_FORMAT_14;
+			packed.addShot(shot);
+		}
+		ok = expect("packed sent formatted",
+				packed.build() == OI_ERR_NONE
+				&& packed.getCommand() == OI_CMD_QUEUE_FRAME_FORMATTED
+				&& roundTrip(packed))
+				&& ok;
+
+		// Then so many shots that neither form fits in a packet.
+		while (program.addShot(program.getShot(0u))) {
+		}
+		ok = expect("oversized frame refused",
+				program.build() == OI_ERR_INCORRECT_SIZE
+				&& program.getBytes().empty())
+				&& ok;
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Shot iShot of a frame steered across the aperture.
+static OI_SHOT makeShot(uint32_t iShot)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		const uint32_t delay = (iShot & 1u) ? iC * (iShot % 7u)
+				: (OI_N_CHAN - 1u - iC) * (iShot % 7u);
+		setPulse(shot.tx.channels[iC], delay, PULSE, sizeof(PULSE));
+		shot.rx.channels[iC].enable = 1u;
+	}
+
+	// The TGC waveform of a curve, as the host would build it:
+	OI_TGC_CURVE curve;
+	oi::makeTgcCurve(curve, 6.0, TGC_RAMPS, TGC_CAL);
+
+	shot.rx.nSamples = N_SAMPLES;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		oiTgcRender(shot.rx.tgc[iAdc], &curve);
+		shot.rx.lpfMul[iAdc] = 2u;
+		shot.rx.lpfDiv[iAdc] = 3u;
+		shot.rx.lna[iAdc] = 1u;
+		shot.rx.pga[iAdc] = (uint8_t) iAdc;
+		shot.rx.hpf_divisor[iAdc] = 4u;
+	}
+
+	return shot;
+}
+
+// The pulse, after 'delay' clocks of RTZ.
+static void setPulse(OI_TX_CHANNEL& channel, uint32_t delay,
+		const int8_t* pPulse, uint32_t nPulse)
+{
+	channel.enable = 1u;
+	channel.nLevelSequence = delay + nPulse;
+	std::memset(channel.levelSequence, 0, sizeof(channel.levelSequence));
+	std::memcpy(&channel.levelSequence[delay], pPulse, nPulse);
+}
+
+// Only what the device plays and records:  a disabled channel's sequence
+//  is ignored.
+static bool sameShot(const OI_SHOT& a, const OI_SHOT& b)
+{
+	bool same = std::memcmp(a.rx.channels, b.rx.channels,
+			sizeof(a.rx.channels)) == 0
+			&& a.rx.nSamples == b.rx.nSamples
+			&& a.rx.sampleFormat == b.rx.sampleFormat;
+
+	for (uint32_t iC = 0u; same && iC < OI_N_CHAN; ++iC) {
+		const OI_TX_CHANNEL& x = a.tx.channels[iC];
+		const OI_TX_CHANNEL& y = b.tx.channels[iC];
+		same = x.enable == y.enable
+				&& (!x.enable || (x.nLevelSequence == y.nLevelSequence
+						&& std::memcmp(x.levelSequence, y.levelSequence,
+								x.nLevelSequence) == 0));
+	}
+	for (uint32_t iAdc = 0u; same && iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		same = a.rx.nTgc[iAdc] == b.rx.nTgc[iAdc]
+				&& std::memcmp(a.rx.tgc[iAdc], b.rx.tgc[iAdc],
+						a.rx.nTgc[iAdc]) == 0
+				&& a.rx.lpfMul[iAdc] == b.rx.lpfMul[iAdc]
+				&& a.rx.lpfDiv[iAdc] == b.rx.lpfDiv[iAdc]
+				&& a.rx.lna[iAdc] == b.rx.lna[iAdc]
+				&& a.rx.pga[iAdc] == b.rx.pga[iAdc]
+				&& a.rx.hpf_divisor[iAdc] == b.rx.hpf_divisor[iAdc]
+				&& a.rx.testMode[iAdc] == b.rx.testMode[iAdc];
+	}
+
+	return same;
+}
+
+// Decodes the built payload as the device would, and compares it with the
+//  shots that were added.
+static bool roundTrip(const oi::FrameProgram& program)
+{
+	const std::vector<uint8_t>& bytes = program.getBytes();
+	// The frames are too large for the stack.
+	std::unique_ptr<OI_FRAME> pFrame(new OI_FRAME);
+	std::unique_ptr<OI_FRAME_RLE> pRle(new OI_FRAME_RLE);
+	bool ok = !bytes.empty();
+
+	if (!ok) {
+		// Not built.
+	} else if (program.getCommand() == OI_CMD_QUEUE_FRAME_RLE) {
+		std::memcpy(pRle.get(), bytes.data(), bytes.size());
+		ok = bytes.size() == oi::frameBytes(*pRle);
+		if (ok) {
+			oi::decodeFrameRle(*pRle, *pFrame);
+		} else {
+			// Truncated.
+		}
+	} else if (program.getCommand() == OI_CMD_QUEUE_FRAME) {
+		// As oiShotManQueueFrame():  shots of protocol version 1.
+		std::memcpy(pFrame.get(), bytes.data(), OI_FRAME_BYTES(0u));
+		ok = bytes.size() == oi::frameV1Bytes(*pFrame);
+		for (uint32_t iS = 0u; ok && iS < pFrame->nShots; ++iS) {
+			std::memcpy(&pFrame->shots[iS], &bytes[OI_FRAME_V1_BYTES(iS)],
+					OI_SHOT_V1_BYTES);
+			pFrame->shots[iS].rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+		}
+	} else {
+		std::memcpy(pFrame.get(), bytes.data(), bytes.size());
+		ok = bytes.size() == oi::frameBytes(*pFrame);
+	}
+
+	ok = ok && pFrame->handle == program.getHandle()
+			&& pFrame->nShots == program.getNShots();
+	for (uint32_t iS = 0u; ok && iS < program.getNShots(); ++iS) {
+		ok = sameShot(pFrame->shots[iS], program.getShot(iS));
+	}
+
+	return ok;
+}
+
+static bool expect(const char* name, bool ok)
+{
+	std::printf("%-32s %s\n", name, ok ? "ok" : "FAILED");
+
+	return ok;
+}
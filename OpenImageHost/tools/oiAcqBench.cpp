@@ -0,0 +1,568 @@
+/*
+	oiAcqBench.cpp
+
+	End-to-end benchmark of acquisition over the protocol, with a device or
+	the emulator (oiEmulator.h).  The scenarios are:
+		roundtrip    a one-shot frame queued, recorded and read back; and
+		             the time from the ACK until its shot is counted,
+		             polling as fast as replies come
+		upload       a 100-shot frame, from sending to its ACK
+		download     the data of that frame, at several sizes of request
+		status       GET_STATUS alone, and behind a download
+		continuous   frames of 32 shots, each read while the next records
+	Each reports metrics, which are printed and written as JSON; given the
+	JSON of an earlier run, each metric is compared with it, and the exit
+	status is 3 if any is worse by more than REGRESSION_TOLERANCE.
+
+	Usage:  oiAcqBench host[:port] [out.json [baseline.json]]
+	where a host of "-" runs the emulator in this process.  Rates are in
+	megabytes per second (_MBps).
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiClient.h"
+#include "oiEmulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//********************************  Constants  *******************************//
+// A single-cycle pulse at a quarter of the transmit clock, as oiCapture.
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t
+	ROUNDTRIP_N_SAMPLES = 1024u,
+	ROUNDTRIP_REPS = 50u,
+	UPLOAD_N_SHOTS = 100u,
+	UPLOAD_N_SAMPLES = 1024u,
+	UPLOAD_REPS = 20u,
+	DOWNLOAD_REPS = 3u,
+	STATUS_REPS = 1000u,
+	CONTINUOUS_N_FRAMES = 20u,
+	CONTINUOUS_N_SHOTS = 32u,
+	CONTINUOUS_N_SAMPLES = 2048u;
+
+// Sizes of OI_CMD_GET_FRAME requests; each reply must fit in the device's
+//  send buffer (see ClientOptions).
+static const std::size_t DOWNLOAD_CHUNKS[] = { 1024u, 4096u, 8000u };
+
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+
+static const char USAGE[] =
+		"usage: oiAcqBench host[:port] [out.json [baseline.json]]\n"
+		"  a host of \"-\" runs the emulator in this process\n";
+
+// A metric worse than its baseline by more than this fraction fails.
+static const double REGRESSION_TOLERANCE = 0.10;
+
+//**********************************  Types  *********************************//
+struct Metric {
+	std::string name;
+	double value;
+	bool isHigherBetter;
+};
+
+using Clock = std::chrono::steady_clock;
+
+//***********************  Local Function Declarations  **********************//
+static bool runRoundtrip(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics);
+static bool runUpload(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics);
+static bool runDownload(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics);
+static bool runStatus(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics);
+static bool runContinuous(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics);
+
+static bool record(oi::Client& client, const oi::FrameProgram& program,
+		double* pAckUs, double* pFirstShotUs);
+static bool readAll(oi::Client& client, const oi::FrameProgram& program,
+		std::vector<uint8_t> (&data)[OI_RX_N_CHIPS]);
+static OI_SHOT makeShot(uint32_t nSamples);
+static oi::FrameProgram makeFrame(uint32_t nShots, uint32_t nSamples);
+static bool getStatus(oi::Client& client, OI_STATUS& status);
+static double percentile(std::vector<double> values, double p);
+static double usSince(Clock::time_point start);
+static void addLatencies(std::vector<Metric>& metrics, const char* name,
+		const std::vector<double>& us);
+static bool writeJson(const char* path, const std::string& target,
+		const std::vector<Metric>& metrics);
+static bool compare(const char* path, const std::vector<Metric>& metrics);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && (std::strcmp(argv[1], "-h") == 0
+			|| std::strcmp(argv[1], "--help") == 0)) {
+		std::fputs(USAGE, stdout);
+		return 0;
+	} else if (argc < 2 || argc > 4 || argv[1][0] == '\0'
+			|| (argv[1][0] == '-' && argv[1][1] != '\0')) {
+		std::fputs(USAGE, stderr);
+		return 2;
+	} else {
+		// Ok.
+	}
+
+	std::string host = argv[1];
+	uint16_t port = OI_TCP_PORT;
+	std::unique_ptr<oi::Emulator> pEmulator;
+
+	if (host == "-") {
+		oi::EmulatorOptions options;
+		options.port = 0u;
+		pEmulator.reset(new oi::Emulator(options));
+		if (!pEmulator->start()) {
+			std::fprintf(stderr, "cannot start the emulator\n");
+			return 1;
+		} else {
+			host = "127.0.0.1";
+			port = pEmulator->getPort();
+		}
+	} else if (host.find(':') != std::string::npos) {
+		const std::string portText = host.substr(host.rfind(':') + 1u);
+		char* pEnd;
+		const unsigned long value = std::strtoul(portText.c_str(), &pEnd, 10);
+		host.erase(host.rfind(':'));
+		if (portText.empty() || *pEnd != '\0' || value == 0u
+				|| value > UINT16_MAX || host.empty()) {
+			std::fprintf(stderr, "bad host or port: %s\n", argv[1]);
+			return 2;
+		} else {
+			port = (uint16_t) value;
+		}
+	} else {
+		// The device's port.
+	}
+
+	std::vector<Metric> metrics;
+	const bool ok = runRoundtrip(host, port, metrics)
+			&& runUpload(host, port, metrics)
+			&& runDownload(host, port, metrics)
+			&& runStatus(host, port, metrics)
+			&& runContinuous(host, port, metrics);
+
+	for (const Metric& m : metrics) {
+		std::printf("%-28s %12.1f\n", m.name.c_str(), m.value);
+	}
+	if (!ok) {
+		std::fprintf(stderr, "a scenario failed\n");
+		return 1;
+	} else if (argc > 2 && !writeJson(argv[2], argv[1], metrics)) {
+		std::fprintf(stderr, "cannot write %s\n", argv[2]);
+		return 1;
+	} else if (argc > 3) {
+		return compare(argv[3], metrics) ? 0 : 3;
+	} else {
+		return 0;
+	}
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static bool runRoundtrip(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics)
+{
+	oi::Client client;
+	oi::FrameProgram program = makeFrame(1u, ROUNDTRIP_N_SAMPLES);
+	std::vector<uint8_t> data[OI_RX_N_CHIPS];
+	std::vector<double> roundtrip, firstShot;
+	bool ok = client.connect(host, port);
+
+	for (uint32_t iRep = 0u; iRep < ROUNDTRIP_REPS && ok; ++iRep) {
+		const Clock::time_point start = Clock::now();
+		double firstShotUs = 0.0;
+
+		program.setHandle(iRep);
+		program.build();
+		ok = record(client, program, nullptr, &firstShotUs)
+				&& readAll(client, program, data);
+		if (iRep > 0u) {
+			roundtrip.push_back(usSince(start));
+			firstShot.push_back(firstShotUs);
+		} else {
+			// Warms up both ends.
+		}
+	}
+
+	if (ok) {
+		addLatencies(metrics, "roundtrip", roundtrip);
+		addLatencies(metrics, "arm_to_first_shot", firstShot);
+	} else {
+		std::fprintf(stderr, "roundtrip failed\n");
+	}
+
+	return ok;
+}
+
+static bool runUpload(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics)
+{
+	oi::Client client;
+	oi::FrameProgram program = makeFrame(UPLOAD_N_SHOTS, UPLOAD_N_SAMPLES);
+	std::vector<double> upload;
+	bool ok = client.connect(host, port);
+
+	for (uint32_t iRep = 0u; iRep < UPLOAD_REPS && ok; ++iRep) {
+		double ackUs;
+
+		program.setHandle(iRep);
+		program.build();
+		ok = record(client, program, &ackUs, nullptr);
+		upload.push_back(ackUs);
+	}
+
+	if (ok) {
+		addLatencies(metrics, "upload_100_shots", upload);
+		metrics.push_back({ "upload_100_shots_bytes",
+				(double) program.getBytes().size(), false });
+	} else {
+		std::fprintf(stderr, "upload failed\n");
+	}
+
+	return ok;
+}
+
+// Reads the 100-shot frame left by runUpload.
+static bool runDownload(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics)
+{
+	const oi::FrameProgram program = makeFrame(UPLOAD_N_SHOTS,
+			UPLOAD_N_SAMPLES);
+	std::vector<uint8_t> data[OI_RX_N_CHIPS];
+	bool ok = true;
+
+	for (std::size_t chunk : DOWNLOAD_CHUNKS) {
+		oi::ClientOptions options;
+		options.chunkBytes = chunk;
+		oi::Client client(options);
+		ok = ok && client.connect(host, port);
+
+		const Clock::time_point start = Clock::now();
+		for (uint32_t iRep = 0u; iRep < DOWNLOAD_REPS && ok; ++iRep) {
+			ok = readAll(client, program, data);
+		}
+		const double us = usSince(start);
+
+		if (ok) {
+			metrics.push_back({ "download_" + std::to_string(chunk) + "_MBps",
+					DOWNLOAD_REPS * OI_RX_N_CHIPS * program.getRawBytes() / us,
+					true });
+		} else {
+			std::fprintf(stderr, "download of %zu-byte pieces failed\n", chunk);
+		}
+	}
+
+	return ok;
+}
+
+// Latency of GET_STATUS alone, and while the frame left by runUpload is
+//  read on the same connection, so that each waits behind frame data.
+static bool runStatus(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics)
+{
+	const oi::FrameProgram program = makeFrame(UPLOAD_N_SHOTS,
+			UPLOAD_N_SAMPLES);
+	oi::Client client;
+	std::vector<double> idle, loaded;
+	OI_STATUS status;
+	bool ok = client.connect(host, port);
+
+	for (uint32_t iRep = 0u; iRep < STATUS_REPS && ok; ++iRep) {
+		const Clock::time_point start = Clock::now();
+		ok = getStatus(client, status);
+		idle.push_back(usSince(start));
+	}
+
+	std::vector<uint8_t> data[OI_RX_N_CHIPS];
+	oi::FrameBuffers buffers;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		data[iAdc].resize(program.getRawBytes());
+		buffers.pData[iAdc] = data[iAdc].data();
+		buffers.nBytes[iAdc] = data[iAdc].size();
+	}
+	for (uint32_t iRep = 0u; iRep < DOWNLOAD_REPS && ok; ++iRep) {
+		std::future<oi::FrameResult> read = client.readFrame(buffers);
+
+		while (ok && read.wait_for(std::chrono::seconds(0))
+				!= std::future_status::ready) {
+			const Clock::time_point start = Clock::now();
+			ok = getStatus(client, status);
+			loaded.push_back(usSince(start));
+		}
+		ok = ok && read.get().ok;
+	}
+
+	if (ok) {
+		addLatencies(metrics, "status_idle", idle);
+		addLatencies(metrics, "status_loaded", loaded);
+	} else {
+		std::fprintf(stderr, "status failed\n");
+	}
+
+	return ok;
+}
+
+// As oiCapture:  each frame's data are read while the next is queued and
+//  recorded.
+static bool runContinuous(const std::string& host, uint16_t port,
+		std::vector<Metric>& metrics)
+{
+	oi::Client client;
+	oi::FrameProgram program = makeFrame(CONTINUOUS_N_SHOTS,
+			CONTINUOUS_N_SAMPLES);
+	const std::size_t nBytes = program.getRawBytes();
+	std::vector<uint8_t> data[2][OI_RX_N_CHIPS];
+	std::future<oi::FrameResult> reads[2];
+	bool ok = client.connect(host, port);
+
+	const Clock::time_point start = Clock::now();
+	for (uint32_t iF = 0u; iF <= CONTINUOUS_N_FRAMES && ok; ++iF) {
+		const uint32_t iBuf = iF & 1u;
+
+		if (iF < CONTINUOUS_N_FRAMES) {
+			program.setHandle(iF);
+			program.build();
+			ok = record(client, program, nullptr, nullptr);
+
+			oi::FrameBuffers buffers;
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+				data[iBuf][iAdc].resize(nBytes);
+				buffers.pData[iAdc] = data[iBuf][iAdc].data();
+				buffers.nBytes[iAdc] = nBytes;
+			}
+			if (ok) {
+				reads[iBuf] = client.readFrame(buffers);
+			} else {
+				// Not recorded.
+			}
+		} else {
+			// The last frame is being read.
+		}
+
+		if (iF > 0u && ok) {
+			ok = reads[iBuf ^ 1u].get().ok;
+		} else {
+			// Nothing read yet.
+		}
+	}
+	const double seconds = usSince(start) / 1.0e6;
+
+	if (ok) {
+		metrics.push_back({ "continuous_prf_hz",
+				CONTINUOUS_N_FRAMES * CONTINUOUS_N_SHOTS / seconds, true });
+		metrics.push_back({ "continuous_frames_per_s",
+				CONTINUOUS_N_FRAMES / seconds, true });
+		metrics.push_back({ "continuous_MBps",
+				CONTINUOUS_N_FRAMES * OI_RX_N_CHIPS * nBytes / seconds / 1.0e6,
+				true });
+	} else {
+		std::fprintf(stderr, "continuous failed\n");
+	}
+
+	return ok;
+}
+
+// Queues a built frame and polls until it is recorded, as fast as the
+//  replies come.  Optionally gives the time to the ACK, and from the ACK
+//  until the first shot was seen to be counted:  an upper bound on the
+//  time from arming to the end of that shot.
+static bool record(oi::Client& client, const oi::FrameProgram& program,
+		double* pAckUs, double* pFirstShotUs)
+{
+	OI_STATUS status;
+	bool ok = getStatus(client, status);
+	const uint32_t before = status.nShots;
+
+	const Clock::time_point start = Clock::now();
+	ok = ok && client.queueFrame(program).get().isAck();
+	const Clock::time_point acked = Clock::now();
+	if (pAckUs != nullptr) {
+		*pAckUs = usSince(start);
+	} else {
+		// Not wanted.
+	}
+
+	bool isFirstSeen = false;
+	while (ok && (status.state != STATE_READY
+			|| (int32_t) (status.nShots - before - program.getNShots()) < 0)) {
+		ok = Clock::now() - start < RECORD_TIMEOUT
+				&& getStatus(client, status);
+		if (ok && !isFirstSeen && status.nShots != before) {
+			isFirstSeen = true;
+			if (pFirstShotUs != nullptr) {
+				*pFirstShotUs = usSince(acked);
+			} else {
+				// Not wanted.
+			}
+		} else {
+			// Not yet, or already seen.
+		}
+	}
+
+	return ok;
+}
+
+static bool readAll(oi::Client& client, const oi::FrameProgram& program,
+		std::vector<uint8_t> (&data)[OI_RX_N_CHIPS])
+{
+	oi::FrameBuffers buffers;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		data[iAdc].resize(program.getRawBytes());
+		buffers.pData[iAdc] = data[iAdc].data();
+		buffers.nBytes[iAdc] = data[iAdc].size();
+	}
+
+	return client.readFrame(buffers).get().ok;
+}
+
+static OI_SHOT makeShot(uint32_t nSamples)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+
+	shot.rx.nSamples = nSamples;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	return shot;
+}
+
+static oi::FrameProgram makeFrame(uint32_t nShots, uint32_t nSamples)
+{
+	oi::FrameProgram program;
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		program.addShot(makeShot(nSamples));
+	}
+	program.build();
+
+	return program;
+}
+
+static bool getStatus(oi::Client& client, OI_STATUS& status)
+{
+	return client.getStatus().get().get(status);
+}
+
+// The nearest-rank percentile, p in (0, 1].
+static double percentile(std::vector<double> values, double p)
+{
+	double result = 0.0;
+
+	if (!values.empty()) {
+		const std::size_t rank = (std::size_t) std::ceil(p * values.size());
+		std::nth_element(values.begin(), values.begin() + (rank - 1u),
+				values.end());
+		result = values[rank - 1u];
+	} else {
+		// No samples.
+	}
+
+	return result;
+}
+
+static double usSince(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(
+			Clock::now() - start).count();
+}
+
+static void addLatencies(std::vector<Metric>& metrics, const char* name,
+		const std::vector<double>& us)
+{
+	metrics.push_back({ std::string(name) + "_p50_us", percentile(us, 0.50),
+			false });
+	metrics.push_back({ std::string(name) + "_p99_us", percentile(us, 0.99),
+			false });
+}
+
+static bool writeJson(const char* path, const std::string& target,
+		const std::vector<Metric>& metrics)
+{
+	std::FILE* const pFile = std::fopen(path, "w");
+
+	if (pFile != nullptr) {
+		std::fprintf(pFile, "{\n  \"tool\": \"oiAcqBench\",\n"
+				"  \"target\": \"%s\",\n  \"metrics\": {\n", target.c_str());
+		for (std::size_t i = 0u; i < metrics.size(); ++i) {
+			std::fprintf(pFile, "    \"%s\": %.3f%s\n", metrics[i].name.c_str(),
+					metrics[i].value, i + 1u < metrics.size() ? "," : "");
+		}
+		std::fprintf(pFile, "  }\n}\n");
+		std::fclose(pFile);
+	} else {
+		// Cannot write.
+	}
+
+	return pFile != nullptr;
+}
+
+// Compares each metric with that of the same name in the JSON written by an
+//  earlier run.  Returns false if any is worse beyond the tolerance.
+static bool compare(const char* path, const std::vector<Metric>& metrics)
+{
+	std::FILE* const pFile = std::fopen(path, "r");
+	const bool isRead = pFile != nullptr;
+	std::string json;
+	bool ok = isRead;
+
+	if (isRead) {
+		char buffer[4096];
+		std::size_t n;
+		while ((n = std::fread(buffer, 1u, sizeof(buffer), pFile)) > 0u) {
+			json.append(buffer, n);
+		}
+		std::fclose(pFile);
+	} else {
+		std::fprintf(stderr, "cannot read %s\n", path);
+	}
+
+	std::printf("\n%-28s %12s %12s %8s\n", "vs. baseline", "was", "now",
+			"change");
+	for (std::size_t i = 0u; i < metrics.size() && isRead; ++i) {
+		const Metric& m = metrics[i];
+		const std::size_t at = json.find("\"" + m.name + "\":");
+
+		if (at == std::string::npos) {
+			std::printf("%-28s %12s %12.1f\n", m.name.c_str(), "-", m.value);
+		} else {
+			const double
+				was = std::strtod(&json[at + m.name.size() + 3u], nullptr),
+				change = was != 0.0 ? (m.value - was) / was : 0.0,
+				worse = m.isHigherBetter ? -change : change;
+			const bool isRegressed = worse > REGRESSION_TOLERANCE;
+
+			std::printf("%-28s %12.1f %12.1f %+7.1f%%%s\n", m.name.c_str(),
+					was, m.value, 100.0 * change,
+					isRegressed ? "  WORSE" : "");
+			ok = ok && !isRegressed;
+		}
+	}
+
+	return ok;
+}
@@ -0,0 +1,238 @@
+/*
+	oiArrayBench.cpp
+
+	Acquires frames from several units as one array (oiAggregator.h), with
+	devices or emulators, and reports the rate of frames and of data, the
+	time to arm every unit, and how far the units' shots drifted apart.
+	Units that do not timestamp their shots cannot be aligned, so their
+	frames fail; the emulators run here timestamp theirs.
+	Each shot leaves one element of the array silent, a different one for
+	each shot, so the merged frame shows whether each unit's channels land
+	in the right rows:  that element must record nothing, and every other
+	must record something.  A silent element's row is constant, whether
+	or not its lane is inverted.
+
+	Usage:  oiArrayBench units [nFrames [nShots [nSamples]]]
+	where units is either a number of emulators to run in this process, or
+	the units' host[:port]s, separated by commas; e.g., with
+	"oiEmulator 26001 &  oiEmulator 26002 &", 127.0.0.1:26001,127.0.0.1:26002.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiAggregator.h"
+#include "oiEmulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+//********************************  Constants  *******************************//
+// A single-cycle pulse at a quarter of the transmit clock, as oiCapture.
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t DEFAULT_N_FRAMES = 20u;
+static const uint32_t DEFAULT_N_SHOTS = 32u;
+static const uint32_t DEFAULT_N_SAMPLES = 2048u;
+
+//***********************  Local Function Declarations  **********************//
+static std::vector<std::string> splitHosts(const char* list);
+static oi::ArrayProgram makeFrame(uint32_t nUnits, uint32_t nShots,
+		uint32_t nSamples);
+static uint32_t countMisplaced(const std::vector<int16_t>& frame,
+		uint32_t nElements, uint32_t nShots, uint32_t nSamples);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		std::fprintf(stderr, "usage: oiArrayBench units "
+				"[nFrames [nShots [nSamples]]]\n");
+		return 2;
+	} else {
+		// Ok.
+	}
+
+	const uint32_t
+		nFrames = argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 0)
+				: DEFAULT_N_FRAMES,
+		nShots = argc > 3 ? (uint32_t) std::strtoul(argv[3], nullptr, 0)
+				: DEFAULT_N_SHOTS,
+		nSamples = argc > 4 ? (uint32_t) std::strtoul(argv[4], nullptr, 0)
+				: DEFAULT_N_SAMPLES;
+
+	/////  Units  /////
+	std::vector<std::string> hosts;
+	std::vector<std::unique_ptr<oi::Emulator>> emulators;
+	char* pEnd;
+	const uint32_t nEmulators = (uint32_t) std::strtoul(argv[1], &pEnd, 10);
+	if (*pEnd != '\0' || nEmulators == 0u) {
+		hosts = splitHosts(argv[1]);
+	} else {
+		for (uint32_t iUnit = 0u; iUnit < nEmulators; ++iUnit) {
+			oi::EmulatorOptions options;
+			options.port = 0u;
+			options.seed = iUnit + 1u;
+			options.isFpgaHeader = true;
+			emulators.emplace_back(new oi::Emulator(options));
+			if (!emulators.back()->start()) {
+				std::fprintf(stderr, "cannot start an emulator\n");
+				return 1;
+			} else {
+				hosts.push_back("127.0.0.1:"
+						+ std::to_string(emulators.back()->getPort()));
+			}
+		}
+	}
+
+	oi::Aggregator aggregator;
+	if (!aggregator.connect(hosts)) {
+		std::fprintf(stderr, "cannot connect to every unit\n");
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	oi::ArrayProgram program = makeFrame(aggregator.getNUnits(), nShots,
+			nSamples);
+	if (program.build() != OI_ERR_NONE) {
+		std::fprintf(stderr, "bad frame\n");
+		return 1;
+	} else {
+		std::printf("%u units, %u elements:  %u frames of %u shots of %u "
+				"samples\n", program.getNUnits(), program.getNElements(),
+				nFrames, nShots, nSamples);
+	}
+
+	/////  Acquire  /////
+	const uint32_t nElements = program.getNElements();
+	std::vector<int16_t> frame((std::size_t) nShots * nElements * nSamples);
+	uint32_t
+		nFailed = 0u,
+		nBadShots = 0u,
+		nMisaligned = 0u,
+		maxSkewClocks = 0u,
+		nMisplaced = 0u,
+		nUntimed = 0u;
+	double
+		armUs = 0.0,
+		maxArmUs = 0.0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t iF = 0u; iF < nFrames; ++iF) {
+		program.setHandle(iF);
+		program.build();
+
+		const oi::ArrayResult result = aggregator.acquire(program,
+				frame.data(), nSamples);
+		nFailed += result.ok ? 0u : 1u;
+		nBadShots += result.nBadShots;
+		nMisaligned += result.nMisaligned;
+		nUntimed += result.isTimed ? 0u : 1u;
+		maxSkewClocks = std::max(maxSkewClocks, result.maxSkewClocks);
+		armUs += result.armUs;
+		maxArmUs = std::max(maxArmUs, result.armUs);
+		nMisplaced += countMisplaced(frame, nElements, nShots, nSamples);
+	}
+	const double seconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+
+	const double nBytes = (double) nFrames * program.getNUnits()
+			* OI_RX_N_CHIPS * program.getUnit(0u).getRawBytes();
+	std::printf("%.1f frames/s  %.1f MB/s  arm %.0f us (most %.0f)  skew %u "
+			"clocks\n", nFrames / seconds, nBytes / seconds / 1.0e6,
+			nFrames > 0u ? armUs / nFrames : 0.0, maxArmUs, maxSkewClocks);
+	std::printf("failed %u  bad shots %u  misaligned %u  misplaced %u\n",
+			nFailed, nBadShots, nMisaligned, nMisplaced);
+	if (nUntimed > 0u) {
+		std::fprintf(stderr, "WARNING:  %u frames had shots without "
+				"timestamps (no shot-header block in the bitstream); their "
+				"alignment was not checked\n", nUntimed);
+	} else {
+		// Every frame aligned.
+	}
+
+	aggregator.close();
+
+	return nFailed == 0u && nMisplaced == 0u ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static std::vector<std::string> splitHosts(const char* list)
+{
+	std::vector<std::string> hosts;
+	const std::string s = list;
+	std::size_t first = 0u;
+
+	for (std::size_t comma = s.find(','); comma != std::string::npos;
+			comma = s.find(',', first)) {
+		hosts.push_back(s.substr(first, comma - first));
+		first = comma + 1u;
+	}
+	hosts.push_back(s.substr(first));
+
+	return hosts;
+}
+
+// Every element fires; shot s records on every element but s % nElements.
+static oi::ArrayProgram makeFrame(uint32_t nUnits, uint32_t nShots,
+		uint32_t nSamples)
+{
+	oi::ArrayProgram program(nUnits);
+	const uint32_t nElements = program.getNElements();
+
+	OI_SHOT settings;
+	std::memset(&settings, 0, sizeof(settings));
+	settings.rx.nSamples = nSamples;
+	settings.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		settings.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(settings.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	std::vector<OI_TX_CHANNEL> tx(nElements);
+	std::vector<OI_RX_CHANNEL> rx(nElements);
+	for (OI_TX_CHANNEL& channel : tx) {
+		std::memset(&channel, 0, sizeof(channel));
+		channel.enable = 1u;
+		channel.nLevelSequence = sizeof(PULSE);
+		std::memcpy(channel.levelSequence, PULSE, sizeof(PULSE));
+	}
+
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		for (uint32_t iE = 0u; iE < nElements; ++iE) {
+			rx[iE].enable = iE != iS % nElements ? 1u : 0u;
+		}
+		program.addShot(settings, tx.data(), rx.data());
+	}
+
+	return program;
+}
+
+// Elements whose rows are constant when they should record, or the
+//  reverse.
+static uint32_t countMisplaced(const std::vector<int16_t>& frame,
+		uint32_t nElements, uint32_t nShots, uint32_t nSamples)
+{
+	uint32_t nMisplaced = 0u;
+
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		for (uint32_t iE = 0u; iE < nElements; ++iE) {
+			const int16_t* const pRow
+				= &frame[((std::size_t) iS * nElements + iE) * nSamples];
+			const bool isSilent = std::all_of(pRow, pRow + nSamples,
+					[pRow](int16_t v) { return v == pRow[0]; });
+			nMisplaced += isSilent != (iE == iS % nElements) ? 1u : 0u;
+		}
+	}
+
+	return nMisplaced;
+}
@@ -0,0 +1,218 @@
+/*
+	oiBModeBench.cpp
+
+	Time per frame of the host's B-mode conversion (oiBMode.h), for a sector
+	and a linear scan into several sizes of image, against the period of
+	the frame that the lines come from.  Conversions that take less are
+	marked.
+
+	The lines are a synthesized echo in uniform noise.  That the images
+	are right is checked by oiBModeTest.
+
+	Usage:  oiBModeBench [nLines [nSamples]]
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiBMode.h"
+#include "oiEmulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t DEFAULT_N_LINES = 64u;
+static const uint32_t DEFAULT_N_SAMPLES = 2400u;
+
+static const double SAMPLE_RATE_HZ = 40.0e6;
+static const float SPEED_OF_SOUND = 1540.0f;
+static const double PI = 3.14159265358979324;
+
+// The echo:  a Gaussian-windowed burst at the centre frequency, on the
+//  middle line and those either side, at ECHO_DEPTH of the recording.
+static const double CENTRE_HZ = 5.0e6;
+static const double BURST_SAMPLES = 6.0;
+static const float ECHO_AMPLITUDE = 1000.0f;
+static const double ECHO_DEPTH = 0.6;
+static const float NOISE_AMPLITUDE = 1.0f;
+
+// The sector's lines fan over this, from one point at the array's centre;
+//  the linear scan's cover this width.
+static const float SECTOR_DEG = 60.0f;
+static const float LINEAR_WIDTH_UM = 19200.0f;
+
+static const uint32_t SIZES[] = { 256u, 512u, 1024u };    // square images
+
+// Repeat each measurement for at least this long.
+static const double MIN_TIMED_SECONDS = 0.5;
+
+//***********************  Local Function Declarations  **********************//
+static std::vector<float> makeLines(uint32_t nLines, uint32_t nSamples);
+static oi::ScanGrid makeGrid(const oi::ScanGeometry& geometry, uint32_t size);
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	const uint32_t
+		nLines = argc > 1
+				? (uint32_t) std::strtoul(argv[1], nullptr, 0)
+				: DEFAULT_N_LINES,
+		nSamples = argc > 2
+				? (uint32_t) std::strtoul(argv[2], nullptr, 0)
+				: DEFAULT_N_SAMPLES;
+
+	if (nLines < 3u || nLines > OI_MAX_N_SHOTS || nSamples < 2u) {
+		std::fprintf(stderr, "between 3 and %u lines, of 2 or more samples\n",
+				OI_MAX_N_SHOTS);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	// A line per shot, as the device records them.
+	oi::FrameProgram program;
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+	shot.rx.nSamples = nSamples;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iLine = 0u; iLine < nLines; ++iLine) {
+		program.addShot(shot);
+	}
+
+	oi::ScanGeometry sector = oi::scanOfFrame(program, SPEED_OF_SOUND,
+			SAMPLE_RATE_HZ);
+	oi::ScanGeometry linear = sector;
+	for (uint32_t iLine = 0u; iLine < nLines; ++iLine) {
+		const float f = (float) iLine / (nLines - 1u) - 0.5f;
+		sector.angleDeg[iLine] = f * SECTOR_DEG;
+		linear.originXUm[iLine] = f * LINEAR_WIDTH_UM;
+	}
+	const struct {
+		const char* name;
+		const oi::ScanGeometry& geometry;
+	} scans[] = {
+		{ "sector", sector },
+		{ "linear", linear },
+	};
+
+	const std::vector<float> lines = makeLines(nLines, nSamples);
+	const oi::BModeCompression compression;
+	const double periodMs = 1.0e3 * nLines * (nSamples / SAMPLE_RATE_HZ
+			+ oi::EmulatorOptions().shotSetupUs * 1.0e-6);
+
+	std::printf("%u lines of %u samples:  the device records a frame every "
+			"%.2f ms\n", nLines, nSamples, periodMs);
+
+	/////  Time  /////
+	std::printf("%-8s %-10s %8s %9s %9s\n", "scan", "image", "plan ms",
+			"scalar ms", "SIMD ms");
+	for (const auto& scan : scans) {
+		for (const uint32_t size : SIZES) {
+			const oi::ScanGrid grid = makeGrid(scan.geometry, size);
+			std::vector<uint8_t> image((std::size_t) size * size);
+			char name[32];
+
+			std::snprintf(name, sizeof(name), "%ux%u", size, size);
+			std::printf("%-8s %-10s", scan.name, name);
+
+			for (const bool isSimd : { false, true }) {
+				oi::BModeConverter converter(isSimd);
+
+				const auto planStart = std::chrono::steady_clock::now();
+				converter.plan(scan.geometry, grid);
+				if (!isSimd) {
+					std::printf(" %8.1f", secondsSince(planStart) * 1.0e3);
+				} else {
+					// Once per size.
+				}
+
+				converter.convert(image.data(), lines.data(), nSamples,
+						compression);
+				uint32_t nFrames = 0u;
+				const auto start = std::chrono::steady_clock::now();
+				double seconds = 0.0;
+				do {
+					// Planning again, as a client would each frame, costs
+					//  only the comparison.
+					converter.plan(scan.geometry, grid);
+					converter.convert(image.data(), lines.data(), nSamples,
+							compression);
+					++nFrames;
+					seconds = secondsSince(start);
+				} while (seconds < MIN_TIMED_SECONDS);
+
+				const double ms = seconds * 1.0e3 / nFrames;
+				std::printf(" %8.2f%c", ms, ms <= periodMs ? '*' : ' ');
+			}
+			std::printf("\n");
+		}
+	}
+
+	return 0;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static std::vector<float> makeLines(uint32_t nLines, uint32_t nSamples)
+{
+	std::vector<float> lines((std::size_t) nLines * nSamples);
+	const double echo = ECHO_DEPTH * (nSamples - 1u);
+	uint32_t seed = 1u;
+
+	for (uint32_t iLine = 0u; iLine < nLines; ++iLine) {
+		const int32_t fromEcho = (int32_t) iLine - (int32_t) (nLines / 2u);
+		const float amplitude = std::abs(fromEcho) <= 1
+				? ECHO_AMPLITUDE / (1 + std::abs(fromEcho))
+				: 0.0f;
+
+		for (uint32_t i = 0u; i < nSamples; ++i) {
+			const double t = i - echo;
+			seed = seed * 1664525u + 1013904223u;
+			lines[(std::size_t) iLine * nSamples + i] = amplitude
+					* (float) (std::exp(-0.5 * t * t
+							/ (BURST_SAMPLES * BURST_SAMPLES))
+					* std::cos(2.0 * PI * CENTRE_HZ / SAMPLE_RATE_HZ * t))
+					+ NOISE_AMPLITUDE * ((float) (seed >> 8) / (1u << 24) - 0.5f);
+		}
+	}
+
+	return lines;
+}
+
+// A square grid over the scan's extent.
+static oi::ScanGrid makeGrid(const oi::ScanGeometry& geometry, uint32_t size)
+{
+	float xMin = 1.0e30f, xMax = -1.0e30f, zMax = 0.0f;
+	const float reach = geometry.startUm
+			+ (geometry.nSamples - 1u) * geometry.stepUm;
+	for (std::size_t i = 0u; i < geometry.angleDeg.size(); ++i) {
+		const double a = geometry.angleDeg[i] * PI / 180.0;
+		const float x = geometry.originXUm[i] + (float) (reach * std::sin(a));
+		xMin = std::min({ xMin, x, geometry.originXUm[i] });
+		xMax = std::max({ xMax, x, geometry.originXUm[i] });
+		zMax = std::max(zMax, geometry.originZUm[i]
+				+ (float) (reach * std::cos(a)));
+	}
+
+	oi::ScanGrid grid;
+	grid.width = size;
+	grid.height = size;
+	grid.pixelUm = std::max(xMax - xMin, zMax) / (size - 1u);
+	grid.xStartUm = 0.5f * (xMin + xMax) - 0.5f * (size - 1u) * grid.pixelUm;
+	grid.zStartUm = 0.0f;
+
+	return grid;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,264 @@
+/*
+	oiBootPack.cpp
+
+	Compresses the partitions of a boot image (BOOT.BIN, as written by
+	bootgen) so that the FSBL reads less of the boot device.  Each chosen
+	partition is compressed in place (see xfsbl_lz4.h); what it no longer
+	needs is zeroed, so that offsets, and the rest of the image, are left
+	as they were.  Its header is marked XIH_PH_ATTRB_COMPRESSED, with the
+	compressed length, and its checksum redone.
+
+	The FSBL itself (partition 0), which the boot ROM loads, is never
+	compressed; nor are partitions that are encrypted, authenticated or
+	checksummed, whose protection covers the bytes as bootgen wrote them.
+	Images with an authenticated header table are refused altogether.
+
+	Each compressed partition is decompressed again by the FSBL's own
+	decoder, fed in chunks of several sizes, and compared with the
+	original before anything is written.
+
+	Usage:  oiBootPack in.bin out.bin [partition...]
+	where the partitions are numbered as in the image; by default, all that
+	may be compressed are.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiLz4.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+#include <vector>
+
+//********************************  Constants  *******************************//
+// As xfsbl_image_header.h:
+static const uint32_t BH_IH_TABLE_OFFSET = 0x98u;
+static const uint32_t IHT_NO_OF_PARTITIONS_OFFSET = 0x4u;
+static const uint32_t IHT_PH_ADDR_OFFSET = 0x8u;
+static const uint32_t IHT_AC_OFFSET = 0x10u;
+static const uint32_t MAX_PARTITIONS = 32u;
+
+static const uint32_t PH_LEN = 64u;
+static const uint32_t PH_ENC_DATAWORD_LENGTH = 0x0u;
+static const uint32_t PH_UNENC_DATAWORD_LENGTH = 0x4u;
+static const uint32_t PH_TOTAL_DATAWORD_LENGTH = 0x8u;
+static const uint32_t PH_DATA_WORD_OFFSET = 0x20u;
+static const uint32_t PH_ATTRB_OFFSET = 0x24u;
+static const uint32_t PH_CHECKSUM = 0x3Cu;
+
+static const uint32_t ATTRB_COMPRESSED = 0x1000000u;
+static const uint32_t ATTRB_RSA_SIGNATURE_MASK = 0x8000u;
+static const uint32_t ATTRB_CHECKSUM_MASK = 0x7000u;
+static const uint32_t ATTRB_ENCRYPTION_MASK = 0x0080u;
+
+static const uint32_t WORD = 4u;
+
+// Chunks fed to the decoder in the check; those of xfsbl_bs.c among them.
+static const std::size_t CHECK_CHUNKS[] = { 1u, 7u, 12u * 1024u, 28u * 1024u };
+
+//***********************  Local Function Declarations  **********************//
+static bool packPartition(std::vector<uint8_t>& image, uint32_t ph, uint32_t iPart);
+static bool readFile(const char* path, std::vector<uint8_t>& out);
+static bool writeFile(const char* path, const std::vector<uint8_t>& data);
+static uint32_t getWord(const std::vector<uint8_t>& image, uint32_t offset);
+static void setWord(std::vector<uint8_t>& image, uint32_t offset, uint32_t word);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3) {
+		std::fprintf(stderr, "usage: oiBootPack in.bin out.bin [partition...]\n");
+		return 2;
+	} else {
+		// Ok.
+	}
+
+	std::vector<uint8_t> image;
+	if (!readFile(argv[1], image) || image.size() < BH_IH_TABLE_OFFSET + WORD) {
+		std::fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	std::set<uint32_t> chosen;
+	for (int i = 3; i < argc; ++i) {
+		chosen.insert((uint32_t) std::strtoul(argv[i], nullptr, 0));
+	}
+
+	// The image header table, and the partition headers it lists:
+	const uint32_t iht = getWord(image, BH_IH_TABLE_OFFSET);
+	if ((std::size_t) iht + IHT_AC_OFFSET + WORD > image.size()) {
+		std::fprintf(stderr, "no image header table\n");
+		return 1;
+	} else if (getWord(image, iht + IHT_AC_OFFSET) != 0u) {
+		std::fprintf(stderr, "the header table is authenticated; "
+				"its partitions cannot be changed\n");
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	const uint32_t
+		nParts = getWord(image, iht + IHT_NO_OF_PARTITIONS_OFFSET),
+		ph0 = getWord(image, iht + IHT_PH_ADDR_OFFSET) * WORD;
+	if (nParts > MAX_PARTITIONS
+			|| (std::size_t) ph0 + nParts * PH_LEN > image.size()) {
+		std::fprintf(stderr, "bad partition headers\n");
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	bool ok = true;
+	for (uint32_t iPart = 1u; iPart < nParts && ok; ++iPart) {
+		const uint32_t
+			ph = ph0 + iPart * PH_LEN,
+			attributes = getWord(image, ph + PH_ATTRB_OFFSET);
+		const bool
+			isChosen = chosen.empty() || chosen.count(iPart) != 0u,
+			isProtected = (attributes & (ATTRB_RSA_SIGNATURE_MASK
+					| ATTRB_CHECKSUM_MASK | ATTRB_ENCRYPTION_MASK)) != 0u;
+
+		if (!isChosen) {
+			// Left alone.
+		} else if (isProtected || (attributes & ATTRB_COMPRESSED) != 0u
+				|| getWord(image, ph + PH_UNENC_DATAWORD_LENGTH) == 0u) {
+			std::printf("partition %2u  left as it is (%s)\n", iPart,
+					isProtected ? "protected"
+					: (attributes & ATTRB_COMPRESSED) != 0u ? "compressed"
+					: "XIP");
+		} else {
+			ok = packPartition(image, ph, iPart);
+		}
+	}
+
+	if (ok && !writeFile(argv[2], image)) {
+		std::fprintf(stderr, "cannot write %s\n", argv[2]);
+		ok = false;
+	} else {
+		// Written, or failed already.
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Compresses one partition in place, if that saves anything; returns false
+//  if the partition lies outside the image or does not survive the trip.
+static bool packPartition(std::vector<uint8_t>& image, uint32_t ph, uint32_t iPart)
+{
+	const uint32_t
+		offset = getWord(image, ph + PH_DATA_WORD_OFFSET) * WORD,
+		length = getWord(image, ph + PH_UNENC_DATAWORD_LENGTH) * WORD;
+
+	if ((std::size_t) offset + length > image.size()) {
+		std::fprintf(stderr, "partition %u lies outside the image\n", iPart);
+		return false;
+	} else {
+		// Ok.
+	}
+
+	const std::vector<uint8_t>
+		original(&image[offset], &image[offset] + length),
+		packed = oi::lz4Compress(original.data(), original.size());
+
+	if (packed.size() >= original.size()) {
+		std::printf("partition %2u  %9u bytes  left as it is (incompressible)\n",
+				iPart, length);
+		return true;
+	} else {
+		// Worth it.
+	}
+
+	for (const std::size_t chunk : CHECK_CHUNKS) {
+		std::vector<uint8_t> check;
+		if (!oi::lz4Decompress(check, packed.data(), packed.size(), chunk)
+				|| check != original) {
+			std::fprintf(stderr, "partition %u does not decompress "
+					"(in chunks of %zu)\n", iPart, chunk);
+			return false;
+		} else {
+			// Intact.
+		}
+	}
+
+	std::memcpy(&image[offset], packed.data(), packed.size());
+	std::memset(&image[offset + packed.size()], 0, length - packed.size());
+
+	const uint32_t words = (uint32_t) (packed.size() / WORD);
+	setWord(image, ph + PH_ENC_DATAWORD_LENGTH, words);
+	setWord(image, ph + PH_UNENC_DATAWORD_LENGTH, words);
+	setWord(image, ph + PH_TOTAL_DATAWORD_LENGTH, words);
+	setWord(image, ph + PH_ATTRB_OFFSET,
+			getWord(image, ph + PH_ATTRB_OFFSET) | ATTRB_COMPRESSED);
+
+	// As XFsbl_ValidateChecksum:  the complement of the sum of the others.
+	uint32_t sum = 0u;
+	for (uint32_t at = 0u; at < PH_CHECKSUM; at += WORD) {
+		sum += getWord(image, ph + at);
+	}
+	setWord(image, ph + PH_CHECKSUM, ~sum);
+
+	std::printf("partition %2u  %9u -> %9zu bytes  (%.2f)\n", iPart, length,
+			packed.size(), (double) length / packed.size());
+
+	return true;
+}
+
+static bool readFile(const char* path, std::vector<uint8_t>& out)
+{
+	std::FILE* const pFile = std::fopen(path, "rb");
+	bool ok = pFile != nullptr;
+
+	if (ok) {
+		uint8_t buffer[64u * 1024u];
+		std::size_t n;
+		while ((n = std::fread(buffer, 1u, sizeof(buffer), pFile)) > 0u) {
+			out.insert(out.end(), buffer, buffer + n);
+		}
+		ok = std::ferror(pFile) == 0;
+		std::fclose(pFile);
+	} else {
+		// Cannot open.
+	}
+
+	return ok;
+}
+
+static bool writeFile(const char* path, const std::vector<uint8_t>& data)
+{
+	std::FILE* const pFile = std::fopen(path, "wb");
+	bool ok = pFile != nullptr;
+
+	if (ok) {
+		ok = std::fwrite(data.data(), 1u, data.size(), pFile) == data.size();
+		ok = std::fclose(pFile) == 0 && ok;
+	} else {
+		// Cannot open.
+	}
+
+	return ok;
+}
+
+// Little-endian, as the image is.
+static uint32_t getWord(const std::vector<uint8_t>& image, uint32_t offset)
+{
+	uint32_t word = 0u;
+	for (uint32_t i = 0u; i < WORD; ++i) {
+		word |= (uint32_t) image[offset + i] << (8u * i);
+	}
+
+	return word;
+}
+
+static void setWord(std::vector<uint8_t>& image, uint32_t offset, uint32_t word)
+{
+	for (uint32_t i = 0u; i < WORD; ++i) {
+		image[offset + i] = (uint8_t) (word >> (8u * i));
+	}
+}
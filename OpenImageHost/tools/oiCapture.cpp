@@ -0,0 +1,217 @@
+/*
+	oiCapture.cpp
+
+	Records frames with a device and reads back their raw data, reporting
+	the rate; an example of the client library (oiClient.h).  Each frame
+	fires every channel with a single-cycle pulse and records nSamples
+	rows.  The data of each frame are read while the next is programmed.
+
+	Usage:  oiCapture host [nFrames [nShots [nSamples [out.oir]]]]
+	where out.oir, if given, receives the frames, with their program, as a
+	recording (oiRecording.h).
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiClient.h"
+#include "oiRecording.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+//********************************  Constants  *******************************//
+// A single-cycle pulse at a quarter of the transmit clock.
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+// Middle of the TGC DAC's range.
+static const uint8_t TGC_LEVEL = 128u;
+
+static const std::chrono::milliseconds POLL_PERIOD(1);
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+
+//***********************  Local Function Declarations  **********************//
+static OI_SHOT makeShot(uint32_t nSamples);
+static bool waitRecorded(oi::Client& client, uint32_t nShots);
+static bool getStatus(oi::Client& client, OI_STATUS& status);
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		std::fprintf(stderr, "usage: oiCapture host "
+				"[nFrames [nShots [nSamples [out.oir]]]]\n");
+		return 2;
+	} else {
+		// Ok.
+	}
+
+	const uint32_t
+		nFrames = argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 0) : 10u,
+		nShots = argc > 3 ? (uint32_t) std::strtoul(argv[3], nullptr, 0) : 32u,
+		nSamples = argc > 4 ? (uint32_t) std::strtoul(argv[4], nullptr, 0) : 2048u;
+
+	oi::FrameProgram program;
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		program.addShot(makeShot(nSamples));
+	}
+	oi_error_t error = program.build();
+	if (error != OI_ERR_NONE) {
+		std::fprintf(stderr, "bad frame (error %d)\n", (int) error);
+		return 1;
+	} else {
+		std::printf("frame:  %u shots, %zu bytes as %s\n", nShots,
+				program.getBytes().size(),
+				program.getCommand() == OI_CMD_QUEUE_FRAME_RLE
+						? "OI_FRAME_RLE" : "OI_FRAME");
+	}
+
+	oi::RecordingWriter recording;
+	if (argc > 5 && !recording.create(argv[5], program)) {
+		std::fprintf(stderr, "cannot write %s\n", argv[5]);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	oi::Client client;
+	if (!client.connect(argv[1])) {
+		std::fprintf(stderr, "cannot connect to %s\n", argv[1]);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	// Two sets of buffers:  one being read while the other is written out.
+	const std::size_t nBytes = program.getRawBytes();
+	std::vector<uint8_t> data[2][OI_RX_N_CHIPS];
+	std::future<oi::FrameResult> reads[2];
+	std::size_t nRead = 0u;
+	bool ok = true;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t iF = 0u; iF <= nFrames && ok; ++iF) {
+		const uint32_t iBuf = iF & 1u, iPrev = iBuf ^ 1u;
+
+		if (iF < nFrames) {
+			program.setHandle(iF);
+			program.build();
+
+			OI_STATUS before;
+			ok = getStatus(client, before)
+					&& client.queueFrame(program).get().isAck()
+					&& waitRecorded(client, before.nShots + nShots);
+
+			oi::FrameBuffers buffers;
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS && ok; ++iAdc) {
+				data[iBuf][iAdc].resize(nBytes);
+				buffers.pData[iAdc] = data[iBuf][iAdc].data();
+				buffers.nBytes[iAdc] = nBytes;
+			}
+			if (ok) {
+				reads[iBuf] = client.readFrame(buffers);
+			} else {
+				std::fprintf(stderr, "frame %u was not recorded\n", iF);
+			}
+		} else {
+			// The last frame is being read.
+		}
+
+		// The previous frame, while this one is read:
+		if (iF > 0u && ok) {
+			const oi::FrameResult result = reads[iPrev].get();
+			ok = result.ok;
+			if (!ok) {
+				std::fprintf(stderr, "frame %u:  read failed (error %d)\n",
+						iF - 1u, (int) result.error);
+			} else if (recording.isOpen()) {
+				const uint8_t* ppData[OI_RX_N_CHIPS];
+				for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+					ppData[iAdc] = data[iPrev][iAdc].data();
+				}
+				ok = recording.append(ppData, (uint64_t)
+						std::chrono::duration_cast<std::chrono::nanoseconds>(
+								std::chrono::system_clock::now()
+										.time_since_epoch()).count());
+				if (!ok) {
+					std::fprintf(stderr, "cannot write %s\n", argv[5]);
+				} else {
+					// Recorded.
+				}
+			} else {
+				// Not kept.
+			}
+			nRead += ok ? OI_RX_N_CHIPS * nBytes : 0u;
+		} else {
+			// Nothing read yet.
+		}
+	}
+	const double seconds = secondsSince(start);
+
+	client.close();
+	ok = recording.close() && ok;
+
+	std::printf("%zu bytes in %.3f s:  %.1f MB/s, %.1f frames/s\n", nRead,
+			seconds, nRead / seconds / 1.0e6,
+			nRead / (double) (OI_RX_N_CHIPS * nBytes) / seconds);
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static OI_SHOT makeShot(uint32_t nSamples)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+
+	shot.rx.nSamples = nSamples;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	return shot;
+}
+
+// Waits until the device is ready, with nShots recorded since power-up.
+static bool waitRecorded(oi::Client& client, uint32_t nShots)
+{
+	const auto start = std::chrono::steady_clock::now();
+	OI_STATUS status;
+	bool ok = getStatus(client, status);
+
+	while (ok && (status.state != STATE_READY
+			|| (int32_t) (status.nShots - nShots) < 0)) {
+		std::this_thread::sleep_for(POLL_PERIOD);
+		ok = std::chrono::steady_clock::now() - start < RECORD_TIMEOUT
+				&& getStatus(client, status);
+	}
+
+	return ok;
+}
+
+static bool getStatus(oi::Client& client, OI_STATUS& status)
+{
+	return client.getStatus().get().get(status);
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,282 @@
+/*
+	oiCaptured.cpp
+
+	Captures frames from a device continuously, straight to a recording on
+	disk (oiCaptureWriter.h), until it has the frames asked for or is
+	interrupted.  Each frame is queued, recorded and read as oiCapture does,
+	into a buffer of the writer's ring, and written while the next frame is
+	acquired.  Once a second, and at the end, it reports the rates of the
+	network and the disk, the frames waiting to be written, and the frames
+	that found no free buffer:  dropped, or with -w, waited for.
+
+	Usage:  oiCaptured [-w] host out.oir [nFrames [nShots [nSamples
+	        [nBuffers]]]]
+	where nFrames of 0 captures until SIGINT or SIGTERM.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiCaptureWriter.h"
+#include "oiClient.h"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+//********************************  Constants  *******************************//
+// A single-cycle pulse at a quarter of the transmit clock, as oiCapture.
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+// Polling faster only takes time from the device, or the emulator beside
+//  this on the host.
+static const std::chrono::microseconds STATUS_POLL_PERIOD(100);
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+static const std::chrono::seconds REPORT_PERIOD(1);
+static const std::chrono::microseconds BUFFER_POLL_PERIOD(100);
+
+//**********************************  Types  *********************************//
+
+struct Counts {
+	std::atomic<uint64_t>
+		nReceived{ 0u },
+		nReadErrors{ 0u },
+		nNetBytes{ 0u };
+	uint64_t
+		nDropped = 0u,
+		nWaits = 0u;
+	double waitSeconds = 0.0;
+};
+
+//*******************************  Module Data  ******************************//
+static volatile std::sig_atomic_t isInterrupted = 0;
+
+//***********************  Local Function Declarations  **********************//
+static void onSignal(int signal);
+static OI_SHOT makeShot(uint32_t nSamples);
+static bool record(oi::Client& client, const oi::FrameProgram& program);
+static void report(const char* label, double seconds, const Counts& counts,
+		const oi::CaptureWriterStats& stats, std::size_t nQueued);
+static uint64_t nowNs();
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	const bool isWaiting = argc > 1 && std::strcmp(argv[1], "-w") == 0;
+	char** const args = argv + (isWaiting ? 1 : 0);
+	const int nArgs = argc - (isWaiting ? 1 : 0);
+
+	if (nArgs < 3) {
+		std::fprintf(stderr, "usage: oiCaptured [-w] host out.oir "
+				"[nFrames [nShots [nSamples [nBuffers]]]]\n");
+		return 2;
+	} else {
+		// Ok.
+	}
+
+	const uint32_t
+		nFrames = nArgs > 3 ? (uint32_t) std::strtoul(args[3], nullptr, 0) : 0u,
+		nShots = nArgs > 4 ? (uint32_t) std::strtoul(args[4], nullptr, 0) : 32u,
+		nSamples = nArgs > 5 ? (uint32_t) std::strtoul(args[5], nullptr, 0)
+				: 2048u;
+	oi::CaptureWriterOptions options;
+	options.nBuffers = nArgs > 6
+			? (std::size_t) std::strtoul(args[6], nullptr, 0)
+			: options.nBuffers;
+
+	oi::FrameProgram program;
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		program.addShot(makeShot(nSamples));
+	}
+	const oi_error_t error = program.build();
+	if (error != OI_ERR_NONE) {
+		std::fprintf(stderr, "bad frame (error %d)\n", (int) error);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	oi::CaptureWriter writer(options);
+	if (!writer.create(args[2], program)) {
+		std::fprintf(stderr, "cannot write %s\n", args[2]);
+		return 1;
+	} else {
+		std::printf("%s:  frames of %zu bytes, %zu buffers, %s, %s\n", args[2],
+				writer.getFrameBytes(), options.nBuffers,
+				writer.isUring() ? "io_uring" : "pwrite",
+				writer.isDirect() ? "O_DIRECT" : "page cache");
+	}
+
+	oi::Client client;
+	if (!client.connect(args[1])) {
+		std::fprintf(stderr, "cannot connect to %s\n", args[1]);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	std::signal(SIGINT, onSignal);
+	std::signal(SIGTERM, onSignal);
+
+	/////  Capture  /////
+	const std::size_t nRawBytes = program.getRawBytes();
+	Counts counts;
+	bool ok = true;
+	const auto start = std::chrono::steady_clock::now();
+	auto reported = start;
+
+	for (uint32_t iF = 0u; (nFrames == 0u || iF < nFrames) && ok
+			&& !isInterrupted; ++iF) {
+		program.setHandle(iF);
+		program.build();
+		ok = record(client, program);
+		if (!ok) {
+			std::fprintf(stderr, "frame %u was not recorded\n", iF);
+			break;
+		} else {
+			// Recorded.
+		}
+
+		// A buffer for it:  waited for, or the frame is dropped.
+		uint8_t* pBuffer = writer.acquire();
+		if (pBuffer == nullptr && isWaiting) {
+			const auto waitStart = std::chrono::steady_clock::now();
+			while (pBuffer == nullptr && !isInterrupted) {
+				std::this_thread::sleep_for(BUFFER_POLL_PERIOD);
+				pBuffer = writer.acquire();
+			}
+			++counts.nWaits;
+			counts.waitSeconds += secondsSince(waitStart);
+		} else {
+			// Free, or not to be waited for.
+		}
+
+		if (pBuffer != nullptr) {
+			oi::FrameBuffers buffers;
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+				buffers.pData[iAdc] = writer.getAdcData(pBuffer, iAdc);
+				buffers.nBytes[iAdc] = nRawBytes;
+			}
+			client.readFrame(buffers,
+					[&writer, &counts, pBuffer](const oi::FrameResult& result) {
+				if (result.ok) {
+					writer.commit(pBuffer, nowNs());
+					++counts.nReceived;
+					counts.nNetBytes += result.nBytes[0] + result.nBytes[1];
+				} else {
+					writer.discard(pBuffer);
+					++counts.nReadErrors;
+				}
+			});
+		} else {
+			++counts.nDropped;
+		}
+
+		if (std::chrono::steady_clock::now() - reported >= REPORT_PERIOD) {
+			reported = std::chrono::steady_clock::now();
+			report("", secondsSince(start), counts, writer.getStats(),
+					writer.getNQueued());
+		} else {
+			// Not yet.
+		}
+	}
+
+	// The replies come in order, so the frames' reads are done with this:
+	ok = client.getStatus().get().code != 0u && ok;
+	client.close();
+	const double seconds = secondsSince(start);
+	const bool isWritten = writer.close();
+	report("total:  ", seconds, counts, writer.getStats(), 0u);
+	if (!isWritten) {
+		std::fprintf(stderr, "cannot write %s\n", args[2]);
+	} else {
+		// Ok.
+	}
+
+	return ok && isWritten && counts.nReadErrors == 0u ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static void onSignal(int)
+{
+	isInterrupted = 1;
+}
+
+static OI_SHOT makeShot(uint32_t nSamples)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+
+	shot.rx.nSamples = nSamples;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	return shot;
+}
+
+// Queues a built frame and polls until it is recorded.
+static bool record(oi::Client& client, const oi::FrameProgram& program)
+{
+	OI_STATUS status;
+	bool ok = client.getStatus().get().get(status);
+	const uint32_t before = status.nShots;
+
+	const auto start = std::chrono::steady_clock::now();
+	ok = ok && client.queueFrame(program).get().isAck();
+	while (ok && (status.state != STATE_READY
+			|| (int32_t) (status.nShots - before - program.getNShots()) < 0)) {
+		std::this_thread::sleep_for(STATUS_POLL_PERIOD);
+		ok = std::chrono::steady_clock::now() - start < RECORD_TIMEOUT
+				&& client.getStatus().get().get(status);
+	}
+
+	return ok;
+}
+
+static void report(const char* label, double seconds, const Counts& counts,
+		const oi::CaptureWriterStats& stats, std::size_t nQueued)
+{
+	std::printf("%s%7.1f s  %8llu frames  net %7.1f MB/s  disk %7.1f MB/s  "
+			"queued %3zu (most %zu)  dropped %llu  waited %llu (%.1f ms)  "
+			"errors %llu\n", label, seconds,
+			(unsigned long long) counts.nReceived.load(),
+			counts.nNetBytes / seconds / 1.0e6,
+			stats.nBytesWritten / seconds / 1.0e6,
+			nQueued, stats.maxQueued,
+			(unsigned long long) counts.nDropped,
+			(unsigned long long) counts.nWaits, counts.waitSeconds * 1.0e3,
+			(unsigned long long) (counts.nReadErrors + stats.nErrors));
+	std::fflush(stdout);
+}
+
+static uint64_t nowNs()
+{
+	return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+}
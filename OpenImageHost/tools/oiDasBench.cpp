@@ -0,0 +1,264 @@
+/*
+	oiDasBench.cpp
+
+	Rate of the host's delay-and-sum beamformer (oiDas.h), in frames per
+	second, for several image sizes and numbers of threads, against the
+	rate at which the device delivers the frame continuously:  that at
+	which it records it, or that at which its link carries the raw data,
+	whichever is less.  Rates that keep up are marked.  Under each size,
+	the speed-up of each thread count over one thread, and its efficiency
+	(the speed-up per thread), show how the beamformer scales; past the
+	number of processors, neither can grow.
+
+	The frame is of steered plane waves, compounded into a grid; its shots
+	are synthesized (oiSynth.h) and deinterleaved as a client would.  That
+	the images are right, for every thread count and kernel, is checked by
+	oiDasTest.
+
+	Usage:  oiDasBench [nShots [nSamples]]
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiDas.h"
+#include "oiDeinterleave.h"
+#include "oiEmulator.h"
+#include "oiSynth.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const uint32_t DEFAULT_N_SHOTS = 11u;
+static const uint32_t DEFAULT_N_SAMPLES = 2400u;
+
+// Steering of the outermost plane waves, either side of straight down.
+static const double MAX_STEER_DEG = 10.0;
+
+// A cycle at the centre frequency:  half at each polarity.
+static const uint32_t HALF_CYCLE_CLOCKS = 22u;
+static const uint8_t TGC_LEVEL = 128u;
+
+static const double PI = 3.14159265358979324;
+
+// The imaged region, and the sizes of grid timed over it.
+static const float WIDTH_UM = 4800.0f;
+static const float DEPTH_START_UM = 5000.0f;
+static const float DEPTH_UM = 40000.0f;
+static const uint32_t SIZES[][2] = {      // columns, depths
+	{ 64u, 256u },
+	{ 128u, 512u },
+	{ 256u, 1024u },
+};
+
+// TCP over Gigabit Ethernet, with full segments.
+static const double LINK_BYTES_PER_SEC = 117.6e6;
+
+// Repeat each measurement for at least this long.
+static const double MIN_TIMED_SECONDS = 0.5;
+
+//***********************  Local Function Declarations  **********************//
+static oi::FrameProgram makeFrame(uint32_t nShots, uint32_t nSamples,
+		const oi::DasGeometry& geometry);
+static oi::DasImage makeImage(uint32_t nColumns, uint32_t nDepth);
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	const uint32_t
+		nShots = argc > 1
+				? (uint32_t) std::strtoul(argv[1], nullptr, 0)
+				: DEFAULT_N_SHOTS,
+		nSamples = argc > 2
+				? (uint32_t) std::strtoul(argv[2], nullptr, 0)
+				: DEFAULT_N_SAMPLES;
+	const oi::SynthModel model;
+	oi::DasGeometry geometry = oi::makeLinearArray(model.pitchNm);
+	geometry.speedOfSound = (float) model.speedOfSound;
+	geometry.sampleRateHz = model.sampleRateHz;
+	geometry.fNumber = 1.0f;
+
+	if (nShots == 0u || nShots > OI_MAX_N_SHOTS || nSamples < 2u) {
+		std::fprintf(stderr, "between 1 and %u shots, of 2 or more samples\n",
+				OI_MAX_N_SHOTS);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	/////  Record  /////
+	// The synthesized lanes are not inverted, as the board's are.
+	const oi::FrameProgram program = makeFrame(nShots, nSamples, geometry);
+	oi::ChannelMap map = oi::defaultChannelMap();
+	std::fill_n(map.isInverted, OI_N_CHAN, false);
+
+	std::vector<float> rf((std::size_t) nShots * OI_N_CHAN * nSamples);
+	std::vector<int16_t> raw[OI_RX_N_CHIPS];
+	int16_t* ppRaw[OI_RX_N_CHIPS];
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		raw[iAdc].resize((std::size_t) nSamples * oi::DEINTERLEAVE_N_LANES);
+		ppRaw[iAdc] = raw[iAdc].data();
+	}
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		oi::synthesizeShot(ppRaw, program.getShot(iShot), model, iShot + 1u);
+		oi::deinterleave(&rf[(std::size_t) iShot * OI_N_CHAN * nSamples],
+				nSamples, ppRaw, nSamples, map);
+	}
+
+	const double
+		recordFps = 1.0 / (nShots * (nSamples / model.sampleRateHz
+				+ oi::EmulatorOptions().shotSetupUs * 1.0e-6)),
+		linkFps = LINK_BYTES_PER_SEC / (OI_RX_N_CHIPS * nShots
+				* OI_RX_SHOT_RECORD_BYTES(nSamples, OI_SAMPLE_FORMAT_16)),
+		deviceFps = std::min(recordFps, linkFps);
+	// Powers of two up to the processors, and one more than them:
+	const unsigned nCpus = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<unsigned> threadCounts;
+	for (unsigned n = 1u; n < nCpus; n *= 2u) {
+		threadCounts.push_back(n);
+	}
+	threadCounts.push_back(nCpus);
+	threadCounts.push_back(nCpus + 1u);
+
+	std::printf("%u plane waves of %u samples:  the device records %.0f "
+			"frames/s, its link carries %.0f\n", nShots, nSamples, recordFps,
+			linkFps);
+	std::printf("%u processors\n", nCpus);
+
+	/////  Time  /////
+	std::printf("%-10s %8s", "image", "plan ms");
+	for (const unsigned nThreads : threadCounts) {
+		std::printf(" %7u thr", nThreads);
+	}
+	std::printf("   (frames/s)\n");
+
+	for (const uint32_t* pSize : SIZES) {
+		const oi::DasImage shape = makeImage(pSize[0], pSize[1]);
+		std::vector<float> image((std::size_t) pSize[0] * pSize[1]);
+		char name[32];
+
+		std::vector<double> fps(threadCounts.size());
+
+		std::snprintf(name, sizeof(name), "%ux%u", pSize[0], pSize[1]);
+		std::printf("%-10s", name);
+
+		for (std::size_t iCount = 0u; iCount < threadCounts.size(); ++iCount) {
+			oi::DasBeamformer beamformer(threadCounts[iCount]);
+
+			const auto planStart = std::chrono::steady_clock::now();
+			beamformer.plan(program, geometry, shape);
+			if (iCount == 0u) {
+				std::printf(" %8.1f", secondsSince(planStart) * 1.0e3);
+			} else {
+				// Once per size.
+			}
+
+			beamformer.beamform(image.data(), rf.data(), nSamples);
+			uint32_t nFrames = 0u;
+			const auto start = std::chrono::steady_clock::now();
+			double seconds = 0.0;
+			do {
+				beamformer.beamform(image.data(), rf.data(), nSamples);
+				++nFrames;
+				seconds = secondsSince(start);
+			} while (seconds < MIN_TIMED_SECONDS);
+
+			fps[iCount] = nFrames / seconds;
+			std::printf(" %10.0f%c", fps[iCount],
+					fps[iCount] >= deviceFps ? '*' : ' ');
+		}
+		std::printf("\n");
+
+		// Scaling:
+		std::printf("%-10s %8s", "  speed-up", "");
+		for (std::size_t iCount = 0u; iCount < threadCounts.size(); ++iCount) {
+			std::printf(" %10.2fx", fps[iCount] / fps[0]);
+		}
+		std::printf("\n%-10s %8s", "  per thr", "");
+		for (std::size_t iCount = 0u; iCount < threadCounts.size(); ++iCount) {
+			std::printf(" %10.0f%%",
+					100.0 * fps[iCount] / fps[0] / threadCounts[iCount]);
+		}
+		std::printf("\n");
+	}
+
+	return 0;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Plane waves steered evenly from -MAX_STEER_DEG to +MAX_STEER_DEG.  Each
+//  element's pulse starts after the clocks that steer it.
+static oi::FrameProgram makeFrame(uint32_t nShots, uint32_t nSamples,
+		const oi::DasGeometry& geometry)
+{
+	const double clocksPerUm = OI_TX_CLOCK_HZ / (geometry.speedOfSound * 1.0e6);
+	oi::FrameProgram program;
+
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		const double steer = nShots > 1u
+				? (-1.0 + 2.0 * iShot / (nShots - 1u)) * MAX_STEER_DEG * PI / 180.0
+				: 0.0;
+		const double xFirst = steer >= 0.0
+				? geometry.elementXUm[0]
+				: geometry.elementXUm[OI_N_CHAN - 1u];
+		OI_SHOT shot;
+		std::memset(&shot, 0, sizeof(shot));
+
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			OI_TX_CHANNEL& tx = shot.tx.channels[iChan];
+			const uint32_t delay = (uint32_t) std::lround(
+					(geometry.elementXUm[iChan] - xFirst) * std::sin(steer)
+							* clocksPerUm);
+			uint32_t n = 1u + delay;
+
+			std::fill_n(&tx.levelSequence[n], HALF_CYCLE_CLOCKS, (int8_t) 2);
+			n += HALF_CYCLE_CLOCKS;
+			std::fill_n(&tx.levelSequence[n], HALF_CYCLE_CLOCKS, (int8_t) -2);
+			n += HALF_CYCLE_CLOCKS;
+			tx.nLevelSequence = n + 1u;
+			tx.enable = 1u;
+
+			shot.rx.channels[iChan].enable = 1u;
+		}
+
+		shot.rx.nSamples = nSamples;
+		shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+			std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+		}
+
+		program.addShot(shot);
+	}
+
+	return program;
+}
+
+static oi::DasImage makeImage(uint32_t nColumns, uint32_t nDepth)
+{
+	oi::DasImage image;
+
+	for (uint32_t iCol = 0u; iCol < nColumns; ++iCol) {
+		image.columnXUm.push_back(WIDTH_UM
+				* ((iCol + 0.5f) / nColumns - 0.5f));
+	}
+	image.depthStartUm = DEPTH_START_UM;
+	image.depthStepUm = DEPTH_UM / nDepth;
+	image.nDepth = nDepth;
+
+	return image;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,119 @@
+/*
+	oiDeinterleaveBench.cpp
+
+	Times the conversion of raw shots into [channel][sample] matrices
+	(oiDeinterleave.h):  each kernel that the CPU runs, to float and to
+	int16_t, with the board's map.  That the kernels match the scalar
+	version is checked by oiDeinterleaveTest.
+
+	Usage:  oiDeinterleaveBench [nSamples]
+	where nSamples is the length of each shot (default 4093, so that every
+	kernel leaves a tail to the scalar version).
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiDeinterleave.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const std::size_t DEFAULT_N_SAMPLES = 4093u;
+static const uint32_t SEED = 0x4F49u;
+
+// Repeat until at least this much raw data has been timed.
+static const std::size_t MIN_TIMED_BYTES = 512u << 20;
+
+static const char* const ISA_NAMES[] = { "scalar", "avx2", "avx512" };
+
+//***********************  Local Function Declarations  **********************//
+template <typename T>
+static double time(
+		oi::DeinterleaveIsa isa,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const oi::ChannelMap& map
+);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	const std::size_t nSamples = argc > 1
+			? (std::size_t) std::strtoul(argv[1], nullptr, 0)
+			: DEFAULT_N_SAMPLES;
+	const oi::DeinterleaveIsa best = oi::bestDeinterleaveIsa();
+	std::mt19937 random(SEED);
+
+	if (nSamples == 0u) {
+		std::fprintf(stderr, "no samples\n");
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	// Every code, in the 14 bits of the ADC, with the extremes:
+	std::vector<int16_t> raw[OI_RX_N_CHIPS];
+	const int16_t* ppRaw[OI_RX_N_CHIPS];
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		raw[iAdc].resize(nSamples * oi::DEINTERLEAVE_N_LANES);
+		for (int16_t& v : raw[iAdc]) {
+			v = (int16_t) (random() & 0xFFFCu);
+		}
+		raw[iAdc][0] = INT16_MIN;
+		raw[iAdc][1] = (int16_t) 0x7FFC;
+		ppRaw[iAdc] = raw[iAdc].data();
+	}
+
+	const oi::ChannelMap map = oi::defaultChannelMap();
+	const double rawBytes = (double) nSamples * OI_N_CHAN * sizeof(int16_t);
+	double scalarSeconds[2] = {};
+	std::printf("%-8s %12s %12s\n", "", "to float", "to int16");
+	for (int isa = oi::DEINTERLEAVE_SCALAR; isa <= best; ++isa) {
+		const double seconds[2] = {
+			time<float>((oi::DeinterleaveIsa) isa, ppRaw, nSamples, map),
+			time<int16_t>((oi::DeinterleaveIsa) isa, ppRaw, nSamples, map)
+		};
+		if (isa == oi::DEINTERLEAVE_SCALAR) {
+			std::copy_n(seconds, 2, scalarSeconds);
+		} else {
+			// Compared with the scalar.
+		}
+		std::printf("%-8s %7.0f MB/s %7.0f MB/s  (x%.1f, x%.1f)\n",
+				ISA_NAMES[isa],
+				rawBytes / seconds[0] / 1.0e6, rawBytes / seconds[1] / 1.0e6,
+				scalarSeconds[0] / seconds[0], scalarSeconds[1] / seconds[1]);
+	}
+
+	return 0;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Seconds per shot.
+template <typename T>
+static double time(
+		oi::DeinterleaveIsa isa,
+		const int16_t* const ppRaw[OI_RX_N_CHIPS],
+		std::size_t nSamples,
+		const oi::ChannelMap& map
+) {
+	const std::size_t shotBytes = nSamples * OI_N_CHAN * sizeof(int16_t);
+	const std::size_t nReps = std::max<std::size_t>(1u,
+			MIN_TIMED_BYTES / shotBytes);
+	std::vector<T> out(nSamples * OI_N_CHAN);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (std::size_t iRep = 0u; iRep < nReps; ++iRep) {
+		oi::deinterleave(out.data(), nSamples, ppRaw, nSamples, map, isa);
+	}
+	const double seconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+
+	return seconds / nReps;
+}
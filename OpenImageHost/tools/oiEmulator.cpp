@@ -0,0 +1,84 @@
+/*
+	oiEmulator.cpp
+
+	Serves an emulated Open Imager (oiEmulator.h) until interrupted, so that
+	host software may be run against it, e.g. oiCapture 127.0.0.1.
+
+	Usage:  oiEmulator [port [shotSetupUs [linkMBps [replyUs [fpgaHeader]]]]]
+	where linkMBps limits the rate of the replies (zero for no limit),
+	replyUs delays each, and a fpgaHeader of 1 timestamps the shots as a
+	bitstream with the shot-header block would.  The default port is
+	OI_TCP_PORT.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiEmulator.h"
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+
+#include <unistd.h>
+
+//*******************************  Module Data  ******************************//
+static volatile std::sig_atomic_t isInterrupted = 0;
+
+//***********************  Local Function Declarations  **********************//
+static void onInterrupt(int);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	oi::EmulatorOptions options;
+	if (argc > 1) {
+		options.port = (uint16_t) std::strtoul(argv[1], nullptr, 0);
+	} else {
+		// The device's.
+	}
+	if (argc > 2) {
+		options.shotSetupUs = (uint32_t) std::strtoul(argv[2], nullptr, 0);
+	} else {
+		// Default.
+	}
+	if (argc > 3) {
+		options.linkBytesPerSec = std::strtod(argv[3], nullptr) * 1.0e6;
+	} else {
+		// Unlimited.
+	}
+	if (argc > 4) {
+		options.replyUs = (uint32_t) std::strtoul(argv[4], nullptr, 0);
+	} else {
+		// Immediate.
+	}
+	if (argc > 5) {
+		options.isFpgaHeader = std::strtoul(argv[5], nullptr, 0) != 0u;
+	} else {
+		// As the present bitstream:  no timestamps.
+	}
+
+	oi::Emulator emulator(options);
+	if (!emulator.start()) {
+		std::fprintf(stderr, "cannot listen on port %u\n",
+				(unsigned) options.port);
+		return 1;
+	} else {
+		std::printf("emulating on port %u\n", (unsigned) emulator.getPort());
+		std::fflush(stdout);
+	}
+
+	std::signal(SIGINT, onInterrupt);
+	std::signal(SIGTERM, onInterrupt);
+	while (!isInterrupted) {
+		pause();
+	}
+
+	emulator.stop();
+
+	return 0;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static void onInterrupt(int) { isInterrupted = 1; }
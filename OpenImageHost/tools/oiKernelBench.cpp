@@ -0,0 +1,141 @@
+/*
+	oiKernelBench.cpp
+
+	Throughput benchmark of the portable processing kernels, as built for
+	the host.  Each kernel runs on one thread, so the rates are per core.
+
+	Usage:  oiKernelBench [nSamples] [nReps]
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiIqDesign.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const double SAMPLE_RATE_HZ = 40.0e6;
+static const double PI = 3.14159265358979324;
+
+// Channels recorded by each ADC.
+static const uint32_t N_ADC_CHAN = OI_N_CHAN / OI_RX_N_CHIPS;
+
+//***********************  Local Function Declarations  **********************//
+static void report(
+		const char* name,
+		uint32_t nReps,
+		double samplesPerRep,
+		const std::function<void()>& run
+);
+static std::vector<int16_t> makeRf(uint32_t nSamples, uint32_t iAdc);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	const uint32_t
+		nSamples = argc > 1 ? (uint32_t) std::atoi(argv[1]) : 4096u,
+		nReps = argc > 2 ? (uint32_t) std::atoi(argv[2]) : 200u;
+	std::vector<int16_t> rf[OI_RX_N_CHIPS];
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		rf[iAdc] = makeRf(nSamples, iAdc);
+	}
+
+	// Samples of one shot, over all channels:
+	const double shotSamples = (double) nSamples * OI_N_CHAN;
+
+	/////  IQ demodulation  /////
+	for (uint32_t decimation : { 4u, 8u, 16u }) {
+		OI_IQ_CONFIG iq;
+		oi::makeIqConfig(iq, SAMPLE_RATE_HZ, 5.0e6, 
+				SAMPLE_RATE_HZ / decimation, decimation);
+		std::vector<int16_t> out(oi::iqShotBytes(nSamples, iq) / 2u);
+
+		char name[64];
+		std::snprintf(name, sizeof(name), "iq/decimate%u", decimation);
+		report(name, nReps, shotSamples, [&]() {
+			for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+				oiIqDemodulate(out.data(), rf[iAdc].data(), nSamples, &iq);
+			}
+		});
+	}
+
+	/////  Beamforming  /////
+	{
+		OI_BF_CONFIG bf;
+		std::memset(&bf, 0, sizeof(bf));
+		bf.enable = 1u;
+		bf.pitchNm = 300000u;
+		bf.speedOfSound = 1540u;
+		bf.sampleRateHz = (uint32_t) SAMPLE_RATE_HZ;
+		// One point per sample of round trip:
+		bf.depthStepUm = (uint32_t) (1540.0e6 / SAMPLE_RATE_HZ / 2.0);
+		bf.nDepth = std::min(nSamples, OI_BF_MAX_N_DEPTH);
+		for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+			bf.apodization[iChan] = 32767 / OI_N_CHAN;
+		}
+
+		std::vector<uint32_t> delays(bf.nDepth * OI_N_CHAN);
+		std::vector<int32_t> line(bf.nDepth);
+		const int16_t* pRf[OI_RX_N_CHIPS] = { rf[0].data(), rf[1].data() };
+
+		report("bf/delays", nReps, shotSamples, [&]() {
+			oiBfDelays(delays.data(), &bf, 0u);
+		});
+		report("bf/sum", nReps, shotSamples, [&]() {
+			oiBfSum(line.data(), pRf, nSamples, delays.data(), &bf);
+		});
+	}
+
+	return 0;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+// Prints the rate at which 'run' consumes input samples.
+static void report(
+		const char* name,
+		uint32_t nReps,
+		double samplesPerRep,
+		const std::function<void()>& run
+) {
+	using clock = std::chrono::steady_clock;
+
+	run();  // warm up
+
+	const clock::time_point start = clock::now();
+	for (uint32_t iRep = 0u; iRep < nReps; ++iRep) {
+		run();
+	}
+	const double seconds 
+		= std::chrono::duration<double>(clock::now() - start).count();
+
+	std::printf("%-16s %10.1f Msamples/s\n", 
+			name, samplesPerRep * nReps / seconds / 1.0e6);
+}
+
+// A decaying 5 MHz echo on every channel, with a little noise.
+static std::vector<int16_t> makeRf(uint32_t nSamples, uint32_t iAdc)
+{
+	std::vector<int16_t> rf((std::size_t) nSamples * N_ADC_CHAN);
+
+	for (uint32_t n = 0u; n < nSamples; ++n) {
+		for (uint32_t iLane = 0u; iLane < N_ADC_CHAN; ++iLane) {
+			const double 
+				t = n / SAMPLE_RATE_HZ,
+				echo = 8000.0 * std::exp(-t * 1.0e5)
+						* std::cos(2.0 * PI * 5.0e6 * t + iAdc + iLane);
+			rf[(std::size_t) n * N_ADC_CHAN + iLane] 
+					= (int16_t) (echo + (std::rand() % 64 - 32));
+		}
+	}
+
+	return rf;
+}
@@ -0,0 +1,165 @@
+/*
+	oiPackBench.cpp
+
+	Compression ratio and throughput of the packing of raw frame data
+	(OI_CMD_GET_FRAME_PACKED), over recorded data.  The data are split
+	into requests of OI_PACK_MAX_BYTES, as a client would fetch them; each
+	is packed as the firmware does, unpacked, and checked.
+
+	Usage:  oiPackBench [file.raw]
+	where the file holds the raw data of one ADC, as returned by
+	OI_CMD_GET_FRAME (rows of interleaved int16_t).  Without a file, a
+	synthetic echo is used.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiPack.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+//********************************  Constants  *******************************//
+static const double SAMPLE_RATE_HZ = 40.0e6;
+static const double PI = 3.14159265358979324;
+
+static const uint32_t ROW_BYTES = oi::PACK_N_LANES * sizeof(int16_t);
+static const uint32_t CHUNK_ROWS = OI_PACK_MAX_BYTES / ROW_BYTES;
+
+// Repeat small inputs until at least this much has been timed.
+static const std::size_t MIN_TIMED_BYTES = 64u << 20;
+
+//***********************  Local Function Declarations  **********************//
+static bool readRaw(const char* path, std::vector<int16_t>& out);
+static std::vector<int16_t> makeRaw(uint32_t nRows);
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	std::vector<int16_t> raw;
+	
+	if (argc > 1) {
+		if (!readRaw(argv[1], raw)) {
+			std::fprintf(stderr, "cannot read %s\n", argv[1]);
+			return 1;
+		} else {
+			// Ok.
+		}
+	} else {
+		raw = makeRaw(64u * CHUNK_ROWS);
+	}
+
+	const uint32_t 
+		nRows = (uint32_t) (raw.size() / oi::PACK_N_LANES),
+		nChunks = (nRows + CHUNK_ROWS - 1u) / CHUNK_ROWS;
+	const std::size_t 
+		rawBytes = (std::size_t) nRows * ROW_BYTES,
+		nReps = rawBytes >= MIN_TIMED_BYTES ? 1u : MIN_TIMED_BYTES / rawBytes;
+
+	std::vector<std::vector<uint32_t>> packed(nChunks);
+	std::vector<std::size_t> nPacked(nChunks);
+	for (uint32_t iC = 0u; iC < nChunks; ++iC) {
+		packed[iC].resize(oi::packedBytesMax(CHUNK_ROWS) / sizeof(uint32_t));
+	}
+
+	/////  Pack  /////
+	const auto packStart = std::chrono::steady_clock::now();
+	for (std::size_t iRep = 0u; iRep < nReps; ++iRep) {
+		for (uint32_t iC = 0u; iC < nChunks; ++iC) {
+			const uint32_t 
+				row0 = iC * CHUNK_ROWS,
+				n = std::min(CHUNK_ROWS, nRows - row0);
+			nPacked[iC] = oi::packRaw(packed[iC].data(), 
+					&raw[(std::size_t) row0 * oi::PACK_N_LANES], n);
+		}
+	}
+	const double packSeconds = secondsSince(packStart);
+
+	/////  Unpack  /////
+	std::vector<int16_t> out(raw.size());
+	bool ok = true;
+	const auto unpackStart = std::chrono::steady_clock::now();
+	for (std::size_t iRep = 0u; iRep < nReps; ++iRep) {
+		for (uint32_t iC = 0u; iC < nChunks; ++iC) {
+			const uint32_t 
+				row0 = iC * CHUNK_ROWS,
+				n = std::min(CHUNK_ROWS, nRows - row0);
+			ok = oi::unpackRaw(&out[(std::size_t) row0 * oi::PACK_N_LANES], 
+					n, (const uint8_t*) packed[iC].data(), nPacked[iC]) && ok;
+		}
+	}
+	const double unpackSeconds = secondsSince(unpackStart);
+
+	ok = ok && std::memcmp(out.data(), raw.data(), rawBytes) == 0;
+
+	std::size_t totalPacked = 0u;
+	for (const std::size_t n : nPacked) {
+		totalPacked += n;
+	}
+
+	std::printf("rows       %10u\n", nRows);
+	std::printf("ratio      %10.2f  (%.2f bits/sample)\n", 
+			(double) rawBytes / totalPacked,
+			8.0 * totalPacked / ((double) nRows * oi::PACK_N_LANES));
+	std::printf("pack       %10.1f MB/s\n", 
+			rawBytes * nReps / packSeconds / 1.0e6);
+	std::printf("unpack     %10.1f MB/s\n", 
+			rawBytes * nReps / unpackSeconds / 1.0e6);
+	std::printf("round trip %10s\n", ok ? "exact" : "FAILED");
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static bool readRaw(const char* path, std::vector<int16_t>& out)
+{
+	std::FILE* const pFile = std::fopen(path, "rb");
+	bool ok = pFile != nullptr;
+
+	if (ok) {
+		std::vector<int16_t> row(oi::PACK_N_LANES);
+		while (std::fread(row.data(), ROW_BYTES, 1u, pFile) == 1u) {
+			out.insert(out.end(), row.begin(), row.end());
+		}
+		std::fclose(pFile);
+		ok = !out.empty();
+	} else {
+		// Cannot open.
+	}
+
+	return ok;
+}
+
+// Decaying 5 MHz echoes on every channel over noise, with the 14 bits of
+//  the ADC justified in the 16-bit word.
+static std::vector<int16_t> makeRaw(uint32_t nRows)
+{
+	std::vector<int16_t> raw((std::size_t) nRows * oi::PACK_N_LANES);
+
+	for (uint32_t n = 0u; n < nRows; ++n) {
+		// Each shot is 4096 samples:
+		const double t = (n % 4096u) / SAMPLE_RATE_HZ;
+		for (uint32_t iLane = 0u; iLane < oi::PACK_N_LANES; ++iLane) {
+			const double echo = 6000.0 * std::exp(-t * 1.0e5)
+					* std::cos(2.0 * PI * 5.0e6 * t + iLane);
+			const int code = (int) std::lround(echo) + std::rand() % 16 - 8;
+			raw[(std::size_t) n * oi::PACK_N_LANES + iLane] 
+					= (int16_t) (code * 4);
+		}
+	}
+
+	return raw;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+}
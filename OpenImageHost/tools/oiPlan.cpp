@@ -0,0 +1,328 @@
+/*
+	oiPlan.cpp
+
+	Predicts the timing of a frame with the timing model (oiPlanner.h), and
+	checks the prediction against the frame run on a device or emulator:
+	its frames are recorded and read one after another, as oiCapture does,
+	and the measured frame period, and the PRF from the shots' timestamps,
+	are printed beside the estimates, with the cost of each request for
+	data that would account for the measured frame's transfer:  the device
+	cannot measure what the link and the host add to it, so this is the
+	requestNs to plan with when it is more than a chunk's time on the
+	link.  With a frame rate, it also prints
+	the most shots of this length, and the most samples of this many
+	shots, that reach it.
+
+	Usage:  oiPlan host [nShots [nSamples [frameRateHz [clearDepthMm]]]]
+	where host is "model" for the default costs alone, "emulator" for an
+	emulator in this process, with a 50 MB/s link, or the device's
+	host[:port].
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiClient.h"
+#include "oiEmulator.h"
+#include "oiPlanner.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//********************************  Constants  *******************************//
+// A single-cycle pulse at a quarter of the transmit clock, as oiCapture.
+static const int8_t PULSE[] = { 0, 2, 2, -2, -2, 0 };
+static const uint8_t TGC_LEVEL = 128u;
+
+static const uint32_t N_FRAMES = 20u;
+static const std::chrono::seconds RECORD_TIMEOUT(5);
+
+// Of the emulator, when it is run here.
+static const double EMULATOR_LINK_BYTES_PER_SEC = 50.0e6;
+
+// Most samples that the fit searches.
+static const uint32_t MAX_FIT_SAMPLES = 65536u;
+
+//***********************  Local Function Declarations  **********************//
+static OI_SHOT makeShot(uint32_t nSamples);
+static void printTiming(const OI_TIMING_CAL& timing);
+static void printEstimate(const char* label, const OI_FRAME_ESTIMATE& est);
+static bool record(oi::Client& client, const oi::FrameProgram& program,
+		std::chrono::microseconds pollPeriod);
+static double shotPeriodNs(const std::vector<uint8_t>& data,
+		const oi::FrameProgram& program, double sampleRateHz);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2) {
+		std::fprintf(stderr, "usage: oiPlan host "
+				"[nShots [nSamples [frameRateHz [clearDepthMm]]]]\n");
+		return 2;
+	} else {
+		// Ok.
+	}
+
+	const std::string host = argv[1];
+	const uint32_t
+		nShots = argc > 2 ? (uint32_t) std::strtoul(argv[2], nullptr, 0) : 32u,
+		nSamples = argc > 3 ? (uint32_t) std::strtoul(argv[3], nullptr, 0)
+				: 2048u;
+	const double
+		frameRateHz = argc > 4 ? std::strtod(argv[4], nullptr) : 0.0,
+		clearDepthMm = argc > 5 ? std::strtod(argv[5], nullptr) : 0.0;
+
+	oi::PlannerOptions options;
+	options.clearDepthUm = (uint32_t) (clearDepthMm * 1.0e3);
+
+	const OI_SHOT shot = makeShot(nSamples);
+	oi::FrameProgram program;
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		program.addShot(shot);
+	}
+	const oi_error_t error = program.build();
+	if (error != OI_ERR_NONE) {
+		std::fprintf(stderr, "bad frame (error %d)\n", (int) error);
+		return 1;
+	} else {
+		std::printf("%u shots of %u samples:  %zu bytes queued, %zu bytes "
+				"of each ADC\n", nShots, nSamples, program.getBytes().size(),
+				program.getRawBytes());
+	}
+
+	/////  Costs  /////
+	std::unique_ptr<oi::Emulator> pEmulator;
+	oi::Client client;
+	std::string address = host;
+	uint16_t port = OI_TCP_PORT;
+	if (host == "emulator") {
+		oi::EmulatorOptions emulatorOptions;
+		emulatorOptions.port = 0u;
+		// A link slower than the loopback, as the device's is:
+		emulatorOptions.linkBytesPerSec = EMULATOR_LINK_BYTES_PER_SEC;
+		// And timestamps, so that the PRF is measured:
+		emulatorOptions.isFpgaHeader = true;
+		pEmulator.reset(new oi::Emulator(emulatorOptions));
+		if (!pEmulator->start()) {
+			std::fprintf(stderr, "cannot start the emulator\n");
+			return 1;
+		} else {
+			address = "127.0.0.1";
+			port = pEmulator->getPort();
+		}
+	} else if (host.find(':') != std::string::npos) {
+		address = host.substr(0u, host.find(':'));
+		port = (uint16_t) std::strtoul(host.c_str() + host.find(':') + 1u,
+				nullptr, 10);
+	} else {
+		// The device's port.
+	}
+
+	oi::FramePlanner planner(options);
+	const bool isRun = host != "model";
+	if (isRun) {
+		OI_TIMING_CAL timing;
+		if (!client.connect(address, port)) {
+			std::fprintf(stderr, "cannot connect to %s\n", host.c_str());
+			return 1;
+		} else if (!client.getTiming().get().get(timing)) {
+			std::fprintf(stderr, "no timing from %s\n", host.c_str());
+			return 1;
+		} else {
+			planner.setTiming(timing);
+		}
+	} else {
+		// The defaults.
+	}
+	printTiming(planner.getTiming());
+
+	/////  Estimate  /////
+	OI_FRAME_ESTIMATE est;
+	if (!planner.estimate(program, est)) {
+		std::fprintf(stderr, "cannot estimate the frame\n");
+		return 1;
+	} else {
+		printEstimate("planned", est);
+	}
+
+	bool ok = true;
+	if (isRun) {
+		OI_FRAME_ESTIMATE device;
+		const oi::Reply reply = client.estimateFrame(
+				planner.makeRequest(program)).get();
+		if (reply.get(device)) {
+			printEstimate("device", device);
+			ok = std::memcmp(&device, &est, sizeof(est)) == 0;
+		} else {
+			std::fprintf(stderr, "no estimate from %s (error %d)\n",
+					host.c_str(), (int) reply.error);
+			ok = false;
+		}
+	} else {
+		// Nothing to ask.
+	}
+
+	/////  Measure  /////
+	if (isRun && ok) {
+		const std::size_t nRawBytes = program.getRawBytes();
+		std::vector<uint8_t> data[OI_RX_N_CHIPS];
+		oi::FrameBuffers buffers;
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			data[iAdc].resize(nRawBytes);
+			buffers.pData[iAdc] = data[iAdc].data();
+			buffers.nBytes[iAdc] = nRawBytes;
+		}
+
+		double periodNs = 0.0;
+		const auto start = std::chrono::steady_clock::now();
+		for (uint32_t iF = 0u; iF < N_FRAMES && ok; ++iF) {
+			program.setHandle(iF);
+			program.build();
+			ok = record(client, program, options.pollPeriod)
+					&& client.readFrame(buffers).get().ok;
+			periodNs += shotPeriodNs(data[0], program,
+					planner.getTiming().sampleRateHz);
+		}
+		const double frameNs = std::chrono::duration<double, std::nano>(
+				std::chrono::steady_clock::now() - start).count() / N_FRAMES;
+
+		if (ok) {
+			const double prfHz = periodNs > 0.0
+					? 1.0e9 * N_FRAMES / periodNs : 0.0;
+			std::printf("measured:  frame %.3f ms (%.1f frames/s), PRF %.1f Hz"
+					"%s\n", frameNs / 1.0e6, 1.0e9 / frameNs, prfHz,
+					prfHz > 0.0 ? "" : " (the shots are not timestamped)");
+			const std::size_t nRequests = OI_RX_N_CHIPS
+					* ((nRawBytes + options.chunkBytes - 1u)
+							/ options.chunkBytes);
+			std::printf("error:     frame %+.1f%%, PRF %+.1f%%;  implies %.1f "
+					"us per request\n",
+					(est.frameNs - frameNs) / frameNs * 100.0,
+					prfHz > 0.0 ? (est.prfMilliHz / 1.0e3 - prfHz) / prfHz
+							* 100.0 : 0.0,
+					(frameNs - (est.frameNs - est.transferNs))
+							/ (nRequests + 1u) / 1.0e3);
+		} else {
+			std::fprintf(stderr, "the frame was not recorded and read\n");
+		}
+	} else {
+		// Nothing to run.
+	}
+
+	/////  Fit  /////
+	if (frameRateHz > 0.0) {
+		std::printf("at %.1f frames/s:  at most %u shots of %u samples, or "
+				"%u samples in %u shots\n", frameRateHz,
+				planner.fitShots(shot, frameRateHz), nSamples,
+				planner.fitSamples(shot, nShots, frameRateHz, MAX_FIT_SAMPLES),
+				nShots);
+	} else {
+		// No rate to fit.
+	}
+
+	client.close();
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static OI_SHOT makeShot(uint32_t nSamples)
+{
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iC = 0u; iC < OI_N_CHAN; ++iC) {
+		OI_TX_CHANNEL& tx = shot.tx.channels[iC];
+		tx.enable = 1u;
+		tx.nLevelSequence = sizeof(PULSE);
+		std::memcpy(tx.levelSequence, PULSE, sizeof(PULSE));
+
+		shot.rx.channels[iC].enable = 1u;
+	}
+
+	shot.rx.nSamples = nSamples;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		shot.rx.nTgc[iAdc] = OI_RX_MAX_N_TGC;
+		std::memset(shot.rx.tgc[iAdc], TGC_LEVEL, OI_RX_MAX_N_TGC);
+	}
+
+	return shot;
+}
+
+static void printTiming(const OI_TIMING_CAL& timing)
+{
+	std::printf("costs (us):  arm %.1f  shot %.1f  pulsers %.1f  TGC %.1f  "
+			"ADCs %.1f  BD %.3f  request %.1f;  link %.1f MB/s, %.1f MHz, "
+			"%u shots measured\n", timing.armNs / 1.0e3, timing.shotNs / 1.0e3,
+			timing.pulserNs / 1.0e3, timing.tgcNs / 1.0e3,
+			timing.adcNs / 1.0e3, timing.bdNs / 1.0e3,
+			timing.requestNs / 1.0e3, timing.linkBytesPerSec / 1.0e6,
+			timing.sampleRateHz / 1.0e6, timing.nMeasured);
+}
+
+static void printEstimate(const char* label, const OI_FRAME_ESTIMATE& est)
+{
+	std::printf("%s:  frame %.3f ms (%.1f frames/s), PRF %.1f Hz, link "
+			"%.1f%% busy\n", label, est.frameNs / 1.0e6,
+			est.frameRateMilliHz / 1.0e3, est.prfMilliHz / 1.0e3,
+			est.linkPermille / 10.0);
+	std::printf("    upload %.1f  arm %.1f  setup %.1f  record %.1f  shots "
+			"%.1f  poll %.1f  transfer %.1f us;  %u BDs, %u shots before the "
+			"echoes\n", est.uploadNs / 1.0e3, est.armNs / 1.0e3,
+			est.setupNs / 1.0e3, est.recordNs / 1.0e3, est.shotsNs / 1.0e3,
+			est.pollNs / 1.0e3, est.transferNs / 1.0e3, est.nBds,
+			est.nEchoOverlap);
+}
+
+// Queues a built frame and polls until it is recorded.
+static bool record(oi::Client& client, const oi::FrameProgram& program,
+		std::chrono::microseconds pollPeriod)
+{
+	OI_STATUS status;
+	bool ok = client.getStatus().get().get(status);
+	const uint32_t before = status.nShots;
+
+	const auto start = std::chrono::steady_clock::now();
+	ok = ok && client.queueFrame(program).get().isAck();
+	while (ok && (status.state != STATE_READY
+			|| (int32_t) (status.nShots - before - program.getNShots()) < 0)) {
+		std::this_thread::sleep_for(pollPeriod);
+		ok = std::chrono::steady_clock::now() - start < RECORD_TIMEOUT
+				&& client.getStatus().get().get(status);
+	}
+
+	return ok;
+}
+
+// Mean period of the frame's shots, from their headers' timestamps; zero
+//  for a single shot, or if the bitstream does not timestamp them.
+static double shotPeriodNs(const std::vector<uint8_t>& data,
+		const oi::FrameProgram& program, double sampleRateHz)
+{
+	const uint32_t nShots = program.getNShots();
+	uint64_t first = 0u, last = 0u;
+	std::size_t offset = 0u;
+
+	for (uint32_t iS = 0u; iS < nShots; ++iS) {
+		OI_SHOT_HEADER header;
+		std::memcpy(&header, &data[offset], sizeof(header));
+		last = (uint64_t) header.timestampHi << 32 | header.timestampLo;
+		first = iS == 0u ? last : first;
+
+		const OI_RX& rx = program.getShot(iS).rx;
+		offset += OI_RX_SHOT_RECORD_BYTES((std::size_t) rx.nSamples,
+				rx.sampleFormat);
+	}
+
+	return nShots > 1u && sampleRateHz > 0.0
+			? (double) (last - first) / sampleRateHz * 1.0e9 / (nShots - 1u)
+			: 0.0;
+}
@@ -0,0 +1,250 @@
+/*
+	oiRecordingBench.cpp
+
+	Times recordings (oiRecording.h):  the rate at which frames are
+	appended, into the page cache and through to the disk, and the time to
+	read one channel of a random shot of a random frame, with the file
+	cached and not.  oiRecordingTest checks what is read.
+
+	Usage:  oiRecordingBench [path [nFrames [nShots [nSamples]]]]
+	where path is kept only if it is given.
+
+	2026-10-19  agent  Created.
+*/
+
+#include "oiRecording.h"
+#include "oiSamples.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+//********************************  Constants  *******************************//
+static const char* const DEFAULT_PATH = "oiRecordingBench.oir";
+static const uint32_t DEFAULT_N_FRAMES = 64u;
+static const uint32_t DEFAULT_N_SHOTS = 32u;
+static const uint32_t DEFAULT_N_SAMPLES = 2048u;
+static const uint32_t SEED = 0x4F49u;
+
+static const uint32_t N_WARM_READS = 100000u;
+static const uint32_t N_COLD_READS = 1000u;
+
+//*******************************  Module Data  ******************************//
+static volatile int64_t sumSink;
+
+//***********************  Local Function Declarations  **********************//
+static oi::FrameProgram makeProgram(uint32_t nShots, uint32_t nSamples);
+static void makeFrame(std::vector<uint8_t> data[OI_RX_N_CHIPS],
+		const oi::FrameProgram& program, uint32_t iFrame);
+static int16_t sampleOf(uint32_t iShot, uint32_t iAdc, std::size_t i);
+static double timeReads(const oi::RecordingReader& reader, uint32_t nReads,
+		std::mt19937& random);
+static double secondsSince(std::chrono::steady_clock::time_point start);
+
+//****************************  Global Functions  ****************************//
+
+int main(int argc, char* argv[])
+{
+	const char* const path = argc > 1 ? argv[1] : DEFAULT_PATH;
+	const uint32_t
+		nFrames = argc > 2
+				? (uint32_t) std::strtoul(argv[2], nullptr, 0)
+				: DEFAULT_N_FRAMES,
+		nShots = argc > 3
+				? (uint32_t) std::strtoul(argv[3], nullptr, 0)
+				: DEFAULT_N_SHOTS,
+		nSamples = argc > 4
+				? (uint32_t) std::strtoul(argv[4], nullptr, 0)
+				: DEFAULT_N_SAMPLES;
+
+	if (nFrames < 2u || nShots == 0u || nShots > OI_MAX_N_SHOTS
+			|| nSamples == 0u) {
+		std::fprintf(stderr, "2 or more frames, of between 1 and %u shots\n",
+				OI_MAX_N_SHOTS);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	const oi::FrameProgram program = makeProgram(nShots, nSamples);
+	const std::size_t nFrameBytes = OI_RX_N_CHIPS * program.getRawBytes();
+	std::vector<uint8_t> data[OI_RX_N_CHIPS];
+	const uint8_t* ppData[OI_RX_N_CHIPS];
+	makeFrame(data, program, 0u);
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		ppData[iAdc] = data[iAdc].data();
+	}
+
+	/////  Write  /////
+	oi::RecordingWriter writer;
+	if (!writer.create(path, program)) {
+		std::fprintf(stderr, "cannot write %s\n", path);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	bool ok = true;
+	double appendSeconds = 0.0;
+	for (uint32_t iFrame = 0u; iFrame < nFrames && ok; ++iFrame) {
+		// Each frame's shots carry its number, as their handle.
+		for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+			for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+				const std::size_t offset = (std::size_t) iShot
+						* oi::shotRecordBytes(nSamples, OI_SAMPLE_FORMAT_16);
+				std::memcpy(&data[iAdc][offset
+						+ offsetof(OI_SHOT_HEADER, handle)], &iFrame,
+						sizeof(iFrame));
+			}
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		ok = writer.append(ppData, (uint64_t) std::chrono::duration_cast<
+				std::chrono::nanoseconds>(std::chrono::system_clock::now()
+						.time_since_epoch()).count());
+		appendSeconds += secondsSince(start);
+	}
+
+	const auto syncStart = std::chrono::steady_clock::now();
+	ok = ok && writer.sync();
+	const double syncSeconds = appendSeconds + secondsSince(syncStart);
+	ok = writer.close() && ok;
+
+	std::printf("%u frames of %zu bytes:  appended at %.0f MB/s, "
+			"to the disk at %.0f MB/s\n", nFrames, nFrameBytes,
+			nFrames * nFrameBytes / appendSeconds / 1.0e6,
+			nFrames * nFrameBytes / syncSeconds / 1.0e6);
+
+	/////  Read  /////
+	oi::RecordingReader reader;
+	ok = ok && reader.open(path) && reader.getNFrames() == nFrames;
+	if (!ok) {
+		std::fprintf(stderr, "cannot write or read back %s\n", path);
+		std::remove(path);
+		return 1;
+	} else {
+		// Ok.
+	}
+
+	std::mt19937 random(SEED);
+	const double warmUs = timeReads(reader, N_WARM_READS, random);
+
+	// Drop the file from the page cache, which keeps pages while they are
+	//  mapped; it was synced.
+	reader.close();
+	const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+	if (fd >= 0) {
+		::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		::close(fd);
+	} else {
+		// Stays cached.
+	}
+	ok = reader.open(path) && ok;
+	const double coldUs = timeReads(reader, N_COLD_READS, random);
+
+	std::printf("a channel of a random shot:  %.2f us cached, %.1f us not\n",
+			warmUs, coldUs);
+
+	reader.close();
+	if (argc <= 1) {
+		std::remove(path);
+	} else {
+		// Kept.
+	}
+
+	return ok ? 0 : 1;
+}
+
+//***********************  Local Function Definitions  ***********************//
+
+static oi::FrameProgram makeProgram(uint32_t nShots, uint32_t nSamples)
+{
+	oi::FrameProgram program;
+	OI_SHOT shot;
+	std::memset(&shot, 0, sizeof(shot));
+
+	for (uint32_t iChan = 0u; iChan < OI_N_CHAN; ++iChan) {
+		shot.rx.channels[iChan].enable = 1u;
+	}
+	shot.rx.nSamples = nSamples;
+	shot.rx.sampleFormat = OI_SAMPLE_FORMAT_16;
+	for (uint32_t iShot = 0u; iShot < nShots; ++iShot) {
+		program.addShot(shot);
+	}
+
+	return program;
+}
+
+// Good headers, and samples that identify their shot, ADC and place.
+static void makeFrame(std::vector<uint8_t> data[OI_RX_N_CHIPS],
+		const oi::FrameProgram& program, uint32_t iFrame)
+{
+	const uint32_t nSamples = program.getShot(0u).rx.nSamples;
+	const std::size_t
+		nRecord = oi::shotRecordBytes(nSamples, OI_SAMPLE_FORMAT_16),
+		nValues = (std::size_t) nSamples * oi::DEINTERLEAVE_N_LANES;
+
+	for (uint32_t iAdc = 0u; iAdc < OI_RX_N_CHIPS; ++iAdc) {
+		data[iAdc].assign(program.getRawBytes(), 0u);
+		for (uint32_t iShot = 0u; iShot < program.getNShots(); ++iShot) {
+			uint8_t* const pRecord = &data[iAdc][iShot * nRecord];
+			OI_SHOT_HEADER header = {};
+			header.magic = OI_SHOT_MAGIC;
+			header.handle = iFrame;
+			header.iShot = iShot;
+			header.nBytes = (uint32_t) (nRecord - OI_SHOT_HEADER_BYTES);
+			std::memcpy(pRecord, &header, sizeof(header));
+
+			for (std::size_t i = 0u; i < nValues; ++i) {
+				const int16_t value = sampleOf(iShot, iAdc, i);
+				std::memcpy(pRecord + OI_SHOT_HEADER_BYTES + 2u * i, &value,
+						sizeof(value));
+			}
+		}
+	}
+}
+
+static int16_t sampleOf(uint32_t iShot, uint32_t iAdc, std::size_t i)
+{
+	return (int16_t) (i * 7u + iShot * 131u + iAdc * 4099u);
+}
+
+// Mean microseconds to find and sum one channel of a random shot.  The sum
+//  is stored to sumSink, so that the reads are not optimized away.
+static double timeReads(const oi::RecordingReader& reader, uint32_t nReads,
+		std::mt19937& random)
+{
+	const oi::ChannelMap map = oi::defaultChannelMap();
+	std::uniform_int_distribution<uint64_t>
+		frames(0u, reader.getNFrames() - 1u);
+	std::uniform_int_distribution<uint32_t>
+		shots(0u, reader.getHeader().nShots - 1u),
+		channels(0u, OI_N_CHAN - 1u);
+
+	int64_t sum = 0;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t iRead = 0u; iRead < nReads; ++iRead) {
+		const oi::ChannelView view = reader.getChannel(frames(random),
+				shots(random), channels(random), map);
+		for (std::size_t i = 0u; i < view.nSamples; ++i) {
+			sum += view.pSamples[i * view.stride];
+		}
+	}
+	sumSink = sum;
+
+	return secondsSince(start) * 1.0e6 / nReads;
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+}